@@ -239,6 +239,7 @@ namespace Ogre
         void destroyData(PageStrategyData* d);
         void updateDebugDisplay(Page* p, SceneNode* sn);
         PageID getPageID(const Vector3& worldPos, PagedWorldSection* section);
+        Real getLoadPriority(PageID pageID, const Vector3& cameraPos, PagedWorldSection* section);
     };
 
     /** @} */
@@ -55,9 +55,16 @@ namespace Ogre
         PageID mID;
         PagedWorldSection* mParent;
         unsigned long mFrameLastHeld;
+        unsigned long mFrameLastRequested;
         ContentCollectionList mContentCollections;
         uint16 mWorkQueueChannel;
         bool mDeferredProcessInProgress;
+        /// The pending prepare request, only valid while mDeferredProcessInProgress
+        WorkQueue::RequestID mPrepareRequestID;
+        /// Priority last given to the pending prepare request
+        Real mLoadPriority;
+        /// Timer value (microseconds) at which the pending load was requested
+        unsigned long mLoadRequestTime;
         bool mModified;
 
         SceneNode* mDebugNode;
@@ -121,11 +128,24 @@ namespace Ogre
         virtual unsigned long getFrameLastHeld() { return mFrameLastHeld; }
         /// 'Touch' the page to let it know it's being used
         virtual void touch();
+        /** 'Touch' the page and note that it was explicitly requested to be loaded,
+            rather than just held.
+        @remarks
+            Requested pages are never evicted to satisfy PageManager::setMemoryBudget.
+        */
+        virtual void _notifyRequested();
 
         /** Load this page. 
         @param synchronous Whether to force this to happen synchronously.
         */
         virtual void load(bool synchronous);
+        /** Update the priority of the background prepare request, if there is one.
+        @remarks
+            Called whenever the page is requested again, so the work queue is only
+            told about changes of more than 10% to keep the cost per frame low.
+        @see PagedWorldSection::getLoadPriority
+        */
+        virtual void updateLoadPriority();
         /** Unload this page. 
         */
         virtual void unload();
@@ -138,6 +158,17 @@ namespace Ogre
         */
         virtual bool isHeld() const;
 
+        /** Returns whether this page was explicitly requested to be loaded in the
+            last frame, as opposed to just being held.
+        */
+        virtual bool isRequested() const;
+
+        /** Get the number of bytes of memory used by this page, as reported by
+            its content collections.
+        @see PageContentCollection::getMemoryUsage
+        */
+        virtual size_t getMemoryUsage() const;
+
         /// Save page data to an automatically generated file name
         virtual void save();
         /// Save page data to a file
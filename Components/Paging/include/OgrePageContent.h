@@ -80,6 +80,8 @@ namespace Ogre
         virtual void unload() = 0;
         /// Unprepare data - may be called in the background
         virtual void unprepare() = 0;
+        /// Get the number of bytes of memory held by this content, or 0 if unknown
+        virtual size_t getMemoryUsage() const { return 0; }
 
     };
 
@@ -91,6 +91,13 @@ namespace Ogre
         virtual void unload() = 0;
         /// Unprepare data - may be called in the background
         virtual void unprepare() = 0;
+        /** Get the number of bytes of memory held by this collection.
+        @remarks
+            Used by PageManager to keep resident pages within the memory budget.
+            The default implementation reports nothing, so the collection is not
+            accounted for.
+        */
+        virtual size_t getMemoryUsage() const { return 0; }
 
 
     };
@@ -432,6 +432,81 @@ namespace Ogre
         /** Get whether paging operations are currently allowed to happen. */
         bool getPagingOperationsEnabled() const { return mPagingEnabled; }
 
+        /** Set the number of bytes resident pages may use, across all worlds.
+        @remarks
+            With no budget (the default) a page is unloaded as soon as it is no
+            longer requested or held. With a budget, released pages stay resident
+            so they can be picked up again without reloading, and pages are evicted
+            at the end of each frame whenever the budget is exceeded: released
+            pages first, then pages which are only held, least recently used first
+            and the furthest from the cameras first among equals. Pages which have
+            been requested are never evicted, so the budget may still be exceeded
+            if the page strategy asks for more than it allows.
+        @par
+            Only memory reported by PagedWorldSection::getPageMemoryUsage is
+            accounted for, which by default is what the page's content collections
+            report; released pages which report none are unloaded straight away as
+            before. Pages which are still being prepared are not evicted.
+        @param bytes The budget in bytes, or 0 for no budget
+        */
+        void setMemoryBudget(size_t bytes) { mMemoryBudget = bytes; }
+
+        /** Get the number of bytes resident pages may use, or 0 if unbounded. */
+        size_t getMemoryBudget() const { return mMemoryBudget; }
+
+        /** Get the number of bytes currently used by resident pages. */
+        size_t getMemoryUsage() const;
+
+        /** Evict pages until the memory budget is respected.
+        @remarks
+            This is called automatically at the end of each frame; you only need
+            to call it if you change the budget or page contents and want the
+            effect to be immediate.
+        */
+        void enforceMemoryBudget();
+
+        /// Paging statistics, accumulated since creation or resetStatistics
+        struct Statistics
+        {
+            /// Number of requests for pages which were released but still resident
+            size_t hits;
+            /// Number of requests which had to create and load a page
+            size_t misses;
+            /// Number of pages which finished loading
+            size_t loads;
+            /// Number of pages evicted to respect the memory budget
+            size_t evictions;
+            /// Total time between requesting and finishing loads, in microseconds
+            uint64 totalLoadTime;
+            /// Longest time between requesting and finishing a load, in microseconds
+            unsigned long maxLoadTime;
+            /// Highest memory usage seen while enforcing the budget
+            size_t peakMemoryUsage;
+
+            Statistics() : hits(0), misses(0), loads(0), evictions(0),
+                totalLoadTime(0), maxLoadTime(0), peakMemoryUsage(0) {}
+
+            /// Fraction of page requests satisfied by resident pages
+            Real getHitRate() const
+            { return hits + misses ? Real(hits) / Real(hits + misses) : 0; }
+            /// Mean time between requesting and finishing a load, in microseconds
+            Real getAverageLoadTime() const
+            { return loads ? Real(totalLoadTime) / Real(loads) : 0; }
+        };
+
+        /** Get the paging statistics. */
+        const Statistics& getStatistics() const { return mStatistics; }
+
+        /** Reset the paging statistics. */
+        void resetStatistics() { mStatistics = Statistics(); }
+
+        /// Internal method to record a request satisfied by a resident page
+        void _notifyPageHit() { ++mStatistics.hits; }
+        /// Internal method to record a request which had to load a page
+        void _notifyPageMiss() { ++mStatistics.misses; }
+        /// Internal method to record that a page finished loading
+        void _notifyPageLoaded(Page* page, unsigned long microseconds);
+
 
     protected:
 
@@ -466,6 +541,8 @@ namespace Ogre
         EventRouter mEventRouter;
         uint8 mDebugDisplayLvl;
         bool mPagingEnabled;
+        size_t mMemoryBudget;
+        Statistics mStatistics;
 
         Grid2DPageStrategy* mGrid2DPageStrategy;
         Grid3DPageStrategy* mGrid3DPageStrategy;
@@ -129,6 +129,17 @@ namespace Ogre
         @return The page ID
         */
         virtual PageID getPageID(const Vector3& worldPos, PagedWorldSection* section) = 0;
+
+        /** Get the priority with which a page should be loaded in the background.
+        @remarks
+            Pages with a higher priority are prepared first, see WorkQueue::addRequest.
+            The default implementation returns 0, so pages are prepared in the
+            order they were requested.
+        @param pageID The page to be loaded
+        @param cameraPos World position of the camera the page is loaded for
+        */
+        virtual Real getLoadPriority(PageID pageID, const Vector3& cameraPos, PagedWorldSection* section)
+        { return 0; }
     };
 
     /*@}*/
@@ -80,6 +80,14 @@ namespace Ogre
         PageProvider* mPageProvider;
         SceneManager* mSceneMgr;
 
+        /** Whether a page which is no longer held may stay resident.
+        @remarks
+            Released pages are kept, and can be picked up again cheaply, while a
+            memory budget is set on the PageManager; the manager evicts them once
+            the budget is exceeded.
+        */
+        virtual bool isRetainable(Page* p);
+
         /// Load data specific to a subtype of this class (if any)
         virtual void loadSubtypeData(StreamSerialiser& ser) {}
         virtual void saveSubtypeData(StreamSerialiser& ser) {}
@@ -177,6 +185,14 @@ namespace Ogre
         */
         virtual void loadPage(PageID pageID, bool forceSynchronous = false);
 
+        /** Get the priority with which a page should be prepared in the background.
+        @remarks
+            Asks the PageStrategy for the priority relative to each camera tracked
+            by the PageManager and returns the highest, so pages close to any
+            camera are prepared first.
+        */
+        virtual Real getLoadPriority(PageID pageID);
+
         /** Ask for a page to be unloaded with the given (section-relative) PageID
         @remarks
             You would not normally call this manually, the PageStrategy is in 
@@ -248,6 +264,17 @@ namespace Ogre
         */
         virtual Page* getPage(PageID pageID);
 
+        /// Get the pages currently resident in this section
+        const PageMap& getPages() const { return mPages; }
+
+        /** Get the number of bytes of memory used by a page of this section.
+        @remarks
+            The default returns Page::getMemoryUsage. Sections which keep page data
+            outside the page's content collections add it here, so that it counts
+            towards PageManager::setMemoryBudget.
+        */
+        virtual size_t getPageMemoryUsage(Page* p) const;
+
         /** Remove all pages immediately. 
         @remarks
             Effectively 'resets' this section by deleting all pages. 
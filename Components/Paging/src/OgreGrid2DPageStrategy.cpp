@@ -453,6 +453,19 @@ namespace Ogre
         return stratData->calculatePageID(x, y);
         
     }
+    //---------------------------------------------------------------------
+    Real Grid2DPageStrategy::getLoadPriority(PageID pageID, const Vector3& cameraPos, PagedWorldSection* section)
+    {
+        Grid2DPageStrategyData* stratData = static_cast<Grid2DPageStrategyData*>(section->getStrategyData());
+
+        int32 x, y;
+        stratData->calculateCell(pageID, &x, &y);
+        Vector2 midPoint, gridpos;
+        stratData->getMidPointGridSpace(x, y, midPoint);
+        stratData->convertWorldToGridSpace(cameraPos, gridpos);
+        // closest pages first
+        return -midPoint.distance(gridpos);
+    }
 
 
 }
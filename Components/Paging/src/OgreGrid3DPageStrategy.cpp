@@ -421,4 +421,16 @@ namespace Ogre
         stratData->determineGridLocation(pos, &x, &y, &z);
         return stratData->calculatePageID(x, y, z);
     }
+    //---------------------------------------------------------------------
+    Real Grid3DPageStrategy::getLoadPriority(PageID pageID, const Vector3& cameraPos, PagedWorldSection* section)
+    {
+        Grid3DPageStrategyData* stratData = static_cast<Grid3DPageStrategyData*>(section->getStrategyData());
+
+        int32 x, y, z;
+        stratData->calculateCell(pageID, &x, &y, &z);
+        Vector3 midPoint;
+        stratData->getMidPointGridSpace(x, y, z, midPoint);
+        // closest pages first
+        return -midPoint.distance(cameraPos);
+    }
 }
@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include "OgrePageContentCollectionFactory.h"
 #include "OgrePageContentCollection.h"
 #include "OgreLogManager.h"
+#include "OgreTimer.h"
 #include "OgreFileSystemLayer.h"
 #include <iomanip>
 
@@ -48,12 +49,35 @@ namespace Ogre
     const uint32 Page::CHUNK_CONTENTCOLLECTION_DECLARATION_ID = StreamSerialiser::makeIdentifier("PCNT");
     const uint16 Page::WORKQUEUE_PREPARE_REQUEST = 1;
     const uint16 Page::WORKQUEUE_CHANGECOLLECTION_REQUEST = 3;
+    //---------------------------------------------------------------------
+    namespace
+    {
+        /// Number of frames a page stays held or requested after it was last touched
+        const unsigned long HOLD_FRAME_TOLERANCE = 5;
+        /// Relative change of the load priority below which the request is not updated
+        const Real PRIORITY_TOLERANCE = 0.1f;
+
+        unsigned long framesSince(unsigned long frame)
+        {
+            unsigned long nextFrame = Root::getSingleton().getNextFrameNumber();
+            if (nextFrame < frame)
+            {
+                // we must have wrapped around
+                return frame + (std::numeric_limits<unsigned long>::max() - frame);
+            }
+            return nextFrame - frame;
+        }
+    }
 
     //---------------------------------------------------------------------
     Page::Page(PageID pageID, PagedWorldSection* parent)
         : mID(pageID)
         , mParent(parent)
+        , mFrameLastRequested(0)
         , mDeferredProcessInProgress(false)
+        , mPrepareRequestID(0)
+        , mLoadPriority(0)
+        , mLoadRequestTime(0)
         , mModified(false)
         , mDebugNode(0)
     {
@@ -62,6 +86,7 @@ namespace Ogre
         wq->addRequestHandler(mWorkQueueChannel, this);
         wq->addResponseHandler(mWorkQueueChannel, this);
         touch();
+        mFrameLastRequested = mFrameLastHeld;
     }
     //---------------------------------------------------------------------
     Page::~Page()
@@ -104,20 +129,31 @@ namespace Ogre
         mFrameLastHeld = Root::getSingleton().getNextFrameNumber();
     }
     //---------------------------------------------------------------------
+    void Page::_notifyRequested()
+    {
+        touch();
+        mFrameLastRequested = mFrameLastHeld;
+    }
+    //---------------------------------------------------------------------
     bool Page::isHeld() const
     {
-        unsigned long nextFrame = Root::getSingleton().getNextFrameNumber();
-        unsigned long dist;
-        if (nextFrame < mFrameLastHeld)
+        return framesSince(mFrameLastHeld) <= HOLD_FRAME_TOLERANCE;
+    }
+    //---------------------------------------------------------------------
+    bool Page::isRequested() const
+    {
+        return framesSince(mFrameLastRequested) <= HOLD_FRAME_TOLERANCE;
+    }
+    //---------------------------------------------------------------------
+    size_t Page::getMemoryUsage() const
+    {
+        size_t bytes = 0;
+        for (ContentCollectionList::const_iterator i = mContentCollections.begin();
+            i != mContentCollections.end(); ++i)
         {
-            // we must have wrapped around
-            dist = mFrameLastHeld + (std::numeric_limits<unsigned long>::max() - mFrameLastHeld);
+            bytes += (*i)->getMemoryUsage();
         }
-        else
-            dist = nextFrame - mFrameLastHeld;
-
-        // 5-frame tolerance
-        return dist <= 5;
+        return bytes;
     }
     //---------------------------------------------------------------------
     bool Page::prepareImpl(StreamSerialiser& stream, PageData* dataToPopulate)
@@ -185,12 +221,26 @@ namespace Ogre
             destroyAllContentCollections();
             PageRequest req(this);
             mDeferredProcessInProgress = true;
-            Root::getSingleton().getWorkQueue()->addRequest(mWorkQueueChannel, WORKQUEUE_PREPARE_REQUEST, 
-                Any(req), 0, synchronous);
+            mLoadRequestTime = Root::getSingleton().getTimer()->getMicroseconds();
+            mLoadPriority = synchronous ? 0 : mParent->getLoadPriority(mID);
+            mPrepareRequestID = Root::getSingleton().getWorkQueue()->addRequest(mWorkQueueChannel,
+                WORKQUEUE_PREPARE_REQUEST, Any(req), 0, synchronous, false, mLoadPriority);
         }
 
     }
     //---------------------------------------------------------------------
+    void Page::updateLoadPriority()
+    {
+        if (!mDeferredProcessInProgress || !mPrepareRequestID)
+            return;
+
+        Real priority = mParent->getLoadPriority(mID);
+        if (Math::Abs(priority - mLoadPriority) <= PRIORITY_TOLERANCE * std::max(Math::Abs(mLoadPriority), Real(1)))
+            return;
+        mLoadPriority = priority;
+        Root::getSingleton().getWorkQueue()->setRequestPriority(mPrepareRequestID, priority);
+    }
+    //---------------------------------------------------------------------
     void Page::unload()
     {
         destroyAllContentCollections();
@@ -264,11 +314,15 @@ namespace Ogre
                 std::swap(mContentCollections, pres.pageData->collectionsToAdd);
 
             loadImpl();
+
+            getManager()->_notifyPageLoaded(this,
+                Root::getSingleton().getTimer()->getMicroseconds() - mLoadRequestTime);
         }
 
         OGRE_DELETE pres.pageData;
 
         mDeferredProcessInProgress = false;
+        mPrepareRequestID = 0;
 
     }
     //---------------------------------------------------------------------
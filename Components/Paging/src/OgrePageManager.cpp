@@ -38,9 +38,34 @@ THE SOFTWARE.
 #include "OgreStreamSerialiser.h"
 #include "OgreRoot.h"
 #include "OgrePageContent.h"
+#include "OgrePage.h"
 
 namespace Ogre
 {
+    namespace
+    {
+        struct EvictionCandidate
+        {
+            Page* page;
+            size_t bytes;
+            bool held;
+            unsigned long frameLastHeld;
+            Real priority;
+        };
+
+        /// Released pages before held ones, then least recently used, then furthest away
+        struct EvictionOrder
+        {
+            bool operator()(const EvictionCandidate& a, const EvictionCandidate& b) const
+            {
+                if (a.held != b.held)
+                    return !a.held;
+                if (a.frameLastHeld != b.frameLastHeld)
+                    return a.frameLastHeld < b.frameLastHeld;
+                return a.priority < b.priority;
+            }
+        };
+    }
     //---------------------------------------------------------------------
     PageManager::PageManager()
         : mWorldNameGenerator("World")
@@ -48,6 +73,7 @@ namespace Ogre
         , mPageResourceGroup(ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME)
         , mDebugDisplayLvl(0)
         , mPagingEnabled(true)
+        , mMemoryBudget(0)
         , mGrid2DPageStrategy(0)
         , mGrid3DPageStrategy(0)
         , mSimpleCollectionFactory(0)
@@ -500,6 +526,78 @@ namespace Ogre
         return mCameraList;
     }
     //---------------------------------------------------------------------
+    size_t PageManager::getMemoryUsage() const
+    {
+        size_t bytes = 0;
+        for (WorldMap::const_iterator w = mWorlds.begin(); w != mWorlds.end(); ++w)
+        {
+            const PagedWorld::SectionMap& sections = w->second->getSections();
+            for (PagedWorld::SectionMap::const_iterator s = sections.begin(); s != sections.end(); ++s)
+            {
+                const PagedWorldSection::PageMap& pages = s->second->getPages();
+                for (PagedWorldSection::PageMap::const_iterator p = pages.begin(); p != pages.end(); ++p)
+                    bytes += s->second->getPageMemoryUsage(p->second);
+            }
+        }
+        return bytes;
+    }
+    //---------------------------------------------------------------------
+    void PageManager::enforceMemoryBudget()
+    {
+        if (!mPagingEnabled)
+            return;
+
+        size_t usage = 0;
+        vector<EvictionCandidate>::type candidates;
+        for (WorldMap::iterator w = mWorlds.begin(); w != mWorlds.end(); ++w)
+        {
+            const PagedWorld::SectionMap& sections = w->second->getSections();
+            for (PagedWorld::SectionMap::const_iterator s = sections.begin(); s != sections.end(); ++s)
+            {
+                const PagedWorldSection::PageMap& pages = s->second->getPages();
+                for (PagedWorldSection::PageMap::const_iterator p = pages.begin(); p != pages.end(); ++p)
+                {
+                    Page* page = p->second;
+                    EvictionCandidate c;
+                    c.page = page;
+                    c.bytes = s->second->getPageMemoryUsage(page);
+                    usage += c.bytes;
+                    // requested pages would only be loaded again next frame, and
+                    // pages still being prepared must finish before they can unload
+                    if (!c.bytes || page->isRequested() || page->isDeferredProcessInProgress())
+                        continue;
+                    c.held = page->isHeld();
+                    c.frameLastHeld = page->getFrameLastHeld();
+                    c.priority = 0;
+                    candidates.push_back(c);
+                }
+            }
+        }
+
+        mStatistics.peakMemoryUsage = std::max(mStatistics.peakMemoryUsage, usage);
+        if (!mMemoryBudget || usage <= mMemoryBudget)
+            return;
+
+        for (vector<EvictionCandidate>::type::iterator c = candidates.begin(); c != candidates.end(); ++c)
+            c->priority = c->page->getParentSection()->getLoadPriority(c->page->getID());
+        std::sort(candidates.begin(), candidates.end(), EvictionOrder());
+
+        for (vector<EvictionCandidate>::type::iterator c = candidates.begin();
+            c != candidates.end() && usage > mMemoryBudget; ++c)
+        {
+            usage -= c->bytes;
+            c->page->getParentSection()->unloadPage(c->page);
+            ++mStatistics.evictions;
+        }
+    }
+    //---------------------------------------------------------------------
+    void PageManager::_notifyPageLoaded(Page* page, unsigned long microseconds)
+    {
+        ++mStatistics.loads;
+        mStatistics.totalLoadTime += microseconds;
+        mStatistics.maxLoadTime = std::max(mStatistics.maxLoadTime, microseconds);
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     void PageManager::EventRouter::cameraPreRenderScene(Camera* cam)
     {
@@ -539,6 +637,9 @@ namespace Ogre
         for(WorldMap::iterator i = pWorldMap->begin(); i != pWorldMap->end(); ++i)
             i->second->frameEnd(evt.timeSinceLastFrame);
 
+        if (pManager->getMemoryBudget())
+            pManager->enforceMemoryBudget();
+
         return true;
     }
 
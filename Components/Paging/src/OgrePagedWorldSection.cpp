@@ -218,10 +218,33 @@ namespace Ogre
                     ret.first->second = page;
                 }
             }
+            getManager()->_notifyPageMiss();
             page->load(sync);
         }
         else
-            i->second->touch();
+        {
+            // a page which had been released but was still resident
+            if (!i->second->isRequested())
+                getManager()->_notifyPageHit();
+            i->second->_notifyRequested();
+            // the camera may have moved since the page was requested
+            i->second->updateLoadPriority();
+        }
+    }
+    //---------------------------------------------------------------------
+    Real PagedWorldSection::getLoadPriority(PageID pageID)
+    {
+        const PageManager::CameraList& cameras = getManager()->getCameraList();
+        if (cameras.empty())
+            return 0;
+
+        Real priority = -std::numeric_limits<Real>::max();
+        for (PageManager::CameraList::const_iterator c = cameras.begin(); c != cameras.end(); ++c)
+        {
+            priority = std::max(priority,
+                mStrategy->getLoadPriority(pageID, (*c)->getDerivedPosition(), this));
+        }
+        return priority;
     }
     //---------------------------------------------------------------------
     void PagedWorldSection::unloadPage(PageID pageID, bool sync)
@@ -338,7 +361,7 @@ namespace Ogre
             Page* p = i->second;
             // pre-increment since unloading will remove it
             ++i;
-            if (!p->isHeld())
+            if (!p->isHeld() && !isRetainable(p))
                 unloadPage(p);
             else
                 p->frameEnd(timeElapsed);
@@ -346,6 +369,19 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
+    bool PagedWorldSection::isRetainable(Page* p)
+    {
+        // Pages the budget can't account for, or which are still loading, are
+        // released immediately; the rest wait for PageManager to evict them
+        return getManager()->getMemoryBudget() &&
+            !p->isDeferredProcessInProgress() && getPageMemoryUsage(p);
+    }
+    //---------------------------------------------------------------------
+    size_t PagedWorldSection::getPageMemoryUsage(Page* p) const
+    {
+        return p->getMemoryUsage();
+    }
+    //---------------------------------------------------------------------
     void PagedWorldSection::notifyCamera(Camera* cam)
     {
         mStrategy->notifyCamera(cam, this);
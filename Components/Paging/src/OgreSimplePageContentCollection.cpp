@@ -129,6 +129,14 @@ namespace Ogre
             (*i)->unprepare();
     }
     //---------------------------------------------------------------------
+    size_t SimplePageContentCollection::getMemoryUsage() const
+    {
+        size_t bytes = 0;
+        for (ContentList::const_iterator i = mContentList.begin(); i != mContentList.end(); ++i)
+            bytes += (*i)->getMemoryUsage();
+        return bytes;
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     String SimplePageContentCollectionFactory::FACTORY_NAME = "Simple";
     //---------------------------------------------------------------------
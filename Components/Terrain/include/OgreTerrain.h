@@ -749,6 +749,15 @@ namespace Ogre
         */
         bool isLoaded() const { return mIsLoaded; }
 
+        /** Get the number of bytes used by this terrain.
+        @remarks
+            This covers the height and delta data, the CPU copies of the maps which
+            are waiting to be uploaded, the blend, normal, colour, light and
+            composite map textures and the vertex data. It should only be called
+            from the render thread, like isLoaded.
+        */
+        size_t getMemoryUsage() const;
+
         /** Returns whether this terrain has been modified since it was first loaded / defined. 
         @remarks
             This flag is reset on save().
@@ -1195,6 +1204,17 @@ namespace Ogre
         static const uint8 DERIVED_DATA_NORMALS;
         static const uint8 DERIVED_DATA_LIGHTMAP;
         static const uint8 DERIVED_DATA_ALL;
+        /** Size in points of the square tiles in which dirty regions are tracked 
+            for derived data updates.
+        */
+        static const uint16 DERIVED_DATA_TILE_SIZE;
+        /** Size in quads of the smallest square blocks whose min/max heights are 
+            kept to let rayIntersects skip empty space.
+        */
+        static const uint16 HEIGHT_BOUNDS_BLOCK_SIZE;
+
+        /// List of rectangles, e.g. the dirty tiles of a derived data update
+        typedef vector<Rect>::type RectList;
 
         /** Updates derived data for the terrain (LOD, lighting) to reflect changed height data, in a separate
         thread if threading is enabled (OGRE_THREAD_SUPPORT). 
@@ -1255,6 +1275,15 @@ namespace Ogre
         */
         Rect calculateHeightDeltas(const Rect& rect);
 
+        /** Calculate (or recalculate) the height deltas in several areas at once.
+        @remarks
+            Every LOD cell touched by any of the rectangles is evaluated once, and
+            the cells are spread across the threads of the Root's ThreadPool.
+        @param rects Rectangles describing the areas in which heights have altered
+        @return A Rectangle bounding all areas which were updated
+        */
+        Rect calculateHeightDeltas(const RectList& rects);
+
         /** Finalise the height deltas. 
         Calculated height deltas are kept in a separate calculation field to make
         them safe to perform in a background thread. This call promotes those
@@ -1298,6 +1327,16 @@ namespace Ogre
         */
         void finaliseLightmap(const Rect& rect, PixelBox* lightmapBox);
 
+        /** Compare the lightmap produced by the horizon sweep with the per-texel ray cast.
+        @remarks
+            calculateLightmap sweeps the height data along the light direction unless
+            TerrainGlobalOptions::setUseRayCastLightmap has been enabled. This evaluates
+            both methods over the whole lightmap, so it costs as much as the ray cast 
+            and is only intended for validating the sweep against the reference.
+        @return The fraction of lightmap texels whose shadowing differs between the two
+        */
+        Real compareLightmapMethods();
+
         /** Gets the resolution of the entire terrain (down one edge) at a 
             given LOD level. 
         */
@@ -1313,6 +1352,10 @@ namespace Ogre
          @return A pair which contains whether the ray hit the terrain and, if so, where.
          @remarks This can be called from any thread as long as no parallel write to
          the heightmap data occurs.
+         @par
+            Blocks of the terrain which the ray passes above or below are skipped using 
+            min/max heights that are kept up to date by dirtyRect, so height data 
+            modified directly must be dirtied before casting rays against it.
          */
         std::pair<bool, Vector3> rayIntersects(const Ray& ray, 
             bool cascadeToNeighbours = false, Real distanceLimit = 0); //const;
@@ -1632,6 +1675,15 @@ namespace Ogre
         /** Query whether a derived data update is in progress or not. */
         bool isDerivedDataUpdateInProgress() const { return mDerivedDataUpdateInProgress; }
 
+        /** Get the priority of background requests issued by this terrain.
+        @remarks
+            This is the negated distance between the terrain and the LOD camera it
+            was last rendered with, so terrains close to the viewer are processed
+            first (see WorkQueue::addRequest). Returns 0 until the terrain has been
+            rendered.
+        */
+        Real getWorkQueuePriority() const;
+
 
         /// Utility method to convert axes from world space to terrain space (xy terrain, z up)
         static void convertWorldToTerrainAxes(Alignment align, const Vector3& worldVec, Vector3* terrainVec);
@@ -1694,6 +1746,10 @@ namespace Ogre
         void calculateCurrentLod(Viewport* vp);
         /// Test a single quad of the terrain for ray intersection.
         std::pair<bool, Vector3> checkQuadIntersection(int x, int y, const Ray& ray); //const;
+        /// Shadow the lightmap texels in rect (lightmap space) by casting a ray towards the light per texel
+        void calculateLightmapRayCast(const Rect& rect, uint8* pData);
+        /// Shadow the lightmap texels in rect (lightmap space) by sweeping the heights along the light direction
+        void calculateLightmapHorizon(const Rect& rect, uint8* pData);
 
         /// Delete blend maps for all layers >= lowIndex
         void deleteBlendMaps(uint8 lowIndex);
@@ -1712,7 +1768,20 @@ namespace Ogre
         void deriveUVMultipliers();
         PixelFormat getBlendTextureFormat(uint8 textureIndex, uint8 numLayers) const;
 
-        void updateDerivedDataImpl(const Rect& rect, const Rect& lightmapExtraRect, bool synchronous, uint8 typeMask);
+        void updateDerivedDataImpl(const Rect& rect, const RectList& rects, const Rect& lightmapExtraRect, 
+            bool synchronous, uint8 typeMask);
+        /// Merge an area into the dirty derived data
+        void mergeDirtyDerivedDataRect(const Rect& rect);
+        /// Cover the given areas with tile aligned rectangles, merging adjacent tiles
+        void tileDerivedDataRects(const RectList& rects, RectList& outTiles) const;
+        /// Calculate the normal of a point which may need heights from neighbours
+        void calculateNormalFromSelfOrNeighbour(long x, long y, Vector3& outNormal) const;
+        /// Recalculate the min/max height blocks covering the given area of points
+        void updateHeightBounds(const Rect& rect);
+        /** Test whether a ray in local vertex space passes entirely above or below a 
+            block of the height bounds, so that none of the block's quads can be hit.
+        */
+        bool rayMissesHeightBounds(const Ray& localRay, size_t level, long blockX, long blockZ) const;
 
         void getEdgeRect(NeighbourIndex index, long range, Rect* outRect) const;
         // get the equivalent of the passed in edge rectangle in neighbour
@@ -1737,6 +1806,11 @@ namespace Ogre
         float* mHeightData;
         /// The delta information defining how a vertex moves before it is removed at a lower LOD
         float* mDeltaData;
+        typedef vector<float>::type HeightBoundsLevel;
+        /** Interleaved min/max heights of square blocks of quads, starting with blocks 
+            of HEIGHT_BOUNDS_BLOCK_SIZE and merging 2x2 blocks per level up to a single block.
+        */
+        vector<HeightBoundsLevel>::type mHeightBounds;
         Alignment mAlign;
         Real mWorldSize;
         uint16 mSize;
@@ -1762,6 +1836,8 @@ namespace Ogre
 
         Rect mDirtyGeometryRect;
         Rect mDirtyDerivedDataRect;
+        /// The individual areas merged into mDirtyDerivedDataRect
+        RectList mDirtyDerivedDataRects;
         Rect mDirtyGeometryRectForNeighbours;
         Rect mDirtyLightmapFromNeighboursRect;
         bool mDerivedDataUpdateInProgress;
@@ -1778,6 +1854,8 @@ namespace Ogre
             // types requested
             uint8 typeMask;
             Rect dirtyRect;
+            /// The dirty area as tile aligned rectangles, for the types that are local
+            RectList dirtyTiles;
             Rect lightmapExtraDirtyRect;
             _OgreTerrainExport friend std::ostream& operator<<(std::ostream& o, const DerivedDataRequest& r)
             { return o; }       
@@ -1791,12 +1869,12 @@ namespace Ogre
             uint8 remainingTypeMask;
             /// The area of deltas that was updated
             Rect deltaUpdateRect;
-            /// The area of normals that was updated
-            Rect normalUpdateRect;
+            /// The areas of normals that were updated, one per dirty tile rectangle
+            RectList normalUpdateRects;
             /// The area of lightmap that was updated
             Rect lightmapUpdateRect;
             /// All CPU-side data, independent of textures; to be blitted in main thread
-            PixelBox* normalMapBox;
+            vector<PixelBox*>::type normalMapBoxes;
             PixelBox* lightMapBox;
             _OgreTerrainExport friend std::ostream& operator<<(std::ostream& o, const DerivedDataResponse& r)
             { return o; }       
@@ -1872,6 +1950,8 @@ namespace Ogre
         PixelBox* mCpuTerrainNormalMap;
 
         const Camera* mLastLODCamera;
+        /// Derived position of mLastLODCamera, used for request priorities
+        Vector3 mLastLODCameraPosition;
         unsigned long mLastLODFrame;
         int mLastViewportHeight;
 
@@ -1922,6 +2002,7 @@ namespace Ogre
         uint32 mVisibilityFlags;
         uint32 mQueryFlags;
         bool mUseRayBoxDistanceCalculation;
+        bool mUseRayCastLightmap;
         TerrainMaterialGeneratorPtr mDefaultMaterialGenerator;
         uint16 mLayerBlendMapSize;
         Real mDefaultLayerTextureWorldSize;
@@ -2083,6 +2164,22 @@ namespace Ogre
         */
         void setLightMapSize(uint16 sz) { mLightmapSize = sz;}
 
+        /** Returns whether lightmaps are calculated by casting a ray per texel
+            rather than by sweeping the height data along the light direction. 
+        */
+        bool getUseRayCastLightmap() const { return mUseRayCastLightmap; }
+
+        /** Sets whether lightmaps are calculated by casting a ray towards the light
+            from every texel, cascading into neighbouring terrains. 
+        @remarks
+            By default the lightmap is calculated by sweeping lines of texels along
+            the light direction, carrying the height of the shadow cast so far. This
+            visits every height sample once per line and runs on the Root's thread
+            pool, which is much faster than a ray per texel. The ray cast is kept as
+            a reference, see Terrain::compareLightmapMethods.
+        */
+        void setUseRayCastLightmap(bool rc) { mUseRayCastLightmap = rc; }
+
         /** Get the default size of the composite maps for a new terrain. 
         */
         uint16 getCompositeMapSize() const { return mCompositeMapSize; }
@@ -416,6 +416,32 @@ namespace Ogre
          the terrain data occurs.
          */
         RayResult rayIntersects(const Ray& ray, Real distanceLimit = 0) const; 
+
+        typedef vector<Ray>::type RayList;
+        typedef vector<RayResult>::type RayResultList;
+        /** Test a batch of rays for intersection with any terrain in the group.
+        @remarks
+            Gives the same results as calling rayIntersects for each ray, but the rays 
+            are spread over the Root's ThreadPool. No terrain data may be written while
+            this runs.
+        @param rays The rays to test
+        @param results Receives one result per ray, in the same order
+        @param distanceLimit As for rayIntersects, applied to every ray
+        */
+        void rayIntersects(const RayList& rays, RayResultList& results, Real distanceLimit = 0) const;
+
+        /// A line segment from its first to its second world space point
+        typedef std::pair<Vector3, Vector3> Segment;
+        typedef vector<Segment>::type SegmentList;
+        /** Test a batch of line segments for intersection with any terrain in the group.
+        @remarks
+            Each segment is cast as a ray from its start towards its end, a hit only 
+            counts if it lies no further away than the end. Like the batched rayIntersects, 
+            the segments are spread over the Root's ThreadPool.
+        @param segments The segments to test
+        @param results Receives one result per segment, in the same order
+        */
+        void segmentIntersects(const SegmentList& segments, RayResultList& results) const;
         
         typedef vector<Terrain*>::type TerrainList; 
         /** Test intersection of a box with the terrain. 
@@ -521,6 +547,15 @@ namespace Ogre
          */
         size_t getNumTerrainPrepareRequests() const;
 
+        /** Set the position that background terrain loads are prioritised around.
+        @remarks
+            Terrains closer to this position are prepared first. Calling this
+            again re-prioritises the prepare requests that are still pending.
+        */
+        void setLoadPriorityPosition(const Vector3& pos);
+        /// Get the position that background terrain loads are prioritised around
+        const Vector3& getLoadPriorityPosition() const { return mLoadPriorityPosition; }
+
     protected:
         typedef std::map<TerrainSlot*, WorkQueue::RequestID> TerrainPrepareRequestMap;
         SceneManager *mSceneManager;
@@ -537,6 +572,8 @@ namespace Ogre
         String mResourceGroup;
         TerrainAutoUpdateLod *mAutoUpdateLod;
         Terrain::DefaultGpuBufferAllocator mBufferAllocator;
+        Vector3 mLoadPriorityPosition;
+        bool mLoadPriorityPositionSet;
         
         /// Get the position of a terrain instance
         Vector3 getTerrainSlotPosition(long x, long y);
@@ -547,6 +584,8 @@ namespace Ogre
         void connectNeighbour(TerrainSlot* slot, long offsetx, long offsety);
 
         void loadTerrainImpl(TerrainSlot* slot, bool synchronous);
+        /// Work queue priority of a slot's prepare request
+        Real getLoadPriority(const TerrainSlot* slot) const;
 
         /// Structure for holding the load request
         struct LoadRequest
@@ -31,6 +31,7 @@ THE SOFTWARE.
 
 #include "OgreTerrainPrerequisites.h"
 #include "OgreWorkQueue.h"
+#include "OgreStreamSerialiser.h"
 
 
 namespace Ogre
@@ -101,6 +102,21 @@ namespace Ogre
         /// Save each LOD level separately compressed so seek is possible
         static void saveLodData(StreamSerialiser& stream, Terrain* terrain);
 
+        /** Write LOD geometry data in the layout of TERRAINLODDATA_CHUNK_VERSION 2
+          @param stream The stream to write to
+          @param data The height or delta values of one LOD level
+          @param count The number of values
+          @remarks The values are stored losslessly. When they only take a limited number of
+                distinct values, as height data imported from an image does, they are written
+                as a sorted palette and the differences between successive palette indices.
+                Otherwise the differences between successive values in an order preserving
+                integer form are written. Either way the differences are split into byte
+                planes, which leaves long runs of zero bytes for the deflate stage.
+          */
+        static void encodeLodData(StreamSerialiser& stream, const float* data, size_t count);
+        /// Read LOD geometry data written by encodeLodData
+        static void decodeLodData(StreamSerialiser& stream, float* data, size_t count);
+
         /** Copy geometry data from buffer to mHeightData/mDeltaData
           @param lodLevel A LOD level to work with
           @param data Buffer which holds geometry data if separated form
@@ -112,7 +128,9 @@ namespace Ogre
           @param lowerLodBound Lower bound of LOD levels to load
           @param higherLodBound Upper bound of LOD levels to load
           @remarks Geometry data are uncompressed using inflate() and stored into
-                allocated buffer
+                allocated buffer. The stream positions of the LOD data chunks are
+                looked up on the first call, later calls seek straight to the chunks
+                they need.
           */
         void readLodData(uint16 lowerLodBound, uint16 higherLodBound);
         void waitForDerivedProcesses();
@@ -130,6 +148,8 @@ namespace Ogre
     private:
         void init();
         void buildLodInfoTable();
+        /// Find the stream position of the data chunk of each LOD level
+        void buildLodChunkIndex();
 
         /** Separate geometry data by LOD level
         @param data A geometry data to separate i.e. mHeightData/mDeltaData
@@ -153,6 +173,9 @@ namespace Ogre
         Terrain* mTerrain;
         DataStreamPtr mDataStream;
         size_t mStreamOffset;
+        /// Stream position of the data chunk of each LOD level, empty until needed
+        vector<size_t>::type mLodChunkOffsets;
+        StreamSerialiser::Endian mStreamEndian;
         uint16 mWorkQueueChannel;
 
         LodInfo* mLodInfoTable;
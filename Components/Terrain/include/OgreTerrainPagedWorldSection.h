@@ -147,12 +147,17 @@ namespace Ogre
         void loadPage(PageID pageID, bool forceSynchronous = false);
         /// Overridden from PagedWorldSection
         void unloadPage(PageID pageID, bool forceSynchronous = false);
+        /// Overridden from PagedWorldSection, adds the memory used by the loaded Terrain of the page
+        size_t getPageMemoryUsage(Page* p) const;
 
         /// WorkQueue::RequestHandler override
         WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ);
         /// WorkQueue::ResponseHandler override
         void handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ);
 
+        /// Overridden from PagedWorldSection, also re-prioritises pending terrain loads
+        void notifyCamera(Camera* cam);
+
         static const uint16 WORKQUEUE_LOAD_TERRAIN_PAGE_REQUEST;
 
         class TerrainDefiner : public TerrainAlloc
@@ -181,6 +186,9 @@ namespace Ogre
         unsigned long mNextLoadingTime;
         uint32 mLoadingIntervalMs;
 
+        /// Move the page with the highest load priority to the front of mPagesInLoading
+        void sortPagesInLoading();
+
         /// Overridden from PagedWorldSection
         void loadSubtypeData(StreamSerialiser& ser);
         void saveSubtypeData(StreamSerialiser& ser);
@@ -127,6 +127,11 @@ namespace Ogre
         void unprepare();
         /// Save node to a stream
         void save(StreamSerialiser& stream);
+        /** Get the number of bytes used by the vertex data of this node and its children.
+        @remarks
+            Index buffers are shared between nodes of the same size and are not included.
+        */
+        size_t getMemoryUsage() const;
 
         struct _OgreTerrainExport LodLevel : public TerrainAlloc
         {
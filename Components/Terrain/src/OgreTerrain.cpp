@@ -49,6 +49,7 @@ THE SOFTWARE.
 #include "OgreTimer.h"
 #include "OgreTerrainMaterialGeneratorA.h"
 #include "OgreFileSystemLayer.h"
+#include "OgreThreadPool.h"
 
 #if OGRE_COMPILER == OGRE_COMPILER_MSVC
 // we do lots of conversions here, casting them all is tedious & cluttered, we know what we're doing
@@ -82,6 +83,8 @@ namespace Ogre
     const uint8 Terrain::DERIVED_DATA_LIGHTMAP = 4;
     // This MUST match the bitwise OR of all the types above with no extra bits!
     const uint8 Terrain::DERIVED_DATA_ALL = 7;
+    const uint16 Terrain::DERIVED_DATA_TILE_SIZE = 32;
+    const uint16 Terrain::HEIGHT_BOUNDS_BLOCK_SIZE = 8;
     //-----------------------------------------------------------------------
     template<> TerrainGlobalOptions* Singleton<TerrainGlobalOptions>::msSingleton = 0;
     TerrainGlobalOptions* TerrainGlobalOptions::getSingletonPtr(void)
@@ -104,6 +107,7 @@ namespace Ogre
         , mVisibilityFlags(0xFFFFFFFF)
         , mQueryFlags(0xFFFFFFFF)
         , mUseRayBoxDistanceCalculation(false)
+        , mUseRayCastLightmap(false)
         , mLayerBlendMapSize(1024)
         , mDefaultLayerTextureWorldSize(10)
         , mDefaultGlobalColourMapSize(1024)
@@ -193,6 +197,7 @@ namespace Ogre
         , mCompositeMapRequired(false)
         , mCpuTerrainNormalMap(0)
         , mLastLODCamera(0)
+        , mLastLODCameraPosition(Vector3::ZERO)
         , mLastLODFrame(0)
         , mLastViewportHeight(0)
         , mCustomGpuBufferAllocator(0)
@@ -246,6 +251,13 @@ namespace Ogre
             return mQuadTree->getAABB();
     }
     //---------------------------------------------------------------------
+    Real Terrain::getWorkQueuePriority() const
+    {
+        if (!mLastLODCamera)
+            return 0;
+        return -getWorldAABB().distance(mLastLODCameraPosition);
+    }
+    //---------------------------------------------------------------------
     AxisAlignedBox Terrain::getWorldAABB() const
     {
         Affine3 m = Affine3::IDENTITY;
@@ -791,6 +803,8 @@ namespace Ogre
         mQuadTree = OGRE_NEW TerrainQuadTreeNode(this, 0, 0, 0, mSize, mNumLodLevels - 1, 0, 0);
         mQuadTree->prepare(stream);
 
+        updateHeightBounds(Rect(0, 0, mSize, mSize));
+
         // stop uncompressing
         if(mainChunk->version > 1)
             stream.stopDeflate();
@@ -931,6 +945,7 @@ namespace Ogre
         rect.left = 0; rect.right = mSize;
         calculateHeightDeltas(rect);
         finaliseHeightDeltas(rect, true);
+        updateHeightBounds(rect);
 
         distributeVertexData();
 
@@ -1166,7 +1181,7 @@ namespace Ogre
 
         Root::getSingleton().getWorkQueue()->addRequest(
             mWorkQueueChannel, WORKQUEUE_GENERATE_MATERIAL_REQUEST, 
-            Any(req), 0, synchronous);
+            Any(req), 0, synchronous, false, getWorkQueuePriority());
     }
     //---------------------------------------------------------------------
     void Terrain::unload()
@@ -1192,6 +1207,45 @@ namespace Ogre
             mQuadTree->unprepare();
     }
     //---------------------------------------------------------------------
+    size_t Terrain::getMemoryUsage() const
+    {
+        size_t bytes = 0;
+        size_t points = (size_t)mSize * mSize;
+        if (mHeightData)
+            bytes += points * sizeof(float);
+        if (mDeltaData)
+            bytes += points * sizeof(float);
+
+        // CPU data only lives between prepare and load
+        uint8 numLayers = getLayerCount();
+        for (size_t i = 0; i < mCpuBlendMapStorage.size(); ++i)
+        {
+            bytes += PixelUtil::getMemorySize(mLayerBlendMapSize, mLayerBlendMapSize, 1,
+                getBlendTextureFormat(static_cast<uint8>(i), numLayers));
+        }
+        if (mCpuTerrainNormalMap)
+            bytes += mCpuTerrainNormalMap->getConsecutiveSize();
+        if (mCpuColourMapStorage)
+            bytes += (size_t)mGlobalColourMapSize * mGlobalColourMapSize * 3;
+        if (mCpuLightmapStorage)
+            bytes += (size_t)mLightmapSize * mLightmapSize;
+        if (mCpuCompositeMapStorage)
+            bytes += (size_t)mCompositeMapSize * mCompositeMapSize * 4;
+
+        for (TexturePtrList::const_iterator i = mBlendTextureList.begin(); i != mBlendTextureList.end(); ++i)
+            bytes += (*i)->getSize();
+        const TexturePtr* maps[] = {&mTerrainNormalMap, &mColourMap, &mLightmap, &mCompositeMap};
+        for (int i = 0; i < 4; ++i)
+        {
+            if (*maps[i])
+                bytes += (*maps[i])->getSize();
+        }
+
+        if (mQuadTree)
+            bytes += mQuadTree->getMemoryUsage();
+        return bytes;
+    }
+    //---------------------------------------------------------------------
     float* Terrain::getHeightData() const
     {
         return mHeightData;
@@ -1884,8 +1938,9 @@ namespace Ogre
     {
         mDirtyGeometryRect.merge(rect);
         mDirtyGeometryRectForNeighbours.merge(rect);
-        mDirtyDerivedDataRect.merge(rect);
+        mergeDirtyDerivedDataRect(rect);
         mCompositeMapDirtyRect.merge(rect);
+        updateHeightBounds(rect);
 
         mModified = true;
         mHeightDataModified = true;
@@ -1900,7 +1955,7 @@ namespace Ogre
     //---------------------------------------------------------------------
     void Terrain::dirtyLightmapRect(const Rect& rect)
     {
-        mDirtyDerivedDataRect.merge(rect);
+        mergeDirtyDerivedDataRect(rect);
 
         mModified = true;
 
@@ -1954,9 +2009,10 @@ namespace Ogre
             }
             else
             {
-                updateDerivedDataImpl(mDirtyDerivedDataRect, mDirtyLightmapFromNeighboursRect, 
-                    synchronous, typeMask);
+                updateDerivedDataImpl(mDirtyDerivedDataRect, mDirtyDerivedDataRects, 
+                    mDirtyLightmapFromNeighboursRect, synchronous, typeMask);
                 mDirtyDerivedDataRect.setNull();
+                mDirtyDerivedDataRects.clear();
                 mDirtyLightmapFromNeighboursRect.setNull();
             }
         }
@@ -1971,8 +2027,8 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
-    void Terrain::updateDerivedDataImpl(const Rect& rect, const Rect& lightmapExtraRect, 
-        bool synchronous, uint8 typeMask)
+    void Terrain::updateDerivedDataImpl(const Rect& rect, const RectList& rects, 
+        const Rect& lightmapExtraRect, bool synchronous, uint8 typeMask)
     {
         mDerivedDataUpdateInProgress = true;
         mDerivedUpdatePendingMask = 0;
@@ -1980,6 +2036,7 @@ namespace Ogre
         DerivedDataRequest req;
         req.terrain = this;
         req.dirtyRect = rect;
+        tileDerivedDataRects(rects, req.dirtyTiles);
         req.lightmapExtraDirtyRect = lightmapExtraRect;
         req.typeMask = typeMask;
         if (!mNormalMapRequired)
@@ -1989,7 +2046,7 @@ namespace Ogre
 
         Root::getSingleton().getWorkQueue()->addRequest(
             mWorkQueueChannel, WORKQUEUE_DERIVED_DATA_REQUEST, 
-            Any(req), 0, synchronous);
+            Any(req), 0, synchronous, false, getWorkQueuePriority());
 
     }
     //---------------------------------------------------------------------
@@ -2004,6 +2061,72 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
+    void Terrain::mergeDirtyDerivedDataRect(const Rect& rect)
+    {
+        mDirtyDerivedDataRect.merge(rect);
+        mDirtyDerivedDataRects.push_back(rect);
+
+        // many small edits between updates, e.g. brush strokes, are collapsed 
+        // into their tiles so the list doesn't keep growing
+        if (mDirtyDerivedDataRects.size() > 256)
+        {
+            RectList tiles;
+            tileDerivedDataRects(mDirtyDerivedDataRects, tiles);
+            mDirtyDerivedDataRects.swap(tiles);
+        }
+    }
+    //---------------------------------------------------------------------
+    void Terrain::tileDerivedDataRects(const RectList& rects, RectList& outTiles) const
+    {
+        outTiles.clear();
+        long tileSize = DERIVED_DATA_TILE_SIZE;
+        long numTiles = (mSize + tileSize - 1) / tileSize;
+        vector<uint8>::type dirty(numTiles * numTiles, 0);
+        for (RectList::const_iterator i = rects.begin(); i != rects.end(); ++i)
+        {
+            long left = std::max(0L, i->left);
+            long top = std::max(0L, i->top);
+            long right = std::min((long)mSize, i->right);
+            long bottom = std::min((long)mSize, i->bottom);
+            if (left >= right || top >= bottom)
+                continue;
+            for (long ty = top / tileSize; ty <= (bottom - 1) / tileSize; ++ty)
+                for (long tx = left / tileSize; tx <= (right - 1) / tileSize; ++tx)
+                    dirty[ty * numTiles + tx] = 1;
+        }
+
+        // runs of dirty tiles along a row, extended downwards while the rows
+        // below have the same run
+        for (long ty = 0; ty < numTiles; ++ty)
+        {
+            for (long tx = 0; tx < numTiles; )
+            {
+                if (!dirty[ty * numTiles + tx])
+                {
+                    ++tx;
+                    continue;
+                }
+                long runEnd = tx;
+                while (runEnd < numTiles && dirty[ty * numTiles + runEnd])
+                    ++runEnd;
+
+                Rect run(tx * tileSize, ty * tileSize, 
+                    std::min(runEnd * tileSize, (long)mSize), std::min((ty + 1) * tileSize, (long)mSize));
+                RectList::iterator above = outTiles.begin();
+                for (; above != outTiles.end(); ++above)
+                {
+                    if (above->bottom == run.top && above->left == run.left && above->right == run.right)
+                        break;
+                }
+                if (above != outTiles.end())
+                    above->bottom = run.bottom;
+                else
+                    outTiles.push_back(run);
+                tx = runEnd;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
     void Terrain::freeCPUResources()
     {
         OGRE_FREE(mHeightData, MEMCATEGORY_GEOMETRY);
@@ -2012,6 +2135,8 @@ namespace Ogre
         OGRE_FREE(mDeltaData, MEMCATEGORY_GEOMETRY);
         mDeltaData = 0;
 
+        mHeightBounds.clear();
+
         OGRE_DELETE mQuadTree;
         mQuadTree = 0;
 
@@ -2094,51 +2219,114 @@ namespace Ogre
     //---------------------------------------------------------------------
     Rect Terrain::calculateHeightDeltas(const Rect& rect)
     {
-        Rect clampedRect(rect);
-        clampedRect.left = std::max(0L, clampedRect.left);
-        clampedRect.top = std::max(0L, clampedRect.top);
-        clampedRect.right = std::min((long)mSize, clampedRect.right);
-        clampedRect.bottom = std::min((long)mSize, clampedRect.bottom);
+        return calculateHeightDeltas(RectList(1, rect));
+    }
+    //---------------------------------------------------------------------
+    namespace
+    {
+        /// Number of vertices whose height delta is evaluated per thread pool task
+        const long DELTA_VERTICES_PER_TASK = 4096;
+        /// Number of points whose normal is calculated per thread pool task
+        const long NORMAL_POINTS_PER_TASK = 4096;
 
-        Rect finalRect(clampedRect);
+        /** The largest height deltas within one cell of a LOD level.
+        @remarks
+            The vertices of the cell's left column and bottom row can lie on the
+            boundary between two quadtree nodes and count for both of them, so they
+            are kept apart from those inside the cell.
+        */
+        struct CellHeightDeltas
+        {
+            Real inner;
+            Real left;
+            Real bottom;
+        };
+    }
+    //---------------------------------------------------------------------
+    Rect Terrain::calculateHeightDeltas(const RectList& rects)
+    {
+        Rect finalRect(0, 0, 0, 0);
+        for (RectList::const_iterator r = rects.begin(); r != rects.end(); ++r)
+        {
+            Rect clampedRect(*r);
+            clampedRect.left = std::max(0L, clampedRect.left);
+            clampedRect.top = std::max(0L, clampedRect.top);
+            clampedRect.right = std::min((long)mSize, clampedRect.right);
+            clampedRect.bottom = std::min((long)mSize, clampedRect.bottom);
+
+            finalRect.merge(clampedRect);
+
+            mQuadTree->preDeltaCalculation(clampedRect);
+        }
 
-        mQuadTree->preDeltaCalculation(clampedRect);
+        Root* root = Root::getSingletonPtr();
+        ThreadPool* pool = root ? root->getThreadPool() : 0;
+        vector<long>::type cells;
+        vector<uint8>::type cellTouched;
+        vector<CellHeightDeltas>::type cellDeltas;
 
         /// Iterate over target levels, 
         for (int targetLevel = 1; targetLevel < mNumLodLevels; ++targetLevel)
         {
             int sourceLevel = targetLevel - 1;
-            int step = 1 << targetLevel;
-            // The step of the next higher LOD
-//          int higherstep = step >> 1;
-
-            // need to widen the dirty rectangle since change will affect surrounding
-            // vertices at lower LOD
-            Rect widenedRect(rect);
-            widenedRect.left = std::max(0L, widenedRect.left - step);
-            widenedRect.top = std::max(0L, widenedRect.top - step);
-            widenedRect.right = std::min((long)mSize, widenedRect.right + step);
-            widenedRect.bottom = std::min((long)mSize, widenedRect.bottom + step);
-
-            // keep a merge of the widest
-            finalRect.merge(widenedRect);
-            
+            long step = 1L << targetLevel;
+            long numCells = (mSize - 1) / step;
 
-            // now round the rectangle at this level so that it starts & ends on 
-            // the step boundaries
-            Rect lodRect(widenedRect);
-            lodRect.left -= lodRect.left % step;
-            lodRect.top -= lodRect.top % step;
-            if (lodRect.right % step)
-                lodRect.right += step - (lodRect.right % step);
-            if (lodRect.bottom % step)
-                lodRect.bottom += step - (lodRect.bottom % step);
-
-            for (long j = lodRect.top; j < lodRect.bottom - step; j += step )
+            // collect each cell touched by any of the rectangles once
+            cells.clear();
+            cellTouched.assign(numCells * numCells, 0);
+            for (RectList::const_iterator r = rects.begin(); r != rects.end(); ++r)
             {
-                for (long i = lodRect.left; i < lodRect.right - step; i += step )
+                // need to widen the dirty rectangle since change will affect surrounding
+                // vertices at lower LOD
+                Rect widenedRect(*r);
+                widenedRect.left = std::max(0L, widenedRect.left - step);
+                widenedRect.top = std::max(0L, widenedRect.top - step);
+                widenedRect.right = std::min((long)mSize, widenedRect.right + step);
+                widenedRect.bottom = std::min((long)mSize, widenedRect.bottom + step);
+
+                // keep a merge of the widest
+                finalRect.merge(widenedRect);
+
+                // now round the rectangle at this level so that it starts & ends on 
+                // the step boundaries
+                Rect lodRect(widenedRect);
+                lodRect.left -= lodRect.left % step;
+                lodRect.top -= lodRect.top % step;
+                if (lodRect.right % step)
+                    lodRect.right += step - (lodRect.right % step);
+                if (lodRect.bottom % step)
+                    lodRect.bottom += step - (lodRect.bottom % step);
+
+                for (long j = lodRect.top; j < lodRect.bottom - step; j += step )
                 {
-                    // Form planes relating to the lower detail tris to be produced
+                    for (long i = lodRect.left; i < lodRect.right - step; i += step )
+                    {
+                        long cell = (j / step) * numCells + i / step;
+                        if (!cellTouched[cell])
+                        {
+                            cellTouched[cell] = 1;
+                            cells.push_back(cell);
+                        }
+                    }
+                }
+            }
+
+            cellDeltas.resize(cells.size());
+            const float* heights = mHeightData;
+            float* deltas = mDeltaData;
+            long size = mSize;
+            auto calculateCells = [&](size_t begin, size_t end, size_t)
+            {
+                Real invStep = 1.0f / step;
+                int halfStep = step / 2;
+                for (size_t c = begin; c < end; ++c)
+                {
+                    long i = (cells[c] % numCells) * step;
+                    long j = (cells[c] / numCells) * step;
+
+                    // Interpolate over the lower detail tris to be produced, 
+                    // straight from the height data
                     // For even tri strip rows, they are this shape:
                     // 2---3
                     // | / |
@@ -2147,27 +2335,15 @@ namespace Ogre
                     // 2---3
                     // | \ |
                     // 0---1
-
-                    Vector3 v0, v1, v2, v3;
-                    getPointAlign(i, j, ALIGN_X_Y, &v0);
-                    getPointAlign(i + step, j, ALIGN_X_Y, &v1);
-                    getPointAlign(i, j + step, ALIGN_X_Y, &v2);
-                    getPointAlign(i + step, j + step, ALIGN_X_Y, &v3);
-
-                    Plane t1, t2;
-                    bool backwardTri = false;
+                    float h0 = heights[j * size + i];
+                    float h1 = heights[j * size + i + step];
+                    float h2 = heights[(j + step) * size + i];
+                    float h3 = heights[(j + step) * size + i + step];
                     // Odd or even in terms of target level
-                    if ((j / step) % 2 == 0)
-                    {
-                        t1.redefine(v0, v1, v3);
-                        t2.redefine(v0, v3, v2);
-                    }
-                    else
-                    {
-                        t1.redefine(v1, v3, v2);
-                        t2.redefine(v0, v1, v2);
-                        backwardTri = true;
-                    }
+                    bool backwardTri = (j / step) % 2 != 0;
+
+                    CellHeightDeltas& cellDelta = cellDeltas[c];
+                    cellDelta.inner = cellDelta.left = cellDelta.bottom = -std::numeric_limits<Real>::max();
 
                     // include the bottommost row of vertices if this is the last row
                     int yubound = (j == (mSize - step)? step : step - 1);
@@ -2177,8 +2353,8 @@ namespace Ogre
                         int xubound = (i == (mSize - step)? step : step - 1);
                         for ( int x = 0; x <= xubound; x++ )
                         {
-                            int fulldetailx = static_cast<int>(i + x);
-                            int fulldetaily = static_cast<int>(j + y);
+                            long fulldetailx = i + x;
+                            long fulldetaily = j + y;
                             if ( fulldetailx % step == 0 && 
                                 fulldetaily % step == 0 )
                             {
@@ -2186,65 +2362,82 @@ namespace Ogre
                                 continue;
                             }
 
-                            Real ypct = (Real)y / (Real)step;
-                            Real xpct = (Real)x / (Real)step;
+                            Real ypct = y * invStep;
+                            Real xpct = x * invStep;
 
                             //interpolated height
-                            Vector3 actualPos;
-                            getPointAlign(fulldetailx, fulldetaily, ALIGN_X_Y, &actualPos);
                             Real interp_h;
                             // Determine which tri we're on 
-                            if ((xpct > ypct && !backwardTri) ||
-                                (xpct > (1-ypct) && backwardTri))
+                            if (!backwardTri)
                             {
-                                // Solve for x/z
-                                interp_h = 
-                                    (-t1.normal.x * actualPos.x
-                                    - t1.normal.y * actualPos.y
-                                    - t1.d) / t1.normal.z;
+                                if (xpct > ypct)
+                                    interp_h = h0 + xpct * (h1 - h0) + ypct * (h3 - h1);
+                                else
+                                    interp_h = h0 + xpct * (h3 - h2) + ypct * (h2 - h0);
                             }
                             else
                             {
-                                // Second tri
-                                interp_h = 
-                                    (-t2.normal.x * actualPos.x
-                                    - t2.normal.y * actualPos.y
-                                    - t2.d) / t2.normal.z;
+                                if (xpct > (1 - ypct))
+                                    interp_h = h3 + (1 - xpct) * (h2 - h3) + (1 - ypct) * (h1 - h3);
+                                else
+                                    interp_h = h0 + xpct * (h1 - h0) + ypct * (h2 - h0);
                             }
 
-                            Real actual_h = actualPos.z;
+                            Real actual_h = heights[fulldetaily * size + fulldetailx];
                             Real delta = interp_h - actual_h;
 
                             // max(delta) is the worst case scenario at this LOD
                             // compared to the original heightmap
-
-                            // tell the quadtree about this 
-                            mQuadTree->notifyDelta(fulldetailx, fulldetaily, sourceLevel, delta);
-
+                            Real& maxDelta = x == 0 ? cellDelta.left : (y == 0 ? cellDelta.bottom : cellDelta.inner);
+                            maxDelta = std::max(maxDelta, delta);
 
                             // If this vertex is being removed at this LOD, 
                             // then save the height difference since that's the move
                             // it will need to make. Vertices to be removed at this LOD
                             // are halfway between the steps, but exclude those that
                             // would have been eliminated at earlier levels
-                            int halfStep = step / 2;
                             if (
                              ((fulldetailx % step) == halfStep && (fulldetaily % halfStep) == 0) ||
                              ((fulldetaily % step) == halfStep && (fulldetailx % halfStep) == 0))
                             {
                                 // Save height difference 
-                                mDeltaData[fulldetailx + (fulldetaily * mSize)] = delta;
+                                deltas[fulldetailx + (fulldetaily * size)] = delta;
                             }
 
                         }
 
                     }
-                } // i
-            } // j
+                }
+            };
+
+            size_t cellsPerTask = std::max(1L, DELTA_VERTICES_PER_TASK / (step * step));
+            if (pool)
+                pool->parallelFor(0, cells.size(), cellsPerTask, calculateCells);
+            else
+                calculateCells(0, cells.size(), 0);
+
+            // tell the quadtree about the deltas; this isn't thread safe, but one
+            // vertex of each group reaches the same nodes as every vertex in it
+            for (size_t c = 0; c < cells.size(); ++c)
+            {
+                uint16 i = static_cast<uint16>((cells[c] % numCells) * step);
+                uint16 j = static_cast<uint16>((cells[c] / numCells) * step);
+                mQuadTree->notifyDelta(i + 1, j + 1, sourceLevel, cellDeltas[c].inner);
+                mQuadTree->notifyDelta(i, j + 1, sourceLevel, cellDeltas[c].left);
+                mQuadTree->notifyDelta(i + 1, j, sourceLevel, cellDeltas[c].bottom);
+            }
 
         } // targetLevel
 
-        mQuadTree->postDeltaCalculation(clampedRect);
+        for (RectList::const_iterator r = rects.begin(); r != rects.end(); ++r)
+        {
+            Rect clampedRect(*r);
+            clampedRect.left = std::max(0L, clampedRect.left);
+            clampedRect.top = std::max(0L, clampedRect.top);
+            clampedRect.right = std::min((long)mSize, clampedRect.right);
+            clampedRect.bottom = std::min((long)mSize, clampedRect.bottom);
+            mQuadTree->postDeltaCalculation(clampedRect);
+        }
 
         return finalRect;
 
@@ -2308,6 +2501,7 @@ namespace Ogre
             || mLastViewportHeight != vpHeight)
         {
             mLastLODCamera = lodCamera;
+            mLastLODCameraPosition = lodCamera->getDerivedPosition();
             mLastLODFrame = frameNum;
             mLastViewportHeight = vpHeight;
             calculateCurrentLod(v);
@@ -2345,6 +2539,146 @@ namespace Ogre
         }
     }
     //---------------------------------------------------------------------
+    namespace
+    {
+        /** Narrow [tMin, tMax] to the part of a ray which lies between lo and hi along
+            one axis, returns false if no part of the ray does.
+        */
+        bool clipRayToSlab(Real origin, Real dir, Real lo, Real hi, Real& tMin, Real& tMax)
+        {
+            if (dir == 0)
+                return origin >= lo && origin <= hi;
+
+            Real t0 = (lo - origin) / dir;
+            Real t1 = (hi - origin) / dir;
+            if (t0 > t1)
+                std::swap(t0, t1);
+            tMin = std::max(tMin, t0);
+            tMax = std::min(tMax, t1);
+            return tMin <= tMax;
+        }
+    }
+    //---------------------------------------------------------------------
+    void Terrain::updateHeightBounds(const Rect& rect)
+    {
+        if (!mHeightData || mSize < 2)
+            return;
+
+        long numQuads = mSize - 1;
+        long blockSize = HEIGHT_BOUNDS_BLOCK_SIZE;
+        long numBlocks = (numQuads + blockSize - 1) / blockSize;
+        // blocks (inclusive) which contain a quad using any of the points in rect
+        long bx0 = 0, bz0 = 0, bx1 = numBlocks - 1, bz1 = numBlocks - 1;
+        if (mHeightBounds.empty())
+        {
+            // build every level, the top one holding a single block
+            for (long levelBlocks = numBlocks; ; levelBlocks = (levelBlocks + 1) / 2)
+            {
+                mHeightBounds.push_back(HeightBoundsLevel(levelBlocks * levelBlocks * 2));
+                if (levelBlocks == 1)
+                    break;
+            }
+        }
+        else
+        {
+            bx0 = std::max(rect.left - 1, 0L) / blockSize;
+            bz0 = std::max(rect.top - 1, 0L) / blockSize;
+            bx1 = std::min(rect.right - 1, numQuads - 1) / blockSize;
+            bz1 = std::min(rect.bottom - 1, numQuads - 1) / blockSize;
+            if (bx0 > bx1 || bz0 > bz1)
+                return;
+        }
+
+        // finest level straight from the height data
+        HeightBoundsLevel& finest = mHeightBounds[0];
+        for (long bz = bz0; bz <= bz1; ++bz)
+        {
+            long z0 = bz * blockSize;
+            long z1 = std::min(z0 + blockSize, numQuads);
+            for (long bx = bx0; bx <= bx1; ++bx)
+            {
+                long x0 = bx * blockSize;
+                long x1 = std::min(x0 + blockSize, numQuads);
+                float minHeight = std::numeric_limits<float>::max();
+                float maxHeight = -std::numeric_limits<float>::max();
+                for (long z = z0; z <= z1; ++z)
+                {
+                    const float* pHeight = mHeightData + z * mSize + x0;
+                    for (long x = x0; x <= x1; ++x, ++pHeight)
+                    {
+                        minHeight = std::min(minHeight, *pHeight);
+                        maxHeight = std::max(maxHeight, *pHeight);
+                    }
+                }
+                float* pBounds = &finest[(bz * numBlocks + bx) * 2];
+                pBounds[0] = minHeight;
+                pBounds[1] = maxHeight;
+            }
+        }
+
+        // merge 2x2 blocks into each coarser level
+        for (size_t level = 1; level < mHeightBounds.size(); ++level)
+        {
+            const HeightBoundsLevel& children = mHeightBounds[level - 1];
+            HeightBoundsLevel& parents = mHeightBounds[level];
+            long numChildBlocks = numBlocks;
+            numBlocks = (numBlocks + 1) / 2;
+            bx0 /= 2; bz0 /= 2; bx1 /= 2; bz1 /= 2;
+            for (long bz = bz0; bz <= bz1; ++bz)
+            {
+                for (long bx = bx0; bx <= bx1; ++bx)
+                {
+                    float minHeight = std::numeric_limits<float>::max();
+                    float maxHeight = -std::numeric_limits<float>::max();
+                    for (long cz = bz * 2; cz <= std::min(bz * 2 + 1, numChildBlocks - 1); ++cz)
+                    {
+                        for (long cx = bx * 2; cx <= std::min(bx * 2 + 1, numChildBlocks - 1); ++cx)
+                        {
+                            const float* pChild = &children[(cz * numChildBlocks + cx) * 2];
+                            minHeight = std::min(minHeight, pChild[0]);
+                            maxHeight = std::max(maxHeight, pChild[1]);
+                        }
+                    }
+                    float* pBounds = &parents[(bz * numBlocks + bx) * 2];
+                    pBounds[0] = minHeight;
+                    pBounds[1] = maxHeight;
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    bool Terrain::rayMissesHeightBounds(const Ray& localRay, size_t level, long blockX, long blockZ) const
+    {
+        long numQuads = mSize - 1;
+        long blockSize = (long)HEIGHT_BOUNDS_BLOCK_SIZE << level;
+        long numBlocks = (numQuads + blockSize - 1) / blockSize;
+        const float* pBounds = &mHeightBounds[level][(blockZ * numBlocks + blockX) * 2];
+
+        // checkQuadIntersection accepts hits up to 0.01 outside a quad, allow a little more
+        const Real edgePad = 0.02f;
+        Real x0 = (Real)(blockX * blockSize) - edgePad;
+        Real z0 = (Real)(blockZ * blockSize) - edgePad;
+        Real x1 = (Real)std::min((blockX + 1) * blockSize, numQuads) + edgePad;
+        Real z1 = (Real)std::min((blockZ + 1) * blockSize, numQuads) + edgePad;
+
+        const Vector3& origin = localRay.getOrigin();
+        const Vector3& dir = localRay.getDirection();
+        Real tMin = 0;
+        Real tMax = std::numeric_limits<Real>::max();
+        // the ray is known to be inside the block, so be conservative if rounding says otherwise
+        if (!clipRayToSlab(origin.x, dir.x, x0, x1, tMin, tMax) ||
+            !clipRayToSlab(origin.z, dir.z, z0, z1, tMin, tMax))
+            return false;
+
+        Real y0 = origin.y + dir.y * tMin;
+        Real y1 = origin.y + dir.y * tMax;
+        // Outside the triangles the quad planes may rise or fall beyond the corner heights
+        // by a small part of the height range, pad for that and for rounding
+        Real heightPad = (pBounds[1] - pBounds[0]) * 0.05f + 0.01f + 
+            (Math::Abs(pBounds[0]) + Math::Abs(pBounds[1])) * 1e-5f;
+        return std::max(y0, y1) < pBounds[0] - heightPad || std::min(y0, y1) > pBounds[1] + heightPad;
+    }
+    //---------------------------------------------------------------------
     std::pair<bool, Vector3> Terrain::rayIntersects(const Ray& ray, 
         bool cascadeToNeighbours /* = false */, Real distanceLimit /* = 0 */)
     {
@@ -2421,6 +2755,9 @@ namespace Ogre
 
         Result result(true, Vector3::ZERO);
         Real dummyHighValue = (Real)mSize * 10000.0f;
+        // finest height bounds block which the ray was found to pass through
+        long blockSize = HEIGHT_BOUNDS_BLOCK_SIZE;
+        long testedBlockX = -1, testedBlockZ = -1;
 
 
         while (cur.y >= (minHeight - 1e-3) && cur.y <= (maxHeight + 1e-3))
@@ -2428,6 +2765,51 @@ namespace Ogre
             if (quadX < 0 || quadX >= (int)mSize-1 || quadZ < 0 || quadZ >= (int)mSize-1)
                 break;
 
+            if (quadX / blockSize != testedBlockX || quadZ / blockSize != testedBlockZ)
+            {
+                // find the largest block around this quad which the ray passes above or below
+                size_t level = 0;
+                while (level < mHeightBounds.size() && rayMissesHeightBounds(localRay, level, 
+                    quadX / (blockSize << level), quadZ / (blockSize << level)))
+                    ++level;
+
+                if (level == 0)
+                {
+                    testedBlockX = quadX / blockSize;
+                    testedBlockZ = quadZ / blockSize;
+                }
+                else
+                {
+                    // none of its quads can be hit, continue where the ray leaves the block
+                    long skipSize = blockSize << (level - 1);
+                    long x0 = quadX / skipSize * skipSize;
+                    long z0 = quadZ / skipSize * skipSize;
+                    long x1 = std::min(x0 + skipSize, (long)mSize - 1);
+                    long z1 = std::min(z0 + skipSize, (long)mSize - 1);
+                    Real xExit = Math::RealEqual(rayDirection.x, 0.0) ? std::numeric_limits<Real>::max() :
+                        ((xDir < 0 ? x0 : x1) - rayOrigin.x) / rayDirection.x;
+                    Real zExit = Math::RealEqual(rayDirection.z, 0.0) ? std::numeric_limits<Real>::max() :
+                        ((zDir < 0 ? z0 : z1) - rayOrigin.z) / rayDirection.z;
+                    result.first = false;
+                    // a vertical ray has nowhere else to go
+                    if (xExit == std::numeric_limits<Real>::max() && zExit == std::numeric_limits<Real>::max())
+                        break;
+                    if (xExit < zExit)
+                    {
+                        cur = localRay.getPoint(xExit);
+                        quadX = xDir < 0 ? x0 - 1 : x1;
+                        quadZ = std::min(std::max((long)Math::Floor(cur.z), z0), z1 - 1);
+                    }
+                    else
+                    {
+                        cur = localRay.getPoint(zExit);
+                        quadX = std::min(std::max((long)Math::Floor(cur.x), x0), x1 - 1);
+                        quadZ = zDir < 0 ? z0 - 1 : z1;
+                    }
+                    continue;
+                }
+            }
+
             result = checkQuadIntersection(quadX, quadZ, localRay);
             if (result.first)
                 break;
@@ -3073,8 +3455,7 @@ namespace Ogre
             if (mNormalMapRequired)
             {
                 // update derived data for whole terrain, but just normals
-                mDirtyDerivedDataRect.left = mDirtyDerivedDataRect.top = 0;
-                mDirtyDerivedDataRect.right = mDirtyDerivedDataRect.bottom = mSize;
+                mergeDirtyDerivedDataRect(Rect(0, 0, mSize, mSize));
                 updateDerivedData(false, DERIVED_DATA_NORMALS);
             }
             
@@ -3094,8 +3475,7 @@ namespace Ogre
             if (mLightMapRequired)
             {
                 // update derived data for whole terrain, but just lightmap
-                mDirtyDerivedDataRect.left = mDirtyDerivedDataRect.top = 0;
-                mDirtyDerivedDataRect.right = mDirtyDerivedDataRect.bottom = mSize;
+                mergeDirtyDerivedDataRect(Rect(0, 0, mSize, mSize));
                 updateDerivedData(false, DERIVED_DATA_LIGHTMAP);
             }
         }
@@ -3185,14 +3565,21 @@ namespace Ogre
         // this means we return faster, can abort faster and we repeat less redundant calcs
         // we don't do this as separate requests, because we only want one background
         // task per Terrain instance in flight at once
+        // Deltas and normals only depend on nearby heights, so just the dirty tiles
+        // are recalculated rather than everything within the merged dirty rect
         if (ddr.typeMask & DERIVED_DATA_DELTAS)
         {
-            ddres.deltaUpdateRect = calculateHeightDeltas(ddr.dirtyRect);
+            ddres.deltaUpdateRect = calculateHeightDeltas(ddr.dirtyTiles);
             ddres.remainingTypeMask &= ~ DERIVED_DATA_DELTAS;
         }
         else if (ddr.typeMask & DERIVED_DATA_NORMALS)
         {
-            ddres.normalMapBox = calculateNormals(ddr.dirtyRect, ddres.normalUpdateRect);
+            for (RectList::const_iterator i = ddr.dirtyTiles.begin(); i != ddr.dirtyTiles.end(); ++i)
+            {
+                Rect normalUpdateRect;
+                ddres.normalMapBoxes.push_back(calculateNormals(*i, normalUpdateRect));
+                ddres.normalUpdateRects.push_back(normalUpdateRect);
+            }
             ddres.remainingTypeMask &= ~ DERIVED_DATA_NORMALS;
         }
         else if (ddr.typeMask & DERIVED_DATA_LIGHTMAP)
@@ -3228,7 +3615,8 @@ namespace Ogre
         if ((ddreq.typeMask & DERIVED_DATA_NORMALS) && 
             !(ddres.remainingTypeMask & DERIVED_DATA_NORMALS))
         {
-            finaliseNormals(ddres.normalUpdateRect, ddres.normalMapBox);
+            for (size_t i = 0; i < ddres.normalMapBoxes.size(); ++i)
+                finaliseNormals(ddres.normalUpdateRects[i], ddres.normalMapBoxes[i]);
             mCompositeMapDirtyRect.merge(ddreq.dirtyRect);
         }
         if ((ddreq.typeMask & DERIVED_DATA_LIGHTMAP) && 
@@ -3244,12 +3632,18 @@ namespace Ogre
         // Re-trigger another request if there are still things to do, or if
         // we had a new request since this one
         Rect newRect(0,0,0,0);
+        RectList newRects;
         if (ddres.remainingTypeMask)
+        {
             newRect.merge(ddreq.dirtyRect);
+            newRects = ddreq.dirtyTiles;
+        }
         if (mDerivedUpdatePendingMask)
         {
             newRect.merge(mDirtyDerivedDataRect);
+            newRects.insert(newRects.end(), mDirtyDerivedDataRects.begin(), mDirtyDerivedDataRects.end());
             mDirtyDerivedDataRect.setNull();
+            mDirtyDerivedDataRects.clear();
         }
         Rect newLightmapExtraRect(0,0,0,0);
         if (ddres.remainingTypeMask)
@@ -3263,7 +3657,7 @@ namespace Ogre
         if (newMask)
         {
             // trigger again
-            updateDerivedDataImpl(newRect, newLightmapExtraRect, false, newMask);
+            updateDerivedDataImpl(newRect, newRects, newLightmapExtraRect, false, newMask);
         }
         else
         {
@@ -3293,7 +3687,7 @@ namespace Ogre
 				gmreq.startTime = currentTime + (gmreq.synchronous ? 0 : TERRAIN_GENERATE_MATERIAL_INTERVAL_MS);
                 Root::getSingleton().getWorkQueue()->addRequest(
                     mWorkQueueChannel, WORKQUEUE_GENERATE_MATERIAL_REQUEST, 
-                    Any(gmreq), 0, gmreq.synchronous);
+                    Any(gmreq), 0, gmreq.synchronous, false, getWorkQueuePriority());
                 return;
             }
             break;
@@ -3359,55 +3753,96 @@ namespace Ogre
         //  4---P---0
         //  | / | \ |
         //  5---6---7
+        // Points away from the edges read their neighbours straight from the
+        // height data, in terrain axes where the ring of points is a fixed offset
+        static const int ringX[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+        static const int ringY[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+        const float* heights = mHeightData;
+        long size = mSize;
+        Real scale = mScale;
 
-        Plane plane;
-        for (long y = widenedRect.top; y < widenedRect.bottom; ++y)
+        auto calculateRows = [&](size_t begin, size_t end, size_t)
         {
-            for (long x = widenedRect.left; x < widenedRect.right; ++x)
+            for (long y = widenedRect.top + (long)begin; y < widenedRect.top + (long)end; ++y)
             {
-                Vector3 cumulativeNormal = Vector3::ZERO;
-
-                // Build points to sample
-                Vector3 centrePoint;
-                Vector3 adjacentPoints[8];
-                getPointFromSelfOrNeighbour(x  , y,   &centrePoint);
-                getPointFromSelfOrNeighbour(x+1, y,   &adjacentPoints[0]);
-                getPointFromSelfOrNeighbour(x+1, y+1, &adjacentPoints[1]);
-                getPointFromSelfOrNeighbour(x,   y+1, &adjacentPoints[2]);
-                getPointFromSelfOrNeighbour(x-1, y+1, &adjacentPoints[3]);
-                getPointFromSelfOrNeighbour(x-1, y,   &adjacentPoints[4]);
-                getPointFromSelfOrNeighbour(x-1, y-1, &adjacentPoints[5]);
-                getPointFromSelfOrNeighbour(x,   y-1, &adjacentPoints[6]);
-                getPointFromSelfOrNeighbour(x+1, y-1, &adjacentPoints[7]);
-
-                for (int i = 0; i < 8; ++i)
+                for (long x = widenedRect.left; x < widenedRect.right; ++x)
                 {
-                    plane.redefine(centrePoint, adjacentPoints[i], adjacentPoints[(i+1)%8]);
-                    cumulativeNormal += plane.normal;
-                }
-
-                // normalise & store normal
-                cumulativeNormal.normalise();
+                    Vector3 cumulativeNormal;
+                    if (x > 0 && y > 0 && x < size - 1 && y < size - 1)
+                    {
+                        const float* centre = heights + y * size + x;
+                        Vector3 adjacent[8];
+                        for (int i = 0; i < 8; ++i)
+                        {
+                            adjacent[i].x = ringX[i] * scale;
+                            adjacent[i].y = ringY[i] * scale;
+                            adjacent[i].z = centre[ringY[i] * size + ringX[i]] - *centre;
+                        }
 
-                // encode as RGB, object space
-                // invert the Y to deal with image space
-                long storeX = x - widenedRect.left;
-                long storeY = widenedRect.bottom - y - 1;
+                        Vector3 terrainNormal = Vector3::ZERO;
+                        for (int i = 0; i < 8; ++i)
+                            terrainNormal += adjacent[i].crossProduct(adjacent[(i+1)%8]).normalisedCopy();
+                        // terrain to world axes is a rotation, so the normal can be converted afterwards
+                        cumulativeNormal = convertTerrainToWorldAxes(terrainNormal);
+                    }
+                    else
+                    {
+                        calculateNormalFromSelfOrNeighbour(x, y, cumulativeNormal);
+                    }
 
-                uint8* pStore = pData + ((storeY * widenedRect.width()) + storeX) * 3;
-                *pStore++ = static_cast<uint8>((cumulativeNormal.x + 1.0f) * 0.5f * 255.0f);
-                *pStore++ = static_cast<uint8>((cumulativeNormal.y + 1.0f) * 0.5f * 255.0f);
-                *pStore++ = static_cast<uint8>((cumulativeNormal.z + 1.0f) * 0.5f * 255.0f);
+                    // normalise & store normal
+                    cumulativeNormal.normalise();
 
+                    // encode as RGB, object space
+                    // invert the Y to deal with image space
+                    long storeX = x - widenedRect.left;
+                    long storeY = widenedRect.bottom - y - 1;
 
+                    uint8* pStore = pData + ((storeY * widenedRect.width()) + storeX) * 3;
+                    *pStore++ = static_cast<uint8>((cumulativeNormal.x + 1.0f) * 0.5f * 255.0f);
+                    *pStore++ = static_cast<uint8>((cumulativeNormal.y + 1.0f) * 0.5f * 255.0f);
+                    *pStore++ = static_cast<uint8>((cumulativeNormal.z + 1.0f) * 0.5f * 255.0f);
+                }
             }
-        }
+        };
+
+        Root* root = Root::getSingletonPtr();
+        ThreadPool* pool = root ? root->getThreadPool() : 0;
+        size_t rowsPerTask = std::max(1L, NORMAL_POINTS_PER_TASK / std::max(1L, widenedRect.width()));
+        if (pool)
+            pool->parallelFor(0, widenedRect.height(), rowsPerTask, calculateRows);
+        else
+            calculateRows(0, widenedRect.height(), 0);
 
         finalRect = widenedRect;
 
         return pixbox;
     }
     //---------------------------------------------------------------------
+    void Terrain::calculateNormalFromSelfOrNeighbour(long x, long y, Vector3& outNormal) const
+    {
+        // Build points to sample
+        Vector3 centrePoint;
+        Vector3 adjacentPoints[8];
+        getPointFromSelfOrNeighbour(x  , y,   &centrePoint);
+        getPointFromSelfOrNeighbour(x+1, y,   &adjacentPoints[0]);
+        getPointFromSelfOrNeighbour(x+1, y+1, &adjacentPoints[1]);
+        getPointFromSelfOrNeighbour(x,   y+1, &adjacentPoints[2]);
+        getPointFromSelfOrNeighbour(x-1, y+1, &adjacentPoints[3]);
+        getPointFromSelfOrNeighbour(x-1, y,   &adjacentPoints[4]);
+        getPointFromSelfOrNeighbour(x-1, y-1, &adjacentPoints[5]);
+        getPointFromSelfOrNeighbour(x,   y-1, &adjacentPoints[6]);
+        getPointFromSelfOrNeighbour(x+1, y-1, &adjacentPoints[7]);
+
+        Plane plane;
+        outNormal = Vector3::ZERO;
+        for (int i = 0; i < 8; ++i)
+        {
+            plane.redefine(centrePoint, adjacentPoints[i], adjacentPoints[(i+1)%8]);
+            outNormal += plane.normal;
+        }
+    }
+    //---------------------------------------------------------------------
     void Terrain::finaliseNormals(const Ogre::Rect &rect, Ogre::PixelBox *normalsBox)
     {
         createOrDestroyGPUNormalMap();
@@ -3537,11 +3972,24 @@ namespace Ogre
         PixelBox* pixbox = OGRE_NEW PixelBox(static_cast<uint32>(widenedRect.width()),
                                              static_cast<uint32>(widenedRect.height()), 1, PF_L8, pData);
 
+        if (TerrainGlobalOptions::getSingleton().getUseRayCastLightmap())
+            calculateLightmapRayCast(widenedRect, pData);
+        else
+            calculateLightmapHorizon(widenedRect, pData);
+
+        return pixbox;
+
+
+    }
+    //---------------------------------------------------------------------
+    void Terrain::calculateLightmapRayCast(const Rect& rect, uint8* pData)
+    {
+        const Vector3& lightVec = TerrainGlobalOptions::getSingleton().getLightMapDirection();
         Real heightPad = (getMaxHeight() - getMinHeight()) * 1.0e-3f;
 
-        for (long y = widenedRect.top; y < widenedRect.bottom; ++y)
+        for (long y = rect.top; y < rect.bottom; ++y)
         {
-            for (long x = widenedRect.left; x < widenedRect.right; ++x)
+            for (long x = rect.left; x < rect.right; ++x)
             {
                 float litVal = 1.0f;
 
@@ -3566,18 +4014,216 @@ namespace Ogre
 
                 // encode as L8
                 // invert the Y to deal with image space
-                long storeX = x - widenedRect.left;
-                long storeY = widenedRect.bottom - y - 1;
+                long storeX = x - rect.left;
+                long storeY = rect.bottom - y - 1;
 
-                uint8* pStore = pData + ((storeY * widenedRect.width()) + storeX);
+                uint8* pStore = pData + ((storeY * rect.width()) + storeX);
                 *pStore = (unsigned char)(litVal * 255.0);
 
             }
         }
+    }
+    //---------------------------------------------------------------------
+    namespace
+    {
+        /// Number of sweep lines handed to a thread pool task at once
+        const size_t LIGHTMAP_LINES_PER_TASK = 32;
 
-        return pixbox;
+        /// Height at a point space position, interpolated over the same triangles as
+        /// Terrain::getHeightAtTerrainPosition but reading the height data directly
+        inline float sampleTriangulatedHeight(const float* heights, long size, float x, float y)
+        {
+            long startX = std::min(static_cast<long>(x), size - 2);
+            long startY = std::min(static_cast<long>(y), size - 2);
+            float u = x - startX;
+            float v = y - startY;
+            const float* row0 = heights + startY * size + startX;
+            const float* row1 = row0 + size;
+            float h0 = row0[0], h1 = row0[1], h2 = row1[1], h3 = row1[0];
+
+            /* even     odd
+            3---2   3---2
+            | / |   | \ |
+            0---1   0---1
+            */
+            if (startY % 2)
+            {
+                if (1.0f - v > u)
+                    return h0 + u * (h1 - h0) + v * (h3 - h0);
+                return h2 + (1.0f - u) * (h3 - h2) + (1.0f - v) * (h1 - h2);
+            }
+            if (v > u)
+                return h0 + v * (h3 - h0) + u * (h2 - h3);
+            return h0 + u * (h1 - h0) + v * (h2 - h1);
+        }
+
+        /// The height data of a terrain and its neighbours, addressed in the centre terrain's point space
+        struct LightmapCasterHeights
+        {
+            const float* heights[3][3];
+            float heightOffset[3][3];
+            long size;
+
+            float operator()(float x, float y) const
+            {
+                long last = size - 1;
+                int ox = x < 0 ? -1 : (x > last ? 1 : 0);
+                int oy = y < 0 ? -1 : (y > last ? 1 : 0);
+                x -= ox * last;
+                y -= oy * last;
+                const float* h = heights[oy + 1][ox + 1];
+                // nothing to cast a shadow outside of the known terrains
+                if (!h || x < 0 || y < 0 || x > last || y > last)
+                    return -std::numeric_limits<float>::infinity();
+                return sampleTriangulatedHeight(h, size, x, y) + heightOffset[oy + 1][ox + 1];
+            }
+        };
+    }
+    //---------------------------------------------------------------------
+    void Terrain::calculateLightmapHorizon(const Rect& rect, uint8* pData)
+    {
+        // Every texel receiving a shadow is lit if no terrain along the ray towards
+        // the light rises above it. Rather than casting that ray per texel, texels are
+        // visited along lines parallel to the light direction, starting on the light
+        // side. Each line carries the height of the shadow cast by everything it has
+        // passed so far, which only drops by the light slope at each step.
+        Vector3 lightVec = -TerrainGlobalOptions::getSingleton().getLightMapDirection();
+        convertDirection(WORLD_SPACE, lightVec, TERRAIN_SPACE, lightVec);
+        Real horizontal = Math::Sqrt(lightVec.x * lightVec.x + lightVec.y * lightVec.y);
+        long width = rect.width();
+
+        if (horizontal <= std::abs(lightVec.z) * 1e-6f)
+        {
+            // light straight above (everything lit) or below (everything in shadow)
+            memset(pData, lightVec.z > 0 ? 255 : 0, width * rect.height());
+            return;
+        }
 
+        OGRE_LOCK_RW_MUTEX_READ(mNeighbourMutex);
+
+        LightmapCasterHeights casters;
+        casters.size = mSize;
+        Real maxCasterHeight = getMaxHeight();
+        for (int oy = -1; oy <= 1; ++oy)
+        {
+            for (int ox = -1; ox <= 1; ++ox)
+            {
+                const Terrain* t = this;
+                if (ox || oy)
+                {
+                    t = mNeighbours[getNeighbourIndex(ox, oy)];
+                    // only neighbours sharing our layout can be addressed as one grid
+                    if (t && (t->mSize != mSize || !t->mHeightData || t->mAlign != mAlign))
+                        t = 0;
+                }
+                casters.heights[oy + 1][ox + 1] = t ? t->mHeightData : 0;
+                casters.heightOffset[oy + 1][ox + 1] = t ?
+                    convertWorldToTerrainAxes(t->getPosition() - getPosition()).z : 0;
+                if (t && t != this)
+                    maxCasterHeight = std::max(maxCasterHeight,
+                        t->getMaxHeight() + casters.heightOffset[oy + 1][ox + 1]);
+            }
+        }
+
+        // sweep along the dominant axis a, one texel per step, the other axis b
+        // follows b = line + slope * a
+        int axisA = std::abs(lightVec.x) >= std::abs(lightVec.y) ? 0 : 1;
+        Real dirA = axisA == 0 ? lightVec.x : lightVec.y;
+        Real dirB = axisA == 0 ? lightVec.y : lightVec.x;
+        long stepA = dirA > 0 ? -1 : 1;
+        Real slope = dirB / dirA;
+        long beginA = axisA == 0 ? rect.left : rect.top;
+        long endA = axisA == 0 ? rect.right : rect.bottom;
+        long beginB = axisA == 0 ? rect.top : rect.left;
+        long endB = axisA == 0 ? rect.bottom : rect.right;
+
+        Real pointsPerTexel = (Real)(mSize - 1) / (Real)(mLightmapSizeActual - 1);
+        Real worldPerStep = mWorldSize / (Real)(mLightmapSizeActual - 1) * Math::Sqrt(1 + slope * slope);
+        Real dropPerStep = lightVec.z / horizontal * worldPerStep;
+        // sample at least every height point so narrow ridges still cast shadows
+        int subSteps = std::max(1, (int)Math::Ceil(pointsPerTexel));
+        Real subDrop = dropPerStep / subSteps;
+
+        // start far enough towards the light that nothing beyond can reach down to
+        // this terrain; like the ray cast, never look further than the world size
+        Real sweepLimit = mWorldSize;
+        if (dropPerStep > 0)
+            sweepLimit = std::min(sweepLimit, (maxCasterHeight - getMinHeight()) / dropPerStep * worldPerStep);
+        long preroll = (long)Math::Ceil(sweepLimit / worldPerStep);
+
+        long firstA = stepA > 0 ? beginA - preroll : endA - 1 + preroll;
+        long lastA = stepA > 0 ? endA - 1 : beginA;
+        long numSteps = (lastA - firstA) * stepA;
+
+        // lines are one texel apart along b, so each texel is reached by exactly one line
+        Real minShift = std::min(slope * beginA, slope * (endA - 1));
+        Real maxShift = std::max(slope * beginA, slope * (endA - 1));
+        long firstLine = (long)Math::Floor(beginB - 0.5f - maxShift);
+        long lastLine = (long)Math::Ceil(endB - 0.5f - minShift);
+
+        Real heightPad = (getMaxHeight() - getMinHeight()) * 1.0e-3f;
+        const float* heights = mHeightData;
+        long size = mSize;
+
+        auto sweepLines = [=, &casters](size_t lineBegin, size_t lineEnd, size_t)
+        {
+            for (size_t l = lineBegin; l < lineEnd; ++l)
+            {
+                long line = firstLine + (long)l;
+                float shadowHeight = -std::numeric_limits<float>::infinity();
+                for (long i = 0; i <= numSteps; ++i)
+                {
+                    long a = firstA + i * stepA;
+                    Real b = line + slope * a;
+                    if (a >= beginA && a < endA)
+                    {
+                        // integer line offset keeps neighbouring lines on distinct texels
+                        long r = line + (long)Math::Floor(slope * a + 0.5f);
+                        if (r >= beginB && r < endB)
+                        {
+                            long x = axisA == 0 ? a : r;
+                            long y = axisA == 0 ? r : a;
+                            float receiver = sampleTriangulatedHeight(heights, size,
+                                x * pointsPerTexel, y * pointsPerTexel) + heightPad;
+                            // invert the Y to deal with image space
+                            pData[(rect.bottom - y - 1) * width + (x - rect.left)] =
+                                shadowHeight > receiver ? 0 : 255;
+                        }
+                    }
+
+                    for (int s = 0; s < subSteps; ++s)
+                    {
+                        Real t = (Real)s / subSteps;
+                        Real sa = (a + t * stepA) * pointsPerTexel;
+                        Real sb = (b + t * stepA * slope) * pointsPerTexel;
+                        float h = axisA == 0 ? casters(sa, sb) : casters(sb, sa);
+                        shadowHeight = std::max(shadowHeight, h) - subDrop;
+                    }
+                }
+            }
+        };
+
+        size_t numLines = lastLine - firstLine + 1;
+        Root* root = Root::getSingletonPtr();
+        ThreadPool* pool = root ? root->getThreadPool() : 0;
+        if (pool)
+            pool->parallelFor(0, numLines, LIGHTMAP_LINES_PER_TASK, sweepLines);
+        else
+            sweepLines(0, numLines, 0);
+    }
+    //---------------------------------------------------------------------
+    Real Terrain::compareLightmapMethods()
+    {
+        Rect rect(0, 0, mLightmapSizeActual, mLightmapSizeActual);
+        size_t numTexels = rect.width() * rect.height();
+        vector<uint8>::type rayCast(numTexels), horizon(numTexels);
+        calculateLightmapRayCast(rect, &rayCast[0]);
+        calculateLightmapHorizon(rect, &horizon[0]);
 
+        size_t mismatches = 0;
+        for (size_t i = 0; i < numTexels; ++i)
+            mismatches += rayCast[i] != horizon[i];
+        return (Real)mismatches / (Real)numTexels;
     }
     //---------------------------------------------------------------------
     void Terrain::finaliseLightmap(const Rect& rect, PixelBox* lightmapBox)
@@ -3970,7 +4616,7 @@ namespace Ogre
                 // lightmaps) because a dirty geom rectangle will actually grow by one 
                 // element in each direction for normals recalculation. However for
                 // the sake of one row/column it's really not worth it.
-                mDirtyDerivedDataRect.merge(edgerect);
+                mergeDirtyDerivedDataRect(edgerect);
                 updateDerived |= DERIVED_DATA_NORMALS;
             }
         }
@@ -4607,6 +5253,7 @@ namespace Ogre
             rect.left = 0; rect.right = mSize;
             calculateHeightDeltas(rect);
             finaliseHeightDeltas(rect, true);
+            updateHeightBounds(rect);
 
             if(mIsLoaded)
             {
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgreStreamSerialiser.h"
 #include "OgreLogManager.h"
 #include "OgreTerrainAutoUpdateLod.h"
+#include "OgreThreadPool.h"
 #include <cmath>
 #include <iomanip>
 
@@ -52,6 +53,8 @@ namespace Ogre
         , mFilenameExtension("dat")
         , mResourceGroup(ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME)
         , mAutoUpdateLod( TerrainAutoUpdateLodFactory::getAutoUpdateLod(NONE) )
+        , mLoadPriorityPosition(Vector3::ZERO)
+        , mLoadPriorityPositionSet(false)
     {
         mDefaultImportData.terrainAlign = align;
         mDefaultImportData.terrainSize = terrainSize;
@@ -77,6 +80,8 @@ namespace Ogre
         , mFilenameExtension("dat")
         , mResourceGroup(ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME)
         , mAutoUpdateLod(0)
+        , mLoadPriorityPosition(Vector3::ZERO)
+        , mLoadPriorityPositionSet(false)
     {
         mDefaultImportData.terrainAlign = mAlignment;
         mDefaultImportData.terrainSize = 0;
@@ -315,12 +320,36 @@ namespace Ogre
             WorkQueue::RequestID id =
                 Root::getSingleton().getWorkQueue()->addRequest(
                     mWorkQueueChannel, WORKQUEUE_LOAD_REQUEST,
-                    Any(req), 0, synchronous);
+                    Any(req), 0, synchronous, false, synchronous ? 0 : getLoadPriority(slot));
             if (!synchronous)
                 ret.first->second = id;
         }
     }
     //---------------------------------------------------------------------
+    Real TerrainGroup::getLoadPriority(const TerrainSlot* slot) const
+    {
+        if (!mLoadPriorityPositionSet)
+            return 0;
+
+        Vector3 centre;
+        convertTerrainSlotToWorldPosition(slot->x, slot->y, &centre);
+        return -centre.distance(mLoadPriorityPosition);
+    }
+    //---------------------------------------------------------------------
+    void TerrainGroup::setLoadPriorityPosition(const Vector3& pos)
+    {
+        mLoadPriorityPosition = pos;
+        mLoadPriorityPositionSet = true;
+
+        WorkQueue* wq = Root::getSingleton().getWorkQueue();
+        for (TerrainPrepareRequestMap::iterator i = mTerrainPrepareRequests.begin();
+            i != mTerrainPrepareRequests.end(); ++i)
+        {
+            if (i->second)
+                wq->setRequestPriority(i->second, getLoadPriority(i->first));
+        }
+    }
+    //---------------------------------------------------------------------
     void TerrainGroup::increaseLodLevel(long x, long y, bool synchronous /* = false */)
     {
         TerrainSlot* slot = getTerrainSlot(x, y, false);
@@ -583,6 +612,63 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
+    namespace
+    {
+        /// Number of rays or segments handed to a thread pool task at once
+        const size_t RAYS_PER_TASK = 64;
+    }
+    //---------------------------------------------------------------------
+    void TerrainGroup::rayIntersects(const RayList& rays, RayResultList& results, 
+        Real distanceLimit /* = 0 */) const
+    {
+        results.assign(rays.size(), RayResult(false, 0, Vector3::ZERO));
+
+        ThreadPool::RangeFunction castRays = [&](size_t begin, size_t end, size_t)
+        {
+            for (size_t i = begin; i < end; ++i)
+                results[i] = rayIntersects(rays[i], distanceLimit);
+        };
+
+        Root* root = Root::getSingletonPtr();
+        ThreadPool* pool = root ? root->getThreadPool() : 0;
+        if (pool)
+            pool->parallelFor(0, rays.size(), RAYS_PER_TASK, castRays);
+        else
+            castRays(0, rays.size(), 0);
+    }
+    //---------------------------------------------------------------------
+    void TerrainGroup::segmentIntersects(const SegmentList& segments, RayResultList& results) const
+    {
+        results.assign(segments.size(), RayResult(false, 0, Vector3::ZERO));
+
+        // The slot search stops at slots whose centre is further away than the limit,
+        // so allow for the segment ending anywhere inside a slot
+        Real slotRadius = mTerrainWorldSize * Math::Sqrt(0.5f);
+
+        ThreadPool::RangeFunction castSegments = [&](size_t begin, size_t end, size_t)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                const Segment& segment = segments[i];
+                Vector3 dir = segment.second - segment.first;
+                Real length = dir.normalise();
+                if (length == 0)
+                    continue;
+
+                RayResult result = rayIntersects(Ray(segment.first, dir), length + slotRadius);
+                if (result.hit && segment.first.squaredDistance(result.position) <= length * length)
+                    results[i] = result;
+            }
+        };
+
+        Root* root = Root::getSingletonPtr();
+        ThreadPool* pool = root ? root->getThreadPool() : 0;
+        if (pool)
+            pool->parallelFor(0, segments.size(), RAYS_PER_TASK, castSegments);
+        else
+            castSegments(0, segments.size(), 0);
+    }
+    //---------------------------------------------------------------------
     void TerrainGroup::boxIntersects(const AxisAlignedBox& box, TerrainList* resultList) const
     {
         resultList->clear();
@@ -36,7 +36,72 @@ namespace Ogre
 {
     const uint16 TerrainLodManager::WORKQUEUE_LOAD_LOD_DATA_REQUEST = 1;
     const uint32 TerrainLodManager::TERRAINLODDATA_CHUNK_ID = StreamSerialiser::makeIdentifier("TLDA");
-    const uint16 TerrainLodManager::TERRAINLODDATA_CHUNK_VERSION = 1;
+    const uint16 TerrainLodManager::TERRAINLODDATA_CHUNK_VERSION = 2;
+
+    namespace
+    {
+        /// LOD data values are stored as palette indices
+        const uint8 LOD_ENCODING_PALETTE = 0;
+        /// LOD data values are stored as order preserving integers
+        const uint8 LOD_ENCODING_ORDERED = 1;
+        /// Most entries in a palette, keeps index differences within 16 bits
+        const size_t LOD_PALETTE_MAX_SIZE = 32768;
+
+        /// Map the bits of a float to an unsigned integer which sorts the same way
+        uint32 floatToOrdered(float value)
+        {
+            uint32 bits;
+            memcpy(&bits, &value, sizeof(uint32));
+            return (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
+        }
+
+        float orderedToFloat(uint32 ordered)
+        {
+            uint32 bits = (ordered & 0x80000000) ? (ordered & 0x7fffffff) : ~ordered;
+            float value;
+            memcpy(&value, &bits, sizeof(uint32));
+            return value;
+        }
+
+        /// Interleave negative and positive differences so small ones of either sign stay small
+        uint32 zigZag(int32 value)
+        {
+            return (static_cast<uint32>(value) << 1) ^ static_cast<uint32>(value >> 31);
+        }
+
+        int32 unZigZag(uint32 value)
+        {
+            return static_cast<int32>(value >> 1) ^ -static_cast<int32>(value & 1);
+        }
+
+        /// Write the lowest numPlanes bytes of each value, one byte plane after the other
+        void writeBytePlanes(StreamSerialiser& stream, const vector<uint32>::type& values, size_t numPlanes)
+        {
+            if (values.empty())
+                return;
+            vector<uint8>::type plane(values.size());
+            for (size_t p = 0; p < numPlanes; ++p)
+            {
+                for (size_t i = 0; i < values.size(); ++i)
+                    plane[i] = static_cast<uint8>(values[i] >> (p * 8));
+                stream.write(&plane[0], plane.size());
+            }
+        }
+
+        void readBytePlanes(StreamSerialiser& stream, vector<uint32>::type& values, size_t numPlanes)
+        {
+            if (values.empty())
+                return;
+            vector<uint8>::type plane(values.size());
+            std::fill(values.begin(), values.end(), 0);
+            for (size_t p = 0; p < numPlanes; ++p)
+            {
+                stream.read(&plane[0], plane.size());
+                for (size_t i = 0; i < values.size(); ++i)
+                    values[i] |= static_cast<uint32>(plane[i]) << (p * 8);
+            }
+        }
+    }
 
     TerrainLodManager::TerrainLodManager(Terrain* t, DataStreamPtr& stream)
         : mTerrain(t)
@@ -55,12 +120,14 @@ namespace Ogre
 
     void TerrainLodManager::open(const String& filename)
     {
+        mLodChunkOffsets.clear();
         if(!filename.empty() && filename.length() > 0)
             mDataStream = Root::getSingleton().openFileStream(filename, mTerrain->_getDerivedResourceGroup());
     }
 
     void TerrainLodManager::close()
     {
+        mLodChunkOffsets.clear();
         mDataStream.reset();
     }
 
@@ -77,6 +144,7 @@ namespace Ogre
         mIncreaseLodLevelInProgress = false;
         mLastRequestSynchronous = false;
         mLodInfoTable = 0;
+        mStreamEndian = StreamSerialiser::ENDIAN_AUTO;
 
         WorkQueue* wq = Root::getSingleton().getWorkQueue();
         mWorkQueueChannel = wq->getChannel("Ogre/TerrainLodManager");
@@ -283,7 +351,7 @@ namespace Ogre
                 LoadLodRequest req(this,mHighestLodPrepared,mHighestLodLoaded,mTargetLodLevel);
                 Root::getSingleton().getWorkQueue()->addRequest(
                     mWorkQueueChannel, WORKQUEUE_LOAD_LOD_DATA_REQUEST,
-                    Any(req), 0, synchronous);
+                    Any(req), 0, synchronous, false, mTerrain->getWorkQueuePriority());
             }
             else if(synchronous)
                 waitForDerivedProcesses();
@@ -314,24 +382,115 @@ namespace Ogre
 
         for (int level = numLodLevels - 1; level >=0; level--)
         {
+            // height data followed by delta data
+            size_t count = lods[level].size() / 2;
             stream.writeChunkBegin(TERRAINLODDATA_CHUNK_ID, TERRAINLODDATA_CHUNK_VERSION);
             stream.startDeflate();
-            stream.write(&(lods[level][0]), lods[level].size());
+            encodeLodData(stream, &lods[level][0], count);
+            encodeLodData(stream, &lods[level][count], count);
             stream.stopDeflate();
             stream.writeChunkEnd(TERRAINLODDATA_CHUNK_ID);
         }
     }
+    //---------------------------------------------------------------------
+    void TerrainLodManager::encodeLodData(StreamSerialiser& stream, const float* data, size_t count)
+    {
+        vector<uint32>::type ordered(count);
+        for (size_t i = 0; i < count; ++i)
+            ordered[i] = floatToOrdered(data[i]);
 
-    void TerrainLodManager::readLodData(uint16 lowerLodBound, uint16 higherLodBound)
+        vector<uint32>::type palette(ordered);
+        std::sort(palette.begin(), palette.end());
+        palette.erase(std::unique(palette.begin(), palette.end()), palette.end());
+
+        vector<uint32>::type residuals(count);
+        if (!palette.empty() && palette.size() <= LOD_PALETTE_MAX_SIZE && palette.size() <= count / 2)
+        {
+            stream.write(&LOD_ENCODING_PALETTE);
+            uint32 paletteSize = static_cast<uint32>(palette.size());
+            stream.write(&paletteSize);
+            vector<float>::type paletteValues(palette.size());
+            for (size_t i = 0; i < palette.size(); ++i)
+                paletteValues[i] = orderedToFloat(palette[i]);
+            stream.write(&paletteValues[0], paletteValues.size());
+
+            int32 prevIndex = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                int32 index = static_cast<int32>(
+                    std::lower_bound(palette.begin(), palette.end(), ordered[i]) - palette.begin());
+                residuals[i] = zigZag(index - prevIndex);
+                prevIndex = index;
+            }
+            writeBytePlanes(stream, residuals, 2);
+        }
+        else
+        {
+            stream.write(&LOD_ENCODING_ORDERED);
+            uint32 prev = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                residuals[i] = zigZag(static_cast<int32>(ordered[i] - prev));
+                prev = ordered[i];
+            }
+            writeBytePlanes(stream, residuals, 4);
+        }
+    }
+    //---------------------------------------------------------------------
+    void TerrainLodManager::decodeLodData(StreamSerialiser& stream, float* data, size_t count)
     {
-        if(!mDataStream) // No file to read from
-            return;
+        uint8 encoding;
+        stream.read(&encoding);
 
+        vector<uint32>::type residuals(count);
+        if (encoding == LOD_ENCODING_PALETTE)
+        {
+            uint32 paletteSize;
+            stream.read(&paletteSize);
+            if (paletteSize == 0 || paletteSize > LOD_PALETTE_MAX_SIZE)
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Corrupt terrain LOD data",
+                    "TerrainLodManager::decodeLodData");
+            vector<float>::type palette(paletteSize);
+            stream.read(&palette[0], palette.size());
+            readBytePlanes(stream, residuals, 2);
+
+            int32 index = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                index += unZigZag(residuals[i]);
+                if (index < 0 || index >= static_cast<int32>(paletteSize))
+                    OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Corrupt terrain LOD data",
+                        "TerrainLodManager::decodeLodData");
+                data[i] = palette[index];
+            }
+        }
+        else if (encoding == LOD_ENCODING_ORDERED)
+        {
+            readBytePlanes(stream, residuals, 4);
+
+            uint32 ordered = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                ordered += static_cast<uint32>(unZigZag(residuals[i]));
+                data[i] = orderedToFloat(ordered);
+            }
+        }
+        else
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Unknown terrain LOD data encoding",
+                "TerrainLodManager::decodeLodData");
+        }
+    }
+    //---------------------------------------------------------------------
+    void TerrainLodManager::buildLodChunkIndex()
+    {
         uint16 numLodLevels = mTerrain->getNumLodLevels();
         mDataStream->seek(mStreamOffset);
         StreamSerialiser stream(mDataStream);
 
         const StreamSerialiser::Chunk *mainChunk = stream.readChunkBegin(Terrain::TERRAIN_CHUNK_ID, Terrain::TERRAIN_CHUNK_VERSION);
+        if (!mainChunk)
+            return;
 
         if(mainChunk->version > 1)
         {
@@ -339,36 +498,73 @@ namespace Ogre
             stream.readChunkBegin(Terrain::TERRAINGENERALINFO_CHUNK_ID, Terrain::TERRAINGENERALINFO_CHUNK_VERSION);
             stream.readChunkEnd(Terrain::TERRAINGENERALINFO_CHUNK_ID);
 
-            // skip the previous lod data
-            for(int skip=numLodLevels-1-lowerLodBound; skip>0; skip--)
+            // LOD data is stored from the lowest LOD level to the highest
+            mLodChunkOffsets.resize(numLodLevels);
+            for(int level=numLodLevels-1; level>=0; level--)
             {
-                stream.readChunkBegin(TERRAINLODDATA_CHUNK_ID, TERRAINLODDATA_CHUNK_VERSION);
+                const StreamSerialiser::Chunk *c = stream.readChunkBegin(TERRAINLODDATA_CHUNK_ID,
+                        TERRAINLODDATA_CHUNK_VERSION);
+                if (!c)
+                {
+                    mLodChunkOffsets.clear();
+                    OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Missing terrain LOD data",
+                        "TerrainLodManager::buildLodChunkIndex");
+                }
+                mLodChunkOffsets[level] = c->offset;
                 stream.readChunkEnd(TERRAINLODDATA_CHUNK_ID);
             }
+            mStreamEndian = stream.getEndian();
+        }
+        stream.readChunkEnd(Terrain::TERRAIN_CHUNK_ID);
+    }
 
-            // uncompress
-            uint maxSize = 2 * mTerrain->getGeoDataSizeAtLod(higherLodBound);
-            float *lodData = OGRE_ALLOC_T(float, maxSize, MEMCATEGORY_GENERAL);
+    void TerrainLodManager::readLodData(uint16 lowerLodBound, uint16 higherLodBound)
+    {
+        if(!mDataStream) // No file to read from
+            return;
 
-            for(int level=lowerLodBound; level>=higherLodBound; level-- )
-            {
-                // both height data and delta data
-                uint dataSize = 2 * mTerrain->getGeoDataSizeAtLod(level);
+        if(mLodChunkOffsets.empty())
+            buildLodChunkIndex();
+        if(mLodChunkOffsets.empty()) // No separate LOD data
+            return;
 
-                // reach and read the target lod data
-                const StreamSerialiser::Chunk *c = stream.readChunkBegin(TERRAINLODDATA_CHUNK_ID,
-                        TERRAINLODDATA_CHUNK_VERSION);
-                stream.startDeflate(c->length);
-                stream.read(lodData, dataSize);
-                stream.stopDeflate();
-                stream.readChunkEnd(TERRAINLODDATA_CHUNK_ID);
+        // the chunks of the requested levels follow each other
+        mDataStream->seek(mLodChunkOffsets[lowerLodBound]);
+        StreamSerialiser stream(mDataStream, mStreamEndian, false);
+
+        // uncompress
+        uint maxSize = 2 * mTerrain->getGeoDataSizeAtLod(higherLodBound);
+        float *lodData = OGRE_ALLOC_T(float, maxSize, MEMCATEGORY_GENERAL);
 
-                fillBufferAtLod(level, lodData, dataSize);
+        for(int level=lowerLodBound; level>=higherLodBound; level-- )
+        {
+            // both height data and delta data
+            uint dataSize = 2 * mTerrain->getGeoDataSizeAtLod(level);
+
+            // reach and read the target lod data
+            const StreamSerialiser::Chunk *c = stream.readChunkBegin(TERRAINLODDATA_CHUNK_ID,
+                    TERRAINLODDATA_CHUNK_VERSION);
+            if (!c)
+            {
+                OGRE_FREE(lodData, MEMCATEGORY_GENERAL);
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Missing terrain LOD data",
+                    "TerrainLodManager::readLodData");
             }
-            stream.readChunkEnd(Terrain::TERRAIN_CHUNK_ID);
+            stream.startDeflate(c->length);
+            if (c->version > 1)
+            {
+                decodeLodData(stream, lodData, dataSize / 2);
+                decodeLodData(stream, lodData + dataSize / 2, dataSize / 2);
+            }
+            else
+                stream.read(lodData, dataSize);
+            stream.stopDeflate();
+            stream.readChunkEnd(TERRAINLODDATA_CHUNK_ID);
 
-            OGRE_FREE(lodData, MEMCATEGORY_GENERAL);
+            fillBufferAtLod(level, lodData, dataSize);
         }
+
+        OGRE_FREE(lodData, MEMCATEGORY_GENERAL);
     }
     void TerrainLodManager::fillBufferAtLod(uint lodLevel, const float* data, uint dataSize )
     {
@@ -29,9 +29,11 @@ THE SOFTWARE.
 #include "OgreTerrainGroup.h"
 #include "OgreGrid2DPageStrategy.h"
 #include "OgrePagedWorld.h"
+#include "OgrePage.h"
 #include "OgrePageManager.h"
 #include "OgreRoot.h"
 #include "OgreTimer.h"
+#include "OgreCamera.h"
 
 namespace Ogre
 {
@@ -275,6 +277,47 @@ namespace Ogre
         }
     }
     //---------------------------------------------------------------------
+    size_t TerrainPagedWorldSection::getPageMemoryUsage(Page* p) const
+    {
+        size_t bytes = PagedWorldSection::getPageMemoryUsage(p);
+
+        // terrains which are still loading can't be evicted and so aren't reported
+        long x, y;
+        // pageID is the same as a packed index
+        mTerrainGroup->unpackIndex(p->getID(), &x, &y);
+        Terrain* terrain = mTerrainGroup->getTerrain(x, y);
+        if (terrain && terrain->isLoaded())
+            bytes += terrain->getMemoryUsage();
+        return bytes;
+    }
+    //---------------------------------------------------------------------
+    void TerrainPagedWorldSection::notifyCamera(Camera* cam)
+    {
+        mTerrainGroup->setLoadPriorityPosition(cam->getDerivedPosition());
+
+        PagedWorldSection::notifyCamera(cam);
+    }
+    //---------------------------------------------------------------------
+    void TerrainPagedWorldSection::sortPagesInLoading()
+    {
+        if (mPagesInLoading.size() < 2)
+            return;
+
+        // handleRequest and handleResponse both take the front page
+        std::list<PageID>::iterator best = mPagesInLoading.begin();
+        Real bestPriority = getLoadPriority(*best);
+        for (std::list<PageID>::iterator i = ++mPagesInLoading.begin(); i != mPagesInLoading.end(); ++i)
+        {
+            Real priority = getLoadPriority(*i);
+            if (priority > bestPriority)
+            {
+                best = i;
+                bestPriority = priority;
+            }
+        }
+        mPagesInLoading.splice(mPagesInLoading.begin(), mPagesInLoading, best);
+    }
+    //---------------------------------------------------------------------
     WorkQueue::Response* TerrainPagedWorldSection::handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
     {
         if(mPagesInLoading.empty())
@@ -323,7 +366,8 @@ namespace Ogre
             unsigned long currentTime = Root::getSingletonPtr()->getTimer()->getMilliseconds();
             mNextLoadingTime = currentTime + mLoadingIntervalMs;
 
-            // Continue loading other pages
+            // Continue loading other pages, closest first
+            sortPagesInLoading();
             Root::getSingleton().getWorkQueue()->addRequest(
                     mWorkQueueChannel, WORKQUEUE_LOAD_TERRAIN_PAGE_REQUEST, 
                     Any(), 0, false);
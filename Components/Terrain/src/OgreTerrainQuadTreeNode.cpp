@@ -243,6 +243,34 @@ namespace Ogre
         }
     }
     //---------------------------------------------------------------------
+    size_t TerrainQuadTreeNode::getMemoryUsage() const
+    {
+        size_t bytes = 0;
+        if (mVertexDataRecord)
+        {
+            VertexData* vertexData[] = {mVertexDataRecord->cpuVertexData, mVertexDataRecord->gpuVertexData};
+            for (int v = 0; v < 2; ++v)
+            {
+                if (!vertexData[v])
+                    continue;
+                const VertexBufferBinding::VertexBufferBindingMap& bindings =
+                    vertexData[v]->vertexBufferBinding->getBindings();
+                for (VertexBufferBinding::VertexBufferBindingMap::const_iterator i = bindings.begin();
+                    i != bindings.end(); ++i)
+                {
+                    bytes += i->second->getSizeInBytes();
+                }
+            }
+        }
+
+        if (!isLeaf())
+        {
+            for (int i = 0; i < 4; ++i)
+                bytes += mChildren[i]->getMemoryUsage();
+        }
+        return bytes;
+    }
+    //---------------------------------------------------------------------
     void TerrainQuadTreeNode::load()
     {
         loadSelf();
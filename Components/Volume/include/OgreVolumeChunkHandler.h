@@ -121,8 +121,10 @@ namespace Volume {
         /** Adds a new ChunkRequest to be loaded to the WorkQueue.
         @param req
             The ChunkRequest.
+        @param priority
+            The WorkQueue priority, higher values are processed first.
         */
-        void addRequest(const ChunkRequest &req);
+        void addRequest(const ChunkRequest &req, Real priority = 0);
 
         /** Calls the process-update of the WorkQueue so it doesn't block.
         */
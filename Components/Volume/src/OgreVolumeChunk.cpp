@@ -77,7 +77,15 @@ namespace Volume {
             req.meshBuilder = OGRE_NEW MeshBuilder();
             req.dualGridGenerator = OGRE_NEW DualGridGenerator();
 
-            mChunkHandler.addRequest(req);
+            // Chunks closer to the camera first
+            Real priority = 0;
+            Camera* camera = mShared->parameters->loadPriorityCamera;
+            if (camera)
+            {
+                Vector3 centre = parent->_getDerivedPosition() + (from + to) / (Real)2.0 * mShared->parameters->scale;
+                priority = -centre.distance(camera->getDerivedPosition());
+            }
+            mChunkHandler.addRequest(req, priority);
         }
         else
         {
@@ -70,10 +70,10 @@ namespace Volume {
 
     //-----------------------------------------------------------------------
   
-    void ChunkHandler::addRequest(const ChunkRequest &req)
+    void ChunkHandler::addRequest(const ChunkRequest &req, Real priority)
     {
         init();
-        mWQ->addRequest(mWorkQueueChannel, WORKQUEUE_LOAD_REQUEST, Any(req));
+        mWQ->addRequest(mWorkQueueChannel, WORKQUEUE_LOAD_REQUEST, Any(req), 0, false, false, priority);
     }
     
     //-----------------------------------------------------------------------
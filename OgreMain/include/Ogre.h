@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgrePrerequisites.h"
 
 #include "OgreAnimation.h"
+#include "OgreAnimationPrePass.h"
 #include "OgreAnimationState.h"
 #include "OgreAnimationTrack.h"
 #include "OgreAny.h"
@@ -41,11 +42,13 @@ THE SOFTWARE.
 #include "OgreBillboardChain.h"
 #include "OgreBillboardSet.h"
 #include "OgreBone.h"
+#include "OgreBonePoseBuffer.h"
 #include "OgreCamera.h"
 #include "OgreCompositor.h"
 #include "OgreCompositorManager.h"
 #include "OgreCompositorChain.h"
 #include "OgreCompositorInstance.h"
+#include "OgreCompressedTransformKeys.h"
 #include "OgreCompositionTechnique.h"
 #include "OgreCompositionPass.h"
 #include "OgreCompositionTargetPass.h"
@@ -83,8 +86,10 @@ THE SOFTWARE.
 #include "OgreMeshManager.h"
 #include "OgreMovablePlane.h"
 #include "OgreMeshSerializer.h"
+#include "OgreParallelSceneCuller.h"
 #include "OgreParticleAffector.h"
 #include "OgreParticleEmitter.h"
+#include "OgreParticleSoA.h"
 #include "OgreParticleSystem.h"
 #include "OgreParticleSystemManager.h"
 #include "OgrePass.h"
@@ -106,6 +111,8 @@ THE SOFTWARE.
 #include "OgreSceneManager.h"
 #include "OgreSceneManagerEnumerator.h"
 #include "OgreSceneNode.h"
+#include "OgreSceneGraphTransformCache.h"
+#include "OgreSceneQueryBroadPhase.h"
 #include "OgreShadowCameraSetup.h"
 #include "OgreShadowCameraSetupFocused.h"
 #include "OgreShadowCameraSetupLiSPSM.h"
@@ -125,6 +132,7 @@ THE SOFTWARE.
 #include "OgreTechnique.h"
 #include "OgreTextureManager.h"
 #include "OgreTextureUnitState.h"
+#include "OgreThreadPool.h"
 #include "OgreTimer.h"
 #include "OgreVector2.h"
 #include "OgreViewport.h"
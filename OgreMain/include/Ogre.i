@@ -144,7 +144,8 @@ JNIEnv* OgreJNIGetEnv() {
 %include "OgrePrerequisites.h"
 %include "OgrePlatform.h"
 %include "OgreConfig.h"
-%ignore Ogre::AllocPolicy;
+%ignore Ogre::CategorisedAllocPolicy;
+%ignore Ogre::MemoryCategoryAllocator;
 %import "OgreMemoryAllocatorConfig.h"
 %include "OgreCommon.h"
 %template() Ogre::map<Ogre::String, Ogre::String>;
@@ -279,6 +279,24 @@ namespace Ogre {
         void apply(Skeleton* skeleton, Real timePos, float weight,
           const AnimationState::BoneBlendMask* blendMask, Real scale);
 
+        /** Blends all node tracks into a pose instead of applying them to bones (internal use only).
+        @remarks
+            The arrays are indexed by track handle, i.e. bone handle. Each transform is
+            modified exactly as apply would modify the bone, so blending several animations
+            into the same pose and setting the bones once gives the same result as applying
+            them in turn.
+        @param timePos The time position in the animation to apply.
+        @param weight The influence to give to this track.
+        @param blendMask Optional per bone weights, modulated with the weight factor
+        @param scale The scale to apply to translations and scalings.
+        @param positions The positions to translate
+        @param orientations The orientations to rotate
+        @param scales The scales to multiply
+        @param modified Set to 1 for each transform which was modified
+        */
+        void _blendToPose(Real timePos, Real weight, const AnimationState::BoneBlendMask* blendMask,
+            Real scale, Vector3* positions, Quaternion* orientations, Vector3* scales, uint8* modified);
+
         /** Applies all vertex tracks given a specific time point and weight to a given entity.
         @param entity The Entity to which this animation should be applied
         @param timePos The time position in the animation to apply.
@@ -423,6 +441,18 @@ namespace Ogre {
         */
         void optimise(bool discardIdentityNodeTracks = true);
 
+        /** Compress the keyframes of all node tracks.
+        @remarks
+            Lossy, see NodeAnimationTrack::compress. Should be done after optimise
+            since identity tracks can no longer be detected exactly afterwards.
+        @param settings The error allowed when dropping keys
+        */
+        void compressNodeTracks(const CompressedTransformKeys::Settings& settings =
+            CompressedTransformKeys::Settings());
+
+        /** Restore editable keyframes on all compressed node tracks. */
+        void decompressNodeTracks(void);
+
         /// A list of track handles
         typedef set<ushort>::type TrackHandleList;
 
@@ -500,6 +530,14 @@ namespace Ogre {
         
         /// Internal method to adjust keyframes relative to a base keyframe (@see setUseBaseKeyFrame) */
         void _applyBaseKeyFrame();
+
+        /** Internal method which performs the initialisation apply otherwise does lazily.
+        @remarks
+            This applies the base keyframe, builds the keyframe time list and the
+            interpolation splines. Afterwards the apply methods only read the animation,
+            so it can be applied to different targets concurrently.
+        */
+        void _prepareForConcurrentApply(void);
         
         void _notifyContainer(AnimationContainer* c);
         /** Retrieve the container of this animation. */
@@ -0,0 +1,147 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __AnimationPrePass_H__
+#define __AnimationPrePass_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreHardwareVertexBuffer.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Animation
+    *  @{
+    */
+    /** Updates the skeletal animation of all the Entities visible to a camera on the
+        Root ThreadPool.
+    @remarks
+        While collecting, Entity::_updateRenderQueue hands animated entities to the
+        pre-pass instead of updating them immediately. end() then runs between culling
+        and rendering and performs the work Entity::updateAnimation would have done:
+        the animation states are applied to the bone hierarchies, one task per
+        SkeletonInstance, and the software skinned vertex buffers are blended in
+        vertex ranges, all concurrently. The results are identical to the serial update.
+    @par
+        Everything which is not thread safe stays on the calling thread: the
+        decisions what to update, the check out of temporary blend buffers and the
+        hardware buffer locks. Entities with vertex animation, manual LOD levels, tag
+        points or attached objects are therefore always updated immediately.
+    @note
+        Node listeners of bones are called on the worker threads.
+    */
+    class _OgreExport AnimationPrePass : public AnimationAlloc
+    {
+    public:
+        AnimationPrePass();
+
+        /// Start collecting entities, see Entity::_updateRenderQueue
+        void begin(void);
+        /// Whether entities are being collected
+        bool isCollecting(void) const { return mCollecting; }
+        /** Stop collecting and update the animation of the collected entities.
+        @param pool Pool to update on, if NULL or single threaded the updates run serially
+        */
+        void end(ThreadPool* pool);
+
+        /// Internal method to defer the animation update of a visible entity
+        void _addEntity(Entity* entity);
+        /** Internal method to queue a software vertex blend, see Mesh::softwareVertexBlend.
+        @remarks
+            The blend matrices are copied, the matrices they point to must stay valid
+            until the end of the pass.
+        */
+        void _queueSoftwareVertexBlend(const VertexData* sourceVertexData,
+            const VertexData* targetVertexData,
+            const Affine3* const* blendMatrices, size_t numMatrices,
+            bool blendNormals);
+
+        /// Number of entities updated by the last pass
+        size_t getNumEntities(void) const { return mNumEntities; }
+    private:
+        /// Skinning of one vertex data, pointers into the locked buffers
+        struct BlendJob
+        {
+            float* srcPos;
+            float* srcNorm;
+            float* destPos;
+            float* destNorm;
+            float* blendWeight;
+            unsigned char* blendIndex;
+            size_t srcPosStride;
+            size_t srcNormStride;
+            size_t destPosStride;
+            size_t destNormStride;
+            size_t blendWeightStride;
+            size_t blendIndexStride;
+            size_t numWeightsPerVertex;
+            size_t numVertices;
+            /// Index of the first blend matrix in mBlendMatrices
+            size_t firstMatrix;
+        };
+        /// Range of vertices of a BlendJob processed by one task
+        struct BlendTask
+        {
+            size_t job;
+            size_t begin;
+            size_t end;
+        };
+        struct LockedBuffer
+        {
+            HardwareVertexBufferSharedPtr buffer;
+            void* data;
+        };
+        typedef vector<Entity*>::type EntityList;
+        typedef vector<BlendJob>::type BlendJobList;
+        typedef vector<BlendTask>::type BlendTaskList;
+        typedef vector<const Affine3*>::type BlendMatrixList;
+        typedef map<HardwareVertexBuffer*, LockedBuffer>::type LockedBufferMap;
+
+        /// Unlock the buffers and clear the lists of the pass
+        void reset(void);
+        /// Lock a buffer once for the whole pass, source buffers may be shared by entities
+        void* lockBuffer(const HardwareVertexBufferSharedPtr& buffer, HardwareBuffer::LockOptions options);
+
+        EntityList mEntities;
+        BlendJobList mBlendJobs;
+        BlendTaskList mBlendTasks;
+        BlendMatrixList mBlendMatrices;
+        LockedBufferMap mLockedBuffers;
+        bool mCollecting;
+        size_t mNumEntities;
+    };
+    /** @} */
+    /** @} */
+
+} // namespace Ogre
+
+#include "OgreHeaderSuffix.h"
+
+#endif
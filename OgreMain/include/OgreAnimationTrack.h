@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include "OgreSimpleSpline.h"
 #include "OgreRotationalSpline.h"
 #include "OgrePose.h"
+#include "OgreCompressedTransformKeys.h"
 
 namespace Ogre 
 {
@@ -352,6 +353,15 @@ namespace Ogre
         virtual void applyToNode(Node* node, const TimeIndex& timeIndex, Real weight = 1.0, 
             Real scale = 1.0f);
 
+        /** Computes the transform applyToNode would apply to a node.
+        @remarks
+            applyToNode translates the node by outTranslate, rotates it by
+            outRotate in local space and multiplies its scale by outScale.
+        @return False if the track has no effect, in which case the outputs are not set
+        */
+        bool _getWeightedTransform(const TimeIndex& timeIndex, Real weight, Real scale,
+            Vector3& outTranslate, Quaternion& outRotate, Vector3& outScale) const;
+
         /** Sets the method of rotation calculation */
         virtual void setUseShortestRotationPath(bool useShortestPath);
 
@@ -384,6 +394,40 @@ namespace Ogre
         NodeAnimationTrack* _clone(Animation* newParent) const;
         
         void _applyBaseKeyFrame(const KeyFrame* base);
+
+        /** Internal method which builds the interpolation splines if they are out of
+            date, rather than lazily on the next spline interpolated getInterpolatedKeyFrame. */
+        void _buildInterpolationSplines(void) const;
+
+        /** Replace the keyframes of this track by a compact representation.
+        @remarks
+            The keys are moved to a CompressedTransformKeys, which quantises rotations,
+            stores unchanging channels once and drops keys which linear interpolation
+            reproduces within the given tolerances. This is lossy and one-way: once
+            compressed the track has no KeyFrame objects, getNumKeyFrames returns 0
+            and the keys are accessed through getCompressedKeys. Creating a keyframe
+            or calling decompress restores editable keyframes from the compressed keys.
+        @par
+            Compressed tracks are always interpolated linearly. Does nothing if the
+            track has no keyframes.
+        */
+        void compress(const CompressedTransformKeys::Settings& settings =
+            CompressedTransformKeys::Settings());
+
+        /** Recreate keyframes from the compressed keys, see compress. */
+        void decompress(void);
+
+        /** Whether the keys of this track are compressed. */
+        bool isCompressed(void) const { return mCompressedKeys != 0; }
+
+        /** The compressed keys, or NULL if the track is not compressed. */
+        const CompressedTransformKeys* getCompressedKeys(void) const { return mCompressedKeys; }
+
+        /** Replace the keyframes of this track by the given compressed keys (internal use only).
+        @remarks
+            The track takes ownership of the keys.
+        */
+        void _setCompressedKeys(CompressedTransformKeys* keys);
         
     protected:
         /// Specialised keyframe creation
@@ -405,6 +449,8 @@ namespace Ogre
         mutable bool mSplineBuildNeeded;
         /// Defines if rotation is done using shortest path
         mutable bool mUseShortestRotationPath ;
+        /// Keys replacing the keyframe list once compressed
+        CompressedTransformKeys* mCompressedKeys;
     };
 
     /** Type of vertex animation.
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgrePrerequisites.h"
 #include "OgreParticleSystemRenderer.h"
 #include "OgreBillboardSet.h"
+#include "OgreBillboard.h"
 #include "OgreHeaderPrefix.h"
 
 namespace Ogre {
@@ -54,6 +55,8 @@ namespace Ogre {
     protected:
         /// The billboard set that's doing the rendering
         BillboardSet* mBillboardSet;
+        /// Billboards generated from the particles, injected as one batch
+        vector<Billboard>::type mBillboards;
     public:
         BillboardParticleRenderer();
         ~BillboardParticleRenderer();
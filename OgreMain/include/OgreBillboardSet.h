@@ -198,6 +198,8 @@ namespace Ogre {
         Quaternion mCamQ;
         /// Camera position in billboard space
         Vector3 mCamPos;
+        /// Vertex colour format, fetched in beginBillboards
+        VertexElementType mColourType;
 
         /// The vertex index data for all billboards in this set (1 set only)
         IndexData* mIndexData;
@@ -222,6 +224,9 @@ namespace Ogre {
         /// Number of visible billboards (will be == getNumBillboards if mCullIndividual == false)
         unsigned short mNumVisibleBillboards;
 
+        /// Billboards of the current batch which passed individual culling
+        vector<const Billboard*>::type mBatchVisibleBillboards;
+
         /// Internal method for increasing pool size
         virtual void increasePool(size_t size);
 
@@ -236,7 +241,7 @@ namespace Ogre {
         @remarks
             Optional parameter pBill is only present for type BBT_ORIENTED_SELF and BBT_PERPENDICULAR_SELF
         */
-        void genBillboardAxes(Vector3* pX, Vector3 *pY, const Billboard* pBill = 0);
+        void genBillboardAxes(Vector3* pX, Vector3 *pY, const Billboard* pBill = 0) const;
 
         /** Internal method, generates parametric offsets based on origin.
         */
@@ -248,6 +253,44 @@ namespace Ogre {
         */
         void genVertices(const Vector3* const offsets, const Billboard& pBillboard);
 
+        /** Internal method for generating vertex data into a given location.
+        @remarks
+            Does not modify the set, so it can be called from several threads at once.
+        @param pDest Where to write the vertices
+        @param offsets Array of 4 Vector3 offsets
+        @param pBillboard Reference to billboard
+        @param colour The billboard colour, already converted to the vertex colour format
+        @return The location following the written vertices
+        */
+        float* genVertices(float* pDest, const Vector3* const offsets, const Billboard& pBillboard,
+            RGBA colour) const;
+
+        /** Internal method returning the corner offsets of a billboard.
+        @remarks
+            Returns the offsets precalculated in beginBillboards if the billboard can use
+            them, otherwise generates its own offsets into pOwnOffsets and returns that.
+        */
+        const Vector3* getBillboardOffsets(const Billboard& bb, Vector3* pOwnOffsets) const;
+
+        /** Internal method generating the vertices of billboards which passed culling,
+            shared by injectBillboards and the update of the set's own billboards.
+        @param billboards The contiguous billboard array
+        @param visible If not null, the billboards to use instead of the array
+        @param count The number of billboards
+        */
+        void injectBillboardBatch(const Billboard* billboards, const Billboard* const* visible,
+            size_t count);
+
+        /** Internal method generating the vertices of a range of the billboards
+            passed to injectBillboardBatch.
+        @param billboards The contiguous billboard array
+        @param visible If not null, the billboards to use instead of the array
+        @param begin,end The range of billboards to process
+        @param pDest Where to write the vertices of the first billboard in the range
+        */
+        void genVerticesBatch(const Billboard* billboards, const Billboard* const* visible,
+            size_t begin, size_t end, float* pDest) const;
+
         /** Internal method generates vertex offsets.
         @remarks
             Takes in parametric offsets as generated from getParametericOffsets, width and height values
@@ -257,7 +300,7 @@ namespace Ogre {
         */
         void genVertOffsets(Real inleft, Real inright, Real intop, Real inbottom,
             Real width, Real height,
-            const Vector3& x, const Vector3& y, Vector3* pDestVec);
+            const Vector3& x, const Vector3& y, Vector3* pDestVec) const;
 
 
         /** Sort by direction functor */
@@ -322,7 +365,8 @@ namespace Ogre {
             data. When driving the billboard from external data, you must call
             _notifyCurrentCamera to reorient the billboards, setPoolSize to set
             the maximum billboards you want to use, beginBillboards to 
-            start the update, and injectBillboard per billboard, 
+            start the update, and injectBillboard per billboard (or injectBillboards
+            for a contiguous array),
             followed by endBillboards.
         @see
             BillboardSet::setAutoextend
@@ -548,6 +592,17 @@ namespace Ogre {
         void beginBillboards(size_t numBillboards = 0);
         /** Define a billboard. */
         void injectBillboard(const Billboard& bb);
+        /** Define a batch of billboards stored contiguously.
+        @remarks
+            Produces the same vertices as calling injectBillboard for each billboard in
+            turn. Individual culling is done up front, after which the vertices are
+            generated straight into the locked buffer in chunks, on the Root thread pool
+            when the batch is large enough. Corners of billboards without rotation are
+            expanded by OptimisedUtil::expandBillboardQuads.
+        @param billboards Pointer to the first billboard
+        @param count Number of billboards
+        */
+        void injectBillboards(const Billboard* billboards, size_t count);
         /** Finish defining billboards. */
         void endBillboards(void);
         /** Set the bounds of the BillboardSet.
@@ -126,6 +126,21 @@ namespace Ogre
         /// @see Node::needUpdate
         void needUpdate(bool forceParentUpdate = false);
 
+        /** Sets the derived transform as computed by BonePoseBuffer.
+        @remarks
+            Internal use only. Leaves the bone in the state Node::_update would.
+        */
+        void _setDerivedTransform(const Vector3& position, const Quaternion& orientation,
+            const Vector3& scale);
+
+        /** Sets the position, orientation and scale relative to the parent at once.
+        @remarks
+            Internal use only. Unlike setOrientation the orientation is not normalised,
+            and the bone is marked out of date once.
+        */
+        void _setLocalTransform(const Vector3& position, const Quaternion& orientation,
+            const Vector3& scale);
+
 
     protected:
         /** See Node. */
@@ -0,0 +1,164 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __BonePoseBuffer_H__
+#define __BonePoseBuffer_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreVector3.h"
+#include "OgreQuaternion.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Animation
+    *  @{
+    */
+    /** Flattened pose of the bones of a Skeleton, used by Skeleton::_updateTransforms.
+    @remarks
+        The bones are stored ordered by depth, so every parent precedes its children
+        and the hierarchy is updated by one linear loop over parent indices instead of
+        recursing through Node::_update. The local, derived and inverse binding pose
+        transforms are kept in structure-of-arrays form in a single SIMD aligned block.
+    @par
+        The Bone objects remain the interface to the pose: the local transforms are
+        read from them at the start of each update and the derived transforms written
+        back, computed exactly as Node::updateFromParentImpl does, so the results are
+        bit-identical to the recursive update. Skeletons with Node::Listener instances
+        on their bones or with TagPoints attached are not supported by the buffer and
+        are updated through the Node hierarchy instead.
+    @par
+        The flattened hierarchy is rebuilt automatically when bones are added or
+        reparented.
+    */
+    class _OgreExport BonePoseBuffer : public AnimationAlloc
+    {
+    public:
+        typedef vector<Bone*>::type BoneList;
+
+        BonePoseBuffer();
+        ~BonePoseBuffer();
+
+        /** Update the derived transforms of the bones.
+        @param bones The bones of the skeleton, indexed by handle
+        @return False if the bones cannot be updated through the buffer, in which case
+            nothing was modified
+        */
+        bool update(const BoneList& bones);
+
+        /** Compute the transforms from the binding pose to the current pose.
+        @remarks
+            Equivalent to Bone::_getOffsetTransform for all bones, as of the last
+            successful update.
+        @param matrices Array indexed by bone handle, must hold getNumBones entries
+        */
+        void getOffsetTransforms(Affine3* matrices) const;
+
+        /// Whether the last update went through the buffer
+        bool isValid(void) const { return mValid; }
+        /// Number of bones in the buffer
+        size_t getNumBones(void) const { return mBones.size(); }
+        /// Handle of the bone at the given index, bones are ordered by depth
+        ushort getHandle(size_t index) const { return mHandles[index]; }
+        /// Index of the parent of the bone at the given index, NO_PARENT for roots
+        uint16 getParentIndex(size_t index) const { return mParents[index]; }
+
+        /// Derived position of the bone at the given index as of the last update
+        Vector3 getDerivedPosition(size_t index) const { return loadVector3(mDerived.position, index); }
+        /// Derived orientation of the bone at the given index as of the last update
+        Quaternion getDerivedOrientation(size_t index) const { return loadQuaternion(mDerived.orientation, index); }
+        /// Derived scale of the bone at the given index as of the last update
+        Vector3 getDerivedScale(size_t index) const { return loadVector3(mDerived.scale, index); }
+
+        static const uint16 NO_PARENT = 0xFFFF;
+    private:
+        /// Position, orientation (w, x, y, z) and scale arrays
+        struct TransformStreams
+        {
+            Real* position[3];
+            Real* orientation[4];
+            Real* scale[3];
+        };
+
+        enum BoneFlags
+        {
+            BF_INHERIT_ORIENTATION = 0x1,
+            BF_INHERIT_SCALE = 0x2
+        };
+
+        /// Flatten the hierarchy, returns false if it is not supported
+        bool rebuild(const BoneList& bones);
+        enum GatherResult
+        {
+            GR_OK,
+            GR_HIERARCHY_CHANGED,
+            /// Bones with listeners or TagPoints
+            GR_UNSUPPORTED
+        };
+        /// Read the local and binding pose transforms
+        GatherResult gather(const BoneList& bones);
+
+        static Vector3 loadVector3(Real* const* streams, size_t i)
+        { return Vector3(streams[0][i], streams[1][i], streams[2][i]); }
+        static Quaternion loadQuaternion(Real* const* streams, size_t i)
+        { return Quaternion(streams[0][i], streams[1][i], streams[2][i], streams[3][i]); }
+        static void storeVector3(Real* const* streams, size_t i, const Vector3& v)
+        { streams[0][i] = v.x; streams[1][i] = v.y; streams[2][i] = v.z; }
+        static void storeQuaternion(Real* const* streams, size_t i, const Quaternion& q)
+        { streams[0][i] = q.w; streams[1][i] = q.x; streams[2][i] = q.y; streams[3][i] = q.z; }
+
+        typedef vector<uint16>::type IndexList;
+
+        /// Bones ordered by depth
+        BoneList mBones;
+        /// Parent nodes of mBones, used to detect hierarchy changes
+        vector<Node*>::type mParentNodes;
+        IndexList mHandles;
+        IndexList mParents;
+        /// Number of children of each bone which are bones of the skeleton
+        IndexList mNumBoneChildren;
+        vector<uint8>::type mFlags;
+
+        TransformStreams mLocal;
+        TransformStreams mDerived;
+        TransformStreams mBindInverse;
+        /// Storage of all the transform streams
+        Real* mData;
+
+        bool mValid;
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -589,12 +589,19 @@ namespace Ogre {
         */
         virtual void forwardIntersect(const Plane& worldPlane, vector<Vector4>::type* intersect3d) const;
 
+        using Frustum::isVisible;
         /// @copydoc Frustum::isVisible(const AxisAlignedBox&, FrustumPlane*) const
         bool isVisible(const AxisAlignedBox& bound, FrustumPlane* culledBy = 0) const;
         /// @copydoc Frustum::isVisible(const Sphere&, FrustumPlane*) const
         bool isVisible(const Sphere& bound, FrustumPlane* culledBy = 0) const;
         /// @copydoc Frustum::isVisible(const Vector3&, FrustumPlane*) const
         bool isVisible(const Vector3& vert, FrustumPlane* culledBy = 0) const;
+        /// @copydoc Frustum::isVisible(size_t, const float* const[3], const float* const[3], uint32*) const
+        void isVisible(size_t numBoxes, const float* const centres[3],
+                       const float* const halfSizes[3], uint32* visibility) const;
+        /// @copydoc Frustum::isVisible(size_t, const float* const[3], const float*, uint32*) const
+        void isVisible(size_t numSpheres, const float* const centres[3],
+                       const float* radii, uint32* visibility) const;
         /// @copydoc Frustum::getWorldSpaceCorners
         const Vector3* getWorldSpaceCorners(void) const;
         /// @copydoc Frustum::getFrustumPlane
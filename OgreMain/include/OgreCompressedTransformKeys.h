@@ -0,0 +1,196 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __CompressedTransformKeys_H__
+#define __CompressedTransformKeys_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreVector3.h"
+#include "OgreQuaternion.h"
+#include "OgreAtomicScalar.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Animation
+    *  @{
+    */
+    /** Compact storage for the keyframes of a NodeAnimationTrack.
+    @remarks
+        Instead of one heap allocated TransformKeyFrame per key, the key times,
+        translations, rotations and scales are each held in a contiguous array.
+        Rotations are quantised to 48 bits using the 'smallest three' encoding,
+        channels which do not change over the whole track are stored only once,
+        and keys which can be reproduced by linearly interpolating their neighbours
+        within the requested tolerances are dropped.
+    @par
+        Sampling looks the key up starting from the interval found by the previous
+        sample, falling back to a binary search, so playing an animation forwards
+        costs a couple of comparisons per track. The cursor is a hint only and
+        may be shared by concurrent samplers.
+    @par
+        Compressed keys are always interpolated linearly, Animation::IM_SPLINE is
+        ignored for tracks which use them.
+    @see NodeAnimationTrack::compress
+    */
+    class _OgreExport CompressedTransformKeys : public AnimationAlloc
+    {
+    public:
+        /// Maximum error allowed when dropping keys
+        struct _OgreExport Settings
+        {
+            Settings();
+
+            /// Maximum distance between the interpolated and the original translation
+            Real positionTolerance;
+            /// Maximum angle between the interpolated and the original rotation
+            Radian rotationTolerance;
+            /// Maximum difference between the interpolated and the original scale
+            Real scaleTolerance;
+        };
+
+        /// Channels stored as a single value for the whole track
+        enum ConstantChannel
+        {
+            CC_TRANSLATE = 0x1,
+            CC_ROTATION = 0x2,
+            CC_SCALE = 0x4
+        };
+
+        /// Rotation quantised to three 15 bit components
+        struct PackedRotation
+        {
+            uint16 data[3];
+        };
+
+        CompressedTransformKeys();
+        CompressedTransformKeys(const CompressedTransformKeys& rhs);
+
+        /** Build from the keyframes of a track.
+        @param track The source of the keys, which must have at least one keyframe
+        @param settings The error allowed for dropped keys
+        @param sphericalRotation Whether the track is interpolated using Quaternion::Slerp
+            rather than Quaternion::nlerp
+        */
+        void build(const NodeAnimationTrack* track, const Settings& settings,
+            bool sphericalRotation);
+
+        /** Interpolate the keys at the given time.
+        @remarks
+            Follows AnimationTrack::getKeyFramesAtTime, wrapping from the last key
+            back to the first one.
+        @param timePos The time position in the animation
+        @param length The length of the animation
+        @param sphericalRotation Interpolate rotations using Quaternion::Slerp
+        @param shortestPath Interpolate rotations along the shortest path
+        @param kf Receives the result
+        */
+        void getInterpolatedKeyFrame(Real timePos, Real length, bool sphericalRotation,
+            bool shortestPath, TransformKeyFrame* kf) const;
+
+        /// Number of keys kept
+        size_t getNumKeys(void) const { return mTimes.size(); }
+        /// Time of the given key
+        Real getKeyTime(size_t index) const { return mTimes[index]; }
+        /// Decode the given key
+        void getKey(size_t index, TransformKeyFrame* kf) const;
+        /// Combination of ConstantChannel flags
+        uint16 getConstantChannels(void) const { return mConstantChannels; }
+        /// Number of bytes used by the keys
+        size_t getMemoryUsage(void) const;
+
+        /** Re-base the keys relative to the given transform.
+        @see AnimationTrack::_applyBaseKeyFrame
+        */
+        void _applyBaseTransform(const Vector3& translate, const Quaternion& rotation,
+            const Vector3& scale);
+
+        /** Resize the arrays for direct access by serializers.
+        @remarks
+            Channels flagged as constant get a single element.
+        */
+        void _resize(size_t numKeys, uint16 constantChannels);
+        float* _getTimes(void) { return mTimes.empty() ? 0 : &mTimes[0]; }
+        const float* _getTimes(void) const { return mTimes.empty() ? 0 : &mTimes[0]; }
+        /// Translations as x, y, z triplets
+        float* _getTranslations(void) { return mTranslations.empty() ? 0 : &mTranslations[0]; }
+        const float* _getTranslations(void) const { return mTranslations.empty() ? 0 : &mTranslations[0]; }
+        /// Packed rotations as triplets of uint16
+        uint16* _getRotations(void) { return mRotations.empty() ? 0 : mRotations[0].data; }
+        const uint16* _getRotations(void) const { return mRotations.empty() ? 0 : mRotations[0].data; }
+        /// Scales as x, y, z triplets
+        float* _getScales(void) { return mScales.empty() ? 0 : &mScales[0]; }
+        const float* _getScales(void) const { return mScales.empty() ? 0 : &mScales[0]; }
+        /// Number of elements of each channel
+        size_t getNumTranslations(void) const { return mTranslations.size() / 3; }
+        size_t getNumRotations(void) const { return mRotations.size(); }
+        size_t getNumScales(void) const { return mScales.size() / 3; }
+
+        /// Quantise a unit quaternion
+        static PackedRotation packRotation(const Quaternion& q);
+        /// Restore a quantised quaternion
+        static Quaternion unpackRotation(const PackedRotation& p);
+    private:
+        /** Find the keys around the given time.
+        @return Parametric position between the two keys
+        */
+        Real findKeys(Real timePos, Real length, size_t& key1, size_t& key2) const;
+
+        Vector3 getTranslate(size_t index) const
+        {
+            const float* v = &mTranslations[(mConstantChannels & CC_TRANSLATE) ? 0 : index * 3];
+            return Vector3(v[0], v[1], v[2]);
+        }
+        Quaternion getRotation(size_t index) const
+        {
+            return unpackRotation(mRotations[(mConstantChannels & CC_ROTATION) ? 0 : index]);
+        }
+        Vector3 getScale(size_t index) const
+        {
+            const float* v = &mScales[(mConstantChannels & CC_SCALE) ? 0 : index * 3];
+            return Vector3(v[0], v[1], v[2]);
+        }
+
+        vector<float>::type mTimes;
+        vector<float>::type mTranslations;
+        vector<PackedRotation>::type mRotations;
+        vector<float>::type mScales;
+        uint16 mConstantChannels;
+        /// Key found by the last search
+        mutable AtomicScalar<uint32> mCursor;
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -473,6 +473,34 @@ namespace Ogre {
         void setFreeOnClose(bool free) { mFreeOnClose = free; }
     };
 
+    /** Read-only MemoryDataStream over a memory mapped file.
+    @remarks
+        The file is mapped into the address space instead of being read, so
+        consumers that accept a MemoryDataStream can work on getPtr() directly
+        and the OS only pages in what is actually touched. The mapping is
+        released on close.
+    */
+    class _OgreExport MappedDataStream : public MemoryDataStream
+    {
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32 || OGRE_PLATFORM == OGRE_PLATFORM_WINRT
+        /// File mapping object, kept open for the lifetime of the view
+        void* mMapping;
+#endif
+    public:
+        /** Map a file.
+        @param name The name to give the stream
+        @param path The path of the file to map
+        @note Throws ERR_FILE_NOT_FOUND if the file cannot be opened or mapped.
+        */
+        MappedDataStream(const String& name, const String& path);
+
+        ~MappedDataStream();
+
+        /** @copydoc DataStream::close
+        */
+        void close(void);
+    };
+
     /** Common subclass of DataStream for handling data from 
         std::basic_istream.
     */
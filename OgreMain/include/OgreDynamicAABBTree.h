@@ -0,0 +1,161 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __DynamicAABBTree_H__
+#define __DynamicAABBTree_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreVector3.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Incrementally updated bounding volume hierarchy of axis aligned boxes.
+    @remarks
+        Every proxy is a leaf holding a user pointer and a 'fat' box, which is the box it
+        was inserted with enlarged by a margin proportional to its size. Moving a proxy
+        only touches the tree when the new box leaves the fat box, so objects jittering in
+        place cost nothing. Leaves are inserted where they increase the surface area of the
+        hierarchy least, and internal nodes are rotated to keep the tree balanced.
+    @par
+        Nodes are stored in a single array and addressed by index, proxy handles stay valid
+        until destroyProxy. The tree is not thread safe for modification, but any number of
+        threads may traverse it concurrently.
+    */
+    class _OgreExport DynamicAABBTree : public SceneMgtAlloc
+    {
+    public:
+        /// Handle used for 'no node'
+        static const uint32 NULL_NODE = 0xFFFFFFFF;
+
+        /** Constructor.
+        @param margin Fraction of the box size the stored boxes are enlarged by on each side
+        */
+        explicit DynamicAABBTree(Real margin = 0.1f);
+
+        /// Insert a box, returns the handle of the new proxy
+        uint32 createProxy(const AxisAlignedBox& box, void* userData);
+        /// Remove a proxy
+        void destroyProxy(uint32 proxy);
+        /** Update the box of a proxy.
+        @return true if the proxy was reinserted, false if the box was still inside its fat box
+        */
+        bool moveProxy(uint32 proxy, const AxisAlignedBox& box);
+        /// Remove all proxies
+        void clear();
+
+        void* getUserData(uint32 proxy) const { return mNodes[proxy].userData; }
+        /// Whether a handle refers to a proxy, rather than to a destroyed proxy or an internal node
+        bool isProxy(uint32 proxy) const { return proxy < mNodes.size() && mNodes[proxy].height == 0; }
+        /// Get the enlarged box stored for a proxy
+        AxisAlignedBox getFatBox(uint32 proxy) const;
+
+        /// Number of proxies in the tree
+        size_t getNumProxies() const { return mNumProxies; }
+        /// Height of the tree, 0 for a single leaf
+        int getHeight() const { return mRoot == NULL_NODE ? 0 : mNodes[mRoot].height; }
+
+        /** Visit all proxies whose fat box passes a test.
+        @remarks
+            The visitor must provide <tt>bool overlaps(const Vector3& min, const Vector3& max)</tt>,
+            used to prune whole subtrees, and <tt>bool visit(void* userData)</tt>, called for
+            every leaf that overlaps and which may return false to stop the traversal.
+        @return false if the visitor stopped the traversal
+        */
+        template <class Visitor> bool traverse(Visitor& visitor) const
+        {
+            if (mRoot == NULL_NODE)
+                return true;
+
+            // balanced, so the depth is logarithmic in the proxy count
+            uint32 stack[128];
+            int top = 0;
+            stack[top++] = mRoot;
+            while (top > 0)
+            {
+                const TreeNode& node = mNodes[stack[--top]];
+                if (!visitor.overlaps(node.min, node.max))
+                    continue;
+
+                if (node.isLeaf())
+                {
+                    if (!visitor.visit(node.userData))
+                        return false;
+                }
+                else
+                {
+                    stack[top++] = node.child1;
+                    stack[top++] = node.child2;
+                }
+            }
+            return true;
+        }
+
+    private:
+        struct TreeNode
+        {
+            Vector3 min;
+            Vector3 max;
+            void* userData;
+            /// parent node, or next free node while on the free list
+            uint32 parent;
+            uint32 child1;
+            uint32 child2;
+            /// 0 for leaves, -1 for free nodes
+            int32 height;
+
+            bool isLeaf() const { return child1 == NULL_NODE; }
+        };
+        typedef vector<TreeNode>::type TreeNodeList;
+
+        uint32 allocateNode();
+        void freeNode(uint32 node);
+        void insertLeaf(uint32 leaf);
+        void removeLeaf(uint32 leaf);
+        uint32 balance(uint32 node);
+        void setFatBox(TreeNode& node, const AxisAlignedBox& box) const;
+
+        TreeNodeList mNodes;
+        uint32 mRoot;
+        uint32 mFreeList;
+        size_t mNumProxies;
+        Real mMargin;
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
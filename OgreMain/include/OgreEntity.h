@@ -82,6 +82,7 @@ namespace Ogre {
         // Allow EntityFactory full access
         friend class EntityFactory;
         friend class SubEntity;
+        friend class AnimationPrePass;
     public:
         
         typedef set<Entity*>::type EntitySet;
@@ -140,6 +141,8 @@ namespace Ogre {
         bool mVertexProgramInUse : 1;
         /// Has this entity been initialised yet?
         bool mInitialised : 1;
+        /// Whether the animation update was deferred to the AnimationPrePass of the current render
+        bool mAnimationPrePassQueued : 1;
 
         /** Internal method - given vertex data which could be from the Mesh or
             any submesh, finds the temporary blend copy.
@@ -197,8 +200,30 @@ namespace Ogre {
         /// Records the last frame in which animation was updated.
         unsigned long mFrameAnimationLastUpdated;
 
+        /// What updateAnimation has to do in the current frame, see evaluateAnimationUpdate.
+        struct AnimationUpdate
+        {
+            bool hwAnimation;
+            bool isNeedUpdateHardwareAnim;
+            bool stencilShadows;
+            bool softwareAnimation;
+            bool blendNormals;
+            bool animationDirty;
+            /// Whether bones, vertex animation and software blending have to be reapplied
+            bool applyAnimation;
+        };
+
         /// Perform all the updates required for an animated entity.
         void updateAnimation(void);
+        /** Decide which updates updateAnimation has to perform.
+        @param manualBonesDirty Whether the manual bones of the skeleton were modified
+        */
+        void evaluateAnimationUpdate(AnimationUpdate& update, bool manualBonesDirty);
+        /** Perform the updates decided by evaluateAnimationUpdate.
+        @param prePass If not NULL, the software vertex blending is queued on it
+            instead of being performed immediately
+        */
+        void applyAnimationUpdate(const AnimationUpdate& update, AnimationPrePass* prePass);
 
         /// Records the last frame in which the bones was updated.
         /// It's a pointer because it can be shared between different entities with
@@ -67,6 +67,18 @@ namespace Ogre {
 
         /// Get whether hidden files are ignored during filesystem enumeration.
         static bool getIgnoreHidden();
+
+        /** Set whether files opened read-only are memory mapped.
+        @remarks
+            When enabled, FileSystem archives return a MappedDataStream instead of
+            reading through std::ifstream, so loaders that work on a MemoryDataStream
+            (meshes, images, scripts) use the mapped file directly instead of copying
+            it into a buffer first. The default is false.
+        */
+        static void setUseMemoryMapping(bool mapped);
+
+        /// Get whether files opened read-only are memory mapped.
+        static bool getUseMemoryMapping();
     };
 
     class APKFileSystemArchiveFactory : public ArchiveFactory
@@ -151,6 +151,8 @@ namespace Ogre
         void updateFrustumPlanes(void) const;
         /// Implementation of updateFrustumPlanes (called if out of date)
         virtual void updateFrustumPlanesImpl(void) const;
+        /// Copy the up to date planes used for culling to the array, returns the plane count
+        size_t getCullingPlanes(Plane* planes) const;
         void updateWorldSpaceCorners(void) const;
         /// Implementation of updateWorldSpaceCorners (called if out of date)
         virtual void updateWorldSpaceCornersImpl(void) const;
@@ -472,6 +474,56 @@ namespace Ogre
         */
         virtual bool isVisible(const Vector3& vert, FrustumPlane* culledBy = 0) const;
 
+        /** Tests a batch of bounding boxes against the Frustum.
+        @remarks
+            Gives the same results as calling isVisible(const AxisAlignedBox&) for every
+            box, but tests the boxes in bulk using the SIMD implementation of
+            OptimisedUtil::cullAxisAlignedBoxes available on the running CPU. Boxes are
+            tested in single precision.
+        @par
+            Subclasses overriding isVisible(const AxisAlignedBox&) with different
+            semantics need to override this as well.
+        @param numBoxes
+            Number of boxes to test.
+        @param centres
+            Box centres (world space) in SoA form, i.e. pointers to the x, y and z arrays.
+        @param halfSizes
+            Box half sizes in SoA form. Null and infinite boxes have to be handled by the
+            caller, see isVisible(size_t, const AxisAlignedBox* const*, uint32*).
+        @param visibility
+            Receives one bit per box, bit (i % 32) of visibility[i / 32] is set if box i is visible.
+        */
+        virtual void isVisible(size_t numBoxes, const float* const centres[3],
+                               const float* const halfSizes[3], uint32* visibility) const;
+
+        /** Tests a batch of bounding boxes against the Frustum.
+        @remarks
+            Convenience version of the above, packing the boxes into SoA form. Null and
+            infinite boxes are handled like isVisible(const AxisAlignedBox&) does.
+        @param numBoxes
+            Number of boxes to test.
+        @param boxes
+            Pointers to the boxes (world space).
+        @param visibility
+            Receives one bit per box, bit (i % 32) of visibility[i / 32] is set if box i is visible.
+        */
+        void isVisible(size_t numBoxes, const AxisAlignedBox* const* boxes, uint32* visibility) const;
+
+        /** Tests a batch of bounding spheres against the Frustum.
+        @remarks
+            The bulk version of isVisible(const Sphere&), see above.
+        @param numSpheres
+            Number of spheres to test.
+        @param centres
+            Sphere centres (world space) in SoA form.
+        @param radii
+            Sphere radii.
+        @param visibility
+            Receives one bit per sphere, bit (i % 32) of visibility[i / 32] is set if sphere i is visible.
+        */
+        virtual void isVisible(size_t numSpheres, const float* const centres[3],
+                               const float* radii, uint32* visibility) const;
+
         /// Overridden from MovableObject::getTypeFlags
         uint32 getTypeFlags(void) const;
 
@@ -161,6 +161,15 @@ namespace Ogre
 
         void updateVisibility(void);
 
+        /** Bulk version of InstancedEntity::findVisible for up to 32 instances.
+        @param camera Camera to cull against, may be null to only check whether the
+            instances are in the scene and visible
+        @param begin Index of the first instance in mInstancedEntities
+        @param count Number of instances to test, at most 32
+        @return Bit i is set if instance begin + i is visible
+        */
+        uint32 findVisibleInstances( Camera *camera, size_t begin, size_t count ) const;
+
         /** @see _defragmentBatch */
         void defragmentBatchNoCull( InstancedEntityVec &usedEntities, CustomParamsVec &usedParams );
 
@@ -463,6 +463,16 @@ namespace Ogre
         }
 
         static void SetRandomValueProvider(RandomValueProvider* provider);
+
+        /** Sets a random value provider for the calling thread only.
+        @remarks
+            Takes precedence over SetRandomValueProvider for UnitRandom calls made on
+            this thread, which allows code running concurrently (e.g. particle systems
+            updated in parallel) to draw from separate, deterministic streams.
+        @param provider The provider, or NULL to use the global one again
+        @return The previous provider of this thread, so it can be restored
+        */
+        static RandomValueProvider* SetThreadRandomValueProvider(RandomValueProvider* provider);
        
         /** Tangent function.
             @param fValue
@@ -77,31 +77,30 @@ namespace Ogre
 
 }
 
+#include "OgreMemoryAllocatedObject.h"
+#include "OgreMemoryCategoryAllocator.h"
+
 namespace Ogre
 {
-    class AllocPolicy {};
-    // this is a template, mainly so swig does not pick it up
-    template<int Category = MEMCATEGORY_GENERAL> class AllocatedObject {};
-
     // Useful shortcuts
-    typedef AllocPolicy GeneralAllocPolicy;
-    typedef AllocPolicy GeometryAllocPolicy;
-    typedef AllocPolicy AnimationAllocPolicy;
-    typedef AllocPolicy SceneCtlAllocPolicy;
-    typedef AllocPolicy SceneObjAllocPolicy;
-    typedef AllocPolicy ResourceAllocPolicy;
-    typedef AllocPolicy ScriptingAllocPolicy;
-    typedef AllocPolicy RenderSysAllocPolicy;
+    typedef CategorisedAllocPolicy<Ogre::MEMCATEGORY_GENERAL> GeneralAllocPolicy;
+    typedef CategorisedAllocPolicy<Ogre::MEMCATEGORY_GEOMETRY> GeometryAllocPolicy;
+    typedef CategorisedAllocPolicy<Ogre::MEMCATEGORY_ANIMATION> AnimationAllocPolicy;
+    typedef CategorisedAllocPolicy<Ogre::MEMCATEGORY_SCENE_CONTROL> SceneCtlAllocPolicy;
+    typedef CategorisedAllocPolicy<Ogre::MEMCATEGORY_SCENE_OBJECTS> SceneObjAllocPolicy;
+    typedef CategorisedAllocPolicy<Ogre::MEMCATEGORY_RESOURCE> ResourceAllocPolicy;
+    typedef CategorisedAllocPolicy<Ogre::MEMCATEGORY_SCRIPTING> ScriptingAllocPolicy;
+    typedef CategorisedAllocPolicy<Ogre::MEMCATEGORY_RENDERSYS> RenderSysAllocPolicy;
 
     // Now define all the base classes for each allocation
-    typedef AllocatedObject<> GeneralAllocatedObject;
-    typedef AllocatedObject<> GeometryAllocatedObject;
-    typedef AllocatedObject<> AnimationAllocatedObject;
-    typedef AllocatedObject<> SceneCtlAllocatedObject;
-    typedef AllocatedObject<> SceneObjAllocatedObject;
-    typedef AllocatedObject<> ResourceAllocatedObject;
-    typedef AllocatedObject<> ScriptingAllocatedObject;
-    typedef AllocatedObject<> RenderSysAllocatedObject;
+    typedef AllocatedObject<GeneralAllocPolicy> GeneralAllocatedObject;
+    typedef AllocatedObject<GeometryAllocPolicy> GeometryAllocatedObject;
+    typedef AllocatedObject<AnimationAllocPolicy> AnimationAllocatedObject;
+    typedef AllocatedObject<SceneCtlAllocPolicy> SceneCtlAllocatedObject;
+    typedef AllocatedObject<SceneObjAllocPolicy> SceneObjAllocatedObject;
+    typedef AllocatedObject<ResourceAllocPolicy> ResourceAllocatedObject;
+    typedef AllocatedObject<ScriptingAllocPolicy> ScriptingAllocatedObject;
+    typedef AllocatedObject<RenderSysAllocPolicy> RenderSysAllocatedObject;
 
 
     // Per-class allocators defined here
@@ -176,11 +175,17 @@ namespace Ogre
 */
 
 /// Allocate a block of raw memory, and indicate the category of usage
-#   define OGRE_MALLOC(bytes, category) (void*)new char[bytes]
+#   define OGRE_MALLOC(bytes, category) ::Ogre::CategorisedAllocPolicy<category>::allocateBytes(bytes)
 /// Allocate a block of memory for a primitive type, and indicate the category of usage
-#   define OGRE_ALLOC_T(T, count, category) (T*)new char[(count) * sizeof(T)]
+#   define OGRE_ALLOC_T(T, count, category) static_cast<T*>(::Ogre::CategorisedAllocPolicy<category>::allocateBytes(sizeof(T)*(count)))
 /// Free the memory allocated with OGRE_MALLOC or OGRE_ALLOC_T. Category is required to be restated to ensure the matching policy is used
-#   define OGRE_FREE(ptr, category) delete[] (char*)ptr
+#   define OGRE_FREE(ptr, category) ::Ogre::CategorisedAllocPolicy<category>::deallocateBytes((void*)ptr)
+
+/// Resize a block allocated with OGRE_MALLOC or OGRE_ALLOC_T, like realloc
+#   define OGRE_REALLOC(ptr, bytes, category) ::Ogre::CategorisedAllocPolicy<category>::reallocateBytes((void*)ptr, bytes)
+
+// The _T variants stay on the global heap; they are used for external types whose
+// lifetime is not always ended through OGRE_DELETE_T (e.g. handed to shared pointers)
 
 /// Allocate space for one primitive type, external type or non-virtual type with constructor parameters
 #   define OGRE_NEW_T(T, category) new T
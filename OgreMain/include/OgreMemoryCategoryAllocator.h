@@ -0,0 +1,205 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __MemoryCategoryAllocator_H__
+#define __MemoryCategoryAllocator_H__
+
+#include "OgrePlatform.h"
+#include <limits>
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+
+    /** Interface for the allocators that back the memory categories.
+    @remarks
+        Implementations only deal with raw bytes; bookkeeping (the block header,
+        the per category counters and budgets) is done by MemoryCategoryAllocator.
+        The size passed to deallocateBytes is the one passed to allocateBytes, so
+        size-class based allocators don't need to store it themselves.
+    @par
+        Allocators must be thread safe, and have to stay alive until every block
+        they returned has been freed.
+    */
+    class _OgreExport MemoryAllocator
+    {
+    public:
+        virtual ~MemoryAllocator() {}
+
+        /// Allocate at least size bytes, aligned to OGRE_SIMD_ALIGNMENT
+        virtual void* allocateBytes(size_t size, int category) = 0;
+        /// Free a block returned by allocateBytes
+        virtual void deallocateBytes(void* ptr, size_t size, int category) = 0;
+    };
+
+    /** Size-class pool allocator; the default allocator for every category.
+    @remarks
+        Small blocks (up to MAX_POOLED_SIZE bytes) are carved out of chunks which
+        are kept separately for every category, so the data of one subsystem is
+        not interleaved with the data of another. Each thread keeps a small cache
+        of free blocks per category and size class, which is refilled from and
+        flushed to the shared lists in batches, so worker threads which create
+        and destroy lots of small objects rarely touch a lock. Larger blocks go
+        straight to malloc.
+    @par
+        A thread keeps caches for at most MAX_THREAD_CACHES pool instances; beyond
+        that it still works, but takes the lock of the shared lists on every
+        allocation and free for the additional pools.
+    @par
+        Chunks are never returned to the system while the allocator lives, not
+        even when all their blocks are free: freed blocks are only kept for reuse
+        in the same category and size class, so the reserved memory of a category
+        is its peak usage (see getReservedBytes). Everything is released when the
+        allocator is destroyed; an instance must outlive every block allocated
+        from it, the caches other threads still hold for it are discarded. The
+        default instance is never destroyed.
+    */
+    class _OgreExport PoolMemoryAllocator : public MemoryAllocator
+    {
+    public:
+        PoolMemoryAllocator();
+        ~PoolMemoryAllocator();
+
+        void* allocateBytes(size_t size, int category);
+        void deallocateBytes(void* ptr, size_t size, int category);
+
+        /// Number of bytes held in chunks for the given category, in use or not
+        size_t getReservedBytes(int category) const;
+
+        /// Largest block served from the pools
+        static const size_t MAX_POOLED_SIZE = 512;
+        /// Size class granularity
+        static const size_t SIZE_CLASS_STEP = 16;
+        static const size_t NUM_SIZE_CLASSES = MAX_POOLED_SIZE / SIZE_CLASS_STEP;
+        /// Size of the chunks the blocks are carved from
+        static const size_t CHUNK_SIZE = 64 * 1024;
+        /// Number of pool instances a thread keeps a block cache for
+        static const size_t MAX_THREAD_CACHES = 4;
+
+        struct Impl;
+    private:
+        Impl* mImpl;
+    };
+
+    /** Entry point for all memory allocated through the MEMCATEGORY policies.
+    @remarks
+        Every block carries a small header recording its size, category and the
+        allocator it came from, which is what makes it possible to free it
+        without restating the size, and to switch the allocator of a category
+        at any time: blocks allocated before the switch still go back to the
+        allocator they came from.
+    @par
+        Live bytes, live allocations, peak bytes and the total number of
+        allocations are counted per category. A category can also be given a
+        budget; it is a soft limit, allocations never fail because of it, but
+        subsystems can query isOverBudget() to decide to release memory.
+    */
+    class _OgreExport MemoryCategoryAllocator
+    {
+    public:
+        /// Allocate size bytes in the given category, throws std::bad_alloc on failure
+        static DECL_MALLOC void* allocateBytes(size_t size, int category);
+        /// Free memory allocated by allocateBytes (null is ignored)
+        static void deallocateBytes(void* ptr);
+        /** Resize a block, keeping its contents and category.
+        @remarks
+            Behaves like realloc: a null ptr allocates, a size of 0 frees.
+        */
+        static void* reallocateBytes(void* ptr, size_t size, int category);
+
+        /** Set the allocator used for new allocations in a category.
+        @param category The MemoryCategory
+        @param allocator The allocator, or null to go back to the default pool allocator.
+            Must outlive all blocks it allocates.
+        */
+        static void setAllocator(int category, MemoryAllocator* allocator);
+        /// Get the allocator used for new allocations in a category
+        static MemoryAllocator* getAllocator(int category);
+        /// The built-in pool allocator
+        static PoolMemoryAllocator* getDefaultAllocator();
+
+        /// Bytes currently allocated in a category (as requested, excluding overhead)
+        static size_t getAllocatedBytes(int category);
+        /// Number of blocks currently allocated in a category
+        static size_t getAllocationCount(int category);
+        /// Highest value getAllocatedBytes has reached for a category
+        static size_t getPeakAllocatedBytes(int category);
+        /// Number of allocations made in a category since startup
+        static size_t getTotalAllocationCount(int category);
+        /// Reset the peak of a category to its current value
+        static void resetPeakAllocatedBytes(int category);
+
+        /// Set the budget in bytes of a category, 0 for none
+        static void setBudget(int category, size_t bytes);
+        /// Get the budget in bytes of a category, 0 for none
+        static size_t getBudget(int category);
+        /// Whether a category has a budget and is using more than it
+        static bool isOverBudget(int category);
+
+        /// Human readable name of a category
+        static const char* getCategoryName(int category);
+    };
+
+    /** Allocation policy which routes allocations to MemoryCategoryAllocator.
+    @remarks
+        The category is fixed at compile time, so it can be used as a policy
+        class for AllocatedObject without any per-object overhead.
+    */
+    template <int Category>
+    class CategorisedAllocPolicy
+    {
+    public:
+        static inline void* allocateBytes(size_t count)
+        {
+            return MemoryCategoryAllocator::allocateBytes(count, Category);
+        }
+        static inline void deallocateBytes(void* ptr)
+        {
+            MemoryCategoryAllocator::deallocateBytes(ptr);
+        }
+        static inline void* reallocateBytes(void* ptr, size_t count)
+        {
+            return MemoryCategoryAllocator::reallocateBytes(ptr, count, Category);
+        }
+        /// Get the maximum size of a single allocation
+        static inline size_t getMaxAllocationSize()
+        {
+            return std::numeric_limits<size_t>::max() / 2;
+        }
+    };
+
+    /** @} */
+    /** @} */
+}
+
+#endif
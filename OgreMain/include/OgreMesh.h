@@ -88,6 +88,7 @@ namespace Ogre {
     {
         friend class SubMesh;
         friend class MeshSerializerImpl;
+        friend class MeshSerializerImpl_v1_10;
         friend class MeshSerializerImpl_v1_8;
         friend class MeshSerializerImpl_v1_4;
         friend class MeshSerializerImpl_v1_3;
@@ -142,19 +143,51 @@ namespace Ogre {
         SkeletonPtr mSkeleton;
 
        
-        VertexBoneAssignmentList mBoneAssignments;
+        /// Filled on demand from the blend buffer if mBoneAssignmentsPacked is set
+        mutable VertexBoneAssignmentList mBoneAssignments;
 
         /// Flag indicating that bone assignments need to be recompiled.
         bool mBoneAssignmentsOutOfDate;
+        /** Flag indicating that the bone assignments were loaded straight into the
+            blend buffer of the shared geometry and mBoneAssignments is not filled yet.
+        */
+        mutable bool mBoneAssignmentsPacked;
 
         /** Build the index map between bone index and blend index. */
-        void buildIndexMap(const VertexBoneAssignmentList& boneAssignments,
+        static void buildIndexMap(const VertexBoneAssignmentList& boneAssignments,
             IndexMap& boneIndexToBlendIndexMap, IndexMap& blendIndexToBoneIndexMap);
         /** Compile bone assignments into blend index and weight buffers. */
         void compileBoneAssignments(const VertexBoneAssignmentList& boneAssignments,
             unsigned short numBlendWeightsPerVertex, 
             IndexMap& blendIndexToBoneIndexMap,
             VertexData* targetVertexData);
+        /** Compile packed blend indices and weights into blend index and weight buffers.
+        @param blendIndices 4 blend indices per vertex.
+        @param blendWeights numBlendWeightsPerVertex weights per vertex, summing to 1.
+        @param numBlendWeightsPerVertex Number of weights per vertex, 1 to 4.
+        @param targetVertexData The vertex data to add the buffer to.
+        */
+        void compileBoneAssignments(const uint8* blendIndices, const float* blendWeights,
+            unsigned short numBlendWeightsPerVertex, VertexData* targetVertexData);
+        /** Pack bone assignments into per vertex blend indices and weights.
+        @remarks
+            Vertices without assignments get the full weight on blend index 0, the
+            weights of each vertex are normalised.
+        @param boneAssignments The assignments, at most numBlendWeightsPerVertex per vertex.
+        @param vertexCount Number of vertices.
+        @param numBlendWeightsPerVertex Number of weights per vertex, 1 to 4.
+        @param boneIndexToBlendIndexMap As built by buildIndexMap.
+        @param blendIndices Receives 4 blend indices per vertex.
+        @param blendWeights Receives numBlendWeightsPerVertex weights per vertex.
+        */
+        static void packBoneAssignments(const VertexBoneAssignmentList& boneAssignments,
+            size_t vertexCount, unsigned short numBlendWeightsPerVertex,
+            const IndexMap& boneIndexToBlendIndexMap, uint8* blendIndices, float* blendWeights);
+        /** Read the blend index and weight buffer of sourceVertexData back into bone
+            assignments, skipping zero weights.
+        */
+        static void decompileBoneAssignments(const VertexData* sourceVertexData,
+            const IndexMap& blendIndexToBoneIndexMap, vector<VertexBoneAssignment>::type& boneAssignments);
 #if !OGRE_NO_MESHLOD
         const LodStrategy *mLodStrategy;
         bool mHasManualLodLevel;
@@ -479,7 +512,25 @@ namespace Ogre {
 
         /** Gets a const reference to the list of bone assignments
         */
-        const VertexBoneAssignmentList& getBoneAssignments() const { return mBoneAssignments; }
+        const VertexBoneAssignmentList& getBoneAssignments() const
+        {
+            _unpackBoneAssignments();
+            return mBoneAssignments;
+        }
+
+        /** Internal method, fills the bone assignment list of meshes whose bone
+            assignments were loaded in packed form.
+        @remarks
+            Meshes saved with MESH_VERSION_1_11 or later store the bone assignments as
+            per vertex blend indices and weights which are loaded straight into the
+            blend buffers, without filling the bone assignment lists. The lists are only
+            rebuilt from the blend buffers when they are accessed or edited, with the
+            weights at the precision of the blend buffer.
+        @par
+            This method is for the shared geometry of the Mesh, see the equivalent method
+            on SubMesh.
+        */
+        void _unpackBoneAssignments(void) const;
 
         /** Returns the number of levels of detail that this mesh supports. 
         @remarks
@@ -83,6 +83,14 @@ namespace Ogre {
                 M_SUBMESH_TEXTURE_ALIAS = 0x4200, // Repeating section
                     // char* aliasName;
                     // char* textureName;
+                M_SUBMESH_PACKED_BONE_ASSIGNMENTS = 0x4300,
+                    // Optional bone weights of all vertices, replaces M_SUBMESH_BONE_ASSIGNMENT
+                    // unsigned int vertexCount;
+                    // unsigned short numBlendWeights; (per vertex, 1 to 4)
+                    // unsigned short numBlendIndices;
+                    // unsigned short* blendIndexToBoneIndex (x numBlendIndices)
+                    // unsigned char* blendIndices (4 x vertexCount)
+                    // float* blendWeights (numBlendWeights x vertexCount)
 
             M_GEOMETRY          = 0x5000, // NB this chunk is embedded within M_MESH and M_SUBMESH
                 // unsigned int vertexCount
@@ -106,6 +114,9 @@ namespace Ogre {
                 // unsigned int vertexIndex;
                 // unsigned short boneIndex;
                 // float weight;
+            M_MESH_PACKED_BONE_ASSIGNMENTS = 0x7100,
+                // Optional bone weights of all shared vertices, replaces M_MESH_BONE_ASSIGNMENT
+                // same layout as M_SUBMESH_PACKED_BONE_ASSIGNMENTS
             M_MESH_LOD_LEVEL = 0x8000,
                 // Optional LOD information
                 // string strategyName;
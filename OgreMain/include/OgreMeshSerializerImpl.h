@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include "OgreEdgeListBuilder.h"
 #include "OgreKeyFrame.h"
 #include "OgreVertexBoneAssignment.h"
+#include "OgreMesh.h"
 
 namespace Ogre {
     
@@ -94,6 +95,16 @@ namespace Ogre {
         virtual void writeSkeletonLink(const String& skelName);
         virtual void writeMeshBoneAssignment(const VertexBoneAssignment& assign);
         virtual void writeSubMeshBoneAssignment(const VertexBoneAssignment& assign);
+        virtual void writeMeshBoneAssignments(const Mesh* pMesh);
+        virtual void writeSubMeshBoneAssignments(const SubMesh* s);
+        /// Writes the assignments as one M_*_PACKED_BONE_ASSIGNMENTS chunk
+        void writePackedBoneAssignments(uint16 chunkID, const Mesh::VertexBoneAssignmentList& assignments,
+            size_t vertexCount, unsigned short numBlendWeights);
+        /** Returns the number of blend weights per vertex to pack the assignments with,
+            or 0 if they cannot be packed for the given vertex data.
+        */
+        unsigned short getPackedBlendWeightCount(const Mesh::VertexBoneAssignmentList& assignments,
+            const VertexData* vertexData);
 #if !OGRE_NO_MESHLOD
         virtual void writeLodLevel(const Mesh* pMesh);
         virtual void writeLodUsageManual(const MeshLodUsage& usage);
@@ -118,6 +129,10 @@ namespace Ogre {
         virtual size_t calcGeometrySize(const VertexData* pGeom);
         virtual size_t calcSkeletonLinkSize(const String& skelName);
         virtual size_t calcBoneAssignmentSize(void);
+        virtual size_t calcMeshBoneAssignmentsSize(const Mesh* pMesh);
+        virtual size_t calcSubMeshBoneAssignmentsSize(const SubMesh* pSub);
+        size_t calcPackedBoneAssignmentsSize(size_t numBlendIndices, size_t vertexCount,
+            unsigned short numBlendWeights);
         virtual size_t calcSubMeshOperationSize(const SubMesh* pSub);
         virtual size_t calcSubMeshNameTableSize(const Mesh* pMesh);
         virtual size_t calcLodLevelSize(const Mesh* pMesh);
@@ -151,11 +166,29 @@ namespace Ogre {
         virtual void readGeometryVertexDeclaration(DataStreamPtr& stream, Mesh* pMesh, VertexData* dest);
         virtual void readGeometryVertexElement(DataStreamPtr& stream, Mesh* pMesh, VertexData* dest);
         virtual void readGeometryVertexBuffer(DataStreamPtr& stream, Mesh* pMesh, VertexData* dest);
+        /** Reads the payload of a vertex or index buffer into buf.
+        @remarks
+            If the whole file is in memory (a MemoryDataStream, e.g. a prebuffered or
+            memory mapped file) the payload is only located and skipped here. It is copied
+            and endian flipped by flushBufferData once the whole mesh has been read.
+        @param elementSize Size of a vertex, or of an index or float for flat arrays
+        @param elems Vertex elements to flip the endianness of, NULL for flat arrays
+        */
+        void readBufferData(DataStreamPtr& stream, const SharedPtr<HardwareBuffer>& buf,
+            size_t elementSize, const VertexDeclaration::VertexElementList* elems);
+        /// Fills all buffers located by readBufferData, in parallel on the Root thread pool
+        void flushBufferData();
+        /// Flips the endianness of count vertices or flat array elements of a buffer payload
+        void flipBufferData(void* pData, size_t count, size_t elementSize,
+            const VertexDeclaration::VertexElementList& elems);
 
         virtual void readSkeletonLink(DataStreamPtr& stream, Mesh* pMesh, MeshSerializerListener *listener);
         virtual void readMeshBoneAssignment(DataStreamPtr& stream, Mesh* pMesh);
         virtual void readSubMeshBoneAssignment(DataStreamPtr& stream, Mesh* pMesh, 
             SubMesh* sub);
+        /// Reads the packed assignments straight into the blend buffer of dest
+        virtual void readPackedBoneAssignments(DataStreamPtr& stream, Mesh* pMesh,
+            VertexData* dest, Mesh::IndexMap& blendIndexToBoneIndexMap);
         virtual void readMeshLodLevel(DataStreamPtr& stream, Mesh* pMesh);
 #if !OGRE_NO_MESHLOD
         virtual void readMeshLodUsageManual(DataStreamPtr& stream, Mesh* pMesh, unsigned short lodNum, MeshLodUsage& usage);
@@ -187,13 +220,41 @@ namespace Ogre {
         virtual void enableValidation();
 
         ushort exportedLodCount; // Needed to limit exported Edge data, when exporting
+
+        /// A buffer payload located by readBufferData
+        struct PendingBufferData
+        {
+            SharedPtr<HardwareBuffer> buffer;
+            const uchar* source;
+            size_t elementSize;
+            VertexDeclaration::VertexElementList elems;
+        };
+        typedef vector<PendingBufferData>::type PendingBufferDataList;
+        PendingBufferDataList mPendingBufferData;
+        /// Start of the stream data while importing from a MemoryDataStream, NULL otherwise
+        const uchar* mStreamData;
     };
 
 
+    /** Class for providing backwards-compatibility for loading version 1.10 of the .mesh format. 
+     This mesh format was used from Ogre v1.10, it stores each bone assignment in its own chunk.
+     */
+    class _OgrePrivate MeshSerializerImpl_v1_10 : public MeshSerializerImpl
+    {
+    public:
+        MeshSerializerImpl_v1_10();
+        ~MeshSerializerImpl_v1_10();
+    protected:
+        virtual void writeMeshBoneAssignments(const Mesh* pMesh);
+        virtual void writeSubMeshBoneAssignments(const SubMesh* s);
+        virtual size_t calcMeshBoneAssignmentsSize(const Mesh* pMesh);
+        virtual size_t calcSubMeshBoneAssignmentsSize(const SubMesh* pSub);
+    };
+
     /** Class for providing backwards-compatibility for loading version 1.8 of the .mesh format. 
      This mesh format was used from Ogre v1.8.
      */
-    class _OgrePrivate MeshSerializerImpl_v1_8 : public MeshSerializerImpl
+    class _OgrePrivate MeshSerializerImpl_v1_8 : public MeshSerializerImpl_v1_10
     {
     public:
         MeshSerializerImpl_v1_8();
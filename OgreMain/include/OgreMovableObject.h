@@ -112,6 +112,10 @@ namespace Ogre {
         Node* mParentNode;
         /// MovableObject listener - only one allowed (no list) for size & performance reasons. */
         Listener* mListener;
+        /// Broad-phase index of the default scene queries this object is tracked by, if any
+        SceneQueryBroadPhase* mBroadPhase;
+        /// Handle of this object in mBroadPhase
+        uint32 mBroadPhaseProxy;
         bool mParentIsTagPoint : 1;
         /// Is this object visible?
         bool mVisible : 1;
@@ -182,6 +186,19 @@ namespace Ogre {
         /** Get the manager of this object, if any (internal use only) */
         SceneManager* _getManager(void) const { return mManager; }
 
+        /** Notify the object of its handle in the broad-phase index of the scene queries.
+        @note Internal method, called by SceneQueryBroadPhase.
+        */
+        void _notifyBroadPhaseProxy(SceneQueryBroadPhase* broadPhase, uint32 proxy)
+        {
+            mBroadPhase = broadPhase;
+            mBroadPhaseProxy = proxy;
+        }
+        /// Get the broad-phase index this object is tracked by, if any
+        SceneQueryBroadPhase* _getBroadPhase(void) const { return mBroadPhase; }
+        /// Get the handle of this object in the broad-phase index
+        uint32 _getBroadPhaseProxy(void) const { return mBroadPhaseProxy; }
+
         /** Notifies the movable object that hardware resources were lost
             @remarks
                 Called automatically by RenderSystem if hardware resources
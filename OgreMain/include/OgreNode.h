@@ -55,6 +55,7 @@ namespace Ogre {
     */
     class _OgreExport Node : public NodeAlloc
     {
+        friend class SceneGraphTransformCache;
     public:
         /** Enumeration denoting the spaces which a transform can be relative to.
         */
@@ -72,6 +72,18 @@ namespace Ogre {
         */
         static OptimisedUtil* getImplementation(void) { return msImplementation; }
 
+        /// An implementation of this class together with a short name of it, like "SSE"
+        typedef std::pair<String, OptimisedUtil*> NamedImplementation;
+        typedef vector<NamedImplementation>::type ImplementationList;
+
+        /** Gets all implementations of this class usable on the run-time environment.
+        @remarks
+            The general C++ implementation always comes first, followed by the SIMD
+            ones the CPU supports. This is meant for comparing the implementations
+            against each other, use getImplementation to get the best one.
+        */
+        static ImplementationList getAvailableImplementations(void);
+
         /** Performs software vertex skinning.
         @param srcPosPtr Pointer to source position buffer.
         @param destPosPtr Pointer to destination position buffer.
@@ -107,6 +119,26 @@ namespace Ogre {
             size_t numWeightsPerVertex,
             size_t numVertices) = 0;
 
+        /** Performs software vertex skinning, splitting large vertex ranges across threads.
+        @remarks
+            The vertices are blended by softwareVertexSkinning in consecutive ranges,
+            which are distributed over the worker threads of the given pool. Small
+            ranges, or a NULL pool, are blended on the calling thread in one go.
+            The parameters are the same as for softwareVertexSkinning.
+        @param pool The thread pool to use, may be NULL.
+        */
+        void softwareVertexSkinningParallel(
+            ThreadPool* pool,
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const Affine3* const* blendMatrices,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices);
+
         /** Performs a software vertex morph, of the kind used for
             morph animation although it can be used for other purposes. 
         @remarks
@@ -203,6 +235,72 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices) = 0;
+
+        /** Tests axis aligned boxes against a set of planes.
+        @remarks
+            A box is culled if it lies completely on the negative side of any of the
+            planes, using the same arithmetic as Plane::getSide(const Vector3&, const Vector3&).
+        @param planes The planes to test against.
+        @param numPlanes Number of planes.
+        @param centres Box centres in SoA form, i.e. pointers to the x, y and z arrays.
+            No alignment requirement.
+        @param halfSizes Box half sizes in SoA form. Infinite boxes can be passed as
+            infinite half sizes, null boxes must be rejected by the caller.
+        @param visibility Receives one bit per box, bit (i % 32) of visibility[i / 32]
+            is set if box i is not culled. Unused bits of the last word are cleared.
+        @param numBoxes Number of boxes to test.
+        */
+        virtual void cullAxisAlignedBoxes(
+            const Plane* planes, size_t numPlanes,
+            const float* const centres[3],
+            const float* const halfSizes[3],
+            uint32* visibility,
+            size_t numBoxes) = 0;
+
+        /** Tests spheres against a set of planes.
+        @remarks
+            A sphere is culled if its distance to any of the planes is less than
+            the negated radius, same as the Frustum sphere test.
+        @param planes The planes to test against.
+        @param numPlanes Number of planes.
+        @param centres Sphere centres in SoA form, i.e. pointers to the x, y and z arrays.
+            No alignment requirement.
+        @param radii Sphere radii.
+        @param visibility Receives one bit per sphere, see cullAxisAlignedBoxes.
+        @param numSpheres Number of spheres to test.
+        */
+        virtual void cullSpheres(
+            const Plane* planes, size_t numPlanes,
+            const float* const centres[3],
+            const float* radii,
+            uint32* visibility,
+            size_t numSpheres) = 0;
+
+        /** Expands billboards into the four corner vertices of textured quads.
+        @remarks
+            Each billboard produces 4 vertices in the order left-top, right-top,
+            left-bottom, right-bottom. A vertex is the corner position (3 floats,
+            centre plus corner offset), the packed colour (uint32) and the texture
+            coordinates (2 floats), which is the layout used by BillboardSet.
+        @param centres Billboard centres, 3 floats per billboard.
+        @param offsets Corner offsets relative to the centre, 12 floats (4 corners
+            by xyz) per billboard.
+        @param offsetStride Number of floats between the offsets of consecutive
+            billboards, 0 to use the same offsets for all billboards.
+        @param colours Packed colour per billboard.
+        @param texcoordRects Texture coordinate rectangles as left, top, right,
+            bottom, 4 floats per billboard.
+        @param dest Receives the vertices, 24 floats per billboard. No alignment
+            requirement.
+        @param numBillboards Number of billboards to expand.
+        */
+        virtual void expandBillboardQuads(
+            const float* centres,
+            const float* offsets, size_t offsetStride,
+            const uint32* colours,
+            const float* texcoordRects,
+            float* dest,
+            size_t numBillboards) = 0;
     };
 
     /** Returns raw offseted of the given pointer.
@@ -0,0 +1,123 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __ParallelSceneCuller_H__
+#define __ParallelSceneCuller_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Frustum culling of a SceneNode hierarchy on the Root ThreadPool.
+    @remarks
+        The hierarchy below the root is split into tasks, each covering either a
+        whole subtree or only the objects of a node whose children got tasks of their
+        own. The tasks are culled concurrently, every task recording the visible
+        objects of its part of the tree into its own shard. The shards are then merged
+        on the calling thread in depth-first order, which feeds the objects to
+        RenderQueue::processVisibleObject in exactly the order of
+        SceneNode::_findVisibleObjects, so render queue contents and
+        VisibleObjectsBoundsInfo are identical to the serial traversal.
+    @par
+        Only the node bounding box tests run concurrently. Queueing the objects is
+        left to the calling thread because MovableObject::_notifyCurrentCamera and
+        _updateRenderQueue perform LOD selection, fire listeners and may update
+        hardware buffers, none of which is thread safe.
+    */
+    class _OgreExport ParallelSceneCuller : public SceneMgtAlloc
+    {
+    public:
+        ParallelSceneCuller();
+
+        /** Find the objects visible to the camera, see SceneNode::_findVisibleObjects.
+        @param pool Pool to cull on, if NULL or single threaded the serial traversal is used
+        */
+        void findVisibleObjects(SceneNode* root, Camera* cam, RenderQueue* queue,
+                                VisibleObjectsBoundsInfo* visibleBounds, bool displayNodes,
+                                bool onlyShadowCasters, ThreadPool* pool);
+
+        /// Number of tasks the hierarchy was split into by the last parallel call
+        size_t getNumTasks(void) const { return mTasks.size(); }
+    private:
+        /** Visible object of a shard. A NULL object marks the end of the node's
+            subtree, where its debug renderables are queued. */
+        struct VisibleEntry
+        {
+            SceneNode* node;
+            MovableObject* object;
+        };
+        typedef vector<VisibleEntry>::type VisibleEntryList;
+
+        enum TaskType
+        {
+            /// Cull the whole subtree of the node
+            TT_SUBTREE,
+            /// Cull only the node itself, its children have tasks of their own
+            TT_NODE,
+            /// Marks the end of the subtree of a TT_NODE task
+            TT_NODE_END
+        };
+
+        struct Task
+        {
+            SceneNode* node;
+            /// Index of the TT_NODE task of the parent node, ~0 for the root
+            size_t parentTask;
+            TaskType type;
+            /// Whether the node passed the frustum test, only used by TT_NODE tasks
+            bool visible;
+            /// Whether all ancestors passed the frustum test, computed when merging
+            bool active;
+        };
+        typedef vector<Task>::type TaskList;
+
+        void buildTasks(SceneNode* node, size_t parentTask, size_t splitDepth);
+        void cullTask(Task& task, VisibleEntryList& shard) const;
+        void cullSubtree(SceneNode* node, VisibleEntryList& shard) const;
+        void addVisibleNode(SceneNode* node, VisibleEntryList& shard) const;
+
+        Camera* mCamera;
+        TaskList mTasks;
+        /// One shard per task, kept around to reuse the allocations
+        vector<VisibleEntryList>::type mShards;
+        /// Scratch lists used to pick the split depth
+        vector<SceneNode*>::type mFrontier, mNextFrontier;
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
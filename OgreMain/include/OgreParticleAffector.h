@@ -98,6 +98,14 @@ namespace Ogre {
                     (void)pParticle;
                 }
 
+        /** Method called on the main thread before each update of the system.
+        @remarks
+            Affectors which need resources, such as images, should acquire them here rather
+            than in _initParticle or _affectParticles, which may run on a worker thread
+            (see ParticleSystemManager::setParallelUpdate). By default does nothing.
+        */
+        virtual void _prepareUpdate(void) {}
+
         /** Method called to allow the affector to 'do it's stuff' on all active particles in the system.
         @remarks
             This is where the affector gets the chance to apply it's effects to the particles of a system.
@@ -110,6 +118,28 @@ namespace Ogre {
         */
         virtual void _affectParticles(ParticleSystem* pSystem, Real timeElapsed) = 0;
 
+        /** Method called to apply the affector to the particles of a system using SoA storage.
+        @remarks
+            Affectors whose effect is a simple per-particle computation can implement this to
+            process the contiguous arrays of the ParticleSoA directly. The default returns false,
+            in which case the system writes the arrays back to the Particle objects and calls
+            _affectParticles instead.
+        @param
+            pSystem Pointer to a ParticleSystem to affect.
+        @param
+            particles The active particles of the system.
+        @param
+            timeElapsed The number of seconds which have elapsed since the last call.
+        @return
+            True if the particles were affected, false if this affector does not support it.
+        @see ParticleSystem::setSoAStorage
+        */
+        virtual bool _affectParticlesSoA(ParticleSystem* pSystem, ParticleSoA& particles, Real timeElapsed)
+        {
+            (void)pSystem; (void)particles; (void)timeElapsed;
+            return false;
+        }
+
         /** Returns the name of the type of affector. 
         @remarks
             This property is useful for determining the type of affector procedurally so another
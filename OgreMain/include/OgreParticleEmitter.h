@@ -407,6 +407,14 @@ namespace Ogre {
         */
         virtual unsigned short _getEmissionCount(Real timeElapsed) = 0;
 
+        /** Method called on the main thread before each update of the system.
+        @remarks
+            Emitters which need resources should acquire them here rather than in
+            _getEmissionCount or _initParticle, which may run on a worker thread
+            (see ParticleSystemManager::setParallelUpdate). By default does nothing.
+        */
+        virtual void _prepareUpdate(void) {}
+
         /** Initialises a particle based on the emitter's approach and parameters.
         @remarks
             See the _getEmissionCount method for details of why there is a separation between
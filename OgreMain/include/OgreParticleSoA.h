@@ -0,0 +1,125 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __ParticleSoA_H__
+#define __ParticleSoA_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Effects
+    *  @{
+    */
+    /** Structure-of-arrays storage of the active particles of a ParticleSystem.
+    @remarks
+        Used by ParticleSystem::setSoAStorage. Each attribute of the particles is held
+        in its own contiguous array, so expiry, motion and affectors implementing
+        ParticleAffector::_affectParticlesSoA run as linear loops over plain floats
+        instead of chasing the pointers of the active particle list.
+    @par
+        The arrays hold the state of the particles across updates. The system writes
+        them to the Particle objects with store only when those are needed, and
+        rebuilds the arrays from the objects when they may have been changed. Expired
+        particles are removed by moving the last particle into their slot, hence the
+        order of the arrays does not follow the order of the active particle list.
+    */
+    class _OgreExport ParticleSoA : public FXAlloc
+    {
+    public:
+        typedef list<Particle*>::type::iterator ListEntry;
+
+        ParticleSoA();
+
+        /// Number of particles held
+        size_t size(void) const { return mParticles.size(); }
+
+        /// Number of particles of type Particle::Emitter held
+        size_t getNumEmitters(void) const { return mNumEmitters; }
+
+        /// Remove all particles, keeping the allocated storage
+        void clear(void);
+
+        /** Append a particle, copying its attributes.
+        @param p The particle
+        @param entry Position of the particle in the active particle list
+        */
+        void add(Particle* p, ListEntry entry);
+
+        /** Remove the particle at the given index by moving the last particle into its place.
+        */
+        void swapRemove(size_t index);
+
+        /// Copy the attributes of all particles from the Particle objects
+        void load(void);
+
+        /// Copy the attributes of all particles to the Particle objects
+        void store(void) const;
+
+        /// Particle object at the given index
+        Particle* getParticle(size_t index) const { return mParticles[index]; }
+
+        /// Position of the particle at the given index in the active particle list
+        ListEntry getListEntry(size_t index) const { return mListEntries[index]; }
+
+        // Note the intentional public access to the arrays, so affectors can
+        // process them directly
+        vector<Real>::type mPositionX, mPositionY, mPositionZ;
+        vector<Real>::type mDirectionX, mDirectionY, mDirectionZ;
+        vector<float>::type mColourR, mColourG, mColourB, mColourA;
+        vector<Real>::type mTimeToLive;
+        vector<Real>::type mTotalTimeToLive;
+        /// Rotation in radians
+        vector<Real>::type mRotation;
+        /// Rotation speed in radians/sec
+        vector<Real>::type mRotationSpeed;
+        vector<Real>::type mWidth, mHeight;
+        /// Non-zero where the particle has its own dimensions
+        vector<uint8>::type mOwnDimensions;
+        /// Non-zero where the particle is an emitted emitter
+        vector<uint8>::type mIsEmitter;
+
+    protected:
+        /// Load one particle from its Particle object
+        void loadParticle(size_t index);
+
+        vector<Particle*>::type mParticles;
+        vector<ListEntry>::type mListEntries;
+        size_t mNumEmitters;
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -64,6 +64,7 @@ namespace Ogre {
     */
     class _OgreExport ParticleSystem : public StringInterface, public MovableObject
     {
+        friend class ParticleSystemManager;
     public:
 
         /** Command object for quota (see ParamCommand).*/
@@ -143,6 +144,13 @@ namespace Ogre {
             String doGet(const void* target) const;
             void doSet(void* target, const String& val);
         };
+        /** Command object for SoA storage (see ParamCommand).*/
+        class CmdSoAStorage : public ParamCommand
+        {
+        public:
+            String doGet(const void* target) const;
+            void doSet(void* target, const String& val);
+        };
 
         /// Default constructor required for STL creation in manager
         ParticleSystem();
@@ -612,6 +620,44 @@ namespace Ogre {
         */
         bool getKeepParticlesInLocalSpace(void) const { return mLocalSpace; }
 
+        /** Sets whether the particles are stored as structure-of-arrays.
+        @remarks
+            When enabled, the attributes of the active particles are owned by the
+            contiguous arrays of a ParticleSoA, which persist from one _update to the
+            next. Emitted particles are added to the arrays and expired ones removed from
+            them, and expiry, motion and all affectors implementing
+            ParticleAffector::_affectParticlesSoA process the arrays directly. This pays
+            off for large systems with several affectors, particularly with a fixed
+            iteration interval.
+        @par
+            The Particle objects are only brought up to date when they are needed: when
+            the system is rendered or sorted, and when they are accessed through
+            getParticle or _getIterator. Changes made to them through the latter two are
+            picked up by the next _update. Affectors without SoA support still work, but
+            the arrays are synchronised with the Particle objects around them, which costs
+            some of the benefit. Renderers are notified of particle movement once per
+            update rather than once per iteration, and particles expire in a different
+            order. Disabled by default.
+        */
+        void setSoAStorage(bool enabled);
+
+        /** Gets whether the particles are updated through structure-of-arrays storage. */
+        bool getSoAStorage(void) const { return mSoAStorage; }
+
+        /** Sets the seed of the random number stream private to this system.
+        @remarks
+            While this system is updated with its own stream, the random numbers drawn by
+            its emitters and affectors through Math::UnitRandom come from that stream, so
+            the evolution of the system only depends on the seed and the elapsed times.
+            Systems use their own stream once this has been called, and always while
+            ParticleSystemManager::setParallelUpdate is enabled. The default seed is
+            derived from the name of the system.
+        */
+        void setRandomSeed(uint32 seed);
+
+        /** Gets the seed of the random number stream private to this system. */
+        uint32 getRandomSeed(void) const { return mRandomSeed; }
+
         /** Internal method for updating the bounds of the particle system.
         @remarks
             This is called automatically for a period of time after the system's
@@ -661,6 +707,7 @@ namespace Ogre {
         static CmdLocalSpace msLocalSpaceCmd;
         static CmdIterationInterval msIterationIntervalCmd;
         static CmdNonvisibleTimeout msNonvisibleTimeoutCmd;
+        static CmdSoAStorage msSoAStorageCmd;
 
 
         AxisAlignedBox mAABB;
@@ -703,6 +750,30 @@ namespace Ogre {
         bool mEmittedEmitterPoolInitialised;
         /// Used to control if the particle system should emit particles or not.
         bool mIsEmitting;
+        /// Update particles through structure-of-arrays storage?
+        bool mSoAStorage;
+        /// Storage of the active particles with SoA storage, created on demand
+        ParticleSoA* mParticleSoA;
+        /// Do the Particle objects lag behind mParticleSoA?
+        bool mParticleObjectsStale;
+        /// Must mParticleSoA be rebuilt from the Particle objects before the next update?
+        bool mParticleSoAStale;
+        /// Is an update of mParticleSoA in progress?
+        bool mUpdatingSoA;
+        /// Seed of the random number stream of this system
+        uint32 mRandomSeed;
+        /// Current state of the random number stream of this system
+        uint32 mRandomState;
+        /// Use the random number stream of this system even when updated serially?
+        bool mRandomSeedSet;
+        /// Is an update queued with the ParticleSystemManager?
+        bool mUpdateQueued;
+        /// Time elapsed for the queued update
+        Real mQueuedUpdateTime;
+        /// Emission requests per emitter, see _triggerEmitters
+        vector<unsigned>::type mEmissionRequested;
+        /// Emission requests per active emitted emitter, see _triggerEmitters
+        vector<unsigned>::type mEmittedEmissionRequested;
 
         typedef list<Particle*>::type ActiveParticleList;
         typedef list<Particle*>::type FreeParticleList;
@@ -818,6 +889,29 @@ namespace Ogre {
         /// Default nonvisible update timeout
         static Real msDefaultNonvisibleTimeout;
 
+        /** Checks whether the system is to be updated and prepares the update.
+        @remarks
+            Performs the parts of _update which are not safe to run concurrently with
+            other systems, such as configuring the renderer and calling _prepareUpdate
+            on the emitters and affectors.
+        @param timeElapsed The elapsed time, scaled by the speed factor on return
+        @return False if the system is not to be updated
+        */
+        bool prepareUpdate(Real& timeElapsed);
+
+        /** Updates the particles and calculates the bounds of a prepared system.
+        @remarks
+            Only modifies the state of this system, so it can run concurrently with the
+            update of other systems.
+        @return True if the parent node needs to be notified of new bounds
+        */
+        bool updateParticles(Real timeElapsed);
+
+        /** Calculates the bounds, see _updateBounds.
+        @return True if the parent node needs to be notified of new bounds
+        */
+        bool calculateBounds(void);
+
         /** Internal method used to expire dead particles. */
         void _expire(Real timeElapsed);
 
@@ -834,6 +928,27 @@ namespace Ogre {
         /** Applies the effects of affectors. */
         void _triggerAffectors(Real timeElapsed);
 
+        /** Performs one iteration of _update using the SoA storage. */
+        void _updateSoA(Real timeElapsed);
+
+        /** Expires dead particles from the SoA storage. */
+        void _expireSoA(Real timeElapsed);
+
+        /** Applies the effects of affectors to the SoA storage. */
+        void _triggerAffectorsSoA(Real timeElapsed);
+
+        /** Updates the particles in the SoA storage based on their momentum. */
+        void _applyMotionSoA(Real timeElapsed);
+
+        /** Brings the Particle objects up to date with the SoA storage.
+        @param modifiable Whether the caller may change the particles, so the SoA
+            storage needs to be rebuilt from them before the next update
+        */
+        void syncParticleObjects(bool modifiable);
+
+        /** Calculates the world bounds of the particles from the SoA storage. */
+        void calculateBoundsSoA(Vector3& min, Vector3& max) const;
+
         /** Sort the particles in the system **/
         void _sortParticles(Camera* cam);
 
@@ -99,6 +99,16 @@ namespace Ogre {
         // Factory instance
         ParticleSystemFactory* mFactory;
 
+        /// Update the particle systems concurrently?
+        bool mParallelUpdate;
+        typedef vector<ParticleSystem*>::type ParticleSystemList;
+        /// Systems queued by their time controllers, see _queueUpdate
+        ParticleSystemList mQueuedSystems;
+        /// Systems being updated by _updateQueuedSystems
+        ParticleSystemList mUpdatingSystems;
+        /// Whether the bounds of each updating system changed
+        vector<uint8>::type mBoundsChanged;
+
         /** Internal script parsing method. */
         void parseNewEmitter(const String& type, DataStreamPtr& chunk, ParticleSystem* sys);
         /** Internal script parsing method. */
@@ -343,6 +353,42 @@ namespace Ogre {
 
         /** Get an instance of ParticleSystemFactory (internal use). */
         ParticleSystemFactory* _getFactory(void) { return mFactory; }
+
+        /** Sets whether particle systems are updated concurrently on the Root ThreadPool.
+        @remarks
+            By default each ParticleSystem is updated by its frame time controller
+            while ControllerManager::updateAllControllers runs, one after the other.
+            When enabled, the controllers only queue the systems, and SceneManager::_renderScene
+            updates all of them right after the controllers, partitioned across the
+            threads of Root::getThreadPool. Renderer configuration and the notification
+            of the scene graph about new bounds remain on the calling thread, as do
+            all renderer buffer writes, which happen when the systems are queued for
+            rendering.
+        @par
+            While enabled, the emitters and affectors of each system draw their random
+            numbers from the system's own stream (see ParticleSystem::setRandomSeed), so
+            the results do not depend on how the systems are distributed over the
+            threads. Custom emitters and affectors must not modify state shared with
+            other systems. Disabled by default.
+        */
+        void setParallelUpdate(bool enabled);
+
+        /** Gets whether particle systems are updated concurrently on the Root ThreadPool. */
+        bool getParallelUpdate(void) const { return mParallelUpdate; }
+
+        /** Queue the update of a particle system for _updateQueuedSystems (internal use).
+        @param sys The system
+        @param timeElapsed Time added to the pending update of the system
+        */
+        void _queueUpdate(ParticleSystem* sys, Real timeElapsed);
+
+        /** Remove a particle system from the update queue (internal use). */
+        void _dequeueUpdate(ParticleSystem* sys);
+
+        /** Update the queued particle systems on the Root ThreadPool (internal use).
+        @see setParallelUpdate
+        */
+        void _updateQueuedSystems(void);
         
         /// @copydoc Singleton::getSingleton()
         static ParticleSystemManager& getSingleton(void);
@@ -72,6 +72,16 @@ namespace Ogre {
 #   define __OGRE_HAVE_SSE  1
 #endif
 
+/* Define whether or not Ogre compiled with AVX2 support. The AVX2 routines are
+   compiled per function, so the rest of Ogre does not need to be built with AVX
+   enabled, and they are only used if the CPU supports them at run-time.
+*/
+#if __OGRE_HAVE_SSE && OGRE_ARCH_TYPE == OGRE_ARCHITECTURE_64 && \
+    (OGRE_COMPILER_MIN_VERSION(OGRE_COMPILER_MSVC, 1700) || OGRE_COMPILER_MIN_VERSION(OGRE_COMPILER_GNUC, 490) || \
+     OGRE_COMPILER_MIN_VERSION(OGRE_COMPILER_CLANG, 380))
+#   define __OGRE_HAVE_AVX2  1
+#endif
+
 /* Define whether or not Ogre compiled with VFP support.
  */
 #if OGRE_DOUBLE_PRECISION == 0 && OGRE_CPU == OGRE_CPU_ARM && (OGRE_COMPILER == OGRE_COMPILER_GNUC || OGRE_COMPILER == OGRE_COMPILER_CLANG) && defined(__ARM_ARCH_6K__) && defined(__VFP_FP__)
@@ -94,6 +104,10 @@ namespace Ogre {
 #   define __OGRE_HAVE_SSE  0
 #endif
 
+#ifndef __OGRE_HAVE_AVX2
+#   define __OGRE_HAVE_AVX2  0
+#endif
+
 #ifndef __OGRE_HAVE_VFP
 #   define __OGRE_HAVE_VFP  0
 #endif
@@ -150,6 +164,9 @@ namespace Ogre {
             CPU_FEATURE_FPU             = 1 << 12,
             CPU_FEATURE_PRO             = 1 << 13,
             CPU_FEATURE_HTT             = 1 << 14,
+            CPU_FEATURE_AVX             = 1 << 18,
+            CPU_FEATURE_AVX2            = 1 << 19,
+            CPU_FEATURE_FMA             = 1 << 20,
 #elif OGRE_CPU == OGRE_CPU_ARM          
             CPU_FEATURE_VFP             = 1 << 15,
             CPU_FEATURE_NEON            = 1 << 16,
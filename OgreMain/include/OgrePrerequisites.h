@@ -76,6 +76,7 @@ namespace Ogre {
     class Angle;
     class AnimableValue;
     class Animation;
+    class AnimationPrePass;
     class AnimationState;
     class AnimationStateSet;
     class AnimationTrack;
@@ -89,9 +90,11 @@ namespace Ogre {
     class BillboardChain;
     class BillboardSet;
     class Bone;
+    class BonePoseBuffer;
     class Camera;
     class Codec;
     class ColourValue;
+    class CompressedTransformKeys;
     class ConfigDialog;
     template <typename T> class Controller;
     template <typename T> class ControllerFunction;
@@ -101,6 +104,7 @@ namespace Ogre {
     class DefaultWorkQueue;
     class Degree;
     class DepthBuffer;
+    class DynamicAABBTree;
     class DynLib;
     class DynLibManager;
     class EdgeData;
@@ -164,11 +168,13 @@ namespace Ogre {
     class NodeKeyFrame;
     class NumericAnimationTrack;
     class NumericKeyFrame;
+    class ParallelSceneCuller;
     class Particle;
     class ParticleAffector;
     class ParticleAffectorFactory;
     class ParticleEmitter;
     class ParticleEmitterFactory;
+    class ParticleSoA;
     class ParticleSystem;
     class ParticleSystemManager;
     class ParticleSystemRenderer;
@@ -215,8 +221,10 @@ namespace Ogre {
     class Root;
     class SceneManager;
     class SceneManagerEnumerator;
+    class SceneGraphTransformCache;
     class SceneNode;
     class SceneQuery;
+    class SceneQueryBroadPhase;
     class SceneQueryListener;
     class ScriptCompiler;
     class ScriptCompilerManager;
@@ -246,6 +254,7 @@ namespace Ogre {
     class TextureUnitState;
     class Texture;
     class TextureManager;
+    class ThreadPool;
     class TransformKeyFrame;
     class Timer;
     class UserObjectBindings;
@@ -366,6 +366,31 @@ namespace Ogre {
         /// Group name for world resources
         String mWorldGroupName;
 
+        /// Modification stamp of a file or directory of a resource location
+        struct LocationStamp
+        {
+            /// Path relative to the location, empty for the location itself
+            String path;
+            int64 modified;
+            int64 size;
+        };
+        typedef vector<LocationStamp>::type LocationStampList;
+        /// Contents of a resource location, valid while all its stamps match
+        struct LocationIndexCacheEntry
+        {
+            LocationStampList stamps;
+            StringVector files;
+        };
+        /// Cached location contents, keyed on location type, recursion and name
+        typedef map<String, LocationIndexCacheEntry>::type LocationIndexCache;
+        LocationIndexCache mLocationIndexCache;
+        bool mUseLocationIndexCache;
+        bool mLocationIndexCacheDirty;
+
+        /** Lists all files of a resource location, taking them from the location
+            index cache if the location did not change since it was cached. */
+        StringVectorPtr listLocationContents(Archive* arch, bool recursive);
+
         /** Parses all the available scripts found in the resource locations
         for the given group, for all ResourceManagers.
         @remarks
@@ -690,6 +715,34 @@ namespace Ogre {
         bool resourceLocationExists(const String& name, 
             const String& resGroup = DEFAULT_RESOURCE_GROUP_NAME) const;
 
+        /** Set whether the contents of resource locations are kept in the location index cache.
+        @remarks
+            addResourceLocation has to list every file of a location to index it, which
+            for large directory trees dominates start up. With the cache enabled, the
+            listing is stored together with the modification time and size of the location
+            (and, for recursive directories, of every subdirectory). A location whose stamps
+            still match takes its listing from the cache instead of enumerating the archive;
+            locations that changed are listed again and their cache entry replaced.
+        @par
+            Combine with loadResourceIndexCache before adding locations and
+            saveResourceIndexCache at shutdown to keep the index across sessions. Only
+            locations whose name is a path on disk (e.g. FileSystem and Zip) are cached.
+        */
+        void setUseResourceIndexCache(bool use);
+        /** Get whether the contents of resource locations are kept in the location index cache. */
+        bool getUseResourceIndexCache() const { return mUseLocationIndexCache; }
+        /** Returns true if the location index cache changed since it was loaded. */
+        bool isResourceIndexCacheDirty() const { return mLocationIndexCacheDirty; }
+        /** Saves the location index cache.
+        @param stream A writeable stream, e.g. a file created for the cache
+        */
+        void saveResourceIndexCache(const DataStreamPtr& stream) const;
+        /** Replaces the location index cache by one previously saved with saveResourceIndexCache.
+        @remarks
+            Invalid or outdated data is discarded, the locations are then listed as usual.
+        */
+        void loadResourceIndexCache(const DataStreamPtr& stream);
+
         /** Declares a resource to be a part of a resource group, allowing you 
             to load and unload it as part of the group.
         @remarks
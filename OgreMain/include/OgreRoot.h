@@ -141,6 +141,7 @@ namespace Ogre
         bool mIsInitialised;
 
         WorkQueue* mWorkQueue;
+        ThreadPool* mThreadPool;
 
         ///Tells whether blend indices information needs to be passed to the GPU
         bool mIsBlendIndicesGpuRedundant;
@@ -932,6 +933,12 @@ namespace Ogre
             at shutdown, so do not destroy it yourself.
         */
         void setWorkQueue(WorkQueue* queue);
+
+        /** Get the ThreadPool used to split per-frame work across worker threads.
+            Unlike the WorkQueue, jobs on this pool are processed synchronously;
+            see ThreadPool::parallelFor.
+        */
+        ThreadPool* getThreadPool() const { return mThreadPool; }
             
         /** Sets whether blend indices information needs to be passed to the GPU.
             When entities use software animation they remove blend information such as
@@ -0,0 +1,145 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __SceneGraphTransformCache_H__
+#define __SceneGraphTransformCache_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreVector3.h"
+#include "OgreQuaternion.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Flattened, depth-ordered copy of a SceneNode hierarchy used to update it level by level.
+    @remarks
+        The hierarchy below a root node is stored breadth-first, so all nodes of one depth
+        level are contiguous and the children of every node are adjacent. Each level only
+        depends on the level above it, which allows the nodes of a level to be updated
+        concurrently on the ThreadPool.
+    @par
+        The derived transforms are written to the nodes exactly as the recursive
+        Node::_update would (the same code computes them, so the results are
+        bit-identical), and are additionally mirrored into structure-of-arrays storage
+        indexed like getNode(), for consumers that want to stream over them.
+    @par
+        Node::Listener::nodeUpdated and MovableObject::_notifyMoved are called on the
+        calling thread after the transforms have been computed, in depth order.
+        The flattened hierarchy is rebuilt lazily after _notifyHierarchyChanged.
+    */
+    class _OgreExport SceneGraphTransformCache : public SceneMgtAlloc
+    {
+    public:
+        SceneGraphTransformCache();
+
+        /** Update derived transforms and world bounds of root and all nodes below it.
+        @param root The root of the hierarchy, usually SceneManager::getRootSceneNode
+        @param pool Pool used to split each level, may be NULL for serial processing
+        @param parallelBounds Whether SceneNode::_updateBounds may be called concurrently
+            for nodes of the same level
+        */
+        void update(SceneNode* root, ThreadPool* pool, bool parallelBounds);
+
+        /// Called when nodes are attached to or detached from the cached hierarchy
+        void _notifyHierarchyChanged() { mHierarchyDirty = true; }
+
+        /// Number of nodes in the flattened hierarchy
+        size_t getNumNodes() const { return mNodes.size(); }
+        /// Number of depth levels in the flattened hierarchy
+        size_t getNumLevels() const { return mLevelOffsets.empty() ? 0 : mLevelOffsets.size() - 1; }
+        /// Range of node indices [first, second) of the given depth level
+        std::pair<size_t, size_t> getLevelRange(size_t level) const
+        { return std::make_pair(mLevelOffsets[level], mLevelOffsets[level + 1]); }
+
+        /// Node at the given index, nodes are ordered by depth
+        SceneNode* getNode(size_t index) const { return mNodes[index]; }
+        /// Index of the parent of the given node, ~0 for the root
+        uint32 getParentIndex(size_t index) const { return mParents[index]; }
+
+        /// Derived position of the node at the given index as of the last update
+        Vector3 getDerivedPosition(size_t index) const
+        { return Vector3(mPositionX[index], mPositionY[index], mPositionZ[index]); }
+        /// Derived orientation of the node at the given index as of the last update
+        Quaternion getDerivedOrientation(size_t index) const
+        {
+            return Quaternion(mOrientationW[index], mOrientationX[index], mOrientationY[index],
+                              mOrientationZ[index]);
+        }
+        /// Derived scale of the node at the given index as of the last update
+        Vector3 getDerivedScale(size_t index) const
+        { return Vector3(mScaleX[index], mScaleY[index], mScaleZ[index]); }
+
+        /// Whether the derived transform of the node changed during the last update
+        bool hasMoved(size_t index) const { return (mState[index] & NS_MOVED) != 0; }
+    private:
+        enum NodeState
+        {
+            /// Node is visited by the update, i.e. recursive _update would be called on it
+            NS_VISITED = 0x1,
+            /// The parent requested a full update of this node
+            NS_PARENT_CHANGED = 0x2,
+            /// The derived transform was recomputed
+            NS_MOVED = 0x4
+        };
+
+        void rebuild(SceneNode* root);
+        void storeTransform(size_t index);
+        void updateNodes(size_t begin, size_t end);
+        void updateBounds(size_t begin, size_t end);
+
+        typedef vector<SceneNode*>::type NodeList;
+        typedef vector<uint32>::type IndexList;
+        typedef vector<Real>::type RealList;
+
+        NodeList mNodes;
+        IndexList mParents;
+        IndexList mFirstChild;
+        IndexList mNumChildren;
+        vector<size_t>::type mLevelOffsets;
+        vector<uint8>::type mState;
+
+        RealList mPositionX, mPositionY, mPositionZ;
+        RealList mOrientationW, mOrientationX, mOrientationY, mOrientationZ;
+        RealList mScaleX, mScaleY, mScaleZ;
+
+        SceneNode* mRoot;
+        bool mHierarchyDirty;
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
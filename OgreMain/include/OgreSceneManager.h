@@ -628,6 +628,28 @@ namespace Ogre {
         /// Flag indicating whether SceneNodes will be rendered as a set of 3 axes
         bool mDisplayNodes;
 
+        /// Flattened scene graph used by the parallel scene graph update, created on demand
+        SceneGraphTransformCache* mTransformCache;
+        /// Whether _updateSceneGraph updates the scene graph level by level on the ThreadPool
+        bool mParallelSceneGraphUpdate;
+        /** Whether the SceneNode subclass of this manager supports the parallel scene graph
+            update, i.e. does not rely on SceneNode::_update being called. */
+        bool mParallelSceneGraphUpdateSupported;
+        /// Whether SceneNode::_updateBounds may run concurrently for nodes of one depth level
+        bool mParallelNodeBoundsUpdate;
+        /// Culls the scene graph on the ThreadPool, created on demand
+        ParallelSceneCuller* mParallelCuller;
+        /// Whether _findVisibleObjects culls the scene graph on the ThreadPool
+        bool mParallelCulling;
+        /// Updates the skeletal animation of the visible entities on the ThreadPool, created on demand
+        AnimationPrePass* mAnimationPrePass;
+        /// Whether the animation of the visible entities is updated by mAnimationPrePass
+        bool mParallelAnimationUpdate;
+        /// Spatial index used by the default scene queries, created when one is first executed
+        SceneQueryBroadPhase* mSceneQueryBroadPhase;
+        /// Creates mSceneQueryBroadPhase, see _getSceneQueryBroadPhase
+        SceneQueryBroadPhase* createSceneQueryBroadPhase(void);
+
         /// Storage of animations, lookup by name
         AnimationList mAnimationsList;
         OGRE_MUTEX(mAnimationsListMutex);
@@ -2194,6 +2216,69 @@ namespace Ogre {
         /** Returns true if all scene nodes axis are to be displayed */
         bool getDisplaySceneNodes(void) const {return mDisplayNodes;}
 
+        /** Tells the SceneManager whether to update the scene graph in parallel.
+        @remarks
+            By default _updateSceneGraph recursively updates the nodes from the root on
+            the calling thread. If enabled, the scene graph is kept in a flattened, depth
+            ordered form (see SceneGraphTransformCache) and the nodes of each depth level
+            are updated concurrently on the Root ThreadPool. The resulting transforms are
+            identical to the recursive update.
+        @par
+            Node listeners and MovableObject::_notifyMoved are still called on the main
+            thread. This option is ignored by scene managers that do not support it,
+            e.g. because their nodes rely on SceneNode::_update being called.
+        */
+        void setParallelSceneGraphUpdate(bool enabled);
+        /** Returns true if the scene graph is updated in parallel */
+        bool getParallelSceneGraphUpdate(void) const { return mParallelSceneGraphUpdate; }
+
+        /** Get the flattened scene graph of the parallel scene graph update.
+        @return The cache or NULL if the parallel scene graph update was never enabled
+        */
+        SceneGraphTransformCache* _getTransformCache(void) const { return mTransformCache; }
+
+        /** Tells the SceneManager whether to frustum cull the scene graph in parallel.
+        @remarks
+            If enabled, _findVisibleObjects splits the scene graph into subtrees which are
+            culled concurrently on the Root ThreadPool (see ParallelSceneCuller). The
+            visible objects are queued on the calling thread in the same order as by the
+            serial traversal. Scene managers overriding _findVisibleObjects ignore this option.
+        */
+        void setParallelCulling(bool enabled);
+        /** Returns true if the scene graph is frustum culled in parallel */
+        bool getParallelCulling(void) const { return mParallelCulling; }
+
+        /** Tells the SceneManager whether to update the animation of visible entities in parallel.
+        @remarks
+            If enabled, the skeletal animation of the entities queued by _findVisibleObjects
+            is not updated while queueing but in a pass right after culling, which applies
+            the animation states, computes the bone matrices and performs software skinning
+            on the Root ThreadPool (see AnimationPrePass). The results are identical to the
+            serial update.
+        */
+        void setParallelAnimationUpdate(bool enabled);
+        /** Returns true if the animation of visible entities is updated in parallel */
+        bool getParallelAnimationUpdate(void) const { return mParallelAnimationUpdate; }
+
+        /** Get the pass updating the animation of the visible entities.
+        @return The pass or NULL if the parallel animation update is disabled
+        */
+        AnimationPrePass* _getAnimationPrePass(void) const
+        { return mParallelAnimationUpdate ? mAnimationPrePass : 0; }
+
+        /** Get the spatial index of the movable objects used by the default scene queries.
+        @remarks
+            The index is only maintained once it was requested, which the default scene
+            queries do when first executed, so scene managers with their own queries do not
+            pay for it.
+        @param create Whether to create the index if it does not exist yet
+        @return The index, or NULL if it does not exist and create is false
+        */
+        SceneQueryBroadPhase* _getSceneQueryBroadPhase(bool create = true)
+        {
+            return (mSceneQueryBroadPhase || !create) ? mSceneQueryBroadPhase : createSceneQueryBroadPhase();
+        }
+
         /** Creates an animation which can be used to animate scene nodes.
         @remarks
             An animation is a collection of 'tracks' which over time change the position / orientation
@@ -2433,6 +2518,10 @@ namespace Ogre {
         /** Internal method for notifying the manager that a SceneNode is autotracking. */
         void _notifyAutotrackingSceneNode(SceneNode* node, bool autoTrack);
 
+        /** Internal method for notifying the manager that a SceneNode was attached to or
+            detached from the scene graph. */
+        void _notifySceneGraphChanged(void);
+
         
         /** Creates an AxisAlignedBoxSceneQuery for this scene manager. 
         @remarks
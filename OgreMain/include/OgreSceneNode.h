@@ -86,6 +86,11 @@ namespace Ogre {
         */
         virtual void setInSceneGraph(bool inGraph);
 
+        /// _findVisibleObjects for a node already known to be visible
+        void findVisibleObjectsImpl(Camera* cam, RenderQueue* queue,
+            VisibleObjectsBoundsInfo* visibleBounds, bool includeChildren,
+            bool displayNodes, bool onlyShadowCasters);
+
         /// Auto tracking target
         SceneNode* mAutoTrackTarget;
         /// Pointer to a Wire Bounding Box for this Node
@@ -209,6 +214,20 @@ namespace Ogre {
             VisibleObjectsBoundsInfo* visibleBounds, 
             bool includeChildren = true, bool displayNodes = false, bool onlyShadowCasters = false);
 
+        /** Frustum tests a range of child nodes in bulk.
+        @remarks
+            Internal method, uses the batch version of Camera::isVisible on the world
+            bounding boxes of the children.
+        @param cam The active camera
+        @param begin Index of the first child to test
+        @param count Number of children to test, at most 32
+        @return Bit i is set if child begin + i is visible
+        */
+        uint32 _getVisibleChildren(Camera* cam, size_t begin, size_t count) const;
+
+        /// Nodes with at least this many children test them with _getVisibleChildren
+        static const size_t BULK_CULL_THRESHOLD = 4;
+
         /** Gets the axis-aligned bounding box of this node (and hence all subnodes).
         @remarks
             Recommended only if you are extending a SceneManager, because the bounding box returned
@@ -301,6 +320,13 @@ namespace Ogre {
         */
         void _addBoundingBoxToQueue(RenderQueue* queue);
 
+        /** Add the node axes and bounding box to the rendering queue, if enabled.
+        @remarks
+            Called by _findVisibleObjects after the visible children were processed.
+        @param displayNodes Whether the node is to be rendered as a set of 3 axes
+        */
+        void _addDebugRenderablesToQueue(RenderQueue* queue, bool displayNodes);
+
         /** This allows scene managers to determine if the node's bounding box
             should be added to the rendering queue.
         @remarks
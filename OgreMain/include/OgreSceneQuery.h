@@ -60,6 +60,13 @@ namespace Ogre {
         if deemed appropriate by the implementation; i.e. each concrete subclass may
         precalculate information (such as fixed scene partitions involved in the query)
         to speed up the repeated use of the query.
+    @par
+        Region and ray queries report their results in no particular order. The default
+        implementations of SceneManager report them in the order their spatial index
+        visits the objects, which changes as the scene changes; use
+        RaySceneQuery::setSortByDistance if ray results need an order. The default
+        IntersectionSceneQuery reports pairs ordered by movable type and then by name,
+        with the earlier object of each pair first.
     @par
         You should never try to create a SceneQuery object yourself, they should be created
         using the SceneManager interfaces for the type of query required, e.g.
@@ -0,0 +1,221 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __SceneQueryBroadPhase_H__
+#define __SceneQueryBroadPhase_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreDynamicAABBTree.h"
+#include "OgreMovableObject.h"
+#include "OgreAtomicScalar.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Broad-phase index of the movable objects of a SceneManager, used by the default
+        scene queries to avoid testing every object.
+    @remarks
+        Every object attached to a SceneNode has a proxy in a DynamicAABBTree, covering its
+        cached world bounding box and its bounding sphere around the parent node. Proxies are
+        refreshed from SceneNode::_updateBounds, so only nodes that were actually updated by
+        the scene graph update cost anything. While SceneManager::_updateSceneGraph runs the
+        updated nodes are only recorded (this may happen concurrently) and refreshed when the
+        update ends.
+    @par
+        Objects attached to bones, objects with infinite bounds and objects that were attached
+        since the last scene graph update are kept in a separate list which every traversal
+        visits unconditionally, so the index never hides an object the exact test would accept.
+        Objects not created by the owning SceneManager are not tracked, as the scene queries
+        never returned those.
+    @par
+        The pairs of tree proxies whose stored boxes overlap are kept once they have been
+        asked for, and afterwards only the pairs of proxies which were moved, added or
+        removed are recomputed.
+    @par
+        The index reflects the scene as of the last scene graph update, as do the cached
+        world bounding boxes the queries test against.
+    */
+    class _OgreExport SceneQueryBroadPhase : public SceneMgtAlloc
+    {
+    public:
+        SceneQueryBroadPhase(SceneManager* owner);
+        ~SceneQueryBroadPhase();
+
+        /// Bring the index up to date, must be called before traversing it
+        void update();
+
+        /** Visit all tracked objects that may pass a test.
+        @remarks
+            The visitor must provide <tt>bool overlaps(const Vector3& min, const Vector3& max)</tt>
+            and <tt>bool visit(MovableObject* obj)</tt>, see DynamicAABBTree::traverse. The
+            visited objects still need to be tested exactly, in no particular order.
+        @return false if the visitor stopped the traversal
+        */
+        template <class Visitor> bool traverse(Visitor& visitor) const
+        {
+            for (ObjectList::const_iterator i = mUnbounded.begin(); i != mUnbounded.end(); ++i)
+            {
+                if (!visitor.visit(*i))
+                    return false;
+            }
+            TreeVisitor<Visitor> treeVisitor = {visitor};
+            return mTree.traverse(treeVisitor);
+        }
+
+        /** Visit all pairs of tracked objects that may overlap.
+        @remarks
+            The visitor must provide <tt>bool visit(MovableObject* a, MovableObject* b)</tt>,
+            which may return false to stop the traversal. Each pair is visited once, in no
+            particular order, and still needs to be tested exactly. Pairs of objects in the
+            tree come from the kept pairs, the objects visited by every traversal are paired
+            with every object their world bounding box overlaps.
+        @return false if the visitor stopped the traversal
+        */
+        template <class Visitor> bool traversePairs(Visitor& visitor)
+        {
+            updatePairs();
+            for (ProxyPairList::const_iterator i = mPairs.begin(); i != mPairs.end(); ++i)
+            {
+                if (!visitor.visit(i->objectA, i->objectB))
+                    return false;
+            }
+
+            for (size_t i = 0; i < mUnbounded.size(); ++i)
+            {
+                MovableObject* a = mUnbounded[i];
+                const AxisAlignedBox& box = a->getWorldBoundingBox();
+                if (box.isNull())
+                    continue;
+                for (size_t j = i + 1; j < mUnbounded.size(); ++j)
+                {
+                    if (!visitor.visit(a, mUnbounded[j]))
+                        return false;
+                }
+                PairVisitor<Visitor> pairVisitor = {visitor, a, box};
+                if (!mTree.traverse(pairVisitor))
+                    return false;
+            }
+            return true;
+        }
+
+        /// Number of objects with a proxy in the tree
+        size_t getNumBoundedObjects() const { return mTree.getNumProxies(); }
+        /// Number of objects visited by every traversal
+        size_t getNumUnboundedObjects() const { return mUnbounded.size(); }
+
+        /// Request a rebuild of the whole index on the next update
+        void _notifyRebuildRequired() { mRebuildRequired = true; }
+        /** Called by SceneManager before updating the scene graph.
+        @param maxUpdatedNodes Upper bound of the nodes the update will touch
+        */
+        void _beginSceneGraphUpdate(size_t maxUpdatedNodes);
+        /// Called by SceneManager after updating the scene graph
+        void _endSceneGraphUpdate();
+        /** Called when the world bounds of a node were updated.
+        @note May be called concurrently for different nodes during a scene graph update
+        */
+        void _notifyNodeUpdated(SceneNode* node);
+        /// Called by MovableObject when attached to a node or bone
+        void _notifyObjectAttached(MovableObject* obj);
+        /// Called by MovableObject when detached from its node or bone
+        void _notifyObjectDetached(MovableObject* obj);
+
+    private:
+        typedef vector<MovableObject*>::type ObjectList;
+        typedef vector<SceneNode*>::type SceneNodeList;
+        typedef vector<uint32>::type ProxyList;
+
+        /// Tree proxies whose stored boxes overlap
+        struct ProxyPair
+        {
+            uint32 proxyA;
+            uint32 proxyB;
+            MovableObject* objectA;
+            MovableObject* objectB;
+        };
+        typedef vector<ProxyPair>::type ProxyPairList;
+
+        /// Proxy handles with this bit set index into mUnbounded
+        static const uint32 UNBOUNDED_PROXY = 0x80000000;
+
+        template <class Visitor> struct TreeVisitor
+        {
+            Visitor& visitor;
+            bool overlaps(const Vector3& min, const Vector3& max) const { return visitor.overlaps(min, max); }
+            bool visit(void* userData) const { return visitor.visit(static_cast<MovableObject*>(userData)); }
+        };
+
+        /// Pairs an object visited by every traversal with the objects in the tree
+        template <class Visitor> struct PairVisitor
+        {
+            Visitor& visitor;
+            MovableObject* object;
+            const AxisAlignedBox& box;
+            bool overlaps(const Vector3& min, const Vector3& max) const { return box.intersects(AxisAlignedBox(min, max)); }
+            bool visit(void* userData) const { return visitor.visit(object, static_cast<MovableObject*>(userData)); }
+        };
+
+        bool isTracked(MovableObject* obj) const;
+        void refreshNode(SceneNode* node);
+        void refreshObject(MovableObject* obj);
+        void addUnbounded(MovableObject* obj);
+        void removeObject(MovableObject* obj);
+        void rebuild();
+        /// Note that the pairs of a proxy need to be recomputed
+        void invalidatePairs(uint32 proxy);
+        /// Recompute the pairs of the proxies noted by invalidatePairs
+        void updatePairs();
+
+        SceneManager* mOwner;
+        DynamicAABBTree mTree;
+        ObjectList mUnbounded;
+        bool mRebuildRequired;
+
+        ProxyPairList mPairs;
+        /// Proxies whose pairs need to be recomputed
+        ProxyList mInvalidProxies;
+        /// Whether mPairs is kept up to date, only once pairs have been asked for
+        bool mPairsValid;
+
+        bool mInSceneGraphUpdate;
+        SceneNodeList mUpdatedNodes;
+        AtomicScalar<size_t> mNumUpdatedNodes;
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
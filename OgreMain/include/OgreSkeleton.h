@@ -297,9 +297,29 @@ namespace Ogre {
         /** Sets the animation blending mode this skeleton will use. */
         virtual void setBlendMode(SkeletonAnimationBlendMode state);
 
-        /// Updates all the derived transforms in the skeleton
+        /** Sets whether setAnimationState blends the animations in a single pass.
+        @remarks
+            When enabled, all the enabled animation states are sampled into a temporary
+            pose, with their blend masks applied, and every bone is written once at the
+            end, instead of each animation being applied to the bones in turn. The
+            resulting bone transforms are identical. Disabled by default; skeleton
+            instances take the setting of their master skeleton when loaded.
+        */
+        void setBatchedBlending(bool batched) { mBatchedBlending = batched; }
+        /** Gets whether setAnimationState blends the animations in a single pass. */
+        bool getBatchedBlending(void) const { return mBatchedBlending; }
+
+        /** Updates all the derived transforms in the skeleton.
+        @remarks
+            The hierarchy is updated by a linear loop over a BonePoseBuffer, unless
+            bones have listeners or TagPoints attached, in which case the bones
+            are updated recursively through Node::_update.
+        */
         virtual void _updateTransforms(void);
 
+        /// Internal accessor for the flattened pose, NULL until _updateTransforms was called
+        BonePoseBuffer* _getPoseBuffer(void) const { return mPoseBuffer; }
+
         /** Optimise all of this skeleton's animations.
         @see Animation::optimise
         @param
@@ -435,6 +455,25 @@ namespace Ogre {
         BoneSet mManualBones;
         /// Manual bones dirty?
         bool mManualBonesDirty;
+        /// Flattened pose used by _updateTransforms, created on demand
+        BonePoseBuffer* mPoseBuffer;
+        /// Whether setAnimationState uses blendAnimationStates
+        bool mBatchedBlending;
+
+        /// Local transforms accumulated by blendAnimationStates, indexed by bone handle
+        struct BlendPose
+        {
+            vector<Vector3>::type positions;
+            vector<Quaternion>::type orientations;
+            vector<Vector3>::type scales;
+            vector<uint8>::type modified;
+        };
+        BlendPose mBlendPose;
+
+        /** Single pass implementation of setAnimationState, see setBatchedBlending.
+        @param weightFactor Factor applied to the weights of all the animations
+        */
+        void blendAnimationStates(const AnimationStateSet& animSet, Real weightFactor);
 
 
         /// Storage of animations, lookup by name
@@ -101,6 +101,17 @@ namespace Ogre {
                     // Quaternion rotate            : Rotation to apply at this keyframe
                     // Vector3 translate            : Translation to apply at this keyframe
                     // Vector3 scale                : Scale to apply at this keyframe
+
+                SKELETON_ANIMATION_TRACK_COMPRESSED_KEYS = 0x4120,
+                // [Optional, v1.11+] all the keys of the track in compressed form, replaces
+                // the keyframe chunks (see CompressedTransformKeys)
+
+                    // unsigned short numKeys           : Number of keys
+                    // unsigned short constantChannels  : CompressedTransformKeys::ConstantChannel flags
+                    // float times[numKeys]             : The time positions (seconds)
+                    // float translate[3 * n]           : Translations, n is 1 if constant else numKeys
+                    // unsigned short rotate[3 * n]     : Packed rotations, n is 1 if constant else numKeys
+                    // float scale[3 * n]               : Scales, n is 1 if constant else numKeys
         SKELETON_ANIMATION_LINK         = 0x5000
         // Link to another skeleton, to re-use its animations
 
@@ -95,6 +95,9 @@ namespace Ogre {
         /** Frees a TagPoint that already attached to a bone */
         void freeTagPoint(TagPoint* tagPoint);
 
+        /// Internal method, returns whether any TagPoint is attached to a bone
+        bool _hasActiveTagPoints(void) const { return !mActiveTagPoints.empty(); }
+
         /// @copydoc Skeleton::addLinkedSkeletonAnimationSource
         void addLinkedSkeletonAnimationSource(const String& skelName, 
             Real scale = 1.0f);
@@ -184,7 +184,17 @@ namespace Ogre {
 
         /** Gets a const reference to the list of bone assignments
         */
-        const VertexBoneAssignmentList& getBoneAssignments() { return mBoneAssignments; }
+        const VertexBoneAssignmentList& getBoneAssignments() const
+        {
+            _unpackBoneAssignments();
+            return mBoneAssignments;
+        }
+
+        /** Internal method, fills the bone assignment list if the bone assignments
+            were loaded in packed form.
+        @see Mesh::_unpackBoneAssignments
+        */
+        void _unpackBoneAssignments(void) const;
 
 
         /** Must be called once to compile bone assignments into geometry buffer. */
@@ -272,11 +282,15 @@ namespace Ogre {
         /// paired list of texture aliases and texture names
         AliasTextureNamePairList mTextureAliases;
 
-        VertexBoneAssignmentList mBoneAssignments;
+        /// Filled on demand from the blend buffer if mBoneAssignmentsPacked is set
+        mutable VertexBoneAssignmentList mBoneAssignments;
 
         /// Flag indicating that bone assignments need to be recompiled
         bool mBoneAssignmentsOutOfDate;
 
+        /// Flag indicating that the bone assignments were loaded straight into the blend buffer
+        mutable bool mBoneAssignmentsPacked;
+
         /// Type of vertex animation for dedicated vertex data (populated by Mesh)
         mutable VertexAnimationType mVertexAnimationType;
 
@@ -0,0 +1,144 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __OgreThreadPool_H__
+#define __OgreThreadPool_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreAtomicScalar.h"
+#include "Threading/OgreThreadHeaders.h"
+#include <functional>
+#include <exception>
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+
+    /** Small pool of worker threads for splitting per-frame work into parallel chunks.
+    @remarks
+        Unlike the WorkQueue, which processes asynchronous requests whose responses
+        are delivered later on the main thread, this pool executes a single
+        data-parallel job synchronously: parallelFor() returns once every chunk of the
+        given range has been processed. The calling thread takes part in the work, so
+        a pool with N worker threads processes a job on N + 1 threads.
+    @par
+        Only one job can be in flight at a time. If parallelFor() is called while
+        another job is running (e.g. from inside a job, or concurrently from a
+        WorkQueue worker), the range is processed serially on the calling thread
+        instead of blocking. When Ogre is built without thread support all work
+        is executed serially on the calling thread.
+    */
+    class _OgreExport ThreadPool : public UtilityAlloc
+    {
+    public:
+        /** Function processing the half-open range [begin, end).
+        @param threadIdx Index of the executing thread in [0, getNumThreads()); 0 is the
+            calling thread. Useful to select per-thread scratch storage.
+        */
+        typedef std::function<void(size_t begin, size_t end, size_t threadIdx)> RangeFunction;
+
+        /** Constructor.
+        @param numWorkerThreads Number of threads to spawn in addition to the calling thread.
+            Threads are only started on the first parallelFor() call.
+        */
+        ThreadPool(size_t numWorkerThreads);
+        ~ThreadPool();
+
+        /** Process the range [begin, end) in chunks of at most grainSize elements.
+        @remarks
+            Chunks are handed out dynamically, so no assumptions should be made about
+            which thread processes which chunk. Functions must only write to data owned
+            by the chunk (or to per-thread storage selected by threadIdx).
+            An exception thrown by the function is rethrown on the calling thread
+            once all chunks have finished.
+        */
+        void parallelFor(size_t begin, size_t end, size_t grainSize, const RangeFunction& func);
+
+        /** Number of threads that can take part in a job, including the calling thread.
+        */
+        size_t getNumThreads() const { return mNumWorkerThreads + 1; }
+
+        /** Change the number of worker threads.
+        @remarks
+            Must not be called while a job is in flight. Running workers are stopped
+            and new ones are started on the next parallelFor() call.
+        */
+        void setNumWorkerThreads(size_t numWorkerThreads);
+
+        /// Stop and join all worker threads
+        void shutdown();
+    private:
+        void runChunks(size_t threadIdx);
+        void startWorkers();
+        void _threadMain(size_t threadIdx);
+
+        size_t mNumWorkerThreads;
+        /// Set while a job is in flight, guards against nested or concurrent jobs
+        AtomicScalar<bool> mBusy;
+
+        // current job, only valid while mBusy is set
+        const RangeFunction* mFunction;
+        size_t mEnd;
+        size_t mGrainSize;
+        AtomicScalar<size_t> mNextChunk;
+        std::exception_ptr mException;
+
+#if OGRE_THREAD_SUPPORT
+        /// Thread function
+        struct WorkerFunc
+        {
+            ThreadPool* mPool;
+            size_t mThreadIdx;
+            WorkerFunc(ThreadPool* pool, size_t threadIdx) : mPool(pool), mThreadIdx(threadIdx) {}
+            void operator()() { mPool->_threadMain(mThreadIdx); }
+        };
+
+        typedef vector<OGRE_THREAD_TYPE*>::type WorkerThreadList;
+        WorkerThreadList mWorkers;
+
+        /// Guards the job generation, shutdown flag and active worker count
+        OGRE_WQ_MUTEX(mJobMutex);
+        OGRE_WQ_THREAD_SYNCHRONISER(mJobCondition);
+        OGRE_WQ_THREAD_SYNCHRONISER(mDoneCondition);
+        uint32 mJobGeneration;
+        size_t mActiveWorkers;
+        bool mShuttingDown;
+#endif
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
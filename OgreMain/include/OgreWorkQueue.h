@@ -97,10 +97,15 @@ namespace Ogre
             RequestID mID;
             /// Abort Flag
             mutable bool mAborted;
+            /// Priority, requests with a higher priority are processed first
+            Real mPriority;
+            /// Time (Root timer, in milliseconds) after which the request is dropped if not started, 0 = never
+            unsigned long mDeadline;
 
         public:
             /// Constructor 
-            Request(uint16 channel, uint16 rtype, const Any& rData, uint8 retry, RequestID rid);
+            Request(uint16 channel, uint16 rtype, const Any& rData, uint8 retry, RequestID rid,
+                Real priority = 0, unsigned long deadline = 0);
             ~Request();
             /// Set the abort flag
             void abortRequest() const { mAborted = true; }
@@ -116,6 +121,14 @@ namespace Ogre
             RequestID getID() const { return mID; }
             /// Get the abort flag
             bool getAborted() const { return mAborted; }
+            /// Get the priority of this request
+            Real getPriority() const { return mPriority; }
+            /// Internal method, use WorkQueue::setRequestPriority instead
+            void _setPriority(Real priority) { mPriority = priority; }
+            /// Get the time after which this request is dropped if not yet started (0 = never)
+            unsigned long getDeadline() const { return mDeadline; }
+            /// Whether the deadline of this request has passed at the given time
+            bool isExpired(unsigned long currentTimeMS) const { return mDeadline && currentTimeMS > mDeadline; }
         };
 
         /** General purpose response structure. 
@@ -268,10 +281,25 @@ namespace Ogre
             1. If a request handler can't process multiple requests in parallel.
             2. If you add lot of requests, but you want to keep the game fast.
             3. If you have lot of more important threads. (example: physics).
+        @param priority Requests with a higher priority are picked up by the workers first;
+            requests with the same priority are processed in the order they were added.
+            Streaming systems typically pass the negated distance to the camera.
+        @param deadlineMS If non-zero, the maximum time in milliseconds the request may
+            wait in the queue. A request which has not been started by then is aborted,
+            so like any aborted request it gets no response.
         @return The ID of the request that has been added
         */
         virtual RequestID addRequest(uint16 channel, uint16 requestType, const Any& rData, uint8 retryCount = 0, 
-            bool forceSynchronous = false, bool idleThread = false) = 0;
+            bool forceSynchronous = false, bool idleThread = false, Real priority = 0,
+            unsigned long deadlineMS = 0) = 0;
+
+        /** Change the priority of a request which is still waiting to be processed.
+        @remarks
+            Has no effect if the request has already been started or doesn't exist.
+        @param id The ID of the previously issued request.
+        @param priority The new priority, see addRequest
+        */
+        virtual void setRequestPriority(RequestID id, Real priority) = 0;
 
         /** Abort a previously issued request.
         If the request is still waiting to be processed, it will be 
@@ -442,7 +470,10 @@ namespace Ogre
 
         /// @copydoc WorkQueue::addRequest
         virtual RequestID addRequest(uint16 channel, uint16 requestType, const Any& rData, uint8 retryCount = 0, 
-            bool forceSynchronous = false, bool idleThread = false);
+            bool forceSynchronous = false, bool idleThread = false, Real priority = 0,
+            unsigned long deadlineMS = 0);
+        /// @copydoc WorkQueue::setRequestPriority
+        virtual void setRequestPriority(RequestID id, Real priority);
         /// @copydoc WorkQueue::abortRequest
         virtual void abortRequest(RequestID id);
         /// @copydoc WorkQueue::abortPendingRequest
@@ -476,7 +507,24 @@ namespace Ogre
 
         typedef deque<Request*>::type RequestQueue;
         typedef deque<Response*>::type ResponseQueue;
-        RequestQueue mRequestQueue; // Guarded by mRequestMutex
+        /// Heap ordering for the request queues: highest priority first, then lowest ID
+        struct RequestPriorityLess
+        {
+            bool operator()(const Request* a, const Request* b) const
+            {
+                if (a->getPriority() != b->getPriority())
+                    return a->getPriority() < b->getPriority();
+                return a->getID() > b->getID();
+            }
+        };
+        /// Push onto a request queue kept as a heap (see RequestPriorityLess)
+        static void pushRequest(RequestQueue& q, Request* r);
+        /// Pop the most urgent request of a heap ordered request queue
+        static Request* popRequest(RequestQueue& q);
+        /// Absolute deadline for a request added now with the given relative deadline
+        static unsigned long calculateDeadline(unsigned long deadlineMS);
+
+        RequestQueue mRequestQueue; // Guarded by mRequestMutex, heap ordered
         RequestQueue mProcessQueue; // Guarded by mProcessMutex
         ResponseQueue mResponseQueue; // Guarded by mResponseMutex
 
@@ -574,9 +622,10 @@ namespace Ogre
         /// Notify workers about a new request. 
         virtual void notifyWorkers() = 0;
         /// Put a Request on the queue with a specific RequestID.
-        void addRequestWithRID(RequestID rid, uint16 channel, uint16 requestType, const Any& rData, uint8 retryCount);
+        void addRequestWithRID(RequestID rid, uint16 channel, uint16 requestType, const Any& rData, uint8 retryCount,
+            Real priority, unsigned long deadline);
         
-        RequestQueue mIdleRequestQueue; // Guarded by mIdleMutex
+        RequestQueue mIdleRequestQueue; // Guarded by mIdleMutex, heap ordered
         bool mIdleThreadRunning; // Guarded by mIdleMutex
         Request* mIdleProcessed; // Guarded by mProcessMutex
         
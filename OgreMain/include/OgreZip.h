@@ -51,6 +51,14 @@ namespace Ogre {
 
         This archive format supports all archives compressed in the standard
         zip format, including iD pk3 files.
+    @par
+        The central directory is read once into hashed indices when the archive
+        is loaded. Every opened file reads the archive at its own offsets, so
+        Archive::open, find and exists may be called concurrently without
+        blocking each other. The archive file is memory mapped if possible;
+        stored entries are then returned as MemoryDataStream views on the
+        mapping without copying them, deflated ones are inflated on demand.
+        Encrypted entries are not supported.
     */
     class _OgreExport ZipArchiveFactory : public ArchiveFactory
     {
@@ -66,7 +74,11 @@ namespace Ogre {
         void destroyInstance( Archive* ptr) { OGRE_DELETE ptr; }
     };
 
-    /** Specialisation of ZipArchiveFactory for embedded Zip files. */
+    /** Specialisation of ZipArchiveFactory for embedded Zip files.
+    @remarks
+        Embedded archives are read in place like mapped ones, unless they have
+        a decryption function, in which case every read is decrypted.
+    */
     class _OgreExport EmbeddedZipArchiveFactory : public ZipArchiveFactory
     {
     public:
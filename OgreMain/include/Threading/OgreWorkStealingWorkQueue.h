@@ -0,0 +1,304 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __OgreWorkStealingWorkQueue_H__
+#define __OgreWorkStealingWorkQueue_H__
+
+#include "../OgreWorkQueue.h"
+#include "../OgreAtomicScalar.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+
+    /** Work queue that distributes requests over per-worker lock-free deques.
+    @remarks
+        DefaultWorkQueue funnels every request through a single mutex protected
+        queue, so producers and all workers contend on the same locks. This
+        implementation gives every worker thread its own deque (Chase-Lev) which
+        only the owner pushes to and pops from; idle workers steal from the other
+        end of their peers' deques. Requests added from outside the worker threads
+        go through a bounded lock-free injection ring, which workers drain in small
+        batches into their own deque. Requests added from inside a request handler
+        (and retries) stay on the worker that issued them.
+    @par
+        Priorities are bucketed into PRIORITY_LANES lanes, each with its own deques
+        and injection ring; the bucket width doubles with the distance from the
+        default priority. Workers always drain the highest non-empty lane first, but
+        within a lane requests are taken in queue order, so the priority order is
+        only approximate: it is exact between lanes and FIFO-like inside one.
+        setRequestPriority() is constant time: if the new priority maps to another
+        lane the request is queued there again and the stale entry in the old lane
+        is discarded when a worker reaches it.
+    @par
+        Every pending, running or answered request is tracked in a registry
+        sharded by RequestID, so abortRequest() and abortPendingRequest() are
+        constant time instead of scanning the queues.
+    @par
+        The public semantics are the same as DefaultWorkQueue: channels, handler
+        registration, retries, idle thread requests, abort methods and response
+        processing on the main thread behave identically. The only difference is
+        ordering; requests are not guaranteed to start in the order they were added.
+        Install it with Root::setWorkQueue before any component creates requests.
+    @note
+        Not available with the TBB thread provider, whose DefaultWorkQueue already
+        hands requests to the TBB work stealing task scheduler.
+    */
+    class _OgreExport WorkStealingWorkQueue : public DefaultWorkQueueBase
+    {
+    public:
+        WorkStealingWorkQueue(const String& name = BLANKSTRING);
+        virtual ~WorkStealingWorkQueue();
+
+        /// Main function for each thread spawned.
+        virtual void _threadMain();
+
+        /// @copydoc DefaultWorkQueueBase::_processNextRequest
+        virtual void _processNextRequest();
+
+        /// @copydoc WorkQueue::shutdown
+        virtual void shutdown();
+
+        /// @copydoc WorkQueue::startup
+        virtual void startup(bool forceRestart = true);
+
+        /// @copydoc WorkQueue::addRequest
+        virtual RequestID addRequest(uint16 channel, uint16 requestType, const Any& rData, uint8 retryCount = 0,
+            bool forceSynchronous = false, bool idleThread = false, Real priority = 0,
+            unsigned long deadlineMS = 0);
+        /// @copydoc WorkQueue::setRequestPriority
+        virtual void setRequestPriority(RequestID id, Real priority);
+        /// @copydoc WorkQueue::abortRequest
+        virtual void abortRequest(RequestID id);
+        /// @copydoc WorkQueue::abortPendingRequest
+        virtual bool abortPendingRequest(RequestID id);
+        /// @copydoc WorkQueue::abortRequestsByChannel
+        virtual void abortRequestsByChannel(uint16 channel);
+        /// @copydoc WorkQueue::abortPendingRequestsByChannel
+        virtual void abortPendingRequestsByChannel(uint16 channel);
+        /// @copydoc WorkQueue::abortAllRequests
+        virtual void abortAllRequests();
+        /// @copydoc WorkQueue::processResponses
+        virtual void processResponses();
+
+        /// Number of requests waiting to be picked up by a worker (approximate)
+        size_t getPendingRequestCount() const { return mPendingCount.load(); }
+        /// Number of requests a worker took from another worker's deque since startup
+        size_t getStolenRequestCount() const { return mStolenCount.load(); }
+
+        /// Capacity of the lock-free injection ring of the default priority lane; overflow goes to a locked list
+        static const size_t INJECTOR_CAPACITY = 4096;
+        /// Capacity of the injection rings of the other priority lanes
+        static const size_t PRIORITY_INJECTOR_CAPACITY = 256;
+        /// Number of priority lanes; priority 0 maps to the middle one
+        static const size_t PRIORITY_LANES = 32;
+        /// Lane used for a given priority
+        static size_t getLaneForPriority(Real priority);
+        /// Number of registry shards, must be a power of two
+        static const size_t REGISTRY_SHARDS = 16;
+    protected:
+        enum RequestState
+        {
+            /// Waiting in a lane or the idle queue
+            RS_QUEUED,
+            /// Aborted by abortPendingRequest before a worker picked it up
+            RS_ABORTED,
+            /// Taken by a worker (reset to RS_QUEUED when retried)
+            RS_PROCESSING,
+            /// setRequestPriority is changing its priority; claimRequest waits for it
+            RS_REPRIORITISING
+        };
+
+        /** Registry entry; this is what travels through the lanes.
+        @remarks
+            An entry can be queued more than once after setRequestPriority, so it is
+            reference counted: one reference for the registry and one for every
+            queued copy. The copy that wins claimRequest processes the request, the
+            others are dropped when taken.
+        */
+        struct InFlightRequest : public UtilityAlloc
+        {
+            /// Current request, replaced on retry (guarded by the registry shard)
+            Request* request;
+            /// Response waiting for processResponses (guarded by the registry shard)
+            Response* response;
+            AtomicScalar<uint8> state;
+            /// Lane of the current queued copy
+            AtomicScalar<uint8> lane;
+            AtomicScalar<uint32> refs;
+            /// Queued in the idle queue instead of a lane
+            bool idle;
+
+            InFlightRequest(Request* r, bool isIdle)
+                : request(r), response(0), state(RS_QUEUED), lane(0), refs(1), idle(isIdle) {}
+        };
+        struct InFlightPriorityLess
+        {
+            bool operator()(const InFlightRequest* a, const InFlightRequest* b) const
+            {
+                return RequestPriorityLess()(a->request, b->request);
+            }
+        };
+        typedef deque<InFlightRequest*>::type InFlightHeap;
+        static void pushHeap(InFlightHeap& q, InFlightRequest* e);
+        static InFlightRequest* popHeap(InFlightHeap& q);
+
+        /// Chase-Lev work-stealing deque; push / pop by the owner, steal by anyone
+        class WorkerDeque : public UtilityAlloc
+        {
+        public:
+            WorkerDeque();
+            ~WorkerDeque();
+
+            void push(InFlightRequest* e);
+            InFlightRequest* pop();
+            /** Take the oldest entry.
+            @return null if empty or if another thread won the race, see wasRaceLost
+            */
+            InFlightRequest* steal(bool& wasRaceLost);
+        private:
+            struct Buffer
+            {
+                int64 mask;
+                AtomicScalar<InFlightRequest*>* slots;
+            };
+            Buffer* grow(Buffer* old, int64 top, int64 bottom);
+
+            AtomicScalar<int64> mTop;
+            AtomicScalar<int64> mBottom;
+            AtomicScalar<Buffer*> mBuffer;
+            /// Buffers replaced by grow(); thieves may still read them so they live until destruction
+            vector<Buffer*>::type mRetired;
+        };
+
+        /// Bounded multi-producer / multi-consumer ring (Vyukov)
+        class InjectionRing : public UtilityAlloc
+        {
+        public:
+            InjectionRing(size_t capacity);
+            ~InjectionRing();
+
+            bool push(InFlightRequest* e);
+            InFlightRequest* pop();
+        private:
+            struct Cell
+            {
+                AtomicScalar<size_t> sequence;
+                InFlightRequest* data;
+            };
+            Cell* mCells;
+            size_t mMask;
+            AtomicScalar<size_t> mEnqueuePos;
+            AtomicScalar<size_t> mDequeuePos;
+        };
+
+        /// Queues of one priority bucket
+        struct PriorityLane : public UtilityAlloc
+        {
+            vector<WorkerDeque*>::type deques;
+            InjectionRing injector;
+            /// Used when the injector is full
+            deque<InFlightRequest*>::type overflow;
+            OGRE_WQ_MUTEX(overflowMutex);
+            AtomicScalar<size_t> overflowCount;
+            /// Entries queued in this lane, including stale copies
+            AtomicScalar<size_t> pending;
+
+            PriorityLane(size_t capacity) : injector(capacity), overflowCount(0), pending(0) {}
+            ~PriorityLane();
+        };
+
+        typedef OGRE_HashMap<RequestID, InFlightRequest*> InFlightMap;
+        struct RegistryShard
+        {
+            OGRE_WQ_MUTEX(mutex);
+            InFlightMap requests;
+        };
+
+        RegistryShard& getShard(RequestID id) { return mRegistry[id & (REGISTRY_SHARDS - 1)]; }
+        InFlightRequest* registerRequest(Request* r, bool idle);
+        /// Remove from the registry and release its reference (the request is not deleted)
+        void unregisterRequest(RequestID id);
+        /// Drop a reference, deleting the entry with the last one
+        static void releaseRequest(InFlightRequest* e);
+        /** Take ownership of a queued entry for processing.
+        @return false if another copy of the entry was taken already
+        */
+        static bool claimRequest(InFlightRequest* e, bool& wasAborted);
+
+        /// Queue an entry in the lane of its priority; workerIdx is the calling worker or ~0 for other threads
+        void pushRequest(InFlightRequest* e, size_t workerIdx);
+        /// Queue a copy of an entry in a lane
+        void pushToLane(InFlightRequest* e, size_t laneIdx, size_t workerIdx);
+        /// Take any entry from a lane, stale or not
+        InFlightRequest* takeFromLane(size_t laneIdx, size_t workerIdx);
+        /// Take and claim the highest priority entry
+        InFlightRequest* findRequest(size_t workerIdx, bool& wasAborted);
+        void processInFlightRequest(InFlightRequest* e, bool wasAborted, size_t workerIdx);
+        Response* dispatchRequest(const Request* r);
+        bool processIdleRequests(size_t workerIdx);
+        bool isIdleRequestAvailable();
+        void waitForNextRequest();
+        virtual void notifyWorkers();
+        /// Index of the calling thread if it is one of our workers, ~0 otherwise
+        size_t getCurrentWorkerIndex() const;
+
+        AtomicScalar<RequestID> mNextRequestID;
+        /// Entries queued in all lanes
+        AtomicScalar<size_t> mPendingCount;
+        AtomicScalar<size_t> mStolenCount;
+        AtomicScalar<size_t> mNextWorkerIndex;
+
+        PriorityLane* mLanes[PRIORITY_LANES];
+
+        /// Idle thread requests are serialised anyway, so they keep a locked heap (mIdleMutex)
+        InFlightHeap mIdleQueue;
+
+        RegistryShard mRegistry[REGISTRY_SHARDS];
+
+        size_t mNumThreadsRegisteredWithRS;
+        OGRE_WQ_MUTEX(mInitMutex);
+        OGRE_WQ_THREAD_SYNCHRONISER(mInitSync);
+
+        OGRE_WQ_MUTEX(mWakeMutex);
+        OGRE_WQ_THREAD_SYNCHRONISER(mWakeCondition);
+        AtomicScalar<size_t> mSleepingWorkers;
+#if OGRE_THREAD_SUPPORT
+        typedef vector<OGRE_THREAD_TYPE*>::type WorkerThreadList;
+        WorkerThreadList mWorkers;
+#endif
+    };
+    /** @} */
+    /** @} */
+}
+
+#endif
@@ -378,6 +378,35 @@ namespace Ogre {
       }
     }
     //---------------------------------------------------------------------
+    void Animation::_blendToPose(Real timePos, Real weight,
+        const AnimationState::BoneBlendMask* blendMask, Real scale, Vector3* positions,
+        Quaternion* orientations, Vector3* scales, uint8* modified)
+    {
+        _applyBaseKeyFrame();
+
+        // Calculate time index for fast keyframe search
+        TimeIndex timeIndex = _getTimeIndex(timePos);
+
+        Vector3 translate, scl;
+        Quaternion rotate;
+        NodeTrackList::iterator i;
+        for (i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
+        {
+            unsigned short handle = i->first;
+            // Masked weights are computed in single precision, as in apply
+            Real w = blendMask ? (*blendMask)[handle] * static_cast<float>(weight) : weight;
+            if (!i->second->_getWeightedTransform(timeIndex, w, scale, translate, rotate, scl))
+                continue;
+
+            // Same operations as Node::translate, Node::rotate and Node::scale
+            positions[handle] += translate;
+            orientations[handle] = orientations[handle] * rotate;
+            orientations[handle].normalise();
+            scales[handle] = scales[handle] * scl;
+            modified[handle] = 1;
+        }
+    }
+    //---------------------------------------------------------------------
     void Animation::apply(Entity* entity, Real timePos, Real weight, 
         bool software, bool hardware)
     {
@@ -520,6 +549,22 @@ namespace Ogre {
         
     }
     //-----------------------------------------------------------------------
+    void Animation::compressNodeTracks(const CompressedTransformKeys::Settings& settings)
+    {
+        for (NodeTrackList::iterator i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
+        {
+            i->second->compress(settings);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Animation::decompressNodeTracks(void)
+    {
+        for (NodeTrackList::iterator i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
+        {
+            i->second->decompress();
+        }
+    }
+    //-----------------------------------------------------------------------
     void Animation::_collectIdentityNodeTracks(TrackHandleList& tracks) const
     {
         NodeTrackList::const_iterator i, iend;
@@ -773,6 +818,25 @@ namespace Ogre {
         
     }
     //-----------------------------------------------------------------------
+    void Animation::_prepareForConcurrentApply(void)
+    {
+        _applyBaseKeyFrame();
+
+        if (mKeyFrameTimesDirty)
+        {
+            buildKeyFrameTimeList();
+        }
+
+        if (mInterpolationMode == IM_SPLINE)
+        {
+            NodeTrackList::iterator i;
+            for (i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
+            {
+                i->second->_buildInterpolationSplines();
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
     void Animation::_notifyContainer(AnimationContainer* c)
     {
         mContainer = c;
@@ -0,0 +1,306 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreAnimationPrePass.h"
+#include "OgreThreadPool.h"
+#include "OgreEntity.h"
+#include "OgreSkeletonInstance.h"
+#include "OgreAnimation.h"
+#include "OgreOptimisedUtil.h"
+
+namespace Ogre {
+    namespace {
+        /// Vertices per blend task, a multiple of 4 so the SIMD skinning keeps its alignment
+        const size_t BLEND_TASK_VERTICES = 256;
+
+        template <class T>
+        T* advancePointer(T* ptr, size_t bytes)
+        {
+            return ptr ? reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(ptr) + bytes) : 0;
+        }
+    }
+    //-----------------------------------------------------------------------
+    AnimationPrePass::AnimationPrePass()
+        : mCollecting(false)
+        , mNumEntities(0)
+    {
+    }
+    //-----------------------------------------------------------------------
+    void AnimationPrePass::begin(void)
+    {
+        mCollecting = true;
+    }
+    //-----------------------------------------------------------------------
+    void AnimationPrePass::_addEntity(Entity* entity)
+    {
+        // entities may be visible in several viewports of one render
+        if (!entity->mAnimationPrePassQueued)
+        {
+            entity->mAnimationPrePassQueued = true;
+            mEntities.push_back(entity);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void AnimationPrePass::end(ThreadPool* pool)
+    {
+        mCollecting = false;
+        mNumEntities = mEntities.size();
+        if (mEntities.empty())
+            return;
+
+        try
+        {
+            // Decide what to update in queueing order. Changes to the manual bones of a
+            // shared skeleton are seen by the first entity only, as _updateTransforms
+            // clears the flag when that one updates the bones.
+            typedef map<SkeletonInstance*, Entity*>::type SkeletonEntityMap;
+            SkeletonEntityMap skeletons;
+            vector<Entity::AnimationUpdate>::type updates(mEntities.size());
+            EntityList boneEntities;
+            for (size_t i = 0; i < mEntities.size(); ++i)
+            {
+                Entity* entity = mEntities[i];
+                SkeletonInstance* skeleton = entity->getSkeleton();
+                std::pair<SkeletonEntityMap::iterator, bool> inserted =
+                    skeletons.insert(SkeletonEntityMap::value_type(skeleton, (Entity*)0));
+                entity->evaluateAnimationUpdate(updates[i],
+                    inserted.second && skeleton->getManualBonesDirty());
+
+                // the bones are computed by the first entity applying its animation
+                if (updates[i].applyAnimation && !inserted.first->second)
+                {
+                    inserted.first->second = entity;
+                    boneEntities.push_back(entity);
+                }
+            }
+
+            // Build the lazily initialised animation data up front
+            for (size_t i = 0; i < boneEntities.size(); ++i)
+            {
+                Entity* entity = boneEntities[i];
+                const EnabledAnimationStateList& states =
+                    entity->getAllAnimationStates()->getEnabledAnimationStates();
+                EnabledAnimationStateList::const_iterator it;
+                for (it = states.begin(); it != states.end(); ++it)
+                {
+                    Animation* anim = entity->getSkeleton()->_getAnimationImpl((*it)->getAnimationName());
+                    if (anim)
+                        anim->_prepareForConcurrentApply();
+                }
+            }
+
+            // Apply the animation states and compute the bone matrices, one skeleton per task
+            if (pool)
+            {
+                pool->parallelFor(0, boneEntities.size(), 1, [&boneEntities](size_t begin, size_t end, size_t) {
+                    for (size_t i = begin; i < end; ++i)
+                        boneEntities[i]->cacheBoneMatrices();
+                });
+            }
+            else
+            {
+                for (size_t i = 0; i < boneEntities.size(); ++i)
+                    boneEntities[i]->cacheBoneMatrices();
+            }
+
+            // Bind the blend buffers and queue the software skinning, the bone matrices
+            // are up to date so cacheBoneMatrices does nothing here
+            for (size_t i = 0; i < mEntities.size(); ++i)
+            {
+                mEntities[i]->applyAnimationUpdate(updates[i], this);
+                mEntities[i]->mAnimationPrePassQueued = false;
+            }
+
+            // Blend in ranges of vertices, the last range of each job takes the remainder
+            // so no task is smaller than the serial SIMD unrolling threshold
+            for (size_t i = 0; i < mBlendJobs.size(); ++i)
+            {
+                size_t numVertices = mBlendJobs[i].numVertices;
+                size_t numTasks = std::max(numVertices / BLEND_TASK_VERTICES, size_t(1));
+                for (size_t t = 0; t < numTasks; ++t)
+                {
+                    BlendTask task;
+                    task.job = i;
+                    task.begin = t * BLEND_TASK_VERTICES;
+                    task.end = t + 1 == numTasks ? numVertices : task.begin + BLEND_TASK_VERTICES;
+                    mBlendTasks.push_back(task);
+                }
+            }
+
+            OptimisedUtil* util = OptimisedUtil::getImplementation();
+            ThreadPool::RangeFunction blend = [this, util](size_t begin, size_t end, size_t) {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const BlendTask& task = mBlendTasks[i];
+                    const BlendJob& job = mBlendJobs[task.job];
+                    util->softwareVertexSkinning(
+                        advancePointer(job.srcPos, task.begin * job.srcPosStride),
+                        advancePointer(job.destPos, task.begin * job.destPosStride),
+                        advancePointer(job.srcNorm, task.begin * job.srcNormStride),
+                        advancePointer(job.destNorm, task.begin * job.destNormStride),
+                        advancePointer(job.blendWeight, task.begin * job.blendWeightStride),
+                        advancePointer(job.blendIndex, task.begin * job.blendIndexStride),
+                        mBlendMatrices.data() + job.firstMatrix,
+                        job.srcPosStride, job.destPosStride,
+                        job.srcNormStride, job.destNormStride,
+                        job.blendWeightStride, job.blendIndexStride,
+                        job.numWeightsPerVertex,
+                        task.end - task.begin);
+                }
+            };
+            if (pool)
+                pool->parallelFor(0, mBlendTasks.size(), 1, blend);
+            else
+                blend(0, mBlendTasks.size(), 0);
+        }
+        catch (...)
+        {
+            reset();
+            throw;
+        }
+        reset();
+    }
+    //-----------------------------------------------------------------------
+    void AnimationPrePass::reset(void)
+    {
+        LockedBufferMap::iterator i;
+        for (i = mLockedBuffers.begin(); i != mLockedBuffers.end(); ++i)
+        {
+            i->second.buffer->unlock();
+        }
+        mLockedBuffers.clear();
+
+        for (size_t e = 0; e < mEntities.size(); ++e)
+        {
+            mEntities[e]->mAnimationPrePassQueued = false;
+        }
+        mEntities.clear();
+        mBlendJobs.clear();
+        mBlendTasks.clear();
+        mBlendMatrices.clear();
+    }
+    //-----------------------------------------------------------------------
+    void* AnimationPrePass::lockBuffer(const HardwareVertexBufferSharedPtr& buffer,
+        HardwareBuffer::LockOptions options)
+    {
+        LockedBufferMap::iterator i = mLockedBuffers.find(buffer.get());
+        if (i != mLockedBuffers.end())
+        {
+            // source buffers of a shared mesh, or positions and normals in one buffer
+            return i->second.data;
+        }
+
+        LockedBuffer& locked = mLockedBuffers[buffer.get()];
+        locked.buffer = buffer;
+        locked.data = buffer->lock(options);
+        return locked.data;
+    }
+    //-----------------------------------------------------------------------
+    void AnimationPrePass::_queueSoftwareVertexBlend(const VertexData* sourceVertexData,
+        const VertexData* targetVertexData,
+        const Affine3* const* blendMatrices, size_t numMatrices,
+        bool blendNormals)
+    {
+        // Same element and lock selection as Mesh::softwareVertexBlend
+        const VertexElement* srcElemPos =
+            sourceVertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        const VertexElement* srcElemNorm =
+            sourceVertexData->vertexDeclaration->findElementBySemantic(VES_NORMAL);
+        const VertexElement* srcElemBlendIndices =
+            sourceVertexData->vertexDeclaration->findElementBySemantic(VES_BLEND_INDICES);
+        const VertexElement* srcElemBlendWeights =
+            sourceVertexData->vertexDeclaration->findElementBySemantic(VES_BLEND_WEIGHTS);
+        OgreAssert(srcElemPos && srcElemBlendIndices && srcElemBlendWeights,
+            "You must supply at least positions, blend indices and blend weights");
+        const VertexElement* destElemPos =
+            targetVertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        const VertexElement* destElemNorm =
+            targetVertexData->vertexDeclaration->findElementBySemantic(VES_NORMAL);
+
+        bool includeNormals = blendNormals && (srcElemNorm != NULL) && (destElemNorm != NULL);
+
+        const VertexBufferBinding* srcBinding = sourceVertexData->vertexBufferBinding;
+        const VertexBufferBinding* destBinding = targetVertexData->vertexBufferBinding;
+        HardwareVertexBufferSharedPtr srcPosBuf = srcBinding->getBuffer(srcElemPos->getSource());
+        HardwareVertexBufferSharedPtr srcIdxBuf = srcBinding->getBuffer(srcElemBlendIndices->getSource());
+        HardwareVertexBufferSharedPtr srcWeightBuf = srcBinding->getBuffer(srcElemBlendWeights->getSource());
+        HardwareVertexBufferSharedPtr destPosBuf = destBinding->getBuffer(destElemPos->getSource());
+        HardwareVertexBufferSharedPtr srcNormBuf, destNormBuf;
+        if (includeNormals)
+        {
+            srcNormBuf = srcBinding->getBuffer(srcElemNorm->getSource());
+            destNormBuf = destBinding->getBuffer(destElemNorm->getSource());
+        }
+
+        // Indices must be 4 bytes
+        assert(srcElemBlendIndices->getType() == VET_UBYTE4 &&
+               "Blend indices must be VET_UBYTE4");
+
+        BlendJob job;
+        job.srcNorm = 0;
+        job.destNorm = 0;
+        job.srcNormStride = 0;
+        job.destNormStride = 0;
+        job.srcPosStride = srcPosBuf->getVertexSize();
+        job.destPosStride = destPosBuf->getVertexSize();
+        job.blendIndexStride = srcIdxBuf->getVertexSize();
+        job.blendWeightStride = srcWeightBuf->getVertexSize();
+        job.numWeightsPerVertex = VertexElement::getTypeCount(srcElemBlendWeights->getType());
+        job.numVertices = targetVertexData->vertexCount;
+
+        srcElemPos->baseVertexPointerToElement(
+            lockBuffer(srcPosBuf, HardwareBuffer::HBL_READ_ONLY), &job.srcPos);
+        srcElemBlendIndices->baseVertexPointerToElement(
+            lockBuffer(srcIdxBuf, HardwareBuffer::HBL_READ_ONLY), &job.blendIndex);
+        srcElemBlendWeights->baseVertexPointerToElement(
+            lockBuffer(srcWeightBuf, HardwareBuffer::HBL_READ_ONLY), &job.blendWeight);
+
+        HardwareBuffer::LockOptions destPosLock =
+            (destNormBuf != destPosBuf && destPosBuf->getVertexSize() == destElemPos->getSize()) ||
+            (destNormBuf == destPosBuf && destPosBuf->getVertexSize() == destElemPos->getSize() + destElemNorm->getSize()) ?
+            HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL;
+        destElemPos->baseVertexPointerToElement(lockBuffer(destPosBuf, destPosLock), &job.destPos);
+
+        if (includeNormals)
+        {
+            job.srcNormStride = srcNormBuf->getVertexSize();
+            job.destNormStride = destNormBuf->getVertexSize();
+            srcElemNorm->baseVertexPointerToElement(
+                lockBuffer(srcNormBuf, HardwareBuffer::HBL_READ_ONLY), &job.srcNorm);
+            HardwareBuffer::LockOptions destNormLock =
+                destNormBuf->getVertexSize() == destElemNorm->getSize() ?
+                HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL;
+            destElemNorm->baseVertexPointerToElement(
+                lockBuffer(destNormBuf, destNormLock), &job.destNorm);
+        }
+
+        job.firstMatrix = mBlendMatrices.size();
+        mBlendMatrices.insert(mBlendMatrices.end(), blendMatrices, blendMatrices + numMatrices);
+        mBlendJobs.push_back(job);
+    }
+}
@@ -355,6 +355,7 @@ namespace Ogre {
         : AnimationTrack(parent, handle), mTargetNode(0)
         , mSplines(0), mSplineBuildNeeded(false)
         , mUseShortestRotationPath(true)
+        , mCompressedKeys(0)
     {
     }
     //---------------------------------------------------------------------
@@ -363,12 +364,14 @@ namespace Ogre {
         : AnimationTrack(parent, handle), mTargetNode(targetNode)
         , mSplines(0), mSplineBuildNeeded(false)
         , mUseShortestRotationPath(true)
+        , mCompressedKeys(0)
     {
     }
     //---------------------------------------------------------------------
     NodeAnimationTrack::~NodeAnimationTrack()
     {
         OGRE_DELETE_T(mSplines, Splines, MEMCATEGORY_ANIMATION);
+        OGRE_DELETE mCompressedKeys;
     }
     //---------------------------------------------------------------------
     void NodeAnimationTrack::getInterpolatedKeyFrame(const TimeIndex& timeIndex, KeyFrame* kf) const
@@ -381,6 +384,14 @@ namespace Ogre {
 
         TransformKeyFrame* kret = static_cast<TransformKeyFrame*>(kf);
 
+        if (mCompressedKeys)
+        {
+            mCompressedKeys->getInterpolatedKeyFrame(timeIndex.getTimePos(), mParent->getLength(),
+                mParent->getRotationInterpolationMode() == Animation::RIM_SPHERICAL,
+                mUseShortestRotationPath, kret);
+            return;
+        }
+
         // Keyframe pointers
         KeyFrame *kBase1, *kBase2;
         TransformKeyFrame *k1, *k2;
@@ -474,30 +485,40 @@ namespace Ogre {
     void NodeAnimationTrack::applyToNode(Node* node, const TimeIndex& timeIndex, Real weight,
         Real scl)
     {
-        // Nothing to do if no keyframes or zero weight or no node
-        if (mKeyFrames.empty() || !weight || !node)
+        Vector3 translate, scale;
+        Quaternion rotate;
+        if (!node || !_getWeightedTransform(timeIndex, weight, scl, translate, rotate, scale))
             return;
 
+        node->translate(translate);
+        node->rotate(rotate);
+        node->scale(scale);
+    }
+    //---------------------------------------------------------------------
+    bool NodeAnimationTrack::_getWeightedTransform(const TimeIndex& timeIndex, Real weight,
+        Real scl, Vector3& outTranslate, Quaternion& outRotate, Vector3& outScale) const
+    {
+        // Nothing to do if no keyframes or zero weight
+        if ((mKeyFrames.empty() && !mCompressedKeys) || !weight)
+            return false;
+
         TransformKeyFrame kf(0, timeIndex.getTimePos());
         getInterpolatedKeyFrame(timeIndex, &kf);
 
         // add to existing. Weights are not relative, but treated as absolute multipliers for the animation
-        Vector3 translate = kf.getTranslate() * weight * scl;
-        node->translate(translate);
+        outTranslate = kf.getTranslate() * weight * scl;
 
         // interpolate between no-rotation and full rotation, to point 'weight', so 0 = no rotate, 1 = full
-        Quaternion rotate;
         Animation::RotationInterpolationMode rim =
             mParent->getRotationInterpolationMode();
         if (rim == Animation::RIM_LINEAR)
         {
-            rotate = Quaternion::nlerp(weight, Quaternion::IDENTITY, kf.getRotation(), mUseShortestRotationPath);
+            outRotate = Quaternion::nlerp(weight, Quaternion::IDENTITY, kf.getRotation(), mUseShortestRotationPath);
         }
         else //if (rim == Animation::RIM_SPHERICAL)
         {
-            rotate = Quaternion::Slerp(weight, Quaternion::IDENTITY, kf.getRotation(), mUseShortestRotationPath);
+            outRotate = Quaternion::Slerp(weight, Quaternion::IDENTITY, kf.getRotation(), mUseShortestRotationPath);
         }
-        node->rotate(rotate);
 
         Vector3 scale = kf.getScale();
         // Not sure how to modify scale for cumulative anims... leave it alone
@@ -509,8 +530,9 @@ namespace Ogre {
             else if (weight != 1.0f)
                 scale = Vector3::UNIT_SCALE + (scale - Vector3::UNIT_SCALE) * weight;
         }
-        node->scale(scale);
+        outScale = scale;
 
+        return true;
     }
     //---------------------------------------------------------------------
     void NodeAnimationTrack::buildInterpolationSplines(void) const
@@ -551,6 +573,14 @@ namespace Ogre {
         mSplineBuildNeeded = false;
     }
 
+    //---------------------------------------------------------------------
+    void NodeAnimationTrack::_buildInterpolationSplines(void) const
+    {
+        if (mSplineBuildNeeded)
+        {
+            buildInterpolationSplines();
+        }
+    }
     //---------------------------------------------------------------------
     void NodeAnimationTrack::setUseShortestRotationPath(bool useShortestPath)
     {
@@ -570,13 +600,18 @@ namespace Ogre {
     //---------------------------------------------------------------------
     bool NodeAnimationTrack::hasNonZeroKeyFrames(void) const
     {
-        KeyFrameList::const_iterator i = mKeyFrames.begin();
-        for (; i != mKeyFrames.end(); ++i)
+        size_t numKeys = mCompressedKeys ? mCompressedKeys->getNumKeys() : mKeyFrames.size();
+        TransformKeyFrame compressedKey(this, 0);
+        for (size_t i = 0; i < numKeys; ++i)
         {
             // look for keyframes which have any component which is non-zero
             // Since exporters can be a little inaccurate sometimes we use a
             // tolerance value rather than looking for nothing
-            TransformKeyFrame* kf = static_cast<TransformKeyFrame*>(*i);
+            TransformKeyFrame* kf = &compressedKey;
+            if (mCompressedKeys)
+                mCompressedKeys->getKey(i, kf);
+            else
+                kf = static_cast<TransformKeyFrame*>(mKeyFrames[i]);
             Vector3 trans = kf->getTranslate();
             Vector3 scale = kf->getScale();
             Vector3 axis;
@@ -654,6 +689,10 @@ namespace Ogre {
     //--------------------------------------------------------------------------
     KeyFrame* NodeAnimationTrack::createKeyFrameImpl(Real time)
     {
+        // Keyframes are edited uncompressed
+        if (mCompressedKeys)
+            decompress();
+
         return OGRE_NEW TransformKeyFrame(this, time);
     }
     //--------------------------------------------------------------------------
@@ -673,12 +712,20 @@ namespace Ogre {
             newParent->createNodeTrack(mHandle, mTargetNode);
         newTrack->mUseShortestRotationPath = mUseShortestRotationPath;
         populateClone(newTrack);
+        if (mCompressedKeys)
+            newTrack->_setCompressedKeys(OGRE_NEW CompressedTransformKeys(*mCompressedKeys));
         return newTrack;
     }
     //--------------------------------------------------------------------------
     void NodeAnimationTrack::_applyBaseKeyFrame(const KeyFrame* b)
     {
         const TransformKeyFrame* base = static_cast<const TransformKeyFrame*>(b);
+
+        if (mCompressedKeys)
+        {
+            mCompressedKeys->_applyBaseTransform(base->getTranslate(), base->getRotation(),
+                base->getScale());
+        }
         
         for (KeyFrameList::iterator i = mKeyFrames.begin(); i != mKeyFrames.end(); ++i)
         {
@@ -690,6 +737,38 @@ namespace Ogre {
             
     }
     //--------------------------------------------------------------------------
+    void NodeAnimationTrack::compress(const CompressedTransformKeys::Settings& settings)
+    {
+        if (mKeyFrames.empty())
+            return;
+
+        CompressedTransformKeys* keys = OGRE_NEW CompressedTransformKeys();
+        keys->build(this, settings,
+            mParent->getRotationInterpolationMode() == Animation::RIM_SPHERICAL);
+        _setCompressedKeys(keys);
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::decompress(void)
+    {
+        if (!mCompressedKeys)
+            return;
+
+        CompressedTransformKeys* keys = mCompressedKeys;
+        mCompressedKeys = 0;
+        for (size_t i = 0; i < keys->getNumKeys(); ++i)
+        {
+            keys->getKey(i, createNodeKeyFrame(keys->getKeyTime(i)));
+        }
+        OGRE_DELETE keys;
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::_setCompressedKeys(CompressedTransformKeys* keys)
+    {
+        removeAllKeyFrames();
+        OGRE_DELETE mCompressedKeys;
+        mCompressedKeys = keys;
+    }
+    //--------------------------------------------------------------------------
     VertexAnimationTrack::VertexAnimationTrack(Animation* parent,
         unsigned short handle, VertexAnimationType animType)
         : AnimationTrack(parent, handle)
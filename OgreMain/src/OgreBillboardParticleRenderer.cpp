@@ -133,16 +133,18 @@ namespace Ogre {
         Vector3 bboxMax = Math::NEG_INFINITY * Vector3::UNIT_SCALE;
         Real radius = 0.0f;
         mBillboardSet->beginBillboards(currentParticles.size());
-        Billboard bb;
+        mBillboards.resize(currentParticles.size());
         Affine3 invWorld;
 
         if (mBillboardSet->getBillboardsInWorldSpace() && mBillboardSet->getParentSceneNode())
             invWorld = mBillboardSet->getParentSceneNode()->_getFullTransform().inverse();
 
+        size_t index = 0;
         for (list<Particle*>::type::iterator i = currentParticles.begin();
-            i != currentParticles.end(); ++i)
+            i != currentParticles.end(); ++i, ++index)
         {
             Particle* p = *i;
+            Billboard& bb = mBillboards[index];
             bb.mPosition = p->mPosition;
             Vector3 pos = p->mPosition;
 
@@ -168,9 +170,10 @@ namespace Ogre {
                 bb.mWidth = p->mWidth;
                 bb.mHeight = p->mHeight;
             }
-            mBillboardSet->injectBillboard(bb);
-
         }
+        // Vertices are generated in one go from the contiguous array
+        if (!mBillboards.empty())
+            mBillboardSet->injectBillboards(&mBillboards[0], mBillboards.size());
 
         // Only set bounds if there are any active particles
         if(currentParticles.size())
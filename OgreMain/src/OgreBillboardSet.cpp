@@ -29,6 +29,8 @@ THE SOFTWARE.
 
 #include "OgreBillboardSet.h"
 #include "OgreBillboard.h"
+#include "OgreOptimisedUtil.h"
+#include "OgreThreadPool.h"
 
 #include <algorithm>
 
@@ -48,6 +50,7 @@ namespace Ogre {
         mAllDefaultRotation(true),
         mWorldSpace(false),
         mVertexData(0),
+        mColourType(VET_COLOUR),
         mIndexData(0),
         mCullIndividual( false ),
         mBillboardType(BBT_POINT),
@@ -83,6 +86,7 @@ namespace Ogre {
         mAllDefaultRotation(true),
         mWorldSpace(false),
         mVertexData(0),
+        mColourType(VET_COLOUR),
         mIndexData(0),
         mCullIndividual( false ),
         mBillboardType(BBT_POINT),
@@ -430,6 +434,9 @@ namespace Ogre {
             }
         }
 
+        // Fetch the colour format once rather than per billboard
+        mColourType = VertexElement::getBestColourVertexElementType();
+
         // Init num visible
         mNumVisibleBillboards = 0;
 
@@ -472,55 +479,151 @@ namespace Ogre {
         // Skip if not visible (NB always true if not bounds checking individual billboards)
         if (!billboardVisible(mCurrentCamera, bb)) return;
 
-        if (!mPointRendering &&
-            (mBillboardType == BBT_ORIENTED_SELF ||
-            mBillboardType == BBT_PERPENDICULAR_SELF ||
-            (mAccurateFacing && mBillboardType != BBT_PERPENDICULAR_COMMON)))
+        Vector3 vOwnOffset[4];
+        genVertices(getBillboardOffsets(bb, vOwnOffset), bb);
+
+        // Increment visibles
+        mNumVisibleBillboards++;
+    }
+    //-----------------------------------------------------------------------
+    void BillboardSet::injectBillboards(const Billboard* billboards, size_t count)
+    {
+        // Cull up front and serially, Camera::isVisible updates the frustum on demand
+        if (mCullIndividual)
         {
-            // Have to generate axes & offsets per billboard
-            genBillboardAxes(&mCamX, &mCamY, &bb);
+            mBatchVisibleBillboards.clear();
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (billboardVisible(mCurrentCamera, billboards[i]))
+                    mBatchVisibleBillboards.push_back(billboards + i);
+            }
+            count = mBatchVisibleBillboards.size();
+            injectBillboardBatch(0, count ? &mBatchVisibleBillboards[0] : 0, count);
         }
+        else
+        {
+            injectBillboardBatch(billboards, 0, count);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BillboardSet::injectBillboardBatch(const Billboard* billboards, const Billboard* const* visible,
+        size_t count)
+    {
+        // Don't accept injections beyond pool size
+        count = std::min(count, mPoolSize - mNumVisibleBillboards);
+        if (!count)
+            return;
+
+        // Each billboard owns a fixed slice of the locked buffer, so chunks can be
+        // written independently
+        size_t floatsPerBillboard = mMainBuf->getVertexSize() / sizeof(float);
+        if (!mPointRendering)
+            floatsPerBillboard *= 4;
+        float* pDest = mLockPtr;
 
-        // If they're all the same size or we're point rendering
-        if( mAllDefaultSize || mPointRendering)
+        // Large enough to amortise handing a chunk to a worker thread
+        const size_t grainSize = 1024;
+        ThreadPool* pool = Root::getSingleton().getThreadPool();
+        if (pool && count > grainSize)
         {
-            /* No per-billboard checking, just blast through.
-            Saves us an if clause every billboard which may
-            make a difference.
-            */
+            pool->parallelFor(0, count, grainSize,
+                [this, billboards, visible, pDest, floatsPerBillboard](size_t begin, size_t end, size_t) {
+                    genVerticesBatch(billboards, visible, begin, end, pDest + begin * floatsPerBillboard);
+                });
+        }
+        else
+        {
+            genVerticesBatch(billboards, visible, 0, count, pDest);
+        }
 
-            if (!mPointRendering &&
-                (mBillboardType == BBT_ORIENTED_SELF ||
-                mBillboardType == BBT_PERPENDICULAR_SELF ||
-                (mAccurateFacing && mBillboardType != BBT_PERPENDICULAR_COMMON)))
+        mLockPtr += count * floatsPerBillboard;
+        mNumVisibleBillboards += static_cast<unsigned short>(count);
+    }
+    //-----------------------------------------------------------------------
+    void BillboardSet::genVerticesBatch(const Billboard* billboards, const Billboard* const* visible,
+        size_t begin, size_t end, float* pDest) const
+    {
+        // Billboards without rotation are staged and expanded in blocks, rotated
+        // ones flush the staged block and are written on their own
+        const size_t blockSize = 64;
+        float centres[blockSize * 3];
+        float offsets[blockSize * 12];
+        uint32 colours[blockSize];
+        float rects[blockSize * 4];
+        size_t numStaged = 0;
+
+        // Offsets are only staged per billboard if they can differ
+        bool ownOffsets = !mAllDefaultSize ||
+            mBillboardType == BBT_ORIENTED_SELF ||
+            mBillboardType == BBT_PERPENDICULAR_SELF ||
+            (mAccurateFacing && mBillboardType != BBT_PERPENDICULAR_COMMON);
+        if (!ownOffsets)
+        {
+            for (size_t c = 0; c < 4; ++c)
             {
-                genVertOffsets(mLeftOff, mRightOff, mTopOff, mBottomOff,
-                    mDefaultWidth, mDefaultHeight, mCamX, mCamY, mVOffset);
+                offsets[c * 3 + 0] = static_cast<float>(mVOffset[c].x);
+                offsets[c * 3 + 1] = static_cast<float>(mVOffset[c].y);
+                offsets[c * 3 + 2] = static_cast<float>(mVOffset[c].z);
             }
-            genVertices(mVOffset, bb);
         }
-        else // not all default size and not point rendering
+
+        for (size_t i = begin; i < end; ++i)
         {
+            const Billboard& bb = visible ? *visible[i] : billboards[i];
+            RGBA colour = VertexElement::convertColourValue(bb.mColour, mColourType);
+
             Vector3 vOwnOffset[4];
-            // If it has own dimensions, or self-oriented, gen offsets
-            if (mBillboardType == BBT_ORIENTED_SELF ||
-                mBillboardType == BBT_PERPENDICULAR_SELF ||
-                bb.mOwnDimensions ||
-                (mAccurateFacing && mBillboardType != BBT_PERPENDICULAR_COMMON))
+            if (mPointRendering || !(mAllDefaultRotation || bb.mRotation == Radian(0)))
             {
-                // Generate using own dimensions
-                genVertOffsets(mLeftOff, mRightOff, mTopOff, mBottomOff,
-                    bb.mWidth, bb.mHeight, mCamX, mCamY, vOwnOffset);
-                // Create vertex data
-                genVertices(vOwnOffset, bb);
+                if (numStaged)
+                {
+                    OptimisedUtil::getImplementation()->expandBillboardQuads(
+                        centres, offsets, ownOffsets ? 12 : 0, colours, rects, pDest, numStaged);
+                    pDest += numStaged * 24;
+                    numStaged = 0;
+                }
+                pDest = genVertices(pDest, getBillboardOffsets(bb, vOwnOffset), bb, colour);
+                continue;
+            }
+
+            assert( bb.mUseTexcoordRect || bb.mTexcoordIndex < mTextureCoords.size() );
+            const Ogre::FloatRect & r =
+                bb.mUseTexcoordRect ? bb.mTexcoordRect : mTextureCoords[bb.mTexcoordIndex];
+
+            centres[numStaged * 3 + 0] = static_cast<float>(bb.mPosition.x);
+            centres[numStaged * 3 + 1] = static_cast<float>(bb.mPosition.y);
+            centres[numStaged * 3 + 2] = static_cast<float>(bb.mPosition.z);
+            if (ownOffsets)
+            {
+                const Vector3* o = getBillboardOffsets(bb, vOwnOffset);
+                float* dst = offsets + numStaged * 12;
+                for (size_t c = 0; c < 4; ++c)
+                {
+                    dst[c * 3 + 0] = static_cast<float>(o[c].x);
+                    dst[c * 3 + 1] = static_cast<float>(o[c].y);
+                    dst[c * 3 + 2] = static_cast<float>(o[c].z);
+                }
             }
-            else // Use default dimension, already computed before the loop, for faster creation
+            colours[numStaged] = colour;
+            rects[numStaged * 4 + 0] = r.left;
+            rects[numStaged * 4 + 1] = r.top;
+            rects[numStaged * 4 + 2] = r.right;
+            rects[numStaged * 4 + 3] = r.bottom;
+
+            if (++numStaged == blockSize)
             {
-                genVertices(mVOffset, bb);
+                OptimisedUtil::getImplementation()->expandBillboardQuads(
+                    centres, offsets, ownOffsets ? 12 : 0, colours, rects, pDest, numStaged);
+                pDest += numStaged * 24;
+                numStaged = 0;
             }
         }
-        // Increment visibles
-        mNumVisibleBillboards++;
+
+        if (numStaged)
+        {
+            OptimisedUtil::getImplementation()->expandBillboardQuads(
+                centres, offsets, ownOffsets ? 12 : 0, colours, rects, pDest, numStaged);
+        }
     }
     //-----------------------------------------------------------------------
     void BillboardSet::endBillboards(void)
@@ -599,13 +702,18 @@ namespace Ogre {
             }
 
             beginBillboards(mActiveBillboards.size());
+            // The active billboards are not contiguous, batch them through their pointers
+            mBatchVisibleBillboards.clear();
             ActiveBillboardList::iterator it;
             for(it = mActiveBillboards.begin();
                 it != mActiveBillboards.end();
                 ++it )
             {
-                injectBillboard(*(*it));
+                if (billboardVisible(mCurrentCamera, *(*it)))
+                    mBatchVisibleBillboards.push_back(*it);
             }
+            size_t count = mBatchVisibleBillboards.size();
+            injectBillboardBatch(0, count ? &mBatchVisibleBillboards[0] : 0, count);
             endBillboards();
             mBillboardDataChanged = false;
         }
@@ -1004,17 +1112,18 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
-    void BillboardSet::genBillboardAxes(Vector3* pX, Vector3 *pY, const Billboard* bb)
+    void BillboardSet::genBillboardAxes(Vector3* pX, Vector3 *pY, const Billboard* bb) const
     {
         // If we're using accurate facing, recalculate camera direction per BB
+        Vector3 camDir = mCamDir;
         if (mAccurateFacing && 
             (mBillboardType == BBT_POINT || 
             mBillboardType == BBT_ORIENTED_COMMON ||
             mBillboardType == BBT_ORIENTED_SELF))
         {
             // cam -> bb direction
-            mCamDir = bb->mPosition - mCamPos;
-            mCamDir.normalise();
+            camDir = bb->mPosition - mCamPos;
+            camDir.normalise();
         }
 
 
@@ -1026,9 +1135,9 @@ namespace Ogre {
                 // Point billboards will have 'up' based on but not equal to cameras
                 // Use pY temporarily to avoid allocation
                 *pY = mCamQ * Vector3::UNIT_Y;
-                *pX = mCamDir.crossProduct(*pY);
+                *pX = camDir.crossProduct(*pY);
                 pX->normalise();
-                *pY = pX->crossProduct(mCamDir); // both normalised already
+                *pY = pX->crossProduct(camDir); // both normalised already
             }
             else
             {
@@ -1042,7 +1151,7 @@ namespace Ogre {
             // Y-axis is common direction
             // X-axis is cross with camera direction
             *pY = mCommonDirection;
-            *pX = mCamDir.crossProduct(*pY);
+            *pX = camDir.crossProduct(*pY);
             pX->normalise();
             break;
 
@@ -1051,7 +1160,7 @@ namespace Ogre {
             // X-axis is cross with camera direction
             // Scale direction first
             *pY = bb->mDirection;
-            *pX = mCamDir.crossProduct(*pY);
+            *pX = camDir.crossProduct(*pY);
             pX->normalise();
             break;
 
@@ -1111,8 +1220,13 @@ namespace Ogre {
     void BillboardSet::genVertices(
         const Vector3* const offsets, const Billboard& bb)
     {
-        RGBA colour;
-        Root::getSingleton().convertColourValue(bb.mColour, &colour);
+        mLockPtr = genVertices(mLockPtr, offsets, bb,
+            VertexElement::convertColourValue(bb.mColour, mColourType));
+    }
+    //-----------------------------------------------------------------------
+    float* BillboardSet::genVertices(float* pDest,
+        const Vector3* const offsets, const Billboard& bb, RGBA colour) const
+    {
         RGBA* pCol;
 
         // Texcoords
@@ -1124,78 +1238,78 @@ namespace Ogre {
         {
             // Single vertex per billboard, ignore offsets
             // position
-            *mLockPtr++ = bb.mPosition.x;
-            *mLockPtr++ = bb.mPosition.y;
-            *mLockPtr++ = bb.mPosition.z;
+            *pDest++ = bb.mPosition.x;
+            *pDest++ = bb.mPosition.y;
+            *pDest++ = bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // No texture coords in point rendering
         }
         else if (mAllDefaultRotation || bb.mRotation == Radian(0))
         {
             // Left-top
             // Positions
-            *mLockPtr++ = offsets[0].x + bb.mPosition.x;
-            *mLockPtr++ = offsets[0].y + bb.mPosition.y;
-            *mLockPtr++ = offsets[0].z + bb.mPosition.z;
+            *pDest++ = offsets[0].x + bb.mPosition.x;
+            *pDest++ = offsets[0].y + bb.mPosition.y;
+            *pDest++ = offsets[0].z + bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // Texture coords
-            *mLockPtr++ = r.left;
-            *mLockPtr++ = r.top;
+            *pDest++ = r.left;
+            *pDest++ = r.top;
 
             // Right-top
             // Positions
-            *mLockPtr++ = offsets[1].x + bb.mPosition.x;
-            *mLockPtr++ = offsets[1].y + bb.mPosition.y;
-            *mLockPtr++ = offsets[1].z + bb.mPosition.z;
+            *pDest++ = offsets[1].x + bb.mPosition.x;
+            *pDest++ = offsets[1].y + bb.mPosition.y;
+            *pDest++ = offsets[1].z + bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // Texture coords
-            *mLockPtr++ = r.right;
-            *mLockPtr++ = r.top;
+            *pDest++ = r.right;
+            *pDest++ = r.top;
 
             // Left-bottom
             // Positions
-            *mLockPtr++ = offsets[2].x + bb.mPosition.x;
-            *mLockPtr++ = offsets[2].y + bb.mPosition.y;
-            *mLockPtr++ = offsets[2].z + bb.mPosition.z;
+            *pDest++ = offsets[2].x + bb.mPosition.x;
+            *pDest++ = offsets[2].y + bb.mPosition.y;
+            *pDest++ = offsets[2].z + bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // Texture coords
-            *mLockPtr++ = r.left;
-            *mLockPtr++ = r.bottom;
+            *pDest++ = r.left;
+            *pDest++ = r.bottom;
 
             // Right-bottom
             // Positions
-            *mLockPtr++ = offsets[3].x + bb.mPosition.x;
-            *mLockPtr++ = offsets[3].y + bb.mPosition.y;
-            *mLockPtr++ = offsets[3].z + bb.mPosition.z;
+            *pDest++ = offsets[3].x + bb.mPosition.x;
+            *pDest++ = offsets[3].y + bb.mPosition.y;
+            *pDest++ = offsets[3].z + bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // Texture coords
-            *mLockPtr++ = r.right;
-            *mLockPtr++ = r.bottom;
+            *pDest++ = r.right;
+            *pDest++ = r.bottom;
         }
         else if (mRotationType == BBR_VERTEX)
         {
@@ -1210,66 +1324,66 @@ namespace Ogre {
             // Left-top
             // Positions
             pt = rotation * offsets[0];
-            *mLockPtr++ = pt.x + bb.mPosition.x;
-            *mLockPtr++ = pt.y + bb.mPosition.y;
-            *mLockPtr++ = pt.z + bb.mPosition.z;
+            *pDest++ = pt.x + bb.mPosition.x;
+            *pDest++ = pt.y + bb.mPosition.y;
+            *pDest++ = pt.z + bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // Texture coords
-            *mLockPtr++ = r.left;
-            *mLockPtr++ = r.top;
+            *pDest++ = r.left;
+            *pDest++ = r.top;
 
             // Right-top
             // Positions
             pt = rotation * offsets[1];
-            *mLockPtr++ = pt.x + bb.mPosition.x;
-            *mLockPtr++ = pt.y + bb.mPosition.y;
-            *mLockPtr++ = pt.z + bb.mPosition.z;
+            *pDest++ = pt.x + bb.mPosition.x;
+            *pDest++ = pt.y + bb.mPosition.y;
+            *pDest++ = pt.z + bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // Texture coords
-            *mLockPtr++ = r.right;
-            *mLockPtr++ = r.top;
+            *pDest++ = r.right;
+            *pDest++ = r.top;
 
             // Left-bottom
             // Positions
             pt = rotation * offsets[2];
-            *mLockPtr++ = pt.x + bb.mPosition.x;
-            *mLockPtr++ = pt.y + bb.mPosition.y;
-            *mLockPtr++ = pt.z + bb.mPosition.z;
+            *pDest++ = pt.x + bb.mPosition.x;
+            *pDest++ = pt.y + bb.mPosition.y;
+            *pDest++ = pt.z + bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // Texture coords
-            *mLockPtr++ = r.left;
-            *mLockPtr++ = r.bottom;
+            *pDest++ = r.left;
+            *pDest++ = r.bottom;
 
             // Right-bottom
             // Positions
             pt = rotation * offsets[3];
-            *mLockPtr++ = pt.x + bb.mPosition.x;
-            *mLockPtr++ = pt.y + bb.mPosition.y;
-            *mLockPtr++ = pt.z + bb.mPosition.z;
+            *pDest++ = pt.x + bb.mPosition.x;
+            *pDest++ = pt.y + bb.mPosition.y;
+            *pDest++ = pt.z + bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // Texture coords
-            *mLockPtr++ = r.right;
-            *mLockPtr++ = r.bottom;
+            *pDest++ = r.right;
+            *pDest++ = r.bottom;
         }
         else
         {
@@ -1288,69 +1402,95 @@ namespace Ogre {
 
             // Left-top
             // Positions
-            *mLockPtr++ = offsets[0].x + bb.mPosition.x;
-            *mLockPtr++ = offsets[0].y + bb.mPosition.y;
-            *mLockPtr++ = offsets[0].z + bb.mPosition.z;
+            *pDest++ = offsets[0].x + bb.mPosition.x;
+            *pDest++ = offsets[0].y + bb.mPosition.y;
+            *pDest++ = offsets[0].z + bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // Texture coords
-            *mLockPtr++ = mid_u - cos_rot_w + sin_rot_h;
-            *mLockPtr++ = mid_v - sin_rot_w - cos_rot_h;
+            *pDest++ = mid_u - cos_rot_w + sin_rot_h;
+            *pDest++ = mid_v - sin_rot_w - cos_rot_h;
 
             // Right-top
             // Positions
-            *mLockPtr++ = offsets[1].x + bb.mPosition.x;
-            *mLockPtr++ = offsets[1].y + bb.mPosition.y;
-            *mLockPtr++ = offsets[1].z + bb.mPosition.z;
+            *pDest++ = offsets[1].x + bb.mPosition.x;
+            *pDest++ = offsets[1].y + bb.mPosition.y;
+            *pDest++ = offsets[1].z + bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // Texture coords
-            *mLockPtr++ = mid_u + cos_rot_w + sin_rot_h;
-            *mLockPtr++ = mid_v + sin_rot_w - cos_rot_h;
+            *pDest++ = mid_u + cos_rot_w + sin_rot_h;
+            *pDest++ = mid_v + sin_rot_w - cos_rot_h;
 
             // Left-bottom
             // Positions
-            *mLockPtr++ = offsets[2].x + bb.mPosition.x;
-            *mLockPtr++ = offsets[2].y + bb.mPosition.y;
-            *mLockPtr++ = offsets[2].z + bb.mPosition.z;
+            *pDest++ = offsets[2].x + bb.mPosition.x;
+            *pDest++ = offsets[2].y + bb.mPosition.y;
+            *pDest++ = offsets[2].z + bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // Texture coords
-            *mLockPtr++ = mid_u - cos_rot_w - sin_rot_h;
-            *mLockPtr++ = mid_v - sin_rot_w + cos_rot_h;
+            *pDest++ = mid_u - cos_rot_w - sin_rot_h;
+            *pDest++ = mid_v - sin_rot_w + cos_rot_h;
 
             // Right-bottom
             // Positions
-            *mLockPtr++ = offsets[3].x + bb.mPosition.x;
-            *mLockPtr++ = offsets[3].y + bb.mPosition.y;
-            *mLockPtr++ = offsets[3].z + bb.mPosition.z;
+            *pDest++ = offsets[3].x + bb.mPosition.x;
+            *pDest++ = offsets[3].y + bb.mPosition.y;
+            *pDest++ = offsets[3].z + bb.mPosition.z;
             // Colour
             // Convert float* to RGBA*
-            pCol = static_cast<RGBA*>(static_cast<void*>(mLockPtr));
+            pCol = static_cast<RGBA*>(static_cast<void*>(pDest));
             *pCol++ = colour;
             // Update lock pointer
-            mLockPtr = static_cast<float*>(static_cast<void*>(pCol));
+            pDest = static_cast<float*>(static_cast<void*>(pCol));
             // Texture coords
-            *mLockPtr++ = mid_u + cos_rot_w - sin_rot_h;
-            *mLockPtr++ = mid_v + sin_rot_w + cos_rot_h;
+            *pDest++ = mid_u + cos_rot_w - sin_rot_h;
+            *pDest++ = mid_v + sin_rot_w + cos_rot_h;
         }
 
+        return pDest;
+    }
+    //-----------------------------------------------------------------------
+    const Vector3* BillboardSet::getBillboardOffsets(const Billboard& bb, Vector3* pOwnOffsets) const
+    {
+        // Point rendering ignores the offsets
+        if (mPointRendering)
+            return mVOffset;
+
+        bool ownAxes = mBillboardType == BBT_ORIENTED_SELF ||
+            mBillboardType == BBT_PERPENDICULAR_SELF ||
+            (mAccurateFacing && mBillboardType != BBT_PERPENDICULAR_COMMON);
+        bool ownSize = !mAllDefaultSize && bb.mOwnDimensions;
+
+        // Use default offsets, already computed in beginBillboards, for faster creation
+        if (!ownAxes && !ownSize)
+            return mVOffset;
+
+        Vector3 camX = mCamX, camY = mCamY;
+        if (ownAxes)
+            genBillboardAxes(&camX, &camY, &bb);
+
+        genVertOffsets(mLeftOff, mRightOff, mTopOff, mBottomOff,
+            ownSize ? bb.mWidth : mDefaultWidth, ownSize ? bb.mHeight : mDefaultHeight,
+            camX, camY, pOwnOffsets);
+        return pOwnOffsets;
     }
     //-----------------------------------------------------------------------
     void BillboardSet::genVertOffsets(Real inleft, Real inright, Real intop, Real inbottom,
-        Real width, Real height, const Vector3& x, const Vector3& y, Vector3* pDestVec)
+        Real width, Real height, const Vector3& x, const Vector3& y, Vector3* pDestVec) const
     {
         Vector3 vLeftOff, vRightOff, vTopOff, vBottomOff;
         /* Calculate default offsets. Scale the axes by
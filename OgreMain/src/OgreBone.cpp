@@ -113,6 +113,28 @@ namespace Ogre {
         return mHandle;
     }
     //---------------------------------------------------------------------
+    void Bone::_setDerivedTransform(const Vector3& position, const Quaternion& orientation,
+        const Vector3& scale)
+    {
+        mDerivedPosition = position;
+        mDerivedOrientation = orientation;
+        mDerivedScale = scale;
+        mCachedTransformOutOfDate = true;
+        mNeedParentUpdate = false;
+        mNeedChildUpdate = false;
+        mParentNotified = false;
+        mChildrenToUpdate.clear();
+    }
+    //---------------------------------------------------------------------
+    void Bone::_setLocalTransform(const Vector3& position, const Quaternion& orientation,
+        const Vector3& scale)
+    {
+        mPosition = position;
+        mOrientation = orientation;
+        mScale = scale;
+        needUpdate();
+    }
+    //---------------------------------------------------------------------
     void Bone::needUpdate(bool forceParentUpdate)
     {
         Node::needUpdate(forceParentUpdate);
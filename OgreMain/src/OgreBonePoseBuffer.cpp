@@ -0,0 +1,221 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreBonePoseBuffer.h"
+#include "OgreBone.h"
+
+namespace Ogre {
+    const uint16 BonePoseBuffer::NO_PARENT;
+    //-----------------------------------------------------------------------
+    BonePoseBuffer::BonePoseBuffer()
+        : mData(0)
+        , mValid(false)
+    {
+    }
+    //-----------------------------------------------------------------------
+    BonePoseBuffer::~BonePoseBuffer()
+    {
+        OGRE_FREE_SIMD(mData, MEMCATEGORY_ANIMATION);
+    }
+    //-----------------------------------------------------------------------
+    bool BonePoseBuffer::rebuild(const BoneList& bones)
+    {
+        mBones.clear();
+        mParentNodes.clear();
+        mHandles.clear();
+        mParents.clear();
+        mNumBoneChildren.clear();
+        mFlags.clear();
+        OGRE_FREE_SIMD(mData, MEMCATEGORY_ANIMATION);
+        mData = 0;
+
+        const size_t numBones = bones.size();
+        if (numBones == 0 || numBones >= NO_PARENT)
+            return false;
+
+        // depth of each bone, following the parents
+        typedef map<const Node*, uint16>::type HandleMap;
+        HandleMap handles;
+        for (size_t i = 0; i < numBones; ++i)
+        {
+            if (!bones[i])
+                return false;
+            handles[bones[i]] = static_cast<uint16>(i);
+        }
+        IndexList depths(numBones);
+        for (size_t i = 0; i < numBones; ++i)
+        {
+            uint16 depth = 0;
+            for (const Node* parent = bones[i]->getParent(); parent; parent = parent->getParent())
+            {
+                // bones must only have bones of this skeleton as parents
+                if (handles.find(parent) == handles.end() || ++depth >= numBones)
+                    return false;
+            }
+            depths[i] = depth;
+        }
+
+        // order by depth then handle, so parents precede their children
+        mHandles.resize(numBones);
+        for (size_t i = 0; i < numBones; ++i)
+            mHandles[i] = static_cast<uint16>(i);
+        std::stable_sort(mHandles.begin(), mHandles.end(),
+                         [&depths](uint16 a, uint16 b) { return depths[a] < depths[b]; });
+
+        IndexList indices(numBones);
+        for (size_t i = 0; i < numBones; ++i)
+            indices[mHandles[i]] = static_cast<uint16>(i);
+
+        mBones.resize(numBones);
+        mParentNodes.resize(numBones);
+        mParents.resize(numBones);
+        mNumBoneChildren.assign(numBones, 0);
+        mFlags.resize(numBones);
+        for (size_t i = 0; i < numBones; ++i)
+        {
+            Bone* bone = bones[mHandles[i]];
+            mBones[i] = bone;
+            mParentNodes[i] = bone->getParent();
+            mParents[i] = NO_PARENT;
+            if (bone->getParent())
+            {
+                mParents[i] = indices[handles[bone->getParent()]];
+                ++mNumBoneChildren[mParents[i]];
+            }
+        }
+
+        // 30 streams, padded so each one stays aligned
+        const size_t stride = (numBones + 3) & ~size_t(3);
+        mData = static_cast<Real*>(OGRE_MALLOC_SIMD(sizeof(Real) * stride * 30, MEMCATEGORY_ANIMATION));
+        Real* stream = mData;
+        TransformStreams* groups[3] = {&mLocal, &mDerived, &mBindInverse};
+        for (size_t g = 0; g < 3; ++g)
+        {
+            for (size_t c = 0; c < 3; ++c, stream += stride)
+                groups[g]->position[c] = stream;
+            for (size_t c = 0; c < 4; ++c, stream += stride)
+                groups[g]->orientation[c] = stream;
+            for (size_t c = 0; c < 3; ++c, stream += stride)
+                groups[g]->scale[c] = stream;
+        }
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    BonePoseBuffer::GatherResult BonePoseBuffer::gather(const BoneList& bones)
+    {
+        if (bones.size() != mBones.size())
+            return GR_HIERARCHY_CHANGED;
+
+        const size_t numBones = mBones.size();
+        for (size_t i = 0; i < numBones; ++i)
+        {
+            Bone* bone = mBones[i];
+            if (bones[mHandles[i]] != bone || bone->getParent() != mParentNodes[i])
+                return GR_HIERARCHY_CHANGED;
+            // listeners and tag points rely on Node::_update being called
+            if (bone->getListener() || bone->numChildren() != mNumBoneChildren[i])
+                return GR_UNSUPPORTED;
+
+            storeVector3(mLocal.position, i, bone->getPosition());
+            storeQuaternion(mLocal.orientation, i, bone->getOrientation());
+            storeVector3(mLocal.scale, i, bone->getScale());
+            storeVector3(mBindInverse.position, i, bone->_getBindingPoseInversePosition());
+            storeQuaternion(mBindInverse.orientation, i, bone->_getBindingPoseInverseOrientation());
+            storeVector3(mBindInverse.scale, i, bone->_getBindingPoseInverseScale());
+            mFlags[i] = (bone->getInheritOrientation() ? BF_INHERIT_ORIENTATION : 0) |
+                        (bone->getInheritScale() ? BF_INHERIT_SCALE : 0);
+        }
+        return GR_OK;
+    }
+    //-----------------------------------------------------------------------
+    bool BonePoseBuffer::update(const BoneList& bones)
+    {
+        GatherResult result = gather(bones);
+        if (result == GR_HIERARCHY_CHANGED)
+            result = rebuild(bones) ? gather(bones) : GR_UNSUPPORTED;
+        mValid = result == GR_OK;
+        if (!mValid)
+            return false;
+
+        const size_t numBones = mBones.size();
+
+        // same operations as Node::updateFromParentImpl, parents are always updated first
+        for (size_t i = 0; i < numBones; ++i)
+        {
+            const uint16 parent = mParents[i];
+            if (parent == NO_PARENT)
+            {
+                storeVector3(mDerived.position, i, loadVector3(mLocal.position, i));
+                storeQuaternion(mDerived.orientation, i, loadQuaternion(mLocal.orientation, i));
+                storeVector3(mDerived.scale, i, loadVector3(mLocal.scale, i));
+                continue;
+            }
+
+            const Quaternion parentOrientation = loadQuaternion(mDerived.orientation, parent);
+            const Quaternion orientation = loadQuaternion(mLocal.orientation, i);
+            storeQuaternion(mDerived.orientation, i,
+                (mFlags[i] & BF_INHERIT_ORIENTATION) ? parentOrientation * orientation : orientation);
+
+            const Vector3 parentScale = loadVector3(mDerived.scale, parent);
+            const Vector3 scale = loadVector3(mLocal.scale, i);
+            storeVector3(mDerived.scale, i,
+                (mFlags[i] & BF_INHERIT_SCALE) ? parentScale * scale : scale);
+
+            Vector3 position = parentOrientation * (parentScale * loadVector3(mLocal.position, i));
+            position += loadVector3(mDerived.position, parent);
+            storeVector3(mDerived.position, i, position);
+        }
+
+        for (size_t i = 0; i < numBones; ++i)
+        {
+            mBones[i]->_setDerivedTransform(loadVector3(mDerived.position, i),
+                                            loadQuaternion(mDerived.orientation, i),
+                                            loadVector3(mDerived.scale, i));
+        }
+
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void BonePoseBuffer::getOffsetTransforms(Affine3* matrices) const
+    {
+        assert(mValid);
+
+        // same operations as Bone::_getOffsetTransform
+        const size_t numBones = mBones.size();
+        for (size_t i = 0; i < numBones; ++i)
+        {
+            Vector3 locScale = loadVector3(mDerived.scale, i) * loadVector3(mBindInverse.scale, i);
+            Quaternion locRotate =
+                loadQuaternion(mDerived.orientation, i) * loadQuaternion(mBindInverse.orientation, i);
+            Vector3 locTranslate = loadVector3(mDerived.position, i) +
+                locRotate * (locScale * loadVector3(mBindInverse.position, i));
+
+            matrices[mHandles[i]].makeTransform(locTranslate, locScale, locRotate);
+        }
+    }
+}
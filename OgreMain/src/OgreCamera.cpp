@@ -872,6 +872,32 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void Camera::isVisible(size_t numBoxes, const float* const centres[3],
+                           const float* const halfSizes[3], uint32* visibility) const
+    {
+        if (mCullFrustum)
+        {
+            mCullFrustum->isVisible(numBoxes, centres, halfSizes, visibility);
+        }
+        else
+        {
+            Frustum::isVisible(numBoxes, centres, halfSizes, visibility);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Camera::isVisible(size_t numSpheres, const float* const centres[3],
+                           const float* radii, uint32* visibility) const
+    {
+        if (mCullFrustum)
+        {
+            mCullFrustum->isVisible(numSpheres, centres, radii, visibility);
+        }
+        else
+        {
+            Frustum::isVisible(numSpheres, centres, radii, visibility);
+        }
+    }
+    //-----------------------------------------------------------------------
     bool Camera::isVisible(const Sphere& bound, FrustumPlane* culledBy) const
     {
         if (mCullFrustum)
@@ -0,0 +1,348 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreCompressedTransformKeys.h"
+#include "OgreAnimationTrack.h"
+#include "OgreKeyFrame.h"
+
+namespace Ogre {
+    namespace {
+        /// Largest value of the three smallest components of a unit quaternion
+        const Real ROTATION_RANGE = Real(0.70710678118654752440);
+        const Real ROTATION_STEPS = Real(32767);
+
+        struct TransformKey
+        {
+            Real time;
+            Vector3 translate;
+            Quaternion rotation;
+            Vector3 scale;
+        };
+        typedef vector<TransformKey>::type TransformKeyList;
+
+        Real rotationError(const Quaternion& a, const Quaternion& b)
+        {
+            Real d = std::min(Math::Abs(a.Dot(b)), Real(1));
+            return 2 * std::acos(d);
+        }
+
+        Quaternion interpolateRotation(Real t, const Quaternion& a, const Quaternion& b,
+            bool sphericalRotation, bool shortestPath)
+        {
+            return sphericalRotation ? Quaternion::Slerp(t, a, b, shortestPath) :
+                Quaternion::nlerp(t, a, b, shortestPath);
+        }
+
+        Vector3 loadVector3(const float* v)
+        {
+            return Vector3(v[0], v[1], v[2]);
+        }
+
+        void storeVector3(float* dst, const Vector3& v)
+        {
+            dst[0] = static_cast<float>(v.x);
+            dst[1] = static_cast<float>(v.y);
+            dst[2] = static_cast<float>(v.z);
+        }
+    }
+    //-----------------------------------------------------------------------
+    CompressedTransformKeys::Settings::Settings()
+        : positionTolerance(1e-3f)
+        , rotationTolerance(1e-3f)
+        , scaleTolerance(1e-3f)
+    {
+    }
+    //-----------------------------------------------------------------------
+    CompressedTransformKeys::CompressedTransformKeys()
+        : mConstantChannels(0)
+        , mCursor(0)
+    {
+    }
+    //-----------------------------------------------------------------------
+    CompressedTransformKeys::CompressedTransformKeys(const CompressedTransformKeys& rhs)
+        : mTimes(rhs.mTimes)
+        , mTranslations(rhs.mTranslations)
+        , mRotations(rhs.mRotations)
+        , mScales(rhs.mScales)
+        , mConstantChannels(rhs.mConstantChannels)
+        , mCursor(0)
+    {
+    }
+    //-----------------------------------------------------------------------
+    CompressedTransformKeys::PackedRotation CompressedTransformKeys::packRotation(const Quaternion& rotation)
+    {
+        Quaternion q = rotation;
+        q.normalise();
+
+        size_t largest = 0;
+        for (size_t i = 1; i < 4; ++i)
+        {
+            if (Math::Abs(q[i]) > Math::Abs(q[largest]))
+                largest = i;
+        }
+
+        uint16 quantised[3];
+        for (size_t i = 0, c = 0; i < 4; ++i)
+        {
+            if (i == largest)
+                continue;
+            Real v = (q[i] / ROTATION_RANGE + 1) * 0.5f * ROTATION_STEPS;
+            quantised[c++] = static_cast<uint16>(Math::Clamp<Real>(v + 0.5f, 0, ROTATION_STEPS));
+        }
+
+        // The index of the largest component goes in the top bits of the first two
+        // values and its sign in the last one, so q and -q stay distinct
+        PackedRotation p;
+        p.data[0] = quantised[0] | static_cast<uint16>((largest >> 1) << 15);
+        p.data[1] = quantised[1] | static_cast<uint16>((largest & 1) << 15);
+        p.data[2] = quantised[2] | static_cast<uint16>((q[largest] < 0 ? 1 : 0) << 15);
+        return p;
+    }
+    //-----------------------------------------------------------------------
+    Quaternion CompressedTransformKeys::unpackRotation(const PackedRotation& p)
+    {
+        const Real scale = 2 * ROTATION_RANGE / ROTATION_STEPS;
+        Real a = (p.data[0] & 0x7FFF) * scale - ROTATION_RANGE;
+        Real b = (p.data[1] & 0x7FFF) * scale - ROTATION_RANGE;
+        Real c = (p.data[2] & 0x7FFF) * scale - ROTATION_RANGE;
+        Real l = Math::Sqrt(std::max(Real(0), 1 - a * a - b * b - c * c));
+        if (p.data[2] >> 15)
+            l = -l;
+
+        switch (((p.data[0] >> 15) << 1) | (p.data[1] >> 15))
+        {
+        case 0:
+            return Quaternion(l, a, b, c);
+        case 1:
+            return Quaternion(a, l, b, c);
+        case 2:
+            return Quaternion(a, b, l, c);
+        default:
+            return Quaternion(a, b, c, l);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void CompressedTransformKeys::build(const NodeAnimationTrack* track, const Settings& settings,
+        bool sphericalRotation)
+    {
+        size_t numKeys = track->getNumKeyFrames();
+        if (numKeys == 0)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Track has no keyframes",
+                "CompressedTransformKeys::build");
+        }
+        bool shortestPath = track->getUseShortestRotationPath();
+
+        // Rotations are compared after quantisation so the error of the encoding
+        // counts towards the tolerance of the dropped keys
+        TransformKeyList keys(numKeys);
+        for (size_t i = 0; i < numKeys; ++i)
+        {
+            const TransformKeyFrame* kf = track->getNodeKeyFrame(static_cast<unsigned short>(i));
+            keys[i].time = kf->getTime();
+            keys[i].translate = kf->getTranslate();
+            keys[i].rotation = unpackRotation(packRotation(kf->getRotation()));
+            keys[i].scale = kf->getScale();
+        }
+
+        // Channels which stay within tolerance of the first key are stored once
+        uint16 constantChannels = CC_TRANSLATE | CC_ROTATION | CC_SCALE;
+        for (size_t i = 1; i < numKeys; ++i)
+        {
+            if (keys[i].translate.distance(keys[0].translate) > settings.positionTolerance)
+                constantChannels &= ~CC_TRANSLATE;
+            if (rotationError(keys[i].rotation, keys[0].rotation) > settings.rotationTolerance.valueRadians())
+                constantChannels &= ~CC_ROTATION;
+            if (keys[i].scale.distance(keys[0].scale) > settings.scaleTolerance)
+                constantChannels &= ~CC_SCALE;
+        }
+
+        // Greedily extend each segment from the last kept key for as long as the
+        // keys it spans are reproduced by interpolating its ends
+        vector<size_t>::type kept;
+        kept.push_back(0);
+        size_t anchor = 0;
+        for (size_t end = 2; end < numKeys; ++end)
+        {
+            const TransformKey& a = keys[anchor];
+            const TransformKey& b = keys[end];
+            bool valid = true;
+            for (size_t j = anchor + 1; j < end && valid; ++j)
+            {
+                const TransformKey& k = keys[j];
+                Real t = (k.time - a.time) / (b.time - a.time);
+                if (!(constantChannels & CC_TRANSLATE) &&
+                    k.translate.distance(a.translate + (b.translate - a.translate) * t) > settings.positionTolerance)
+                    valid = false;
+                else if (!(constantChannels & CC_ROTATION) &&
+                    rotationError(k.rotation, interpolateRotation(t, a.rotation, b.rotation,
+                        sphericalRotation, shortestPath)) > settings.rotationTolerance.valueRadians())
+                    valid = false;
+                else if (!(constantChannels & CC_SCALE) &&
+                    k.scale.distance(a.scale + (b.scale - a.scale) * t) > settings.scaleTolerance)
+                    valid = false;
+            }
+            if (!valid)
+            {
+                anchor = end - 1;
+                kept.push_back(anchor);
+            }
+        }
+        if (numKeys > 1)
+            kept.push_back(numKeys - 1);
+
+        _resize(kept.size(), constantChannels);
+        for (size_t i = 0; i < kept.size(); ++i)
+        {
+            const TransformKey& k = keys[kept[i]];
+            mTimes[i] = static_cast<float>(k.time);
+            if (i == 0 || !(constantChannels & CC_TRANSLATE))
+                storeVector3(&mTranslations[i * 3], k.translate);
+            if (i == 0 || !(constantChannels & CC_ROTATION))
+                mRotations[i] = packRotation(k.rotation);
+            if (i == 0 || !(constantChannels & CC_SCALE))
+                storeVector3(&mScales[i * 3], k.scale);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void CompressedTransformKeys::_resize(size_t numKeys, uint16 constantChannels)
+    {
+        mConstantChannels = constantChannels;
+        mTimes.resize(numKeys);
+        mTranslations.resize((constantChannels & CC_TRANSLATE) ? 3 : numKeys * 3);
+        mRotations.resize((constantChannels & CC_ROTATION) ? 1 : numKeys);
+        mScales.resize((constantChannels & CC_SCALE) ? 3 : numKeys * 3);
+        mCursor.store(0, std::memory_order_relaxed);
+    }
+    //-----------------------------------------------------------------------
+    Real CompressedTransformKeys::findKeys(Real timePos, Real length, size_t& key1, size_t& key2) const
+    {
+        size_t numKeys = mTimes.size();
+
+        if (timePos > length && length > 0.0f)
+            timePos = fmod(timePos, length);
+
+        // Lower bound of the time, tried from the previous result first since
+        // animations are usually sampled at increasing times
+        size_t i = mCursor.load(std::memory_order_relaxed);
+        if (i > numKeys || (i > 0 && mTimes[i - 1] >= timePos) ||
+            (i < numKeys && mTimes[i] < timePos))
+        {
+            ++i;
+            if (i > numKeys || mTimes[i - 1] >= timePos ||
+                (i < numKeys && mTimes[i] < timePos))
+            {
+                i = std::lower_bound(mTimes.begin(), mTimes.end(), timePos) - mTimes.begin();
+            }
+            mCursor.store(static_cast<uint32>(i), std::memory_order_relaxed);
+        }
+
+        Real t1, t2;
+        if (i == numKeys)
+        {
+            // There is no key after this time, wrap back to the first
+            key2 = 0;
+            t2 = length + mTimes[0];
+            key1 = numKeys - 1;
+        }
+        else
+        {
+            key2 = i;
+            t2 = mTimes[i];
+            if (i != 0 && timePos < mTimes[i])
+                --i;
+            key1 = i;
+        }
+
+        t1 = mTimes[key1];
+        if (t1 == t2)
+            return 0.0;
+        return (timePos - t1) / (t2 - t1);
+    }
+    //-----------------------------------------------------------------------
+    void CompressedTransformKeys::getInterpolatedKeyFrame(Real timePos, Real length,
+        bool sphericalRotation, bool shortestPath, TransformKeyFrame* kf) const
+    {
+        size_t k1, k2;
+        Real t = findKeys(timePos, length, k1, k2);
+
+        if (t == 0.0)
+        {
+            getKey(k1, kf);
+            return;
+        }
+
+        if (mConstantChannels & CC_ROTATION)
+            kf->setRotation(getRotation(0));
+        else
+            kf->setRotation(interpolateRotation(t, getRotation(k1), getRotation(k2),
+                sphericalRotation, shortestPath));
+
+        Vector3 base = getTranslate(k1);
+        kf->setTranslate((mConstantChannels & CC_TRANSLATE) ? base : base + ((getTranslate(k2) - base) * t));
+
+        base = getScale(k1);
+        kf->setScale((mConstantChannels & CC_SCALE) ? base : base + ((getScale(k2) - base) * t));
+    }
+    //-----------------------------------------------------------------------
+    void CompressedTransformKeys::getKey(size_t index, TransformKeyFrame* kf) const
+    {
+        kf->setTranslate(getTranslate(index));
+        kf->setRotation(getRotation(index));
+        kf->setScale(getScale(index));
+    }
+    //-----------------------------------------------------------------------
+    size_t CompressedTransformKeys::getMemoryUsage(void) const
+    {
+        return sizeof(*this) +
+            mTimes.capacity() * sizeof(float) +
+            mTranslations.capacity() * sizeof(float) +
+            mRotations.capacity() * sizeof(PackedRotation) +
+            mScales.capacity() * sizeof(float);
+    }
+    //-----------------------------------------------------------------------
+    void CompressedTransformKeys::_applyBaseTransform(const Vector3& translate,
+        const Quaternion& rotation, const Vector3& scale)
+    {
+        Quaternion invRotation = rotation.Inverse();
+        Vector3 invScale = Vector3::UNIT_SCALE / scale;
+
+        for (size_t i = 0; i < mTranslations.size(); i += 3)
+        {
+            storeVector3(&mTranslations[i], loadVector3(&mTranslations[i]) - translate);
+        }
+        for (size_t i = 0; i < mRotations.size(); ++i)
+        {
+            mRotations[i] = packRotation(invRotation * unpackRotation(mRotations[i]));
+        }
+        for (size_t i = 0; i < mScales.size(); i += 3)
+        {
+            storeVector3(&mScales[i], loadVector3(&mScales[i]) * invScale);
+        }
+    }
+}
@@ -27,6 +27,20 @@ THE SOFTWARE.
 */
 #include "OgreStableHeaders.h"
 
+#include <sys/stat.h>
+
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32 || OGRE_PLATFORM == OGRE_PLATFORM_WINRT
+#  define WIN32_LEAN_AND_MEAN
+#  if !defined(NOMINMAX) && defined(_MSC_VER)
+#   define NOMINMAX // required to stop windows.h messing up std::min
+#  endif
+#  include <windows.h>
+#else
+#  include <sys/mman.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
 namespace Ogre {
 
     //-----------------------------------------------------------------------
@@ -467,6 +481,111 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32 || OGRE_PLATFORM == OGRE_PLATFORM_WINRT
+    MappedDataStream::MappedDataStream(const String& name, const String& path)
+        : MemoryDataStream(name, 0, 0, false, true), mMapping(0)
+    {
+        std::wstring wpath(path.size(), 0);
+        wpath.resize(MultiByteToWideChar(CP_UTF8, 0, path.c_str(), (int)path.size(), &wpath[0], (int)wpath.size()));
+#if OGRE_PLATFORM == OGRE_PLATFORM_WINRT
+        HANDLE file = CreateFile2(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, NULL);
+#else
+        HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, NULL);
+#endif
+        LARGE_INTEGER fileSize;
+        if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize) ||
+            static_cast<uint64>(fileSize.QuadPart) > std::numeric_limits<size_t>::max())
+        {
+            if (file != INVALID_HANDLE_VALUE)
+                CloseHandle(file);
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "Cannot open file: " + path,
+                        "MappedDataStream::MappedDataStream");
+        }
+
+        mSize = static_cast<size_t>(fileSize.QuadPart);
+        if (mSize > 0)
+        {
+            // the view keeps the mapping alive, the file handle is not needed any more
+#if OGRE_PLATFORM == OGRE_PLATFORM_WINRT
+            mMapping = CreateFileMappingFromApp(file, NULL, PAGE_READONLY, 0, NULL);
+            void* view = mMapping ? MapViewOfFileFromApp(mMapping, FILE_MAP_READ, 0, 0) : NULL;
+#else
+            mMapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+            void* view = mMapping ? MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+#endif
+            CloseHandle(file);
+            if (!view)
+            {
+                if (mMapping)
+                    CloseHandle(mMapping);
+                mMapping = 0;
+                OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "Cannot map file: " + path,
+                            "MappedDataStream::MappedDataStream");
+            }
+            mData = mPos = static_cast<uchar*>(view);
+        }
+        else
+            CloseHandle(file);
+        mEnd = mData + mSize;
+    }
+    //-----------------------------------------------------------------------
+    void MappedDataStream::close(void)
+    {
+        if (mData)
+            UnmapViewOfFile(mData);
+        if (mMapping)
+            CloseHandle(mMapping);
+        mMapping = 0;
+        mData = mPos = mEnd = 0;
+    }
+#else
+    MappedDataStream::MappedDataStream(const String& name, const String& path)
+        : MemoryDataStream(name, 0, 0, false, true)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        struct stat tagStat;
+        if (fd == -1 || fstat(fd, &tagStat) != 0 ||
+            static_cast<uint64>(tagStat.st_size) > std::numeric_limits<size_t>::max())
+        {
+            if (fd != -1)
+                ::close(fd);
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "Cannot open file: " + path,
+                        "MappedDataStream::MappedDataStream");
+        }
+
+        mSize = static_cast<size_t>(tagStat.st_size);
+        if (mSize > 0)
+        {
+            // the mapping stays valid after the descriptor is closed
+            void* view = mmap(0, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (view == MAP_FAILED)
+            {
+                OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "Cannot map file: " + path,
+                            "MappedDataStream::MappedDataStream");
+            }
+            mData = mPos = static_cast<uchar*>(view);
+        }
+        else
+            ::close(fd);
+        mEnd = mData + mSize;
+    }
+    //-----------------------------------------------------------------------
+    void MappedDataStream::close(void)
+    {
+        if (mData)
+            munmap(mData, mSize);
+        mData = mPos = mEnd = 0;
+    }
+#endif
+    //-----------------------------------------------------------------------
+    MappedDataStream::~MappedDataStream()
+    {
+        close();
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
     FileStreamDataStream::FileStreamDataStream(std::ifstream* s, bool freeOnClose)
         : DataStream(), mInStream(s), mFStreamRO(s), mFStream(0), mFreeOnClose(freeOnClose)
     {
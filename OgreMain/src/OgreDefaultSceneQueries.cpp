@@ -26,8 +26,152 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "OgreStableHeaders.h"
+#include "OgreSceneQueryBroadPhase.h"
 
 namespace Ogre {
+    namespace {
+        inline bool passesMasks(const MovableObject* a, uint32 typeMask, uint32 queryMask)
+        {
+            return (a->getTypeFlags() & typeMask) && (a->getQueryFlags() & queryMask) &&
+                a->isInScene();
+        }
+
+        /// Collects the pairs of objects passing the masks whose boxes intersect
+        struct IntersectionVisitor
+        {
+            uint32 typeMask;
+            uint32 queryMask;
+            vector<SceneQueryMovableObjectPair>::type& pairs;
+
+            bool visit(MovableObject* a, MovableObject* b)
+            {
+                if (passesMasks(a, typeMask, queryMask) && passesMasks(b, typeMask, queryMask) &&
+                    a->getWorldBoundingBox().intersects(b->getWorldBoundingBox()))
+                {
+                    // earlier object first, as when iterating the object collections
+                    if (isEarlier(b, a))
+                        std::swap(a, b);
+                    pairs.push_back(SceneQueryMovableObjectPair(a, b));
+                }
+                return true;
+            }
+
+            static bool isEarlier(const MovableObject* a, const MovableObject* b)
+            {
+                int type = a->getMovableType().compare(b->getMovableType());
+                return type < 0 || (type == 0 && a->getName() < b->getName());
+            }
+        };
+
+        struct IntersectionOrder
+        {
+            bool operator()(const SceneQueryMovableObjectPair& a, const SceneQueryMovableObjectPair& b) const
+            {
+                if (a.first != b.first)
+                    return IntersectionVisitor::isEarlier(a.first, b.first);
+                return IntersectionVisitor::isEarlier(a.second, b.second);
+            }
+        };
+
+        struct AxisAlignedBoxQueryVisitor
+        {
+            const AxisAlignedBox& box;
+            uint32 typeMask;
+            uint32 queryMask;
+            SceneQueryListener* listener;
+
+            bool overlaps(const Vector3& min, const Vector3& max) const
+            {
+                return box.intersects(AxisAlignedBox(min, max));
+            }
+            bool visit(MovableObject* a)
+            {
+                if (passesMasks(a, typeMask, queryMask) && box.intersects(a->getWorldBoundingBox()))
+                    return listener->queryResult(a);
+                return true;
+            }
+        };
+
+        struct RayQueryVisitor
+        {
+            const Ray& ray;
+            uint32 typeMask;
+            uint32 queryMask;
+            RaySceneQueryListener* listener;
+
+            bool overlaps(const Vector3& min, const Vector3& max) const
+            {
+                return ray.intersects(AxisAlignedBox(min, max)).first;
+            }
+            bool visit(MovableObject* a)
+            {
+                if (passesMasks(a, typeMask, queryMask))
+                {
+                    // Do ray / box test
+                    std::pair<bool, Real> result = ray.intersects(a->getWorldBoundingBox());
+                    if (result.first)
+                        return listener->queryResult(a, result.second);
+                }
+                return true;
+            }
+        };
+
+        struct SphereQueryVisitor
+        {
+            const Sphere& sphere;
+            uint32 typeMask;
+            uint32 queryMask;
+            SceneQueryListener* listener;
+
+            bool overlaps(const Vector3& min, const Vector3& max) const
+            {
+                return sphere.intersects(AxisAlignedBox(min, max));
+            }
+            bool visit(MovableObject* a)
+            {
+                if (passesMasks(a, typeMask, queryMask))
+                {
+                    // Do sphere / sphere test
+                    Sphere testSphere(a->getParentNode()->_getDerivedPosition(), a->getBoundingRadius());
+                    if (sphere.intersects(testSphere))
+                        return listener->queryResult(a);
+                }
+                return true;
+            }
+        };
+
+        struct PlaneBoundedVolumeListQueryVisitor
+        {
+            const PlaneBoundedVolumeList& volumes;
+            uint32 typeMask;
+            uint32 queryMask;
+            SceneQueryListener* listener;
+
+            bool overlaps(const Vector3& min, const Vector3& max) const
+            {
+                AxisAlignedBox box(min, max);
+                for (PlaneBoundedVolumeList::const_iterator pi = volumes.begin(); pi != volumes.end(); ++pi)
+                {
+                    if (pi->intersects(box))
+                        return true;
+                }
+                return false;
+            }
+            bool visit(MovableObject* a)
+            {
+                if (!passesMasks(a, typeMask, queryMask))
+                    return true;
+
+                for (PlaneBoundedVolumeList::const_iterator pi = volumes.begin(); pi != volumes.end(); ++pi)
+                {
+                    // Do AABB / plane volume test, report once
+                    if (pi->intersects(a->getWorldBoundingBox()))
+                        return listener->queryResult(a);
+                }
+                return true;
+            }
+        };
+    }
     //---------------------------------------------------------------------
     DefaultIntersectionSceneQuery::DefaultIntersectionSceneQuery(SceneManager* creator)
     : IntersectionSceneQuery(creator)
@@ -42,80 +186,18 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultIntersectionSceneQuery::execute(IntersectionSceneQueryListener* listener)
     {
-        // Iterate over all movable types
-        Root::MovableObjectFactoryIterator factIt = 
-            Root::getSingleton().getMovableObjectFactoryIterator();
-        while(factIt.hasMoreElements())
-        {
-            SceneManager::MovableObjectIterator objItA = 
-                mParentSceneMgr->getMovableObjectIterator(
-                    factIt.getNext()->getType());
-            while (objItA.hasMoreElements())
-            {
-                MovableObject* a = objItA.getNext();
-                // skip entire section if type doesn't match
-                if (!(a->getTypeFlags() & mQueryTypeMask))
-                    break;
-
-                // Skip if a does not pass the mask
-                if (!(a->getQueryFlags() & mQueryMask) ||
-                    !a->isInScene())
-                    continue;
-
-                // Check against later objects in the same group
-                SceneManager::MovableObjectIterator objItB = objItA;
-                while (objItB.hasMoreElements())
-                {
-                    MovableObject* b = objItB.getNext();
-
-                    // Apply mask to b (both must pass)
-                    if ((b->getQueryFlags() & mQueryMask) && 
-                        b->isInScene())
-                    {
-                        const AxisAlignedBox& box1 = a->getWorldBoundingBox();
-                        const AxisAlignedBox& box2 = b->getWorldBoundingBox();
-
-                        if (box1.intersects(box2))
-                        {
-                            if (!listener->queryResult(a, b)) return;
-                        }
-                    }
-                }
-                // Check  against later groups
-                Root::MovableObjectFactoryIterator factItLater = factIt;
-                while (factItLater.hasMoreElements())
-                {
-                    SceneManager::MovableObjectIterator objItC = 
-                        mParentSceneMgr->getMovableObjectIterator(
-                            factItLater.getNext()->getType());
-                    while (objItC.hasMoreElements())
-                    {
-                        MovableObject* c = objItC.getNext();
-                        // skip entire section if type doesn't match
-                        if (!(c->getTypeFlags() & mQueryTypeMask))
-                            break;
-
-                        // Apply mask to c (both must pass)
-                        if ((c->getQueryFlags() & mQueryMask) &&
-                            c->isInScene())
-                        {
-                            const AxisAlignedBox& box1 = a->getWorldBoundingBox();
-                            const AxisAlignedBox& box2 = c->getWorldBoundingBox();
-
-                            if (box1.intersects(box2))
-                            {
-                                if (!listener->queryResult(a, c)) return;
-                            }
-                        }
-                    }
-
-                }
-
-            }
-
+        // The broad-phase keeps the overlapping pairs between scene graph updates
+        vector<SceneQueryMovableObjectPair>::type pairs;
+        IntersectionVisitor visitor = {mQueryTypeMask, mQueryMask, pairs};
+        mParentSceneMgr->_getSceneQueryBroadPhase()->traversePairs(visitor);
 
+        // Report in the order the pairs were found in when testing every object
+        std::sort(pairs.begin(), pairs.end(), IntersectionOrder());
+        for (vector<SceneQueryMovableObjectPair>::type::const_iterator i = pairs.begin(); i != pairs.end(); ++i)
+        {
+            if (!listener->queryResult(i->first, i->second))
+                return;
         }
-
     }
     //---------------------------------------------------------------------
     DefaultAxisAlignedBoxSceneQuery::
@@ -132,29 +214,11 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultAxisAlignedBoxSceneQuery::execute(SceneQueryListener* listener)
     {
-        // Iterate over all movable types
-        Root::MovableObjectFactoryIterator factIt = 
-            Root::getSingleton().getMovableObjectFactoryIterator();
-        while(factIt.hasMoreElements())
-        {
-            SceneManager::MovableObjectIterator objItA = 
-                mParentSceneMgr->getMovableObjectIterator(
-                factIt.getNext()->getType());
-            while (objItA.hasMoreElements())
-            {
-                MovableObject* a = objItA.getNext();
-                // skip whole group if type doesn't match
-                if (!(a->getTypeFlags() & mQueryTypeMask))
-                    break;
+        SceneQueryBroadPhase* broadPhase = mParentSceneMgr->_getSceneQueryBroadPhase();
+        broadPhase->update();
 
-                if ((a->getQueryFlags() & mQueryMask) && 
-                    a->isInScene() &&
-                    mAABB.intersects(a->getWorldBoundingBox()))
-                {
-                    if (!listener->queryResult(a)) return;
-                }
-            }
-        }
+        AxisAlignedBoxQueryVisitor visitor = {mAABB, mQueryTypeMask, mQueryMask, listener};
+        broadPhase->traverse(visitor);
     }
     //---------------------------------------------------------------------
     DefaultRaySceneQuery::
@@ -170,42 +234,13 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultRaySceneQuery::execute(RaySceneQueryListener* listener)
     {
-        // Note that because we have no scene partitioning, we actually
-        // perform a complete scene search even if restricted results are
-        // requested; smarter scene manager queries can utilise the paritioning 
-        // of the scene in order to reduce the number of intersection tests 
-        // required to fulfil the query
-
-        // Iterate over all movable types
-        Root::MovableObjectFactoryIterator factIt = 
-            Root::getSingleton().getMovableObjectFactoryIterator();
-        while(factIt.hasMoreElements())
-        {
-            SceneManager::MovableObjectIterator objItA = 
-                mParentSceneMgr->getMovableObjectIterator(
-                factIt.getNext()->getType());
-            while (objItA.hasMoreElements())
-            {
-                MovableObject* a = objItA.getNext();
-                // skip whole group if type doesn't match
-                if (!(a->getTypeFlags() & mQueryTypeMask))
-                    break;
-
-                if( (a->getQueryFlags() & mQueryMask) &&
-                    a->isInScene())
-                {
-                    // Do ray / box test
-                    std::pair<bool, Real> result =
-                        mRay.intersects(a->getWorldBoundingBox());
-
-                    if (result.first)
-                    {
-                        if (!listener->queryResult(a, result.second)) return;
-                    }
-                }
-            }
-        }
+        // The broad-phase only visits objects whose bounds the ray may hit, the
+        // results are in no particular order unless sorting by distance is enabled
+        SceneQueryBroadPhase* broadPhase = mParentSceneMgr->_getSceneQueryBroadPhase();
+        broadPhase->update();
 
+        RayQueryVisitor visitor = {mRay, mQueryTypeMask, mQueryMask, listener};
+        broadPhase->traverse(visitor);
     }
     //---------------------------------------------------------------------
     DefaultSphereSceneQuery::
@@ -221,36 +256,11 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultSphereSceneQuery::execute(SceneQueryListener* listener)
     {
-        Sphere testSphere;
+        SceneQueryBroadPhase* broadPhase = mParentSceneMgr->_getSceneQueryBroadPhase();
+        broadPhase->update();
 
-        // Iterate over all movable types
-        Root::MovableObjectFactoryIterator factIt = 
-            Root::getSingleton().getMovableObjectFactoryIterator();
-        while(factIt.hasMoreElements())
-        {
-            SceneManager::MovableObjectIterator objItA = 
-                mParentSceneMgr->getMovableObjectIterator(
-                factIt.getNext()->getType());
-            while (objItA.hasMoreElements())
-            {
-                MovableObject* a = objItA.getNext();
-                // skip whole group if type doesn't match
-                if (!(a->getTypeFlags() & mQueryTypeMask))
-                    break;
-                // Skip unattached
-                if (!a->isInScene() || 
-                    !(a->getQueryFlags() & mQueryMask))
-                    continue;
-
-                // Do sphere / sphere test
-                testSphere.setCenter(a->getParentNode()->_getDerivedPosition());
-                testSphere.setRadius(a->getBoundingRadius());
-                if (mSphere.intersects(testSphere))
-                {
-                    if (!listener->queryResult(a)) return;
-                }
-            }
-        }
+        SphereQueryVisitor visitor = {mSphere, mQueryTypeMask, mQueryMask, listener};
+        broadPhase->traverse(visitor);
     }
     //---------------------------------------------------------------------
     DefaultPlaneBoundedVolumeListSceneQuery::
@@ -267,36 +277,10 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultPlaneBoundedVolumeListSceneQuery::execute(SceneQueryListener* listener)
     {
-        // Iterate over all movable types
-        Root::MovableObjectFactoryIterator factIt = 
-            Root::getSingleton().getMovableObjectFactoryIterator();
-        while(factIt.hasMoreElements())
-        {
-            SceneManager::MovableObjectIterator objItA = 
-                mParentSceneMgr->getMovableObjectIterator(
-                factIt.getNext()->getType());
-            while (objItA.hasMoreElements())
-            {
-                MovableObject* a = objItA.getNext();
-                // skip whole group if type doesn't match
-                if (!(a->getTypeFlags() & mQueryTypeMask))
-                    break;
+        SceneQueryBroadPhase* broadPhase = mParentSceneMgr->_getSceneQueryBroadPhase();
+        broadPhase->update();
 
-                PlaneBoundedVolumeList::iterator pi, piend;
-                piend = mVolumes.end();
-                for (pi = mVolumes.begin(); pi != piend; ++pi)
-                {
-                    PlaneBoundedVolume& vol = *pi;
-                    // Do AABB / plane volume test
-                    if ((a->getQueryFlags() & mQueryMask) && 
-                        a->isInScene() && 
-                        vol.intersects(a->getWorldBoundingBox()))
-                    {
-                        if (!listener->queryResult(a)) return;
-                        break;
-                    }
-                }
-            }
-        }
+        PlaneBoundedVolumeListQueryVisitor visitor = {mVolumes, mQueryTypeMask, mQueryMask, listener};
+        broadPhase->traverse(visitor);
     }
 }
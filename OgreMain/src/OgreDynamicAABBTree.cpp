@@ -0,0 +1,395 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreDynamicAABBTree.h"
+
+namespace Ogre {
+
+    namespace {
+        inline Real surfaceArea(const Vector3& min, const Vector3& max)
+        {
+            Vector3 d = max - min;
+            return 2 * (d.x * d.y + d.y * d.z + d.z * d.x);
+        }
+
+        inline Real mergedSurfaceArea(const Vector3& minA, const Vector3& maxA,
+                                      const Vector3& minB, const Vector3& maxB)
+        {
+            Vector3 min = minA, max = maxA;
+            min.makeFloor(minB);
+            max.makeCeil(maxB);
+            return surfaceArea(min, max);
+        }
+    }
+    //-----------------------------------------------------------------------
+    DynamicAABBTree::DynamicAABBTree(Real margin)
+        : mRoot(NULL_NODE), mFreeList(NULL_NODE), mNumProxies(0), mMargin(margin)
+    {
+    }
+    //-----------------------------------------------------------------------
+    uint32 DynamicAABBTree::createProxy(const AxisAlignedBox& box, void* userData)
+    {
+        assert(box.isFinite() && "only finite boxes can be inserted");
+
+        uint32 proxy = allocateNode();
+        TreeNode& node = mNodes[proxy];
+        setFatBox(node, box);
+        node.userData = userData;
+        node.height = 0;
+
+        insertLeaf(proxy);
+        ++mNumProxies;
+        return proxy;
+    }
+    //-----------------------------------------------------------------------
+    void DynamicAABBTree::destroyProxy(uint32 proxy)
+    {
+        assert(proxy < mNodes.size() && mNodes[proxy].isLeaf() && mNodes[proxy].height == 0);
+
+        removeLeaf(proxy);
+        freeNode(proxy);
+        --mNumProxies;
+    }
+    //-----------------------------------------------------------------------
+    bool DynamicAABBTree::moveProxy(uint32 proxy, const AxisAlignedBox& box)
+    {
+        assert(proxy < mNodes.size() && mNodes[proxy].isLeaf() && mNodes[proxy].height == 0);
+        assert(box.isFinite() && "only finite boxes can be inserted");
+
+        TreeNode& node = mNodes[proxy];
+        const Vector3& min = box.getMinimum();
+        const Vector3& max = box.getMaximum();
+        if (node.min.x <= min.x && node.min.y <= min.y && node.min.z <= min.z &&
+            max.x <= node.max.x && max.y <= node.max.y && max.z <= node.max.z)
+            return false;
+
+        removeLeaf(proxy);
+        setFatBox(mNodes[proxy], box);
+        insertLeaf(proxy);
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void DynamicAABBTree::clear()
+    {
+        mNodes.clear();
+        mRoot = NULL_NODE;
+        mFreeList = NULL_NODE;
+        mNumProxies = 0;
+    }
+    //-----------------------------------------------------------------------
+    AxisAlignedBox DynamicAABBTree::getFatBox(uint32 proxy) const
+    {
+        return AxisAlignedBox(mNodes[proxy].min, mNodes[proxy].max);
+    }
+    //-----------------------------------------------------------------------
+    void DynamicAABBTree::setFatBox(TreeNode& node, const AxisAlignedBox& box) const
+    {
+        Vector3 margin = box.getSize() * mMargin;
+        node.min = box.getMinimum() - margin;
+        node.max = box.getMaximum() + margin;
+    }
+    //-----------------------------------------------------------------------
+    uint32 DynamicAABBTree::allocateNode()
+    {
+        uint32 index;
+        if (mFreeList == NULL_NODE)
+        {
+            index = static_cast<uint32>(mNodes.size());
+            mNodes.push_back(TreeNode());
+        }
+        else
+        {
+            index = mFreeList;
+            mFreeList = mNodes[index].parent;
+        }
+
+        TreeNode& node = mNodes[index];
+        node.userData = 0;
+        node.parent = NULL_NODE;
+        node.child1 = NULL_NODE;
+        node.child2 = NULL_NODE;
+        node.height = 0;
+        return index;
+    }
+    //-----------------------------------------------------------------------
+    void DynamicAABBTree::freeNode(uint32 index)
+    {
+        TreeNode& node = mNodes[index];
+        node.parent = mFreeList;
+        node.height = -1;
+        mFreeList = index;
+    }
+    //-----------------------------------------------------------------------
+    void DynamicAABBTree::insertLeaf(uint32 leaf)
+    {
+        if (mRoot == NULL_NODE)
+        {
+            mRoot = leaf;
+            mNodes[leaf].parent = NULL_NODE;
+            return;
+        }
+
+        // Descend to the sibling which increases the total surface area least
+        const Vector3 leafMin = mNodes[leaf].min;
+        const Vector3 leafMax = mNodes[leaf].max;
+        uint32 index = mRoot;
+        while (!mNodes[index].isLeaf())
+        {
+            const TreeNode& node = mNodes[index];
+            const TreeNode& child1 = mNodes[node.child1];
+            const TreeNode& child2 = mNodes[node.child2];
+
+            Real area = surfaceArea(node.min, node.max);
+            Real combinedArea = mergedSurfaceArea(node.min, node.max, leafMin, leafMax);
+
+            // cost of pairing the leaf with this node
+            Real cost = 2 * combinedArea;
+            // minimum cost of pushing the leaf further down
+            Real inheritanceCost = 2 * (combinedArea - area);
+
+            Real cost1 = mergedSurfaceArea(child1.min, child1.max, leafMin, leafMax) + inheritanceCost;
+            if (!child1.isLeaf())
+                cost1 -= surfaceArea(child1.min, child1.max);
+            Real cost2 = mergedSurfaceArea(child2.min, child2.max, leafMin, leafMax) + inheritanceCost;
+            if (!child2.isLeaf())
+                cost2 -= surfaceArea(child2.min, child2.max);
+
+            if (cost < cost1 && cost < cost2)
+                break;
+
+            index = cost1 < cost2 ? node.child1 : node.child2;
+        }
+
+        // Replace the sibling by a new parent of sibling and leaf
+        uint32 sibling = index;
+        uint32 oldParent = mNodes[sibling].parent;
+        uint32 newParent = allocateNode();
+        {
+            TreeNode& parent = mNodes[newParent];
+            const TreeNode& siblingNode = mNodes[sibling];
+            parent.parent = oldParent;
+            parent.min = siblingNode.min;
+            parent.min.makeFloor(leafMin);
+            parent.max = siblingNode.max;
+            parent.max.makeCeil(leafMax);
+            parent.height = siblingNode.height + 1;
+            parent.child1 = sibling;
+            parent.child2 = leaf;
+        }
+
+        if (oldParent != NULL_NODE)
+        {
+            if (mNodes[oldParent].child1 == sibling)
+                mNodes[oldParent].child1 = newParent;
+            else
+                mNodes[oldParent].child2 = newParent;
+        }
+        else
+        {
+            mRoot = newParent;
+        }
+        mNodes[sibling].parent = newParent;
+        mNodes[leaf].parent = newParent;
+
+        // Walk back up, rebalancing and refitting the ancestors
+        index = mNodes[leaf].parent;
+        while (index != NULL_NODE)
+        {
+            index = balance(index);
+
+            TreeNode& node = mNodes[index];
+            const TreeNode& child1 = mNodes[node.child1];
+            const TreeNode& child2 = mNodes[node.child2];
+            node.height = 1 + std::max(child1.height, child2.height);
+            node.min = child1.min;
+            node.min.makeFloor(child2.min);
+            node.max = child1.max;
+            node.max.makeCeil(child2.max);
+
+            index = node.parent;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void DynamicAABBTree::removeLeaf(uint32 leaf)
+    {
+        if (leaf == mRoot)
+        {
+            mRoot = NULL_NODE;
+            return;
+        }
+
+        uint32 parent = mNodes[leaf].parent;
+        uint32 grandParent = mNodes[parent].parent;
+        uint32 sibling = mNodes[parent].child1 == leaf ? mNodes[parent].child2 : mNodes[parent].child1;
+
+        if (grandParent == NULL_NODE)
+        {
+            mRoot = sibling;
+            mNodes[sibling].parent = NULL_NODE;
+            freeNode(parent);
+            return;
+        }
+
+        // Let the sibling take the place of the parent
+        if (mNodes[grandParent].child1 == parent)
+            mNodes[grandParent].child1 = sibling;
+        else
+            mNodes[grandParent].child2 = sibling;
+        mNodes[sibling].parent = grandParent;
+        freeNode(parent);
+
+        uint32 index = grandParent;
+        while (index != NULL_NODE)
+        {
+            index = balance(index);
+
+            TreeNode& node = mNodes[index];
+            const TreeNode& child1 = mNodes[node.child1];
+            const TreeNode& child2 = mNodes[node.child2];
+            node.height = 1 + std::max(child1.height, child2.height);
+            node.min = child1.min;
+            node.min.makeFloor(child2.min);
+            node.max = child1.max;
+            node.max.makeCeil(child2.max);
+
+            index = node.parent;
+        }
+    }
+    //-----------------------------------------------------------------------
+    uint32 DynamicAABBTree::balance(uint32 iA)
+    {
+        TreeNode& A = mNodes[iA];
+        if (A.isLeaf() || A.height < 2)
+            return iA;
+
+        uint32 iB = A.child1;
+        uint32 iC = A.child2;
+        TreeNode& B = mNodes[iB];
+        TreeNode& C = mNodes[iC];
+
+        int32 imbalance = C.height - B.height;
+
+        if (imbalance > 1)
+        {
+            // Rotate C up
+            uint32 iF = C.child1;
+            uint32 iG = C.child2;
+            TreeNode& F = mNodes[iF];
+            TreeNode& G = mNodes[iG];
+
+            C.child1 = iA;
+            C.parent = A.parent;
+            A.parent = iC;
+
+            if (C.parent != NULL_NODE)
+            {
+                if (mNodes[C.parent].child1 == iA)
+                    mNodes[C.parent].child1 = iC;
+                else
+                    mNodes[C.parent].child2 = iC;
+            }
+            else
+            {
+                mRoot = iC;
+            }
+
+            // Keep the taller grandchild under C
+            TreeNode& moved = F.height > G.height ? G : F;
+            uint32 iMoved = F.height > G.height ? iG : iF;
+            TreeNode& kept = F.height > G.height ? F : G;
+            uint32 iKept = F.height > G.height ? iF : iG;
+
+            C.child2 = iKept;
+            A.child2 = iMoved;
+            moved.parent = iA;
+
+            A.min = B.min;
+            A.min.makeFloor(moved.min);
+            A.max = B.max;
+            A.max.makeCeil(moved.max);
+            C.min = A.min;
+            C.min.makeFloor(kept.min);
+            C.max = A.max;
+            C.max.makeCeil(kept.max);
+
+            A.height = 1 + std::max(B.height, moved.height);
+            C.height = 1 + std::max(A.height, kept.height);
+            return iC;
+        }
+
+        if (imbalance < -1)
+        {
+            // Rotate B up
+            uint32 iD = B.child1;
+            uint32 iE = B.child2;
+            TreeNode& D = mNodes[iD];
+            TreeNode& E = mNodes[iE];
+
+            B.child1 = iA;
+            B.parent = A.parent;
+            A.parent = iB;
+
+            if (B.parent != NULL_NODE)
+            {
+                if (mNodes[B.parent].child1 == iA)
+                    mNodes[B.parent].child1 = iB;
+                else
+                    mNodes[B.parent].child2 = iB;
+            }
+            else
+            {
+                mRoot = iB;
+            }
+
+            // Keep the taller grandchild under B
+            TreeNode& moved = D.height > E.height ? E : D;
+            uint32 iMoved = D.height > E.height ? iE : iD;
+            TreeNode& kept = D.height > E.height ? D : E;
+            uint32 iKept = D.height > E.height ? iD : iE;
+
+            B.child2 = iKept;
+            A.child1 = iMoved;
+            moved.parent = iA;
+
+            A.min = C.min;
+            A.min.makeFloor(moved.min);
+            A.max = C.max;
+            A.max.makeCeil(moved.max);
+            B.min = A.min;
+            B.min.makeFloor(kept.min);
+            B.max = A.max;
+            B.max.makeCeil(kept.max);
+
+            A.height = 1 + std::max(C.height, moved.height);
+            B.height = 1 + std::max(A.height, kept.height);
+            return iB;
+        }
+
+        return iA;
+    }
+}
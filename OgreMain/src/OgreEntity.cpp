@@ -33,6 +33,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreOptimisedUtil.h"
 #include "OgreLodStrategy.h"
 #include "OgreLodListener.h"
+#include "OgreAnimationPrePass.h"
 
 
 namespace Ogre {
@@ -53,6 +54,7 @@ namespace Ogre {
           mUpdateBoundingBoxFromSkeleton(false),
           mVertexProgramInUse(false),
           mInitialised(false),
+          mAnimationPrePassQueued(false),
           mHardwarePoseCount(0),
           mNumBoneMatrices(0),
           mBoneWorldMatrices(NULL),
@@ -240,15 +242,13 @@ namespace Ogre {
                 else if (mSharedSkeletonEntities->empty())
                 {
                     OGRE_DELETE_T(mSharedSkeletonEntities, EntitySet, MEMCATEGORY_ANIMATION); mSharedSkeletonEntities = 0;
-                    // using OGRE_FREE since unsigned long is not a destructor
-                    OGRE_FREE(mFrameBonesLastUpdated, MEMCATEGORY_ANIMATION); mFrameBonesLastUpdated = 0;
+                    OGRE_DELETE_T(mFrameBonesLastUpdated, unsigned long, MEMCATEGORY_ANIMATION); mFrameBonesLastUpdated = 0;
                     OGRE_DELETE mSkeletonInstance; mSkeletonInstance = 0;
                     OGRE_FREE_SIMD(mBoneMatrices, MEMCATEGORY_ANIMATION); mBoneMatrices = 0;
                     OGRE_DELETE mAnimationState; mAnimationState = 0;
                 }
             } else {
-                // using OGRE_FREE since unsigned long is not a destructor
-                OGRE_FREE(mFrameBonesLastUpdated, MEMCATEGORY_ANIMATION); mFrameBonesLastUpdated = 0;
+                OGRE_DELETE_T(mFrameBonesLastUpdated, unsigned long, MEMCATEGORY_ANIMATION); mFrameBonesLastUpdated = 0;
                 OGRE_DELETE mSkeletonInstance; mSkeletonInstance = 0;
                 OGRE_FREE_SIMD(mBoneMatrices, MEMCATEGORY_ANIMATION); mBoneMatrices = 0;
                 OGRE_DELETE mAnimationState; mAnimationState = 0;
@@ -701,7 +701,19 @@ namespace Ogre {
         // update the animation
         if (displayEntity->hasSkeleton() || displayEntity->hasVertexAnimation())
         {
-            displayEntity->updateAnimation();
+            // Skeletal animation without dependants can be deferred to the pre-pass,
+            // which updates all the visible entities on the ThreadPool
+            AnimationPrePass* prePass = mManager ? mManager->_getAnimationPrePass() : 0;
+            if (prePass && prePass->isCollecting() && displayEntity == this &&
+                mChildObjectList.empty() && !hasVertexAnimation() &&
+                !mSkeletonInstance->_hasActiveTagPoints())
+            {
+                prePass->_addEntity(this);
+            }
+            else
+            {
+                displayEntity->updateAnimation();
+            }
 
             //--- pass this point,  we are sure that the transformation matrix of each bone and tagPoint have been updated
             ChildObjectList::iterator child_itr = mChildObjectList.begin();
@@ -831,32 +843,51 @@ namespace Ogre {
         if (!mInitialised)
             return;
 
+        AnimationUpdate update;
+        evaluateAnimationUpdate(update, hasSkeleton() && getSkeleton()->getManualBonesDirty());
+        applyAnimationUpdate(update, 0);
+    }
+    //-----------------------------------------------------------------------
+    void Entity::evaluateAnimationUpdate(AnimationUpdate& update, bool manualBonesDirty)
+    {
         Root& root = Root::getSingleton();
         bool hwAnimation = isHardwareAnimationEnabled();
-        bool isNeedUpdateHardwareAnim = hwAnimation && !mCurrentHWAnimationState;
+        update.hwAnimation = hwAnimation;
+        update.isNeedUpdateHardwareAnim = hwAnimation && !mCurrentHWAnimationState;
         bool forcedSwAnimation = getSoftwareAnimationRequests()>0;
         bool forcedNormals = getSoftwareAnimationNormalsRequests()>0;
-        bool stencilShadows = false;
+        update.stencilShadows = false;
         if (getCastShadows() && hasEdgeList() && root._getCurrentSceneManager())
-            stencilShadows =  root._getCurrentSceneManager()->isShadowTechniqueStencilBased();
-        bool softwareAnimation = !hwAnimation || stencilShadows || forcedSwAnimation;
+            update.stencilShadows =  root._getCurrentSceneManager()->isShadowTechniqueStencilBased();
+        bool softwareAnimation = !hwAnimation || update.stencilShadows || forcedSwAnimation;
+        update.softwareAnimation = softwareAnimation;
         // Blend normals in s/w only if we're not using h/w animation,
         // since shadows only require positions
-        bool blendNormals = !hwAnimation || forcedNormals;
+        update.blendNormals = !hwAnimation || forcedNormals;
         // Animation dirty if animation state modified or manual bones modified
-        bool animationDirty =
+        update.animationDirty =
             (mFrameAnimationLastUpdated != mAnimationState->getDirtyFrameNumber()) ||
-            (hasSkeleton() && getSkeleton()->getManualBonesDirty());
-        
-        //update the current hardware animation state
-        mCurrentHWAnimationState = hwAnimation;
+            manualBonesDirty;
 
         // We only do these tasks if animation is dirty
         // Or, if we're using a skeleton and manual bones have been moved
         // Or, if we're using software animation and temp buffers are unbound
-        if (animationDirty ||
+        update.applyAnimation = update.animationDirty ||
             (softwareAnimation && hasVertexAnimation() && !tempVertexAnimBuffersBound()) ||
-            (softwareAnimation && hasSkeleton() && !tempSkelAnimBuffersBound(blendNormals)))
+            (softwareAnimation && hasSkeleton() && !tempSkelAnimBuffersBound(update.blendNormals));
+
+        //update the current hardware animation state
+        mCurrentHWAnimationState = hwAnimation;
+    }
+    //-----------------------------------------------------------------------
+    void Entity::applyAnimationUpdate(const AnimationUpdate& update, AnimationPrePass* prePass)
+    {
+        bool hwAnimation = update.hwAnimation;
+        bool stencilShadows = update.stencilShadows;
+        bool softwareAnimation = update.softwareAnimation;
+        bool blendNormals = update.blendNormals;
+
+        if (update.applyAnimation)
         {
             if (hasVertexAnimation())
             {
@@ -918,12 +949,17 @@ namespace Ogre {
                         Mesh::prepareMatricesForVertexBlend(blendMatrices,
                                                             mBoneMatrices, mMesh->sharedBlendIndexToBoneIndexMap);
                         // Blend, taking source from either mesh data or morph data
-                        Mesh::softwareVertexBlend(
+                        const VertexData* sourceData =
                             (mMesh->getSharedVertexDataAnimationType() != VAT_NONE) ?
-                            mSoftwareVertexAnimVertexData : mMesh->sharedVertexData,
-                            mSkelAnimVertexData,
-                            blendMatrices, mMesh->sharedBlendIndexToBoneIndexMap.size(),
-                            blendNormals);
+                            mSoftwareVertexAnimVertexData : mMesh->sharedVertexData;
+                        if (prePass)
+                            prePass->_queueSoftwareVertexBlend(sourceData, mSkelAnimVertexData,
+                                blendMatrices, mMesh->sharedBlendIndexToBoneIndexMap.size(),
+                                blendNormals);
+                        else
+                            Mesh::softwareVertexBlend(sourceData, mSkelAnimVertexData,
+                                blendMatrices, mMesh->sharedBlendIndexToBoneIndexMap.size(),
+                                blendNormals);
                     }
                     SubEntityList::iterator i, iend;
                     iend = mSubEntityList.end();
@@ -940,12 +976,17 @@ namespace Ogre {
                             Mesh::prepareMatricesForVertexBlend(blendMatrices,
                                                                 mBoneMatrices, se->mSubMesh->blendIndexToBoneIndexMap);
                             // Blend, taking source from either mesh data or morph data
-                            Mesh::softwareVertexBlend(
+                            const VertexData* sourceData =
                                 (se->getSubMesh()->getVertexAnimationType() != VAT_NONE)?
-                                se->mSoftwareVertexAnimVertexData : se->mSubMesh->vertexData,
-                                se->mSkelAnimVertexData,
-                                blendMatrices, se->mSubMesh->blendIndexToBoneIndexMap.size(),
-                                blendNormals);
+                                se->mSoftwareVertexAnimVertexData : se->mSubMesh->vertexData;
+                            if (prePass)
+                                prePass->_queueSoftwareVertexBlend(sourceData, se->mSkelAnimVertexData,
+                                    blendMatrices, se->mSubMesh->blendIndexToBoneIndexMap.size(),
+                                    blendNormals);
+                            else
+                                Mesh::softwareVertexBlend(sourceData, se->mSkelAnimVertexData,
+                                    blendMatrices, se->mSubMesh->blendIndexToBoneIndexMap.size(),
+                                    blendNormals);
                         }
 
                     }
@@ -963,8 +1004,8 @@ namespace Ogre {
         // Need to update the child object's transforms when animation dirty
         // or parent node transform has altered.
         if (hasSkeleton() && 
-            (isNeedUpdateHardwareAnim || 
-             animationDirty || mLastParentXform != _getParentNodeFullTransform()))
+            (update.isNeedUpdateHardwareAnim || 
+             update.animationDirty || mLastParentXform != _getParentNodeFullTransform()))
         {
             // Cache last parent transform for next frame use too.
             mLastParentXform = _getParentNodeFullTransform();
@@ -2358,8 +2399,7 @@ namespace Ogre {
             OGRE_DELETE mSkeletonInstance;
             OGRE_FREE_SIMD(mBoneMatrices, MEMCATEGORY_ANIMATION);
             OGRE_DELETE mAnimationState;
-            // using OGRE_FREE since unsigned long is not a destructor
-            OGRE_FREE(mFrameBonesLastUpdated, MEMCATEGORY_ANIMATION);
+            OGRE_DELETE_T(mFrameBonesLastUpdated, unsigned long, MEMCATEGORY_ANIMATION);
             mSkeletonInstance = entity->mSkeletonInstance;
             mNumBoneMatrices = entity->mNumBoneMatrices;
             mBoneMatrices = entity->mBoneMatrices;
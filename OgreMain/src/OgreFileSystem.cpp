@@ -116,6 +116,7 @@ namespace {
     };
 
     bool gIgnoreHidden = true;
+    bool gUseMemoryMapping = false;
 }
 
     //-----------------------------------------------------------------------
@@ -330,6 +331,18 @@ namespace {
     {
         String full_path = concatenate_path(mName, filename);
 
+        if (readOnly && gUseMemoryMapping)
+        {
+            // fall back to a regular stream if the file cannot be mapped
+            try
+            {
+                return DataStreamPtr(OGRE_NEW MappedDataStream(filename, full_path));
+            }
+            catch (FileNotFoundException&)
+            {
+            }
+        }
+
         // Use filesystem to determine size 
         // (quicker than streaming to the end and back)
 #ifdef _OGRE_FILESYSTEM_ARCHIVE_UNICODE
@@ -577,4 +590,14 @@ namespace {
     {
         return gIgnoreHidden;
     }
+
+    void FileSystemArchiveFactory::setUseMemoryMapping(bool mapped)
+    {
+        gUseMemoryMapping = mapped;
+    }
+
+    bool FileSystemArchiveFactory::getUseMemoryMapping()
+    {
+        return gUseMemoryMapping;
+    }
 }
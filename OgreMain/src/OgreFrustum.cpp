@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreStableHeaders.h"
 #include "OgreHardwareVertexBuffer.h"
 #include "OgreMovablePlane.h"
+#include "OgreOptimisedUtil.h"
 
 namespace Ogre {
 
@@ -303,6 +304,83 @@ namespace Ogre {
         return true;
     }
     //---------------------------------------------------------------------
+    size_t Frustum::getCullingPlanes(Plane* planes) const
+    {
+        // Make any pending updates to the calculated frustum planes
+        updateFrustumPlanes();
+
+        size_t numPlanes = 0;
+        for (int plane = 0; plane < 6; ++plane)
+        {
+            // Skip far plane if infinite view frustum
+            if (plane == FRUSTUM_PLANE_FAR && mFarDist == 0)
+                continue;
+            planes[numPlanes++] = mFrustumPlanes[plane];
+        }
+        return numPlanes;
+    }
+    //---------------------------------------------------------------------
+    void Frustum::isVisible(size_t numBoxes, const float* const centres[3],
+                            const float* const halfSizes[3], uint32* visibility) const
+    {
+        Plane planes[6];
+        size_t numPlanes = getCullingPlanes(planes);
+        OptimisedUtil::getImplementation()->cullAxisAlignedBoxes(
+            planes, numPlanes, centres, halfSizes, visibility, numBoxes);
+    }
+    //---------------------------------------------------------------------
+    void Frustum::isVisible(size_t numBoxes, const AxisAlignedBox* const* boxes,
+                            uint32* visibility) const
+    {
+        // Pack 32 boxes at a time, one visibility word each
+        float data[6][32];
+        const float* centres[3] = {data[0], data[1], data[2]};
+        const float* halfSizes[3] = {data[3], data[4], data[5]};
+
+        for (size_t begin = 0; begin < numBoxes; begin += 32)
+        {
+            size_t count = std::min(numBoxes - begin, size_t(32));
+            uint32 nullMask = 0, infiniteMask = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const AxisAlignedBox& box = *boxes[begin + i];
+                if (box.isFinite())
+                {
+                    Vector3 centre = box.getCenter();
+                    Vector3 halfSize = box.getHalfSize();
+                    data[0][i] = centre.x;
+                    data[1][i] = centre.y;
+                    data[2][i] = centre.z;
+                    data[3][i] = halfSize.x;
+                    data[4][i] = halfSize.y;
+                    data[5][i] = halfSize.z;
+                    continue;
+                }
+
+                if (box.isNull())
+                    nullMask |= 1u << i;
+                else
+                    infiniteMask |= 1u << i;
+                for (int k = 0; k < 6; ++k)
+                    data[k][i] = 0;
+            }
+
+            // virtual, so the Camera gets to forward to its culling frustum
+            uint32& word = visibility[begin / 32];
+            isVisible(count, centres, halfSizes, &word);
+            word = (word & ~nullMask) | infiniteMask;
+        }
+    }
+    //---------------------------------------------------------------------
+    void Frustum::isVisible(size_t numSpheres, const float* const centres[3],
+                            const float* radii, uint32* visibility) const
+    {
+        Plane planes[6];
+        size_t numPlanes = getCullingPlanes(planes);
+        OptimisedUtil::getImplementation()->cullSpheres(
+            planes, numPlanes, centres, radii, visibility, numSpheres);
+    }
+    //---------------------------------------------------------------------
     uint32 Frustum::getTypeFlags(void) const
     {
         return SceneManager::FRUSTUM_TYPE_MASK;
@@ -167,18 +167,62 @@ namespace Ogre
     {
         mVisible = false;
 
-        InstancedEntityVec::const_iterator itor = mInstancedEntities.begin();
-        InstancedEntityVec::const_iterator end  = mInstancedEntities.end();
-
-        while( itor != end && !mVisible )
+        for( size_t begin=0; begin<mInstancedEntities.size() && !mVisible; begin += 32 )
         {
             //Trick to force Ogre not to render us if none of our instances is visible
             //Because we do Camera::isVisible(), it is better if the SceneNode from the
             //InstancedEntity is not part of the scene graph (i.e. ultimate parent is root node)
             //to avoid unnecessary wasteful calculations
-            mVisible |= (*itor)->findVisible( mCurrentCamera );
-            ++itor;
+            const size_t count = std::min( mInstancedEntities.size() - begin, size_t(32) );
+            mVisible = findVisibleInstances( mCurrentCamera, begin, count ) != 0;
+        }
+    }
+    //-----------------------------------------------------------------------
+    uint32 InstanceBatch::findVisibleInstances( Camera *camera, size_t begin, size_t count ) const
+    {
+        assert( count <= 32 && begin + count <= mInstancedEntities.size() );
+
+        uint32 retVal = 0;
+
+        //Gather the bounding spheres of the active instances, then cull them in bulk
+        float sphereData[4][32];
+        size_t sphereOwner[32];
+        size_t numSpheres = 0;
+
+        for( size_t i=0; i<count; ++i )
+        {
+            const InstancedEntity *entity = mInstancedEntities[begin + i];
+            if( !entity->isInScene() || !entity->isVisible() )
+                continue;
+
+            if( !camera )
+            {
+                retVal |= 1u << i;
+                continue;
+            }
+
+            const Vector3 &pos = entity->_getDerivedPosition();
+            sphereData[0][numSpheres] = pos.x;
+            sphereData[1][numSpheres] = pos.y;
+            sphereData[2][numSpheres] = pos.z;
+            sphereData[3][numSpheres] = entity->getBoundingRadius();
+            sphereOwner[numSpheres++] = i;
+        }
+
+        if( numSpheres )
+        {
+            const float *centres[3] = { sphereData[0], sphereData[1], sphereData[2] };
+            uint32 visible;
+            camera->isVisible( numSpheres, centres, sphereData[3], &visible );
+
+            for( size_t i=0; i<numSpheres; ++i )
+            {
+                if( visible & (1u << i) )
+                    retVal |= 1u << sphereOwner[i];
+            }
         }
+
+        return retVal;
     }
     //-----------------------------------------------------------------------
     void InstanceBatch::createAllInstancedEntities()
@@ -184,19 +184,23 @@ namespace Ogre
         float *pDest = static_cast<float*>(mRenderOperation.vertexData->vertexBufferBinding->
                                             getBuffer(bufferIdx)->lock( HardwareBuffer::HBL_DISCARD ));
 
-        InstancedEntityVec::const_iterator itor = mInstancedEntities.begin();
-        InstancedEntityVec::const_iterator end  = mInstancedEntities.end();
-
         unsigned char numCustomParams           = mCreator->getNumCustomParams();
         size_t customParamIdx                   = 0;
+        uint32 visibleMask                      = 0;
 
-        while( itor != end )
+        for( size_t i=0; i<mInstancedEntities.size(); ++i )
         {
             //Cull on an individual basis, the less entities are visible, the less instances we draw.
-            //No need to use null matrices at all!
-            if( (*itor)->findVisible( currentCamera ) )
+            //No need to use null matrices at all! The instances are culled in bulk, 32 at a time
+            if( i % 32 == 0 )
+            {
+                visibleMask = findVisibleInstances( currentCamera, i,
+                                                    std::min( mInstancedEntities.size() - i, size_t(32) ) );
+            }
+
+            if( visibleMask & (1u << (i % 32)) )
             {
-                const size_t floatsWritten = (*itor)->getTransforms3x4( pDest );
+                const size_t floatsWritten = mInstancedEntities[i]->getTransforms3x4( pDest );
 
                 if( mManager->getCameraRelativeRendering() )
                     makeMatrixCameraRelative3x4( pDest, floatsWritten );
@@ -204,17 +208,16 @@ namespace Ogre
                 pDest += floatsWritten;
 
                 //Write custom parameters, if any
-                for( unsigned char i=0; i<numCustomParams; ++i )
+                for( unsigned char j=0; j<numCustomParams; ++j )
                 {
-                    *pDest++ = mCustomParams[customParamIdx+i].x;
-                    *pDest++ = mCustomParams[customParamIdx+i].y;
-                    *pDest++ = mCustomParams[customParamIdx+i].z;
-                    *pDest++ = mCustomParams[customParamIdx+i].w;
+                    *pDest++ = mCustomParams[customParamIdx+j].x;
+                    *pDest++ = mCustomParams[customParamIdx+j].y;
+                    *pDest++ = mCustomParams[customParamIdx+j].z;
+                    *pDest++ = mCustomParams[customParamIdx+j].w;
                 }
 
                 ++retVal;
             }
-            ++itor;
 
             customParamIdx += numCustomParams;
         }
@@ -437,8 +437,13 @@ namespace Ogre
             transforms = mTempTransformsArray3x4;
         }
         
+        uint32 visibleMask = 0;
         for(size_t i = 0 ; i < instanceCount ; ++i)
         {
+            //Cull in bulk, 32 instances at a time
+            if (i % 32 == 0)
+                visibleMask = findVisibleInstances(currentCamera, i, std::min(instanceCount - i, size_t(32)));
+
             InstancedEntity* entity = mInstancedEntities[i];
             size_t textureLookupPosition = updatedInstances;
             if (useMatrixLookup)
@@ -450,7 +455,7 @@ namespace Ogre
             if (((!useMatrixLookup) || !writtenPositions[entity->mTransformLookupNumber]) &&
                 //Cull on an individual basis, the less entities are visible, the less instances we draw.
                 //No need to use null matrices at all!
-                (entity->findVisible( currentCamera )))
+                (visibleMask & (1u << (i % 32))))
             {
                 float* pDest = pSource + floatPerEntity * textureLookupPosition + 
                     (size_t)(textureLookupPosition / entitiesPerPadding) * mWidthFloatsPadding;
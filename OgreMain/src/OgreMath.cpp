@@ -48,6 +48,12 @@ namespace Ogre
 
     Math::RandomValueProvider* Math::mRandProvider = NULL;
 
+    namespace
+    {
+        /// Provider set by SetThreadRandomValueProvider, overrides mRandProvider
+        thread_local Math::RandomValueProvider* tlsRandProvider = NULL;
+    }
+
     //-----------------------------------------------------------------------
     Math::Math( unsigned int trigTableSize )
     {
@@ -151,6 +157,8 @@ namespace Ogre
     //-----------------------------------------------------------------------
     Real Math::UnitRandom ()
     {
+        if (tlsRandProvider)
+            return tlsRandProvider->getRandomUnit();
         if (mRandProvider)
             return mRandProvider->getRandomUnit();
         else return Real(rand()) / RAND_MAX;
@@ -161,6 +169,13 @@ namespace Ogre
     {
         mRandProvider = provider;
     }
+    //-----------------------------------------------------------------------
+    Math::RandomValueProvider* Math::SetThreadRandomValueProvider(RandomValueProvider* provider)
+    {
+        RandomValueProvider* previous = tlsRandProvider;
+        tlsRandProvider = provider;
+        return previous;
+    }
 
    //-----------------------------------------------------------------------
     void Math::setAngleUnit(Math::AngleUnit unit)
@@ -0,0 +1,546 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreMemoryCategoryAllocator.h"
+
+#include <mutex>
+
+namespace Ogre
+{
+    namespace
+    {
+        /// Stored in front of every block handed out by MemoryCategoryAllocator
+        struct BlockHeader
+        {
+            size_t size;
+            uint16 category;
+            uint8 allocator;
+            uint8 tag;
+        };
+        /// Keeps the user pointer SIMD aligned
+        const size_t HEADER_SIZE = OGRE_SIMD_ALIGNMENT;
+        static_assert(sizeof(BlockHeader) <= HEADER_SIZE, "BlockHeader too large");
+        const uint8 BLOCK_TAG = 0xA7;
+
+        /// Slot 0 is the default allocator
+        const size_t MAX_ALLOCATORS = 256;
+
+        struct CategoryStats
+        {
+            AtomicScalar<size_t> bytes;
+            AtomicScalar<size_t> count;
+            AtomicScalar<size_t> peak;
+            AtomicScalar<size_t> total;
+            AtomicScalar<size_t> budget;
+            AtomicScalar<uint8> allocator;
+        };
+        // zero initialised before any dynamic initialisation, so usable from static constructors
+        CategoryStats gStats[MEMCATEGORY_COUNT];
+        AtomicScalar<MemoryAllocator*> gAllocators[MAX_ALLOCATORS];
+        std::mutex gAllocatorsMutex;
+
+        const char* const CATEGORY_NAMES[MEMCATEGORY_COUNT] =
+        {
+            "General", "Geometry", "Animation", "SceneControl",
+            "SceneObjects", "Resource", "Scripting", "RenderSystem"
+        };
+
+        MemoryAllocator* getAllocatorInSlot(uint8 slot)
+        {
+            return slot ? gAllocators[slot].load(std::memory_order_acquire)
+                        : MemoryCategoryAllocator::getDefaultAllocator();
+        }
+
+        BlockHeader* getHeader(void* ptr)
+        {
+            BlockHeader* header = reinterpret_cast<BlockHeader*>(static_cast<char*>(ptr) - HEADER_SIZE);
+            assert(header->tag == BLOCK_TAG && "Memory not allocated by MemoryCategoryAllocator or freed twice");
+            return header;
+        }
+    }
+    //---------------------------------------------------------------------
+    void* MemoryCategoryAllocator::allocateBytes(size_t size, int category)
+    {
+        assert(category >= 0 && category < MEMCATEGORY_COUNT);
+        CategoryStats& stats = gStats[category];
+        uint8 slot = stats.allocator.load(std::memory_order_acquire);
+
+        void* mem = getAllocatorInSlot(slot)->allocateBytes(size + HEADER_SIZE, category);
+        if (!mem)
+            throw std::bad_alloc();
+
+        BlockHeader* header = static_cast<BlockHeader*>(mem);
+        header->size = size;
+        header->category = static_cast<uint16>(category);
+        header->allocator = slot;
+        header->tag = BLOCK_TAG;
+
+        size_t bytes = stats.bytes.fetch_add(size, std::memory_order_relaxed) + size;
+        stats.count.fetch_add(1, std::memory_order_relaxed);
+        stats.total.fetch_add(1, std::memory_order_relaxed);
+        size_t peak = stats.peak.load(std::memory_order_relaxed);
+        while (bytes > peak && !stats.peak.compare_exchange_weak(peak, bytes, std::memory_order_relaxed))
+        {
+        }
+
+        return static_cast<char*>(mem) + HEADER_SIZE;
+    }
+    //---------------------------------------------------------------------
+    void MemoryCategoryAllocator::deallocateBytes(void* ptr)
+    {
+        if (!ptr)
+            return;
+
+        BlockHeader* header = getHeader(ptr);
+        size_t size = header->size;
+        int category = header->category;
+        header->tag = 0;
+
+        CategoryStats& stats = gStats[category];
+        stats.bytes.fetch_sub(size, std::memory_order_relaxed);
+        stats.count.fetch_sub(1, std::memory_order_relaxed);
+
+        getAllocatorInSlot(header->allocator)->deallocateBytes(header, size + HEADER_SIZE, category);
+    }
+    //---------------------------------------------------------------------
+    void* MemoryCategoryAllocator::reallocateBytes(void* ptr, size_t size, int category)
+    {
+        if (!ptr)
+            return allocateBytes(size, category);
+        if (!size)
+        {
+            deallocateBytes(ptr);
+            return 0;
+        }
+
+        BlockHeader* header = getHeader(ptr);
+        if (header->size == size)
+            return ptr;
+
+        void* result = allocateBytes(size, header->category);
+        memcpy(result, ptr, std::min(size, header->size));
+        deallocateBytes(ptr);
+        return result;
+    }
+    //---------------------------------------------------------------------
+    void MemoryCategoryAllocator::setAllocator(int category, MemoryAllocator* allocator)
+    {
+        assert(category >= 0 && category < MEMCATEGORY_COUNT);
+        uint8 slot = 0;
+        if (allocator && allocator != getDefaultAllocator())
+        {
+            // slots are never released, blocks refer to them
+            std::lock_guard<std::mutex> lock(gAllocatorsMutex);
+            size_t i = 1;
+            while (i < MAX_ALLOCATORS && gAllocators[i].load() && gAllocators[i].load() != allocator)
+                ++i;
+            if (i == MAX_ALLOCATORS)
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Too many different allocators",
+                    "MemoryCategoryAllocator::setAllocator");
+            }
+            gAllocators[i].store(allocator, std::memory_order_release);
+            slot = static_cast<uint8>(i);
+        }
+        gStats[category].allocator.store(slot, std::memory_order_release);
+    }
+    //---------------------------------------------------------------------
+    MemoryAllocator* MemoryCategoryAllocator::getAllocator(int category)
+    {
+        assert(category >= 0 && category < MEMCATEGORY_COUNT);
+        return getAllocatorInSlot(gStats[category].allocator.load(std::memory_order_acquire));
+    }
+    //---------------------------------------------------------------------
+    PoolMemoryAllocator* MemoryCategoryAllocator::getDefaultAllocator()
+    {
+        // never destroyed, blocks are still freed during static destruction
+        static PoolMemoryAllocator* pool = new PoolMemoryAllocator();
+        return pool;
+    }
+    //---------------------------------------------------------------------
+    size_t MemoryCategoryAllocator::getAllocatedBytes(int category)
+    {
+        assert(category >= 0 && category < MEMCATEGORY_COUNT);
+        return gStats[category].bytes.load(std::memory_order_relaxed);
+    }
+    //---------------------------------------------------------------------
+    size_t MemoryCategoryAllocator::getAllocationCount(int category)
+    {
+        assert(category >= 0 && category < MEMCATEGORY_COUNT);
+        return gStats[category].count.load(std::memory_order_relaxed);
+    }
+    //---------------------------------------------------------------------
+    size_t MemoryCategoryAllocator::getPeakAllocatedBytes(int category)
+    {
+        assert(category >= 0 && category < MEMCATEGORY_COUNT);
+        return gStats[category].peak.load(std::memory_order_relaxed);
+    }
+    //---------------------------------------------------------------------
+    size_t MemoryCategoryAllocator::getTotalAllocationCount(int category)
+    {
+        assert(category >= 0 && category < MEMCATEGORY_COUNT);
+        return gStats[category].total.load(std::memory_order_relaxed);
+    }
+    //---------------------------------------------------------------------
+    void MemoryCategoryAllocator::resetPeakAllocatedBytes(int category)
+    {
+        assert(category >= 0 && category < MEMCATEGORY_COUNT);
+        gStats[category].peak.store(gStats[category].bytes.load(std::memory_order_relaxed),
+            std::memory_order_relaxed);
+    }
+    //---------------------------------------------------------------------
+    void MemoryCategoryAllocator::setBudget(int category, size_t bytes)
+    {
+        assert(category >= 0 && category < MEMCATEGORY_COUNT);
+        gStats[category].budget.store(bytes, std::memory_order_relaxed);
+    }
+    //---------------------------------------------------------------------
+    size_t MemoryCategoryAllocator::getBudget(int category)
+    {
+        assert(category >= 0 && category < MEMCATEGORY_COUNT);
+        return gStats[category].budget.load(std::memory_order_relaxed);
+    }
+    //---------------------------------------------------------------------
+    bool MemoryCategoryAllocator::isOverBudget(int category)
+    {
+        size_t budget = getBudget(category);
+        return budget && getAllocatedBytes(category) > budget;
+    }
+    //---------------------------------------------------------------------
+    const char* MemoryCategoryAllocator::getCategoryName(int category)
+    {
+        assert(category >= 0 && category < MEMCATEGORY_COUNT);
+        return CATEGORY_NAMES[category];
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    namespace
+    {
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        /// Blocks a thread keeps per category and size class before giving some back
+        const uint32 THREAD_CACHE_LIMIT = 64;
+        /// Blocks moved between a thread cache and the shared lists at once
+        const uint32 THREAD_CACHE_BATCH = 32;
+        const size_t MAX_THREAD_CACHES = PoolMemoryAllocator::MAX_THREAD_CACHES;
+
+        struct SharedList
+        {
+            std::mutex mutex;
+            FreeBlock* head;
+            vector<void*>::type chunks;
+
+            SharedList() : head(0) {}
+        };
+    }
+
+    struct PoolMemoryAllocator::Impl
+    {
+        SharedList lists[MEMCATEGORY_COUNT][NUM_SIZE_CLASSES];
+        AtomicScalar<size_t> reserved[MEMCATEGORY_COUNT];
+        /// Unique for the process lifetime, unlike the address which can be reused
+        uint64 generation;
+        /// Next entry of gLivePools
+        Impl* nextLive;
+
+        Impl() : generation(0), nextLive(0)
+        {
+            for (size_t c = 0; c < MEMCATEGORY_COUNT; ++c)
+                reserved[c] = 0;
+        }
+
+        ~Impl()
+        {
+            for (size_t c = 0; c < MEMCATEGORY_COUNT; ++c)
+            {
+                for (size_t s = 0; s < NUM_SIZE_CLASSES; ++s)
+                {
+                    vector<void*>::type& chunks = lists[c][s].chunks;
+                    for (size_t i = 0; i < chunks.size(); ++i)
+                        AlignedMemory::deallocate(chunks[i]);
+                }
+            }
+        }
+
+        /// Take up to maxCount blocks linked together, carving a new chunk if needed
+        FreeBlock* take(int category, size_t sizeClass, uint32 maxCount, uint32& taken)
+        {
+            SharedList& list = lists[category][sizeClass];
+            std::lock_guard<std::mutex> lock(list.mutex);
+            if (!list.head)
+            {
+                size_t blockSize = (sizeClass + 1) * SIZE_CLASS_STEP;
+                size_t numBlocks = CHUNK_SIZE / blockSize;
+                char* chunk = static_cast<char*>(AlignedMemory::allocate(CHUNK_SIZE, OGRE_SIMD_ALIGNMENT));
+                list.chunks.push_back(chunk);
+                reserved[category].fetch_add(CHUNK_SIZE, std::memory_order_relaxed);
+
+                for (size_t i = 0; i < numBlocks; ++i)
+                {
+                    FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + i * blockSize);
+                    block->next = i + 1 < numBlocks ? reinterpret_cast<FreeBlock*>(chunk + (i + 1) * blockSize) : 0;
+                }
+                list.head = reinterpret_cast<FreeBlock*>(chunk);
+            }
+
+            FreeBlock* first = list.head;
+            FreeBlock* last = first;
+            taken = 1;
+            while (taken < maxCount && last->next)
+            {
+                last = last->next;
+                ++taken;
+            }
+            list.head = last->next;
+            last->next = 0;
+            return first;
+        }
+
+        /// Give back a linked run of blocks
+        void give(int category, size_t sizeClass, FreeBlock* first, FreeBlock* last)
+        {
+            SharedList& list = lists[category][sizeClass];
+            std::lock_guard<std::mutex> lock(list.mutex);
+            last->next = list.head;
+            list.head = first;
+        }
+    };
+
+    namespace
+    {
+        /// Pools which are alive, linked through Impl::nextLive (guarded by gPoolsMutex)
+        PoolMemoryAllocator::Impl* gLivePools = 0;
+        uint64 gNextGeneration = 0;
+        std::mutex gPoolsMutex;
+
+        /// gPoolsMutex must be locked
+        bool isPoolLive(uint64 generation)
+        {
+            for (PoolMemoryAllocator::Impl* p = gLivePools; p; p = p->nextLive)
+            {
+                if (p->generation == generation)
+                    return true;
+            }
+            return false;
+        }
+
+        struct ThreadCache
+        {
+            PoolMemoryAllocator::Impl* owner;
+            /// Generation of the owner; the owner pointer is only valid while this is live
+            uint64 generation;
+            FreeBlock* heads[MEMCATEGORY_COUNT][PoolMemoryAllocator::NUM_SIZE_CLASSES];
+            uint32 counts[MEMCATEGORY_COUNT][PoolMemoryAllocator::NUM_SIZE_CLASSES];
+
+            ThreadCache(PoolMemoryAllocator::Impl* o) : owner(o), generation(o->generation)
+            {
+                memset(heads, 0, sizeof(heads));
+                memset(counts, 0, sizeof(counts));
+            }
+
+            /// Move up to count blocks of one list back to the owner
+            void flush(int category, size_t sizeClass, uint32 count)
+            {
+                FreeBlock*& head = heads[category][sizeClass];
+                if (!head || !count)
+                    return;
+                FreeBlock* first = head;
+                FreeBlock* last = first;
+                uint32 moved = 1;
+                while (moved < count && last->next)
+                {
+                    last = last->next;
+                    ++moved;
+                }
+                head = last->next;
+                counts[category][sizeClass] -= moved;
+                owner->give(category, sizeClass, first, last);
+            }
+        };
+
+        /// Caches of the calling thread, handed back when the thread exits
+        struct ThreadCacheSet
+        {
+            ThreadCache* caches[MAX_THREAD_CACHES];
+
+            ThreadCacheSet() { memset(caches, 0, sizeof(caches)); }
+            ~ThreadCacheSet();
+
+            /** Drop the caches of destroyed pools without touching their blocks, which
+                were freed with the pool's chunks. gPoolsMutex must be locked. */
+            void dropDeadCaches()
+            {
+                size_t kept = 0;
+                for (size_t i = 0; i < MAX_THREAD_CACHES && caches[i]; ++i)
+                {
+                    if (isPoolLive(caches[i]->generation))
+                        caches[kept++] = caches[i];
+                    else
+                        delete caches[i];
+                }
+                for (size_t i = kept; i < MAX_THREAD_CACHES; ++i)
+                    caches[i] = 0;
+            }
+        };
+
+        thread_local ThreadCacheSet tlsCacheSet;
+        /// Set once tlsCacheSet is destroyed, later frees on this thread bypass the caches
+        thread_local bool tlsCacheSetDestroyed = false;
+
+        ThreadCacheSet::~ThreadCacheSet()
+        {
+            tlsCacheSetDestroyed = true;
+            // keeps the owners alive while flushing
+            std::lock_guard<std::mutex> lock(gPoolsMutex);
+            dropDeadCaches();
+            for (size_t i = 0; i < MAX_THREAD_CACHES && caches[i]; ++i)
+            {
+                for (int c = 0; c < MEMCATEGORY_COUNT; ++c)
+                {
+                    for (size_t s = 0; s < PoolMemoryAllocator::NUM_SIZE_CLASSES; ++s)
+                        caches[i]->flush(c, s, caches[i]->counts[c][s]);
+                }
+                delete caches[i];
+            }
+        }
+
+        /// The calling thread's cache for a pool, null if it can't have one
+        ThreadCache* getThreadCache(PoolMemoryAllocator::Impl* owner)
+        {
+            if (tlsCacheSetDestroyed)
+                return 0;
+            ThreadCacheSet& set = tlsCacheSet;
+            for (size_t i = 0; i < MAX_THREAD_CACHES && set.caches[i]; ++i)
+            {
+                // compared by generation, a new pool may live at the address of a destroyed one
+                if (set.caches[i]->generation == owner->generation)
+                    return set.caches[i];
+            }
+
+            // slow path, once per thread and pool
+            std::lock_guard<std::mutex> lock(gPoolsMutex);
+            set.dropDeadCaches();
+            for (size_t i = 0; i < MAX_THREAD_CACHES; ++i)
+            {
+                if (!set.caches[i])
+                {
+                    set.caches[i] = new ThreadCache(owner);
+                    return set.caches[i];
+                }
+            }
+            // all slots taken by live pools, this thread uses the shared lists
+            return 0;
+        }
+    }
+    //---------------------------------------------------------------------
+    PoolMemoryAllocator::PoolMemoryAllocator()
+        : mImpl(new Impl())
+    {
+        std::lock_guard<std::mutex> lock(gPoolsMutex);
+        mImpl->generation = ++gNextGeneration;
+        mImpl->nextLive = gLivePools;
+        gLivePools = mImpl;
+    }
+    //---------------------------------------------------------------------
+    PoolMemoryAllocator::~PoolMemoryAllocator()
+    {
+        {
+            // from now on the caches of other threads are dropped instead of flushed
+            std::lock_guard<std::mutex> lock(gPoolsMutex);
+            for (Impl** p = &gLivePools; *p; p = &(*p)->nextLive)
+            {
+                if (*p == mImpl)
+                {
+                    *p = mImpl->nextLive;
+                    break;
+                }
+            }
+            if (!tlsCacheSetDestroyed)
+                tlsCacheSet.dropDeadCaches();
+        }
+        delete mImpl;
+    }
+    //---------------------------------------------------------------------
+    void* PoolMemoryAllocator::allocateBytes(size_t size, int category)
+    {
+        if (size > MAX_POOLED_SIZE)
+            return AlignedMemory::allocate(size, OGRE_SIMD_ALIGNMENT);
+
+        size_t sizeClass = (size - 1) / SIZE_CLASS_STEP;
+        ThreadCache* cache = getThreadCache(mImpl);
+        if (!cache)
+        {
+            uint32 taken;
+            return mImpl->take(category, sizeClass, 1, taken);
+        }
+
+        FreeBlock*& head = cache->heads[category][sizeClass];
+        if (!head)
+        {
+            uint32 taken;
+            head = mImpl->take(category, sizeClass, THREAD_CACHE_BATCH, taken);
+            cache->counts[category][sizeClass] = taken;
+        }
+        FreeBlock* block = head;
+        head = block->next;
+        --cache->counts[category][sizeClass];
+        return block;
+    }
+    //---------------------------------------------------------------------
+    void PoolMemoryAllocator::deallocateBytes(void* ptr, size_t size, int category)
+    {
+        if (size > MAX_POOLED_SIZE)
+        {
+            AlignedMemory::deallocate(ptr);
+            return;
+        }
+
+        size_t sizeClass = (size - 1) / SIZE_CLASS_STEP;
+        FreeBlock* block = static_cast<FreeBlock*>(ptr);
+        ThreadCache* cache = getThreadCache(mImpl);
+        if (!cache)
+        {
+            mImpl->give(category, sizeClass, block, block);
+            return;
+        }
+
+        block->next = cache->heads[category][sizeClass];
+        cache->heads[category][sizeClass] = block;
+        if (++cache->counts[category][sizeClass] > THREAD_CACHE_LIMIT)
+            cache->flush(category, sizeClass, THREAD_CACHE_BATCH);
+    }
+    //---------------------------------------------------------------------
+    size_t PoolMemoryAllocator::getReservedBytes(int category) const
+    {
+        assert(category >= 0 && category < MEMCATEGORY_COUNT);
+        return mImpl->reserved[category].load(std::memory_order_relaxed);
+    }
+}
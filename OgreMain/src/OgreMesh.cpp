@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include "OgreAnimationState.h"
 #include "OgreAnimationTrack.h"
 #include "OgreOptimisedUtil.h"
+#include "OgreThreadPool.h"
 #include "OgreTangentSpaceCalc.h"
 #include "OgreLodStrategyManager.h"
 #include "OgrePixelCountLodStrategy.h"
@@ -46,6 +47,7 @@ namespace Ogre {
         mBoundRadius(0.0f),
         mBoneBoundingRadius(0.0f),
         mBoneAssignmentsOutOfDate(false),
+        mBoneAssignmentsPacked(false),
         mLodStrategy(LodStrategyManager::getSingleton().getDefaultStrategy()),
         mHasManualLodLevel(false),
         mNumLods(1),
@@ -209,8 +211,10 @@ namespace Ogre {
             ResourceGroupManager::getSingleton().openResource(
                 mName, mGroup, this);
  
-        // fully prebuffer into host RAM
-        mFreshFromDisk = DataStreamPtr(OGRE_NEW MemoryDataStream(mName,mFreshFromDisk));
+        // fully prebuffer into host RAM, unless the archive already handed out
+        // the data in memory (e.g. a memory mapped file)
+        if (!dynamic_cast<MemoryDataStream*>(mFreshFromDisk.get()))
+            mFreshFromDisk = DataStreamPtr(OGRE_NEW MemoryDataStream(mName,mFreshFromDisk));
     }
     //-----------------------------------------------------------------------
     void Mesh::unprepareImpl()
@@ -275,6 +279,7 @@ namespace Ogre {
         // Clear bone assignments
         mBoneAssignments.clear();
         mBoneAssignmentsOutOfDate = false;
+        mBoneAssignmentsPacked = false;
 
         // Removes reference to skeleton
         setSkeletonName(BLANKSTRING);
@@ -340,6 +345,8 @@ namespace Ogre {
         // Copy any bone assignments
         newMesh->mBoneAssignments = mBoneAssignments;
         newMesh->mBoneAssignmentsOutOfDate = mBoneAssignmentsOutOfDate;
+        // Packed assignments are unpacked from the cloned blend buffer
+        newMesh->mBoneAssignmentsPacked = mBoneAssignmentsPacked;
         // Copy bounds
         newMesh->mAABB = mAABB;
         newMesh->mBoundRadius = mBoundRadius;
@@ -543,6 +550,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Mesh::addBoneAssignment(const VertexBoneAssignment& vertBoneAssign)
     {
+        _unpackBoneAssignments();
         mBoneAssignments.insert(
             VertexBoneAssignmentList::value_type(vertBoneAssign.vertexIndex, vertBoneAssign));
         mBoneAssignmentsOutOfDate = true;
@@ -552,6 +560,27 @@ namespace Ogre {
     {
         mBoneAssignments.clear();
         mBoneAssignmentsOutOfDate = true;
+        mBoneAssignmentsPacked = false;
+    }
+    //-----------------------------------------------------------------------
+    void Mesh::_unpackBoneAssignments(void) const
+    {
+        if (mBoneAssignmentsPacked)
+        {
+            mBoneAssignmentsPacked = false;
+            if (sharedVertexData)
+            {
+                vector<VertexBoneAssignment>::type assignments;
+                decompileBoneAssignments(sharedVertexData, sharedBlendIndexToBoneIndexMap, assignments);
+                mBoneAssignments.clear();
+                // Sorted by vertex, so always inserting at the end
+                for (size_t i = 0; i < assignments.size(); ++i)
+                {
+                    mBoneAssignments.insert(mBoneAssignments.end(),
+                        VertexBoneAssignmentList::value_type(assignments[i].vertexIndex, assignments[i]));
+                }
+            }
+        }
     }
     //-----------------------------------------------------------------------
     void Mesh::_initAnimationState(AnimationStateSet* animSet)
@@ -778,11 +807,71 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void Mesh::packBoneAssignments(const VertexBoneAssignmentList& boneAssignments,
+        size_t vertexCount, unsigned short numBlendWeightsPerVertex,
+        const IndexMap& boneIndexToBlendIndexMap, uint8* blendIndices, float* blendWeights)
+    {
+        VertexBoneAssignmentList::const_iterator i, iend;
+        i = boneAssignments.begin();
+        iend = boneAssignments.end();
+        // Iterate by vertex
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            uint8* indices = blendIndices + v * 4;
+            float* weights = blendWeights + v * numBlendWeightsPerVertex;
+            indices[0] = indices[1] = indices[2] = indices[3] = 0;
+            weights[0] = 1.0f;
+            for (unsigned short bone = 1; bone < numBlendWeightsPerVertex; ++bone)
+                weights[bone] = 0.0f;
+
+            // Skip assignments beyond the maximum, as _rationaliseBoneAssignments does
+            while (i != iend && i->second.vertexIndex < v)
+                ++i;
+
+            float totalWeight = 0.0f;
+            for (unsigned short bone = 0; bone < numBlendWeightsPerVertex; ++bone)
+            {
+                // Do we still have data for this vertex?
+                if (i != iend && i->second.vertexIndex == v)
+                {
+                    // If so, grab weight and index
+                    weights[ bone ] = i->second.weight;
+                    indices[ bone ] = static_cast<uint8>( boneIndexToBlendIndexMap[ i->second.boneIndex ] );
+                    totalWeight += i->second.weight;
+                    ++i;
+                }
+            }
+            // Make sure the weights are normalised
+            if (totalWeight > 0.0f && !Math::RealEqual(totalWeight, 1.0f))
+            {
+                for (unsigned short bone = 0; bone < numBlendWeightsPerVertex; ++bone)
+                    weights[bone] /= totalWeight;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
     void Mesh::compileBoneAssignments(
         const VertexBoneAssignmentList& boneAssignments,
         unsigned short numBlendWeightsPerVertex,
         IndexMap& blendIndexToBoneIndexMap,
         VertexData* targetVertexData)
+    {
+        // Build the index map brute-force. It's possible to store the index map
+        // in .mesh, but maybe trivial.
+        IndexMap boneIndexToBlendIndexMap;
+        buildIndexMap(boneAssignments, boneIndexToBlendIndexMap, blendIndexToBoneIndexMap);
+
+        vector<uint8>::type blendIndices(targetVertexData->vertexCount * 4);
+        vector<float>::type blendWeights(targetVertexData->vertexCount * numBlendWeightsPerVertex);
+        packBoneAssignments(boneAssignments, targetVertexData->vertexCount, numBlendWeightsPerVertex,
+            boneIndexToBlendIndexMap, blendIndices.data(), blendWeights.data());
+
+        compileBoneAssignments(blendIndices.data(), blendWeights.data(), numBlendWeightsPerVertex,
+            targetVertexData);
+    }
+    //---------------------------------------------------------------------
+    void Mesh::compileBoneAssignments(const uint8* blendIndices, const float* blendWeights,
+        unsigned short numBlendWeightsPerVertex, VertexData* targetVertexData)
     {
         // Create or reuse blend weight / indexes buffer
         // Indices are always a UBYTE4 no matter how many weights per vertex
@@ -790,11 +879,6 @@ namespace Ogre {
         VertexBufferBinding* bind = targetVertexData->vertexBufferBinding;
         unsigned short bindIndex;
 
-        // Build the index map brute-force. It's possible to store the index map
-        // in .mesh, but maybe trivial.
-        IndexMap boneIndexToBlendIndexMap;
-        buildIndexMap(boneAssignments, boneIndexToBlendIndexMap, blendIndexToBoneIndexMap);
-
         const VertexElement* testElem =
             decl->findElementBySemantic(VES_BLEND_INDICES);
         if (testElem)
@@ -876,27 +960,17 @@ namespace Ogre {
         }
         // Assign data
         size_t v;
-        VertexBoneAssignmentList::const_iterator i, iend;
-        i = boneAssignments.begin();
-        iend = boneAssignments.end();
         unsigned char *pBase = static_cast<unsigned char*>(
             vbuf->lock(HardwareBuffer::HBL_DISCARD));
         // Iterate by vertex
         for (v = 0; v < targetVertexData->vertexCount; ++v)
         {
             // collect the indices/weights in these arrays
-            unsigned char indices[ 4 ] = { 0, 0, 0, 0 };
-            float weights[ 4 ] = { 1.0f, 0.0f, 0.0f, 0.0f };
+            const uint8* indices = blendIndices + v * 4;
+            float weights[ 4 ] = { 0.0f, 0.0f, 0.0f, 0.0f };
             for (unsigned short bone = 0; bone < numBlendWeightsPerVertex; ++bone)
             {
-                // Do we still have data for this vertex?
-                if (i != iend && i->second.vertexIndex == v)
-                {
-                    // If so, grab weight and index
-                    weights[ bone ] = i->second.weight;
-                    indices[ bone ] = static_cast<unsigned char>( boneIndexToBlendIndexMap[ i->second.boneIndex ] );
-                    ++i;
-                }
+                weights[ bone ] = blendWeights[ v * numBlendWeightsPerVertex + bone ];
             }
             // if weights are integers,
             if ( weightsBaseType != VET_FLOAT1 )
@@ -952,7 +1026,8 @@ namespace Ogre {
                     // write out the weights as shorts
                     unsigned short* pWeight;
                     pWeightElem->baseVertexPointerToElement( pBase, &pWeight );
-                    for ( int ii = 0; ii < numBlendWeightsPerVertex; ++ii )
+                    // NOTE: also zeroes the padding short of 3 weights per vertex
+                    for ( int ii = 0; ii < VertexElement::getTypeCount( weightsVertexElemType ); ++ii )
                     {
                         *pWeight++ = static_cast<unsigned short>( intWeights[ ii ] );
                     }
@@ -981,6 +1056,92 @@ namespace Ogre {
 
     }
     //---------------------------------------------------------------------
+    void Mesh::decompileBoneAssignments(const VertexData* sourceVertexData,
+        const IndexMap& blendIndexToBoneIndexMap, vector<VertexBoneAssignment>::type& boneAssignments)
+    {
+        boneAssignments.clear();
+        const VertexDeclaration* decl = sourceVertexData->vertexDeclaration;
+        const VertexElement* pIdxElem = decl->findElementBySemantic(VES_BLEND_INDICES);
+        const VertexElement* pWeightElem = decl->findElementBySemantic(VES_BLEND_WEIGHTS);
+        if (!pIdxElem || !pWeightElem || blendIndexToBoneIndexMap.empty())
+            return;
+
+        VertexElementType weightsBaseType = VertexElement::getBaseType(pWeightElem->getType());
+        unsigned short numBlendWeightsPerVertex = VertexElement::getTypeCount(pWeightElem->getType());
+        float intWtScale = 1.0f;
+        switch (weightsBaseType)
+        {
+            case VET_FLOAT1:
+                break;
+            case VET_UBYTE4_NORM:
+                // always holds 4 weights, the unused ones are zero
+                intWtScale = 1.0f / 0xff;
+                break;
+            case VET_USHORT2_NORM:
+                intWtScale = 1.0f / 0xffff;
+                break;
+            case VET_SHORT2_NORM:
+                intWtScale = 1.0f / 0x7fff;
+                break;
+            default:
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Unsupported blend weight type",
+                    "Mesh::decompileBoneAssignments");
+        }
+
+        HardwareVertexBufferSharedPtr vbuf =
+            sourceVertexData->vertexBufferBinding->getBuffer(pIdxElem->getSource());
+        HardwareVertexBufferSharedPtr wbuf =
+            sourceVertexData->vertexBufferBinding->getBuffer(pWeightElem->getSource());
+        const unsigned char* pIdxBase = static_cast<const unsigned char*>(
+            vbuf->lock(HardwareBuffer::HBL_READ_ONLY));
+        const unsigned char* pWeightBase = wbuf == vbuf ? pIdxBase :
+            static_cast<const unsigned char*>(wbuf->lock(HardwareBuffer::HBL_READ_ONLY));
+
+        boneAssignments.reserve(sourceVertexData->vertexCount);
+        for (size_t v = 0; v < sourceVertexData->vertexCount; ++v)
+        {
+            const unsigned char* pIndex = pIdxBase + pIdxElem->getOffset();
+            const unsigned char* pWeight = pWeightBase + pWeightElem->getOffset();
+            for (unsigned short bone = 0; bone < numBlendWeightsPerVertex; ++bone)
+            {
+                float weight;
+                switch (weightsBaseType)
+                {
+                    case VET_UBYTE4_NORM:
+                        weight = pWeight[bone] * intWtScale;
+                        break;
+                    case VET_USHORT2_NORM:
+                        weight = reinterpret_cast<const uint16*>(pWeight)[bone] * intWtScale;
+                        break;
+                    case VET_SHORT2_NORM:
+                        weight = reinterpret_cast<const int16*>(pWeight)[bone] * intWtScale;
+                        break;
+                    default:
+                        weight = reinterpret_cast<const float*>(pWeight)[bone];
+                        break;
+                }
+                // Zero weights are padding
+                if (weight > 0.0f && pIndex[bone] < blendIndexToBoneIndexMap.size())
+                {
+                    VertexBoneAssignment assign;
+                    assign.vertexIndex = static_cast<unsigned int>(v);
+                    assign.boneIndex = blendIndexToBoneIndexMap[pIndex[bone]];
+                    assign.weight = weight;
+                    boneAssignments.push_back(assign);
+                }
+            }
+            pIdxBase += vbuf->getVertexSize();
+            if (wbuf != vbuf)
+                pWeightBase += wbuf->getVertexSize();
+            else
+                pWeightBase = pIdxBase;
+        }
+
+        if (wbuf != vbuf)
+            wbuf->unlock();
+        vbuf->unlock();
+    }
+    //---------------------------------------------------------------------
     static Real distLineSegToPoint( const Vector3& line0, const Vector3& line1, const Vector3& pt )
     {
         Vector3 v01 = line1 - line0;
@@ -990,8 +1151,18 @@ namespace Ogre {
         return pt.distance( onLine );
     }
     //---------------------------------------------------------------------
+    static inline const VertexBoneAssignment& _getAssignment(const VertexBoneAssignment& assign)
+    {
+        return assign;
+    }
+    static inline const VertexBoneAssignment& _getAssignment(const Mesh::VertexBoneAssignmentList::value_type& entry)
+    {
+        return entry.second;
+    }
+    //---------------------------------------------------------------------
+    template<typename AssignmentList>
     static Real _computeBoneBoundingRadiusHelper( VertexData* vertexData,
-        const Mesh::VertexBoneAssignmentList& boneAssignments,
+        const AssignmentList& boneAssignments,
         const vector<Vector3>::type& bonePositions,
         const vector< vector<ushort>::type >::type& boneChildren
         )
@@ -1022,15 +1193,16 @@ namespace Ogre {
         Real maxRadius = Real(0);
         Real minWeight = Real(0.01);
         // for each vertex-bone assignment,
-        for (Mesh::VertexBoneAssignmentList::const_iterator i = boneAssignments.begin(); i != boneAssignments.end(); ++i)
+        for (typename AssignmentList::const_iterator i = boneAssignments.begin(); i != boneAssignments.end(); ++i)
         {
+            const VertexBoneAssignment& assign = _getAssignment(*i);
             // if weight is close to zero, ignore
-            if (i->second.weight > minWeight)
+            if (assign.weight > minWeight)
             {
                 // if we have a bounding box around all bone origins, we consider how far outside this box the
                 // current vertex could ever get (assuming it is only attached to the given bone, and the bones all have unity scale)
-                size_t iBone = i->second.boneIndex;
-                const Vector3& v = vertexPositions[ i->second.vertexIndex ];
+                size_t iBone = assign.boneIndex;
+                const Vector3& v = vertexPositions[ assign.vertexIndex ];
                 Vector3 diff = v - bonePositions[ iBone ];
                 Real dist = diff.length();  // max distance of vertex v outside of bounding box
                 // if this bone has children, we can reduce the dist under the assumption that the children may rotate wrt their parent, but don't translate
@@ -1044,7 +1216,7 @@ namespace Ogre {
                     dist = std::min( dist, distChild );
                 }
                 // scale the distance by the weight, this prevents the radius from being over-inflated because of a vertex that is lightly influenced by a faraway bone
-                dist *= i->second.weight;
+                dist *= assign.weight;
                 maxRadius = std::max( maxRadius, dist );
             }
         }
@@ -1078,10 +1250,18 @@ namespace Ogre {
                     }
                 }
             }
+            // packed assignments are read from the blend buffers without unpacking them
+            vector<VertexBoneAssignment>::type packedAssignments;
             if (sharedVertexData)
             {
                 // check shared vertices
-                radius = _computeBoneBoundingRadiusHelper(sharedVertexData, mBoneAssignments, bonePositions, boneChildren);
+                if (mBoneAssignmentsPacked)
+                {
+                    decompileBoneAssignments(sharedVertexData, sharedBlendIndexToBoneIndexMap, packedAssignments);
+                    radius = _computeBoneBoundingRadiusHelper(sharedVertexData, packedAssignments, bonePositions, boneChildren);
+                }
+                else
+                    radius = _computeBoneBoundingRadiusHelper(sharedVertexData, mBoneAssignments, bonePositions, boneChildren);
             }
 
             // check submesh vertices
@@ -1093,7 +1273,14 @@ namespace Ogre {
                 SubMesh* submesh = *itor;
                 if (!submesh->useSharedVertices && submesh->vertexData)
                 {
-                    Real r = _computeBoneBoundingRadiusHelper(submesh->vertexData, submesh->mBoneAssignments, bonePositions, boneChildren);
+                    Real r;
+                    if (submesh->mBoneAssignmentsPacked)
+                    {
+                        decompileBoneAssignments(submesh->vertexData, submesh->blendIndexToBoneIndexMap, packedAssignments);
+                        r = _computeBoneBoundingRadiusHelper(submesh->vertexData, packedAssignments, bonePositions, boneChildren);
+                    }
+                    else
+                        r = _computeBoneBoundingRadiusHelper(submesh->vertexData, submesh->mBoneAssignments, bonePositions, boneChildren);
                     radius = std::max( radius, r );
                 }
                 ++itor;
@@ -1118,6 +1305,7 @@ namespace Ogre {
     //---------------------------------------------------------------------
     Mesh::BoneAssignmentIterator Mesh::getBoneAssignmentIterator(void)
     {
+        _unpackBoneAssignments();
         return BoneAssignmentIterator(mBoneAssignments.begin(),
             mBoneAssignments.end());
     }
@@ -1456,6 +1644,12 @@ namespace Ogre {
         bool splitMirrored, bool splitRotated, bool storeParityInW)
     {
 
+        // Split vertices copy their bone assignments, which therefore have to be unpacked
+        // before the vertex data changes
+        _unpackBoneAssignments();
+        for (SubMeshList::iterator i = mSubMeshList.begin(); i != mSubMeshList.end(); ++i)
+            (*i)->_unpackBoneAssignments();
+
         TangentSpaceCalc tangentsCalc;
         tangentsCalc.setSplitMirrored(splitMirrored);
         tangentsCalc.setSplitRotated(splitRotated);
@@ -2037,7 +2231,10 @@ namespace Ogre {
             destElemNorm->baseVertexPointerToElement(pBuffer, &pDestNorm);
         }
 
-        OptimisedUtil::getImplementation()->softwareVertexSkinning(
+        // Large meshes are blended in ranges across the worker threads
+        Root* root = Root::getSingletonPtr();
+        OptimisedUtil::getImplementation()->softwareVertexSkinningParallel(
+            root ? root->getThreadPool() : NULL,
             pSrcPos, pDestPos,
             pSrcNorm, pDestNorm,
             pBlendWeight, pBlendIdx,
@@ -40,11 +40,15 @@ namespace Ogre {
         // Note MUST be added in reverse order so latest is first in the list
 
         // This one is a little ugly, 1.10 is used for version 1.1 legacy meshes.
-        // So bump up to 1.100
+        // So bump up to 1.100, and 1.110 for 1.11
         mVersionData.push_back(OGRE_NEW MeshVersionData(
-            MESH_VERSION_1_10, "[MeshSerializer_v1.100]", 
+            MESH_VERSION_1_11, "[MeshSerializer_v1.110]", 
             OGRE_NEW MeshSerializerImpl()));
 
+        mVersionData.push_back(OGRE_NEW MeshVersionData(
+            MESH_VERSION_1_10, "[MeshSerializer_v1.100]", 
+            OGRE_NEW MeshSerializerImpl_v1_10()));
+
         mVersionData.push_back(OGRE_NEW MeshVersionData(
             MESH_VERSION_1_8, "[MeshSerializer_v1.8]", 
             OGRE_NEW MeshSerializerImpl_v1_8()));
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "OgreAnimationTrack.h"
 #include "OgreLodStrategyManager.h"
 #include "OgreDistanceLodStrategy.h"
+#include "OgreThreadPool.h"
 
 #if OGRE_COMPILER == OGRE_COMPILER_MSVC
 // Disable conversion warnings, we do a lot of them, intentionally
@@ -46,9 +47,10 @@ namespace Ogre {
     const long MSTREAM_OVERHEAD_SIZE = sizeof(uint16) + sizeof(uint32);
     //---------------------------------------------------------------------
     MeshSerializerImpl::MeshSerializerImpl()
+        : mStreamData(0)
     {
         // Version number
-        mVersion = "[MeshSerializer_v1.100]";
+        mVersion = "[MeshSerializer_v1.110]";
     }
     //---------------------------------------------------------------------
     MeshSerializerImpl::~MeshSerializerImpl()
@@ -99,23 +101,40 @@ namespace Ogre {
 #if OGRE_SERIALIZER_VALIDATE_CHUNKSIZE
         enableValidation();
 #endif
-        // Check header
-        readFileHeader(stream);
-        pushInnerChunk(stream);
-        unsigned short streamID = readChunk(stream);
+        // Buffer payloads can be referenced in place if the whole file is in memory
+        MemoryDataStream* memStream = dynamic_cast<MemoryDataStream*>(stream.get());
+        mStreamData = memStream ? memStream->getPtr() : 0;
+        mPendingBufferData.clear();
 
-        while(!stream->eof())
+        try
         {
-            switch (streamID)
+            // Check header
+            readFileHeader(stream);
+            pushInnerChunk(stream);
+            unsigned short streamID = readChunk(stream);
+
+            while(!stream->eof())
             {
-            case M_MESH:
-                readMesh(stream, pMesh, listener);
-                break;
+                switch (streamID)
+                {
+                case M_MESH:
+                    readMesh(stream, pMesh, listener);
+                    break;
+                }
+
+                streamID = readChunk(stream);
             }
+            popInnerChunk(stream);
 
-            streamID = readChunk(stream);
+            flushBufferData();
         }
-        popInnerChunk(stream);
+        catch (...)
+        {
+            mPendingBufferData.clear();
+            mStreamData = 0;
+            throw;
+        }
+        mStreamData = 0;
     }
     //---------------------------------------------------------------------
     void MeshSerializerImpl::writeMesh(const Mesh* pMesh)
@@ -152,17 +171,10 @@ namespace Ogre {
             LogManager::getSingleton().logMessage("Skeleton link exported.");
 
             // Write bone assignments
-            if (!pMesh->mBoneAssignments.empty())
+            if (!pMesh->getBoneAssignments().empty())
             {
                 LogManager::getSingleton().logMessage("Exporting shared geometry bone assignments...");
-
-                Mesh::VertexBoneAssignmentList::const_iterator vi;
-                for (vi = pMesh->mBoneAssignments.begin();
-                vi != pMesh->mBoneAssignments.end(); ++vi)
-                {
-                    writeMeshBoneAssignment(vi->second);
-                }
-
+                writeMeshBoneAssignments(pMesh);
                 LogManager::getSingleton().logMessage("Shared geometry bone assignments exported.");
             }
         }
@@ -286,15 +298,10 @@ namespace Ogre {
         writeSubMeshOperation(s);
 
         // Bone assignments
-        if (!s->mBoneAssignments.empty())
+        if (!s->getBoneAssignments().empty())
         {
             LogManager::getSingleton().logMessage("Exporting dedicated geometry bone assignments...");
-            SubMesh::VertexBoneAssignmentList::const_iterator vi;
-            for (vi = s->mBoneAssignments.begin();
-            vi != s->mBoneAssignments.end(); ++vi)
-            {
-                writeSubMeshBoneAssignment(vi->second);
-            }
+            writeSubMeshBoneAssignments(s);
             LogManager::getSingleton().logMessage("Dedicated geometry bone assignments exported.");
         }
         popInnerChunk(mStream);
@@ -537,7 +544,8 @@ namespace Ogre {
         {
             size += calcSkeletonLinkSize(pMesh->getSkeletonName());
             // Write bone assignments
-            size += pMesh->mBoneAssignments.size() * calcBoneAssignmentSize();
+            if (!pMesh->getBoneAssignments().empty())
+                size += calcMeshBoneAssignmentsSize(pMesh);
         }
         
 #if !OGRE_NO_MESHLOD
@@ -605,14 +613,9 @@ namespace Ogre {
         size += calcSubMeshOperationSize(pSub);
 
         // Bone assignments
-        if (!pSub->mBoneAssignments.empty())
+        if (!pSub->getBoneAssignments().empty())
         {
-            SubMesh::VertexBoneAssignmentList::const_iterator vi;
-            for (vi = pSub->mBoneAssignments.begin();
-                 vi != pSub->mBoneAssignments.end(); ++vi)
-            {
-                size += calcBoneAssignmentSize();
-            }
+            size += calcSubMeshBoneAssignmentsSize(pSub);
         }
 
         return size;
@@ -814,16 +817,9 @@ namespace Ogre {
             dest->vertexCount,
             pMesh->mVertexBufferUsage,
             pMesh->mVertexBufferShadowBuffer);
-        void* pBuf = vbuf->lock(HardwareBuffer::HBL_DISCARD);
-        stream->read(pBuf, dest->vertexCount * vertexSize);
-
-        // endian conversion for OSX
-        flipFromLittleEndian(
-            pBuf,
-            dest->vertexCount,
-            vertexSize,
-            dest->vertexDeclaration->findElementsBySource(bindIndex));
-        vbuf->unlock();
+        VertexDeclaration::VertexElementList elems =
+            dest->vertexDeclaration->findElementsBySource(bindIndex);
+        readBufferData(stream, vbuf, vertexSize, &elems);
 
         // Set binding
         dest->vertexBufferBinding->setBinding(bindIndex, vbuf);
@@ -832,6 +828,156 @@ namespace Ogre {
 
     }
     //---------------------------------------------------------------------
+    void MeshSerializerImpl::readBufferData(DataStreamPtr& stream, const SharedPtr<HardwareBuffer>& buf,
+        size_t elementSize, const VertexDeclaration::VertexElementList* elems)
+    {
+        size_t size = buf->getSizeInBytes();
+        if (mStreamData)
+        {
+            if (stream->tell() + size > stream->size())
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Buffer data exceeds the end of " + stream->getName(),
+                    "MeshSerializerImpl::readBufferData");
+            }
+            PendingBufferData pending;
+            pending.buffer = buf;
+            pending.source = mStreamData + stream->tell();
+            pending.elementSize = elementSize;
+            if (elems)
+                pending.elems = *elems;
+            mPendingBufferData.push_back(pending);
+            stream->skip(static_cast<long>(size));
+            return;
+        }
+
+        void* pBuf = buf->lock(HardwareBuffer::HBL_DISCARD);
+        stream->read(pBuf, size);
+        // endian conversion for OSX
+        if (mFlipEndian)
+            flipBufferData(pBuf, size / elementSize, elementSize,
+                elems ? *elems : VertexDeclaration::VertexElementList());
+        buf->unlock();
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl::flushBufferData()
+    {
+        if (mPendingBufferData.empty())
+            return;
+
+        // Locking has to happen on this thread, only copying and flipping is done in parallel
+        vector<uchar*>::type dest(mPendingBufferData.size());
+        for (size_t i = 0; i < mPendingBufferData.size(); ++i)
+            dest[i] = static_cast<uchar*>(mPendingBufferData[i].buffer->lock(HardwareBuffer::HBL_DISCARD));
+
+        // Split large buffers into blocks, so that a single huge buffer is spread
+        // over all threads as well
+        const size_t blockSize = 1024 * 1024;
+        struct Block
+        {
+            size_t buffer;
+            size_t offset;
+            size_t size;
+        };
+        vector<Block>::type blocks;
+        for (size_t i = 0; i < mPendingBufferData.size(); ++i)
+        {
+            size_t elementSize = mPendingBufferData[i].elementSize;
+            size_t step = std::max(blockSize / elementSize, size_t(1)) * elementSize;
+            size_t size = mPendingBufferData[i].buffer->getSizeInBytes();
+            for (size_t offset = 0; offset < size; offset += step)
+            {
+                Block block = { i, offset, std::min(step, size - offset) };
+                blocks.push_back(block);
+            }
+        }
+
+        PendingBufferDataList& pendingData = mPendingBufferData;
+        bool flip = mFlipEndian;
+        auto copyBlocks = [this, &blocks, &dest, &pendingData, flip](size_t begin, size_t end, size_t) {
+            for (size_t b = begin; b < end; ++b)
+            {
+                const Block& block = blocks[b];
+                const PendingBufferData& pending = pendingData[block.buffer];
+                uchar* pDest = dest[block.buffer] + block.offset;
+                memcpy(pDest, pending.source + block.offset, block.size);
+                if (flip)
+                    flipBufferData(pDest, block.size / pending.elementSize, pending.elementSize, pending.elems);
+            }
+        };
+
+        Root* root = Root::getSingletonPtr();
+        ThreadPool* pool = root ? root->getThreadPool() : NULL;
+        if (pool && blocks.size() > 1)
+        {
+            try
+            {
+                pool->parallelFor(0, blocks.size(), 1, copyBlocks);
+            }
+            catch (...)
+            {
+                for (size_t i = 0; i < mPendingBufferData.size(); ++i)
+                    mPendingBufferData[i].buffer->unlock();
+                throw;
+            }
+        }
+        else
+        {
+            copyBlocks(0, blocks.size(), 0);
+        }
+
+        for (size_t i = 0; i < mPendingBufferData.size(); ++i)
+            mPendingBufferData[i].buffer->unlock();
+        mPendingBufferData.clear();
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl::flipBufferData(void* pData, size_t count, size_t elementSize,
+        const VertexDeclaration::VertexElementList& elems)
+    {
+        if (elems.empty())
+        {
+            // Index data
+            if (elementSize == sizeof(uint16))
+            {
+                uint16* p = static_cast<uint16*>(pData);
+                for (size_t i = 0; i < count; ++i)
+                    p[i] = Bitwise::bswap16(p[i]);
+            }
+            else
+            {
+                uint32* p = static_cast<uint32*>(pData);
+                for (size_t i = 0; i < count; ++i)
+                    p[i] = Bitwise::bswap32(p[i]);
+            }
+            return;
+        }
+
+        // Vertices made up of 4 byte components only (floats, colours) can be flipped
+        // as one flat array, which the compiler turns into a vectorised loop
+        size_t flatSize = 0;
+        VertexDeclaration::VertexElementList::const_iterator ei;
+        for (ei = elems.begin(); ei != elems.end(); ++ei)
+        {
+            VertexElementType baseType = VertexElement::getBaseType(ei->getType());
+            if (baseType != VET_FLOAT1 && baseType != VET_INT1 && baseType != VET_UINT1 &&
+                baseType != VET_COLOUR && baseType != VET_COLOUR_ABGR && baseType != VET_COLOUR_ARGB)
+            {
+                flatSize = 0;
+                break;
+            }
+            flatSize += ei->getSize();
+        }
+        if (flatSize == elementSize && elementSize % sizeof(uint32) == 0)
+        {
+            uint32* p = static_cast<uint32*>(pData);
+            size_t n = count * elementSize / sizeof(uint32);
+            for (size_t i = 0; i < n; ++i)
+                p[i] = Bitwise::bswap32(p[i]);
+            return;
+        }
+
+        flipEndian(pData, count, elementSize, elems);
+    }
+    //---------------------------------------------------------------------
     void MeshSerializerImpl::readSubMeshNameTable(DataStreamPtr& stream, Mesh* pMesh)
     {
         // The map for
@@ -905,6 +1051,7 @@ namespace Ogre {
                  streamID == M_SUBMESH ||
                  streamID == M_MESH_SKELETON_LINK ||
                  streamID == M_MESH_BONE_ASSIGNMENT ||
+                 streamID == M_MESH_PACKED_BONE_ASSIGNMENTS ||
                  streamID == M_MESH_LOD_LEVEL ||
                  streamID == M_MESH_BOUNDS ||
                  streamID == M_SUBMESH_NAME_TABLE ||
@@ -938,6 +1085,13 @@ namespace Ogre {
                 case M_MESH_BONE_ASSIGNMENT:
                     readMeshBoneAssignment(stream, pMesh);
                     break;
+                case M_MESH_PACKED_BONE_ASSIGNMENTS:
+                    readPackedBoneAssignments(stream, pMesh, pMesh->sharedVertexData,
+                        pMesh->sharedBlendIndexToBoneIndexMap);
+                    pMesh->mBoneAssignments.clear();
+                    pMesh->mBoneAssignmentsOutOfDate = false;
+                    pMesh->mBoneAssignmentsPacked = true;
+                    break;
                 case M_MESH_LOD_LEVEL:
                     readMeshLodLevel(stream, pMesh);
                     break;
@@ -1011,12 +1165,7 @@ namespace Ogre {
                         pMesh->mIndexBufferUsage,
                         pMesh->mIndexBufferShadowBuffer);
                 // unsigned int* faceVertexIndices
-                unsigned int* pIdx = static_cast<unsigned int*>(
-                    ibuf->lock(HardwareBuffer::HBL_DISCARD)
-                    );
-                readInts(stream, pIdx, sm->indexData->indexCount);
-                ibuf->unlock();
-
+                readBufferData(stream, ibuf, sizeof(uint32), NULL);
             }
             else // 16-bit
             {
@@ -1026,11 +1175,7 @@ namespace Ogre {
                         pMesh->mIndexBufferUsage,
                         pMesh->mIndexBufferShadowBuffer);
                 // unsigned short* faceVertexIndices
-                unsigned short* pIdx = static_cast<unsigned short*>(
-                    ibuf->lock(HardwareBuffer::HBL_DISCARD)
-                    );
-                readShorts(stream, pIdx, sm->indexData->indexCount);
-                ibuf->unlock();
+                readBufferData(stream, ibuf, sizeof(uint16), NULL);
             }
         }
         sm->indexData->indexBuffer = ibuf;
@@ -1057,6 +1202,7 @@ namespace Ogre {
             streamID = readChunk(stream);
             while(!stream->eof() &&
                 (streamID == M_SUBMESH_BONE_ASSIGNMENT ||
+                 streamID == M_SUBMESH_PACKED_BONE_ASSIGNMENTS ||
                  streamID == M_SUBMESH_OPERATION ||
                  streamID == M_SUBMESH_TEXTURE_ALIAS))
             {
@@ -1068,6 +1214,13 @@ namespace Ogre {
                 case M_SUBMESH_BONE_ASSIGNMENT:
                     readSubMeshBoneAssignment(stream, pMesh, sm);
                     break;
+                case M_SUBMESH_PACKED_BONE_ASSIGNMENTS:
+                    readPackedBoneAssignments(stream, pMesh, sm->vertexData,
+                        sm->blendIndexToBoneIndexMap);
+                    sm->mBoneAssignments.clear();
+                    sm->mBoneAssignmentsOutOfDate = false;
+                    sm->mBoneAssignmentsPacked = true;
+                    break;
                 case M_SUBMESH_TEXTURE_ALIAS:
                     readSubMeshTextureAlias(stream, pMesh, sm);
                     break;
@@ -1195,6 +1348,191 @@ namespace Ogre {
 
     }
     //---------------------------------------------------------------------
+    void MeshSerializerImpl::writeMeshBoneAssignments(const Mesh* pMesh)
+    {
+        const Mesh::VertexBoneAssignmentList& assignments = pMesh->getBoneAssignments();
+        unsigned short numBlendWeights = getPackedBlendWeightCount(assignments, pMesh->sharedVertexData);
+        if (numBlendWeights)
+        {
+            writePackedBoneAssignments(M_MESH_PACKED_BONE_ASSIGNMENTS, assignments,
+                pMesh->sharedVertexData->vertexCount, numBlendWeights);
+            return;
+        }
+
+        Mesh::VertexBoneAssignmentList::const_iterator vi;
+        for (vi = assignments.begin(); vi != assignments.end(); ++vi)
+        {
+            writeMeshBoneAssignment(vi->second);
+        }
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl::writeSubMeshBoneAssignments(const SubMesh* s)
+    {
+        const SubMesh::VertexBoneAssignmentList& assignments = s->getBoneAssignments();
+        const VertexData* vertexData = s->useSharedVertices ? NULL : s->vertexData;
+        unsigned short numBlendWeights = getPackedBlendWeightCount(assignments, vertexData);
+        if (numBlendWeights)
+        {
+            writePackedBoneAssignments(M_SUBMESH_PACKED_BONE_ASSIGNMENTS, assignments,
+                vertexData->vertexCount, numBlendWeights);
+            return;
+        }
+
+        SubMesh::VertexBoneAssignmentList::const_iterator vi;
+        for (vi = assignments.begin(); vi != assignments.end(); ++vi)
+        {
+            writeSubMeshBoneAssignment(vi->second);
+        }
+    }
+    //---------------------------------------------------------------------
+    unsigned short MeshSerializerImpl::getPackedBlendWeightCount(
+        const Mesh::VertexBoneAssignmentList& assignments, const VertexData* vertexData)
+    {
+        if (!vertexData || assignments.empty())
+            return 0;
+
+        // Anything the blend buffers can't represent is kept as separate assignments
+        size_t maxBones = 0;
+        Mesh::VertexBoneAssignmentList::const_iterator i = assignments.begin();
+        while (i != assignments.end())
+        {
+            if (i->first >= vertexData->vertexCount)
+                return 0;
+            size_t count = assignments.count(i->first);
+            maxBones = std::max(maxBones, count);
+            std::advance(i, count);
+        }
+        if (maxBones > OGRE_MAX_BLEND_WEIGHTS)
+            return 0;
+
+        Mesh::IndexMap boneIndexToBlendIndexMap, blendIndexToBoneIndexMap;
+        Mesh::buildIndexMap(assignments, boneIndexToBlendIndexMap, blendIndexToBoneIndexMap);
+        if (blendIndexToBoneIndexMap.size() > 256)
+            return 0;
+
+        return static_cast<unsigned short>(maxBones);
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl::writePackedBoneAssignments(uint16 chunkID,
+        const Mesh::VertexBoneAssignmentList& assignments, size_t vertexCount,
+        unsigned short numBlendWeights)
+    {
+        Mesh::IndexMap boneIndexToBlendIndexMap, blendIndexToBoneIndexMap;
+        Mesh::buildIndexMap(assignments, boneIndexToBlendIndexMap, blendIndexToBoneIndexMap);
+
+        vector<uint8>::type blendIndices(vertexCount * 4);
+        vector<float>::type blendWeights(vertexCount * numBlendWeights);
+        Mesh::packBoneAssignments(assignments, vertexCount, numBlendWeights,
+            boneIndexToBlendIndexMap, blendIndices.data(), blendWeights.data());
+
+        writeChunkHeader(chunkID, calcPackedBoneAssignmentsSize(
+            blendIndexToBoneIndexMap.size(), vertexCount, numBlendWeights));
+
+        // unsigned int vertexCount;
+        uint32 count = static_cast<uint32>(vertexCount);
+        writeInts(&count, 1);
+        // unsigned short numBlendWeights;
+        writeShorts(&numBlendWeights, 1);
+        // unsigned short numBlendIndices;
+        uint16 numBlendIndices = static_cast<uint16>(blendIndexToBoneIndexMap.size());
+        writeShorts(&numBlendIndices, 1);
+        // unsigned short* blendIndexToBoneIndex
+        writeShorts(blendIndexToBoneIndexMap.data(), numBlendIndices);
+        // unsigned char* blendIndices
+        writeData(blendIndices.data(), 1, blendIndices.size());
+        // float* blendWeights
+        writeFloats(blendWeights.data(), blendWeights.size());
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl::readPackedBoneAssignments(DataStreamPtr& stream, Mesh* pMesh,
+        VertexData* dest, Mesh::IndexMap& blendIndexToBoneIndexMap)
+    {
+        uint32 vertexCount;
+        readInts(stream, &vertexCount, 1);
+        uint16 numBlendWeights, numBlendIndices;
+        readShorts(stream, &numBlendWeights, 1);
+        readShorts(stream, &numBlendIndices, 1);
+
+        // blend indices are stored as bytes, so no more than 256 bones can be addressed
+        if (!dest || dest->vertexCount != vertexCount ||
+            numBlendWeights == 0 || numBlendWeights > OGRE_MAX_BLEND_WEIGHTS ||
+            numBlendIndices > 256)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Packed bone assignments do not match the geometry in " + pMesh->getName(),
+                "MeshSerializerImpl::readPackedBoneAssignments");
+        }
+
+        blendIndexToBoneIndexMap.resize(numBlendIndices);
+        readShorts(stream, blendIndexToBoneIndexMap.data(), numBlendIndices);
+
+        // Read both arrays in one go and compile them straight into the blend buffer
+        vector<uint8>::type blendIndices(vertexCount * 4);
+        vector<float>::type blendWeights(vertexCount * numBlendWeights);
+        stream->read(blendIndices.data(), blendIndices.size());
+        readFloats(stream, blendWeights.data(), blendWeights.size());
+
+        for (size_t i = 0; i < blendIndices.size(); ++i)
+        {
+            if (blendIndices[i] >= numBlendIndices)
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                    "Packed bone assignments reference a missing blend index in " + pMesh->getName(),
+                    "MeshSerializerImpl::readPackedBoneAssignments");
+            }
+        }
+
+        pMesh->compileBoneAssignments(blendIndices.data(), blendWeights.data(), numBlendWeights, dest);
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl::calcMeshBoneAssignmentsSize(const Mesh* pMesh)
+    {
+        const Mesh::VertexBoneAssignmentList& assignments = pMesh->getBoneAssignments();
+        unsigned short numBlendWeights = getPackedBlendWeightCount(assignments, pMesh->sharedVertexData);
+        if (numBlendWeights)
+        {
+            Mesh::IndexMap boneIndexToBlendIndexMap, blendIndexToBoneIndexMap;
+            Mesh::buildIndexMap(assignments, boneIndexToBlendIndexMap, blendIndexToBoneIndexMap);
+            return calcPackedBoneAssignmentsSize(blendIndexToBoneIndexMap.size(),
+                pMesh->sharedVertexData->vertexCount, numBlendWeights);
+        }
+        return assignments.size() * calcBoneAssignmentSize();
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl::calcSubMeshBoneAssignmentsSize(const SubMesh* pSub)
+    {
+        const SubMesh::VertexBoneAssignmentList& assignments = pSub->getBoneAssignments();
+        const VertexData* vertexData = pSub->useSharedVertices ? NULL : pSub->vertexData;
+        unsigned short numBlendWeights = getPackedBlendWeightCount(assignments, vertexData);
+        if (numBlendWeights)
+        {
+            Mesh::IndexMap boneIndexToBlendIndexMap, blendIndexToBoneIndexMap;
+            Mesh::buildIndexMap(assignments, boneIndexToBlendIndexMap, blendIndexToBoneIndexMap);
+            return calcPackedBoneAssignmentsSize(blendIndexToBoneIndexMap.size(),
+                vertexData->vertexCount, numBlendWeights);
+        }
+        return assignments.size() * calcBoneAssignmentSize();
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl::calcPackedBoneAssignmentsSize(size_t numBlendIndices,
+        size_t vertexCount, unsigned short numBlendWeights)
+    {
+        size_t size = MSTREAM_OVERHEAD_SIZE;
+
+        // unsigned int vertexCount
+        size += sizeof(uint32);
+        // unsigned short numBlendWeights, numBlendIndices
+        size += sizeof(uint16) * 2;
+        // blend index to bone index map
+        size += sizeof(uint16) * numBlendIndices;
+        // blend indices
+        size += sizeof(uint8) * 4 * vertexCount;
+        // blend weights
+        size += sizeof(float) * numBlendWeights * vertexCount;
+
+        return size;
+    }
+    //---------------------------------------------------------------------
     size_t MeshSerializerImpl::calcBoneAssignmentSize(void)
     {
         size_t size = MSTREAM_OVERHEAD_SIZE;
@@ -1589,19 +1927,10 @@ namespace Ogre {
                 indexData->indexBuffer = pMesh->getHardwareBufferManager()->createIndexBuffer(
                     idx32Bit ? HardwareIndexBuffer::IT_32BIT : HardwareIndexBuffer::IT_16BIT,
                     buffIndexCount, pMesh->mIndexBufferUsage, pMesh->mIndexBufferShadowBuffer);
-                void* pIdx = static_cast<unsigned int*>(indexData->indexBuffer->lock(
-                    0, indexData->indexBuffer->getSizeInBytes(), HardwareBuffer::HBL_DISCARD));
 
                 // unsigned short*/int* faceIndexes;  ((v1, v2, v3) * numFaces)
-                if (idx32Bit)
-                {
-                    readInts(stream, (uint32*)pIdx, buffIndexCount);
-                }
-                else
-                {
-                    readShorts(stream, (uint16*)pIdx, buffIndexCount);
-                }
-                indexData->indexBuffer->unlock();
+                readBufferData(stream, indexData->indexBuffer,
+                    idx32Bit ? sizeof(uint32) : sizeof(uint16), NULL);
             }
         }
     }
@@ -2664,10 +2993,7 @@ namespace Ogre {
                 vertexSize, vertexCount,
                 HardwareBuffer::HBU_STATIC, true);
         // float x,y,z          // repeat by number of vertices in original geometry
-        float* pDst = static_cast<float*>(
-            vbuf->lock(HardwareBuffer::HBL_DISCARD));
-        readFloats(stream, pDst, vertexCount * (includesNormals ? 6 : 3));
-        vbuf->unlock();
+        readBufferData(stream, vbuf, sizeof(float), NULL);
         kf->setVertexBuffer(vbuf);
 
     }
@@ -2746,6 +3072,48 @@ namespace Ogre {
     }
 
 
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    MeshSerializerImpl_v1_10::MeshSerializerImpl_v1_10()
+    {
+        // Version number
+        mVersion = "[MeshSerializer_v1.100]";
+    }
+    //---------------------------------------------------------------------
+    MeshSerializerImpl_v1_10::~MeshSerializerImpl_v1_10()
+    {
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_v1_10::writeMeshBoneAssignments(const Mesh* pMesh)
+    {
+        const Mesh::VertexBoneAssignmentList& assignments = pMesh->getBoneAssignments();
+        Mesh::VertexBoneAssignmentList::const_iterator vi;
+        for (vi = assignments.begin(); vi != assignments.end(); ++vi)
+        {
+            writeMeshBoneAssignment(vi->second);
+        }
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_v1_10::writeSubMeshBoneAssignments(const SubMesh* s)
+    {
+        const SubMesh::VertexBoneAssignmentList& assignments = s->getBoneAssignments();
+        SubMesh::VertexBoneAssignmentList::const_iterator vi;
+        for (vi = assignments.begin(); vi != assignments.end(); ++vi)
+        {
+            writeSubMeshBoneAssignment(vi->second);
+        }
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl_v1_10::calcMeshBoneAssignmentsSize(const Mesh* pMesh)
+    {
+        return pMesh->getBoneAssignments().size() * calcBoneAssignmentSize();
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl_v1_10::calcSubMeshBoneAssignmentsSize(const SubMesh* pSub)
+    {
+        return pSub->getBoneAssignments().size() * calcBoneAssignmentSize();
+    }
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
@@ -3022,28 +3390,14 @@ namespace Ogre {
                     indexData->indexBuffer = pMesh->getHardwareBufferManager()->createIndexBuffer(
                         HardwareIndexBuffer::IT_32BIT, indexData->indexCount,
                         pMesh->mIndexBufferUsage, pMesh->mIndexBufferShadowBuffer);
-                    unsigned int* pIdx = static_cast<unsigned int*>(
-                        indexData->indexBuffer->lock(
-                        0,
-                        indexData->indexBuffer->getSizeInBytes(),
-                        HardwareBuffer::HBL_DISCARD));
-
-                    readInts(stream, pIdx, indexData->indexCount);
-                    indexData->indexBuffer->unlock();
-
+                    readBufferData(stream, indexData->indexBuffer, sizeof(uint32), NULL);
                 }
                 else
                 {
                     indexData->indexBuffer = pMesh->getHardwareBufferManager()->createIndexBuffer(
                         HardwareIndexBuffer::IT_16BIT, indexData->indexCount,
                         pMesh->mIndexBufferUsage, pMesh->mIndexBufferShadowBuffer);
-                    unsigned short* pIdx = static_cast<unsigned short*>(
-                        indexData->indexBuffer->lock(
-                        0,
-                        indexData->indexBuffer->getSizeInBytes(),
-                        HardwareBuffer::HBL_DISCARD));
-                    readShorts(stream, pIdx, indexData->indexCount);
-                    indexData->indexBuffer->unlock();
+                    readBufferData(stream, indexData->indexBuffer, sizeof(uint16), NULL);
                 }
             }
         }
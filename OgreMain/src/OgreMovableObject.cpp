@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgreLight.h"
 #include "OgreEntity.h"
 #include "OgreLodListener.h"
+#include "OgreSceneQueryBroadPhase.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -46,6 +47,8 @@ namespace Ogre {
         , mManager(0)
         , mParentNode(0)
         , mListener(0)
+        , mBroadPhase(0)
+        , mBroadPhaseProxy(0)
         , mParentIsTagPoint(false)
         , mVisible(true)
         , mDebugDisplay(false)
@@ -92,6 +95,10 @@ namespace Ogre {
                 static_cast<SceneNode*>(mParentNode)->detachObject(this);
             }
         }
+
+        // detaching removes the object from the scene query index, unless it was not notified
+        if (mBroadPhase)
+            mBroadPhase->_notifyObjectDetached(this);
     }
     //-----------------------------------------------------------------------
     void MovableObject::_notifyAttached(Node* parent, bool isTagPoint)
@@ -103,6 +110,19 @@ namespace Ogre {
         mParentNode = parent;
         mParentIsTagPoint = isTagPoint;
 
+        // Keep the scene query index of our manager in sync
+        if (mParentNode)
+        {
+            SceneQueryBroadPhase* broadPhase =
+                mManager ? mManager->_getSceneQueryBroadPhase(false) : 0;
+            if (broadPhase)
+                broadPhase->_notifyObjectAttached(this);
+        }
+        else if (mBroadPhase)
+        {
+            mBroadPhase->_notifyObjectDetached(this);
+        }
+
         // Mark light list being dirty, simply decrease
         // counter by one for minimise overhead
         --mLightListUpdated;
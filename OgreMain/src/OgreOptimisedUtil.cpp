@@ -27,6 +27,7 @@ THE SOFTWARE.
 */
 #include "OgreStableHeaders.h"
 #include "OgreOptimisedUtil.h"
+#include "OgreThreadPool.h"
 
 //#define __DO_PROFILE__
 
@@ -37,6 +38,9 @@ namespace Ogre {
     extern OptimisedUtil* _getOptimisedUtilGeneral(void);
 #if __OGRE_HAVE_SSE
     extern OptimisedUtil* _getOptimisedUtilSSE(void);
+#if __OGRE_HAVE_AVX2
+    extern OptimisedUtil* _getOptimisedUtilAVX2(void);
+#endif
 //#elif __OGRE_HAVE_NEON
 //    extern OptimisedUtil* _getOptimisedUtilNEON(void);
 //#elif __OGRE_HAVE_VFP
@@ -80,6 +84,9 @@ namespace Ogre {
             IMPL_DEFAULT,
 #if __OGRE_HAVE_SSE
             IMPL_SSE,
+#if __OGRE_HAVE_AVX2
+            IMPL_AVX2,
+#endif
 //#elif __OGRE_HAVE_NEON
 //            IMPL_NEON,
 //#elif __OGRE_HAVE_VFP
@@ -131,6 +138,13 @@ namespace Ogre {
             {
                 mOptimisedUtils.push_back(_getOptimisedUtilSSE());
             }
+#if __OGRE_HAVE_AVX2
+            if ((PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_AVX2) &&
+                (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_FMA))
+            {
+                mOptimisedUtils.push_back(_getOptimisedUtilAVX2());
+            }
+#endif
 //#elif __OGRE_HAVE_VFP
 //            if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_VFP)
 //            {
@@ -342,6 +356,89 @@ namespace Ogre {
             ++index;    // So we can put break point here even if in release build
         }
 
+        virtual void cullAxisAlignedBoxes(
+            const Plane* planes, size_t numPlanes,
+            const float* const centres[3],
+            const float* const halfSizes[3],
+            uint32* visibility,
+            size_t numBoxes)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->cullAxisAlignedBoxes(
+                planes, numPlanes,
+                centres,
+                halfSizes,
+                visibility,
+                numBoxes);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void cullSpheres(
+            const Plane* planes, size_t numPlanes,
+            const float* const centres[3],
+            const float* radii,
+            uint32* visibility,
+            size_t numSpheres)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->cullSpheres(
+                planes, numPlanes,
+                centres,
+                radii,
+                visibility,
+                numSpheres);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
+        virtual void expandBillboardQuads(
+            const float* centres,
+            const float* offsets, size_t offsetStride,
+            const uint32* colours,
+            const float* texcoordRects,
+            float* dest,
+            size_t numBillboards)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            impl->expandBillboardQuads(
+                centres,
+                offsets, offsetStride,
+                colours,
+                texcoordRects,
+                dest,
+                numBillboards);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+        }
+
     };
 #endif // __DO_PROFILE__
 
@@ -396,6 +493,14 @@ namespace Ogre {
 #else   // !__DO_PROFILE__
 
 #if __OGRE_HAVE_SSE
+#if __OGRE_HAVE_AVX2
+        if ((PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_AVX2) &&
+            (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_FMA))
+        {
+            return _getOptimisedUtilAVX2();
+        }
+        else
+#endif
         if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE)
         {
             return _getOptimisedUtilSSE();
@@ -424,5 +529,80 @@ namespace Ogre {
 
 #endif  // __DO_PROFILE__
     }
+    //---------------------------------------------------------------------
+    OptimisedUtil::ImplementationList OptimisedUtil::getAvailableImplementations(void)
+    {
+        ImplementationList impls;
+        impls.push_back(NamedImplementation("General", _getOptimisedUtilGeneral()));
+#if __OGRE_HAVE_SSE
+        if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE)
+        {
+            impls.push_back(NamedImplementation("SSE", _getOptimisedUtilSSE()));
+        }
+#if __OGRE_HAVE_AVX2
+        if ((PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_AVX2) &&
+            (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_FMA))
+        {
+            impls.push_back(NamedImplementation("AVX2", _getOptimisedUtilAVX2()));
+        }
+#endif
+#endif
+#if __OGRE_HAVE_DIRECTXMATH
+        impls.push_back(NamedImplementation("DirectXMath", _getOptimisedUtilDirectXMath()));
+#endif
+        return impls;
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtil::softwareVertexSkinningParallel(
+        ThreadPool* pool,
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const Affine3* const* blendMatrices,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        // Vertices per task, a multiple of 4 keeps the ranges of packed float3 buffers
+        // 16 bytes aligned, so the SIMD implementations stay on their unrolled path
+        const size_t SKINNING_TASK_VERTICES = 1024;
+
+        size_t numTasks = numVertices / SKINNING_TASK_VERTICES;
+        if (!pool || numTasks < 2)
+        {
+            softwareVertexSkinning(
+                pSrcPos, pDestPos,
+                pSrcNorm, pDestNorm,
+                pBlendWeight, pBlendIndex,
+                blendMatrices,
+                srcPosStride, destPosStride,
+                srcNormStride, destNormStride,
+                blendWeightStride, blendIndexStride,
+                numWeightsPerVertex,
+                numVertices);
+            return;
+        }
+
+        // The last range takes the remainder, so no range is smaller than a task
+        pool->parallelFor(0, numTasks, 1, [=](size_t begin, size_t end, size_t) {
+            size_t first = begin * SKINNING_TASK_VERTICES;
+            size_t last = end == numTasks ? numVertices : end * SKINNING_TASK_VERTICES;
+            softwareVertexSkinning(
+                rawOffsetPointer(pSrcPos, first * srcPosStride),
+                rawOffsetPointer(pDestPos, first * destPosStride),
+                pSrcNorm ? rawOffsetPointer(pSrcNorm, first * srcNormStride) : NULL,
+                pSrcNorm ? rawOffsetPointer(pDestNorm, first * destNormStride) : NULL,
+                rawOffsetPointer(pBlendWeight, first * blendWeightStride),
+                rawOffsetPointer(pBlendIndex, first * blendIndexStride),
+                blendMatrices,
+                srcPosStride, destPosStride,
+                srcNormStride, destNormStride,
+                blendWeightStride, blendIndexStride,
+                numWeightsPerVertex,
+                last - first);
+        });
+    }
 
 }
@@ -0,0 +1,635 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreOptimisedUtil.h"
+
+#if __OGRE_HAVE_AVX2
+
+#include <immintrin.h>
+
+// The rest of Ogre is built for SSE only, so enable AVX2 and FMA per function
+// rather than for the whole file. That way the compiler can't emit AVX code into
+// anything that might run before the CPU features are checked.
+#if OGRE_COMPILER == OGRE_COMPILER_GNUC || OGRE_COMPILER == OGRE_COMPILER_CLANG
+#define __OGRE_AVX2_TARGET __attribute__((target("avx2,fma")))
+#else
+#define __OGRE_AVX2_TARGET
+#endif
+
+namespace Ogre {
+
+//-------------------------------------------------------------------------
+// Local classes
+//-------------------------------------------------------------------------
+
+    /** AVX2 implementation of OptimisedUtil.
+    @remarks
+        Software vertex skinning and culling have AVX2 versions, all other
+        functions are forwarded to the SSE implementation.
+    @note
+        Don't use this class directly, use OptimisedUtil instead.
+    */
+    class _OgrePrivate OptimisedUtilAVX2 : public OptimisedUtil
+    {
+    protected:
+        /// The implementation the functions without an AVX2 version forward to
+        OptimisedUtil* mFallback;
+
+    public:
+        /// Constructor
+        OptimisedUtilAVX2(OptimisedUtil* fallback)
+            : mFallback(fallback)
+        {
+        }
+
+        /// @copydoc OptimisedUtil::softwareVertexSkinning
+        virtual void softwareVertexSkinning(
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const Affine3* const* blendMatrices,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices);
+
+        /// @copydoc OptimisedUtil::softwareVertexMorph
+        virtual void softwareVertexMorph(
+            Real t,
+            const float *srcPos1, const float *srcPos2,
+            float *dstPos,
+            size_t pos1VSize, size_t pos2VSize, size_t dstVSize, 
+            size_t numVertices,
+            bool morphNormals)
+        {
+            mFallback->softwareVertexMorph(
+                t, srcPos1, srcPos2, dstPos, pos1VSize, pos2VSize, dstVSize, numVertices, morphNormals);
+        }
+
+        /// @copydoc OptimisedUtil::concatenateAffineMatrices
+        virtual void concatenateAffineMatrices(
+            const Affine3& baseMatrix,
+            const Affine3* srcMatrices,
+            Affine3* dstMatrices,
+            size_t numMatrices)
+        {
+            mFallback->concatenateAffineMatrices(baseMatrix, srcMatrices, dstMatrices, numMatrices);
+        }
+
+        /// @copydoc OptimisedUtil::calculateFaceNormals
+        virtual void calculateFaceNormals(
+            const float *positions,
+            const EdgeData::Triangle *triangles,
+            Vector4 *faceNormals,
+            size_t numTriangles)
+        {
+            mFallback->calculateFaceNormals(positions, triangles, faceNormals, numTriangles);
+        }
+
+        /// @copydoc OptimisedUtil::calculateLightFacing
+        virtual void calculateLightFacing(
+            const Vector4& lightPos,
+            const Vector4* faceNormals,
+            char* lightFacings,
+            size_t numFaces)
+        {
+            mFallback->calculateLightFacing(lightPos, faceNormals, lightFacings, numFaces);
+        }
+
+        /// @copydoc OptimisedUtil::extrudeVertices
+        virtual void extrudeVertices(
+            const Vector4& lightPos,
+            Real extrudeDist,
+            const float* srcPositions,
+            float* destPositions,
+            size_t numVertices)
+        {
+            mFallback->extrudeVertices(lightPos, extrudeDist, srcPositions, destPositions, numVertices);
+        }
+
+        /// @copydoc OptimisedUtil::cullAxisAlignedBoxes
+        virtual void cullAxisAlignedBoxes(
+            const Plane* planes, size_t numPlanes,
+            const float* const centres[3],
+            const float* const halfSizes[3],
+            uint32* visibility,
+            size_t numBoxes);
+
+        /// @copydoc OptimisedUtil::cullSpheres
+        virtual void cullSpheres(
+            const Plane* planes, size_t numPlanes,
+            const float* const centres[3],
+            const float* radii,
+            uint32* visibility,
+            size_t numSpheres);
+
+        /// @copydoc OptimisedUtil::expandBillboardQuads
+        virtual void expandBillboardQuads(
+            const float* centres,
+            const float* offsets, size_t offsetStride,
+            const uint32* colours,
+            const float* texcoordRects,
+            float* dest,
+            size_t numBillboards)
+        {
+            mFallback->expandBillboardQuads(
+                centres, offsets, offsetStride, colours, texcoordRects, dest, numBillboards);
+        }
+    };
+
+//-------------------------------------------------------------------------
+// Some useful macro and helpers
+//-------------------------------------------------------------------------
+
+    //---------------------------------------------------------------------
+    /// Loads a 3 float vector into the xyz lanes and 'w' into the w lane,
+    /// without reading past the end of the vector
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET __m128 _loadVector3AVX2(const float* p, __m128 w)
+    {
+        __m128 xy = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(p)));
+        __m128 zw = _mm_unpacklo_ps(_mm_load_ss(p + 2), w);
+        return _mm_movelh_ps(xy, zw);
+    }
+    //---------------------------------------------------------------------
+    /// Loads a 3 float vector into the xyz lanes of both halves and takes the w lanes
+    /// from 'w'. Reads 16 bytes, so there must be something after the vector.
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET __m256 _broadcastVector3AVX2(const float* p, __m256 w)
+    {
+        return _mm256_blend_ps(_mm256_broadcast_ps(reinterpret_cast<const __m128*>(p)), w, 0x88);
+    }
+    //---------------------------------------------------------------------
+    /// Stores the xyz lanes of a vector
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void _storeVector3AVX2(float* p, __m128 v)
+    {
+        _mm_storel_pi(reinterpret_cast<__m64*>(p), v);
+        _mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+    }
+    //---------------------------------------------------------------------
+    /** Reciprocal of the square root of 'lengthSq', 0 where 'lengthSq' is 0.
+    @remarks
+        Uses the reciprocal square root refined by one Newton-Raphson step, which
+        is nearly as precise as dividing by the square root but cheaper.
+    */
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET __m128 _reciprocalLengthAVX2(__m128 lengthSq)
+    {
+        __m128 rsqrt = _mm_rsqrt_ps(lengthSq);
+        __m128 halfLengthSq = _mm_mul_ps(lengthSq, _mm_set1_ps(0.5f));
+        rsqrt = _mm_mul_ps(rsqrt, _mm_fnmadd_ps(halfLengthSq, _mm_mul_ps(rsqrt, rsqrt), _mm_set1_ps(1.5f)));
+        return _mm_and_ps(rsqrt, _mm_cmpgt_ps(lengthSq, _mm_setzero_ps()));
+    }
+    //---------------------------------------------------------------------
+    /** Collapses the weighted blend matrices of one vertex. Rows 0 and 1 of the
+        3x4 result end up in the low and high half of 'row01', row 2 in 'row2'.
+    */
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void _collapseOneMatrixAVX2(
+        __m256& row01, __m128& row2,
+        const float* pBlendWeight, const unsigned char* pBlendIndex,
+        const Affine3* const* blendMatrices,
+        size_t numWeightsPerVertex)
+    {
+        const Affine3* mat = blendMatrices[pBlendIndex[0]];
+        __m256 weight = _mm256_broadcast_ss(pBlendWeight);
+        row01 = _mm256_mul_ps(weight, _mm256_loadu_ps((*mat)[0]));
+        row2 = _mm_mul_ps(_mm256_castps256_ps128(weight), _mm_loadu_ps((*mat)[2]));
+
+        for (size_t i = 1; i < numWeightsPerVertex; ++i)
+        {
+            mat = blendMatrices[pBlendIndex[i]];
+            weight = _mm256_broadcast_ss(pBlendWeight + i);
+            row01 = _mm256_fmadd_ps(weight, _mm256_loadu_ps((*mat)[0]), row01);
+            row2 = _mm_fmadd_ps(_mm256_castps256_ps128(weight), _mm_loadu_ps((*mat)[2]), row2);
+        }
+    }
+    //---------------------------------------------------------------------
+    // General AVX2 version skinning positions, and optional skinning normals.
+    // One vertex per-iteration, never reads past the end of the vectors.
+    static __OGRE_AVX2_TARGET void softwareVertexSkinning_AVX2_General(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const Affine3* const* blendMatrices,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set_ss(1.0f);
+
+        for (size_t i = 0; i < numVertices; ++i)
+        {
+            __m256 row01;
+            __m128 row2;
+            _collapseOneMatrixAVX2(
+                row01, row2,
+                pBlendWeight, pBlendIndex,
+                blendMatrices,
+                numWeightsPerVertex);
+
+            // Advance blend weight and index pointers
+            advanceRawPointer(pBlendWeight, blendWeightStride);
+            advanceRawPointer(pBlendIndex, blendIndexStride);
+
+            // Position with w = 1 picks up the translation column
+            __m128 pos = _loadVector3AVX2(pSrcPos, one);
+            __m256 pos01 = _mm256_mul_ps(row01, _mm256_insertf128_ps(_mm256_castps128_ps256(pos), pos, 1));
+            __m128 posZ = _mm_mul_ps(row2, pos);
+
+            // Sum up the rows: x y z z
+            __m128 xy = _mm_hadd_ps(_mm256_castps256_ps128(pos01), _mm256_extractf128_ps(pos01, 1));
+            _storeVector3AVX2(pDestPos, _mm_hadd_ps(xy, _mm_hadd_ps(posZ, posZ)));
+
+            // Advance source and target position pointers
+            advanceRawPointer(pSrcPos, srcPosStride);
+            advanceRawPointer(pDestPos, destPosStride);
+
+            if (pSrcNorm)
+            {
+                // Normal with w = 0 ignores the translation column
+                __m128 norm = _loadVector3AVX2(pSrcNorm, zero);
+                __m256 norm01 = _mm256_mul_ps(row01, _mm256_insertf128_ps(_mm256_castps128_ps256(norm), norm, 1));
+                __m128 normZ = _mm_mul_ps(row2, norm);
+
+                xy = _mm_hadd_ps(_mm256_castps256_ps128(norm01), _mm256_extractf128_ps(norm01, 1));
+                __m128 accumNorm = _mm_hadd_ps(xy, _mm_hadd_ps(normZ, normZ));
+                accumNorm = _mm_mul_ps(accumNorm, _reciprocalLengthAVX2(_mm_dp_ps(accumNorm, accumNorm, 0x7F)));
+                _storeVector3AVX2(pDestNorm, accumNorm);
+
+                // Advance source and target normal pointers
+                advanceRawPointer(pSrcNorm, srcNormStride);
+                advanceRawPointer(pDestNorm, destNormStride);
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    // AVX2 version skinning positions, and optional skinning normals.
+    //
+    // Two vertices per-iteration: the blend matrices are collapsed with 256 bits
+    // FMA, two rows at once, and the dot products of both vertices share the
+    // horizontal adds.
+    static __OGRE_AVX2_TARGET void softwareVertexSkinning_AVX2(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const Affine3* const* blendMatrices,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+
+        // Vectors are loaded 16 bytes at once, so keep at least one vertex after
+        // the pair to not read past the end of the buffers
+        size_t numPairs = numVertices > 2 ? (numVertices - 1) / 2 : 0;
+        for (size_t i = 0; i < numPairs; ++i)
+        {
+            // Collapse matrices
+            __m256 row01A, row01B;
+            __m128 row2A, row2B;
+            _collapseOneMatrixAVX2(
+                row01A, row2A,
+                pBlendWeight, pBlendIndex,
+                blendMatrices,
+                numWeightsPerVertex);
+            _collapseOneMatrixAVX2(
+                row01B, row2B,
+                rawOffsetPointer(pBlendWeight, blendWeightStride),
+                rawOffsetPointer(pBlendIndex, blendIndexStride),
+                blendMatrices,
+                numWeightsPerVertex);
+            __m256 row2 = _mm256_insertf128_ps(_mm256_castps128_ps256(row2A), row2B, 1);
+
+            // Advance blend weight and index pointers
+            advanceRawPointer(pBlendWeight, 2 * blendWeightStride);
+            advanceRawPointer(pBlendIndex, 2 * blendIndexStride);
+
+            // Positions with w = 1 pick up the translation column
+            __m256 posA = _broadcastVector3AVX2(pSrcPos, one);
+            __m256 posB = _broadcastVector3AVX2(rawOffsetPointer(pSrcPos, srcPosStride), one);
+            __m256 pos01 = _mm256_hadd_ps(_mm256_mul_ps(row01A, posA), _mm256_mul_ps(row01B, posB));
+            __m256 pos2 = _mm256_mul_ps(row2, _mm256_blend_ps(posA, posB, 0xF0));
+
+            float* pDestPosB = rawOffsetPointer(pDestPos, destPosStride);
+            if (pSrcNorm)
+            {
+                // Normals with w = 0 ignore the translation column
+                __m256 normA = _broadcastVector3AVX2(pSrcNorm, zero);
+                __m256 normB = _broadcastVector3AVX2(rawOffsetPointer(pSrcNorm, srcNormStride), zero);
+                __m256 norm01 = _mm256_hadd_ps(_mm256_mul_ps(row01A, normA), _mm256_mul_ps(row01B, normB));
+                __m256 norm2 = _mm256_mul_ps(row2, _mm256_blend_ps(normA, normB, 0xF0));
+
+                // Sum up the rows, lower half | upper half:
+                //   xy = Apx Bpx Anx Bnx | Apy Bpy Any Bny
+                //   z  = Apz Anz Apz Anz | Bpz Bnz Bpz Bnz
+                __m256 xy = _mm256_hadd_ps(pos01, norm01);
+                __m256 z = _mm256_hadd_ps(pos2, norm2);
+                z = _mm256_hadd_ps(z, z);
+
+                __m128 xyLow = _mm256_castps256_ps128(xy);
+                __m128 xyHigh = _mm256_extractf128_ps(xy, 1);
+                __m128 xyPos = _mm_unpacklo_ps(xyLow, xyHigh);     // Apx Apy Bpx Bpy
+                __m128 xyNorm = _mm_unpackhi_ps(xyLow, xyHigh);    // Anx Any Bnx Bny
+                __m128 zA = _mm256_castps256_ps128(z);
+                __m128 zB = _mm256_extractf128_ps(z, 1);
+
+                _storeVector3AVX2(pDestPos, _mm_shuffle_ps(xyPos, zA, _MM_SHUFFLE(0, 0, 1, 0)));
+                _storeVector3AVX2(pDestPosB, _mm_shuffle_ps(xyPos, zB, _MM_SHUFFLE(0, 0, 3, 2)));
+
+                // Normalise normals, with squared lengths ALen ALen BLen BLen
+                __m128 zNorm = _mm_shuffle_ps(zA, zB, _MM_SHUFFLE(1, 1, 1, 1));   // Anz Anz Bnz Bnz
+                __m128 lengthSq = _mm_mul_ps(xyNorm, xyNorm);
+                lengthSq = _mm_hadd_ps(lengthSq, lengthSq);
+                lengthSq = _mm_fmadd_ps(zNorm, zNorm, _mm_unpacklo_ps(lengthSq, lengthSq));
+                __m128 scale = _reciprocalLengthAVX2(lengthSq);
+                xyNorm = _mm_mul_ps(xyNorm, scale);
+                zNorm = _mm_mul_ps(zNorm, scale);
+
+                _storeVector3AVX2(pDestNorm, _mm_shuffle_ps(xyNorm, zNorm, _MM_SHUFFLE(0, 0, 1, 0)));
+                _storeVector3AVX2(rawOffsetPointer(pDestNorm, destNormStride), _mm_shuffle_ps(xyNorm, zNorm, _MM_SHUFFLE(2, 2, 3, 2)));
+
+                // Advance source and target normal pointers
+                advanceRawPointer(pSrcNorm, 2 * srcNormStride);
+                advanceRawPointer(pDestNorm, 2 * destNormStride);
+            }
+            else
+            {
+                // Sum up the rows, lower half | upper half:
+                //   Apx Bpx Apz Apz | Apy Bpy Bpz Bpz
+                __m256 accumPos = _mm256_hadd_ps(pos01, _mm256_hadd_ps(pos2, pos2));
+
+                __m128 low = _mm256_castps256_ps128(accumPos);
+                __m128 high = _mm256_extractf128_ps(accumPos, 1);
+                __m128 xyPos = _mm_unpacklo_ps(low, high);         // Apx Apy Bpx Bpy
+
+                _storeVector3AVX2(pDestPos, _mm_shuffle_ps(xyPos, low, _MM_SHUFFLE(2, 2, 1, 0)));
+                _storeVector3AVX2(pDestPosB, _mm_shuffle_ps(xyPos, high, _MM_SHUFFLE(2, 2, 3, 2)));
+            }
+
+            // Advance source and target position pointers
+            advanceRawPointer(pSrcPos, 2 * srcPosStride);
+            advanceRawPointer(pDestPos, 2 * destPosStride);
+        }
+
+        // Blend remaining vertices
+        softwareVertexSkinning_AVX2_General(
+            pSrcPos, pDestPos,
+            pSrcNorm, pDestNorm,
+            pBlendWeight, pBlendIndex,
+            blendMatrices,
+            srcPosStride, destPosStride,
+            srcNormStride, destNormStride,
+            blendWeightStride, blendIndexStride,
+            numWeightsPerVertex,
+            numVertices - numPairs * 2);
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::softwareVertexSkinning(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const Affine3* const* blendMatrices,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        softwareVertexSkinning_AVX2(
+            pSrcPos, pDestPos,
+            pSrcNorm, pDestNorm,
+            pBlendWeight, pBlendIndex,
+            blendMatrices,
+            srcPosStride, destPosStride,
+            srcNormStride, destNormStride,
+            blendWeightStride, blendIndexStride,
+            numWeightsPerVertex,
+            numVertices);
+    }
+    //---------------------------------------------------------------------
+    // Helpers for the culling functions, eight boxes/spheres per iteration.
+    //---------------------------------------------------------------------
+    struct CullPlanesAVX2
+    {
+        __m256 nx, ny, nz, d;
+    };
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void _loadCullPlanesAVX2(
+        CullPlanesAVX2* dst, const Plane* planes, size_t numPlanes)
+    {
+        for (size_t p = 0; p < numPlanes; ++p)
+        {
+            dst[p].nx = _mm256_set1_ps(planes[p].normal.x);
+            dst[p].ny = _mm256_set1_ps(planes[p].normal.y);
+            dst[p].nz = _mm256_set1_ps(planes[p].normal.z);
+            dst[p].d = _mm256_set1_ps(planes[p].d);
+        }
+    }
+    /// Same operation order as Plane::getDistance, no FMA so the results match
+    /// the other implementations exactly
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET __m256 _planeDistanceAVX2(
+        const CullPlanesAVX2& p, __m256 x, __m256 y, __m256 z)
+    {
+        return _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p.nx, x), _mm256_mul_ps(p.ny, y)),
+                                           _mm256_mul_ps(p.nz, z)), p.d);
+    }
+    /// Returns the 8-bits mask of boxes not culled by any plane
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET int _cullBoxes8(const CullPlanesAVX2* planes, size_t numPlanes,
+        __m256 cx, __m256 cy, __m256 cz, __m256 hx, __m256 hy, __m256 hz)
+    {
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+        __m256 culled = _mm256_setzero_ps();
+        for (size_t p = 0; p < numPlanes; ++p)
+        {
+            __m256 dist = _planeDistanceAVX2(planes[p], cx, cy, cz);
+            // Same as Vector3::absDotProduct
+            __m256 maxAbsDist = _mm256_add_ps(_mm256_add_ps(
+                _mm256_andnot_ps(signMask, _mm256_mul_ps(planes[p].nx, hx)),
+                _mm256_andnot_ps(signMask, _mm256_mul_ps(planes[p].ny, hy))),
+                _mm256_andnot_ps(signMask, _mm256_mul_ps(planes[p].nz, hz)));
+            culled = _mm256_or_ps(culled,
+                _mm256_cmp_ps(dist, _mm256_xor_ps(maxAbsDist, signMask), _CMP_LT_OQ));
+        }
+        return ~_mm256_movemask_ps(culled) & 0xFF;
+    }
+    /// Returns the 8-bits mask of spheres not culled by any plane
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET int _cullSpheres8(const CullPlanesAVX2* planes, size_t numPlanes,
+        __m256 cx, __m256 cy, __m256 cz, __m256 r)
+    {
+        const __m256 negR = _mm256_xor_ps(r, _mm256_set1_ps(-0.0f));
+        __m256 culled = _mm256_setzero_ps();
+        for (size_t p = 0; p < numPlanes; ++p)
+        {
+            culled = _mm256_or_ps(culled,
+                _mm256_cmp_ps(_planeDistanceAVX2(planes[p], cx, cy, cz), negR, _CMP_LT_OQ));
+        }
+        return ~_mm256_movemask_ps(culled) & 0xFF;
+    }
+    //---------------------------------------------------------------------
+    /// Broadcasted planes live on the stack, more planes than a frustum has
+    /// are rare enough to leave them to the fallback implementation
+    static const size_t CULL_MAX_PLANES = 8;
+    //---------------------------------------------------------------------
+    static __OGRE_AVX2_TARGET void cullAxisAlignedBoxes_AVX2(
+        const Plane* planes, size_t numPlanes,
+        const float* const centres[3],
+        const float* const halfSizes[3],
+        uint32* visibility,
+        size_t numBoxes)
+    {
+        assert(numPlanes <= CULL_MAX_PLANES);
+        CullPlanesAVX2 cullPlanes[CULL_MAX_PLANES];
+        _loadCullPlanesAVX2(cullPlanes, planes, numPlanes);
+
+        const float *cx = centres[0], *cy = centres[1], *cz = centres[2];
+        const float *hx = halfSizes[0], *hy = halfSizes[1], *hz = halfSizes[2];
+
+        size_t numWords = (numBoxes + 31) / 32;
+        memset(visibility, 0, numWords * sizeof(uint32));
+
+        size_t numIterations = numBoxes / 8;
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            int mask = _cullBoxes8(cullPlanes, numPlanes,
+                _mm256_loadu_ps(cx), _mm256_loadu_ps(cy), _mm256_loadu_ps(cz),
+                _mm256_loadu_ps(hx), _mm256_loadu_ps(hy), _mm256_loadu_ps(hz));
+            cx += 8; cy += 8; cz += 8;
+            hx += 8; hy += 8; hz += 8;
+
+            // 4 groups of eight per mask word
+            visibility[i / 4] |= uint32(mask) << ((i % 4) * 8);
+        }
+
+        size_t remaining = numBoxes & 7;
+        if (remaining)
+        {
+            // Pad the remaining boxes, the padding bits are masked out below
+            float tmp[6][8] = {};
+            for (size_t k = 0; k < remaining; ++k)
+            {
+                tmp[0][k] = cx[k]; tmp[1][k] = cy[k]; tmp[2][k] = cz[k];
+                tmp[3][k] = hx[k]; tmp[4][k] = hy[k]; tmp[5][k] = hz[k];
+            }
+            int mask = _cullBoxes8(cullPlanes, numPlanes,
+                _mm256_loadu_ps(tmp[0]), _mm256_loadu_ps(tmp[1]), _mm256_loadu_ps(tmp[2]),
+                _mm256_loadu_ps(tmp[3]), _mm256_loadu_ps(tmp[4]), _mm256_loadu_ps(tmp[5]));
+            mask &= (1 << remaining) - 1;
+            visibility[numIterations / 4] |= uint32(mask) << ((numIterations % 4) * 8);
+        }
+    }
+    //---------------------------------------------------------------------
+    static __OGRE_AVX2_TARGET void cullSpheres_AVX2(
+        const Plane* planes, size_t numPlanes,
+        const float* const centres[3],
+        const float* radii,
+        uint32* visibility,
+        size_t numSpheres)
+    {
+        assert(numPlanes <= CULL_MAX_PLANES);
+        CullPlanesAVX2 cullPlanes[CULL_MAX_PLANES];
+        _loadCullPlanesAVX2(cullPlanes, planes, numPlanes);
+
+        const float *cx = centres[0], *cy = centres[1], *cz = centres[2];
+
+        size_t numWords = (numSpheres + 31) / 32;
+        memset(visibility, 0, numWords * sizeof(uint32));
+
+        size_t numIterations = numSpheres / 8;
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            int mask = _cullSpheres8(cullPlanes, numPlanes,
+                _mm256_loadu_ps(cx), _mm256_loadu_ps(cy), _mm256_loadu_ps(cz), _mm256_loadu_ps(radii));
+            cx += 8; cy += 8; cz += 8; radii += 8;
+
+            visibility[i / 4] |= uint32(mask) << ((i % 4) * 8);
+        }
+
+        size_t remaining = numSpheres & 7;
+        if (remaining)
+        {
+            float tmp[4][8] = {};
+            for (size_t k = 0; k < remaining; ++k)
+            {
+                tmp[0][k] = cx[k]; tmp[1][k] = cy[k]; tmp[2][k] = cz[k]; tmp[3][k] = radii[k];
+            }
+            int mask = _cullSpheres8(cullPlanes, numPlanes,
+                _mm256_loadu_ps(tmp[0]), _mm256_loadu_ps(tmp[1]), _mm256_loadu_ps(tmp[2]),
+                _mm256_loadu_ps(tmp[3]));
+            mask &= (1 << remaining) - 1;
+            visibility[numIterations / 4] |= uint32(mask) << ((numIterations % 4) * 8);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::cullAxisAlignedBoxes(
+        const Plane* planes, size_t numPlanes,
+        const float* const centres[3],
+        const float* const halfSizes[3],
+        uint32* visibility,
+        size_t numBoxes)
+    {
+        if (numPlanes > CULL_MAX_PLANES)
+        {
+            mFallback->cullAxisAlignedBoxes(planes, numPlanes, centres, halfSizes, visibility, numBoxes);
+            return;
+        }
+        cullAxisAlignedBoxes_AVX2(planes, numPlanes, centres, halfSizes, visibility, numBoxes);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::cullSpheres(
+        const Plane* planes, size_t numPlanes,
+        const float* const centres[3],
+        const float* radii,
+        uint32* visibility,
+        size_t numSpheres)
+    {
+        if (numPlanes > CULL_MAX_PLANES)
+        {
+            mFallback->cullSpheres(planes, numPlanes, centres, radii, visibility, numSpheres);
+            return;
+        }
+        cullSpheres_AVX2(planes, numPlanes, centres, radii, visibility, numSpheres);
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    extern OptimisedUtil* _getOptimisedUtilSSE(void);
+    extern OptimisedUtil* _getOptimisedUtilAVX2(void);
+    extern OptimisedUtil* _getOptimisedUtilAVX2(void)
+    {
+        static OptimisedUtilAVX2 msOptimisedUtilAVX2(_getOptimisedUtilSSE());
+        return &msOptimisedUtilAVX2;
+    }
+
+}
+
+#endif // __OGRE_HAVE_AVX2
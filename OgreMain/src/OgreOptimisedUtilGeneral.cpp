@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreStableHeaders.h"
 
 #include "OgreOptimisedUtil.h"
+#include "OgrePlane.h"
 
 namespace Ogre {
 
@@ -91,6 +92,31 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+
+        /// @copydoc OptimisedUtil::cullAxisAlignedBoxes
+        virtual void cullAxisAlignedBoxes(
+            const Plane* planes, size_t numPlanes,
+            const float* const centres[3],
+            const float* const halfSizes[3],
+            uint32* visibility,
+            size_t numBoxes);
+
+        /// @copydoc OptimisedUtil::cullSpheres
+        virtual void cullSpheres(
+            const Plane* planes, size_t numPlanes,
+            const float* const centres[3],
+            const float* radii,
+            uint32* visibility,
+            size_t numSpheres);
+
+        /// @copydoc OptimisedUtil::expandBillboardQuads
+        virtual void expandBillboardQuads(
+            const float* centres,
+            const float* offsets, size_t offsetStride,
+            const uint32* colours,
+            const float* texcoordRects,
+            float* dest,
+            size_t numBillboards);
     };
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
@@ -364,6 +390,80 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::cullAxisAlignedBoxes(
+        const Plane* planes, size_t numPlanes,
+        const float* const centres[3],
+        const float* const halfSizes[3],
+        uint32* visibility,
+        size_t numBoxes)
+    {
+        memset(visibility, 0, ((numBoxes + 31) / 32) * sizeof(uint32));
+
+        for (size_t i = 0; i < numBoxes; ++i)
+        {
+            Vector3 centre(centres[0][i], centres[1][i], centres[2][i]);
+            Vector3 halfSize(halfSizes[0][i], halfSizes[1][i], halfSizes[2][i]);
+
+            bool visible = true;
+            for (size_t p = 0; p < numPlanes && visible; ++p)
+                visible = planes[p].getSide(centre, halfSize) != Plane::NEGATIVE_SIDE;
+
+            if (visible)
+                visibility[i / 32] |= 1u << (i % 32);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::cullSpheres(
+        const Plane* planes, size_t numPlanes,
+        const float* const centres[3],
+        const float* radii,
+        uint32* visibility,
+        size_t numSpheres)
+    {
+        memset(visibility, 0, ((numSpheres + 31) / 32) * sizeof(uint32));
+
+        for (size_t i = 0; i < numSpheres; ++i)
+        {
+            Vector3 centre(centres[0][i], centres[1][i], centres[2][i]);
+
+            bool visible = true;
+            for (size_t p = 0; p < numPlanes && visible; ++p)
+                visible = !(planes[p].getDistance(centre) < -radii[i]);
+
+            if (visible)
+                visibility[i / 32] |= 1u << (i % 32);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::expandBillboardQuads(
+        const float* centres,
+        const float* offsets, size_t offsetStride,
+        const uint32* colours,
+        const float* texcoordRects,
+        float* dest,
+        size_t numBillboards)
+    {
+        for (size_t i = 0; i < numBillboards; ++i)
+        {
+            const float* c = centres + i * 3;
+            const float* o = offsets + i * offsetStride;
+            const float* r = texcoordRects + i * 4;
+            // Texture coordinate indices into left, top, right, bottom per corner
+            static const size_t uIndex[4] = { 0, 2, 0, 2 };
+            static const size_t vIndex[4] = { 1, 1, 3, 3 };
+
+            for (size_t corner = 0; corner < 4; ++corner)
+            {
+                *dest++ = c[0] + o[corner * 3 + 0];
+                *dest++ = c[1] + o[corner * 3 + 1];
+                *dest++ = c[2] + o[corner * 3 + 2];
+                memcpy(dest++, colours + i, sizeof(uint32));
+                *dest++ = r[uIndex[corner]];
+                *dest++ = r[vIndex[corner]];
+            }
+        }
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilGeneral(void);
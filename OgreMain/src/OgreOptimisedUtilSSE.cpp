@@ -27,6 +27,7 @@ THE SOFTWARE.
 */
 #include "OgreStableHeaders.h"
 #include "OgreOptimisedUtil.h"
+#include "OgrePlane.h"
 
 
 #if __OGRE_HAVE_SSE
@@ -129,6 +130,31 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+
+        /// @copydoc OptimisedUtil::cullAxisAlignedBoxes
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE cullAxisAlignedBoxes(
+            const Plane* planes, size_t numPlanes,
+            const float* const centres[3],
+            const float* const halfSizes[3],
+            uint32* visibility,
+            size_t numBoxes);
+
+        /// @copydoc OptimisedUtil::cullSpheres
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE cullSpheres(
+            const Plane* planes, size_t numPlanes,
+            const float* const centres[3],
+            const float* radii,
+            uint32* visibility,
+            size_t numSpheres);
+
+        /// @copydoc OptimisedUtil::expandBillboardQuads
+        virtual void __OGRE_SIMD_ALIGN_ATTRIBUTE expandBillboardQuads(
+            const float* centres,
+            const float* offsets, size_t offsetStride,
+            const uint32* colours,
+            const float* texcoordRects,
+            float* dest,
+            size_t numBillboards);
     };
 
 #if defined(__OGRE_SIMD_ALIGN_STACK)
@@ -268,6 +294,62 @@ namespace Ogre {
                 destPositions,
                 numVertices);
         }
+
+        /// @copydoc OptimisedUtil::cullAxisAlignedBoxes
+        virtual void cullAxisAlignedBoxes(
+            const Plane* planes, size_t numPlanes,
+            const float* const centres[3],
+            const float* const halfSizes[3],
+            uint32* visibility,
+            size_t numBoxes)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->cullAxisAlignedBoxes(
+                planes, numPlanes,
+                centres,
+                halfSizes,
+                visibility,
+                numBoxes);
+        }
+
+        /// @copydoc OptimisedUtil::cullSpheres
+        virtual void cullSpheres(
+            const Plane* planes, size_t numPlanes,
+            const float* const centres[3],
+            const float* radii,
+            uint32* visibility,
+            size_t numSpheres)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->cullSpheres(
+                planes, numPlanes,
+                centres,
+                radii,
+                visibility,
+                numSpheres);
+        }
+
+        /// @copydoc OptimisedUtil::expandBillboardQuads
+        virtual void expandBillboardQuads(
+            const float* centres,
+            const float* offsets, size_t offsetStride,
+            const uint32* colours,
+            const float* texcoordRects,
+            float* dest,
+            size_t numBillboards)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->expandBillboardQuads(
+                centres,
+                offsets, offsetStride,
+                colours,
+                texcoordRects,
+                dest,
+                numBillboards);
+        }
     };
 #endif  // !defined(__OGRE_SIMD_ALIGN_STACK)
 
@@ -2129,6 +2211,225 @@ namespace Ogre {
             }
         }
     }
+    extern OptimisedUtil* _getOptimisedUtilGeneral(void);
+    //---------------------------------------------------------------------
+    // Helpers for the culling functions, four boxes/spheres per iteration.
+    //---------------------------------------------------------------------
+    struct CullPlanesSSE
+    {
+        __m128 nx, ny, nz, d;
+    };
+    static OGRE_FORCE_INLINE void _loadCullPlanes(CullPlanesSSE* dst, const Plane* planes, size_t numPlanes)
+    {
+        for (size_t p = 0; p < numPlanes; ++p)
+        {
+            dst[p].nx = _mm_set1_ps(planes[p].normal.x);
+            dst[p].ny = _mm_set1_ps(planes[p].normal.y);
+            dst[p].nz = _mm_set1_ps(planes[p].normal.z);
+            dst[p].d = _mm_set1_ps(planes[p].d);
+        }
+    }
+    /// Same operation order as Plane::getDistance
+    static OGRE_FORCE_INLINE __m128 _planeDistance(const CullPlanesSSE& p, __m128 x, __m128 y, __m128 z)
+    {
+        return _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(p.nx, x), _mm_mul_ps(p.ny, y)),
+                                     _mm_mul_ps(p.nz, z)), p.d);
+    }
+    /// Returns the 4-bits mask of boxes not culled by any plane
+    static OGRE_FORCE_INLINE int _cullBoxes4(const CullPlanesSSE* planes, size_t numPlanes,
+        __m128 cx, __m128 cy, __m128 cz, __m128 hx, __m128 hy, __m128 hz)
+    {
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        __m128 culled = _mm_setzero_ps();
+        for (size_t p = 0; p < numPlanes; ++p)
+        {
+            __m128 dist = _planeDistance(planes[p], cx, cy, cz);
+            // Same as Vector3::absDotProduct
+            __m128 maxAbsDist = _mm_add_ps(_mm_add_ps(
+                _mm_andnot_ps(signMask, _mm_mul_ps(planes[p].nx, hx)),
+                _mm_andnot_ps(signMask, _mm_mul_ps(planes[p].ny, hy))),
+                _mm_andnot_ps(signMask, _mm_mul_ps(planes[p].nz, hz)));
+            culled = _mm_or_ps(culled, _mm_cmplt_ps(dist, _mm_xor_ps(maxAbsDist, signMask)));
+        }
+        return ~_mm_movemask_ps(culled) & 0xF;
+    }
+    /// Returns the 4-bits mask of spheres not culled by any plane
+    static OGRE_FORCE_INLINE int _cullSpheres4(const CullPlanesSSE* planes, size_t numPlanes,
+        __m128 cx, __m128 cy, __m128 cz, __m128 r)
+    {
+        const __m128 negR = _mm_xor_ps(r, _mm_set1_ps(-0.0f));
+        __m128 culled = _mm_setzero_ps();
+        for (size_t p = 0; p < numPlanes; ++p)
+        {
+            culled = _mm_or_ps(culled, _mm_cmplt_ps(_planeDistance(planes[p], cx, cy, cz), negR));
+        }
+        return ~_mm_movemask_ps(culled) & 0xF;
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::cullAxisAlignedBoxes(
+        const Plane* planes, size_t numPlanes,
+        const float* const centres[3],
+        const float* const halfSizes[3],
+        uint32* visibility,
+        size_t numBoxes)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        // Broadcasted planes live on the stack, more planes than a frustum has
+        // are rare enough to leave them to the general implementation
+        const size_t MAX_PLANES = 8;
+        if (numPlanes > MAX_PLANES)
+        {
+            _getOptimisedUtilGeneral()->cullAxisAlignedBoxes(
+                planes, numPlanes, centres, halfSizes, visibility, numBoxes);
+            return;
+        }
+        CullPlanesSSE cullPlanes[MAX_PLANES];
+        _loadCullPlanes(cullPlanes, planes, numPlanes);
+
+        const float *cx = centres[0], *cy = centres[1], *cz = centres[2];
+        const float *hx = halfSizes[0], *hy = halfSizes[1], *hz = halfSizes[2];
+
+        size_t numWords = (numBoxes + 31) / 32;
+        memset(visibility, 0, numWords * sizeof(uint32));
+
+        size_t numIterations = numBoxes / 4;
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            int mask = _cullBoxes4(cullPlanes, numPlanes,
+                _mm_loadu_ps(cx), _mm_loadu_ps(cy), _mm_loadu_ps(cz),
+                _mm_loadu_ps(hx), _mm_loadu_ps(hy), _mm_loadu_ps(hz));
+            cx += 4; cy += 4; cz += 4;
+            hx += 4; hy += 4; hz += 4;
+
+            // 8 groups of four per mask word
+            visibility[i / 8] |= uint32(mask) << ((i % 8) * 4);
+        }
+
+        size_t remaining = numBoxes & 3;
+        if (remaining)
+        {
+            // Pad the remaining boxes, the padding bits are masked out below
+            float tmp[6][4] = {};
+            for (size_t k = 0; k < remaining; ++k)
+            {
+                tmp[0][k] = cx[k]; tmp[1][k] = cy[k]; tmp[2][k] = cz[k];
+                tmp[3][k] = hx[k]; tmp[4][k] = hy[k]; tmp[5][k] = hz[k];
+            }
+            int mask = _cullBoxes4(cullPlanes, numPlanes,
+                _mm_loadu_ps(tmp[0]), _mm_loadu_ps(tmp[1]), _mm_loadu_ps(tmp[2]),
+                _mm_loadu_ps(tmp[3]), _mm_loadu_ps(tmp[4]), _mm_loadu_ps(tmp[5]));
+            mask &= (1 << remaining) - 1;
+            visibility[numIterations / 8] |= uint32(mask) << ((numIterations % 8) * 4);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::cullSpheres(
+        const Plane* planes, size_t numPlanes,
+        const float* const centres[3],
+        const float* radii,
+        uint32* visibility,
+        size_t numSpheres)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        const size_t MAX_PLANES = 8;
+        if (numPlanes > MAX_PLANES)
+        {
+            _getOptimisedUtilGeneral()->cullSpheres(
+                planes, numPlanes, centres, radii, visibility, numSpheres);
+            return;
+        }
+        CullPlanesSSE cullPlanes[MAX_PLANES];
+        _loadCullPlanes(cullPlanes, planes, numPlanes);
+
+        const float *cx = centres[0], *cy = centres[1], *cz = centres[2];
+
+        size_t numWords = (numSpheres + 31) / 32;
+        memset(visibility, 0, numWords * sizeof(uint32));
+
+        size_t numIterations = numSpheres / 4;
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            int mask = _cullSpheres4(cullPlanes, numPlanes,
+                _mm_loadu_ps(cx), _mm_loadu_ps(cy), _mm_loadu_ps(cz), _mm_loadu_ps(radii));
+            cx += 4; cy += 4; cz += 4; radii += 4;
+
+            visibility[i / 8] |= uint32(mask) << ((i % 8) * 4);
+        }
+
+        size_t remaining = numSpheres & 3;
+        if (remaining)
+        {
+            float tmp[4][4] = {};
+            for (size_t k = 0; k < remaining; ++k)
+            {
+                tmp[0][k] = cx[k]; tmp[1][k] = cy[k]; tmp[2][k] = cz[k]; tmp[3][k] = radii[k];
+            }
+            int mask = _cullSpheres4(cullPlanes, numPlanes,
+                _mm_loadu_ps(tmp[0]), _mm_loadu_ps(tmp[1]), _mm_loadu_ps(tmp[2]), _mm_loadu_ps(tmp[3]));
+            mask &= (1 << remaining) - 1;
+            visibility[numIterations / 8] |= uint32(mask) << ((numIterations % 8) * 4);
+        }
+    }
+    //---------------------------------------------------------------------
+    /// Loads a 3 float vector into the xyz lanes, the w lane is zero
+    static OGRE_FORCE_INLINE __m128 _loadVector3(const float* p)
+    {
+        return _mm_setr_ps(p[0], p[1], p[2], 0.0f);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::expandBillboardQuads(
+        const float* centres,
+        const float* offsets, size_t offsetStride,
+        const uint32* colours,
+        const float* texcoordRects,
+        float* dest,
+        size_t numBillboards)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        // Corner offsets with a zero w lane, reloaded per billboard only if not shared
+        __m128 o0 = _loadVector3(offsets + 0);
+        __m128 o1 = _loadVector3(offsets + 3);
+        __m128 o2 = _loadVector3(offsets + 6);
+        __m128 o3 = _loadVector3(offsets + 9);
+
+        for (size_t i = 0; i < numBillboards; ++i)
+        {
+            if (offsetStride)
+            {
+                const float* o = offsets + i * offsetStride;
+                o0 = _loadVector3(o + 0);
+                o1 = _loadVector3(o + 3);
+                o2 = _loadVector3(o + 6);
+                o3 = _loadVector3(o + 9);
+            }
+
+            // Centre in xyz, colour bits in w. Adding offsets with a zero w lane
+            // gives +0 in w, so or-ing the colour in afterwards leaves it untouched.
+            float colourBits;
+            memcpy(&colourBits, colours + i, sizeof(float));
+            const __m128 colour = _mm_setr_ps(0.0f, 0.0f, 0.0f, colourBits);
+            const __m128 centre = _loadVector3(centres + i * 3);
+
+            // left, top, right, bottom
+            const __m128 rect = _mm_loadu_ps(texcoordRects + i * 4);
+            const __m128 uvRightTop = _mm_shuffle_ps(rect, rect, _MM_SHUFFLE(3, 3, 1, 2));
+            const __m128 uvLeftBottom = _mm_shuffle_ps(rect, rect, _MM_SHUFFLE(3, 3, 3, 0));
+            const __m128 uvRightBottom = _mm_movehl_ps(rect, rect);
+
+            _mm_storeu_ps(dest + 0, _mm_or_ps(_mm_add_ps(centre, o0), colour));
+            _mm_storel_pi(reinterpret_cast<__m64*>(dest + 4), rect);
+            _mm_storeu_ps(dest + 6, _mm_or_ps(_mm_add_ps(centre, o1), colour));
+            _mm_storel_pi(reinterpret_cast<__m64*>(dest + 10), uvRightTop);
+            _mm_storeu_ps(dest + 12, _mm_or_ps(_mm_add_ps(centre, o2), colour));
+            _mm_storel_pi(reinterpret_cast<__m64*>(dest + 16), uvLeftBottom);
+            _mm_storeu_ps(dest + 18, _mm_or_ps(_mm_add_ps(centre, o3), colour));
+            _mm_storel_pi(reinterpret_cast<__m64*>(dest + 22), uvRightBottom);
+            dest += 24;
+        }
+    }
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
@@ -0,0 +1,205 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreParallelSceneCuller.h"
+#include "OgreThreadPool.h"
+#include "OgreSceneNode.h"
+#include "OgreCamera.h"
+#include "OgreRenderQueue.h"
+
+namespace Ogre {
+
+    namespace
+    {
+        /// Tasks per thread to aim for, so unbalanced subtrees even out
+        const size_t TASKS_PER_THREAD = 8;
+        /// Deepest level the hierarchy is split at
+        const size_t MAX_SPLIT_DEPTH = 6;
+    }
+    //-----------------------------------------------------------------------
+    ParallelSceneCuller::ParallelSceneCuller() : mCamera(0)
+    {
+    }
+    //-----------------------------------------------------------------------
+    void ParallelSceneCuller::findVisibleObjects(SceneNode* root, Camera* cam, RenderQueue* queue,
+                                                 VisibleObjectsBoundsInfo* visibleBounds,
+                                                 bool displayNodes, bool onlyShadowCasters,
+                                                 ThreadPool* pool)
+    {
+        if (!pool || pool->getNumThreads() < 2)
+        {
+            root->_findVisibleObjects(cam, queue, visibleBounds, true, displayNodes,
+                                      onlyShadowCasters);
+            return;
+        }
+
+        // Frustum::isVisible updates the planes lazily, do that here so the
+        // concurrent tests only read the camera
+        Frustum* cullFrustum = cam->getCullingFrustum();
+        (cullFrustum ? cullFrustum : cam)->getFrustumPlanes();
+
+        // split at the shallowest level offering enough subtrees
+        size_t targetTasks = pool->getNumThreads() * TASKS_PER_THREAD;
+        size_t splitDepth = 0;
+        mFrontier.assign(1, root);
+        while (mFrontier.size() < targetTasks && splitDepth < MAX_SPLIT_DEPTH)
+        {
+            mNextFrontier.clear();
+            for (SceneNode* n : mFrontier)
+            {
+                for (Node* child : n->getChildren())
+                    mNextFrontier.push_back(static_cast<SceneNode*>(child));
+            }
+            if (mNextFrontier.empty())
+                break;
+            mFrontier.swap(mNextFrontier);
+            ++splitDepth;
+        }
+
+        mTasks.clear();
+        buildTasks(root, ~size_t(0), splitDepth);
+        if (mShards.size() < mTasks.size())
+            mShards.resize(mTasks.size());
+
+        mCamera = cam;
+        pool->parallelFor(0, mTasks.size(), 1, [this](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; ++i)
+                cullTask(mTasks[i], mShards[i]);
+        });
+
+        // merge in depth-first order, skipping everything below invisible nodes
+        for (size_t i = 0; i < mTasks.size(); ++i)
+        {
+            Task& task = mTasks[i];
+            task.active = task.parentTask == ~size_t(0) ||
+                (mTasks[task.parentTask].active && mTasks[task.parentTask].visible);
+            if (!task.active)
+                continue;
+
+            if (task.type == TT_NODE_END)
+            {
+                task.node->_addDebugRenderablesToQueue(queue, displayNodes);
+                continue;
+            }
+
+            for (const VisibleEntry& e : mShards[i])
+            {
+                if (e.object)
+                    queue->processVisibleObject(e.object, cam, onlyShadowCasters, visibleBounds);
+                else
+                    e.node->_addDebugRenderablesToQueue(queue, displayNodes);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ParallelSceneCuller::buildTasks(SceneNode* node, size_t parentTask, size_t splitDepth)
+    {
+        Task task = { node, parentTask, TT_SUBTREE, false, false };
+        if (splitDepth == 0 || node->getChildren().empty())
+        {
+            mTasks.push_back(task);
+            return;
+        }
+
+        size_t nodeTask = mTasks.size();
+        task.type = TT_NODE;
+        mTasks.push_back(task);
+
+        for (Node* child : node->getChildren())
+            buildTasks(static_cast<SceneNode*>(child), nodeTask, splitDepth - 1);
+
+        task.type = TT_NODE_END;
+        task.parentTask = nodeTask;
+        mTasks.push_back(task);
+    }
+    //-----------------------------------------------------------------------
+    void ParallelSceneCuller::cullTask(Task& task, VisibleEntryList& shard) const
+    {
+        shard.clear();
+        switch (task.type)
+        {
+        case TT_SUBTREE:
+            cullSubtree(task.node, shard);
+            break;
+        case TT_NODE:
+            task.visible = mCamera->isVisible(task.node->_getWorldAABB());
+            if (task.visible)
+            {
+                for (MovableObject* mo : task.node->getAttachedObjects())
+                {
+                    VisibleEntry e = { task.node, mo };
+                    shard.push_back(e);
+                }
+            }
+            break;
+        case TT_NODE_END:
+            break;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ParallelSceneCuller::cullSubtree(SceneNode* node, VisibleEntryList& shard) const
+    {
+        if (!mCamera->isVisible(node->_getWorldAABB()))
+            return;
+
+        addVisibleNode(node, shard);
+    }
+    //-----------------------------------------------------------------------
+    void ParallelSceneCuller::addVisibleNode(SceneNode* node, VisibleEntryList& shard) const
+    {
+        // mirrors SceneNode::_findVisibleObjects
+        for (MovableObject* mo : node->getAttachedObjects())
+        {
+            VisibleEntry e = { node, mo };
+            shard.push_back(e);
+        }
+
+        const Node::ChildNodeMap& children = node->getChildren();
+        if (children.size() < SceneNode::BULK_CULL_THRESHOLD)
+        {
+            for (Node* child : children)
+                cullSubtree(static_cast<SceneNode*>(child), shard);
+        }
+        else
+        {
+            for (size_t begin = 0; begin < children.size(); begin += 32)
+            {
+                size_t count = std::min(children.size() - begin, size_t(32));
+                uint32 visible = node->_getVisibleChildren(mCamera, begin, count);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    if (visible & (1u << i))
+                        addVisibleNode(static_cast<SceneNode*>(children[begin + i]), shard);
+                }
+            }
+        }
+
+        VisibleEntry end = { node, 0 };
+        shard.push_back(end);
+    }
+}
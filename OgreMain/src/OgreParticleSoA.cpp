@@ -0,0 +1,182 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreParticleSoA.h"
+#include "OgreParticle.h"
+
+namespace Ogre {
+    //-----------------------------------------------------------------------
+    ParticleSoA::ParticleSoA()
+        : mNumEmitters(0)
+    {
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSoA::clear(void)
+    {
+        mPositionX.clear(); mPositionY.clear(); mPositionZ.clear();
+        mDirectionX.clear(); mDirectionY.clear(); mDirectionZ.clear();
+        mColourR.clear(); mColourG.clear(); mColourB.clear(); mColourA.clear();
+        mTimeToLive.clear();
+        mTotalTimeToLive.clear();
+        mRotation.clear();
+        mRotationSpeed.clear();
+        mWidth.clear(); mHeight.clear();
+        mOwnDimensions.clear();
+        mIsEmitter.clear();
+        mParticles.clear();
+        mListEntries.clear();
+        mNumEmitters = 0;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSoA::add(Particle* p, ListEntry entry)
+    {
+        size_t index = mParticles.size();
+        size_t newSize = index + 1;
+
+        mPositionX.resize(newSize); mPositionY.resize(newSize); mPositionZ.resize(newSize);
+        mDirectionX.resize(newSize); mDirectionY.resize(newSize); mDirectionZ.resize(newSize);
+        mColourR.resize(newSize); mColourG.resize(newSize); mColourB.resize(newSize); mColourA.resize(newSize);
+        mTimeToLive.resize(newSize);
+        mTotalTimeToLive.resize(newSize);
+        mRotation.resize(newSize);
+        mRotationSpeed.resize(newSize);
+        mWidth.resize(newSize); mHeight.resize(newSize);
+        mOwnDimensions.resize(newSize);
+        mIsEmitter.resize(newSize);
+        mParticles.push_back(p);
+        mListEntries.push_back(entry);
+
+        loadParticle(index);
+        if (mIsEmitter[index])
+            ++mNumEmitters;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSoA::swapRemove(size_t index)
+    {
+        assert(index < mParticles.size() && "Index out of bounds!");
+        if (mIsEmitter[index])
+            --mNumEmitters;
+
+        size_t last = mParticles.size() - 1;
+        if (index != last)
+        {
+            mPositionX[index] = mPositionX[last];
+            mPositionY[index] = mPositionY[last];
+            mPositionZ[index] = mPositionZ[last];
+            mDirectionX[index] = mDirectionX[last];
+            mDirectionY[index] = mDirectionY[last];
+            mDirectionZ[index] = mDirectionZ[last];
+            mColourR[index] = mColourR[last];
+            mColourG[index] = mColourG[last];
+            mColourB[index] = mColourB[last];
+            mColourA[index] = mColourA[last];
+            mTimeToLive[index] = mTimeToLive[last];
+            mTotalTimeToLive[index] = mTotalTimeToLive[last];
+            mRotation[index] = mRotation[last];
+            mRotationSpeed[index] = mRotationSpeed[last];
+            mWidth[index] = mWidth[last];
+            mHeight[index] = mHeight[last];
+            mOwnDimensions[index] = mOwnDimensions[last];
+            mIsEmitter[index] = mIsEmitter[last];
+            mParticles[index] = mParticles[last];
+            mListEntries[index] = mListEntries[last];
+        }
+
+        mPositionX.pop_back(); mPositionY.pop_back(); mPositionZ.pop_back();
+        mDirectionX.pop_back(); mDirectionY.pop_back(); mDirectionZ.pop_back();
+        mColourR.pop_back(); mColourG.pop_back(); mColourB.pop_back(); mColourA.pop_back();
+        mTimeToLive.pop_back();
+        mTotalTimeToLive.pop_back();
+        mRotation.pop_back();
+        mRotationSpeed.pop_back();
+        mWidth.pop_back(); mHeight.pop_back();
+        mOwnDimensions.pop_back();
+        mIsEmitter.pop_back();
+        mParticles.pop_back();
+        mListEntries.pop_back();
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSoA::loadParticle(size_t index)
+    {
+        const Particle* p = mParticles[index];
+        mPositionX[index] = p->mPosition.x;
+        mPositionY[index] = p->mPosition.y;
+        mPositionZ[index] = p->mPosition.z;
+        mDirectionX[index] = p->mDirection.x;
+        mDirectionY[index] = p->mDirection.y;
+        mDirectionZ[index] = p->mDirection.z;
+        mColourR[index] = p->mColour.r;
+        mColourG[index] = p->mColour.g;
+        mColourB[index] = p->mColour.b;
+        mColourA[index] = p->mColour.a;
+        mTimeToLive[index] = p->mTimeToLive;
+        mTotalTimeToLive[index] = p->mTotalTimeToLive;
+        mRotation[index] = p->mRotation.valueRadians();
+        mRotationSpeed[index] = p->mRotationSpeed.valueRadians();
+        mWidth[index] = p->mWidth;
+        mHeight[index] = p->mHeight;
+        mOwnDimensions[index] = p->mOwnDimensions;
+        mIsEmitter[index] = p->mParticleType == Particle::Emitter;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSoA::load(void)
+    {
+        mNumEmitters = 0;
+        for (size_t i = 0; i < mParticles.size(); ++i)
+        {
+            loadParticle(i);
+            if (mIsEmitter[i])
+                ++mNumEmitters;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSoA::store(void) const
+    {
+        for (size_t i = 0; i < mParticles.size(); ++i)
+        {
+            Particle* p = mParticles[i];
+            p->mPosition.x = mPositionX[i];
+            p->mPosition.y = mPositionY[i];
+            p->mPosition.z = mPositionZ[i];
+            p->mDirection.x = mDirectionX[i];
+            p->mDirection.y = mDirectionY[i];
+            p->mDirection.z = mDirectionZ[i];
+            p->mColour.r = mColourR[i];
+            p->mColour.g = mColourG[i];
+            p->mColour.b = mColourB[i];
+            p->mColour.a = mColourA[i];
+            p->mTimeToLive = mTimeToLive[i];
+            p->mTotalTimeToLive = mTotalTimeToLive[i];
+            p->mRotation = Radian(mRotation[i]);
+            p->mRotationSpeed = Radian(mRotationSpeed[i]);
+            p->mWidth = mWidth[i];
+            p->mHeight = mHeight[i];
+            p->mOwnDimensions = mOwnDimensions[i] != 0;
+        }
+    }
+}
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgreParticleEmitter.h"
 #include "OgreParticleAffector.h"
 #include "OgreParticle.h"
+#include "OgreParticleSoA.h"
 #include "OgreIteratorWrappers.h"
 #include "OgreParticleAffectorFactory.h"
 #include "OgreParticleSystemRenderer.h"
@@ -49,6 +50,7 @@ namespace Ogre {
     ParticleSystem::CmdLocalSpace ParticleSystem::msLocalSpaceCmd;
     ParticleSystem::CmdIterationInterval ParticleSystem::msIterationIntervalCmd;
     ParticleSystem::CmdNonvisibleTimeout ParticleSystem::msNonvisibleTimeoutCmd;
+    ParticleSystem::CmdSoAStorage ParticleSystem::msSoAStorageCmd;
 
     RadixSort<ParticleSystem::ActiveParticleList, Particle*, float> ParticleSystem::mRadixSorter;
 
@@ -66,10 +68,49 @@ namespace Ogre {
 
         Real getValue(void) const { return 0; } // N/A
 
-        void setValue(Real value) { mTarget->_update(value); }
+        void setValue(Real value)
+        {
+            ParticleSystemManager& mgr = ParticleSystemManager::getSingleton();
+            if (mgr.getParallelUpdate())
+                mgr._queueUpdate(mTarget, value);
+            else
+                mTarget->_update(value);
+        }
 
     };
     //-----------------------------------------------------------------------
+    /** Random number stream private to one ParticleSystem.
+    @remarks
+        Installed as the random value provider of the calling thread for its lifetime,
+        so the emitters and affectors of a system draw from the system's own stream.
+    */
+    class ParticleSystemRandomScope : public Math::RandomValueProvider
+    {
+    protected:
+        uint32& mState;
+        bool mEnabled;
+        Math::RandomValueProvider* mPrevious;
+    public:
+        ParticleSystemRandomScope(uint32& state, bool enabled)
+            : mState(state), mEnabled(enabled), mPrevious(0)
+        {
+            if (mEnabled)
+                mPrevious = Math::SetThreadRandomValueProvider(this);
+        }
+        ~ParticleSystemRandomScope()
+        {
+            if (mEnabled)
+                Math::SetThreadRandomValueProvider(mPrevious);
+        }
+
+        Real getRandomUnit()
+        {
+            // Linear congruential generator, the top 24 bits fill a float mantissa
+            mState = mState * 1664525u + 1013904223u;
+            return Real(mState >> 8) / Real(0xFFFFFF);
+        }
+    };
+    //-----------------------------------------------------------------------
     ParticleSystem::ParticleSystem() 
       : mAABB(),
         mBoundingRadius(1.0f),
@@ -90,6 +131,16 @@ namespace Ogre {
         mTimeController(0),
         mEmittedEmitterPoolInitialised(false),
         mIsEmitting(true),
+        mSoAStorage(false),
+        mParticleSoA(0),
+        mParticleObjectsStale(false),
+        mParticleSoAStale(false),
+        mUpdatingSoA(false),
+        mRandomSeed(0),
+        mRandomState(0),
+        mRandomSeedSet(false),
+        mUpdateQueued(false),
+        mQueuedUpdateTime(0),
         mRenderer(0),
         mCullIndividual(false),
         mPoolSize(0),
@@ -123,6 +174,16 @@ namespace Ogre {
         mTimeController(0),
         mEmittedEmitterPoolInitialised(false),
         mIsEmitting(true),
+        mSoAStorage(false),
+        mParticleSoA(0),
+        mParticleObjectsStale(false),
+        mParticleSoAStale(false),
+        mUpdatingSoA(false),
+        mRandomSeed(0),
+        mRandomState(0),
+        mRandomSeedSet(false),
+        mUpdateQueued(false),
+        mQueuedUpdateTime(0),
         mRenderer(0), 
         mCullIndividual(false),
         mPoolSize(0),
@@ -135,6 +196,9 @@ namespace Ogre {
         setEmittedEmitterQuota( 3 );
         initParameters();
 
+        // Deterministic default stream, distinct for each named system
+        mRandomSeed = mRandomState = FastHash(name.c_str(), name.size());
+
         // Default to billboard renderer
         setRenderer("billboard");
     }
@@ -148,6 +212,9 @@ namespace Ogre {
             mTimeController = 0;
         }
 
+        if (mUpdateQueued)
+            ParticleSystemManager::getSingleton()._dequeueUpdate(this);
+
         // Arrange for the deletion of emitters & affectors
         removeAllEmitters();
         removeAllEmittedEmitters();
@@ -168,6 +235,7 @@ namespace Ogre {
             mRenderer = 0;
         }
 
+        OGRE_DELETE mParticleSoA;
     }
     //-----------------------------------------------------------------------
     ParticleEmitter* ParticleSystem::addEmitter(const String& emitterType)
@@ -289,6 +357,7 @@ namespace Ogre {
         mIterationIntervalSet = rhs.mIterationIntervalSet;
         mNonvisibleTimeout = rhs.mNonvisibleTimeout;
         mNonvisibleTimeoutSet = rhs.mNonvisibleTimeoutSet;
+        setSoAStorage(rhs.mSoAStorage);
         // last frame visible and time since last visible should be left default
 
         setRenderer(rhs.getRendererName());
@@ -360,10 +429,19 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::_update(Real timeElapsed)
+    {
+        if (!prepareUpdate(timeElapsed))
+            return;
+
+        if (updateParticles(timeElapsed))
+            mParentNode->needUpdate();
+    }
+    //-----------------------------------------------------------------------
+    bool ParticleSystem::prepareUpdate(Real& timeElapsed)
     {
         // Only update if attached to a node
         if (!mParentNode)
-            return;
+            return false;
 
         Real nonvisibleTimeout = mNonvisibleTimeoutSet ?
             mNonvisibleTimeout : msDefaultNonvisibleTimeout;
@@ -379,7 +457,7 @@ namespace Ogre {
                 if (mTimeSinceLastVisible >= nonvisibleTimeout)
                 {
                     // No update
-                    return;
+                    return false;
                 }
             }
         }
@@ -393,6 +471,40 @@ namespace Ogre {
         // Initialise emitted emitters list if not done already
         initialiseEmittedEmitters();
 
+        // Let emitters and affectors acquire what they need on this thread
+        ParticleEmitterList::iterator ei, eiEnd = mEmitters.end();
+        for (ei = mEmitters.begin(); ei != eiEnd; ++ei)
+            (*ei)->_prepareUpdate();
+        ActiveEmittedEmitterList::iterator ai, aiEnd = mActiveEmittedEmitters.end();
+        for (ai = mActiveEmittedEmitters.begin(); ai != aiEnd; ++ai)
+            (*ai)->_prepareUpdate();
+        ParticleAffectorList::iterator fi, fiEnd = mAffectors.end();
+        for (fi = mAffectors.begin(); fi != fiEnd; ++fi)
+            (*fi)->_prepareUpdate();
+
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    bool ParticleSystem::updateParticles(Real timeElapsed)
+    {
+        // Draw random numbers from the stream of this system while updating
+        ParticleSystemRandomScope randomScope(mRandomState,
+            mRandomSeedSet || ParticleSystemManager::getSingleton().getParallelUpdate());
+
+        if (mSoAStorage)
+        {
+            if (mParticleSoAStale)
+            {
+                // The Particle objects may have been changed or reordered since
+                mParticleSoA->clear();
+                ActiveParticleList::iterator i, itEnd = mActiveParticles.end();
+                for (i = mActiveParticles.begin(); i != itEnd; ++i)
+                    mParticleSoA->add(*i, i);
+                mParticleSoAStale = false;
+            }
+            mUpdatingSoA = true;
+        }
+
         Real iterationInterval = mIterationIntervalSet ? 
             mIterationInterval : msDefaultIterationInterval;
         if (iterationInterval > 0)
@@ -401,20 +513,31 @@ namespace Ogre {
 
             while (mUpdateRemainTime >= iterationInterval)
             {
-                // Update existing particles
-                _expire(iterationInterval);
-                _triggerAffectors(iterationInterval);
-                _applyMotion(iterationInterval);
-
-                if(mIsEmitting)
+                if (mSoAStorage)
+                {
+                    _updateSoA(iterationInterval);
+                }
+                else
                 {
-                    // Emit new particles
-                    _triggerEmitters(iterationInterval);
+                    // Update existing particles
+                    _expire(iterationInterval);
+                    _triggerAffectors(iterationInterval);
+                    _applyMotion(iterationInterval);
+
+                    if(mIsEmitting)
+                    {
+                        // Emit new particles
+                        _triggerEmitters(iterationInterval);
+                    }
                 }
 
                 mUpdateRemainTime -= iterationInterval;
             }
         }
+        else if (mSoAStorage)
+        {
+            _updateSoA(timeElapsed);
+        }
         else
         {
             // Update existing particles
@@ -429,10 +552,17 @@ namespace Ogre {
             }
         }
 
+        if (mSoAStorage)
+        {
+            // The arrays hold the results, the Particle objects are synchronised on demand
+            mUpdatingSoA = false;
+            mParticleObjectsStale = true;
+            mRenderer->_notifyParticleMoved(mActiveParticles);
+        }
+
         if (!mBoundsAutoUpdate && mBoundsUpdateTime > 0.0f)
             mBoundsUpdateTime -= timeElapsed; // count down 
-        _updateBounds();
-
+        return calculateBounds();
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::_expire(Real timeElapsed)
@@ -484,8 +614,8 @@ namespace Ogre {
     void ParticleSystem::_triggerEmitters(Real timeElapsed)
     {
         // Add up requests for emission
-        static vector<unsigned>::type requested;
-        static vector<unsigned>::type emittedRequested;
+        vector<unsigned>::type& requested = mEmissionRequested;
+        vector<unsigned>::type& emittedRequested = mEmittedEmissionRequested;
 
         if( requested.size() != mEmitters.size() )
             requested.resize( mEmitters.size() );
@@ -612,6 +742,10 @@ namespace Ogre {
 
             // Notify renderer
             mRenderer->_notifyParticleEmitted(p);
+
+            // New particles are always appended to the active list
+            if (mSoAStorage)
+                mParticleSoA->add(p, --mActiveParticles.end());
         }
     }
     //-----------------------------------------------------------------------
@@ -653,6 +787,161 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void ParticleSystem::_updateSoA(Real timeElapsed)
+    {
+        // Update existing particles
+        _expireSoA(timeElapsed);
+        _triggerAffectorsSoA(timeElapsed);
+        _applyMotionSoA(timeElapsed);
+
+        if(mIsEmitting)
+        {
+            // Emit new particles, they are added to the arrays as they are created
+            _triggerEmitters(timeElapsed);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::_expireSoA(Real timeElapsed)
+    {
+        Real* timeToLive = mParticleSoA->mTimeToLive.empty() ? 0 : &mParticleSoA->mTimeToLive[0];
+
+        for (size_t i = 0; i < mParticleSoA->size(); )
+        {
+            if (timeToLive[i] < timeElapsed)
+            {
+                Particle* pParticle = mParticleSoA->getParticle(i);
+                ActiveParticleList::iterator entry = mParticleSoA->getListEntry(i);
+
+                // Notify renderer
+                mRenderer->_notifyParticleExpired(pParticle);
+
+                // Identify the particle type
+                if (pParticle->mParticleType == Particle::Visual)
+                {
+                    // Destroy this one
+                    mFreeParticles.splice(mFreeParticles.end(), mActiveParticles, entry);
+                }
+                else
+                {
+                    // For now, it can only be an emitted emitter
+                    ParticleEmitter* pParticleEmitter = static_cast<ParticleEmitter*>(pParticle);
+                    list<ParticleEmitter*>::type* fee = findFreeEmittedEmitter(pParticleEmitter->getName());
+                    fee->push_back(pParticleEmitter);
+
+                    // Also erase from mActiveEmittedEmitters
+                    removeFromActiveEmittedEmitters (pParticleEmitter);
+
+                    // And erase from mActiveParticles
+                    mActiveParticles.erase(entry);
+                }
+
+                // The last particle moves into this slot, process it next
+                mParticleSoA->swapRemove(i);
+            }
+            else
+            {
+                // Decrement TTL
+                timeToLive[i] -= timeElapsed;
+                ++i;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::_triggerAffectorsSoA(Real timeElapsed)
+    {
+        ParticleAffectorList::iterator i, itEnd;
+        // Whether the Particle objects hold the current state rather than the arrays
+        bool objectsCurrent = false;
+
+        itEnd = mAffectors.end();
+        for (i = mAffectors.begin(); i != itEnd; ++i)
+        {
+            if (objectsCurrent)
+            {
+                mParticleSoA->load();
+                objectsCurrent = false;
+            }
+
+            if (!(*i)->_affectParticlesSoA(this, *mParticleSoA, timeElapsed))
+            {
+                // No SoA support, go through the Particle objects
+                mParticleSoA->store();
+                (*i)->_affectParticles(this, timeElapsed);
+                objectsCurrent = true;
+            }
+        }
+
+        if (objectsCurrent)
+            mParticleSoA->load();
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::_applyMotionSoA(Real timeElapsed)
+    {
+        size_t count = mParticleSoA->size();
+        if (!count)
+            return;
+
+        Real* posX = &mParticleSoA->mPositionX[0];
+        Real* posY = &mParticleSoA->mPositionY[0];
+        Real* posZ = &mParticleSoA->mPositionZ[0];
+        const Real* dirX = &mParticleSoA->mDirectionX[0];
+        const Real* dirY = &mParticleSoA->mDirectionY[0];
+        const Real* dirZ = &mParticleSoA->mDirectionZ[0];
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            posX[i] += dirX[i] * timeElapsed;
+            posY[i] += dirY[i] * timeElapsed;
+            posZ[i] += dirZ[i] * timeElapsed;
+        }
+
+        if (mParticleSoA->getNumEmitters())
+        {
+            // If it is an emitter, the emitter position must also be updated
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (mParticleSoA->mIsEmitter[i])
+                {
+                    ParticleEmitter* pParticleEmitter =
+                        static_cast<ParticleEmitter*>(mParticleSoA->getParticle(i));
+                    pParticleEmitter->setPosition(Vector3(posX[i], posY[i], posZ[i]));
+                }
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::syncParticleObjects(bool modifiable)
+    {
+        if (mParticleSoAStale)
+        {
+            // Already the current state
+            return;
+        }
+        if (mParticleObjectsStale)
+        {
+            mParticleSoA->store();
+            mParticleObjectsStale = false;
+        }
+        mParticleSoAStale = modifiable;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::calculateBoundsSoA(Vector3& min, Vector3& max) const
+    {
+        const ParticleSoA& soa = *mParticleSoA;
+        Real defaultPadding = 0.5f * std::max(mDefaultHeight, mDefaultWidth);
+        for (size_t i = 0; i < soa.size(); ++i)
+        {
+            Real padding = soa.mOwnDimensions[i] ?
+                0.5f * std::max(soa.mWidth[i], soa.mHeight[i]) : defaultPadding;
+            min.x = std::min(min.x, soa.mPositionX[i] - padding);
+            min.y = std::min(min.y, soa.mPositionY[i] - padding);
+            min.z = std::min(min.z, soa.mPositionZ[i] - padding);
+            max.x = std::max(max.x, soa.mPositionX[i] + padding);
+            max.y = std::max(max.y, soa.mPositionY[i] + padding);
+            max.z = std::max(max.z, soa.mPositionZ[i] + padding);
+        }
+    }
+    //-----------------------------------------------------------------------
     void ParticleSystem::increasePool(size_t size)
     {
         size_t oldSize = mParticlePool.size();
@@ -677,12 +966,16 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     ParticleIterator ParticleSystem::_getIterator(void)
     {
+        if (mSoAStorage && !mUpdatingSoA)
+            syncParticleObjects(true);
         return ParticleIterator(mActiveParticles.begin(), mActiveParticles.end());
     }
     //-----------------------------------------------------------------------
     Particle* ParticleSystem::getParticle(size_t index) 
     {
         assert (index < mActiveParticles.size() && "Index out of bounds!");
+        if (mSoAStorage && !mUpdatingSoA)
+            syncParticleObjects(true);
         ActiveParticleList::iterator i = mActiveParticles.begin();
         std::advance(i, index);
         return *i;
@@ -731,6 +1024,8 @@ namespace Ogre {
     {
         if (mRenderer)
         {
+            if (mSoAStorage)
+                syncParticleObjects(false);
             mRenderer->_updateRenderQueue(queue, mActiveParticles, mCullIndividual);
         }
     }
@@ -796,6 +1091,11 @@ namespace Ogre {
                 PT_BOOL),
                 &msLocalSpaceCmd);
 
+            dict->addParameter(ParameterDef("soa_storage", 
+                "Sets whether particles are updated through structure-of-arrays storage. ",
+                PT_BOOL),
+                &msSoAStorageCmd);
+
             dict->addParameter(ParameterDef("iteration_interval", 
                 "Sets a fixed update interval for the system, or 0 for the frame rate. ",
                 PT_REAL),
@@ -812,7 +1112,12 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void ParticleSystem::_updateBounds()
     {
-
+        if (calculateBounds())
+            mParentNode->needUpdate();
+    }
+    //-----------------------------------------------------------------------
+    bool ParticleSystem::calculateBounds(void)
+    {
         if (mParentNode && (mBoundsAutoUpdate || mBoundsUpdateTime > 0.0f))
         {
             if (mActiveParticles.empty())
@@ -843,7 +1148,9 @@ namespace Ogre {
                 Vector3 halfScale = Vector3::UNIT_SCALE * 0.5;
                 Vector3 defaultPadding = 
                     halfScale * std::max(mDefaultHeight, mDefaultWidth);
-                for (p = mActiveParticles.begin(); p != mActiveParticles.end(); ++p)
+                if (mSoAStorage && mParticleObjectsStale)
+                    calculateBoundsSoA(min, max);
+                else for (p = mActiveParticles.begin(); p != mActiveParticles.end(); ++p)
                 {
                     if ((*p)->mOwnDimensions)
                     {
@@ -879,8 +1186,9 @@ namespace Ogre {
                 mAABB.merge(newAABB);
             }
 
-            mParentNode->needUpdate();
+            return true;
         }
+        return false;
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::fastForward(Real time, Real interval)
@@ -1042,6 +1350,12 @@ namespace Ogre {
 
         // Move actives to free list
         mFreeParticles.splice(mFreeParticles.end(), mActiveParticles);
+        if (mParticleSoA)
+        {
+            mParticleSoA->clear();
+            mParticleObjectsStale = false;
+            mParticleSoAStale = false;
+        }
 
         // Add active emitted emitters to free list
         addActiveEmittedEmittersToFreeList();
@@ -1191,6 +1505,32 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void ParticleSystem::setRandomSeed(uint32 seed)
+    {
+        mRandomSeed = mRandomState = seed;
+        mRandomSeedSet = true;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::setSoAStorage(bool enabled)
+    {
+        if (enabled == mSoAStorage)
+            return;
+
+        if (enabled)
+        {
+            if (!mParticleSoA)
+                mParticleSoA = OGRE_NEW ParticleSoA();
+            mParticleSoAStale = true;
+        }
+        else
+        {
+            // The Particle objects take over
+            syncParticleObjects(false);
+            mParticleSoA->clear();
+        }
+        mSoAStorage = enabled;
+    }
+    //-----------------------------------------------------------------------
     void ParticleSystem::setKeepParticlesInLocalSpace(bool keepLocal)
     {
         mLocalSpace = keepLocal;
@@ -1205,6 +1545,12 @@ namespace Ogre {
         if (mRenderer)
         {
             SortMode sortMode = mRenderer->_getSortMode();
+            if (mSoAStorage)
+            {
+                // Sorting moves the particles between the entries of the active list
+                syncParticleObjects(false);
+                mParticleSoAStale = true;
+            }
             if (sortMode == SM_DIRECTION)
             {
                 Vector3 camDir = cam->getDerivedDirection();
@@ -1579,6 +1925,17 @@ namespace Ogre {
             StringConverter::parseBool(val));
     }
     //-----------------------------------------------------------------------
+    String ParticleSystem::CmdSoAStorage::doGet(const void* target) const
+    {
+        return StringConverter::toString(
+            static_cast<const ParticleSystem*>(target)->getSoAStorage());
+    }
+    void ParticleSystem::CmdSoAStorage::doSet(void* target, const String& val)
+    {
+        static_cast<ParticleSystem*>(target)->setSoAStorage(
+            StringConverter::parseBool(val));
+    }
+    //-----------------------------------------------------------------------
     String ParticleSystem::CmdIterationInterval::doGet(const void* target) const
     {
         return StringConverter::toString(
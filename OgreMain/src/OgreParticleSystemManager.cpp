@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreParticleSystemRenderer.h"
 #include "OgreBillboardParticleRenderer.h"
 #include "OgreParticleSystem.h"
+#include "OgreThreadPool.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -49,6 +50,7 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     ParticleSystemManager::ParticleSystemManager()
+        : mParallelUpdate(false)
     {
         OGRE_LOCK_AUTO_MUTEX;
         mFactory = OGRE_NEW ParticleSystemFactory();
@@ -84,6 +86,85 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void ParticleSystemManager::setParallelUpdate(bool enabled)
+    {
+        // Don't lose updates that are already queued
+        if (!enabled)
+            _updateQueuedSystems();
+        mParallelUpdate = enabled;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystemManager::_queueUpdate(ParticleSystem* sys, Real timeElapsed)
+    {
+        if (!sys->mUpdateQueued)
+        {
+            sys->mUpdateQueued = true;
+            sys->mQueuedUpdateTime = 0;
+            mQueuedSystems.push_back(sys);
+        }
+        sys->mQueuedUpdateTime += timeElapsed;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystemManager::_dequeueUpdate(ParticleSystem* sys)
+    {
+        if (sys->mUpdateQueued)
+        {
+            ParticleSystemList::iterator i =
+                std::find(mQueuedSystems.begin(), mQueuedSystems.end(), sys);
+            assert(i != mQueuedSystems.end());
+            mQueuedSystems.erase(i);
+            sys->mUpdateQueued = false;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystemManager::_updateQueuedSystems(void)
+    {
+        if (mQueuedSystems.empty())
+            return;
+
+        // Prepare on this thread, this may configure renderers and load materials
+        mUpdatingSystems.clear();
+        ParticleSystemList::iterator i, iend = mQueuedSystems.end();
+        for (i = mQueuedSystems.begin(); i != iend; ++i)
+        {
+            ParticleSystem* sys = *i;
+            sys->mUpdateQueued = false;
+            if (sys->prepareUpdate(sys->mQueuedUpdateTime))
+            {
+                // Bring the cached transforms of the parent node up to date,
+                // so they are only read while updating
+                Node* parent = sys->getParentNode();
+                parent->_getDerivedPosition();
+                parent->_getFullTransform();
+                mUpdatingSystems.push_back(sys);
+            }
+        }
+        mQueuedSystems.clear();
+
+        // Each system only modifies its own state
+        size_t count = mUpdatingSystems.size();
+        mBoundsChanged.resize(count);
+        ThreadPool::RangeFunction update = [this](size_t begin, size_t end, size_t) {
+            for (size_t s = begin; s < end; ++s)
+            {
+                ParticleSystem* sys = mUpdatingSystems[s];
+                mBoundsChanged[s] = sys->updateParticles(sys->mQueuedUpdateTime);
+            }
+        };
+        ThreadPool* pool = Root::getSingleton().getThreadPool();
+        if (pool)
+            pool->parallelFor(0, count, 1, update);
+        else
+            update(0, count, 0);
+
+        // Notifying the nodes modifies the scene graph
+        for (size_t s = 0; s < count; ++s)
+        {
+            if (mBoundsChanged[s])
+                mUpdatingSystems[s]->getParentNode()->needUpdate();
+        }
+    }
+    //-----------------------------------------------------------------------
     const StringVector& ParticleSystemManager::getScriptPatterns(void) const
     {
         return mScriptPatterns;
@@ -148,13 +148,14 @@ namespace Ogre {
     }
 
     //---------------------------------------------------------------------
-    // Performs CPUID instruction with 'query', fill the results, and return value of eax.
-    static uint _performCpuid(int query, CpuidResult& result)
+    // Performs CPUID instruction with 'query' and 'subQuery' (in ecx), fill the results,
+    // and return value of eax.
+    static uint _performCpuid(int query, CpuidResult& result, int subQuery = 0)
     {
 #if OGRE_COMPILER == OGRE_COMPILER_MSVC
-    #if _MSC_VER >= 1400 
+    #if _MSC_VER >= 1500
         int CPUInfo[4];
-        __cpuid(CPUInfo, query);
+        __cpuidex(CPUInfo, query, subQuery);
         result._eax = CPUInfo[0];
         result._ebx = CPUInfo[1];
         result._ecx = CPUInfo[2];
@@ -165,6 +166,7 @@ namespace Ogre {
         {
             mov     edi, result
             mov     eax, query
+            mov     ecx, subQuery
             cpuid
             mov     [edi]._eax, eax
             mov     [edi]._ebx, ebx
@@ -177,7 +179,7 @@ namespace Ogre {
         #if OGRE_ARCH_TYPE == OGRE_ARCHITECTURE_64
         __asm__
         (
-            "cpuid": "=a" (result._eax), "=b" (result._ebx), "=c" (result._ecx), "=d" (result._edx) : "a" (query)
+            "cpuid": "=a" (result._eax), "=b" (result._ebx), "=c" (result._ecx), "=d" (result._edx) : "a" (query), "c" (subQuery)
         );
         #else
         __asm__
@@ -187,7 +189,7 @@ namespace Ogre {
             "movl   %%ebx, %%edi    \n\t"
             "popl   %%ebx           \n\t"
             : "=a" (result._eax), "=D" (result._ebx), "=c" (result._ecx), "=d" (result._edx)
-            : "a" (query)
+            : "a" (query), "c" (subQuery)
         );
        #endif // OGRE_ARCHITECTURE_64
         return result._eax;
@@ -274,15 +276,36 @@ namespace Ogre {
 #endif
     }
 
+    //---------------------------------------------------------------------
+    // Detect whether or not os saves the AVX (YMM) register state on context switches.
+    // Must only be called if CPUID reports OSXSAVE.
+    static bool _checkOperatingSystemSupportAVX(void)
+    {
+#if OGRE_COMPILER == OGRE_COMPILER_MSVC && _MSC_VER >= 1600
+        unsigned long long xcr0 = _xgetbv(0);
+        return (xcr0 & 6) == 6;
+#elif (OGRE_COMPILER == OGRE_COMPILER_GNUC || OGRE_COMPILER == OGRE_COMPILER_CLANG) && OGRE_PLATFORM != OGRE_PLATFORM_EMSCRIPTEN
+        uint xcr0, xcr0High;
+        __asm__ ("xgetbv" : "=a" (xcr0), "=d" (xcr0High) : "c" (0));
+        return (xcr0 & 6) == 6;
+#else
+        // TODO: Supports other compiler, assumed is not supported by default
+        return false;
+#endif
+    }
+
     //---------------------------------------------------------------------
     // Compiler-independent routines
     //---------------------------------------------------------------------
 
+    static uint queryAvxFeatures(const CpuidResult& standardFeatures, uint maxStandardFunctionSupport);
+
     static uint queryCpuFeatures(void)
     {
 
 #define CPUID_FUNC_VENDOR_ID                 0x0
 #define CPUID_FUNC_STANDARD_FEATURES         0x1
+#define CPUID_FUNC_STRUCTURED_EXTENDED_FEATURES 0x7
 #define CPUID_FUNC_EXTENSION_QUERY           0x80000000
 #define CPUID_FUNC_EXTENDED_FEATURES         0x80000001
 #define CPUID_FUNC_ADVANCED_POWER_MANAGEMENT 0x80000007
@@ -298,6 +321,11 @@ namespace Ogre {
 #define CPUID_STD_SSE3              (1<<0)      // ECX[0]  - Bit 0 of standard function 1 indicate SSE3 supported
 #define CPUID_STD_SSE41             (1<<19)     // ECX[19] - Bit 0 of standard function 1 indicate SSE41 supported
 #define CPUID_STD_SSE42             (1<<20)     // ECX[20] - Bit 0 of standard function 1 indicate SSE42 supported
+#define CPUID_STD_FMA               (1<<12)     // ECX[12] - Bit 12 of standard function 1 indicate FMA3 supported
+#define CPUID_STD_OSXSAVE           (1<<27)     // ECX[27] - Bit 27 of standard function 1 indicate os enabled XSAVE/XGETBV
+#define CPUID_STD_AVX               (1<<28)     // ECX[28] - Bit 28 of standard function 1 indicate AVX supported
+
+#define CPUID_SEF_AVX2              (1<<5)      // EBX[5]  - Bit 5 of function 7 sub-leaf 0 indicate AVX2 supported
 
 #define CPUID_FAMILY_ID_MASK        0x0F00      // EAX[11:8] - Bit 11 thru 8 contains family  processor id
 #define CPUID_EXT_FAMILY_ID_MASK    0x0F00000   // EAX[23:20] - Bit 23 thru 20 contains extended family processor id
@@ -320,6 +348,8 @@ namespace Ogre {
             // Has standard feature ?
             if (_performCpuid(CPUID_FUNC_VENDOR_ID, result))
             {
+                const uint maxStandardFunctionSupport = result._eax;
+
                 // Check vendor strings
                 if (memcmp(&result._ebx, "GenuineIntel", 12) == 0)
                 {
@@ -348,6 +378,8 @@ namespace Ogre {
                     if (result._ecx & CPUID_STD_SSE42)
                         features |= PlatformInformation::CPU_FEATURE_SSE42;
 
+                    features |= queryAvxFeatures(result, maxStandardFunctionSupport);
+
                     // Check to see if this is a Pentium 4 or later processor
                     if ((result._eax & CPUID_EXT_FAMILY_ID_MASK) ||
                         (result._eax & CPUID_FAMILY_ID_MASK) == CPUID_PENTIUM4_ID)
@@ -390,6 +422,8 @@ namespace Ogre {
                     if (result._ecx & CPUID_STD_SSE3)
                         features |= PlatformInformation::CPU_FEATURE_SSE3;
 
+                    features |= queryAvxFeatures(result, maxStandardFunctionSupport);
+
                     // Has extended feature ?
                     const uint maxExtensionFunctionSupport = _performCpuid(CPUID_FUNC_EXTENSION_QUERY, result);
                     if (maxExtensionFunctionSupport >= CPUID_FUNC_EXTENDED_FEATURES)
@@ -420,6 +454,35 @@ namespace Ogre {
         return features;
     }
     //---------------------------------------------------------------------
+    // Query AVX, AVX2 and FMA support, 'standardFeatures' is the result of standard function 1.
+    static uint queryAvxFeatures(const CpuidResult& standardFeatures, uint maxStandardFunctionSupport)
+    {
+        uint features = 0;
+
+        // The YMM registers are only usable if the os saves them on context switches
+        if (!(standardFeatures._ecx & CPUID_STD_AVX) ||
+            !(standardFeatures._ecx & CPUID_STD_OSXSAVE) ||
+            !_checkOperatingSystemSupportAVX())
+        {
+            return features;
+        }
+
+        features |= PlatformInformation::CPU_FEATURE_AVX;
+        if (standardFeatures._ecx & CPUID_STD_FMA)
+            features |= PlatformInformation::CPU_FEATURE_FMA;
+
+        if (maxStandardFunctionSupport >= CPUID_FUNC_STRUCTURED_EXTENDED_FEATURES)
+        {
+            CpuidResult result;
+            _performCpuid(CPUID_FUNC_STRUCTURED_EXTENDED_FEATURES, result, 0);
+
+            if (result._ebx & CPUID_SEF_AVX2)
+                features |= PlatformInformation::CPU_FEATURE_AVX2;
+        }
+
+        return features;
+    }
+    //---------------------------------------------------------------------
     static uint _detectCpuFeatures(void)
     {
         uint features = queryCpuFeatures();
@@ -429,7 +492,10 @@ namespace Ogre {
             | PlatformInformation::CPU_FEATURE_SSE2
             | PlatformInformation::CPU_FEATURE_SSE3
             | PlatformInformation::CPU_FEATURE_SSE41
-            | PlatformInformation::CPU_FEATURE_SSE42;
+            | PlatformInformation::CPU_FEATURE_SSE42
+            | PlatformInformation::CPU_FEATURE_AVX
+            | PlatformInformation::CPU_FEATURE_AVX2
+            | PlatformInformation::CPU_FEATURE_FMA;
 
         if ((features & sse_features) && !_checkOperatingSystemSupportSSE())
         {
@@ -703,6 +769,12 @@ namespace Ogre {
                 " *        SSE41: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_SSE41), true));
             pLog->logMessage(
                 " *        SSE42: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_SSE42), true));
+            pLog->logMessage(
+                " *          AVX: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_AVX), true));
+            pLog->logMessage(
+                " *         AVX2: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_AVX2), true));
+            pLog->logMessage(
+                " *          FMA: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_FMA), true));
             pLog->logMessage(
                 " *          MMX: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_MMX), true));
             pLog->logMessage(
@@ -28,8 +28,55 @@ THE SOFTWARE.
 #include "OgreStableHeaders.h"
 #include "OgreScriptLoader.h"
 
+#include <sys/stat.h>
+
 namespace Ogre {
 
+namespace {
+    /// Identifies a saved location index cache and its layout version
+    const uint32 LOCATION_INDEX_CACHE_ID = 0x49524C4F; // 'OLRI'
+    const uint32 LOCATION_INDEX_CACHE_VERSION = 1;
+
+    bool readLocationStamp(const String& location, const String& path,
+                           int64& modified, int64& size, bool* isDir = 0)
+    {
+        String fullPath = path.empty() ? location : location + "/" + path;
+        struct stat tagStat;
+        if (stat(fullPath.c_str(), &tagStat) != 0)
+            return false;
+        // use the full timestamp resolution where available, changes within the same
+        // second would be missed otherwise
+#if OGRE_PLATFORM == OGRE_PLATFORM_LINUX || OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
+        modified = static_cast<int64>(tagStat.st_mtim.tv_sec) * 1000000000 + tagStat.st_mtim.tv_nsec;
+#elif OGRE_PLATFORM == OGRE_PLATFORM_APPLE || OGRE_PLATFORM == OGRE_PLATFORM_APPLE_IOS
+        modified = static_cast<int64>(tagStat.st_mtimespec.tv_sec) * 1000000000 + tagStat.st_mtimespec.tv_nsec;
+#else
+        modified = static_cast<int64>(tagStat.st_mtime);
+#endif
+        size = static_cast<int64>(tagStat.st_size);
+        if (isDir)
+            *isDir = (tagStat.st_mode & S_IFMT) == S_IFDIR;
+        return true;
+    }
+
+    void writeString(const DataStreamPtr& stream, const String& str)
+    {
+        uint32 length = static_cast<uint32>(str.size());
+        stream->write(&length, sizeof(uint32));
+        stream->write(str.data(), length);
+    }
+
+    bool readString(const DataStreamPtr& stream, String& str)
+    {
+        uint32 length = 0;
+        if (stream->read(&length, sizeof(uint32)) != sizeof(uint32) ||
+            length > stream->size() - stream->tell())
+            return false;
+        str.resize(length);
+        return length == 0 || stream->read(&str[0], length) == length;
+    }
+}
+
     //-----------------------------------------------------------------------
     template<> ResourceGroupManager* Singleton<ResourceGroupManager>::msSingleton = 0;
     ResourceGroupManager* ResourceGroupManager::getSingletonPtr(void)
@@ -54,7 +101,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     ResourceGroupManager::ResourceGroupManager()
-        : mLoadingListener(0), mCurrentGroup(0)
+        : mLoadingListener(0), mUseLocationIndexCache(false)
+        , mLocationIndexCacheDirty(false), mCurrentGroup(0)
     {
         // Create the 'General' group
         createResourceGroup(DEFAULT_RESOURCE_GROUP_NAME, true); // the "General" group is synonymous to global pool
@@ -534,7 +582,7 @@ namespace Ogre {
         // Add to location list
 
         ResourceLocation loc = {pArch, recursive};
-        StringVectorPtr vec = pArch->find("*", recursive);
+        StringVectorPtr vec = listLocationContents(pArch, recursive);
 
         ResourceGroup* grp = getResourceGroup(resGroup);
         if (!grp)
@@ -591,6 +639,158 @@ namespace Ogre {
         LogManager::getSingleton().logMessage("Removed resource location " + name);
 
 
+    }
+    //-----------------------------------------------------------------------
+    StringVectorPtr ResourceGroupManager::listLocationContents(Archive* arch, bool recursive)
+    {
+        if (!mUseLocationIndexCache)
+            return arch->find("*", recursive);
+
+        const String& location = arch->getName();
+        String key = arch->getType() + (recursive ? "|r|" : "|n|") + location;
+
+        {
+            OGRE_LOCK_AUTO_MUTEX;
+            LocationIndexCache::const_iterator it = mLocationIndexCache.find(key);
+            if (it != mLocationIndexCache.end())
+            {
+                const LocationStampList& stamps = it->second.stamps;
+                bool unchanged = true;
+                for (size_t i = 0; i < stamps.size() && unchanged; ++i)
+                {
+                    int64 modified, size;
+                    unchanged = readLocationStamp(location, stamps[i].path, modified, size) &&
+                                modified == stamps[i].modified && size == stamps[i].size;
+                }
+                if (unchanged)
+                {
+                    return StringVectorPtr(OGRE_NEW_T(StringVector, MEMCATEGORY_GENERAL)(
+                        it->second.files), SPFM_DELETE_T);
+                }
+            }
+        }
+
+        // Stamp before listing, so changes made while listing show up next time
+        LocationIndexCacheEntry entry;
+        LocationStamp stamp;
+        bool isDir = false;
+        if (!readLocationStamp(location, BLANKSTRING, stamp.modified, stamp.size, &isDir))
+        {
+            // not a path on disk, nothing to validate a cache entry against
+            return arch->find("*", recursive);
+        }
+        entry.stamps.push_back(stamp);
+
+        if (isDir && recursive)
+        {
+            // files are only added / removed through the directories that contain them
+            StringVectorPtr dirs = arch->find("*", true, true);
+            for (StringVector::iterator i = dirs->begin(); i != dirs->end(); ++i)
+            {
+                stamp.path = *i;
+                if (readLocationStamp(location, stamp.path, stamp.modified, stamp.size))
+                    entry.stamps.push_back(stamp);
+            }
+        }
+
+        StringVectorPtr vec = arch->find("*", recursive);
+        entry.files = *vec;
+
+        OGRE_LOCK_AUTO_MUTEX;
+        LocationIndexCacheEntry& cached = mLocationIndexCache[key];
+        cached.stamps.swap(entry.stamps);
+        cached.files.swap(entry.files);
+        mLocationIndexCacheDirty = true;
+        return vec;
+    }
+    //-----------------------------------------------------------------------
+    void ResourceGroupManager::setUseResourceIndexCache(bool use)
+    {
+        mUseLocationIndexCache = use;
+    }
+    //-----------------------------------------------------------------------
+    void ResourceGroupManager::saveResourceIndexCache(const DataStreamPtr& stream) const
+    {
+        if (!stream->isWriteable())
+        {
+            OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE,
+                "Unable to write to stream " + stream->getName(),
+                "ResourceGroupManager::saveResourceIndexCache");
+        }
+
+        OGRE_LOCK_AUTO_MUTEX;
+
+        stream->write(&LOCATION_INDEX_CACHE_ID, sizeof(uint32));
+        stream->write(&LOCATION_INDEX_CACHE_VERSION, sizeof(uint32));
+        uint32 numEntries = static_cast<uint32>(mLocationIndexCache.size());
+        stream->write(&numEntries, sizeof(uint32));
+
+        LocationIndexCache::const_iterator it, itend = mLocationIndexCache.end();
+        for (it = mLocationIndexCache.begin(); it != itend; ++it)
+        {
+            writeString(stream, it->first);
+
+            const LocationStampList& stamps = it->second.stamps;
+            uint32 numStamps = static_cast<uint32>(stamps.size());
+            stream->write(&numStamps, sizeof(uint32));
+            for (size_t i = 0; i < stamps.size(); ++i)
+            {
+                writeString(stream, stamps[i].path);
+                stream->write(&stamps[i].modified, sizeof(int64));
+                stream->write(&stamps[i].size, sizeof(int64));
+            }
+
+            const StringVector& files = it->second.files;
+            uint32 numFiles = static_cast<uint32>(files.size());
+            stream->write(&numFiles, sizeof(uint32));
+            for (size_t i = 0; i < files.size(); ++i)
+                writeString(stream, files[i]);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ResourceGroupManager::loadResourceIndexCache(const DataStreamPtr& stream)
+    {
+        LocationIndexCache cache;
+
+        uint32 header[3] = {0, 0, 0};
+        bool valid = stream->read(header, sizeof(header)) == sizeof(header) &&
+            header[0] == LOCATION_INDEX_CACHE_ID && header[1] == LOCATION_INDEX_CACHE_VERSION;
+
+        for (uint32 e = 0; valid && e < header[2]; ++e)
+        {
+            String key;
+            uint32 count = 0;
+            valid = readString(stream, key) &&
+                stream->read(&count, sizeof(uint32)) == sizeof(uint32);
+            LocationIndexCacheEntry& entry = cache[key];
+
+            for (uint32 i = 0; valid && i < count; ++i)
+            {
+                LocationStamp stamp;
+                valid = readString(stream, stamp.path) &&
+                    stream->read(&stamp.modified, sizeof(int64)) == sizeof(int64) &&
+                    stream->read(&stamp.size, sizeof(int64)) == sizeof(int64);
+                entry.stamps.push_back(stamp);
+            }
+
+            valid = valid && stream->read(&count, sizeof(uint32)) == sizeof(uint32);
+            for (uint32 i = 0; valid && i < count; ++i)
+            {
+                entry.files.push_back(BLANKSTRING);
+                valid = readString(stream, entry.files.back());
+            }
+        }
+
+        if (!valid)
+        {
+            LogManager::getSingleton().logMessage(
+                "Ignoring invalid or outdated resource index cache " + stream->getName(), LML_WARNING);
+            cache.clear();
+        }
+
+        OGRE_LOCK_AUTO_MUTEX;
+        mLocationIndexCache.swap(cache);
+        mLocationIndexCacheDirty = false;
     }
     //-----------------------------------------------------------------------
     void ResourceGroupManager::declareResource(const String& name, 
@@ -1008,7 +1208,8 @@ namespace Ogre {
                         if (mLoadingListener)
                             mLoadingListener->resourceStreamOpened(fii->filename, grp->name, 0, stream);
 
-                        if(fii->archive->getType() == "FileSystem" && stream->size() <= 1024 * 1024)
+                        if(fii->archive->getType() == "FileSystem" && stream->size() <= 1024 * 1024 &&
+                           !dynamic_cast<MemoryDataStream*>(stream.get()))
                         {
                             DataStreamPtr cachedCopy(OGRE_NEW MemoryDataStream(stream->getName(), stream));
                             su->parseScript(cachedCopy, grp->name);
@@ -48,6 +48,7 @@ THE SOFTWARE.
 #include "OgreRenderQueueInvocation.h"
 #include "OgreConvexBody.h"
 #include "OgreTimer.h"
+#include "OgreThreadPool.h"
 #include "OgreFrameListener.h"
 #include "OgreLodStrategyManager.h"
 #include "OgreFileSystemLayer.h"
@@ -161,6 +162,9 @@ namespace Ogre {
         defaultQ->setWorkersCanAccessRenderSystem(OGRE_THREAD_SUPPORT == 1);
         mWorkQueue = defaultQ;
 
+        // ThreadPool for synchronous per-frame jobs, the calling thread takes part in those
+        mThreadPool = OGRE_NEW ThreadPool(threadCount - 1);
+
         // ResourceBackgroundQueue
         mResourceBackgroundQueue = OGRE_NEW ResourceBackgroundQueue();
 
@@ -316,6 +320,7 @@ namespace Ogre {
         OGRE_DELETE mRibbonTrailFactory;
 
         OGRE_DELETE mWorkQueue;
+        OGRE_DELETE mThreadPool;
 
         OGRE_DELETE mTimer;
 
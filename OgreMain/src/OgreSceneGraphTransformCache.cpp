@@ -0,0 +1,225 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreSceneGraphTransformCache.h"
+#include "OgreThreadPool.h"
+
+namespace Ogre {
+
+    namespace
+    {
+        /// Nodes per job chunk; levels with fewer nodes are processed serially
+        const size_t NODE_GRAIN_SIZE = 256;
+    }
+    //-----------------------------------------------------------------------
+    SceneGraphTransformCache::SceneGraphTransformCache()
+        : mRoot(0), mHierarchyDirty(true)
+    {
+    }
+    //-----------------------------------------------------------------------
+    void SceneGraphTransformCache::rebuild(SceneNode* root)
+    {
+        mNodes.clear();
+        mParents.clear();
+        mFirstChild.clear();
+        mNumChildren.clear();
+        mLevelOffsets.clear();
+
+        mNodes.push_back(root);
+        mParents.push_back(~0u);
+        mLevelOffsets.push_back(0);
+
+        // breadth-first, so the children of each node end up adjacent
+        size_t levelBegin = 0;
+        while (levelBegin < mNodes.size())
+        {
+            size_t levelEnd = mNodes.size();
+            for (size_t i = levelBegin; i < levelEnd; ++i)
+            {
+                const Node::ChildNodeMap& children = mNodes[i]->getChildren();
+                mFirstChild.push_back(static_cast<uint32>(mNodes.size()));
+                mNumChildren.push_back(static_cast<uint32>(children.size()));
+                for (size_t c = 0; c < children.size(); ++c)
+                {
+                    mNodes.push_back(static_cast<SceneNode*>(children[c]));
+                    mParents.push_back(static_cast<uint32>(i));
+                }
+            }
+            mLevelOffsets.push_back(levelEnd);
+            levelBegin = levelEnd;
+        }
+
+        size_t count = mNodes.size();
+        mState.resize(count);
+        mPositionX.resize(count);
+        mPositionY.resize(count);
+        mPositionZ.resize(count);
+        mOrientationW.resize(count);
+        mOrientationX.resize(count);
+        mOrientationY.resize(count);
+        mOrientationZ.resize(count);
+        mScaleX.resize(count);
+        mScaleY.resize(count);
+        mScaleZ.resize(count);
+
+        // nodes that are not visited by the next update keep their current transform
+        for (size_t i = 0; i < count; ++i)
+            storeTransform(i);
+
+        mRoot = root;
+        mHierarchyDirty = false;
+    }
+    //-----------------------------------------------------------------------
+    void SceneGraphTransformCache::storeTransform(size_t i)
+    {
+        const Node* n = mNodes[i];
+        mPositionX[i] = n->mDerivedPosition.x;
+        mPositionY[i] = n->mDerivedPosition.y;
+        mPositionZ[i] = n->mDerivedPosition.z;
+        mOrientationW[i] = n->mDerivedOrientation.w;
+        mOrientationX[i] = n->mDerivedOrientation.x;
+        mOrientationY[i] = n->mDerivedOrientation.y;
+        mOrientationZ[i] = n->mDerivedOrientation.z;
+        mScaleX[i] = n->mDerivedScale.x;
+        mScaleY[i] = n->mDerivedScale.y;
+        mScaleZ[i] = n->mDerivedScale.z;
+    }
+    //-----------------------------------------------------------------------
+    void SceneGraphTransformCache::updateNodes(size_t begin, size_t end)
+    {
+        // Mirrors Node::_update, except that listeners and attached objects are
+        // notified later on the calling thread
+        for (size_t i = begin; i < end; ++i)
+        {
+            uint8 state = mState[i];
+            if (!(state & NS_VISITED))
+                continue;
+
+            SceneNode* n = mNodes[i];
+            bool parentHasChanged = (state & NS_PARENT_CHANGED) != 0;
+
+            n->mParentNotified = false;
+
+            if (n->mNeedParentUpdate || parentHasChanged)
+            {
+                n->Node::updateFromParentImpl();
+                // children read this while being updated concurrently, so compute it now
+                n->_getFullTransform();
+                storeTransform(i);
+                state |= NS_MOVED;
+            }
+
+            uint32 firstChild = mFirstChild[i];
+            uint32 childEnd = firstChild + mNumChildren[i];
+            if (n->mNeedChildUpdate || parentHasChanged)
+            {
+                for (uint32 c = firstChild; c < childEnd; ++c)
+                    mState[c] = NS_VISITED | NS_PARENT_CHANGED;
+            }
+            else if (!n->mChildrenToUpdate.empty())
+            {
+                // Just update selected children
+                for (uint32 c = firstChild; c < childEnd; ++c)
+                {
+                    if (n->mChildrenToUpdate.count(mNodes[c]))
+                        mState[c] = NS_VISITED;
+                }
+            }
+
+            n->mChildrenToUpdate.clear();
+            n->mNeedChildUpdate = false;
+            mState[i] = state;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneGraphTransformCache::updateBounds(size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (mState[i] & NS_VISITED)
+                mNodes[i]->_updateBounds();
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneGraphTransformCache::update(SceneNode* root, ThreadPool* pool, bool parallelBounds)
+    {
+        if (mHierarchyDirty || root != mRoot)
+            rebuild(root);
+
+        std::fill(mState.begin(), mState.end(), 0);
+        mState[0] = NS_VISITED;
+
+        size_t numLevels = getNumLevels();
+        for (size_t level = 0; level < numLevels; ++level)
+        {
+            size_t begin = mLevelOffsets[level], end = mLevelOffsets[level + 1];
+            if (pool)
+            {
+                pool->parallelFor(begin, end, NODE_GRAIN_SIZE,
+                                  [this](size_t b, size_t e, size_t) { updateNodes(b, e); });
+            }
+            else
+            {
+                updateNodes(begin, end);
+            }
+        }
+
+        // Notify in depth order what SceneNode::updateFromParentImpl and
+        // Node::_updateFromParent would have notified
+        for (size_t i = 0; i < mNodes.size(); ++i)
+        {
+            if (!(mState[i] & NS_MOVED))
+                continue;
+
+            const SceneNode* n = mNodes[i];
+            const SceneNode::ObjectMap& objects = n->getAttachedObjects();
+            for (SceneNode::ObjectMap::const_iterator o = objects.begin(); o != objects.end(); ++o)
+            {
+                (*o)->_notifyMoved();
+            }
+
+            if (Node::Listener* listener = n->getListener())
+                listener->nodeUpdated(n);
+        }
+
+        // Bounds are merged bottom-up, children before parents
+        for (size_t level = numLevels; level-- > 0;)
+        {
+            size_t begin = mLevelOffsets[level], end = mLevelOffsets[level + 1];
+            if (pool && parallelBounds)
+            {
+                pool->parallelFor(begin, end, NODE_GRAIN_SIZE,
+                                  [this](size_t b, size_t e, size_t) { updateBounds(b, e); });
+            }
+            else
+            {
+                updateBounds(begin, end);
+            }
+        }
+    }
+}
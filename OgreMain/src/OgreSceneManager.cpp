@@ -52,6 +52,11 @@ THE SOFTWARE.
 #include "OgreLodListener.h"
 #include "OgreInstancedGeometry.h"
 #include "OgreUnifiedHighLevelGpuProgram.h"
+#include "OgreSceneGraphTransformCache.h"
+#include "OgreParallelSceneCuller.h"
+#include "OgreAnimationPrePass.h"
+#include "OgreThreadPool.h"
+#include "OgreSceneQueryBroadPhase.h"
 
 // This class implements the most basic scene manager
 
@@ -101,6 +106,15 @@ mMovableNameGenerator("Ogre/MO"),
 mShadowCasterPlainBlackPass(0),
 mShadowReceiverPass(0),
 mDisplayNodes(false),
+mTransformCache(0),
+mParallelSceneGraphUpdate(false),
+mParallelSceneGraphUpdateSupported(true),
+mParallelNodeBoundsUpdate(true),
+mParallelCuller(0),
+mParallelCulling(false),
+mAnimationPrePass(0),
+mParallelAnimationUpdate(false),
+mSceneQueryBroadPhase(0),
 mShowBoundingBoxes(false),
 mActiveCompositorChain(0),
 mLateMaterialResolving(false),
@@ -194,11 +208,16 @@ SceneManager::~SceneManager()
 
     OGRE_DELETE mShadowCasterQueryListener;
     OGRE_DELETE mSceneRoot;
+    OGRE_DELETE mTransformCache;
+    OGRE_DELETE mParallelCuller;
+    OGRE_DELETE mAnimationPrePass;
     OGRE_DELETE mFullScreenQuad;
     OGRE_DELETE mShadowCasterSphereQuery;
     OGRE_DELETE mShadowCasterAABBQuery;
     OGRE_DELETE mRenderQueue;
     OGRE_DELETE mAutoParamDataSource;
+    // last, objects deleted above notify it when detached
+    OGRE_DELETE mSceneQueryBroadPhase;
 }
 //-----------------------------------------------------------------------
 RenderQueue* SceneManager::getRenderQueue(void)
@@ -1412,6 +1431,8 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
     // Update controllers 
     ControllerManager::getSingleton().updateAllControllers();
+    // Run the particle system updates queued by the controllers
+    ParticleSystemManager::getSingleton()._updateQueuedSystems();
 
     // Update the scene, only do this once per frame
     unsigned long thisFrameNumber = Root::getSingleton().getNextFrameNumber();
@@ -1533,8 +1554,16 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
             // Parse the scene and tag visibles
             firePreFindVisibleObjects(vp);
+            AnimationPrePass* animationPrePass = _getAnimationPrePass();
+            if (animationPrePass)
+                animationPrePass->begin();
             _findVisibleObjects(camera, &(camVisObjIt->second),
                 mIlluminationStage == IRS_RENDER_TO_TEXTURE? true : false);
+            if (animationPrePass)
+            {
+                Root* root = Root::getSingletonPtr();
+                animationPrePass->end(root ? root->getThreadPool() : NULL);
+            }
             firePostFindVisibleObjects(vp);
 
             mAutoParamDataSource->setMainCamBoundsInfo(&(camVisObjIt->second));
@@ -2291,11 +2320,27 @@ void SceneManager::_updateSceneGraph(Camera* cam)
     // Process queued needUpdate calls 
     Node::processQueuedUpdates();
 
+    // Collect the nodes whose bounds change for the scene query index
+    if (mSceneQueryBroadPhase)
+        mSceneQueryBroadPhase->_beginSceneGraphUpdate(mSceneNodes.size() + 1);
+
     // Cascade down the graph updating transforms & world bounds
     // In this implementation, just update from the root
     // Smarter SceneManager subclasses may choose to update only
     //   certain scene graph branches
-    getRootSceneNode()->_update(true, false);
+    if (mParallelSceneGraphUpdate)
+    {
+        Root* root = Root::getSingletonPtr();
+        mTransformCache->update(getRootSceneNode(), root ? root->getThreadPool() : NULL,
+                                mParallelNodeBoundsUpdate);
+    }
+    else
+    {
+        getRootSceneNode()->_update(true, false);
+    }
+
+    if (mSceneQueryBroadPhase)
+        mSceneQueryBroadPhase->_endSceneGraphUpdate();
 
     firePostUpdateSceneGraph(cam);
 }
@@ -2303,6 +2348,14 @@ void SceneManager::_updateSceneGraph(Camera* cam)
 void SceneManager::_findVisibleObjects(
     Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
 {
+    if (mParallelCulling)
+    {
+        Root* root = Root::getSingletonPtr();
+        mParallelCuller->findVisibleObjects(getRootSceneNode(), cam, getRenderQueue(),
+            visibleBounds, mDisplayNodes, onlyShadowCasters, root ? root->getThreadPool() : NULL);
+        return;
+    }
+
     // Tell nodes to find, cascade down all nodes
     getRootSceneNode()->_findVisibleObjects(cam, getRenderQueue(), visibleBounds, true, 
         mDisplayNodes, onlyShadowCasters);
@@ -3646,6 +3699,39 @@ void SceneManager::setDisplaySceneNodes(bool display)
     mDisplayNodes = display;
 }
 //-----------------------------------------------------------------------
+void SceneManager::setParallelSceneGraphUpdate(bool enabled)
+{
+    mParallelSceneGraphUpdate = enabled && mParallelSceneGraphUpdateSupported;
+    if (mParallelSceneGraphUpdate && !mTransformCache)
+        mTransformCache = OGRE_NEW SceneGraphTransformCache();
+}
+//-----------------------------------------------------------------------
+void SceneManager::setParallelCulling(bool enabled)
+{
+    mParallelCulling = enabled;
+    if (mParallelCulling && !mParallelCuller)
+        mParallelCuller = OGRE_NEW ParallelSceneCuller();
+}
+//-----------------------------------------------------------------------
+void SceneManager::setParallelAnimationUpdate(bool enabled)
+{
+    mParallelAnimationUpdate = enabled;
+    if (mParallelAnimationUpdate && !mAnimationPrePass)
+        mAnimationPrePass = OGRE_NEW AnimationPrePass();
+}
+//-----------------------------------------------------------------------
+SceneQueryBroadPhase* SceneManager::createSceneQueryBroadPhase(void)
+{
+    mSceneQueryBroadPhase = OGRE_NEW SceneQueryBroadPhase(this);
+    return mSceneQueryBroadPhase;
+}
+//-----------------------------------------------------------------------
+void SceneManager::_notifySceneGraphChanged(void)
+{
+    if (mTransformCache)
+        mTransformCache->_notifyHierarchyChanged();
+}
+//-----------------------------------------------------------------------
 Animation* SceneManager::createAnimation(const String& name, Real length)
 {
     OGRE_LOCK_MUTEX(mAnimationsListMutex);
@@ -26,6 +26,7 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "OgreStableHeaders.h"
+#include "OgreSceneQueryBroadPhase.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -68,6 +69,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void SceneNode::setParent(Node* parent)
     {
+        bool wasInSceneGraph = mIsInSceneGraph;
+
         Node::setParent(parent);
 
         if (parent)
@@ -79,6 +82,10 @@ namespace Ogre {
         {
             setInSceneGraph(false);
         }
+
+        // the shape of the scene graph changed
+        if (mCreator && (wasInSceneGraph || mIsInSceneGraph))
+            mCreator->_notifySceneGraphChanged();
     }
     //-----------------------------------------------------------------------
     void SceneNode::setInSceneGraph(bool inGraph)
@@ -256,6 +263,13 @@ namespace Ogre {
             mWorldAABB.merge(sceneChild->mWorldAABB);
         }
 
+        // Let the scene query index pick up the new object bounds
+        if (!mObjectsByName.empty())
+        {
+            SceneQueryBroadPhase* broadPhase = mCreator->_getSceneQueryBroadPhase(false);
+            if (broadPhase)
+                broadPhase->_notifyNodeUpdated(this);
+        }
     }
     //-----------------------------------------------------------------------
     void SceneNode::_findVisibleObjects(Camera* cam, RenderQueue* queue, 
@@ -266,6 +280,14 @@ namespace Ogre {
         if (!cam->isVisible(mWorldAABB))
             return;
 
+        findVisibleObjectsImpl(cam, queue, visibleBounds, includeChildren, displayNodes,
+                               onlyShadowCasters);
+    }
+    //-----------------------------------------------------------------------
+    void SceneNode::findVisibleObjectsImpl(Camera* cam, RenderQueue* queue,
+        VisibleObjectsBoundsInfo* visibleBounds, bool includeChildren,
+        bool displayNodes, bool onlyShadowCasters)
+    {
         // Add all entities
         ObjectMap::iterator iobj;
         ObjectMap::iterator iobjend = mObjectsByName.end();
@@ -278,16 +300,55 @@ namespace Ogre {
 
         if (includeChildren)
         {
-            ChildNodeMap::iterator child, childend;
-            childend = mChildren.end();
-            for (child = mChildren.begin(); child != childend; ++child)
+            if (mChildren.size() < BULK_CULL_THRESHOLD)
             {
-                SceneNode* sceneChild = static_cast<SceneNode*>(*child);
-                sceneChild->_findVisibleObjects(cam, queue, visibleBounds, includeChildren, 
-                    displayNodes, onlyShadowCasters);
+                ChildNodeMap::iterator child, childend;
+                childend = mChildren.end();
+                for (child = mChildren.begin(); child != childend; ++child)
+                {
+                    SceneNode* sceneChild = static_cast<SceneNode*>(*child);
+                    sceneChild->_findVisibleObjects(cam, queue, visibleBounds, includeChildren,
+                        displayNodes, onlyShadowCasters);
+                }
+            }
+            else
+            {
+                // Test the children in bulk, 32 at a time
+                for (size_t begin = 0; begin < mChildren.size(); begin += 32)
+                {
+                    size_t count = std::min(mChildren.size() - begin, size_t(32));
+                    uint32 visible = _getVisibleChildren(cam, begin, count);
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        if (visible & (1u << i))
+                        {
+                            static_cast<SceneNode*>(mChildren[begin + i])->findVisibleObjectsImpl(
+                                cam, queue, visibleBounds, includeChildren, displayNodes,
+                                onlyShadowCasters);
+                        }
+                    }
+                }
             }
         }
 
+        _addDebugRenderablesToQueue(queue, displayNodes);
+    }
+    //-----------------------------------------------------------------------
+    uint32 SceneNode::_getVisibleChildren(Camera* cam, size_t begin, size_t count) const
+    {
+        assert(count <= 32 && begin + count <= mChildren.size());
+
+        const AxisAlignedBox* boxes[32];
+        for (size_t i = 0; i < count; ++i)
+            boxes[i] = &static_cast<SceneNode*>(mChildren[begin + i])->mWorldAABB;
+
+        uint32 visible;
+        cam->isVisible(count, boxes, &visible);
+        return visible;
+    }
+    //-----------------------------------------------------------------------
+    void SceneNode::_addDebugRenderablesToQueue(RenderQueue* queue, bool displayNodes)
+    {
         if (displayNodes)
         {
             // Include self in the render queue
@@ -301,8 +362,6 @@ namespace Ogre {
         { 
             _addBoundingBoxToQueue(queue);
         }
-
-
     }
 
     Node::DebugRenderable* SceneNode::getDebugRenderable()
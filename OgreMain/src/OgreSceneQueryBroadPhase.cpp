@@ -0,0 +1,336 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreSceneQueryBroadPhase.h"
+
+namespace Ogre {
+
+    namespace {
+        /// Visits every tracked object
+        struct ResetVisitor
+        {
+            bool overlaps(const Vector3&, const Vector3&) const { return true; }
+            bool visit(MovableObject* obj) const
+            {
+                obj->_notifyBroadPhaseProxy(0, 0);
+                return true;
+            }
+        };
+
+        /// Collects the proxies of all objects in the tree
+        struct ProxyCollector
+        {
+            vector<uint32>::type& proxies;
+
+            bool overlaps(const Vector3&, const Vector3&) const { return true; }
+            bool visit(void* userData) const
+            {
+                proxies.push_back(static_cast<MovableObject*>(userData)->_getBroadPhaseProxy());
+                return true;
+            }
+        };
+
+        /// Whether a pair involves one of a sorted list of proxies
+        template <class ProxyPair> struct PairInvalidated
+        {
+            const vector<uint32>::type& proxies;
+
+            bool operator()(const ProxyPair& pair) const
+            {
+                return std::binary_search(proxies.begin(), proxies.end(), pair.proxyA) ||
+                    std::binary_search(proxies.begin(), proxies.end(), pair.proxyB);
+            }
+        };
+
+        /// Pairs a proxy with the proxies overlapping its stored box
+        template <class ProxyPair> struct PairCollector
+        {
+            AxisAlignedBox box;
+            uint32 proxy;
+            MovableObject* object;
+            /// sorted, pairs between two of these are only collected for the lower proxy
+            const vector<uint32>::type& collecting;
+            typename vector<ProxyPair>::type& pairs;
+
+            bool overlaps(const Vector3& min, const Vector3& max) const
+            {
+                return box.intersects(AxisAlignedBox(min, max));
+            }
+            bool visit(void* userData) const
+            {
+                MovableObject* other = static_cast<MovableObject*>(userData);
+                uint32 otherProxy = other->_getBroadPhaseProxy();
+                if (otherProxy == proxy || (otherProxy < proxy &&
+                    std::binary_search(collecting.begin(), collecting.end(), otherProxy)))
+                    return true;
+
+                ProxyPair pair = {proxy, otherProxy, object, other};
+                pairs.push_back(pair);
+                return true;
+            }
+        };
+    }
+    //-----------------------------------------------------------------------
+    SceneQueryBroadPhase::SceneQueryBroadPhase(SceneManager* owner)
+        : mOwner(owner)
+        , mRebuildRequired(true)
+        , mPairsValid(false)
+        , mInSceneGraphUpdate(false)
+        , mNumUpdatedNodes(0)
+    {
+    }
+    //-----------------------------------------------------------------------
+    SceneQueryBroadPhase::~SceneQueryBroadPhase()
+    {
+        ResetVisitor visitor;
+        traverse(visitor);
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadPhase::update()
+    {
+        if (mRebuildRequired)
+            rebuild();
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadPhase::_beginSceneGraphUpdate(size_t maxUpdatedNodes)
+    {
+        if (mUpdatedNodes.size() < maxUpdatedNodes)
+            mUpdatedNodes.resize(maxUpdatedNodes);
+        mNumUpdatedNodes = 0;
+        mInSceneGraphUpdate = true;
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadPhase::_endSceneGraphUpdate()
+    {
+        mInSceneGraphUpdate = false;
+
+        size_t numNodes = mNumUpdatedNodes;
+        mNumUpdatedNodes = 0;
+        if (mRebuildRequired)
+            return;
+
+        if (numNodes > mUpdatedNodes.size())
+        {
+            // more nodes than expected (not created through the manager), start over
+            mRebuildRequired = true;
+            return;
+        }
+
+        for (size_t i = 0; i < numNodes; ++i)
+            refreshNode(mUpdatedNodes[i]);
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadPhase::_notifyNodeUpdated(SceneNode* node)
+    {
+        if (mInSceneGraphUpdate)
+        {
+            size_t index = mNumUpdatedNodes++;
+            if (index < mUpdatedNodes.size())
+                mUpdatedNodes[index] = node;
+        }
+        else if (!mRebuildRequired)
+        {
+            refreshNode(node);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadPhase::_notifyObjectAttached(MovableObject* obj)
+    {
+        // Visible to all queries until its bounds are known
+        if (!obj->_getBroadPhase() && isTracked(obj))
+            addUnbounded(obj);
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadPhase::_notifyObjectDetached(MovableObject* obj)
+    {
+        if (obj->_getBroadPhase() == this)
+            removeObject(obj);
+    }
+    //-----------------------------------------------------------------------
+    bool SceneQueryBroadPhase::isTracked(MovableObject* obj) const
+    {
+        if (obj->_getManager() != mOwner)
+            return false;
+
+        // The queries only report objects of the manager's collections
+        const String& name = obj->getName();
+        const String& type = obj->getMovableType();
+        return mOwner->hasMovableObject(name, type) && mOwner->getMovableObject(name, type) == obj;
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadPhase::refreshNode(SceneNode* node)
+    {
+        const SceneNode::ObjectMap& objects = node->getAttachedObjects();
+        for (SceneNode::ObjectMap::const_iterator i = objects.begin(); i != objects.end(); ++i)
+        {
+            MovableObject* obj = *i;
+            if (obj->_getBroadPhase() == this || isTracked(obj))
+                refreshObject(obj);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadPhase::refreshObject(MovableObject* obj)
+    {
+        bool registered = obj->_getBroadPhase() == this;
+        uint32 proxy = obj->_getBroadPhaseProxy();
+
+        // Cover both the box tests and the sphere test of the queries
+        const AxisAlignedBox& worldBox = obj->getWorldBoundingBox();
+        Real radius = obj->getBoundingRadius();
+        bool bounded = !obj->isParentTagPoint() && !worldBox.isInfinite() &&
+            radius < std::numeric_limits<Real>::max();
+
+        if (!bounded)
+        {
+            if (registered && (proxy & UNBOUNDED_PROXY))
+                return;
+            if (registered)
+            {
+                mTree.destroyProxy(proxy);
+                invalidatePairs(proxy);
+            }
+            addUnbounded(obj);
+            return;
+        }
+
+        AxisAlignedBox box(worldBox);
+        const Vector3& centre = obj->getParentNode()->_getDerivedPosition();
+        box.merge(AxisAlignedBox(centre - radius, centre + radius));
+
+        if (registered && !(proxy & UNBOUNDED_PROXY))
+        {
+            if (mTree.moveProxy(proxy, box))
+                invalidatePairs(proxy);
+            return;
+        }
+
+        if (registered)
+            removeObject(obj);
+        proxy = mTree.createProxy(box, obj);
+        obj->_notifyBroadPhaseProxy(this, proxy);
+        invalidatePairs(proxy);
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadPhase::addUnbounded(MovableObject* obj)
+    {
+        obj->_notifyBroadPhaseProxy(this, UNBOUNDED_PROXY | static_cast<uint32>(mUnbounded.size()));
+        mUnbounded.push_back(obj);
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadPhase::removeObject(MovableObject* obj)
+    {
+        uint32 proxy = obj->_getBroadPhaseProxy();
+        if (proxy & UNBOUNDED_PROXY)
+        {
+            // swap with the last entry
+            MovableObject* last = mUnbounded.back();
+            mUnbounded[proxy & ~UNBOUNDED_PROXY] = last;
+            last->_notifyBroadPhaseProxy(this, proxy);
+            mUnbounded.pop_back();
+        }
+        else
+        {
+            mTree.destroyProxy(proxy);
+            invalidatePairs(proxy);
+        }
+        obj->_notifyBroadPhaseProxy(0, 0);
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadPhase::rebuild()
+    {
+        ResetVisitor visitor;
+        traverse(visitor);
+        mTree.clear();
+        mUnbounded.clear();
+        mPairs.clear();
+        mInvalidProxies.clear();
+        mPairsValid = false;
+        mRebuildRequired = false;
+
+        Root::MovableObjectFactoryIterator factIt =
+            Root::getSingleton().getMovableObjectFactoryIterator();
+        while (factIt.hasMoreElements())
+        {
+            SceneManager::MovableObjectIterator objIt =
+                mOwner->getMovableObjectIterator(factIt.getNext()->getType());
+            while (objIt.hasMoreElements())
+            {
+                MovableObject* obj = objIt.getNext();
+                if (obj->isAttached())
+                    refreshObject(obj);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadPhase::invalidatePairs(uint32 proxy)
+    {
+        if (!mPairsValid)
+            return;
+
+        mInvalidProxies.push_back(proxy);
+        // most of the scene changed, cheaper to start over
+        if (mInvalidProxies.size() > std::max<size_t>(64, mTree.getNumProxies()))
+        {
+            mPairs.clear();
+            mInvalidProxies.clear();
+            mPairsValid = false;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void SceneQueryBroadPhase::updatePairs()
+    {
+        update();
+
+        if (!mPairsValid)
+        {
+            ProxyCollector collector = {mInvalidProxies};
+            mTree.traverse(collector);
+            mPairsValid = true;
+        }
+        if (mInvalidProxies.empty())
+            return;
+
+        std::sort(mInvalidProxies.begin(), mInvalidProxies.end());
+        mInvalidProxies.erase(std::unique(mInvalidProxies.begin(), mInvalidProxies.end()), mInvalidProxies.end());
+
+        PairInvalidated<ProxyPair> invalidated = {mInvalidProxies};
+        mPairs.erase(std::remove_if(mPairs.begin(), mPairs.end(), invalidated), mPairs.end());
+
+        for (ProxyList::const_iterator i = mInvalidProxies.begin(); i != mInvalidProxies.end(); ++i)
+        {
+            // removed since
+            if (!mTree.isProxy(*i))
+                continue;
+
+            PairCollector<ProxyPair> collector = {mTree.getFatBox(*i), *i,
+                static_cast<MovableObject*>(mTree.getUserData(*i)), mInvalidProxies, mPairs};
+            mTree.traverse(collector);
+        }
+        mInvalidProxies.clear();
+    }
+}
@@ -594,7 +594,7 @@ namespace Ogre
                 return retval;
             }
 
-            nodes = ScriptParser::parse(ScriptLexer::tokenize(stream->getAsString(), name));
+            nodes = ScriptParser::parse(ScriptLexer::tokenize(stream, name));
         }
 
         if(nodes)
@@ -1691,7 +1691,8 @@ namespace Ogre
                     OGRE_LOCK_AUTO_MUTEX;
             OGRE_THREAD_POINTER_GET(mScriptCompiler)->setListener(mListener);
         }
-        OGRE_THREAD_POINTER_GET(mScriptCompiler)->compile(stream->getAsString(), stream->getName(), groupName);
+        ConcreteNodeListPtr nodes = ScriptParser::parse(ScriptLexer::tokenize(stream, stream->getName()));
+        OGRE_THREAD_POINTER_GET(mScriptCompiler)->compile(nodes, groupName);
     }
 
     //-------------------------------------------------------------------------
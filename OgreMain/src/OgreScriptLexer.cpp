@@ -30,6 +30,25 @@ THE SOFTWARE.
 
 namespace Ogre{
     ScriptTokenListPtr ScriptLexer::tokenize(const String &str, const String &source)
+    {
+        return tokenize(str.data(), str.data() + str.size(), source);
+    }
+
+    ScriptTokenListPtr ScriptLexer::tokenize(const DataStreamPtr &stream, const String &source)
+    {
+        // a memory stream (e.g. a mapped file) is lexed in place from the current
+        // position, and consumed like a read would
+        if (MemoryDataStream *memStream = dynamic_cast<MemoryDataStream*>(stream.get()))
+        {
+            const char *data = reinterpret_cast<const char*>(memStream->getCurrentPtr());
+            size_t size = memStream->size() - memStream->tell();
+            memStream->skip(static_cast<long>(size));
+            return tokenize(data, data + size, source);
+        }
+        return tokenize(stream->getAsString(), source);
+    }
+
+    ScriptTokenListPtr ScriptLexer::tokenize(const char *begin, const char *end, const String &source)
     {
         // State enums
         enum{ READY = 0, COMMENT, MULTICOMMENT, WORD, QUOTE, VAR, POSSIBLECOMMENT };
@@ -43,7 +62,7 @@ namespace Ogre{
         ScriptTokenListPtr tokens(OGRE_NEW_T(ScriptTokenList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
 
         // Iterate over the input
-        String::const_iterator i = str.begin(), end = str.end();
+        const char *i = begin;
         while(i != end)
         {
             lastc = c;
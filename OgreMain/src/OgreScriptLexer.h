@@ -74,6 +74,10 @@ namespace Ogre {
     public:
         /** Tokenizes the given input and returns the list of tokens found */
         static ScriptTokenListPtr tokenize(const String &str, const String &source);
+        /** Tokenizes the characters in [begin, end) and returns the list of tokens found */
+        static ScriptTokenListPtr tokenize(const char *begin, const char *end, const String &source);
+        /** Tokenizes the whole stream, in place if it is a MemoryDataStream */
+        static ScriptTokenListPtr tokenize(const DataStreamPtr &stream, const String &source);
     private: // Private utility operations
         static void setToken(const String &lexeme, uint32 line, const String &source, ScriptTokenList *tokens);
         static bool isWhitespace(Ogre::String::value_type c);
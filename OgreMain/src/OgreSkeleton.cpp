@@ -32,6 +32,7 @@ THE SOFTWARE.
 // Just for logging
 #include "OgreAnimationTrack.h"
 #include "OgreKeyFrame.h"
+#include "OgreBonePoseBuffer.h"
 
 
 namespace Ogre {
@@ -41,14 +42,17 @@ namespace Ogre {
         : Resource(),
         mBlendState(ANIMBLEND_AVERAGE),
         mNextAutoHandle(0),
-        mManualBonesDirty(false)
+        mManualBonesDirty(false),
+        mPoseBuffer(0),
+        mBatchedBlending(false)
     {
     }
     //---------------------------------------------------------------------
     Skeleton::Skeleton(ResourceManager* creator, const String& name, ResourceHandle handle,
         const String& group, bool isManual, ManualResourceLoader* loader) 
         : Resource(creator, name, handle, group, isManual, loader), 
-        mBlendState(ANIMBLEND_AVERAGE), mNextAutoHandle(0)
+        mBlendState(ANIMBLEND_AVERAGE), mNextAutoHandle(0), mPoseBuffer(0),
+        mBatchedBlending(false)
         // set animation blending to weighted, not cumulative
     {
         if (createParamDictionary("Skeleton"))
@@ -62,6 +66,7 @@ namespace Ogre {
         // have to call this here reather than in Resource destructor
         // since calling virtual methods in base destructors causes crash
         unload(); 
+        OGRE_DELETE mPoseBuffer;
     }
     //---------------------------------------------------------------------
     void Skeleton::loadImpl(void)
@@ -99,6 +104,8 @@ namespace Ogre {
         mBoneList.clear();
         mBoneListByName.clear();
         mRootBones.clear();
+        OGRE_DELETE mPoseBuffer;
+        mPoseBuffer = 0;
         mManualBones.clear();
         mManualBonesDirty = false;
 
@@ -203,9 +210,6 @@ namespace Ogre {
           2. Iterate per AnimationState, if enabled get Animation and call Animation::apply
         */
 
-        // Reset bones
-        reset();
-
         Real weightFactor = 1.0f;
         if (mBlendState == ANIMBLEND_AVERAGE)
         {
@@ -230,6 +234,15 @@ namespace Ogre {
             }
         }
 
+        if (mBatchedBlending)
+        {
+            blendAnimationStates(animSet, weightFactor);
+            return;
+        }
+
+        // Reset bones
+        reset();
+
         // Per enabled animation state
         EnabledAnimationStateList::const_iterator animIt;
         for(animIt = animSet.getEnabledAnimationStates().begin(); animIt != animSet.getEnabledAnimationStates().end(); ++animIt)
@@ -254,6 +267,61 @@ namespace Ogre {
         }
 
 
+    }
+    //---------------------------------------------------------------------
+    void Skeleton::blendAnimationStates(const AnimationStateSet& animSet, Real weightFactor)
+    {
+        size_t numBones = mBoneList.size();
+        if (numBones == 0)
+            return;
+
+        BlendPose& pose = mBlendPose;
+        pose.positions.resize(numBones);
+        pose.orientations.resize(numBones);
+        pose.scales.resize(numBones);
+        pose.modified.resize(numBones);
+
+        // Start from the state reset() would leave the bones in, every bone it
+        // resets is written back
+        for (size_t i = 0; i < numBones; ++i)
+        {
+            Bone* bone = mBoneList[i];
+            if (bone->isManuallyControlled())
+            {
+                pose.positions[i] = bone->getPosition();
+                pose.orientations[i] = bone->getOrientation();
+                pose.scales[i] = bone->getScale();
+                pose.modified[i] = 0;
+            }
+            else
+            {
+                pose.positions[i] = bone->getInitialPosition();
+                pose.orientations[i] = bone->getInitialOrientation();
+                pose.scales[i] = bone->getInitialScale();
+                pose.modified[i] = 1;
+            }
+        }
+
+        EnabledAnimationStateList::const_iterator animIt;
+        for(animIt = animSet.getEnabledAnimationStates().begin(); animIt != animSet.getEnabledAnimationStates().end(); ++animIt)
+        {
+            const AnimationState* animState = *animIt;
+            const LinkedSkeletonAnimationSource* linked = 0;
+            Animation* anim = _getAnimationImpl(animState->getAnimationName(), &linked);
+            // tolerate state entries for animations we're not aware of
+            if (anim)
+            {
+                anim->_blendToPose(animState->getTimePosition(), animState->getWeight() * weightFactor,
+                    animState->hasBlendMask() ? animState->getBlendMask() : 0, linked ? linked->scale : 1.0f,
+                    &pose.positions[0], &pose.orientations[0], &pose.scales[0], &pose.modified[0]);
+            }
+        }
+
+        for (size_t i = 0; i < numBones; ++i)
+        {
+            if (pose.modified[i])
+                mBoneList[i]->_setLocalTransform(pose.positions[i], pose.orientations[i], pose.scales[i]);
+        }
     }
     //---------------------------------------------------------------------
     void Skeleton::setBindingPose(void)
@@ -456,6 +524,12 @@ namespace Ogre {
         // Update derived transforms
         _updateTransforms();
 
+        if (mPoseBuffer && mPoseBuffer->isValid())
+        {
+            mPoseBuffer->getOffsetTransforms(pMatrices);
+            return;
+        }
+
         /*
             Calculating the bone matrices
             -----------------------------
@@ -586,11 +660,21 @@ namespace Ogre {
                 NodeAnimationTrack* track = anim->getNodeTrack(ti);
                 of << "  -- AnimationTrack " << ti << " --" << std::endl;
                 of << "  Affects bone: " << static_cast<Bone*>(track->getAssociatedNode())->getHandle() << std::endl;
-                of << "  Number of keyframes: " << track->getNumKeyFrames() << std::endl;
-
-                for (unsigned short ki = 0; ki < track->getNumKeyFrames(); ++ki)
+                const CompressedTransformKeys* compressedKeys = track->getCompressedKeys();
+                size_t numKeys = compressedKeys ? compressedKeys->getNumKeys() : track->getNumKeyFrames();
+                of << "  Number of keyframes: " << numKeys;
+                if (compressedKeys)
+                    of << " (compressed)";
+                of << std::endl;
+
+                for (unsigned short ki = 0; ki < numKeys; ++ki)
                 {
-                    TransformKeyFrame* key = track->getNodeKeyFrame(ki);
+                    TransformKeyFrame compressedKey(track, compressedKeys ? compressedKeys->getKeyTime(ki) : 0);
+                    TransformKeyFrame* key = &compressedKey;
+                    if (compressedKeys)
+                        compressedKeys->getKey(ki, key);
+                    else
+                        key = track->getNodeKeyFrame(ki);
                     of << "    -- KeyFrame " << ki << " --" << std::endl;
                     of << "    Time index: " << key->getTime(); 
                     of << "    Translation: " << key->getTranslate() << std::endl;
@@ -634,11 +718,20 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void Skeleton::_updateTransforms(void)
     {
-        BoneList::iterator i, iend;
-        iend = mRootBones.end();
-        for (i = mRootBones.begin(); i != iend; ++i)
+        bool updated = false;
+#if !OGRE_NODE_INHERIT_TRANSFORM
+        if (!mPoseBuffer)
+            mPoseBuffer = OGRE_NEW BonePoseBuffer();
+        updated = mPoseBuffer->update(mBoneList);
+#endif
+        if (!updated)
         {
-            (*i)->_update(true, false);
+            BoneList::iterator i, iend;
+            iend = mRootBones.end();
+            for (i = mRootBones.begin(); i != iend; ++i)
+            {
+                (*i)->_update(true, false);
+            }
         }
         mManualBonesDirty = false;
     }
@@ -942,10 +1035,17 @@ namespace Ogre {
                     NodeAnimationTrack* dstTrack = dstAnimation->createNodeTrack(dstHandle, this->getBone(dstHandle));
                     dstTrack->setUseShortestRotationPath(srcTrack->getUseShortestRotationPath());
 
-                    ushort numKeyFrames = srcTrack->getNumKeyFrames();
+                    // Compressed source tracks are merged as keyframes
+                    const CompressedTransformKeys* srcKeys = srcTrack->getCompressedKeys();
+                    size_t numKeyFrames = srcKeys ? srcKeys->getNumKeys() : srcTrack->getNumKeyFrames();
                     for (ushort k = 0; k < numKeyFrames; ++k)
                     {
-                        const TransformKeyFrame* srcKeyFrame = srcTrack->getNodeKeyFrame(k);
+                        TransformKeyFrame srcKey(srcTrack, srcKeys ? srcKeys->getKeyTime(k) : 0);
+                        const TransformKeyFrame* srcKeyFrame = &srcKey;
+                        if (srcKeys)
+                            srcKeys->getKey(k, &srcKey);
+                        else
+                            srcKeyFrame = srcTrack->getNodeKeyFrame(k);
                         TransformKeyFrame* dstKeyFrame = dstTrack->createNodeKeyFrame(srcKeyFrame->getTime());
 
                         // Adjust keyframes to match target binding pose
@@ -124,7 +124,8 @@ namespace Ogre {
         // Read version
         String ver = readString(stream);
         if ((ver != "[Serializer_v1.10]") &&
-            (ver != "[Serializer_v1.80]"))
+            (ver != "[Serializer_v1.80]") &&
+            (ver != "[Serializer_v1.110]"))
         {
             OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
                 "Invalid file: version incompatible, file reports " + String(ver),
@@ -176,7 +177,9 @@ namespace Ogre {
     {
         if (ver == SKELETON_VERSION_1_0)
             mVersion = "[Serializer_v1.10]";
-        else mVersion = "[Serializer_v1.80]";
+        else if (ver == SKELETON_VERSION_1_8)
+            mVersion = "[Serializer_v1.80]";
+        else mVersion = "[Serializer_v1.110]";
     }
     //---------------------------------------------------------------------
     void SkeletonSerializer::writeSkeleton(const Skeleton* pSkel, SkeletonVersion ver)
@@ -284,7 +287,7 @@ namespace Ogre {
         Animation::NodeTrackIterator trackIt = anim->getNodeTrackIterator();
         while(trackIt.hasMoreElements())
         {
-            writeAnimationTrack(pSkel, trackIt.getNext());
+            writeAnimationTrack(pSkel, trackIt.getNext(), ver);
         }
         }
         popInnerChunk(mStream);
@@ -292,19 +295,37 @@ namespace Ogre {
     }
     //---------------------------------------------------------------------
     void SkeletonSerializer::writeAnimationTrack(const Skeleton* pSkel, 
-        const NodeAnimationTrack* track)
+        const NodeAnimationTrack* track, SkeletonVersion ver)
     {
-        writeChunkHeader(SKELETON_ANIMATION_TRACK, calcAnimationTrackSize(pSkel, track));
+        writeChunkHeader(SKELETON_ANIMATION_TRACK, calcAnimationTrackSize(pSkel, track, ver));
 
         // unsigned short boneIndex     : Index of bone to apply to
         Bone* bone = static_cast<Bone*>(track->getAssociatedNode());
         unsigned short boneid = bone->getHandle();
         writeShorts(&boneid, 1);
         pushInnerChunk(mStream);
-        // Write all keyframes
-        for (unsigned short i = 0; i < track->getNumKeyFrames(); ++i)
+        const CompressedTransformKeys* keys = track->getCompressedKeys();
+        if (keys && (int)ver > (int)SKELETON_VERSION_1_8)
         {
-            writeKeyFrame(pSkel, track->getNodeKeyFrame(i));
+            writeCompressedKeys(pSkel, keys);
+        }
+        else if (keys)
+        {
+            // Older formats get the compressed keys as keyframes
+            for (size_t i = 0; i < keys->getNumKeys(); ++i)
+            {
+                TransformKeyFrame key(track, keys->getKeyTime(i));
+                keys->getKey(i, &key);
+                writeKeyFrame(pSkel, &key);
+            }
+        }
+        else
+        {
+            // Write all keyframes
+            for (unsigned short i = 0; i < track->getNumKeyFrames(); ++i)
+            {
+                writeKeyFrame(pSkel, track->getNodeKeyFrame(i));
+            }
         }
         popInnerChunk(mStream);
     }
@@ -329,6 +350,27 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void SkeletonSerializer::writeCompressedKeys(const Skeleton* pSkel,
+        const CompressedTransformKeys* keys)
+    {
+        writeChunkHeader(SKELETON_ANIMATION_TRACK_COMPRESSED_KEYS, calcCompressedKeysSize(pSkel, keys));
+
+        // unsigned short numKeys           : Number of keys
+        uint16 numKeys = static_cast<uint16>(keys->getNumKeys());
+        writeShorts(&numKeys, 1);
+        // unsigned short constantChannels  : CompressedTransformKeys::ConstantChannel flags
+        uint16 constantChannels = keys->getConstantChannels();
+        writeShorts(&constantChannels, 1);
+        // float times[numKeys]             : The time positions (seconds)
+        writeFloats(keys->_getTimes(), numKeys);
+        // float translate[3 * n]           : Translations
+        writeFloats(keys->_getTranslations(), keys->getNumTranslations() * 3);
+        // unsigned short rotate[3 * n]     : Packed rotations
+        writeShorts(keys->_getRotations(), keys->getNumRotations() * 3);
+        // float scale[3 * n]               : Scales
+        writeFloats(keys->_getScales(), keys->getNumScales() * 3);
+    }
+    //---------------------------------------------------------------------
     size_t SkeletonSerializer::calcBoneSize(const Skeleton* pSkel, 
         const Bone* pBone)
     {
@@ -402,24 +444,41 @@ namespace Ogre {
         Animation::NodeTrackIterator trackIt = pAnim->getNodeTrackIterator();
         while(trackIt.hasMoreElements())
         {
-            size += calcAnimationTrackSize(pSkel, trackIt.getNext());
+            size += calcAnimationTrackSize(pSkel, trackIt.getNext(), ver);
         }
 
         return size;
     }
     //---------------------------------------------------------------------
     size_t SkeletonSerializer::calcAnimationTrackSize(const Skeleton* pSkel, 
-        const NodeAnimationTrack* pTrack)
+        const NodeAnimationTrack* pTrack, SkeletonVersion ver)
     {
         size_t size = SSTREAM_OVERHEAD_SIZE;
 
         // unsigned short boneIndex     : Index of bone to apply to
         size += sizeof(unsigned short);
 
-        // Nested keyframes
-        for (unsigned short i = 0; i < pTrack->getNumKeyFrames(); ++i)
+        const CompressedTransformKeys* keys = pTrack->getCompressedKeys();
+        if (keys && (int)ver > (int)SKELETON_VERSION_1_8)
+        {
+            size += calcCompressedKeysSize(pSkel, keys);
+        }
+        else if (keys)
         {
-            size += calcKeyFrameSize(pSkel, pTrack->getNodeKeyFrame(i));
+            for (size_t i = 0; i < keys->getNumKeys(); ++i)
+            {
+                TransformKeyFrame key(pTrack, keys->getKeyTime(i));
+                keys->getKey(i, &key);
+                size += calcKeyFrameSize(pSkel, &key);
+            }
+        }
+        else
+        {
+            // Nested keyframes
+            for (unsigned short i = 0; i < pTrack->getNumKeyFrames(); ++i)
+            {
+                size += calcKeyFrameSize(pSkel, pTrack->getNodeKeyFrame(i));
+            }
         }
 
         return size;
@@ -454,6 +513,25 @@ namespace Ogre {
         return size;
     }
     //---------------------------------------------------------------------
+    size_t SkeletonSerializer::calcCompressedKeysSize(const Skeleton* pSkel,
+        const CompressedTransformKeys* keys)
+    {
+        size_t size = SSTREAM_OVERHEAD_SIZE;
+
+        // unsigned short numKeys, constantChannels
+        size += sizeof(uint16) * 2;
+        // float times[numKeys]
+        size += sizeof(float) * keys->getNumKeys();
+        // float translate[3 * n]
+        size += sizeof(float) * 3 * keys->getNumTranslations();
+        // unsigned short rotate[3 * n]
+        size += sizeof(uint16) * 3 * keys->getNumRotations();
+        // float scale[3 * n]
+        size += sizeof(float) * 3 * keys->getNumScales();
+
+        return size;
+    }
+    //---------------------------------------------------------------------
     void SkeletonSerializer::readBone(DataStreamPtr& stream, Skeleton* pSkel)
     {
         // char* name
@@ -580,9 +658,13 @@ namespace Ogre {
         {
             pushInnerChunk(stream);
             unsigned short streamID = readChunk(stream);
-            while(streamID == SKELETON_ANIMATION_TRACK_KEYFRAME && !stream->eof())
+            while((streamID == SKELETON_ANIMATION_TRACK_KEYFRAME ||
+                   streamID == SKELETON_ANIMATION_TRACK_COMPRESSED_KEYS) && !stream->eof())
             {
-                readKeyFrame(stream, pTrack, pSkel);
+                if (streamID == SKELETON_ANIMATION_TRACK_KEYFRAME)
+                    readKeyFrame(stream, pTrack, pSkel);
+                else
+                    readCompressedKeys(stream, pTrack, pSkel);
 
                 if (!stream->eof())
                 {
@@ -627,6 +709,37 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void SkeletonSerializer::readCompressedKeys(DataStreamPtr& stream, NodeAnimationTrack* track,
+        Skeleton* pSkel)
+    {
+        // unsigned short numKeys           : Number of keys
+        uint16 numKeys;
+        readShorts(stream, &numKeys, 1);
+        // unsigned short constantChannels  : CompressedTransformKeys::ConstantChannel flags
+        uint16 constantChannels;
+        readShorts(stream, &constantChannels, 1);
+
+        if (numKeys == 0)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Compressed track without keys in " + stream->getName(),
+                "SkeletonSerializer::readCompressedKeys");
+        }
+
+        CompressedTransformKeys* keys = OGRE_NEW CompressedTransformKeys();
+        keys->_resize(numKeys, constantChannels);
+        // float times[numKeys]             : The time positions (seconds)
+        readFloats(stream, keys->_getTimes(), numKeys);
+        // float translate[3 * n]           : Translations
+        readFloats(stream, keys->_getTranslations(), keys->getNumTranslations() * 3);
+        // unsigned short rotate[3 * n]     : Packed rotations
+        readShorts(stream, keys->_getRotations(), keys->getNumRotations() * 3);
+        // float scale[3 * n]               : Scales
+        readFloats(stream, keys->_getScales(), keys->getNumScales() * 3);
+
+        track->_setCompressedKeys(keys);
+    }
+    //---------------------------------------------------------------------
     void SkeletonSerializer::writeSkeletonAnimationLink(const Skeleton* pSkel, 
         const LinkedSkeletonAnimationSource& link)
     {
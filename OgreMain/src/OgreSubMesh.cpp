@@ -36,6 +36,7 @@ namespace Ogre {
         , parent(0)
         , mMatInitialised(false)
         , mBoneAssignmentsOutOfDate(false)
+        , mBoneAssignmentsPacked(false)
         , mVertexAnimationType(VAT_NONE)
         , mVertexAnimationIncludesNormals(false)
         , mBuildEdgesEnabled(true)
@@ -92,6 +93,7 @@ namespace Ogre {
             OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "This SubMesh uses shared geometry,  you "
                 "must assign bones to the Mesh, not the SubMesh", "SubMesh.addBoneAssignment");
         }
+        _unpackBoneAssignments();
         mBoneAssignments.insert(
             VertexBoneAssignmentList::value_type(vertBoneAssign.vertexIndex, vertBoneAssign));
         mBoneAssignmentsOutOfDate = true;
@@ -101,6 +103,27 @@ namespace Ogre {
     {
         mBoneAssignments.clear();
         mBoneAssignmentsOutOfDate = true;
+        mBoneAssignmentsPacked = false;
+    }
+    //-----------------------------------------------------------------------
+    void SubMesh::_unpackBoneAssignments(void) const
+    {
+        if (mBoneAssignmentsPacked)
+        {
+            mBoneAssignmentsPacked = false;
+            if (vertexData)
+            {
+                vector<VertexBoneAssignment>::type assignments;
+                Mesh::decompileBoneAssignments(vertexData, blendIndexToBoneIndexMap, assignments);
+                mBoneAssignments.clear();
+                // Sorted by vertex, so always inserting at the end
+                for (size_t i = 0; i < assignments.size(); ++i)
+                {
+                    mBoneAssignments.insert(mBoneAssignments.end(),
+                        VertexBoneAssignmentList::value_type(assignments[i].vertexIndex, assignments[i]));
+                }
+            }
+        }
     }
 
     //-----------------------------------------------------------------------
@@ -120,6 +143,7 @@ namespace Ogre {
     //---------------------------------------------------------------------
     SubMesh::BoneAssignmentIterator SubMesh::getBoneAssignmentIterator(void)
     {
+        _unpackBoneAssignments();
         return BoneAssignmentIterator(mBoneAssignments.begin(),
             mBoneAssignments.end());
     }
@@ -483,6 +507,7 @@ namespace Ogre {
         // Copy any bone assignments
         newSub->mBoneAssignments = this->mBoneAssignments;
         newSub->mBoneAssignmentsOutOfDate = this->mBoneAssignmentsOutOfDate;
+        newSub->mBoneAssignmentsPacked = this->mBoneAssignmentsPacked;
         // Copy texture aliases
         newSub->mTextureAliases = this->mTextureAliases;
 
@@ -0,0 +1,210 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreThreadPool.h"
+
+namespace Ogre
+{
+    //---------------------------------------------------------------------
+    ThreadPool::ThreadPool(size_t numWorkerThreads)
+        : mNumWorkerThreads(numWorkerThreads)
+        , mBusy(false)
+        , mFunction(0)
+        , mEnd(0)
+        , mGrainSize(1)
+        , mNextChunk(0)
+#if OGRE_THREAD_SUPPORT
+        , mJobGeneration(0)
+        , mActiveWorkers(0)
+        , mShuttingDown(false)
+#endif
+    {
+#if !OGRE_THREAD_SUPPORT
+        mNumWorkerThreads = 0;
+#endif
+    }
+    //---------------------------------------------------------------------
+    ThreadPool::~ThreadPool()
+    {
+        shutdown();
+    }
+    //---------------------------------------------------------------------
+    void ThreadPool::setNumWorkerThreads(size_t numWorkerThreads)
+    {
+        OgreAssert(!mBusy, "cannot resize the pool while a job is in flight");
+        shutdown();
+#if OGRE_THREAD_SUPPORT
+        mNumWorkerThreads = numWorkerThreads;
+#endif
+    }
+    //---------------------------------------------------------------------
+    void ThreadPool::startWorkers()
+    {
+#if OGRE_THREAD_SUPPORT
+        mShuttingDown = false;
+        mActiveWorkers = 0;
+        for (size_t i = 0; i < mNumWorkerThreads; ++i)
+        {
+            OGRE_THREAD_CREATE(t, WorkerFunc(this, i + 1));
+            mWorkers.push_back(t);
+        }
+#endif
+    }
+    //---------------------------------------------------------------------
+    void ThreadPool::shutdown()
+    {
+#if OGRE_THREAD_SUPPORT
+        if (mWorkers.empty())
+            return;
+
+        {
+            OGRE_WQ_LOCK_MUTEX(mJobMutex);
+            mShuttingDown = true;
+        }
+        OGRE_THREAD_NOTIFY_ALL(mJobCondition);
+
+        for (WorkerThreadList::iterator i = mWorkers.begin(); i != mWorkers.end(); ++i)
+        {
+            (*i)->join();
+            OGRE_THREAD_DESTROY(*i);
+        }
+        mWorkers.clear();
+#endif
+    }
+    //---------------------------------------------------------------------
+    void ThreadPool::runChunks(size_t threadIdx)
+    {
+        size_t begin;
+        while ((begin = mNextChunk.fetch_add(mGrainSize)) < mEnd)
+        {
+            (*mFunction)(begin, std::min(begin + mGrainSize, mEnd), threadIdx);
+        }
+    }
+    //---------------------------------------------------------------------
+    void ThreadPool::_threadMain(size_t threadIdx)
+    {
+#if OGRE_THREAD_SUPPORT
+        uint32 seenGeneration = 0;
+        OGRE_WQ_LOCK_MUTEX_NAMED(mJobMutex, jobLock);
+        while (true)
+        {
+            while (!mShuttingDown && seenGeneration == mJobGeneration)
+                OGRE_THREAD_WAIT(mJobCondition, mJobMutex, jobLock);
+
+            if (mShuttingDown)
+                break;
+
+            seenGeneration = mJobGeneration;
+            jobLock.unlock();
+
+            try
+            {
+                runChunks(threadIdx);
+            }
+            catch (...)
+            {
+                // skip the remaining chunks and let the caller rethrow
+                mNextChunk = mEnd;
+                OGRE_WQ_LOCK_MUTEX(mJobMutex);
+                if (!mException)
+                    mException = std::current_exception();
+            }
+
+            jobLock.lock();
+            if (--mActiveWorkers == 0)
+                OGRE_THREAD_NOTIFY_ALL(mDoneCondition);
+        }
+#endif
+    }
+    //---------------------------------------------------------------------
+    void ThreadPool::parallelFor(size_t begin, size_t end, size_t grainSize,
+                                 const RangeFunction& func)
+    {
+        if (begin >= end)
+            return;
+
+        grainSize = std::max<size_t>(grainSize, 1);
+
+        bool expected = false;
+        if (mNumWorkerThreads == 0 || end - begin <= grainSize ||
+            !mBusy.compare_exchange_strong(expected, true))
+        {
+            // nothing to split, or a job is already in flight
+            func(begin, end, 0);
+            return;
+        }
+
+        mFunction = &func;
+        mEnd = end;
+        mGrainSize = grainSize;
+        mNextChunk = begin;
+        mException = nullptr;
+
+#if OGRE_THREAD_SUPPORT
+        if (mWorkers.empty())
+            startWorkers();
+
+        {
+            OGRE_WQ_LOCK_MUTEX(mJobMutex);
+            mActiveWorkers = mWorkers.size();
+            ++mJobGeneration;
+        }
+        OGRE_THREAD_NOTIFY_ALL(mJobCondition);
+#endif
+
+        try
+        {
+            runChunks(0);
+        }
+        catch (...)
+        {
+            mNextChunk = mEnd;
+#if OGRE_THREAD_SUPPORT
+            OGRE_WQ_LOCK_MUTEX(mJobMutex);
+#endif
+            if (!mException)
+                mException = std::current_exception();
+        }
+
+#if OGRE_THREAD_SUPPORT
+        {
+            OGRE_WQ_LOCK_MUTEX_NAMED(mJobMutex, jobLock);
+            while (mActiveWorkers > 0)
+                OGRE_THREAD_WAIT(mDoneCondition, mJobMutex, jobLock);
+        }
+#endif
+
+        mFunction = 0;
+        std::exception_ptr ex = mException;
+        mException = nullptr;
+        mBusy = false;
+
+        if (ex)
+            std::rethrow_exception(ex);
+    }
+}
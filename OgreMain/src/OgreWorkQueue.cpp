@@ -43,8 +43,10 @@ namespace Ogre {
         return i->second;
     }
     //---------------------------------------------------------------------
-    WorkQueue::Request::Request(uint16 channel, uint16 rtype, const Any& rData, uint8 retry, RequestID rid)
+    WorkQueue::Request::Request(uint16 channel, uint16 rtype, const Any& rData, uint8 retry, RequestID rid,
+        Real priority, unsigned long deadline)
         : mChannel(channel), mType(rtype), mData(rData), mRetryCount(retry), mID(rid), mAborted(false)
+        , mPriority(priority), mDeadline(deadline)
     {
 
     }
@@ -125,6 +127,28 @@ namespace Ogre {
         mResponseQueue.clear();
     }
     //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::pushRequest(RequestQueue& q, Request* r)
+    {
+        q.push_back(r);
+        std::push_heap(q.begin(), q.end(), RequestPriorityLess());
+    }
+    //---------------------------------------------------------------------
+    WorkQueue::Request* DefaultWorkQueueBase::popRequest(RequestQueue& q)
+    {
+        std::pop_heap(q.begin(), q.end(), RequestPriorityLess());
+        Request* r = q.back();
+        q.pop_back();
+        return r;
+    }
+    //---------------------------------------------------------------------
+    unsigned long DefaultWorkQueueBase::calculateDeadline(unsigned long deadlineMS)
+    {
+        if (!deadlineMS)
+            return 0;
+        // never 0, that means no deadline
+        return std::max(Root::getSingleton().getTimer()->getMilliseconds() + deadlineMS, 1ul);
+    }
+    //---------------------------------------------------------------------
     void DefaultWorkQueueBase::addRequestHandler(uint16 channel, RequestHandler* rh)
     {
             OGRE_WQ_LOCK_RW_MUTEX_WRITE(mRequestHandlerMutex);
@@ -198,7 +222,8 @@ namespace Ogre {
     }
     //---------------------------------------------------------------------
     WorkQueue::RequestID DefaultWorkQueueBase::addRequest(uint16 channel, uint16 requestType, 
-        const Any& rData, uint8 retryCount, bool forceSynchronous, bool idleThread)
+        const Any& rData, uint8 retryCount, bool forceSynchronous, bool idleThread, Real priority,
+        unsigned long deadlineMS)
     {
         Request* req = 0;
         RequestID rid = 0;
@@ -211,17 +236,18 @@ namespace Ogre {
                 return 0;
 
             rid = ++mRequestCount;
-            req = OGRE_NEW Request(channel, requestType, rData, retryCount, rid);
+            req = OGRE_NEW Request(channel, requestType, rData, retryCount, rid, priority,
+                calculateDeadline(deadlineMS));
 
             LogManager::getSingleton().stream(LML_TRIVIAL) << 
                 "DefaultWorkQueueBase('" << mName << "') - QUEUED(thread:" <<
                 OGRE_THREAD_CURRENT_ID
                 << "): ID=" << rid
-                << " channel=" << channel << " requestType=" << requestType;
+                << " channel=" << channel << " requestType=" << requestType << " priority=" << priority;
 #if OGRE_THREAD_SUPPORT
             if (!forceSynchronous&& !idleThread)
             {
-                mRequestQueue.push_back(req);
+                pushRequest(mRequestQueue, req);
                 notifyWorkers();
                 return rid;
             }
@@ -229,7 +255,7 @@ namespace Ogre {
         }
         if(OGRE_THREAD_SUPPORT && idleThread){
             OGRE_WQ_LOCK_MUTEX(mIdleMutex);
-            mIdleRequestQueue.push_back(req);
+            pushRequest(mIdleRequestQueue, req);
             if(!mIdleThreadRunning)
             {
                 notifyWorkers();
@@ -242,7 +268,7 @@ namespace Ogre {
     }
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::addRequestWithRID(WorkQueue::RequestID rid, uint16 channel, 
-        uint16 requestType, const Any& rData, uint8 retryCount)
+        uint16 requestType, const Any& rData, uint8 retryCount, Real priority, unsigned long deadline)
     {
         // lock to push request to the queue
             OGRE_WQ_LOCK_MUTEX(mRequestMutex);
@@ -250,7 +276,7 @@ namespace Ogre {
         if (mShuttingDown)
             return;
 
-        Request* req = OGRE_NEW Request(channel, requestType, rData, retryCount, rid);
+        Request* req = OGRE_NEW Request(channel, requestType, rData, retryCount, rid, priority, deadline);
 
         LogManager::getSingleton().stream(LML_TRIVIAL) << 
             "DefaultWorkQueueBase('" << mName << "') - REQUEUED(thread:" <<
@@ -258,13 +284,41 @@ namespace Ogre {
             << "): ID=" << rid
                    << " channel=" << channel << " requestType=" << requestType;
 #if OGRE_THREAD_SUPPORT
-        mRequestQueue.push_back(req);
+        pushRequest(mRequestQueue, req);
         notifyWorkers();
 #else
         processRequestResponse(req, true);
 #endif
     }
     //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::setRequestPriority(RequestID id, Real priority)
+    {
+        {
+            OGRE_WQ_LOCK_MUTEX(mRequestMutex);
+            for (RequestQueue::iterator i = mRequestQueue.begin(); i != mRequestQueue.end(); ++i)
+            {
+                if ((*i)->getID() == id)
+                {
+                    (*i)->_setPriority(priority);
+                    std::make_heap(mRequestQueue.begin(), mRequestQueue.end(), RequestPriorityLess());
+                    return;
+                }
+            }
+        }
+        {
+            OGRE_WQ_LOCK_MUTEX(mIdleMutex);
+            for (RequestQueue::iterator i = mIdleRequestQueue.begin(); i != mIdleRequestQueue.end(); ++i)
+            {
+                if ((*i)->getID() == id)
+                {
+                    (*i)->_setPriority(priority);
+                    std::make_heap(mIdleRequestQueue.begin(), mIdleRequestQueue.end(), RequestPriorityLess());
+                    return;
+                }
+            }
+        }
+    }
+    //---------------------------------------------------------------------
     void DefaultWorkQueueBase::abortRequest(RequestID id)
     {
             OGRE_WQ_LOCK_MUTEX(mProcessMutex);
@@ -513,8 +567,7 @@ namespace Ogre {
 
                 if (!mRequestQueue.empty())
                 {
-                    request = mRequestQueue.front();
-                    mRequestQueue.pop_front();
+                    request = popRequest(mRequestQueue);
                     mProcessQueue.push_back( request );
                 }
             }
@@ -522,6 +575,12 @@ namespace Ogre {
 
         if (request)
         {
+            if (request->getDeadline() &&
+                request->isExpired(Root::getSingleton().getTimer()->getMilliseconds()))
+            {
+                // dropped like an aborted request, no response is sent
+                request->abortRequest();
+            }
             processRequestResponse(request, false);
         }
 
@@ -556,7 +615,7 @@ namespace Ogre {
                 if (req->getRetryCount())
                 {
                     addRequestWithRID(req->getID(), req->getChannel(), req->getType(), req->getData(), 
-                        req->getRetryCount() - 1);
+                        req->getRetryCount() - 1, req->getPriority(), req->getDeadline());
                     // discard response (this also deletes request)
                     OGRE_DELETE response;
                     return;
@@ -725,8 +784,12 @@ namespace Ogre {
                     {
                                             OGRE_WQ_LOCK_MUTEX(mIdleMutex);
                         if(!mIdleRequestQueue.empty()){
-                            mIdleProcessed = mIdleRequestQueue.front();
-                            mIdleRequestQueue.pop_front();
+                            mIdleProcessed = popRequest(mIdleRequestQueue);
+                            if (mIdleProcessed->getDeadline() &&
+                                mIdleProcessed->isExpired(Root::getSingleton().getTimer()->getMilliseconds()))
+                            {
+                                mIdleProcessed->abortRequest();
+                            }
                         } else {
                             mIdleProcessed = 0;
                             mIdleThreadRunning = false;
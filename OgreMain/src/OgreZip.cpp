@@ -28,31 +28,123 @@ THE SOFTWARE.
 #include "OgreStableHeaders.h"
 
 #if OGRE_NO_ZIP_ARCHIVE == 0
-// workaround for Wundef in zzip/conf.h
-#ifndef __GNUC_MINOR_
-#define __GNUC_MINOR_ 0
-#endif
+#include <zlib.h>
+#include <sys/stat.h>
 
-#include <zzip/zzip.h>
-#include <zzip/plugin.h>
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32 || OGRE_PLATFORM == OGRE_PLATFORM_WINRT
+#  define WIN32_LEAN_AND_MEAN
+#  if !defined(NOMINMAX) && defined(_MSC_VER)
+#   define NOMINMAX // required to stop windows.h messing up std::min
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <errno.h>
+#endif
 
 namespace Ogre {
+    //-----------------------------------------------------------------------
+    //  ZipArchive
+    //-----------------------------------------------------------------------
 namespace {
+    typedef EmbeddedZipArchiveFactory::DecryptEmbeddedZipFileFunc DecryptFunc;
+
+    /** Read only archive data which can be read at any offset by several threads at once.
+    @remarks
+        Archive files are memory mapped if possible, so stored entries can be used in
+        place. Otherwise they are read with pread (or overlapped reads on Windows), so
+        readers never share a file position. Embedded archives are read from memory,
+        through their decryption function if they have one.
+    */
+    class ZipFileReader : public ArchiveAlloc
+    {
+    public:
+        /// Open an archive file
+        explicit ZipFileReader(const String& name);
+        /// Read an archive embedded in memory
+        ZipFileReader(const uchar* data, size_t size, DecryptFunc decryptFunc);
+        ~ZipFileReader();
+
+        /// Whether the archive could be opened
+        bool isOpen() const;
+        /// Size of the archive in bytes
+        uint64 size() const { return mSize; }
+        /// The whole archive if it can be read in place, NULL otherwise
+        const uchar* getData() const { return mDecryptFunc ? NULL : mData; }
+        /// Read up to count bytes starting at offset, returns the number of bytes read
+        size_t read(void* buf, size_t count, uint64 offset) const;
+    private:
+        bool openFile(const String& name);
+        void closeFile();
+        size_t readFile(void* buf, size_t count, uint64 offset) const;
+
+        /// MappedDataStream of the archive file, if it could be mapped
+        DataStreamPtr mMapping;
+        /// Mapped or embedded archive, NULL if it is read from the file
+        const uchar* mData;
+        DecryptFunc mDecryptFunc;
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32 || OGRE_PLATFORM == OGRE_PLATFORM_WINRT
+        HANDLE mHandle;
+#else
+        int mFd;
+#endif
+        uint64 mSize;
+    };
+    typedef SharedPtr<ZipFileReader> ZipFileReaderPtr;
+
+    /// Location of an entry, parsed from the central directory
+    struct ZipEntry
+    {
+        /// Full path of the entry within the archive
+        String name;
+        uint64 localHeaderOffset;
+        uint64 compressedSize;
+        uint64 uncompressedSize;
+        uint16 method;
+        uint16 flags;
+    };
+
+    /** Zip archive reading the central directory once into hashed indices.
+    @remarks
+        After load, all lookups only read immutable data and every opened file gets its
+        own reader on the shared file handle, so open, find and the other queries can be
+        called from any number of threads without locking. Entries are either stored or
+        deflated; stored entries of archives in memory are returned as views on the
+        archive data, without a copy.
+    */
     class ZipArchive : public Archive
     {
     protected:
-        /// Handle to root zip file
-        ZZIP_DIR* mZzipDir;
-        /// Handle any errors from zzip
-        void checkZzipError(int zzipError, const String& operation) const;
-        /// File list (since zziplib seems to only allow scanning of dir tree once)
+        typedef vector<ZipEntry>::type ZipEntryList;
+        typedef OGRE_HashMultiMap<String, size_t> NameIndex;
+
+        /// Shared handle of the archive file, NULL if not loaded
+        ZipFileReaderPtr mFile;
+        /// File list, in central directory order
         FileInfoList mFileList;
-        /// A pointer to file io alternative implementation
-        zzip_plugin_io_handlers* mPluginIo;
+        /// Entries matching mFileList
+        ZipEntryList mEntries;
+        /// Lower case FileInfo::filename to mFileList index
+        NameIndex mFilenameIndex;
+        /// Lower case FileInfo::basename to mFileList index
+        NameIndex mBasenameIndex;
+        /// Lower case full entry path to mFileList index, files only
+        NameIndex mPathIndex;
 
         OGRE_AUTO_MUTEX;
+
+        /// Open the archive data, called by load
+        virtual ZipFileReaderPtr createReader() const;
+        void throwError(const String& errorMsg, const String& operation) const;
+        void readCentralDirectory();
+        void addToIndex(NameIndex& index, const String& name, size_t i);
+        /// Collect mFileList indices of name in ascending order
+        void lookUp(const NameIndex& index, const String& name, vector<size_t>::type& ret) const;
+        /// Index of the entry to open, or mFileList.size() if not found
+        size_t findEntry(const String& filename) const;
     public:
-        ZipArchive(const String& name, const String& archType, zzip_plugin_io_handlers* pluginIo = NULL);
+        ZipArchive(const String& name, const String& archType);
         ~ZipArchive();
         /// @copydoc Archive::isCaseSensitive
         bool isCaseSensitive(void) const { return OGRE_RESOURCEMANAGER_STRICT; }
@@ -92,79 +184,258 @@ namespace {
         time_t getModifiedTime(const String& filename) const;
     };
 
-    /** Specialisation of DataStream to handle streaming data from zip archives. */
-    class ZipDataStream : public DataStream
+    /** Archive which was registered with EmbeddedZipArchiveFactory::addEmbbeddedFile. */
+    class EmbeddedZipArchive : public ZipArchive
     {
     protected:
-        ZZIP_FILE* mZzipFile;
-        /// We need caching because sometimes serializers step back in data stream and zziplib behaves slow
-        StaticCache<2 * OGRE_STREAM_TEMP_SIZE> mCache;
+        ZipFileReaderPtr createReader() const;
     public:
-        /// Constructor for creating named streams
-        ZipDataStream(const String& name, ZZIP_FILE* zzipFile, size_t uncompressedSize);
-        ~ZipDataStream();
+        EmbeddedZipArchive(const String& name, const String& archType) : ZipArchive(name, archType) {}
+        /// @copydoc Archive::getModifiedTime
+        time_t getModifiedTime(const String& filename) const { return 0; }
+    };
+
+    /** Stored zip entry of an archive in memory, read in place. */
+    class ZipViewDataStream : public MemoryDataStream
+    {
+    protected:
+        /// Keeps the archive data alive
+        ZipFileReaderPtr mFile;
+    public:
+        ZipViewDataStream(const String& name, const ZipFileReaderPtr& file, const uchar* data, size_t size)
+            : MemoryDataStream(name, const_cast<uchar*>(data), size, false, true), mFile(file) {}
+        /// @copydoc DataStream::close
+        void close(void) { MemoryDataStream::close(); mFile.reset(); }
+    };
+
+    /** Stream of a stored zip entry, reading the archive file directly. */
+    class ZipStoredDataStream : public DataStream
+    {
+    protected:
+        ZipFileReaderPtr mFile;
+        /// Offset of the entry data in the archive
+        uint64 mOffset;
+        size_t mPos;
+    public:
+        ZipStoredDataStream(const String& name, const ZipFileReaderPtr& file, uint64 offset, size_t size);
         /// @copydoc DataStream::read
         size_t read(void* buf, size_t count);
         /// @copydoc DataStream::write
-        size_t write(const void* buf, size_t count);
+        size_t write(const void* buf, size_t count) { return 0; }
         /// @copydoc DataStream::skip
         void skip(long count);
         /// @copydoc DataStream::seek
         void seek( size_t pos );
+        /// @copydoc DataStream::tell
+        size_t tell(void) const { return mPos; }
+        /// @copydoc DataStream::eof
+        bool eof(void) const { return mPos >= mSize; }
+        /// @copydoc DataStream::close
+        void close(void) { mFile.reset(); }
+    };
+
+    /** Stream of a deflated zip entry, inflating from the archive file on demand. */
+    class ZipDeflatedDataStream : public DataStream
+    {
+    protected:
+        ZipFileReaderPtr mFile;
+        /// Offset of the compressed data in the archive
+        uint64 mOffset;
+        uint64 mCompressedSize;
+        /// Compressed bytes consumed so far
+        uint64 mCompressedPos;
+        /// Uncompressed bytes produced so far
+        size_t mInflatedPos;
+        bool mStreamEnd;
+        z_stream mZStream;
+        /// Compressed input buffer
+        uchar mInput[16 * 1024];
+        /// We need caching because sometimes serializers step back in data stream
+        StaticCache<2 * OGRE_STREAM_TEMP_SIZE> mCache;
+
+        /// Inflate up to count bytes at mInflatedPos
+        size_t inflateData(void* buf, size_t count);
+        /// Restart inflating from the start of the entry
+        void rewindInflate();
+    public:
+        ZipDeflatedDataStream(const String& name, const ZipFileReaderPtr& file, uint64 offset,
+                              uint64 compressedSize, size_t uncompressedSize);
+        ~ZipDeflatedDataStream();
+        /// @copydoc DataStream::read
+        size_t read(void* buf, size_t count);
+        /// @copydoc DataStream::write
+        size_t write(const void* buf, size_t count) { return 0; }
+        /// @copydoc DataStream::skip
+        void skip(long count);
         /// @copydoc DataStream::seek
-        size_t tell(void) const;
+        void seek( size_t pos );
+        /// @copydoc DataStream::tell
+        size_t tell(void) const { return mInflatedPos - mCache.avail(); }
         /// @copydoc DataStream::eof
-        bool eof(void) const;
+        bool eof(void) const { return tell() >= mSize; }
         /// @copydoc DataStream::close
         void close(void);
     };
 
-    /// Utility method to format out zzip errors
-    String getZzipErrorDescription(zzip_error_t zzipError)
+    const uint32 ZIP_LOCAL_HEADER_SIGNATURE = 0x04034b50;
+    const uint32 ZIP_CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+    const uint32 ZIP_END_SIGNATURE = 0x06054b50;
+    const uint32 ZIP64_END_SIGNATURE = 0x06064b50;
+    const uint32 ZIP64_END_LOCATOR_SIGNATURE = 0x07064b50;
+    const size_t ZIP_LOCAL_HEADER_SIZE = 30;
+    const size_t ZIP_CENTRAL_HEADER_SIZE = 46;
+    const size_t ZIP_END_SIZE = 22;
+    const size_t ZIP64_END_SIZE = 56;
+    const size_t ZIP64_END_LOCATOR_SIZE = 20;
+    const uint16 ZIP_METHOD_STORED = 0;
+    const uint16 ZIP_METHOD_DEFLATED = 8;
+    const uint16 ZIP_FLAG_ENCRYPTED = 1;
+
+    inline uint16 readUInt16(const uchar* p) { return uint16(p[0] | (p[1] << 8)); }
+    inline uint32 readUInt32(const uchar* p) { return uint32(readUInt16(p)) | (uint32(readUInt16(p + 2)) << 16); }
+    inline uint64 readUInt64(const uchar* p) { return uint64(readUInt32(p)) | (uint64(readUInt32(p + 4)) << 32); }
+
+    void* OgreZipZalloc(void* opaque, unsigned int items, unsigned int size)
     {
-        String errorMsg;
-        switch (zzipError)
+        return OGRE_MALLOC(items * size, MEMCATEGORY_RESOURCE);
+    }
+    void OgreZipZfree(void* opaque, void* address)
+    {
+        OGRE_FREE(address, MEMCATEGORY_RESOURCE);
+    }
+}
+    //-----------------------------------------------------------------------
+    ZipFileReader::ZipFileReader(const String& name)
+        : mData(NULL), mDecryptFunc(NULL), mSize(0)
+    {
+        try
         {
-        case ZZIP_NO_ERROR:
-            break;
-        case ZZIP_OUTOFMEM:
-            errorMsg = "Out of memory.";
-            break;            
-        case ZZIP_DIR_OPEN:
-        case ZZIP_DIR_STAT: 
-        case ZZIP_DIR_SEEK:
-        case ZZIP_DIR_READ:
-            errorMsg = "Unable to read zip file.";
-            break;            
-        case ZZIP_UNSUPP_COMPR:
-            errorMsg = "Unsupported compression format.";
-            break;            
-        case ZZIP_CORRUPTED:
-            errorMsg = "Corrupted archive.";
-            break;
-        case ZZIP_DIR_TOO_SHORT:
-            errorMsg = "Zip file is too short.";
-            break;
-        case ZZIP_DIR_EDH_MISSING:
-            errorMsg = "Zip-file's central directory record missing. Is this a 7z file?";
-            break;
-        case ZZIP_ENOENT:
-            errorMsg = "File not in archive.";
-            break;
-        default:
-            errorMsg = "Unknown error.";
-            break;            
-        };
+            MappedDataStream* mapping = OGRE_NEW MappedDataStream(name, name);
+            mMapping.reset(mapping);
+            mData = mapping->getPtr();
+            mSize = mapping->size();
+        }
+        catch (FileNotFoundException&)
+        {
+            // e.g. no address space left, read the file instead
+        }
+        openFile(mData ? BLANKSTRING : name);
+    }
+    //-----------------------------------------------------------------------
+    ZipFileReader::ZipFileReader(const uchar* data, size_t size, DecryptFunc decryptFunc)
+        : mData(data), mDecryptFunc(decryptFunc), mSize(size)
+    {
+        openFile(BLANKSTRING);
+    }
+    //-----------------------------------------------------------------------
+    ZipFileReader::~ZipFileReader()
+    {
+        closeFile();
+    }
+    //-----------------------------------------------------------------------
+    size_t ZipFileReader::read(void* buf, size_t count, uint64 offset) const
+    {
+        if (!mData)
+            return readFile(buf, count, offset);
 
-        return errorMsg;
+        if (offset >= mSize)
+            return 0;
+        count = static_cast<size_t>(std::min<uint64>(count, mSize - offset));
+        memcpy(buf, mData + offset, count);
+        if (mDecryptFunc && !mDecryptFunc(static_cast<size_t>(offset), buf, count))
+            return 0;
+        return count;
     }
+    //-----------------------------------------------------------------------
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32 || OGRE_PLATFORM == OGRE_PLATFORM_WINRT
+    bool ZipFileReader::openFile(const String& name)
+    {
+        mHandle = INVALID_HANDLE_VALUE;
+        if (name.empty())
+            return false;
 
-    /// A static pointer to file io alternative implementation for the embedded files
-    zzip_plugin_io_handlers* gPluginIo = NULL;
-}
+        std::wstring wname(name.size(), 0);
+        wname.resize(MultiByteToWideChar(CP_UTF8, 0, name.c_str(), (int)name.size(), &wname[0], (int)wname.size()));
+#if OGRE_PLATFORM == OGRE_PLATFORM_WINRT
+        mHandle = CreateFile2(wname.c_str(), GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, NULL);
+#else
+        mHandle = CreateFileW(wname.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+#endif
+        LARGE_INTEGER size;
+        if (mHandle != INVALID_HANDLE_VALUE && GetFileSizeEx(mHandle, &size))
+            mSize = static_cast<uint64>(size.QuadPart);
+        return mHandle != INVALID_HANDLE_VALUE;
+    }
+    //-----------------------------------------------------------------------
+    void ZipFileReader::closeFile()
+    {
+        if (mHandle != INVALID_HANDLE_VALUE)
+            CloseHandle(mHandle);
+    }
     //-----------------------------------------------------------------------
-    ZipArchive::ZipArchive(const String& name, const String& archType, zzip_plugin_io_handlers* pluginIo)
-        : Archive(name, archType), mZzipDir(0), mPluginIo(pluginIo)
+    bool ZipFileReader::isOpen() const
+    {
+        return mData || mHandle != INVALID_HANDLE_VALUE;
+    }
+    //-----------------------------------------------------------------------
+    size_t ZipFileReader::readFile(void* buf, size_t count, uint64 offset) const
+    {
+        size_t total = 0;
+        while (total < count)
+        {
+            // explicit offsets do not touch the shared file pointer
+            OVERLAPPED overlapped = {};
+            overlapped.Offset = static_cast<DWORD>(offset + total);
+            overlapped.OffsetHigh = static_cast<DWORD>((offset + total) >> 32);
+            DWORD chunk = static_cast<DWORD>(std::min<size_t>(count - total, 0x40000000));
+            DWORD numRead = 0;
+            if (!ReadFile(mHandle, static_cast<char*>(buf) + total, chunk, &numRead, &overlapped) || numRead == 0)
+                break;
+            total += numRead;
+        }
+        return total;
+    }
+#else
+    bool ZipFileReader::openFile(const String& name)
+    {
+        mFd = name.empty() ? -1 : ::open(name.c_str(), O_RDONLY);
+        struct stat tagStat;
+        if (mFd != -1 && fstat(mFd, &tagStat) == 0)
+            mSize = static_cast<uint64>(tagStat.st_size);
+        return mFd != -1;
+    }
+    //-----------------------------------------------------------------------
+    void ZipFileReader::closeFile()
+    {
+        if (mFd != -1)
+            ::close(mFd);
+    }
+    //-----------------------------------------------------------------------
+    bool ZipFileReader::isOpen() const
+    {
+        return mData || mFd != -1;
+    }
+    //-----------------------------------------------------------------------
+    size_t ZipFileReader::readFile(void* buf, size_t count, uint64 offset) const
+    {
+        size_t total = 0;
+        while (total < count)
+        {
+            ssize_t numRead = ::pread(mFd, static_cast<char*>(buf) + total, count - total,
+                                      static_cast<off_t>(offset + total));
+            if (numRead < 0 && errno == EINTR)
+                continue;
+            if (numRead <= 0)
+                break;
+            total += static_cast<size_t>(numRead);
+        }
+        return total;
+    }
+#endif
+    //-----------------------------------------------------------------------
+    ZipArchive::ZipArchive(const String& name, const String& archType)
+        : Archive(name, archType)
     {
     }
     //-----------------------------------------------------------------------
@@ -176,105 +447,296 @@ namespace {
     void ZipArchive::load()
     {
         OGRE_LOCK_AUTO_MUTEX;
-        if (!mZzipDir)
+        if (!mFile)
         {
-            zzip_error_t zzipError;
-            mZzipDir = zzip_dir_open_ext_io(mName.c_str(), &zzipError, 0, mPluginIo);
-            checkZzipError(zzipError, "opening archive");
+            ZipFileReaderPtr file = createReader();
+            if (!file || !file->isOpen())
+                throwError("Unable to read zip file.", "opening archive");
+            mFile = file;
 
-            // Cache names
-            ZZIP_DIRENT zzipEntry;
-            while (zzip_dir_read(mZzipDir, &zzipEntry))
+            try
             {
-                FileInfo info;
-                info.archive = this;
-                // Get basename / path
-                StringUtil::splitFilename(zzipEntry.d_name, info.basename, info.path);
-                info.filename = zzipEntry.d_name;
-                // Get sizes
-                info.compressedSize = static_cast<size_t>(zzipEntry.d_csize);
-                info.uncompressedSize = static_cast<size_t>(zzipEntry.st_size);
-                // folder entries
-                if (info.basename.empty())
-                {
-                    info.filename = info.filename.substr (0, info.filename.length () - 1);
-                    StringUtil::splitFilename(info.filename, info.basename, info.path);
-                    // Set compressed size to -1 for folders; anyway nobody will check
-                    // the compressed size of a folder, and if he does, its useless anyway
-                    info.compressedSize = size_t (-1);
-                }
-#if !OGRE_RESOURCEMANAGER_STRICT
-                else
+                readCentralDirectory();
+            }
+            catch (...)
+            {
+                unload();
+                throw;
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    ZipFileReaderPtr ZipArchive::createReader() const
+    {
+        return ZipFileReaderPtr(OGRE_NEW ZipFileReader(mName));
+    }
+    //-----------------------------------------------------------------------
+    void ZipArchive::readCentralDirectory()
+    {
+        // The end of central directory record is followed by a comment of up to 64k
+        uint64 fileSize = mFile->size();
+        size_t tailSize = static_cast<size_t>(
+            std::min<uint64>(fileSize, ZIP_END_SIZE + 0xFFFF + ZIP64_END_LOCATOR_SIZE));
+        if (tailSize < ZIP_END_SIZE)
+            throwError("Zip file is too short.", "opening archive");
+
+        vector<uchar>::type buffer(tailSize);
+        if (mFile->read(&buffer[0], tailSize, fileSize - tailSize) != tailSize)
+            throwError("Unable to read zip file.", "opening archive");
+
+        size_t endPos = tailSize - ZIP_END_SIZE + 1;
+        do
+        {
+            --endPos;
+            if (readUInt32(&buffer[endPos]) == ZIP_END_SIGNATURE)
+                break;
+        } while (endPos > 0);
+        if (readUInt32(&buffer[endPos]) != ZIP_END_SIGNATURE)
+            throwError("Zip-file's central directory record missing. Is this a 7z file?", "opening archive");
+
+        const uchar* end = &buffer[endPos];
+        uint64 numEntries = readUInt16(end + 10);
+        uint64 directorySize = readUInt32(end + 12);
+        uint64 directoryOffset = readUInt32(end + 16);
+
+        // Zip64 archives store the real values in a separate record
+        if (endPos >= ZIP64_END_LOCATOR_SIZE &&
+            readUInt32(end - ZIP64_END_LOCATOR_SIZE) == ZIP64_END_LOCATOR_SIGNATURE)
+        {
+            uchar zip64End[ZIP64_END_SIZE];
+            uint64 zip64EndOffset = readUInt64(end - ZIP64_END_LOCATOR_SIZE + 8);
+            if (mFile->read(zip64End, ZIP64_END_SIZE, zip64EndOffset) != ZIP64_END_SIZE ||
+                readUInt32(zip64End) != ZIP64_END_SIGNATURE)
+                throwError("Corrupted archive.", "opening archive");
+            numEntries = readUInt64(zip64End + 32);
+            directorySize = readUInt64(zip64End + 40);
+            directoryOffset = readUInt64(zip64End + 48);
+        }
+
+        if (directoryOffset + directorySize > fileSize)
+            throwError("Corrupted archive.", "opening archive");
+
+        buffer.resize(static_cast<size_t>(directorySize));
+        if (directorySize &&
+            mFile->read(&buffer[0], buffer.size(), directoryOffset) != buffer.size())
+            throwError("Unable to read zip file.", "opening archive");
+
+        mFileList.reserve(static_cast<size_t>(numEntries));
+        mEntries.reserve(static_cast<size_t>(numEntries));
+        size_t pos = 0;
+        for (uint64 e = 0; e < numEntries; ++e)
+        {
+            if (pos + ZIP_CENTRAL_HEADER_SIZE > buffer.size() ||
+                readUInt32(&buffer[pos]) != ZIP_CENTRAL_HEADER_SIGNATURE)
+                throwError("Corrupted archive.", "opening archive");
+
+            const uchar* header = &buffer[pos];
+            size_t nameLength = readUInt16(header + 28);
+            size_t extraLength = readUInt16(header + 30);
+            size_t commentLength = readUInt16(header + 32);
+            if (pos + ZIP_CENTRAL_HEADER_SIZE + nameLength + extraLength + commentLength > buffer.size())
+                throwError("Corrupted archive.", "opening archive");
+
+            ZipEntry entry;
+            entry.flags = readUInt16(header + 8);
+            entry.method = readUInt16(header + 10);
+            entry.compressedSize = readUInt32(header + 20);
+            entry.uncompressedSize = readUInt32(header + 24);
+            entry.localHeaderOffset = readUInt32(header + 42);
+            entry.name.assign(reinterpret_cast<const char*>(header + ZIP_CENTRAL_HEADER_SIZE), nameLength);
+
+            // Zip64 extended information replaces the saturated fields, in this order
+            const uchar* extra = header + ZIP_CENTRAL_HEADER_SIZE + nameLength;
+            const uchar* extraEnd = extra + extraLength;
+            while (extra + 4 <= extraEnd)
+            {
+                uint16 id = readUInt16(extra);
+                uint16 size = readUInt16(extra + 2);
+                const uchar* data = extra + 4;
+                const uchar* dataEnd = std::min(data + size, extraEnd);
+                if (id == 0x0001)
                 {
-                    info.filename = info.basename;
+                    uint64* fields[] = {&entry.uncompressedSize, &entry.compressedSize, &entry.localHeaderOffset};
+                    for (size_t f = 0; f < 3; ++f)
+                    {
+                        if (*fields[f] != 0xFFFFFFFF)
+                            continue;
+                        if (data + 8 > dataEnd)
+                            break;
+                        *fields[f] = readUInt64(data);
+                        data += 8;
+                    }
                 }
-#endif
-                mFileList.push_back(info);
+                extra += 4 + size;
+            }
+            pos += ZIP_CENTRAL_HEADER_SIZE + nameLength + extraLength + commentLength;
 
+            FileInfo info;
+            info.archive = this;
+            // Get basename / path
+            StringUtil::splitFilename(entry.name, info.basename, info.path);
+            info.filename = entry.name;
+            // Get sizes
+            info.compressedSize = static_cast<size_t>(entry.compressedSize);
+            info.uncompressedSize = static_cast<size_t>(entry.uncompressedSize);
+            // folder entries
+            if (info.basename.empty())
+            {
+                info.filename = info.filename.substr (0, info.filename.length () - 1);
+                StringUtil::splitFilename(info.filename, info.basename, info.path);
+                // Set compressed size to -1 for folders; anyway nobody will check
+                // the compressed size of a folder, and if he does, its useless anyway
+                info.compressedSize = size_t (-1);
             }
+#if !OGRE_RESOURCEMANAGER_STRICT
+            else
+            {
+                info.filename = info.basename;
+            }
+#endif
+            size_t i = mFileList.size();
+            addToIndex(mFilenameIndex, info.filename, i);
+            addToIndex(mBasenameIndex, info.basename, i);
+            if (info.compressedSize != size_t (-1))
+                addToIndex(mPathIndex, entry.name, i);
 
+            mFileList.push_back(info);
+            mEntries.push_back(entry);
         }
     }
     //-----------------------------------------------------------------------
+    void ZipArchive::addToIndex(NameIndex& index, const String& name, size_t i)
+    {
+        String key = name;
+        StringUtil::toLowerCase(key);
+        index.insert(NameIndex::value_type(key, i));
+    }
+    //-----------------------------------------------------------------------
+    void ZipArchive::lookUp(const NameIndex& index, const String& name, vector<size_t>::type& ret) const
+    {
+        String key = name;
+        StringUtil::toLowerCase(key);
+        std::pair<NameIndex::const_iterator, NameIndex::const_iterator> range = index.equal_range(key);
+        for (NameIndex::const_iterator i = range.first; i != range.second; ++i)
+            ret.push_back(i->second);
+        std::sort(ret.begin(), ret.end());
+    }
+    //-----------------------------------------------------------------------
     void ZipArchive::unload()
     {
         OGRE_LOCK_AUTO_MUTEX;
-        if (mZzipDir)
+        if (mFile)
         {
-            zzip_dir_close(mZzipDir);
-            mZzipDir = 0;
+            // open streams keep their own reference to the file
+            mFile.reset();
             mFileList.clear();
+            mEntries.clear();
+            mFilenameIndex.clear();
+            mBasenameIndex.clear();
+            mPathIndex.clear();
         }
-    
     }
     //-----------------------------------------------------------------------
-    DataStreamPtr ZipArchive::open(const String& filename, bool readOnly) const
+    size_t ZipArchive::findEntry(const String& filename) const
     {
-        // zziplib is not threadsafe
-        OGRE_LOCK_AUTO_MUTEX;
-        String lookUpFileName = filename;
-
+        vector<size_t>::type matches;
+        lookUp(mPathIndex, filename, matches);
+        for (size_t m = 0; m < matches.size(); ++m)
+        {
 #if OGRE_RESOURCEMANAGER_STRICT
-        const int flags = 0;
-#else
-        const int flags = ZZIP_CASELESS;
+            if (mEntries[matches[m]].name != filename)
+                continue;
 #endif
-
-        // Format not used here (always binary)
-        ZZIP_FILE* zzipFile =
-            zzip_file_open(mZzipDir, lookUpFileName.c_str(), ZZIP_ONLYZIP | flags);
+            return matches[m];
+        }
+        return mFileList.size();
+    }
+    //-----------------------------------------------------------------------
+    DataStreamPtr ZipArchive::open(const String& filename, bool readOnly) const
+    {
+        // No locking, the index is not modified after load
+        String lookUpFileName = filename;
+        size_t index = findEntry(lookUpFileName);
 
 #if !OGRE_RESOURCEMANAGER_STRICT
-        if (!zzipFile) // Try if we find the file
+        if (index == mFileList.size()) // Try if we find the file
         {
             String basename, path;
             StringUtil::splitFilename(lookUpFileName, basename, path);
-            const FileInfoListPtr fileNfo = findFileInfo(basename, true);
-            if (fileNfo->size() == 1) // If there are more files with the same do not open anyone
+            vector<size_t>::type matches;
+            lookUp(mBasenameIndex, basename, matches);
+
+            size_t numFiles = 0;
+            for (size_t m = 0; m < matches.size(); ++m)
+            {
+                if (mFileList[matches[m]].compressedSize != size_t (-1))
+                {
+                    index = matches[m];
+                    ++numFiles;
+                }
+            }
+
+            if (numFiles == 1) // If there are more files with the same do not open anyone
             {
-                Ogre::FileInfo info = fileNfo->at(0);
+                const FileInfo& info = mFileList[index];
                 lookUpFileName = info.path + info.basename;
-                zzipFile = zzip_file_open(mZzipDir, lookUpFileName.c_str(), ZZIP_ONLYZIP | flags); // When an error happens here we will catch it below
+            }
+            else
+            {
+                index = mFileList.size();
             }
         }
 #endif
 
-        if (!zzipFile)
+        if (index == mFileList.size())
         {
-            int zerr = zzip_error(mZzipDir);
-            String zzDesc = getZzipErrorDescription((zzip_error_t)zerr);
-
             OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND,
-                    mName+ " Cannot open file: " + lookUpFileName + " - "+zzDesc, "ZipArchive::open");
+                    mName+ " Cannot open file: " + lookUpFileName + " - File not in archive.", "ZipArchive::open");
         }
 
-        // Get uncompressed size too
-        ZZIP_STAT zstat;
-        zzip_dir_stat(mZzipDir, lookUpFileName.c_str(), &zstat, flags);
+        const ZipEntry& entry = mEntries[index];
+        if (entry.flags & ZIP_FLAG_ENCRYPTED)
+        {
+            OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+                    mName+ " Cannot open file: " + lookUpFileName + " - Encrypted entries are not supported.",
+                    "ZipArchive::open");
+        }
 
-        // Construct & return stream
-        return DataStreamPtr(OGRE_NEW ZipDataStream(lookUpFileName, zzipFile, static_cast<size_t>(zstat.st_size)));
+        // The local header may have a different extra field than the central directory
+        uchar localHeader[ZIP_LOCAL_HEADER_SIZE];
+        if (mFile->read(localHeader, ZIP_LOCAL_HEADER_SIZE, entry.localHeaderOffset) != ZIP_LOCAL_HEADER_SIZE ||
+            readUInt32(localHeader) != ZIP_LOCAL_HEADER_SIGNATURE)
+        {
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                    mName+ " Cannot open file: " + lookUpFileName + " - Corrupted archive.", "ZipArchive::open");
+        }
+        uint64 dataOffset = entry.localHeaderOffset + ZIP_LOCAL_HEADER_SIZE +
+            readUInt16(localHeader + 26) + readUInt16(localHeader + 28);
+        if (dataOffset + entry.compressedSize > mFile->size())
+        {
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                    mName+ " Cannot open file: " + lookUpFileName + " - Corrupted archive.", "ZipArchive::open");
+        }
 
+        // Construct & return stream
+        switch (entry.method)
+        {
+        case ZIP_METHOD_STORED:
+            if (const uchar* data = mFile->getData())
+            {
+                return DataStreamPtr(OGRE_NEW ZipViewDataStream(lookUpFileName, mFile, data + dataOffset,
+                    static_cast<size_t>(entry.uncompressedSize)));
+            }
+            return DataStreamPtr(OGRE_NEW ZipStoredDataStream(lookUpFileName, mFile, dataOffset,
+                static_cast<size_t>(entry.uncompressedSize)));
+        case ZIP_METHOD_DEFLATED:
+            return DataStreamPtr(OGRE_NEW ZipDeflatedDataStream(lookUpFileName, mFile, dataOffset,
+                entry.compressedSize, static_cast<size_t>(entry.uncompressedSize)));
+        default:
+            OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+                    mName+ " Cannot open file: " + lookUpFileName + " - Unsupported compression format.",
+                    "ZipArchive::open");
+        }
     }
     //---------------------------------------------------------------------
     DataStreamPtr ZipArchive::create(const String& filename)
@@ -294,7 +756,6 @@ namespace {
     //-----------------------------------------------------------------------
     StringVectorPtr ZipArchive::list(bool recursive, bool dirs) const
     {
-        OGRE_LOCK_AUTO_MUTEX;
         StringVectorPtr ret = StringVectorPtr(OGRE_NEW_T(StringVector, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
 
         FileInfoList::const_iterator i, iend;
@@ -309,7 +770,6 @@ namespace {
     //-----------------------------------------------------------------------
     FileInfoListPtr ZipArchive::listFileInfo(bool recursive, bool dirs) const
     {
-        OGRE_LOCK_AUTO_MUTEX;
         FileInfoList* fil = OGRE_NEW_T(FileInfoList, MEMCATEGORY_GENERAL)();
         FileInfoList::const_iterator i, iend;
         iend = mFileList.end();
@@ -323,40 +783,43 @@ namespace {
     //-----------------------------------------------------------------------
     StringVectorPtr ZipArchive::find(const String& pattern, bool recursive, bool dirs) const
     {
-        OGRE_LOCK_AUTO_MUTEX;
         StringVectorPtr ret = StringVectorPtr(OGRE_NEW_T(StringVector, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
-        // If pattern contains a directory name, do a full match
-        bool full_match = (pattern.find ('/') != String::npos) ||
-                          (pattern.find ('\\') != String::npos);
-        bool wildCard = pattern.find('*') != String::npos;
-            
-        FileInfoList::const_iterator i, iend;
-        iend = mFileList.end();
-        for (i = mFileList.begin(); i != iend; ++i)
-            if ((dirs == (i->compressedSize == size_t (-1))) &&
-                (recursive || full_match || wildCard))
-                // Check basename matches pattern (zip is case insensitive)
-                if (StringUtil::match(full_match ? i->filename : i->basename, pattern, false))
-                    ret->push_back(i->filename);
-
+        FileInfoListPtr infos = findFileInfo(pattern, recursive, dirs);
+        ret->reserve(infos->size());
+        for (FileInfoList::const_iterator i = infos->begin(); i != infos->end(); ++i)
+            ret->push_back(i->filename);
         return ret;
     }
     //-----------------------------------------------------------------------
     FileInfoListPtr ZipArchive::findFileInfo(const String& pattern, 
         bool recursive, bool dirs) const
     {
-        OGRE_LOCK_AUTO_MUTEX;
         FileInfoListPtr ret = FileInfoListPtr(OGRE_NEW_T(FileInfoList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
         // If pattern contains a directory name, do a full match
         bool full_match = (pattern.find ('/') != String::npos) ||
                           (pattern.find ('\\') != String::npos);
         bool wildCard = pattern.find('*') != String::npos;
+        if (!(recursive || full_match || wildCard))
+            return ret;
+
+        if (!wildCard)
+        {
+            // Plain names are looked up in the index (zip is case insensitive)
+            vector<size_t>::type matches;
+            lookUp(full_match ? mFilenameIndex : mBasenameIndex, pattern, matches);
+            for (size_t m = 0; m < matches.size(); ++m)
+            {
+                const FileInfo& info = mFileList[matches[m]];
+                if (dirs == (info.compressedSize == size_t (-1)))
+                    ret->push_back(info);
+            }
+            return ret;
+        }
 
         FileInfoList::const_iterator i, iend;
         iend = mFileList.end();
         for (i = mFileList.begin(); i != iend; ++i)
-            if ((dirs == (i->compressedSize == size_t (-1))) &&
-                (recursive || full_match || wildCard))
+            if (dirs == (i->compressedSize == size_t (-1)))
                 // Check name matches pattern (zip is case insensitive)
                 if (StringUtil::match(full_match ? i->filename : i->basename, pattern, false))
                     ret->push_back(*i);
@@ -364,17 +827,8 @@ namespace {
         return ret;
     }
     //-----------------------------------------------------------------------
-    struct FileNameCompare : public std::binary_function<FileInfo, String, bool>
-    {
-        bool operator()(const Ogre::FileInfo& lhs, const String& filename) const
-        {
-            return lhs.filename == filename;
-        }
-    };
-    //-----------------------------------------------------------------------
     bool ZipArchive::exists(const String& filename) const
     {       
-        OGRE_LOCK_AUTO_MUTEX;
         String cleanName = filename;
 #if !OGRE_RESOURCEMANAGER_STRICT
         if(filename.rfind('/') != String::npos)
@@ -384,13 +838,19 @@ namespace {
         }
 #endif
 
-        return std::find_if (mFileList.begin(), mFileList.end(), std::bind2nd<FileNameCompare>(FileNameCompare(), cleanName)) != mFileList.end();
+        vector<size_t>::type matches;
+        lookUp(mFilenameIndex, cleanName, matches);
+        for (size_t m = 0; m < matches.size(); ++m)
+        {
+            if (mFileList[matches[m]].filename == cleanName)
+                return true;
+        }
+        return false;
     }
     //---------------------------------------------------------------------
     time_t ZipArchive::getModifiedTime(const String& filename) const
     {
-        // Zziplib doesn't yet support getting the modification time of individual files
-        // so just check the mod time of the zip itself
+        // Individual entries are not checked, just the mod time of the zip itself
         struct stat tagStat;
         bool ret = (stat(mName.c_str(), &tagStat) == 0);
 
@@ -405,107 +865,177 @@ namespace {
 
     }
     //-----------------------------------------------------------------------
-    void ZipArchive::checkZzipError(int zzipError, const String& operation) const
+    void ZipArchive::throwError(const String& errorMsg, const String& operation) const
     {
-        if (zzipError != ZZIP_NO_ERROR)
-        {
-            String errorMsg = getZzipErrorDescription(static_cast<zzip_error_t>(zzipError));
+        OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, 
+            mName + " - error whilst " + operation + ": " + errorMsg,
+            "ZipArchive::throwError");
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    ZipStoredDataStream::ZipStoredDataStream(const String& name, const ZipFileReaderPtr& file,
+                                             uint64 offset, size_t size)
+        : DataStream(name), mFile(file), mOffset(offset), mPos(0)
+    {
+        mSize = size;
+    }
+    //-----------------------------------------------------------------------
+    size_t ZipStoredDataStream::read(void* buf, size_t count)
+    {
+        if (!mFile)
+            return 0;
 
-            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, 
-                mName + " - error whilst " + operation + ": " + errorMsg,
-                "ZipArchive::checkZzipError");
-        }
+        count = std::min(count, mSize - std::min(mPos, mSize));
+        size_t numRead = mFile->read(buf, count, mOffset + mPos);
+        mPos += numRead;
+        return numRead;
     }
     //-----------------------------------------------------------------------
+    void ZipStoredDataStream::skip(long count)
+    {
+        if (count < 0 && size_t(-count) > mPos)
+            mPos = 0;
+        else
+            mPos = std::min(mPos + count, mSize);
+    }
+    //-----------------------------------------------------------------------
+    void ZipStoredDataStream::seek( size_t pos )
+    {
+        mPos = std::min(pos, mSize);
+    }
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
-    ZipDataStream::ZipDataStream(const String& name, ZZIP_FILE* zzipFile, size_t uncompressedSize)
-        :DataStream(name), mZzipFile(zzipFile)
+    //-----------------------------------------------------------------------
+    ZipDeflatedDataStream::ZipDeflatedDataStream(const String& name, const ZipFileReaderPtr& file,
+        uint64 offset, uint64 compressedSize, size_t uncompressedSize)
+        : DataStream(name), mFile(file), mOffset(offset), mCompressedSize(compressedSize)
+        , mCompressedPos(0), mInflatedPos(0), mStreamEnd(false)
     {
         mSize = uncompressedSize;
+
+        memset(&mZStream, 0, sizeof(mZStream));
+        mZStream.zalloc = OgreZipZalloc;
+        mZStream.zfree = OgreZipZfree;
+        // raw deflate data, zip entries have no zlib header
+        if (inflateInit2(&mZStream, -MAX_WBITS) != Z_OK)
+        {
+            mFile.reset();
+            OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
+                mName + " - error initialising zlib", "ZipDeflatedDataStream");
+        }
     }
     //-----------------------------------------------------------------------
-    ZipDataStream::~ZipDataStream()
+    ZipDeflatedDataStream::~ZipDeflatedDataStream()
     {
         close();
     }
     //-----------------------------------------------------------------------
-    size_t ZipDataStream::read(void* buf, size_t count)
+    size_t ZipDeflatedDataStream::inflateData(void* buf, size_t count)
     {
-        size_t was_avail = mCache.read(buf, count);
-        zzip_ssize_t r = 0;
-        if (was_avail < count)
+        mZStream.next_out = static_cast<Bytef*>(buf);
+        mZStream.avail_out = static_cast<uInt>(count);
+        while (mZStream.avail_out > 0 && !mStreamEnd)
         {
-            r = zzip_file_read(mZzipFile, (char*)buf + was_avail, count - was_avail);
-            if (r<0) {
-                ZZIP_DIR *dir = zzip_dirhandle(mZzipFile);
-                String msg = zzip_strerror_of(dir);
+            if (mZStream.avail_in == 0)
+            {
+                if (const uchar* data = mFile->getData())
+                {
+                    // inflate straight from the archive in memory
+                    uInt numRead = static_cast<uInt>(std::min<uint64>(mCompressedSize - mCompressedPos, 0x40000000));
+                    if (numRead == 0)
+                        break; // truncated entry
+                    mZStream.next_in = const_cast<Bytef*>(data + mOffset + mCompressedPos);
+                    mZStream.avail_in = numRead;
+                    mCompressedPos += numRead;
+                }
+                else
+                {
+                    size_t toRead = static_cast<size_t>(
+                        std::min<uint64>(sizeof(mInput), mCompressedSize - mCompressedPos));
+                    size_t numRead = toRead ? mFile->read(mInput, toRead, mOffset + mCompressedPos) : 0;
+                    if (numRead == 0)
+                        break; // truncated entry
+                    mCompressedPos += numRead;
+                    mZStream.next_in = mInput;
+                    mZStream.avail_in = static_cast<uInt>(numRead);
+                }
+            }
+
+            int status = inflate(&mZStream, Z_NO_FLUSH);
+            if (status == Z_STREAM_END)
+            {
+                mStreamEnd = true;
+            }
+            else if (status != Z_OK && status != Z_BUF_ERROR)
+            {
                 OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
-                    mName+" - error from zziplib: "+msg,
-                    "ZipDataStream::read");
+                    mName + " - error from zlib: " + (mZStream.msg ? mZStream.msg : "corrupted data"),
+                    "ZipDeflatedDataStream::read");
             }
-            mCache.cacheData((char*)buf + was_avail, (size_t)r);
         }
-        return was_avail + (size_t)r;
-    }
-    //---------------------------------------------------------------------
-    size_t ZipDataStream::write(const void* buf, size_t count)
-    {
-        // not supported
-        return 0;
+
+        size_t produced = count - mZStream.avail_out;
+        mInflatedPos += produced;
+        return produced;
     }
     //-----------------------------------------------------------------------
-    void ZipDataStream::skip(long count)
+    void ZipDeflatedDataStream::rewindInflate()
     {
-        long was_avail = static_cast<long>(mCache.avail());
-        if (count > 0)
-        {
-            if (!mCache.ff(count))
-                zzip_seek(mZzipFile, static_cast<zzip_off_t>(count - was_avail), SEEK_CUR);
-        }
-        else if (count < 0)
-        {
-            if (!mCache.rewind((size_t)(-count)))
-                zzip_seek(mZzipFile, static_cast<zzip_off_t>(count + was_avail), SEEK_CUR);
-        }
+        inflateReset(&mZStream);
+        mZStream.avail_in = 0;
+        mCompressedPos = 0;
+        mInflatedPos = 0;
+        mStreamEnd = false;
+        mCache.clear();
     }
     //-----------------------------------------------------------------------
-    void ZipDataStream::seek( size_t pos )
+    size_t ZipDeflatedDataStream::read(void* buf, size_t count)
     {
-        zzip_off_t newPos = static_cast<zzip_off_t>(pos);
-        zzip_off_t prevPos = static_cast<zzip_off_t>(tell());
-        if (prevPos < 0)
-        {
-            // seek set after invalid pos
-            mCache.clear();
-            zzip_seek(mZzipFile, newPos, SEEK_SET);
-        }
-        else
+        size_t was_avail = mCache.read(buf, count);
+        size_t r = 0;
+        if (was_avail < count && mFile)
         {
-            // everything is going all right, relative seek
-            skip((long)(newPos - prevPos));
+            r = inflateData((char*)buf + was_avail, count - was_avail);
+            mCache.cacheData((char*)buf + was_avail, r);
         }
+        return was_avail + r;
     }
     //-----------------------------------------------------------------------
-    size_t ZipDataStream::tell(void) const
+    void ZipDeflatedDataStream::skip(long count)
     {
-        zzip_off_t pos = zzip_tell(mZzipFile);
-        if (pos<0)
-            return (size_t)(-1);
-        return static_cast<size_t>(pos) - mCache.avail();
+        size_t pos = tell();
+        seek(count < 0 && size_t(-count) > pos ? 0 : pos + count);
     }
     //-----------------------------------------------------------------------
-    bool ZipDataStream::eof(void) const
+    void ZipDeflatedDataStream::seek( size_t pos )
     {
-        return (tell() >= mSize);
+        pos = std::min(pos, mSize);
+        size_t current = tell();
+        if (pos >= current ? mCache.ff(pos - current) : mCache.rewind(current - pos))
+            return;
+
+        // not cached, the cache was cleared
+        if (!mFile)
+            return;
+        if (pos < mInflatedPos)
+            rewindInflate();
+
+        char discard[OGRE_STREAM_TEMP_SIZE * 8];
+        while (mInflatedPos < pos)
+        {
+            size_t chunk = std::min(sizeof(discard), pos - mInflatedPos);
+            if (inflateData(discard, chunk) < chunk)
+                break;
+        }
     }
     //-----------------------------------------------------------------------
-    void ZipDataStream::close(void)
+    void ZipDeflatedDataStream::close(void)
     {
-        if (mZzipFile != 0)
+        if (mFile)
         {
-            zzip_file_close(mZzipFile);
-            mZzipFile = 0;
+            inflateEnd(&mZStream);
+            mFile.reset();
         }
         mCache.clear();
     }
@@ -531,204 +1061,37 @@ namespace {
     //  EmbeddedZipArchiveFactory
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
-    /// a struct to hold embedded file data
+    namespace {
+    /// Data of an embedded zip file
     struct EmbeddedFileData
     {
         const uint8 * fileData;
-        zzip_size_t fileSize;
-        zzip_size_t curPos;
-        bool isFileOpened;
-        EmbeddedZipArchiveFactory::DecryptEmbeddedZipFileFunc decryptFunc;
+        size_t fileSize;
+        DecryptFunc decryptFunc;
     };
-    //-----------------------------------------------------------------------
-    /// A type for a map between the file names to file index
-    typedef map<String, int>::type FileNameToIndexMap;
-    typedef FileNameToIndexMap::iterator FileNameToIndexMapIter;
-    /// A type to store the embedded files data
-    typedef vector<EmbeddedFileData>::type EmbbedFileDataList;
+    /// A type for a map between the file names and their data
+    typedef map<String, EmbeddedFileData>::type EmbeddedFileDataMap;
 
-    namespace {
-    /// A static map between the file names to file index
-    FileNameToIndexMap * EmbeddedZipArchiveFactory_mFileNameToIndexMap;
-    /// A static list to store the embedded files data
-    EmbbedFileDataList * EmbeddedZipArchiveFactory_mEmbbedFileDataList;
-    _zzip_plugin_io sEmbeddedZipArchiveFactory_PluginIo;
-    #define EMBED_IO_BAD_FILE_HANDLE (-1)
-    #define EMBED_IO_SUCCESS (0)
-    //-----------------------------------------------------------------------
-    /// functions for embedded zzip_plugin_io_handlers implementation 
-    /// The functions are here and not as static members because they 
-    /// use types that I don't want to define in the header like zzip_char_t,
-    //  zzip_ssize_t and such.
-    //-----------------------------------------------------------------------
-    // get file date by index
-    EmbeddedFileData & getEmbeddedFileDataByIndex(int fd)
+    /// The embedded files; a function local static, so addEmbbeddedFile can be called from static initialisers
+    EmbeddedFileDataMap& getEmbeddedFiles()
     {
-        return (*EmbeddedZipArchiveFactory_mEmbbedFileDataList)[fd-1];
+        static EmbeddedFileDataMap files;
+        return files;
     }
-    //-----------------------------------------------------------------------
-    // opens the file
-    int EmbeddedZipArchiveFactory_open(zzip_char_t* name, int flags, ...)
-    {
-        String nameAsString = name;
-        FileNameToIndexMapIter foundIter = EmbeddedZipArchiveFactory_mFileNameToIndexMap->find(nameAsString);
-        if (foundIter != EmbeddedZipArchiveFactory_mFileNameToIndexMap->end())
-        {
-            int fd = foundIter->second;
-            EmbeddedFileData & curEmbeddedFileData = getEmbeddedFileDataByIndex(fd);
-            if(curEmbeddedFileData.isFileOpened)
-            {
-               // file is opened - return an error handle
-               return EMBED_IO_BAD_FILE_HANDLE;
-            }
-            
-            curEmbeddedFileData.isFileOpened = true;
-            return fd;
-        }
-        else
-        {
-           // not found - return an error handle
-           return EMBED_IO_BAD_FILE_HANDLE;
-        }
     }
     //-----------------------------------------------------------------------
-    // Closes a file.
-    // Return Value - On success, close returns 0. 
-    int EmbeddedZipArchiveFactory_close(int fd)
+    ZipFileReaderPtr EmbeddedZipArchive::createReader() const
     {
-        if (fd == EMBED_IO_BAD_FILE_HANDLE)
-        {
-            // bad index - return an error
-            return -1;
-        }
-
-        EmbeddedFileData & curEmbeddedFileData = getEmbeddedFileDataByIndex(fd);
-
-        if(curEmbeddedFileData.isFileOpened == false)
-        {
-           // file is opened - return an error handle
-           return -1;
-        }
-        else
-        {
-            // success
-            curEmbeddedFileData.isFileOpened = false;
-            curEmbeddedFileData.curPos = 0;
-            return 0;
-        }
-
-    }
-       
-    //-----------------------------------------------------------------------
-    // reads data from the file
-    zzip_ssize_t EmbeddedZipArchiveFactory_read(int fd, void* buf, zzip_size_t len)
-    {
-        if (fd == EMBED_IO_BAD_FILE_HANDLE)
-        {
-            // bad index - return an error size - negative
-            return -1;
-        }
-        // get the current buffer in file;
-        EmbeddedFileData & curEmbeddedFileData = getEmbeddedFileDataByIndex(fd);
-        const uint8 * curFileData = curEmbeddedFileData.fileData;
-        if (len + curEmbeddedFileData.curPos > curEmbeddedFileData.fileSize)
-        {
-            len = curEmbeddedFileData.fileSize - curEmbeddedFileData.curPos;
-        }
-        curFileData += curEmbeddedFileData.curPos;
-        
-        // copy to out buffer
-        memcpy(buf, curFileData, len);
-
-        if( curEmbeddedFileData.decryptFunc != NULL )
-        {
-            if (!curEmbeddedFileData.decryptFunc(curEmbeddedFileData.curPos, buf, len))
-            {
-                // decrypt failed - return an error size - negative
-                return -1;
-            }
-        }
-
-        // move the cursor to the new pos
-        curEmbeddedFileData.curPos += len;
-        
-        return len;
-    }
-    //-----------------------------------------------------------------------
-    // Moves file pointer.
-    zzip_off_t EmbeddedZipArchiveFactory_seeks(int fd, zzip_off_t offset, int whence)
-    {
-        if (fd == EMBED_IO_BAD_FILE_HANDLE)
-        {
-            // bad index - return an error - nonzero value.
-            return -1;
-        }
-        
-        zzip_size_t newPos = -1;
-        // get the current buffer in file;
-        EmbeddedFileData & curEmbeddedFileData = getEmbeddedFileDataByIndex(fd);
-        switch(whence)
-        {
-            case SEEK_CUR:
-                newPos = (zzip_size_t)(curEmbeddedFileData.curPos + offset);
-                break;
-            case SEEK_END:
-                newPos = (zzip_size_t)(curEmbeddedFileData.fileSize - offset);
-                break;
-            case SEEK_SET:
-                newPos = (zzip_size_t)offset;
-                break;
-            default:
-                // bad whence - return an error - nonzero value.
-                return -1;
-                break;
-        };
-        if (newPos >= curEmbeddedFileData.fileSize)
-        {
-            // bad whence - return an error - nonzero value.
-            return -1;
-        }
-
-        curEmbeddedFileData.curPos = newPos;
-        return newPos;
-    }
-    //-----------------------------------------------------------------------
-    // returns the file size
-    zzip_off_t EmbeddedZipArchiveFactory_filesize(int fd)
-    {
-        if (fd == EMBED_IO_BAD_FILE_HANDLE)
-        {
-            // bad index - return an error - nonzero value.
-            return -1;
-        }
-                // get the current buffer in file;
-        EmbeddedFileData & curEmbeddedFileData = getEmbeddedFileDataByIndex(fd);
-        return curEmbeddedFileData.fileSize;
-    }
-    //-----------------------------------------------------------------------
-    // writes data to the file
-    zzip_ssize_t EmbeddedZipArchiveFactory_write(int fd, _zzip_const void* buf, zzip_size_t len)
-    {
-        // the files in this case are read only - return an error  - nonzero value.
-        return -1;
+        EmbeddedFileDataMap& files = getEmbeddedFiles();
+        EmbeddedFileDataMap::const_iterator i = files.find(mName);
+        if (i == files.end())
+            return ZipFileReaderPtr();
+        return ZipFileReaderPtr(OGRE_NEW ZipFileReader(i->second.fileData, i->second.fileSize,
+            i->second.decryptFunc));
     }
-    } // namespace {
     //-----------------------------------------------------------------------
     EmbeddedZipArchiveFactory::EmbeddedZipArchiveFactory()
     {
-        // init static member
-        if (gPluginIo == NULL)
-        {
-            gPluginIo = &sEmbeddedZipArchiveFactory_PluginIo;
-            gPluginIo->fd.open = EmbeddedZipArchiveFactory_open;
-            gPluginIo->fd.close = EmbeddedZipArchiveFactory_close;
-            gPluginIo->fd.read = EmbeddedZipArchiveFactory_read;
-            gPluginIo->fd.seeks = EmbeddedZipArchiveFactory_seeks;
-            gPluginIo->fd.filesize = EmbeddedZipArchiveFactory_filesize;
-            gPluginIo->fd.write = EmbeddedZipArchiveFactory_write;
-            gPluginIo->fd.sys = 1;
-            gPluginIo->fd.type = 1;
-        }
     }
     //-----------------------------------------------------------------------
     EmbeddedZipArchiveFactory::~EmbeddedZipArchiveFactory()
@@ -737,8 +1100,7 @@ namespace {
     //-----------------------------------------------------------------------
     Archive *EmbeddedZipArchiveFactory::createInstance( const String& name, bool readOnly )
     {
-        ZipArchive * resZipArchive = OGRE_NEW ZipArchive(name, getType(), gPluginIo);
-        return resZipArchive;
+        return OGRE_NEW EmbeddedZipArchive(name, getType());
     }
     //-----------------------------------------------------------------------
     const String& EmbeddedZipArchiveFactory::getType(void) const
@@ -750,36 +1112,16 @@ namespace {
     void EmbeddedZipArchiveFactory::addEmbbeddedFile(const String& name, const uint8 * fileData, 
                                         size_t fileSize, DecryptEmbeddedZipFileFunc decryptFunc)
     {
-        static bool needToInit = true;
-        if(needToInit)
-        {
-            needToInit = false;
-
-            // we can't be sure when global variables get initialized
-            // meaning it is possible our list has not been init when this
-            // function is being called. The solution is to use local
-            // static members in this function an init the pointers for the
-            // global here. We know for use that the local static variables
-            // are create in this stage.
-            static FileNameToIndexMap sFileNameToIndexMap;
-            static EmbbedFileDataList sEmbbedFileDataList;
-            EmbeddedZipArchiveFactory_mFileNameToIndexMap = &sFileNameToIndexMap;
-            EmbeddedZipArchiveFactory_mEmbbedFileDataList = &sEmbbedFileDataList;
-        }
-
         EmbeddedFileData newEmbeddedFileData;
-        newEmbeddedFileData.curPos = 0;
-        newEmbeddedFileData.isFileOpened = false;
         newEmbeddedFileData.fileData = fileData;
         newEmbeddedFileData.fileSize = fileSize;
         newEmbeddedFileData.decryptFunc = decryptFunc;
-        EmbeddedZipArchiveFactory_mEmbbedFileDataList->push_back(newEmbeddedFileData);
-        (*EmbeddedZipArchiveFactory_mFileNameToIndexMap)[name] = static_cast<int>(EmbeddedZipArchiveFactory_mEmbbedFileDataList->size());
+        getEmbeddedFiles()[name] = newEmbeddedFileData;
     }
     //-----------------------------------------------------------------------
     void EmbeddedZipArchiveFactory::removeEmbbeddedFile( const String& name )
     {
-        EmbeddedZipArchiveFactory_mFileNameToIndexMap->erase(name);
+        getEmbeddedFiles().erase(name);
     }
 }
 
@@ -0,0 +1,959 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "Threading/OgreWorkStealingWorkQueue.h"
+#include "OgreTimer.h"
+
+namespace Ogre
+{
+    namespace
+    {
+        const size_t NO_WORKER = ~size_t(0);
+        /// Number of entries a worker moves from the injector to its own deque at once
+        const size_t INJECTOR_BATCH = 8;
+        /// Lane of priority 0
+        const size_t DEFAULT_LANE = WorkStealingWorkQueue::PRIORITY_LANES / 2;
+
+#if OGRE_THREAD_SUPPORT
+        // Identifies the worker thread, so requests added by handlers go to the local deque
+        thread_local const WorkStealingWorkQueue* tlsQueue = 0;
+        thread_local size_t tlsWorkerIdx = NO_WORKER;
+#endif
+    }
+    //---------------------------------------------------------------------
+    WorkStealingWorkQueue::WorkerDeque::WorkerDeque()
+        : mTop(0), mBottom(0)
+    {
+        Buffer* buf = OGRE_NEW_T(Buffer, MEMCATEGORY_GENERAL);
+        buf->mask = 255;
+        buf->slots = OGRE_NEW_ARRAY_T(AtomicScalar<InFlightRequest*>, 256, MEMCATEGORY_GENERAL);
+        mBuffer.store(buf);
+    }
+    //---------------------------------------------------------------------
+    WorkStealingWorkQueue::WorkerDeque::~WorkerDeque()
+    {
+        mRetired.push_back(mBuffer.load());
+        for (size_t i = 0; i < mRetired.size(); ++i)
+        {
+            OGRE_DELETE_ARRAY_T(mRetired[i]->slots, AtomicScalar<InFlightRequest*>, size_t(mRetired[i]->mask + 1),
+                MEMCATEGORY_GENERAL);
+            OGRE_DELETE_T(mRetired[i], Buffer, MEMCATEGORY_GENERAL);
+        }
+    }
+    //---------------------------------------------------------------------
+    WorkStealingWorkQueue::WorkerDeque::Buffer* WorkStealingWorkQueue::WorkerDeque::grow(
+        Buffer* old, int64 top, int64 bottom)
+    {
+        Buffer* buf = OGRE_NEW_T(Buffer, MEMCATEGORY_GENERAL);
+        buf->mask = old->mask * 2 + 1;
+        buf->slots = OGRE_NEW_ARRAY_T(AtomicScalar<InFlightRequest*>, size_t(buf->mask + 1), MEMCATEGORY_GENERAL);
+        for (int64 i = top; i < bottom; ++i)
+        {
+            buf->slots[i & buf->mask].store(old->slots[i & old->mask].load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+        }
+        mRetired.push_back(old);
+        mBuffer.store(buf, std::memory_order_release);
+        return buf;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::WorkerDeque::push(InFlightRequest* e)
+    {
+        int64 b = mBottom.load(std::memory_order_relaxed);
+        int64 t = mTop.load(std::memory_order_acquire);
+        Buffer* buf = mBuffer.load(std::memory_order_relaxed);
+        if (b - t > buf->mask)
+            buf = grow(buf, t, b);
+
+        buf->slots[b & buf->mask].store(e, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        mBottom.store(b + 1, std::memory_order_relaxed);
+    }
+    //---------------------------------------------------------------------
+    WorkStealingWorkQueue::InFlightRequest* WorkStealingWorkQueue::WorkerDeque::pop()
+    {
+        int64 b = mBottom.load(std::memory_order_relaxed) - 1;
+        Buffer* buf = mBuffer.load(std::memory_order_relaxed);
+        mBottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64 t = mTop.load(std::memory_order_relaxed);
+
+        InFlightRequest* e = 0;
+        if (t <= b)
+        {
+            e = buf->slots[b & buf->mask].load(std::memory_order_relaxed);
+            if (t == b)
+            {
+                // last entry, race against thieves
+                if (!mTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    e = 0;
+                mBottom.store(b + 1, std::memory_order_relaxed);
+            }
+        }
+        else
+        {
+            mBottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return e;
+    }
+    //---------------------------------------------------------------------
+    WorkStealingWorkQueue::InFlightRequest* WorkStealingWorkQueue::WorkerDeque::steal(bool& wasRaceLost)
+    {
+        wasRaceLost = false;
+        int64 t = mTop.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64 b = mBottom.load(std::memory_order_acquire);
+        if (t >= b)
+            return 0;
+
+        Buffer* buf = mBuffer.load(std::memory_order_acquire);
+        InFlightRequest* e = buf->slots[t & buf->mask].load(std::memory_order_relaxed);
+        if (!mTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            wasRaceLost = true;
+            return 0;
+        }
+        return e;
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    WorkStealingWorkQueue::InjectionRing::InjectionRing(size_t capacity)
+        : mMask(capacity - 1), mEnqueuePos(0), mDequeuePos(0)
+    {
+        assert((capacity & mMask) == 0 && "capacity must be a power of two");
+        mCells = OGRE_NEW_ARRAY_T(Cell, capacity, MEMCATEGORY_GENERAL);
+        for (size_t i = 0; i < capacity; ++i)
+            mCells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    //---------------------------------------------------------------------
+    WorkStealingWorkQueue::InjectionRing::~InjectionRing()
+    {
+        OGRE_DELETE_ARRAY_T(mCells, Cell, mMask + 1, MEMCATEGORY_GENERAL);
+    }
+    //---------------------------------------------------------------------
+    bool WorkStealingWorkQueue::InjectionRing::push(InFlightRequest* e)
+    {
+        size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true)
+        {
+            cell = &mCells[pos & mMask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0)
+            {
+                if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return false; // full
+            else
+                pos = mEnqueuePos.load(std::memory_order_relaxed);
+        }
+        cell->data = e;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+    //---------------------------------------------------------------------
+    WorkStealingWorkQueue::InFlightRequest* WorkStealingWorkQueue::InjectionRing::pop()
+    {
+        size_t pos = mDequeuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true)
+        {
+            cell = &mCells[pos & mMask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+            if (diff == 0)
+            {
+                if (mDequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return 0; // empty
+            else
+                pos = mDequeuePos.load(std::memory_order_relaxed);
+        }
+        InFlightRequest* e = cell->data;
+        cell->sequence.store(pos + mMask + 1, std::memory_order_release);
+        return e;
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    WorkStealingWorkQueue::PriorityLane::~PriorityLane()
+    {
+        for (size_t i = 0; i < deques.size(); ++i)
+            OGRE_DELETE deques[i];
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    WorkStealingWorkQueue::WorkStealingWorkQueue(const String& name)
+        : DefaultWorkQueueBase(name)
+        , mNextRequestID(0)
+        , mPendingCount(0)
+        , mStolenCount(0)
+        , mNextWorkerIndex(0)
+        , mNumThreadsRegisteredWithRS(0)
+        , mSleepingWorkers(0)
+    {
+        for (size_t i = 0; i < PRIORITY_LANES; ++i)
+            mLanes[i] = OGRE_NEW PriorityLane(i == DEFAULT_LANE ? INJECTOR_CAPACITY : PRIORITY_INJECTOR_CAPACITY);
+    }
+    //---------------------------------------------------------------------
+    WorkStealingWorkQueue::~WorkStealingWorkQueue()
+    {
+        shutdown();
+
+        // responses own their request, everything else is still owned by the registry
+        for (ResponseQueue::iterator i = mResponseQueue.begin(); i != mResponseQueue.end(); ++i)
+            OGRE_DELETE (*i);
+        mResponseQueue.clear();
+
+        // drop the queued copies first, so only the registry references remain
+        for (size_t l = 0; l < PRIORITY_LANES; ++l)
+        {
+            while (InFlightRequest* e = takeFromLane(l, NO_WORKER))
+                releaseRequest(e);
+        }
+        for (InFlightHeap::iterator i = mIdleQueue.begin(); i != mIdleQueue.end(); ++i)
+            releaseRequest(*i);
+        mIdleQueue.clear();
+
+        for (size_t s = 0; s < REGISTRY_SHARDS; ++s)
+        {
+            InFlightMap& requests = mRegistry[s].requests;
+            for (InFlightMap::iterator i = requests.begin(); i != requests.end(); ++i)
+            {
+                if (!i->second->response)
+                    OGRE_DELETE i->second->request;
+                OGRE_DELETE i->second;
+            }
+            requests.clear();
+        }
+
+        for (size_t l = 0; l < PRIORITY_LANES; ++l)
+            OGRE_DELETE mLanes[l];
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::startup(bool forceRestart)
+    {
+        if (mIsRunning)
+        {
+            if (forceRestart)
+                shutdown();
+            else
+                return;
+        }
+
+        mShuttingDown = false;
+
+        mWorkerFunc = OGRE_NEW_T(WorkerFunc(this), MEMCATEGORY_GENERAL);
+
+        LogManager::getSingleton().stream() <<
+            "WorkStealingWorkQueue('" << mName << "') initialising on thread " <<
+            OGRE_THREAD_CURRENT_ID
+            << ".";
+
+#if OGRE_THREAD_SUPPORT
+        // deques of a previous run may still hold requests, so they are kept
+        for (size_t l = 0; l < PRIORITY_LANES; ++l)
+        {
+            while (mLanes[l]->deques.size() < mWorkerThreadCount)
+                mLanes[l]->deques.push_back(OGRE_NEW WorkerDeque());
+        }
+        mNextWorkerIndex.store(0);
+
+        if (mWorkerRenderSystemAccess)
+            Root::getSingleton().getRenderSystem()->preExtraThreadsStarted();
+
+        mNumThreadsRegisteredWithRS = 0;
+        for (size_t i = 0; i < mWorkerThreadCount; ++i)
+        {
+            OGRE_THREAD_CREATE(t, *mWorkerFunc);
+            mWorkers.push_back(t);
+        }
+
+        if (mWorkerRenderSystemAccess)
+        {
+            OGRE_WQ_LOCK_MUTEX_NAMED(mInitMutex, initLock);
+            // have to wait until all threads are registered with the render system
+            while (mNumThreadsRegisteredWithRS < mWorkerThreadCount)
+                OGRE_THREAD_WAIT(mInitSync, mInitMutex, initLock);
+
+            Root::getSingleton().getRenderSystem()->postExtraThreadsStarted();
+        }
+#endif
+
+        mIsRunning = true;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::shutdown()
+    {
+        if (!mIsRunning)
+            return;
+
+        LogManager::getSingleton().stream() <<
+            "WorkStealingWorkQueue('" << mName << "') shutting down on thread " <<
+            OGRE_THREAD_CURRENT_ID
+            << ".";
+
+        {
+            // under the wake mutex so no worker misses the flag between its check and wait
+            OGRE_WQ_LOCK_MUTEX(mWakeMutex);
+            mShuttingDown = true;
+        }
+        abortAllRequests();
+#if OGRE_THREAD_SUPPORT
+        OGRE_THREAD_NOTIFY_ALL(mWakeCondition);
+
+        for (WorkerThreadList::iterator i = mWorkers.begin(); i != mWorkers.end(); ++i)
+        {
+            (*i)->join();
+            OGRE_THREAD_DESTROY(*i);
+        }
+        mWorkers.clear();
+#endif
+
+        OGRE_DELETE_T(mWorkerFunc, WorkerFunc, MEMCATEGORY_GENERAL);
+        mWorkerFunc = 0;
+
+        mIsRunning = false;
+    }
+    //---------------------------------------------------------------------
+    size_t WorkStealingWorkQueue::getCurrentWorkerIndex() const
+    {
+#if OGRE_THREAD_SUPPORT
+        if (tlsQueue == this)
+            return tlsWorkerIdx;
+#endif
+        return NO_WORKER;
+    }
+    //---------------------------------------------------------------------
+    WorkStealingWorkQueue::InFlightRequest* WorkStealingWorkQueue::registerRequest(Request* r, bool idle)
+    {
+        InFlightRequest* e = OGRE_NEW InFlightRequest(r, idle);
+        RegistryShard& shard = getShard(r->getID());
+        OGRE_WQ_LOCK_MUTEX(shard.mutex);
+        shard.requests[r->getID()] = e;
+        return e;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::unregisterRequest(RequestID id)
+    {
+        InFlightRequest* e = 0;
+        {
+            RegistryShard& shard = getShard(id);
+            OGRE_WQ_LOCK_MUTEX(shard.mutex);
+            InFlightMap::iterator i = shard.requests.find(id);
+            if (i != shard.requests.end())
+            {
+                e = i->second;
+                shard.requests.erase(i);
+            }
+        }
+        if (e)
+            releaseRequest(e);
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::releaseRequest(InFlightRequest* e)
+    {
+        if (--e->refs == 0)
+            OGRE_DELETE e;
+    }
+    //---------------------------------------------------------------------
+    bool WorkStealingWorkQueue::claimRequest(InFlightRequest* e, bool& wasAborted)
+    {
+        uint8 state = e->state.load();
+        while (true)
+        {
+            if (state == RS_REPRIORITISING)
+            {
+                // setRequestPriority holds it for a few instructions only
+                OGRE_THREAD_YIELD;
+                state = e->state.load();
+                continue;
+            }
+            if (state != RS_QUEUED && state != RS_ABORTED)
+                return false;
+            // a pending abort turns into an abort of the processed request
+            if (e->state.compare_exchange_strong(state, RS_PROCESSING))
+            {
+                wasAborted = state == RS_ABORTED;
+                return true;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    WorkQueue::RequestID WorkStealingWorkQueue::addRequest(uint16 channel, uint16 requestType,
+        const Any& rData, uint8 retryCount, bool forceSynchronous, bool idleThread, Real priority,
+        unsigned long deadlineMS)
+    {
+        if (!mAcceptRequests || mShuttingDown)
+            return 0;
+
+        RequestID rid = ++mNextRequestID;
+        Request* req = OGRE_NEW Request(channel, requestType, rData, retryCount, rid, priority,
+            calculateDeadline(deadlineMS));
+
+#if OGRE_THREAD_SUPPORT
+        if (!forceSynchronous)
+        {
+            InFlightRequest* e = registerRequest(req, idleThread);
+            if (idleThread)
+            {
+                bool notify;
+                {
+                    OGRE_WQ_LOCK_MUTEX(mIdleMutex);
+                    ++e->refs;
+                    pushHeap(mIdleQueue, e);
+                    notify = !mIdleThreadRunning;
+                }
+                if (notify)
+                    notifyWorkers();
+            }
+            else
+            {
+                pushRequest(e, getCurrentWorkerIndex());
+            }
+            return rid;
+        }
+#endif
+        // synchronous; retries are processed immediately as well
+        Response* response = dispatchRequest(req);
+        while (response && !response->succeeded() && req->getRetryCount())
+        {
+            Request* retry = OGRE_NEW Request(channel, requestType, req->getData(), req->getRetryCount() - 1, rid,
+                priority, req->getDeadline());
+            OGRE_DELETE response;
+            req = retry;
+            response = dispatchRequest(req);
+        }
+        if (response)
+        {
+            processResponse(response);
+            OGRE_DELETE response;
+        }
+        else
+        {
+            OGRE_DELETE req;
+        }
+        return rid;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::pushHeap(InFlightHeap& q, InFlightRequest* e)
+    {
+        q.push_back(e);
+        std::push_heap(q.begin(), q.end(), InFlightPriorityLess());
+    }
+    //---------------------------------------------------------------------
+    WorkStealingWorkQueue::InFlightRequest* WorkStealingWorkQueue::popHeap(InFlightHeap& q)
+    {
+        std::pop_heap(q.begin(), q.end(), InFlightPriorityLess());
+        InFlightRequest* e = q.back();
+        q.pop_back();
+        return e;
+    }
+    //---------------------------------------------------------------------
+    size_t WorkStealingWorkQueue::getLaneForPriority(Real priority)
+    {
+        if (priority == 0)
+            return DEFAULT_LANE;
+
+        // one lane per power of two away from the default priority
+        int exponent;
+        std::frexp(Math::Abs(priority) + 1, &exponent);
+        size_t level = exponent - 1;
+        if (priority > 0)
+            return DEFAULT_LANE + 1 + std::min(level, PRIORITY_LANES - DEFAULT_LANE - 2);
+        return DEFAULT_LANE - 1 - std::min(level, DEFAULT_LANE - 1);
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::pushRequest(InFlightRequest* e, size_t workerIdx)
+    {
+        size_t laneIdx = getLaneForPriority(e->request->getPriority());
+        e->lane.store(uint8(laneIdx));
+        pushToLane(e, laneIdx, workerIdx);
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::pushToLane(InFlightRequest* e, size_t laneIdx, size_t workerIdx)
+    {
+        PriorityLane& lane = *mLanes[laneIdx];
+        ++e->refs;
+        // counted before the push, so takers never see more entries than the counters
+        ++lane.pending;
+        ++mPendingCount;
+        if (workerIdx != NO_WORKER && workerIdx < lane.deques.size())
+        {
+            lane.deques[workerIdx]->push(e);
+        }
+        else if (!lane.injector.push(e))
+        {
+            OGRE_WQ_LOCK_MUTEX(lane.overflowMutex);
+            lane.overflow.push_back(e);
+            ++lane.overflowCount;
+        }
+        notifyWorkers();
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::notifyWorkers()
+    {
+        // Producers increment the pending count before checking for sleepers, workers
+        // register as sleeper before checking the pending count, so one side always
+        // sees the other.
+        if (mSleepingWorkers.load())
+        {
+            OGRE_WQ_LOCK_MUTEX(mWakeMutex);
+            OGRE_THREAD_NOTIFY_ONE(mWakeCondition);
+        }
+    }
+    //---------------------------------------------------------------------
+    WorkStealingWorkQueue::InFlightRequest* WorkStealingWorkQueue::takeFromLane(size_t laneIdx, size_t workerIdx)
+    {
+        PriorityLane& lane = *mLanes[laneIdx];
+        bool isWorker = workerIdx != NO_WORKER && workerIdx < lane.deques.size();
+
+        InFlightRequest* e = 0;
+        if (isWorker)
+            e = lane.deques[workerIdx]->pop();
+
+        if (!e && (e = lane.injector.pop()))
+        {
+            // move a few more over so peers can steal them from us
+            if (isWorker)
+            {
+                InFlightRequest* next;
+                for (size_t i = 1; i < INJECTOR_BATCH && (next = lane.injector.pop()); ++i)
+                    lane.deques[workerIdx]->push(next);
+            }
+        }
+
+        if (!e && lane.overflowCount.load())
+        {
+            OGRE_WQ_LOCK_MUTEX(lane.overflowMutex);
+            if (!lane.overflow.empty())
+            {
+                e = lane.overflow.front();
+                lane.overflow.pop_front();
+                --lane.overflowCount;
+            }
+        }
+
+        if (!e)
+        {
+            // steal, starting with the next worker so thieves spread out
+            size_t numDeques = lane.deques.size();
+            size_t start = workerIdx == NO_WORKER ? 0 : workerIdx + 1;
+            bool retry = true;
+            while (!e && retry)
+            {
+                retry = false;
+                for (size_t i = 0; i < numDeques && !e; ++i)
+                {
+                    size_t victim = (start + i) % numDeques;
+                    if (victim == workerIdx)
+                        continue;
+                    bool raceLost;
+                    e = lane.deques[victim]->steal(raceLost);
+                    retry |= raceLost;
+                }
+            }
+            if (e)
+                ++mStolenCount;
+        }
+
+        if (e)
+        {
+            --lane.pending;
+            --mPendingCount;
+        }
+        return e;
+    }
+    //---------------------------------------------------------------------
+    WorkStealingWorkQueue::InFlightRequest* WorkStealingWorkQueue::findRequest(size_t workerIdx, bool& wasAborted)
+    {
+        for (size_t l = PRIORITY_LANES; l-- > 0;)
+        {
+            while (mLanes[l]->pending.load())
+            {
+                InFlightRequest* e = takeFromLane(l, workerIdx);
+                if (!e)
+                    break;
+                // copies left behind by setRequestPriority, or already processed
+                if (e->lane.load() == l && claimRequest(e, wasAborted))
+                    return e;
+                releaseRequest(e);
+            }
+        }
+        return 0;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::_processNextRequest()
+    {
+        size_t workerIdx = getCurrentWorkerIndex();
+        if (processIdleRequests(workerIdx))
+            return;
+
+        bool aborted;
+        if (InFlightRequest* e = findRequest(workerIdx, aborted))
+        {
+            processInFlightRequest(e, aborted, workerIdx);
+            releaseRequest(e);
+        }
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::_threadMain()
+    {
+#if OGRE_THREAD_SUPPORT
+        tlsQueue = this;
+        tlsWorkerIdx = mNextWorkerIndex++;
+
+        LogManager::getSingleton().stream() <<
+            "WorkStealingWorkQueue('" << getName() << "')::WorkerFunc - thread "
+            << OGRE_THREAD_CURRENT_ID << " starting.";
+
+        // Initialise the thread for RS if necessary
+        if (mWorkerRenderSystemAccess)
+        {
+            Root::getSingleton().getRenderSystem()->registerThread();
+            OGRE_WQ_LOCK_MUTEX(mInitMutex);
+            ++mNumThreadsRegisteredWithRS;
+            OGRE_THREAD_NOTIFY_ALL(mInitSync);
+        }
+
+        while (!isShuttingDown())
+        {
+            if (processIdleRequests(tlsWorkerIdx))
+                continue;
+
+            bool aborted;
+            if (InFlightRequest* e = findRequest(tlsWorkerIdx, aborted))
+            {
+                processInFlightRequest(e, aborted, tlsWorkerIdx);
+                releaseRequest(e);
+            }
+            else
+            {
+                waitForNextRequest();
+            }
+        }
+
+        LogManager::getSingleton().stream() <<
+            "WorkStealingWorkQueue('" << getName() << "')::WorkerFunc - thread "
+            << OGRE_THREAD_CURRENT_ID << " stopped.";
+
+        tlsQueue = 0;
+        tlsWorkerIdx = NO_WORKER;
+#endif
+    }
+    //---------------------------------------------------------------------
+    bool WorkStealingWorkQueue::isIdleRequestAvailable()
+    {
+        OGRE_WQ_LOCK_MUTEX(mIdleMutex);
+        return !mIdleQueue.empty() && !mIdleThreadRunning;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::waitForNextRequest()
+    {
+#if OGRE_THREAD_SUPPORT
+        OGRE_WQ_LOCK_MUTEX_NAMED(mWakeMutex, wakeLock);
+        ++mSleepingWorkers;
+        if (mPendingCount.load() == 0 && !isIdleRequestAvailable() && !mShuttingDown)
+        {
+            OGRE_THREAD_WAIT(mWakeCondition, mWakeMutex, wakeLock);
+        }
+        else if (mPendingCount.load())
+        {
+            // an entry is being pushed or taken right now; don't spin on the deques
+            OGRE_THREAD_YIELD;
+        }
+        --mSleepingWorkers;
+#endif
+    }
+    //---------------------------------------------------------------------
+    WorkQueue::Response* WorkStealingWorkQueue::dispatchRequest(const Request* r)
+    {
+        RequestHandlerList handlers;
+        {
+            // copy only the handlers of this channel, to maximise parallelism
+            OGRE_WQ_LOCK_RW_MUTEX_READ(mRequestHandlerMutex);
+            RequestHandlerListByChannel::iterator i = mRequestHandlers.find(r->getChannel());
+            if (i == mRequestHandlers.end())
+                return 0;
+            handlers = i->second;
+        }
+
+        Response* response = 0;
+        for (RequestHandlerList::reverse_iterator j = handlers.rbegin(); j != handlers.rend() && !response; ++j)
+        {
+            // threadsafe call which tests canHandleRequest and calls it if so
+            response = (*j)->handleRequest(r, this);
+        }
+        return response;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::processInFlightRequest(InFlightRequest* e, bool wasAborted, size_t workerIdx)
+    {
+        if (wasAborted)
+            e->request->abortRequest();
+        else if (e->request->getDeadline() &&
+            e->request->isExpired(Root::getSingleton().getTimer()->getMilliseconds()))
+        {
+            // dropped like an aborted request, no response is sent
+            e->request->abortRequest();
+        }
+
+        Request* r = e->request;
+        RequestID rid = r->getID();
+        Response* response = dispatchRequest(r);
+
+        if (!response)
+        {
+            if (!r->getAborted())
+            {
+                LogManager::getSingleton().stream(LML_WARNING) <<
+                    "WorkStealingWorkQueue('" << mName << "') warning: no handler processed request "
+                    << rid << ", channel " << r->getChannel()
+                    << ", type " << r->getType();
+            }
+            unregisterRequest(rid);
+            OGRE_DELETE r;
+            return;
+        }
+
+        if (!response->succeeded() && r->getRetryCount() && !mShuttingDown)
+        {
+            Request* retry = OGRE_NEW Request(r->getChannel(), r->getType(), r->getData(),
+                r->getRetryCount() - 1, rid, r->getPriority(), r->getDeadline());
+            {
+                RegistryShard& shard = getShard(rid);
+                OGRE_WQ_LOCK_MUTEX(shard.mutex);
+                e->request = retry;
+                e->state.store(RS_QUEUED);
+            }
+            // discard response (this also deletes the old request)
+            OGRE_DELETE response;
+            pushRequest(e, workerIdx);
+            return;
+        }
+
+        if (r->getAborted())
+        {
+            // destroy response user data
+            response->abortRequest();
+        }
+        {
+            RegistryShard& shard = getShard(rid);
+            OGRE_WQ_LOCK_MUTEX(shard.mutex);
+            e->response = response;
+        }
+        OGRE_WQ_LOCK_MUTEX(mResponseMutex);
+        mResponseQueue.push_back(response);
+    }
+    //---------------------------------------------------------------------
+    bool WorkStealingWorkQueue::processIdleRequests(size_t workerIdx)
+    {
+        {
+            OGRE_WQ_LOCK_MUTEX(mIdleMutex);
+            if (mIdleQueue.empty() || mIdleThreadRunning)
+                return false;
+            mIdleThreadRunning = true;
+        }
+        InFlightRequest* e = 0;
+        try
+        {
+            while (true)
+            {
+                {
+                    OGRE_WQ_LOCK_MUTEX(mIdleMutex);
+                    if (mIdleQueue.empty())
+                    {
+                        mIdleThreadRunning = false;
+                        return true;
+                    }
+                    e = popHeap(mIdleQueue);
+                }
+                // idle entries are queued exactly once, so the claim cannot fail
+                bool aborted = false;
+                claimRequest(e, aborted);
+                processInFlightRequest(e, aborted, workerIdx);
+                releaseRequest(e);
+            }
+        }
+        catch (...)
+        {
+            // It is very important to clean up or the idle thread will be locked forever!
+            OGRE_WQ_LOCK_MUTEX(mIdleMutex);
+            mIdleThreadRunning = false;
+            LogManager::getSingleton().stream() << "Exception caught in top of worker thread!";
+            return true;
+        }
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::processResponses()
+    {
+        unsigned long msStart = Root::getSingleton().getTimer()->getMilliseconds();
+
+        // keep going until we run out of responses or out of time
+        while (true)
+        {
+            Response* response = 0;
+            {
+                OGRE_WQ_LOCK_MUTEX(mResponseMutex);
+                if (mResponseQueue.empty())
+                    break;
+                response = mResponseQueue.front();
+                mResponseQueue.pop_front();
+            }
+
+            // no longer abortable from here on
+            unregisterRequest(response->getRequest()->getID());
+            processResponse(response);
+            OGRE_DELETE response;
+
+            if (mResposeTimeLimitMS &&
+                Root::getSingleton().getTimer()->getMilliseconds() - msStart > mResposeTimeLimitMS)
+                break;
+        }
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::setRequestPriority(RequestID id, Real priority)
+    {
+        RegistryShard& shard = getShard(id);
+        OGRE_WQ_LOCK_MUTEX(shard.mutex);
+        InFlightMap::iterator i = shard.requests.find(id);
+        if (i == shard.requests.end())
+            return;
+
+        InFlightRequest* e = i->second;
+        if (e->idle)
+        {
+            OGRE_WQ_LOCK_MUTEX(mIdleMutex);
+            if (std::find(mIdleQueue.begin(), mIdleQueue.end(), e) != mIdleQueue.end())
+            {
+                e->request->_setPriority(priority);
+                std::make_heap(mIdleQueue.begin(), mIdleQueue.end(), InFlightPriorityLess());
+            }
+            return;
+        }
+
+        // keep workers off the entry while its priority and lane change
+        uint8 expected = RS_QUEUED;
+        if (!e->state.compare_exchange_strong(expected, RS_REPRIORITISING))
+            return;
+        e->request->_setPriority(priority);
+        size_t laneIdx = getLaneForPriority(priority);
+        bool moved = laneIdx != e->lane.load();
+        e->lane.store(uint8(laneIdx));
+        e->state.store(RS_QUEUED);
+
+        // the copy in the old lane becomes stale; whichever copy is taken first processes it
+        if (moved)
+            pushToLane(e, laneIdx, getCurrentWorkerIndex());
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::abortRequest(RequestID id)
+    {
+        RegistryShard& shard = getShard(id);
+        OGRE_WQ_LOCK_MUTEX(shard.mutex);
+        InFlightMap::iterator i = shard.requests.find(id);
+        if (i == shard.requests.end())
+            return;
+
+        if (i->second->response)
+            i->second->response->abortRequest();
+        else
+            i->second->request->abortRequest();
+    }
+    //---------------------------------------------------------------------
+    bool WorkStealingWorkQueue::abortPendingRequest(RequestID id)
+    {
+        RegistryShard& shard = getShard(id);
+        OGRE_WQ_LOCK_MUTEX(shard.mutex);
+        InFlightMap::iterator i = shard.requests.find(id);
+        if (i == shard.requests.end())
+            return false;
+
+        // a worker that picks the request up concurrently sees RS_ABORTED and aborts it as well
+        uint8 expected = RS_QUEUED;
+        if (!i->second->state.compare_exchange_strong(expected, RS_ABORTED) && expected != RS_ABORTED)
+            return false;
+        i->second->request->abortRequest();
+        return true;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::abortRequestsByChannel(uint16 channel)
+    {
+        for (size_t s = 0; s < REGISTRY_SHARDS; ++s)
+        {
+            OGRE_WQ_LOCK_MUTEX(mRegistry[s].mutex);
+            InFlightMap& requests = mRegistry[s].requests;
+            for (InFlightMap::iterator i = requests.begin(); i != requests.end(); ++i)
+            {
+                if (i->second->request->getChannel() != channel)
+                    continue;
+                if (i->second->response)
+                    i->second->response->abortRequest();
+                else
+                    i->second->request->abortRequest();
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::abortPendingRequestsByChannel(uint16 channel)
+    {
+        for (size_t s = 0; s < REGISTRY_SHARDS; ++s)
+        {
+            OGRE_WQ_LOCK_MUTEX(mRegistry[s].mutex);
+            InFlightMap& requests = mRegistry[s].requests;
+            for (InFlightMap::iterator i = requests.begin(); i != requests.end(); ++i)
+            {
+                if (i->second->request->getChannel() != channel)
+                    continue;
+                uint8 expected = RS_QUEUED;
+                if (i->second->state.compare_exchange_strong(expected, RS_ABORTED))
+                    i->second->request->abortRequest();
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingWorkQueue::abortAllRequests()
+    {
+        for (size_t s = 0; s < REGISTRY_SHARDS; ++s)
+        {
+            OGRE_WQ_LOCK_MUTEX(mRegistry[s].mutex);
+            InFlightMap& requests = mRegistry[s].requests;
+            for (InFlightMap::iterator i = requests.begin(); i != requests.end(); ++i)
+            {
+                if (i->second->response)
+                    i->second->response->abortRequest();
+                else
+                    i->second->request->abortRequest();
+            }
+        }
+    }
+}
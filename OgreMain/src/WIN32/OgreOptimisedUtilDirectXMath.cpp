@@ -159,6 +159,31 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+
+        /// @copydoc OptimisedUtil::cullAxisAlignedBoxes
+        virtual void cullAxisAlignedBoxes(
+            const Plane* planes, size_t numPlanes,
+            const float* const centres[3],
+            const float* const halfSizes[3],
+            uint32* visibility,
+            size_t numBoxes);
+
+        /// @copydoc OptimisedUtil::cullSpheres
+        virtual void cullSpheres(
+            const Plane* planes, size_t numPlanes,
+            const float* const centres[3],
+            const float* radii,
+            uint32* visibility,
+            size_t numSpheres);
+
+        /// @copydoc OptimisedUtil::expandBillboardQuads
+        virtual void expandBillboardQuads(
+            const float* centres,
+            const float* offsets, size_t offsetStride,
+            const uint32* colours,
+            const float* texcoordRects,
+            float* dest,
+            size_t numBillboards);
     };
 
 //---------------------------------------------------------------------
@@ -2032,6 +2057,42 @@ static OGRE_FORCE_INLINE bool _isAlignedForDirectXMath(const void *p)
         }
     }
     //---------------------------------------------------------------------
+    extern OptimisedUtil* _getOptimisedUtilGeneral(void);
+    void OptimisedUtilDirectXMath::cullAxisAlignedBoxes(
+        const Plane* planes, size_t numPlanes,
+        const float* const centres[3],
+        const float* const halfSizes[3],
+        uint32* visibility,
+        size_t numBoxes)
+    {
+        // No DirectXMath version yet
+        _getOptimisedUtilGeneral()->cullAxisAlignedBoxes(
+            planes, numPlanes, centres, halfSizes, visibility, numBoxes);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilDirectXMath::cullSpheres(
+        const Plane* planes, size_t numPlanes,
+        const float* const centres[3],
+        const float* radii,
+        uint32* visibility,
+        size_t numSpheres)
+    {
+        _getOptimisedUtilGeneral()->cullSpheres(
+            planes, numPlanes, centres, radii, visibility, numSpheres);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilDirectXMath::expandBillboardQuads(
+        const float* centres,
+        const float* offsets, size_t offsetStride,
+        const uint32* colours,
+        const float* texcoordRects,
+        float* dest,
+        size_t numBillboards)
+    {
+        _getOptimisedUtilGeneral()->expandBillboardQuads(
+            centres, offsets, offsetStride, colours, texcoordRects, dest, numBillboards);
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilDirectXMath(void)
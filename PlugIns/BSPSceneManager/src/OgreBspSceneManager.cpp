@@ -57,6 +57,9 @@ namespace Ogre {
         // Set features for debugging render
         mShowNodeAABs = false;
 
+        // BspSceneNode::_update tracks moving objects
+        mParallelSceneGraphUpdateSupported = false;
+
         // No sky by default
         mSkyPlaneEnabled = false;
         mSkyBoxEnabled = false;
@@ -394,10 +394,16 @@ namespace Ogre {
     Codec::DecodeResult FreeImageCodec::decode(const DataStreamPtr& input) const
     {
         // Buffer stream into memory (TODO: override IO functions instead?)
-        MemoryDataStream memStream(input, true);
+        // unless it already is, e.g. a memory mapped file, in which case
+        // decode from the current position and consume the rest of the stream
+        MemoryDataStreamPtr memStream = dynamic_pointer_cast<MemoryDataStream>(input);
+        if (!memStream)
+            memStream.reset(OGRE_NEW MemoryDataStream(input, true));
 
+        size_t size = memStream->size() - memStream->tell();
         FIMEMORY* fiMem = 
-            FreeImage_OpenMemory(memStream.getPtr(), static_cast<DWORD>(memStream.size()));
+            FreeImage_OpenMemory(memStream->getCurrentPtr(), static_cast<DWORD>(size));
+        memStream->skip(static_cast<long>(size));
 
         FIBITMAP* fiBitmap = FreeImage_LoadFromMemory(
             (FREE_IMAGE_FORMAT)mFreeImageType, fiMem);
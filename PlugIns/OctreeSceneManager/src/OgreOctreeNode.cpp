@@ -36,6 +36,7 @@ email                : janders@users.sf.net
 
 #include "OgreOctreeNode.h"
 #include "OgreOctreeSceneManager.h"
+#include "OgreSceneQueryBroadPhase.h"
 
 namespace Ogre
 {
@@ -135,6 +136,13 @@ void OctreeNode::_updateBounds( void )
         static_cast < OctreeSceneManager * > ( mCreator ) -> _updateOctreeNode( this );
     }
 
+    // the default intersection query uses the broad-phase index
+    if ( ! mObjectsByName.empty() )
+    {
+        SceneQueryBroadPhase* broadPhase = mCreator->_getSceneQueryBroadPhase( false );
+        if ( broadPhase )
+            broadPhase->_notifyNodeUpdated( this );
+    }
 }
 
 /** Since we are loose, only check the center.
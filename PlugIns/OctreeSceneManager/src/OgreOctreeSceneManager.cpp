@@ -294,6 +294,8 @@ const String& OctreeSceneManager::getTypeName(void) const
 
 void OctreeSceneManager::init( AxisAlignedBox &box, int depth )
 {
+    // OctreeNode::_updateBounds moves nodes between octants
+    mParallelNodeBoundsUpdate = false;
 
     if ( mOctree != 0 )
         OGRE_DELETE mOctree;
@@ -609,17 +611,26 @@ void OctreeSceneManager::walkOctree( OctreeCamera *camera, RenderQueue *queue,
             mBoxes.push_back( octant->getWireBoundingBox() );
         }
 
-        bool vis = true;
+        uint32 visibleMask = 0xFFFFFFFF;
+        size_t index = 0;
 
         while ( it != octant -> mNodes.end() )
         {
             OctreeNode * sn = *it;
 
             // if this octree is partially visible, manually cull all
-            // scene nodes attached directly to this level.
+            // scene nodes attached directly to this level, 32 at a time.
 
-            if ( v == OctreeCamera::PARTIAL )
-                vis = camera -> isVisible( sn -> _getWorldAABB() );
+            if ( v == OctreeCamera::PARTIAL && index % 32 == 0 )
+            {
+                size_t count = std::min( octant -> mNodes.size() - index, size_t( 32 ) );
+                const AxisAlignedBox* boxes[ 32 ];
+                for ( size_t i = 0; i < count; ++i )
+                    boxes[ i ] = &octant -> mNodes[ index + i ] -> _getWorldAABB();
+                camera -> isVisible( count, boxes, &visibleMask );
+            }
+
+            bool vis = ( visibleMask & ( 1u << ( index % 32 ) ) ) != 0;
 
             if ( vis )
             {
@@ -638,6 +649,7 @@ void OctreeSceneManager::walkOctree( OctreeCamera *camera, RenderQueue *queue,
             }
 
             ++it;
+            ++index;
         }
 
         Octree* child;
@@ -55,7 +55,10 @@ namespace Ogre
     mShowPortals(false),
     mZoneFactoryManager(0),
     mActiveCameraZone(0)
-    { }
+    {
+        // zones are updated by our own _updateSceneGraph
+        mParallelSceneGraphUpdateSupported = false;
+    }
 
     PCZSceneManager::~PCZSceneManager()
     {
@@ -88,6 +88,9 @@ namespace Ogre {
         /** See ParticleAffector. */
         void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
 
+        /** See ParticleAffector. */
+        bool _affectParticlesSoA(ParticleSystem* pSystem, ParticleSoA& particles, Real timeElapsed);
+
         /** Sets the colour adjustment to be made per second to particles. 
         @param red, green, blue, alpha
             Sets the adjustment to be made to each of the colour components per second. These
@@ -162,6 +165,15 @@ namespace Ogre {
             }
         }
 
+        /** Internal method for adjusting an array of components while clamping to [0,1] */
+        inline void applyAdjustWithClamp(float* pComponents, size_t count, float adjust)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                pComponents[i] = std::min(std::max(pComponents[i] + adjust, 0.0f), 1.0f);
+            }
+        }
+
     };
 
     /** @} */
@@ -51,6 +51,9 @@ namespace Ogre {
         /** Default constructor. */
         ColourImageAffector(ParticleSystem* psys);
 
+        /** See ParticleAffector. */
+        void _prepareUpdate(void);
+
         /** See ParticleAffector. */
         void _initParticle(Particle* pParticle);
 
@@ -85,6 +85,9 @@ namespace Ogre {
         /** See ParticleAffector. */
         void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
 
+        /** See ParticleAffector. */
+        bool _affectParticlesSoA(ParticleSystem* pSystem, ParticleSoA& particles, Real timeElapsed);
+
 
         /** Sets the force vector to apply to the particles in a system. */
         void setForceVector(const Vector3& force);
@@ -90,6 +90,9 @@ namespace Ogre {
         /** See ParticleAffector. */
         void _affectParticles(ParticleSystem* pSystem, Real timeElapsed);
 
+        /** See ParticleAffector. */
+        bool _affectParticlesSoA(ParticleSystem* pSystem, ParticleSoA& particles, Real timeElapsed);
+
 
 
         /** Sets the minimum rotation speed of particles to be emitted. */
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgreParticleSoA.h"
 
 
 namespace Ogre {
@@ -90,6 +91,21 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    bool ColourFaderAffector::_affectParticlesSoA(ParticleSystem* pSystem, ParticleSoA& particles, Real timeElapsed)
+    {
+        size_t count = particles.size();
+        if (!count)
+            return true;
+
+        // Scale adjustments by time
+        applyAdjustWithClamp(&particles.mColourR[0], count, mRedAdj * timeElapsed);
+        applyAdjustWithClamp(&particles.mColourG[0], count, mGreenAdj * timeElapsed);
+        applyAdjustWithClamp(&particles.mColourB[0], count, mBlueAdj * timeElapsed);
+        applyAdjustWithClamp(&particles.mColourA[0], count, mAlphaAdj * timeElapsed);
+
+        return true;
+    }
+    //-----------------------------------------------------------------------
     void ColourFaderAffector::setAdjust(float red, float green, float blue, float alpha)
     {
         mRedAdj = red;
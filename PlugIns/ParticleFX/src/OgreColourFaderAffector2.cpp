@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgreParticleSoA.h"
 
 
 namespace Ogre {
@@ -139,6 +140,37 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    bool ColourFaderAffector2::_affectParticlesSoA(ParticleSystem* pSystem, ParticleSoA& particles, Real timeElapsed)
+    {
+        size_t count = particles.size();
+        if (!count)
+            return true;
+
+        const Real* timeToLive = &particles.mTimeToLive[0];
+        float* colours[4] = { &particles.mColourR[0], &particles.mColourG[0],
+            &particles.mColourB[0], &particles.mColourA[0] };
+
+        // Scale adjustments by time
+        const float adjust1[4] = { mRedAdj1 * timeElapsed, mGreenAdj1 * timeElapsed,
+            mBlueAdj1 * timeElapsed, mAlphaAdj1 * timeElapsed };
+        const float adjust2[4] = { mRedAdj2 * timeElapsed, mGreenAdj2 * timeElapsed,
+            mBlueAdj2 * timeElapsed, mAlphaAdj2 * timeElapsed };
+
+        for (int c = 0; c < 4; ++c)
+        {
+            float* colour = colours[c];
+            const float d1 = adjust1[c];
+            const float d2 = adjust2[c];
+            for (size_t i = 0; i < count; ++i)
+            {
+                float v = colour[i] + (timeToLive[i] > StateChangeVal ? d1 : d2);
+                colour[i] = std::min(std::max(v, 0.0f), 1.0f);
+            }
+        }
+
+        return true;
+    }
+    //-----------------------------------------------------------------------
     void ColourFaderAffector2::setAdjust1(float red, float green, float blue, float alpha)
     {
         mRedAdj1 = red;
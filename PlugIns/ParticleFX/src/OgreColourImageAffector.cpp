@@ -52,6 +52,15 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void ColourImageAffector::_prepareUpdate(void)
+    {
+        // Load on the main thread, the update may run on a worker
+        if (!mColourImageLoaded)
+        {
+            _loadImage();
+        }
+    }
+    //-----------------------------------------------------------------------
     void ColourImageAffector::_initParticle(Particle* pParticle)
     {
         if (!mColourImageLoaded)
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreLinearForceAffector.h"
 #include "OgreParticleSystem.h"
 #include "OgreParticle.h"
+#include "OgreParticleSoA.h"
 #include "OgreStringConverter.h"
 
 
@@ -95,6 +96,40 @@ namespace Ogre {
         
     }
     //-----------------------------------------------------------------------
+    bool LinearForceAffector::_affectParticlesSoA(ParticleSystem* pSystem, ParticleSoA& particles, Real timeElapsed)
+    {
+        size_t count = particles.size();
+        if (!count)
+            return true;
+
+        Real* dirX = &particles.mDirectionX[0];
+        Real* dirY = &particles.mDirectionY[0];
+        Real* dirZ = &particles.mDirectionZ[0];
+
+        if (mForceApplication == FA_ADD)
+        {
+            // Scale force by time
+            Vector3 scaledVector = mForceVector * timeElapsed;
+            for (size_t i = 0; i < count; ++i)
+            {
+                dirX[i] += scaledVector.x;
+                dirY[i] += scaledVector.y;
+                dirZ[i] += scaledVector.z;
+            }
+        }
+        else // FA_AVERAGE
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                dirX[i] = (dirX[i] + mForceVector.x) * 0.5f;
+                dirY[i] = (dirY[i] + mForceVector.y) * 0.5f;
+                dirZ[i] = (dirZ[i] + mForceVector.z) * 0.5f;
+            }
+        }
+
+        return true;
+    }
+    //-----------------------------------------------------------------------
     void LinearForceAffector::setForceVector(const Vector3& force)
     {
         mForceVector = force;
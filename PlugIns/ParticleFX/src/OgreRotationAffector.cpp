@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgreParticleSoA.h"
 
 
 namespace Ogre {
@@ -107,6 +108,33 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    bool RotationAffector::_affectParticlesSoA(ParticleSystem* pSystem, ParticleSoA& particles, Real timeElapsed)
+    {
+        size_t count = particles.size();
+        if (!count)
+            return true;
+
+        Real* rotation = &particles.mRotation[0];
+        const Real* rotationSpeed = &particles.mRotationSpeed[0];
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            rotation[i] += timeElapsed * rotationSpeed[i];
+        }
+
+        // Equivalent of Particle::setRotation, which only notifies for non-zero rotations
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (rotation[i] != 0)
+            {
+                pSystem->_notifyParticleRotated();
+                break;
+            }
+        }
+
+        return true;
+    }
+    //-----------------------------------------------------------------------
     const Radian& RotationAffector::getRotationSpeedRangeStart(void) const
     {
         return mRotationSpeedRangeStart;
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgreParticleSoA.h"
 
 
 namespace Ogre {
@@ -85,6 +86,34 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    bool ScaleAffector::_affectParticlesSoA(ParticleSystem* pSystem, ParticleSoA& particles, Real timeElapsed)
+    {
+        size_t count = particles.size();
+        if (!count)
+            return true;
+
+        // Scale adjustments by time
+        Real ds = mScaleAdj * timeElapsed;
+        Real defaultWide = pSystem->getDefaultWidth();
+        Real defaultHigh = pSystem->getDefaultHeight();
+
+        Real* width = &particles.mWidth[0];
+        Real* height = &particles.mHeight[0];
+        uint8* ownDimensions = &particles.mOwnDimensions[0];
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            width[i] = (ownDimensions[i] ? width[i] : defaultWide) + ds;
+            height[i] = (ownDimensions[i] ? height[i] : defaultHigh) + ds;
+            ownDimensions[i] = 1;
+        }
+
+        // Equivalent of Particle::setDimensions on every particle
+        pSystem->_notifyParticleResized();
+
+        return true;
+    }
+    //-----------------------------------------------------------------------
     void ScaleAffector::setAdjust( Real rate )
     {
         mScaleAdj = rate;
@@ -37,6 +37,14 @@ THE SOFTWARE.
 #define STBI_NEON
 #endif
 
+// decoded images are handed to MemoryDataStream, which frees them with OGRE_FREE
+#define STBI_MALLOC(sz) OGRE_MALLOC(sz, Ogre::MEMCATEGORY_GENERAL)
+#define STBI_REALLOC(p, sz) OGRE_REALLOC(p, sz, Ogre::MEMCATEGORY_GENERAL)
+#define STBI_FREE(p) OGRE_FREE(p, Ogre::MEMCATEGORY_GENERAL)
+#define STBIW_MALLOC(sz) OGRE_MALLOC(sz, Ogre::MEMCATEGORY_GENERAL)
+#define STBIW_REALLOC(p, sz) OGRE_REALLOC(p, sz, Ogre::MEMCATEGORY_GENERAL)
+#define STBIW_FREE(p) OGRE_FREE(p, Ogre::MEMCATEGORY_GENERAL)
+
 #define STBI_NO_STDIO
 #define STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_STATIC
@@ -47,11 +55,11 @@ THE SOFTWARE.
 static Ogre::uchar* custom_zlib_compress(Ogre::uchar* data, int data_len, int* out_len, int /*quality*/)
 {
     unsigned long destLen = compressBound(data_len);
-    Ogre::uchar* dest = (Ogre::uchar*)malloc(destLen);
+    Ogre::uchar* dest = (Ogre::uchar*)STBIW_MALLOC(destLen);
     int ret = compress(dest, &destLen, data, data_len); // use default quality
     if (ret != Z_OK)
     {
-        free(dest);
+        STBIW_FREE(dest);
         OGRE_EXCEPT(Ogre::Exception::ERR_INTERNAL_ERROR, "compress failed", __FUNCTION__);
     }
 
@@ -175,11 +183,27 @@ namespace Ogre {
     //---------------------------------------------------------------------
     Codec::DecodeResult STBIImageCodec::decode(const DataStreamPtr& input) const
     {
-        String contents = input->getAsString();
+        // decode in place if the data is already in memory (e.g. a mapped file),
+        // starting at the current position and consuming the rest of the stream
+        String contents;
+        const uchar* data;
+        size_t size;
+        if (MemoryDataStream* memStream = dynamic_cast<MemoryDataStream*>(input.get()))
+        {
+            data = memStream->getCurrentPtr();
+            size = memStream->size() - memStream->tell();
+            memStream->skip(static_cast<long>(size));
+        }
+        else
+        {
+            contents = input->getAsString();
+            data = (const uchar*)contents.data();
+            size = contents.size();
+        }
 
         int width, height, components;
-        stbi_uc* pixelData = stbi_load_from_memory((uchar*)contents.data(),
-                static_cast<int>(contents.size()), &width, &height, &components, 0);
+        stbi_uc* pixelData = stbi_load_from_memory(data,
+                static_cast<int>(size), &width, &height, &components, 0);
 
         if (!pixelData)
         {
@@ -32,6 +32,75 @@ THE SOFTWARE.
 
 // Register the test suite
 
+namespace
+{
+    /// Collection which claims a fixed amount of memory
+    class SizedPageContentCollection : public PageContentCollection
+    {
+    public:
+        SizedPageContentCollection(PageContentCollectionFactory* creator)
+            : PageContentCollection(creator) {}
+
+        void save(StreamSerialiser& stream) {}
+        void frameStart(Real timeSinceLastFrame) {}
+        void frameEnd(Real timeElapsed) {}
+        void notifyCamera(Camera* cam) {}
+        bool prepare(StreamSerialiser& ser) { return true; }
+        void load() {}
+        void unload() {}
+        void unprepare() {}
+        size_t getMemoryUsage() const { return 400; }
+    };
+
+    class SizedPageContentCollectionFactory : public PageContentCollectionFactory
+    {
+    public:
+        const String& getName() const { static const String name("Sized"); return name; }
+        PageContentCollection* createInstance() { return OGRE_NEW SizedPageContentCollection(this); }
+        void destroyInstance(PageContentCollection* c) { OGRE_DELETE c; }
+    };
+
+    /// Provider which lets every page load without a file
+    class EmptyPageProvider : public PageProvider
+    {
+    public:
+        bool prepareProceduralPage(Page* page, PagedWorldSection* section) { return true; }
+    };
+
+    /// Section which keeps 400 bytes per page outside the content collections
+    class SizedPagedWorldSection : public PagedWorldSection
+    {
+    public:
+        SizedPagedWorldSection(const String& name, PagedWorld* parent, SceneManager* sm)
+            : PagedWorldSection(name, parent, sm)
+        {
+            setStrategy(parent->getManager()->getStrategy("Grid2D"));
+        }
+
+        size_t getPageMemoryUsage(Page* p) const { return 400; }
+    };
+
+    class SizedPagedWorldSectionFactory : public PagedWorldSectionFactory
+    {
+    public:
+        const String& getName() const { static const String name("Sized"); return name; }
+        PagedWorldSection* createInstance(const String& name, PagedWorld* parent, SceneManager* sm)
+        {
+            return OGRE_NEW SizedPagedWorldSection(name, parent, sm);
+        }
+        void destroyInstance(PagedWorldSection* s) { OGRE_DELETE s; }
+    };
+
+    void renderFrame(Root* root)
+    {
+        FrameEvent evt;
+        evt.timeSinceLastEvent = evt.timeSinceLastFrame = 0;
+        root->_fireFrameStarted(evt);
+        root->_fireFrameRenderingQueued(evt);
+        root->_fireFrameEnded(evt);
+    }
+}
+
 //--------------------------------------------------------------------------
 void PageCoreTests::SetUp()
 {    
@@ -92,3 +161,91 @@ TEST_F(PageCoreTests,SimpleCreateSaveLoadWorld)
 }
 //--------------------------------------------------------------------------
 
+TEST_F(PageCoreTests,MemoryBudgetEviction)
+{
+    SizedPageContentCollectionFactory factory;
+    EmptyPageProvider provider;
+    mPageManager->addContentCollectionFactory(&factory);
+    mPageManager->setPageProvider(&provider);
+    mPageManager->setMemoryBudget(1000);
+
+    PagedWorld* world = mPageManager->createWorld();
+    PagedWorldSection* section = world->createSection("Grid2D", mSceneMgr);
+    for (PageID id = 0; id < 3; ++id)
+    {
+        section->loadPage(id, true);
+        section->getPage(id)->createContentCollection("Sized");
+    }
+    EXPECT_EQ(1200u, mPageManager->getMemoryUsage());
+    EXPECT_EQ(3u, mPageManager->getStatistics().misses);
+    EXPECT_EQ(3u, mPageManager->getStatistics().loads);
+
+    // page 0 stays requested and page 2 held, page 1 is released and evicted first
+    for (int f = 0; f < 10; ++f)
+    {
+        section->loadPage(0);
+        section->holdPage(2);
+        renderFrame(mRoot);
+    }
+    EXPECT_TRUE(section->getPage(1) == 0);
+    EXPECT_TRUE(section->getPage(0) != 0);
+    EXPECT_TRUE(section->getPage(2) != 0);
+    EXPECT_EQ(800u, mPageManager->getMemoryUsage());
+
+    // held pages go next, requested ones never
+    mPageManager->setMemoryBudget(500);
+    section->loadPage(0);
+    section->holdPage(2);
+    renderFrame(mRoot);
+    EXPECT_TRUE(section->getPage(2) == 0);
+    EXPECT_EQ(2u, mPageManager->getStatistics().evictions);
+    EXPECT_EQ(1200u, mPageManager->getStatistics().peakMemoryUsage);
+
+    // released pages within budget stay resident and count as hits
+    for (int f = 0; f < 10; ++f)
+        renderFrame(mRoot);
+    ASSERT_TRUE(section->getPage(0) != 0);
+    EXPECT_FALSE(section->getPage(0)->isHeld());
+    section->loadPage(0);
+    EXPECT_EQ(1u, mPageManager->getStatistics().hits);
+    EXPECT_EQ(3u, mPageManager->getStatistics().misses);
+
+    mPageManager->destroyWorld(world);
+    mPageManager->setPageProvider(0);
+    mPageManager->removeContentCollectionFactory(&factory);
+}
+//--------------------------------------------------------------------------
+
+TEST_F(PageCoreTests,MemoryBudgetSectionUsage)
+{
+    SizedPagedWorldSectionFactory factory;
+    EmptyPageProvider provider;
+    mPageManager->addWorldSectionFactory(&factory);
+    mPageManager->setPageProvider(&provider);
+    mPageManager->setMemoryBudget(300);
+
+    PagedWorld* world = mPageManager->createWorld();
+    PagedWorldSection* section = world->createSection(mSceneMgr, "Sized");
+    section->loadPage(0, true);
+    section->loadPage(1, true);
+    EXPECT_EQ(800u, mPageManager->getMemoryUsage());
+
+    // the work queue is not running, so page 1 stays in preparation
+    section->getPage(1)->load(false);
+    ASSERT_TRUE(section->getPage(1)->isDeferredProcessInProgress());
+
+    // held pages may be evicted, but not while they are being prepared
+    for (int f = 0; f < 10; ++f)
+    {
+        section->holdPage(1);
+        renderFrame(mRoot);
+    }
+    EXPECT_TRUE(section->getPage(0) == 0);
+    EXPECT_TRUE(section->getPage(1) != 0);
+    EXPECT_EQ(1u, mPageManager->getStatistics().evictions);
+
+    mPageManager->destroyWorld(world);
+    mPageManager->setPageProvider(0);
+    mPageManager->removeWorldSectionFactory(&factory);
+}
+//--------------------------------------------------------------------------
@@ -27,6 +27,10 @@ THE SOFTWARE.
 */
 #include "TerrainTests.h"
 #include "OgreTerrain.h"
+#include "OgreTerrainGroup.h"
+#include "OgreTerrainLodManager.h"
+#include "OgreTerrainQuadTreeNode.h"
+#include "OgreStreamSerialiser.h"
 #include "OgreConfigFile.h"
 #include "OgreResourceGroupManager.h"
 #include "OgreLogManager.h"
@@ -99,3 +103,419 @@ TEST_F(TerrainTests, create)
     ASSERT_TRUE(1);
 }
 //--------------------------------------------------------------------------
+namespace
+{
+    Terrain* createHillTerrain(SceneManager* sceneMgr, const Vector3& pos, float ridgeHeight)
+    {
+        const uint16 size = 129;
+        float* heights = OGRE_ALLOC_T(float, size * size, MEMCATEGORY_GEOMETRY);
+        for (uint16 y = 0; y < size; ++y)
+        {
+            for (uint16 x = 0; x < size; ++x)
+            {
+                heights[y * size + x] = 40 * Math::Sin(x * 0.11f) * Math::Cos(y * 0.07f) + 40;
+                // a ridge along the western edge
+                if (x < 4)
+                    heights[y * size + x] += ridgeHeight;
+            }
+        }
+
+        Terrain* t = OGRE_NEW Terrain(sceneMgr);
+        Terrain::ImportData imp;
+        imp.inputFloat = heights;
+        imp.deleteInputData = true;
+        imp.terrainSize = size;
+        imp.worldSize = 1000;
+        imp.minBatchSize = 17;
+        imp.maxBatchSize = 65;
+        imp.pos = pos;
+        t->prepare(imp);
+        return t;
+    }
+
+    size_t countShadowedTexels(Terrain* t)
+    {
+        Rect finalRect;
+        Rect all(0, 0, t->getSize(), t->getSize());
+        PixelBox* box = t->calculateLightmap(all, Rect(0, 0, 0, 0), finalRect);
+        EXPECT_EQ(t->getLightmapSize(), finalRect.width());
+        size_t shadowed = 0;
+        for (size_t i = 0; i < box->getConsecutiveSize(); ++i)
+            shadowed += static_cast<uint8*>(box->data)[i] == 0;
+        OGRE_FREE(box->data, MEMCATEGORY_GENERAL);
+        OGRE_DELETE box;
+        return shadowed;
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, lightmapHorizonSweep)
+{
+    mTerrainOpts->setLightMapSize(256);
+    Terrain* west = createHillTerrain(mSceneMgr, Vector3::ZERO, 0);
+    Terrain* east = createHillTerrain(mSceneMgr, Vector3(1000, 0, 0), 150);
+    west->setNeighbour(Terrain::NEIGHBOUR_EAST, east);
+
+    // low light from the east, so the ridge of the east terrain shadows the west one
+    mTerrainOpts->setLightMapDirection(Vector3(-1, -0.25f, 0.3f).normalisedCopy());
+    size_t numTexels = west->getLightmapSize() * west->getLightmapSize();
+    size_t shadowed = countShadowedTexels(west);
+    EXPECT_LT(numTexels / 20, shadowed);
+    EXPECT_GT(numTexels - numTexels / 20, shadowed);
+    EXPECT_LT(west->compareLightmapMethods(), 0.03f);
+
+    // shadows cast across the terrain boundary are found by both methods
+    mTerrainOpts->setLightMapDirection(Vector3(-1, -0.5f, 0).normalisedCopy());
+    EXPECT_LT(west->compareLightmapMethods(), 0.03f);
+    west->setNeighbour(Terrain::NEIGHBOUR_EAST, 0);
+    EXPECT_GT(shadowed, countShadowedTexels(west));
+
+    mTerrainOpts->setUseRayCastLightmap(true);
+    EXPECT_LT(0u, countShadowedTexels(west));
+
+    OGRE_DELETE east;
+    OGRE_DELETE west;
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, derivedDataKernels)
+{
+    for (int align = 0; align < 3; ++align)
+    {
+        Terrain* t = OGRE_NEW Terrain(mSceneMgr);
+        Terrain::ImportData imp;
+        imp.inputFloat = OGRE_ALLOC_T(float, 129 * 129, MEMCATEGORY_GEOMETRY);
+        imp.deleteInputData = true;
+        for (int i = 0; i < 129 * 129; ++i)
+            imp.inputFloat[i] = 30 * Math::Sin((i % 129) * 0.2f) * Math::Cos((i / 129) * 0.13f) + (i % 7);
+        imp.terrainSize = 129;
+        imp.worldSize = 1000;
+        imp.minBatchSize = 17;
+        imp.maxBatchSize = 65;
+        imp.terrainAlign = static_cast<Terrain::Alignment>(align);
+        t->prepare(imp);
+
+        // normals read from the height data match the plane based evaluation
+        Rect all(0, 0, 129, 129), finalRect;
+        PixelBox* normals = t->calculateNormals(all, finalRect);
+        for (long y = 1; y < 128; y += 7)
+        {
+            for (long x = 1; x < 128; x += 5)
+            {
+                Vector3 centre, adjacent[9];
+                const long ringX[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+                const long ringY[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+                t->getPoint(x, y, &centre);
+                for (int i = 0; i < 8; ++i)
+                    t->getPoint(x + ringX[i], y + ringY[i], &adjacent[i]);
+                adjacent[8] = adjacent[0];
+                Vector3 expected = Vector3::ZERO;
+                for (int i = 0; i < 8; ++i)
+                    expected += Plane(centre, adjacent[i], adjacent[i + 1]).normal;
+                expected.normalise();
+
+                const uint8* stored = static_cast<const uint8*>(normals->data) + ((128 - y) * 129 + x) * 3;
+                for (int c = 0; c < 3; ++c)
+                    EXPECT_NEAR((expected[c] + 1.0f) * 0.5f * 255.0f, stored[c], 1.0f);
+            }
+        }
+        OGRE_FREE(normals->data, MEMCATEGORY_GENERAL);
+        OGRE_DELETE normals;
+
+        // recalculating the deltas of separate edits only is the same as
+        // recalculating the area bounding them
+        for (long y = 10; y < 14; ++y)
+            for (long x = 8; x < 20; ++x)
+                *t->getHeightData(x, y) += 12;
+        for (long y = 100; y < 120; ++y)
+            for (long x = 90; x < 93; ++x)
+                *t->getHeightData(x, y) -= 20;
+        Terrain::RectList edits;
+        edits.push_back(Rect(8, 10, 20, 14));
+        edits.push_back(Rect(90, 100, 93, 120));
+        t->calculateHeightDeltas(edits);
+        std::vector<float> tiledDeltas(t->getDeltaData(), t->getDeltaData() + 129 * 129);
+        t->calculateHeightDeltas(Rect(8, 10, 93, 120));
+        for (int i = 0; i < 129 * 129; ++i)
+            ASSERT_EQ(t->getDeltaData()[i], tiledDeltas[i]);
+
+        OGRE_DELETE t;
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, rayIntersectsHeightBounds)
+{
+    Terrain* t = createHillTerrain(mSceneMgr, Vector3::ZERO, 0);
+
+    // rays descending from all sides within the terrain stop where they first reach the surface
+    for (int i = 0; i < 64; ++i)
+    {
+        Radian angle(Math::TWO_PI * i / 64);
+        Vector3 target((i * 37 % 64 - 32) * 5.5f, 0, (i * 11 % 64 - 32) * 5.5f);
+        target.y = t->getHeightAtWorldPosition(target) - 1;
+        Vector3 origin(target.x + Math::Cos(angle) * 300, 90 + (i % 4) * 30, target.z + Math::Sin(angle) * 300);
+        Ray ray(origin, (target - origin).normalisedCopy());
+        std::pair<bool, Vector3> hit = t->rayIntersects(ray);
+        ASSERT_TRUE(hit.first);
+        EXPECT_NEAR(t->getHeightAtWorldPosition(hit.second), hit.second.y, 0.01f);
+        Real hitDist = origin.distance(hit.second);
+        EXPECT_LT(hitDist, origin.distance(target));
+        for (Real d = 0; d < hitDist - 1; d += 1)
+        {
+            Vector3 p = ray.getPoint(d);
+            ASSERT_GT(p.y, t->getHeightAtWorldPosition(p) - 0.01f);
+        }
+    }
+
+    // lowering a hilltop updates the bounds used to skip empty space
+    long x = 14, y = 90;
+    Vector3 target;
+    t->getPoint(x, y, &target);
+    target.y -= 30;
+    // a shallow ray which only clears the hilltop once it has been lowered
+    Vector3 origin = target + Vector3(-55, 12, 0);
+    Ray ray(origin, (target - origin).normalisedCopy());
+
+    Rect area(x - 8, y - 8, x + 9, y + 9);
+    for (long py = area.top; py < area.bottom; ++py)
+        for (long px = area.left; px < area.right; ++px)
+            *t->getHeightData(px, py) = target.y;
+    t->dirtyRect(area);
+    std::pair<bool, Vector3> hit = t->rayIntersects(ray);
+    ASSERT_TRUE(hit.first);
+    EXPECT_LT(hit.second.distance(target), 0.01f);
+
+    OGRE_DELETE t;
+}
+//--------------------------------------------------------------------------
+namespace
+{
+    /// Fills slots with prepared terrains, since loading them needs a render system
+    class PreparedTerrainGroup : public TerrainGroup
+    {
+    public:
+        PreparedTerrainGroup(SceneManager* sm) : TerrainGroup(sm, Terrain::ALIGN_X_Z, 129, 1000) {}
+
+        void definePreparedTerrain(long x, long y)
+        {
+            TerrainSlot* slot = getTerrainSlot(x, y, true);
+            slot->instance = createHillTerrain(getSceneManager(), getTerrainSlotPosition(x, y), 0);
+        }
+    };
+
+    void expectSameResult(const TerrainGroup::RayResult& expected, const TerrainGroup::RayResult& actual)
+    {
+        EXPECT_EQ(expected.hit, actual.hit);
+        EXPECT_EQ(expected.terrain, actual.terrain);
+        EXPECT_TRUE(expected.position.positionEquals(actual.position, 0.001f));
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, groupBatchedQueries)
+{
+    PreparedTerrainGroup group(mSceneMgr);
+    group.definePreparedTerrain(0, 0);
+    group.definePreparedTerrain(1, 0);
+    group.definePreparedTerrain(0, 1);
+    group.definePreparedTerrain(1, 1);
+
+    // more rays than one task takes, descending across slot borders, along with
+    // some which point up into the sky or start over empty slots
+    TerrainGroup::RayList rays;
+    for (int i = 0; i < 300; ++i)
+    {
+        Radian angle(Math::TWO_PI * i / 300);
+        Vector3 origin((i * 37 % 150) * 13.0f - 600, 120 + (i % 5) * 40, (i * 53 % 150) * 13.0f - 600);
+        Vector3 dir(Math::Cos(angle), i % 7 ? -0.4f - (i % 3) * 0.3f : 0.5f, Math::Sin(angle));
+        rays.push_back(Ray(origin, dir.normalisedCopy()));
+    }
+
+    TerrainGroup::RayResultList results;
+    for (int limit = 0; limit < 2; ++limit)
+    {
+        Real distanceLimit = limit * 400.0f;
+        group.rayIntersects(rays, results, distanceLimit);
+        ASSERT_EQ(rays.size(), results.size());
+        size_t hits = 0;
+        for (size_t i = 0; i < rays.size(); ++i)
+        {
+            expectSameResult(group.rayIntersects(rays[i], distanceLimit), results[i]);
+            hits += results[i].hit;
+        }
+        EXPECT_GT(hits, 0u);
+        EXPECT_LT(hits, rays.size());
+    }
+
+    // segments along the same rays, ending just before and just past the surface
+    TerrainGroup::SegmentList segments;
+    TerrainGroup::RayResultList expected;
+    for (size_t i = 0; i < rays.size(); ++i)
+    {
+        TerrainGroup::RayResult hit = group.rayIntersects(rays[i]);
+        if (!hit.hit)
+        {
+            segments.push_back(TerrainGroup::Segment(rays[i].getOrigin(), rays[i].getPoint(500)));
+            expected.push_back(hit);
+            continue;
+        }
+        Real dist = rays[i].getOrigin().distance(hit.position);
+        segments.push_back(TerrainGroup::Segment(rays[i].getOrigin(), rays[i].getPoint(dist - 1)));
+        expected.push_back(TerrainGroup::RayResult(false, 0, Vector3::ZERO));
+        segments.push_back(TerrainGroup::Segment(rays[i].getOrigin(), rays[i].getPoint(dist + 1)));
+        expected.push_back(hit);
+    }
+    // a degenerate segment never hits
+    segments.push_back(TerrainGroup::Segment(Vector3(0, 500, 0), Vector3(0, 500, 0)));
+    expected.push_back(TerrainGroup::RayResult(false, 0, Vector3::ZERO));
+
+    group.segmentIntersects(segments, results);
+    ASSERT_EQ(segments.size(), results.size());
+    for (size_t i = 0; i < segments.size(); ++i)
+        expectSameResult(expected[i], results[i]);
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, lodDataEncoding)
+{
+    // heights quantised like an imported image, and continuous ones of either sign
+    const size_t count = 4096;
+    std::vector<float> quantised(count), continuous(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        quantised[i] = (int)(100 + 90 * Math::Sin(i * 0.01f)) / 255.0f * 600.0f;
+        continuous[i] = 40 * Math::Sin(i * 0.013f) + (i % 7) * 0.01f;
+    }
+    continuous[5] = 0.0f;
+    continuous[6] = -0.0f;
+
+    const std::vector<float>* inputs[2] = { &quantised, &continuous };
+    for (int i = 0; i < 2; ++i)
+    {
+        const std::vector<float>& input = *inputs[i];
+        DataStreamPtr stream(OGRE_NEW MemoryDataStream(count * sizeof(float) * 2));
+        {
+            StreamSerialiser ser(stream);
+            ser.writeChunkBegin(TerrainLodManager::TERRAINLODDATA_CHUNK_ID, TerrainLodManager::TERRAINLODDATA_CHUNK_VERSION);
+            TerrainLodManager::encodeLodData(ser, &input[0], count);
+            ser.writeChunkEnd(TerrainLodManager::TERRAINLODDATA_CHUNK_ID);
+        }
+        size_t encodedSize = stream->tell();
+        // palette indices take two bytes per value
+        if (i == 0)
+            EXPECT_GT(count * 3, encodedSize);
+
+        std::vector<float> output(count);
+        stream->seek(0);
+        {
+            StreamSerialiser ser(stream);
+            ser.readChunkBegin(TerrainLodManager::TERRAINLODDATA_CHUNK_ID, TerrainLodManager::TERRAINLODDATA_CHUNK_VERSION);
+            TerrainLodManager::decodeLodData(ser, &output[0], count);
+            ser.readChunkEnd(TerrainLodManager::TERRAINLODDATA_CHUNK_ID);
+        }
+        EXPECT_EQ(0, memcmp(&input[0], &output[0], count * sizeof(float)));
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, lodDataStreaming)
+{
+    Terrain* t = createHillTerrain(mSceneMgr, Vector3::ZERO, 0);
+    uint16 numLodLevels = t->getNumLodLevels();
+    ASSERT_GT(numLodLevels, 2);
+
+    // the parts of a saved terrain the LOD data is streamed from, the rest of
+    // Terrain::save needs the GPU resources of a loaded terrain
+    DataStreamPtr saved(OGRE_NEW MemoryDataStream(1024 * 1024));
+    {
+        StreamSerialiser ser(saved);
+        ser.writeChunkBegin(Terrain::TERRAIN_CHUNK_ID, Terrain::TERRAIN_CHUNK_VERSION);
+        ser.writeChunkBegin(Terrain::TERRAINGENERALINFO_CHUNK_ID, Terrain::TERRAINGENERALINFO_CHUNK_VERSION);
+        ser.writeChunkEnd(Terrain::TERRAINGENERALINFO_CHUNK_ID);
+        TerrainLodManager::saveLodData(ser, t);
+        ser.writeChunkEnd(Terrain::TERRAIN_CHUNK_ID);
+    }
+
+    // read it like load(lod) and a later increase of the LOD level do
+    // into a terrain of the same size with other deltas, and no heights
+    Terrain* loaded = createHillTerrain(mSceneMgr, Vector3::ZERO, 50);
+    memset(loaded->getHeightData(), 0, t->getSize() * t->getSize() * sizeof(float));
+    ASSERT_NE(0, memcmp(t->getDeltaData(), loaded->getDeltaData(), t->getSize() * t->getSize() * sizeof(float)));
+    // read only, like an opened file, or the deflate stream would expect writes
+    saved->seek(0);
+    DataStreamPtr stream(OGRE_NEW MemoryDataStream(saved, true, true));
+    TerrainLodManager lodMgr(loaded, stream);
+    const uint16 lod = numLodLevels / 2;
+    lodMgr.readLodData(numLodLevels - 1, lod);
+
+    const long size = t->getSize(), inc = 1 << lod;
+    size_t missing = 0;
+    for (long y = 0; y < size; ++y)
+    {
+        for (long x = 0; x < size; ++x)
+        {
+            if (x % inc == 0 && y % inc == 0)
+            {
+                ASSERT_EQ(t->getHeightAtPoint(x, y), loaded->getHeightAtPoint(x, y)) << x << " " << y;
+                ASSERT_EQ(*t->getDeltaData(x, y), *loaded->getDeltaData(x, y)) << x << " " << y;
+            }
+            else
+                missing += t->getHeightAtPoint(x, y) != loaded->getHeightAtPoint(x, y);
+        }
+    }
+    EXPECT_GT(missing, 0u);
+
+    lodMgr.readLodData(lod - 1, 0);
+    size_t bytes = size * size * sizeof(float);
+    EXPECT_EQ(0, memcmp(t->getHeightData(), loaded->getHeightData(), bytes));
+    EXPECT_EQ(0, memcmp(t->getDeltaData(), loaded->getDeltaData(), bytes));
+
+    // a stream without the LOD data chunks
+    DataStreamPtr truncated(OGRE_NEW MemoryDataStream(1024));
+    {
+        StreamSerialiser ser(truncated);
+        ser.writeChunkBegin(Terrain::TERRAIN_CHUNK_ID, Terrain::TERRAIN_CHUNK_VERSION);
+        ser.writeChunkBegin(Terrain::TERRAINGENERALINFO_CHUNK_ID, Terrain::TERRAINGENERALINFO_CHUNK_VERSION);
+        ser.writeChunkEnd(Terrain::TERRAINGENERALINFO_CHUNK_ID);
+        ser.writeChunkBegin(Terrain::TERRAINDERIVEDDATA_CHUNK_ID, Terrain::TERRAINDERIVEDDATA_CHUNK_VERSION);
+        ser.writeChunkEnd(Terrain::TERRAINDERIVEDDATA_CHUNK_ID);
+        ser.writeChunkEnd(Terrain::TERRAIN_CHUNK_ID);
+    }
+    truncated->seek(0);
+    DataStreamPtr truncatedRead(OGRE_NEW MemoryDataStream(truncated, true, true));
+    TerrainLodManager truncatedMgr(loaded, truncatedRead);
+    EXPECT_THROW(truncatedMgr.readLodData(numLodLevels - 1, 0), InvalidParametersException);
+
+    // a palette without entries
+    DataStreamPtr emptyPalette(OGRE_NEW MemoryDataStream(64));
+    {
+        StreamSerialiser ser(emptyPalette);
+        uint8 encoding = 0;
+        uint32 paletteSize = 0;
+        ser.write(&encoding);
+        ser.write(&paletteSize);
+    }
+    emptyPalette->seek(0);
+    {
+        StreamSerialiser ser(emptyPalette);
+        float value;
+        EXPECT_THROW(TerrainLodManager::decodeLodData(ser, &value, 1), InvalidParametersException);
+    }
+
+    OGRE_DELETE loaded;
+    OGRE_DELETE t;
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, memoryUsage)
+{
+    Terrain* t = createHillTerrain(mSceneMgr, Vector3::ZERO, 0);
+    size_t heightBytes = t->getSize() * t->getSize() * sizeof(float);
+
+    // heights, deltas and the CPU vertex data of the quadtree
+    size_t vertexBytes = t->getQuadTree()->getMemoryUsage();
+    EXPECT_GT(vertexBytes, 0u);
+    EXPECT_GE(t->getMemoryUsage(), 2 * heightBytes + vertexBytes);
+
+    size_t prepared = t->getMemoryUsage();
+    t->unprepare();
+    EXPECT_EQ(0u, t->getQuadTree()->getMemoryUsage());
+    EXPECT_EQ(prepared - vertexBytes, t->getMemoryUsage());
+
+    OGRE_DELETE t;
+}
+//--------------------------------------------------------------------------
@@ -42,4 +42,16 @@ public:
     void TearDown();
 };
 
+/** Archive with a stored entry, a deflated entry spanning several reads and a directory */
+class ZipArchiveMixedTests : public ::testing::Test
+{
+protected:
+    Ogre::String archivePath;
+
+    /// Check listing, reading and lookup of the entries
+    void checkArchive(Ogre::Archive* arch);
+public:
+    void SetUp();
+};
+
 #endif
@@ -0,0 +1,144 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreSceneNode.h"
+#include "OgreEntity.h"
+#include "OgreAnimationPrePass.h"
+#include "OgreAnimationState.h"
+#include "OgreSkeletonInstance.h"
+#include "OgreBone.h"
+#include "OgreSubEntity.h"
+#include "OgreMesh.h"
+#include "OgreSubMesh.h"
+#include "OgreRenderQueue.h"
+#include "OgreThreadPool.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+typedef RootWithoutRenderSystemFixture AnimationPrePassTest;
+
+namespace
+{
+/// only the animation update of _updateRenderQueue is of interest, there are no techniques
+struct RejectRenderables : public RenderQueue::RenderableListener
+{
+    bool renderableQueued(Renderable*, uint8, ushort, Technique**, RenderQueue*) { return false; }
+};
+}
+
+static bool sameVertexData(const VertexData* a, const VertexData* b)
+{
+    const VertexElement* elem = a->vertexDeclaration->findElementBySemantic(VES_POSITION);
+    HardwareVertexBufferSharedPtr bufA = a->vertexBufferBinding->getBuffer(elem->getSource());
+    HardwareVertexBufferSharedPtr bufB = b->vertexBufferBinding->getBuffer(elem->getSource());
+    bool same = memcmp(bufA->lock(HardwareBuffer::HBL_READ_ONLY),
+                       bufB->lock(HardwareBuffer::HBL_READ_ONLY),
+                       std::min(bufA->getSizeInBytes(), bufB->getSizeInBytes())) == 0;
+    bufA->unlock();
+    bufB->unlock();
+    return same;
+}
+
+TEST_F(AnimationPrePassTest, SameAsSerial)
+{
+    mRoot->getThreadPool()->setNumWorkerThreads(3);
+    SceneManager* sm = mRoot->createSceneManager();
+    sm->setParallelAnimationUpdate(true);
+    AnimationPrePass* prePass = sm->_getAnimationPrePass();
+    ASSERT_TRUE(prePass);
+
+    // pairs of entities updated serially and by the pre-pass, the last ones share a skeleton
+    std::vector<Entity*> entities[2];
+    for (int i = 0; i < 6; ++i)
+    {
+        for (int m = 0; m < 2; ++m)
+        {
+            Entity* ent = sm->createEntity("robot.mesh");
+            sm->getRootSceneNode()->createChildSceneNode()->attachObject(ent);
+            if (i >= 4)
+                ent->shareSkeletonInstanceWith(entities[m][3]);
+            entities[m].push_back(ent);
+            if (i >= 4)
+                continue;
+
+            AnimationState* state = ent->getAnimationState(i % 2 ? "Walk" : "Idle");
+            state->setEnabled(true);
+            state->setTimePosition(0.3f * i);
+            if (i == 2)
+            {
+                // manual bones are updated as well
+                Bone* bone = ent->getSkeleton()->getBone(1);
+                bone->setManuallyControlled(true);
+                bone->roll(Degree(30));
+            }
+        }
+    }
+
+    RejectRenderables reject;
+    RenderQueue* queue = sm->getRenderQueue();
+    queue->setRenderableListener(&reject);
+    for (Entity* ent : entities[0])
+        ent->_updateRenderQueue(queue);
+
+    prePass->begin();
+    for (Entity* ent : entities[1])
+    {
+        // queued once even if seen by several cameras
+        ent->_updateRenderQueue(queue);
+        ent->_updateRenderQueue(queue);
+    }
+    prePass->end(mRoot->getThreadPool());
+    EXPECT_EQ(entities[1].size(), prePass->getNumEntities());
+
+    for (size_t i = 0; i < entities[0].size(); ++i)
+    {
+        Entity* serial = entities[0][i];
+        Entity* parallel = entities[1][i];
+        EXPECT_FALSE(parallel->getSkeleton()->getManualBonesDirty());
+        if (serial->getMesh()->sharedVertexData)
+        {
+            EXPECT_TRUE(sameVertexData(serial->_getSkelAnimVertexData(),
+                                       parallel->_getSkelAnimVertexData()));
+            // and actually animated
+            EXPECT_FALSE(sameVertexData(serial->_getSkelAnimVertexData(),
+                                        serial->getMesh()->sharedVertexData));
+        }
+        for (size_t s = 0; s < serial->getNumSubEntities(); ++s)
+        {
+            SubMesh* sub = serial->getMesh()->getSubMesh(s);
+            if (sub->useSharedVertices)
+                continue;
+            const VertexData* vdata = serial->getSubEntity(s)->_getSkelAnimVertexData();
+            EXPECT_TRUE(sameVertexData(vdata, parallel->getSubEntity(s)->_getSkelAnimVertexData()));
+            EXPECT_FALSE(sameVertexData(vdata, sub->vertexData));
+        }
+    }
+}
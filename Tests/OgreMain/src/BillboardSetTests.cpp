@@ -0,0 +1,163 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreSceneNode.h"
+#include "OgreCamera.h"
+#include "OgreBillboardSet.h"
+#include "OgreBillboard.h"
+#include "OgreRenderQueue.h"
+#include "OgreThreadPool.h"
+#include "OgreMaterialManager.h"
+#include "OgreDefaultHardwareBufferManager.h"
+
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1600)
+#include <random>
+using std::minstd_rand;
+#else
+#include <tr1/random>
+using std::tr1::minstd_rand;
+#endif
+
+using namespace Ogre;
+
+namespace
+{
+/// only the vertices written by _updateRenderQueue are of interest, there are no techniques
+struct RejectRenderables : public RenderQueue::RenderableListener
+{
+    bool renderableQueued(Renderable*, uint8, ushort, Technique**, RenderQueue*) { return false; }
+};
+}
+
+static std::vector<float> getBillboardVertices(BillboardSet* set)
+{
+    RenderOperation op;
+    set->getRenderOperation(op);
+    HardwareVertexBufferSharedPtr buf = op.vertexData->vertexBufferBinding->getBuffer(0);
+    size_t numFloats = op.vertexData->vertexCount * buf->getVertexSize() / sizeof(float);
+    const float* data = static_cast<const float*>(buf->lock(HardwareBuffer::HBL_READ_ONLY));
+    std::vector<float> ret(data, data + numFloats);
+    buf->unlock();
+    return ret;
+}
+
+TEST(BillboardSet,batchedVertexGeneration)
+{
+    Root root;
+    DefaultHardwareBufferManager hbm;
+    MaterialManager::getSingleton().initialise();
+    root.getThreadPool()->setNumWorkerThreads(3);
+    SceneManager* mgr = root.createSceneManager();
+
+    Camera* cam = mgr->createCamera("cam");
+    SceneNode* camNode = mgr->getRootSceneNode()->createChildSceneNode(Vector3(100, 200, 3000));
+    camNode->attachObject(cam);
+    camNode->lookAt(Vector3::ZERO, Node::TS_WORLD);
+
+    const size_t count = 5000;
+    BillboardSet* sets[3];
+    for (int s = 0; s < 3; ++s)
+    {
+        sets[s] = mgr->createBillboardSet(count);
+        mgr->getRootSceneNode()->createChildSceneNode(Vector3(10, 0, 0))->attachObject(sets[s]);
+        sets[s]->setDefaultDimensions(30, 20);
+        sets[s]->setBillboardOrigin(BBO_BOTTOM_LEFT);
+        sets[s]->_notifyCurrentCamera(cam);
+    }
+
+    // every third billboard has its own size, every fifth is rotated
+    minstd_rand rng;
+    std::vector<Billboard> billboards;
+    for (size_t i = 0; i < count; ++i)
+    {
+        Vector3 pos(float(rng() % 4000), float(rng() % 4000), float(rng() % 4000));
+        billboards.push_back(Billboard(pos - 2000, sets[0], ColourValue(0.5f, float(i % 7) / 7, 1, 0.25f)));
+        Billboard& bb = billboards.back();
+        bb.mDirection = Vector3(float(rng() % 100), float(rng() % 100), 1).normalisedCopy();
+        bb.setTexcoordRect(0.25f, 0.5f, 0.75f, float(i % 3) / 3);
+        if (i % 3 == 0)
+            bb.setDimensions(float(rng() % 50), float(rng() % 50));
+        if (i % 5 == 0)
+            bb.setRotation(Degree(float(rng() % 360)));
+    }
+    sets[1]->_notifyBillboardResized();
+    sets[1]->_notifyBillboardRotated();
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Billboard& bb = billboards[i];
+        Billboard* own = sets[2]->createBillboard(bb.getPosition(), bb.getColour());
+        own->mDirection = bb.mDirection;
+        own->setTexcoordRect(bb.getTexcoordRect());
+        if (bb.hasOwnDimensions())
+            own->setDimensions(bb.getOwnWidth(), bb.getOwnHeight());
+        own->setRotation(bb.getRotation());
+    }
+    // only the vertices are of interest, there is nothing to render with
+    RenderQueue queue;
+    RejectRenderables listener;
+    queue.setRenderableListener(&listener);
+
+    const BillboardType types[] = {BBT_POINT, BBT_ORIENTED_COMMON, BBT_ORIENTED_SELF,
+                                   BBT_PERPENDICULAR_COMMON, BBT_PERPENDICULAR_SELF};
+    for (int variant = 0; variant < 5 * 4; ++variant)
+    {
+        for (int s = 0; s < 3; ++s)
+        {
+            sets[s]->setBillboardType(types[variant % 5]);
+            sets[s]->setUseAccurateFacing(variant % 2 == 1);
+            sets[s]->setBillboardRotationType(variant / 5 % 2 ? BBR_VERTEX : BBR_TEXCOORD);
+            sets[s]->setCullIndividually(variant / 10 == 1);
+        }
+
+        sets[0]->beginBillboards(count);
+        for (size_t i = 0; i < count; ++i)
+            sets[0]->injectBillboard(billboards[i]);
+        sets[0]->endBillboards();
+
+        sets[1]->beginBillboards(count);
+        sets[1]->injectBillboards(&billboards[0], count);
+        sets[1]->endBillboards();
+
+        // the set's own billboards take the batched path when it is rendered
+        queue.clear();
+        sets[2]->_updateRenderQueue(&queue);
+
+        std::vector<float> serial = getBillboardVertices(sets[0]);
+        std::vector<float> batched = getBillboardVertices(sets[1]);
+        EXPECT_GT(serial.size(), 0u);
+        EXPECT_EQ(serial.size(), batched.size());
+        EXPECT_TRUE(serial == batched) << "variant " << variant;
+        EXPECT_TRUE(serial == getBillboardVertices(sets[2])) << "variant " << variant;
+    }
+
+    queue.setRenderableListener(0);
+    root.destroySceneManager(mgr);
+}
@@ -0,0 +1,216 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreSkeletonManager.h"
+#include "OgreSkeleton.h"
+#include "OgreBone.h"
+#include "OgreAnimation.h"
+#include "OgreAnimationTrack.h"
+#include "OgreKeyFrame.h"
+#include "OgreCompressedTransformKeys.h"
+#include "OgreSkeletonSerializer.h"
+#include "OgreTimer.h"
+#include "OgreLogManager.h"
+
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1600)
+#include <random>
+using std::minstd_rand;
+#else
+#include <tr1/random>
+using std::tr1::minstd_rand;
+#endif
+
+using namespace Ogre;
+
+static void createTestTrack(NodeAnimationTrack* track, minstd_rand& rng, int numKeys, Real length)
+{
+    // smooth motion with a constant scale, followed by a stretch of linear motion
+    Real phase = float(rng() % 100) / 10;
+    Vector3 axis = Vector3(1, float(rng() % 3), 1).normalisedCopy();
+    for (int k = 0; k < numKeys; ++k)
+    {
+        Real t = length * k / (numKeys - 1);
+        TransformKeyFrame* kf = track->createNodeKeyFrame(t);
+        Real s = std::min(t, length / 2);
+        kf->setTranslate(Vector3(std::sin(s + phase), std::cos(s * 2), s) * 10 + Vector3(t - s, 2 * (t - s), 0));
+        kf->setRotation(Quaternion(Radian(std::sin(s * 3 + phase)), axis));
+        kf->setScale(Vector3(1, 2, 1));
+    }
+}
+
+TEST(CompressedTransformKeys,packRotation)
+{
+    minstd_rand rng;
+    for (int i = 0; i < 1000; ++i)
+    {
+        Quaternion q(float(rng() % 2001) - 1000, float(rng() % 2001) - 1000,
+                     float(rng() % 2001) - 1000, float(rng() % 2001) - 1000);
+        q.normalise();
+        Quaternion p = CompressedTransformKeys::unpackRotation(CompressedTransformKeys::packRotation(q));
+        // the sign is kept for interpolation without the shortest path
+        EXPECT_NEAR(1, q.Dot(p), 1e-6);
+    }
+}
+
+TEST(CompressedTransformKeys,sampleAndSerialise)
+{
+    Root root;
+    SkeletonPtr skel = SkeletonManager::getSingleton().create("compressedKeys", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    for (int i = 0; i < 4; ++i)
+        skel->createBone("bone" + StringConverter::toString(i), i);
+
+    minstd_rand rng;
+    Animation* anim = skel->createAnimation("anim", 10);
+    for (int i = 0; i < 4; ++i)
+        createTestTrack(anim->createNodeTrack(i, skel->getBone(i)), rng, 201, 10);
+    Animation* reference = anim->clone("reference");
+
+    CompressedTransformKeys::Settings settings;
+    anim->compressNodeTracks(settings);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        const CompressedTransformKeys* keys = anim->getNodeTrack(i)->getCompressedKeys();
+        ASSERT_TRUE(keys);
+        EXPECT_EQ(0, anim->getNodeTrack(i)->getNumKeyFrames());
+        EXPECT_EQ(CompressedTransformKeys::CC_SCALE, keys->getConstantChannels());
+        EXPECT_LT(keys->getNumKeys(), 201u);
+    }
+
+    // forwards, then at random times to miss the cursor, then past the end
+    for (int s = 0; s < 3000; ++s)
+    {
+        Real t = s < 1000 ? s / 100.0f : s < 2000 ? float(rng() % 10000) / 1000 : 10 + s / 1000.0f;
+        for (int i = 0; i < 4; ++i)
+        {
+            TransformKeyFrame expected(0, t), actual(0, t);
+            reference->getNodeTrack(i)->getInterpolatedKeyFrame(reference->_getTimeIndex(t), &expected);
+            anim->getNodeTrack(i)->getInterpolatedKeyFrame(anim->_getTimeIndex(t), &actual);
+            // elided keys are within tolerance, between them the error is at most twice that
+            EXPECT_LT(expected.getTranslate().distance(actual.getTranslate()), 2 * settings.positionTolerance);
+            EXPECT_NEAR(1, std::abs(expected.getRotation().Dot(actual.getRotation())), 1e-5);
+            EXPECT_EQ(expected.getScale(), actual.getScale());
+        }
+    }
+
+    // compressed tracks round trip exactly, older versions are written as keyframes
+    SkeletonSerializer serializer;
+    for (int v = 0; v < 2; ++v)
+    {
+        MemoryDataStream* buffer = OGRE_NEW MemoryDataStream(1 << 20);
+        serializer.exportSkeleton(skel.get(), DataStreamPtr(buffer), v == 0 ? SKELETON_VERSION_LATEST : SKELETON_VERSION_1_8);
+        DataStreamPtr in(OGRE_NEW MemoryDataStream(buffer->getPtr(), buffer->tell()));
+
+        SkeletonPtr loaded = SkeletonManager::getSingleton().create("compressedKeys" + StringConverter::toString(v),
+                                                                    ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+        serializer.importSkeleton(in, loaded.get());
+        Animation* loadedAnim = loaded->getAnimation("anim");
+        for (int i = 0; i < 4; ++i)
+        {
+            NodeAnimationTrack* track = loadedAnim->getNodeTrack(i);
+            EXPECT_EQ(v == 0, track->isCompressed());
+            for (int s = 0; s < 100; ++s)
+            {
+                Real t = s / 10.0f;
+                TransformKeyFrame expected(0, t), actual(0, t);
+                anim->getNodeTrack(i)->getInterpolatedKeyFrame(anim->_getTimeIndex(t), &expected);
+                track->getInterpolatedKeyFrame(loadedAnim->_getTimeIndex(t), &actual);
+                EXPECT_TRUE(expected.getTranslate().positionEquals(actual.getTranslate(), 1e-4f));
+                EXPECT_NEAR(1, std::abs(expected.getRotation().Dot(actual.getRotation())), 1e-6);
+            }
+        }
+    }
+    OGRE_DELETE reference;
+}
+
+TEST(CompressedTransformKeys,benchmark)
+{
+    Root root;
+    minstd_rand rng;
+    const int numTracks = 64, numKeys = 600, numSamples = 2000;
+    Animation reference("reference", 20), compressed("compressed", 20);
+    for (int i = 0; i < numTracks; ++i)
+        createTestTrack(reference.createNodeTrack(i), rng, numKeys, 20);
+    for (int i = 0; i < numTracks; ++i)
+        reference.getNodeTrack(i)->_clone(&compressed);
+    CompressedTransformKeys::Settings settings;
+    compressed.compressNodeTracks(settings);
+
+    size_t referenceBytes = 0, compressedBytes = 0;
+    for (int i = 0; i < numTracks; ++i)
+    {
+        referenceBytes += numKeys * (sizeof(TransformKeyFrame) + sizeof(KeyFrame*));
+        compressedBytes += compressed.getNodeTrack(i)->getCompressedKeys()->getMemoryUsage();
+    }
+    EXPECT_LT(compressedBytes * 4, referenceBytes);
+
+    Animation* anims[] = {&reference, &compressed};
+    unsigned long micros[2];
+    Vector3 checksum[2] = {Vector3::ZERO, Vector3::ZERO};
+    for (int a = 0; a < 2; ++a)
+    {
+        Timer timer;
+        TransformKeyFrame kf(0, 0);
+        for (int s = 0; s < numSamples; ++s)
+        {
+            TimeIndex timeIndex = anims[a]->_getTimeIndex(s * 0.01f);
+            for (int i = 0; i < numTracks; ++i)
+            {
+                anims[a]->getNodeTrack(i)->getInterpolatedKeyFrame(timeIndex, &kf);
+                checksum[a] += kf.getTranslate();
+            }
+        }
+        micros[a] = timer.getMicroseconds();
+    }
+    EXPECT_TRUE(checksum[0].positionEquals(checksum[1], checksum[0].length() * 1e-3f));
+
+    // the timed samples stay within the error bound of the compression
+    Real maxPositionError = 0, minRotationDot = 1, maxScaleError = 0;
+    for (int s = 0; s < numSamples; ++s)
+    {
+        for (int i = 0; i < numTracks; ++i)
+        {
+            TransformKeyFrame expected(0, 0), actual(0, 0);
+            reference.getNodeTrack(i)->getInterpolatedKeyFrame(reference._getTimeIndex(s * 0.01f), &expected);
+            compressed.getNodeTrack(i)->getInterpolatedKeyFrame(compressed._getTimeIndex(s * 0.01f), &actual);
+            maxPositionError = std::max(maxPositionError, expected.getTranslate().distance(actual.getTranslate()));
+            minRotationDot = std::min(minRotationDot, std::abs(expected.getRotation().Dot(actual.getRotation())));
+            maxScaleError = std::max(maxScaleError, expected.getScale().distance(actual.getScale()));
+        }
+    }
+    // elided keys are within tolerance, between them the error is at most twice that
+    EXPECT_LT(maxPositionError, 2 * settings.positionTolerance);
+    EXPECT_NEAR(1, minRotationDot, 1e-5);
+    EXPECT_LT(maxScaleError, 2 * settings.scaleTolerance);
+
+    LogManager::getSingleton().stream() << numTracks << " tracks of " << numKeys << " keys: keyframes "
+        << referenceBytes << " bytes, " << micros[0] << " us; compressed "
+        << compressedBytes << " bytes, " << micros[1] << " us";
+}
@@ -288,6 +288,34 @@ TEST_F(FileSystemArchiveTests,ReadInterleave)
     EXPECT_TRUE(stream2->eof());
 }
 //--------------------------------------------------------------------------
+TEST_F(FileSystemArchiveTests,MappedFileRead)
+{
+    FileSystemArchiveFactory::setUseMemoryMapping(true);
+    DataStreamPtr stream = mArch->open("rootfile2.txt");
+    DataStreamPtr rwStream = mArch->open("rootfile.txt", false);
+    FileSystemArchiveFactory::setUseMemoryMapping(false);
+
+    MappedDataStream* mapped = dynamic_cast<MappedDataStream*>(stream.get());
+    ASSERT_TRUE(mapped != NULL);
+    EXPECT_FALSE(stream->isWriteable());
+    EXPECT_EQ(mFileSizeRoot2, stream->size());
+    EXPECT_EQ(String("this is line 1 in file 2"), String((const char*)mapped->getPtr(), 24));
+
+    EXPECT_EQ(String("this is line 1 in file 2"), stream->getLine());
+    stream->seek(stream->size() - 1);
+    EXPECT_FALSE(stream->eof());
+    stream->skip(1);
+    EXPECT_TRUE(stream->eof());
+    stream->seek(0);
+    EXPECT_EQ(String("this is line 1 in file 2"), stream->getLine());
+
+    // read-write access is never mapped
+    EXPECT_TRUE(dynamic_cast<MappedDataStream*>(rwStream.get()) == NULL);
+
+    stream->close();
+    EXPECT_TRUE(mapped->getPtr() == NULL);
+}
+//--------------------------------------------------------------------------
 TEST_F(FileSystemArchiveTests,CreateAndRemoveFile)
 {
     EXPECT_TRUE(!mArch->isReadOnly());
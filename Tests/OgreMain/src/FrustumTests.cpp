@@ -0,0 +1,166 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreFrustum.h"
+#include "OgreMaterialManager.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreOptimisedUtil.h"
+
+#include <limits>
+
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1600)
+#include <random>
+using std::minstd_rand;
+#else
+#include <tr1/random>
+using std::tr1::minstd_rand;
+#endif
+
+using namespace Ogre;
+
+TEST(Frustum,bulkVisibility)
+{
+    Root root;
+    DefaultHardwareBufferManager hbm;
+    MaterialManager::getSingleton().initialise();
+
+    Frustum frustum;
+    frustum.setNearClipDistance(1);
+    frustum.setFarClipDistance(200);
+
+    minstd_rand rng;
+    const size_t count = 1001; // not a multiple of 4 or 32
+    std::vector<AxisAlignedBox> boxes(count);
+    std::vector<const AxisAlignedBox*> boxPtrs(count);
+    std::vector<float> data[4];
+    for (size_t i = 0; i < count; ++i)
+    {
+        Vector3 c(float(rng() % 600) - 300, float(rng() % 600) - 300, -float(rng() % 300));
+        Vector3 h(float(rng() % 40), float(rng() % 40), float(rng() % 40));
+        if (i % 97 == 0)
+            boxes[i].setNull();
+        else if (i % 89 == 0)
+            boxes[i].setInfinite();
+        else
+            boxes[i].setExtents(c - h, c + h);
+        boxPtrs[i] = &boxes[i];
+
+        data[0].push_back(c.x);
+        data[1].push_back(c.y);
+        data[2].push_back(c.z);
+        data[3].push_back(h.x);
+    }
+
+    std::vector<uint32> visibility((count + 31) / 32);
+    frustum.isVisible(count, &boxPtrs[0], &visibility[0]);
+
+    std::vector<uint32> sphereVisibility((count + 31) / 32);
+    const float* centres[3] = {&data[0][0], &data[1][0], &data[2][0]};
+    frustum.isVisible(count, centres, &data[3][0], &sphereVisibility[0]);
+
+    size_t numVisible = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        bool visible = (visibility[i / 32] & (1u << (i % 32))) != 0;
+        EXPECT_EQ(frustum.isVisible(boxes[i]), visible) << i;
+        numVisible += visible;
+
+        Sphere sphere(Vector3(data[0][i], data[1][i], data[2][i]), data[3][i]);
+        EXPECT_EQ(frustum.isVisible(sphere), (sphereVisibility[i / 32] & (1u << (i % 32))) != 0) << i;
+    }
+    // unused bits are cleared
+    EXPECT_EQ(0u, visibility.back() >> (count % 32));
+    // make sure both cases are covered
+    EXPECT_GT(numVisible, 0u);
+    EXPECT_LT(numVisible, count);
+}
+
+TEST(Frustum,cullImplementations)
+{
+    Root root;
+    DefaultHardwareBufferManager hbm;
+    MaterialManager::getSingleton().initialise();
+
+    Frustum frustum;
+    frustum.setNearClipDistance(1);
+    frustum.setFarClipDistance(200);
+
+    // the frustum planes, then more planes than the SIMD implementations keep on the stack
+    std::vector<Plane> planes(frustum.getFrustumPlanes(), frustum.getFrustumPlanes() + 6);
+    for (int i = 0; i < 5; ++i)
+        planes.push_back(Plane(Vector3(float(i) - 2, 1, -1).normalisedCopy(), float(i * 10)));
+
+    minstd_rand rng;
+    const size_t count = 1001;
+    std::vector<float> data[7];
+    for (size_t i = 0; i < count; ++i)
+    {
+        data[0].push_back(float(rng() % 600) - 300);
+        data[1].push_back(float(rng() % 600) - 300);
+        data[2].push_back(-float(rng() % 300));
+        for (int k = 3; k < 6; ++k)
+            data[k].push_back(i % 89 == 0 ? std::numeric_limits<float>::infinity() : float(rng() % 40));
+        data[6].push_back(float(rng() % 40));
+    }
+    const float* centres[3] = {&data[0][0], &data[1][0], &data[2][0]};
+    const float* halfSizes[3] = {&data[3][0], &data[4][0], &data[5][0]};
+
+    OptimisedUtil::ImplementationList impls = OptimisedUtil::getAvailableImplementations();
+    ASSERT_EQ("General", impls[0].first);
+    OptimisedUtil* general = impls[0].second;
+
+    // counts around the SIMD widths and the 32 bits of a visibility word
+    const size_t counts[] = {0, 1, 3, 4, 5, 7, 8, 9, 31, 32, 33, 63, 65, count};
+    const size_t numPlanes[] = {0, 1, 6, 8, planes.size()};
+    for (size_t n = 0; n < sizeof(counts) / sizeof(counts[0]); ++n)
+    {
+        // one extra word, to check nothing is written past the end
+        size_t numWords = (counts[n] + 31) / 32 + 1;
+        for (size_t p = 0; p < sizeof(numPlanes) / sizeof(numPlanes[0]); ++p)
+        {
+            std::vector<uint32> expectedBoxes(numWords, 0xDEADBEEF), expectedSpheres(numWords, 0xDEADBEEF);
+            general->cullAxisAlignedBoxes(&planes[0], numPlanes[p], centres, halfSizes,
+                                          &expectedBoxes[0], counts[n]);
+            general->cullSpheres(&planes[0], numPlanes[p], centres, &data[6][0],
+                                 &expectedSpheres[0], counts[n]);
+
+            for (size_t i = 1; i < impls.size(); ++i)
+            {
+                std::vector<uint32> boxes(numWords, 0xDEADBEEF), spheres(numWords, 0xDEADBEEF);
+                impls[i].second->cullAxisAlignedBoxes(&planes[0], numPlanes[p], centres, halfSizes,
+                                                      &boxes[0], counts[n]);
+                impls[i].second->cullSpheres(&planes[0], numPlanes[p], centres, &data[6][0],
+                                             &spheres[0], counts[n]);
+                EXPECT_EQ(expectedBoxes, boxes) << impls[i].first << " " << counts[n] << " " << numPlanes[p];
+                EXPECT_EQ(expectedSpheres, spheres) << impls[i].first << " " << counts[n] << " " << numPlanes[p];
+            }
+        }
+    }
+}
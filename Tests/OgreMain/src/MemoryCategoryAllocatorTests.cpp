@@ -0,0 +1,206 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreMemoryCategoryAllocator.h"
+#include "OgreAlignedAllocator.h"
+#include "OgreAtomicScalar.h"
+
+#include <thread>
+
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1600)
+#include <random>
+using std::minstd_rand;
+#else
+#include <tr1/random>
+using std::tr1::minstd_rand;
+#endif
+
+using namespace Ogre;
+
+namespace
+{
+    struct CountingMemoryAllocator : public MemoryAllocator
+    {
+        AtomicScalar<size_t> live;
+        CountingMemoryAllocator() : live(0) {}
+
+        void* allocateBytes(size_t size, int category)
+        {
+            ++live;
+            return AlignedMemory::allocate(size);
+        }
+        void deallocateBytes(void* ptr, size_t size, int category)
+        {
+            --live;
+            AlignedMemory::deallocate(ptr);
+        }
+    };
+
+    struct AnimationObject : public AnimationAlloc
+    {
+        char data[40];
+    };
+}
+
+TEST(MemoryCategoryAllocator,counters)
+{
+    const int cat = MEMCATEGORY_GEOMETRY;
+    size_t bytes = MemoryCategoryAllocator::getAllocatedBytes(cat);
+    size_t count = MemoryCategoryAllocator::getAllocationCount(cat);
+
+    char* p = static_cast<char*>(OGRE_MALLOC(100, MEMCATEGORY_GEOMETRY));
+    EXPECT_EQ(bytes + 100, MemoryCategoryAllocator::getAllocatedBytes(cat));
+    EXPECT_EQ(count + 1, MemoryCategoryAllocator::getAllocationCount(cat));
+    EXPECT_EQ(0u, size_t(p) % OGRE_SIMD_ALIGNMENT);
+
+    for (int i = 0; i < 100; ++i)
+        p[i] = char(i);
+    p = static_cast<char*>(OGRE_REALLOC(p, 1000, MEMCATEGORY_GEOMETRY));
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(char(i), p[i]);
+    EXPECT_EQ(bytes + 1000, MemoryCategoryAllocator::getAllocatedBytes(cat));
+    EXPECT_GE(MemoryCategoryAllocator::getPeakAllocatedBytes(cat), bytes + 1000);
+
+    MemoryCategoryAllocator::setBudget(cat, bytes + 500);
+    EXPECT_TRUE(MemoryCategoryAllocator::isOverBudget(cat));
+    OGRE_FREE(p, MEMCATEGORY_GEOMETRY);
+    EXPECT_FALSE(MemoryCategoryAllocator::isOverBudget(cat));
+    MemoryCategoryAllocator::setBudget(cat, 0);
+
+    EXPECT_EQ(bytes, MemoryCategoryAllocator::getAllocatedBytes(cat));
+    EXPECT_EQ(count, MemoryCategoryAllocator::getAllocationCount(cat));
+
+    // AllocatedObject subclasses are accounted to their category
+    size_t animBytes = MemoryCategoryAllocator::getAllocatedBytes(MEMCATEGORY_ANIMATION);
+    AnimationObject* obj = OGRE_NEW AnimationObject();
+    EXPECT_EQ(animBytes + sizeof(AnimationObject), MemoryCategoryAllocator::getAllocatedBytes(MEMCATEGORY_ANIMATION));
+    OGRE_DELETE obj;
+    EXPECT_EQ(animBytes, MemoryCategoryAllocator::getAllocatedBytes(MEMCATEGORY_ANIMATION));
+}
+
+TEST(MemoryCategoryAllocator,customAllocator)
+{
+    const int cat = MEMCATEGORY_SCRIPTING;
+    CountingMemoryAllocator allocator;
+
+    void* before = OGRE_MALLOC(10, MEMCATEGORY_SCRIPTING);
+    MemoryCategoryAllocator::setAllocator(cat, &allocator);
+    EXPECT_EQ(&allocator, MemoryCategoryAllocator::getAllocator(cat));
+
+    void* after = OGRE_MALLOC(10, MEMCATEGORY_SCRIPTING);
+    EXPECT_EQ(1u, allocator.live.load());
+
+    // blocks go back to the allocator they came from
+    MemoryCategoryAllocator::setAllocator(cat, 0);
+    OGRE_FREE(before, MEMCATEGORY_SCRIPTING);
+    EXPECT_EQ(1u, allocator.live.load());
+    OGRE_FREE(after, MEMCATEGORY_SCRIPTING);
+    EXPECT_EQ(0u, allocator.live.load());
+    EXPECT_EQ(MemoryCategoryAllocator::getDefaultAllocator(), MemoryCategoryAllocator::getAllocator(cat));
+}
+
+TEST(MemoryCategoryAllocator,threads)
+{
+    const int cat = MEMCATEGORY_RENDERSYS;
+    size_t bytes = MemoryCategoryAllocator::getAllocatedBytes(cat);
+    size_t count = MemoryCategoryAllocator::getAllocationCount(cat);
+
+    // blocks allocated on one thread and freed on another
+    const size_t numThreads = 4;
+    const size_t perThread = 5000;
+    std::vector<void*> blocks[numThreads];
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < numThreads; ++t)
+    {
+        threads.push_back(std::thread([t, perThread, &blocks]() {
+            minstd_rand rng(uint32(t + 1));
+            for (size_t i = 0; i < perThread; ++i)
+            {
+                size_t size = 1 + rng() % 700;
+                char* p = static_cast<char*>(OGRE_MALLOC(size, MEMCATEGORY_RENDERSYS));
+                p[0] = p[size - 1] = char(t);
+                blocks[t].push_back(p);
+            }
+        }));
+    }
+    for (size_t t = 0; t < numThreads; ++t)
+        threads[t].join();
+    EXPECT_EQ(count + numThreads * perThread, MemoryCategoryAllocator::getAllocationCount(cat));
+
+    threads.clear();
+    for (size_t t = 0; t < numThreads; ++t)
+    {
+        threads.push_back(std::thread([t, numThreads, &blocks]() {
+            std::vector<void*>& mine = blocks[(t + 1) % numThreads];
+            for (size_t i = 0; i < mine.size(); ++i)
+            {
+                EXPECT_EQ(char((t + 1) % numThreads), static_cast<char*>(mine[i])[0]);
+                OGRE_FREE(mine[i], MEMCATEGORY_RENDERSYS);
+            }
+        }));
+    }
+    for (size_t t = 0; t < numThreads; ++t)
+        threads[t].join();
+
+    EXPECT_EQ(bytes, MemoryCategoryAllocator::getAllocatedBytes(cat));
+    EXPECT_EQ(count, MemoryCategoryAllocator::getAllocationCount(cat));
+    EXPECT_GT(MemoryCategoryAllocator::getDefaultAllocator()->getReservedBytes(cat), 0u);
+}
+
+TEST(MemoryCategoryAllocator,poolLifetime)
+{
+    const int cat = MEMCATEGORY_GENERAL;
+    // destroyed pools must not leave blocks behind in the thread cache, even
+    // when the next pool is allocated at the same address
+    for (int i = 0; i < 10; ++i)
+    {
+        PoolMemoryAllocator* pool = new PoolMemoryAllocator();
+        void* p = pool->allocateBytes(64, cat);
+        EXPECT_EQ(size_t(PoolMemoryAllocator::CHUNK_SIZE), pool->getReservedBytes(cat));
+        pool->deallocateBytes(p, 64, cat);
+        delete pool;
+    }
+
+    // more live pools than a thread keeps caches for
+    const size_t numPools = PoolMemoryAllocator::MAX_THREAD_CACHES + 2;
+    PoolMemoryAllocator pools[numPools];
+    void* blocks[numPools];
+    for (size_t i = 0; i < numPools; ++i)
+    {
+        blocks[i] = pools[i].allocateBytes(32, cat);
+        memset(blocks[i], int(i), 32);
+    }
+    for (size_t i = 0; i < numPools; ++i)
+    {
+        EXPECT_EQ(char(i), static_cast<char*>(blocks[i])[31]);
+        pools[i].deallocateBytes(blocks[i], 32, cat);
+        EXPECT_EQ(blocks[i], pools[i].allocateBytes(32, cat));
+        pools[i].deallocateBytes(blocks[i], 32, cat);
+    }
+}
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "OgreMeshManager.h"
 #include "OgreSubMesh.h"
 #include "OgreMeshSerializer.h"
+#include "OgreMeshFileFormat.h"
 #include "OgreRoot.h"
 #include "OgreException.h"
 #include "OgreArchive.h"
@@ -196,11 +197,25 @@ TEST_F(MeshSerializerTests,Skeleton_Version_1_0)
     }
 }
 //--------------------------------------------------------------------------
-TEST_F(MeshSerializerTests,Mesh_Version_1_10)
+TEST_F(MeshSerializerTests,Mesh_Version_1_11)
 {
     testMesh(MESH_VERSION_LATEST);
 }
 //--------------------------------------------------------------------------
+TEST_F(MeshSerializerTests,Mesh_Version_1_10)
+{
+    testMesh(MESH_VERSION_1_10);
+}
+//--------------------------------------------------------------------------
+TEST_F(MeshSerializerTests,Mesh_BigEndian)
+{
+    // Buffer payloads are flipped after being located in the prebuffered file
+    MeshSerializer serializer;
+    serializer.exportMesh(mOrigMesh.get(), mMeshFullPath, MESH_VERSION_LATEST, Serializer::ENDIAN_BIG);
+    mMesh->reload();
+    assertMeshClone(mOrigMesh.get(), mMesh.get());
+}
+//--------------------------------------------------------------------------
 TEST_F(MeshSerializerTests,Mesh_Version_1_8)
 {
     testMesh(MESH_VERSION_1_8);
@@ -247,6 +262,7 @@ TEST_F(MeshSerializerTests,Mesh_Version_1_2)
             }
             mOrigMesh = mMesh->clone(mMesh->getName() + ".orig.mesh", mMesh->getGroup());
             testMesh_XML();
+            testMesh(MESH_VERSION_1_11);
             testMesh(MESH_VERSION_1_10);
             testMesh(MESH_VERSION_1_8);
             testMesh(MESH_VERSION_1_7);
@@ -273,6 +289,189 @@ TEST_F(MeshSerializerTests,Mesh_Version_1_2)
 }
 #endif /* ifdef I_HAVE_LOT_OF_FREE_TIME */
 //--------------------------------------------------------------------------
+static VertexData* createSkinnedVertexData(size_t vertexCount)
+{
+    VertexData* data = OGRE_NEW VertexData();
+    data->vertexCount = vertexCount;
+    data->vertexDeclaration->addElement(0, 0, VET_FLOAT3, VES_POSITION);
+    HardwareVertexBufferSharedPtr vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+        sizeof(float) * 3, vertexCount, HardwareBuffer::HBU_STATIC_WRITE_ONLY, true);
+    float* pos = static_cast<float*>(vbuf->lock(HardwareBuffer::HBL_DISCARD));
+    for (size_t v = 0; v < vertexCount * 3; ++v)
+        pos[v] = Real(v);
+    vbuf->unlock();
+    data->vertexBufferBinding->setBinding(0, vbuf);
+    return data;
+}
+//--------------------------------------------------------------------------
+static MeshPtr exportAndImport(const MeshPtr& mesh, const String& name, MeshVersion version, size_t& fileSize)
+{
+    MeshSerializer serializer;
+    MemoryDataStream* buffer = OGRE_NEW MemoryDataStream(1 << 20);
+    DataStreamPtr out(buffer);
+    serializer.exportMesh(mesh.get(), out, version);
+    fileSize = buffer->tell();
+
+    DataStreamPtr stream(OGRE_NEW MemoryDataStream(buffer->getPtr(), fileSize));
+    MeshPtr result = MeshManager::getSingleton().createManual(name, "General");
+    serializer.importMesh(stream, result.get());
+    return result;
+}
+//--------------------------------------------------------------------------
+static void assertBlendBufferEqual(const VertexData* a, const VertexData* b)
+{
+    const VertexElement* aIdx = a->vertexDeclaration->findElementBySemantic(VES_BLEND_INDICES);
+    const VertexElement* aWt = a->vertexDeclaration->findElementBySemantic(VES_BLEND_WEIGHTS);
+    const VertexElement* bIdx = b->vertexDeclaration->findElementBySemantic(VES_BLEND_INDICES);
+    const VertexElement* bWt = b->vertexDeclaration->findElementBySemantic(VES_BLEND_WEIGHTS);
+    ASSERT_TRUE(aIdx && aWt && bIdx && bWt);
+    ASSERT_EQ(aWt->getType(), bWt->getType());
+    ASSERT_EQ(VET_FLOAT1, VertexElement::getBaseType(aWt->getType()));
+
+    HardwareVertexBufferSharedPtr aBuf = a->vertexBufferBinding->getBuffer(aIdx->getSource());
+    HardwareVertexBufferSharedPtr bBuf = b->vertexBufferBinding->getBuffer(bIdx->getSource());
+    const uchar* pa = static_cast<const uchar*>(aBuf->lock(HardwareBuffer::HBL_READ_ONLY));
+    const uchar* pb = static_cast<const uchar*>(bBuf->lock(HardwareBuffer::HBL_READ_ONLY));
+    for (size_t v = 0; v < a->vertexCount; ++v)
+    {
+        for (int i = 0; i < 4; ++i)
+            EXPECT_EQ(pa[aIdx->getOffset() + i], pb[bIdx->getOffset() + i]);
+        const float* wa = reinterpret_cast<const float*>(pa + aWt->getOffset());
+        const float* wb = reinterpret_cast<const float*>(pb + bWt->getOffset());
+        for (int i = 0; i < VertexElement::getTypeCount(aWt->getType()); ++i)
+            EXPECT_FLOAT_EQ(wa[i], wb[i]);
+        pa += aBuf->getVertexSize();
+        pb += bBuf->getVertexSize();
+    }
+    aBuf->unlock();
+    bBuf->unlock();
+}
+//--------------------------------------------------------------------------
+static void assertBoneAssignmentsEqual(const Mesh::VertexBoneAssignmentList& a,
+                                       const Mesh::VertexBoneAssignmentList& b)
+{
+    ASSERT_EQ(a.size(), b.size());
+    Mesh::VertexBoneAssignmentList::const_iterator ia = a.begin(), ib = b.begin();
+    for (; ia != a.end(); ++ia, ++ib)
+    {
+        EXPECT_EQ(ia->second.vertexIndex, ib->second.vertexIndex);
+        EXPECT_EQ(ia->second.boneIndex, ib->second.boneIndex);
+        EXPECT_FLOAT_EQ(ia->second.weight, ib->second.weight);
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(MeshSerializerTests,Mesh_PackedBoneAssignments)
+{
+    const size_t vertexCount = 200;
+    MeshPtr mesh = MeshManager::getSingleton().createManual("packed_source.mesh", "General");
+    mesh->setSkeletonName("jaiqua.skeleton");
+    mesh->sharedVertexData = createSkinnedVertexData(vertexCount);
+
+    SubMesh* shared = mesh->createSubMesh();
+    SubMesh* dedicated = mesh->createSubMesh();
+    shared->useSharedVertices = true;
+    dedicated->useSharedVertices = false;
+    dedicated->vertexData = createSkinnedVertexData(vertexCount);
+    for (int i = 0; i < 2; ++i)
+    {
+        IndexData* indexData = mesh->getSubMesh(i)->indexData;
+        indexData->indexCount = vertexCount;
+        indexData->indexBuffer = HardwareBufferManager::getSingleton().createIndexBuffer(
+            HardwareIndexBuffer::IT_16BIT, vertexCount, HardwareBuffer::HBU_STATIC_WRITE_ONLY, true);
+        uint16* idx = static_cast<uint16*>(indexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
+        for (size_t v = 0; v < vertexCount; ++v)
+            idx[v] = static_cast<uint16>(v);
+        indexData->indexBuffer->unlock();
+    }
+
+    // 1 to 4 unnormalised weights per vertex
+    for (unsigned int v = 0; v < vertexCount; ++v)
+    {
+        for (unsigned int k = 0; k <= v % 4; ++k)
+        {
+            VertexBoneAssignment vba;
+            vba.vertexIndex = v;
+            vba.boneIndex = static_cast<unsigned short>((v * 7 + k * 3) % 20);
+            vba.weight = Real(k + 1);
+            mesh->addBoneAssignment(vba);
+            vba.boneIndex = static_cast<unsigned short>((v * 5 + k * 11) % 30);
+            dedicated->addBoneAssignment(vba);
+        }
+    }
+    mesh->_setBounds(AxisAlignedBox(Vector3::ZERO, Vector3(600, 600, 600)));
+
+    size_t packedSize, legacySize;
+    MeshPtr packed = exportAndImport(mesh, "packed_1_11.mesh", MESH_VERSION_LATEST, packedSize);
+    MeshPtr legacy = exportAndImport(mesh, "packed_1_10.mesh", MESH_VERSION_1_10, legacySize);
+    EXPECT_LT(packedSize, legacySize);
+
+    // Packed assignments are compiled while loading, legacy ones on demand
+    ASSERT_TRUE(packed->sharedVertexData->vertexDeclaration->findElementBySemantic(VES_BLEND_INDICES));
+    legacy->_updateCompiledBoneAssignments();
+
+    EXPECT_EQ(legacy->sharedBlendIndexToBoneIndexMap, packed->sharedBlendIndexToBoneIndexMap);
+    EXPECT_EQ(legacy->getSubMesh(1)->blendIndexToBoneIndexMap, packed->getSubMesh(1)->blendIndexToBoneIndexMap);
+    assertBlendBufferEqual(legacy->sharedVertexData, packed->sharedVertexData);
+    assertBlendBufferEqual(legacy->getSubMesh(1)->vertexData, packed->getSubMesh(1)->vertexData);
+
+    assertBoneAssignmentsEqual(legacy->getBoneAssignments(), packed->getBoneAssignments());
+    assertBoneAssignmentsEqual(legacy->getSubMesh(1)->getBoneAssignments(),
+                               packed->getSubMesh(1)->getBoneAssignments());
+
+    // Editing after unpacking recompiles as usual
+    VertexBoneAssignment vba;
+    vba.vertexIndex = 0;
+    vba.boneIndex = 25;
+    vba.weight = 1;
+    packed->addBoneAssignment(vba);
+    EXPECT_EQ(legacy->getBoneAssignments().size() + 1, packed->getBoneAssignments().size());
+    packed->_updateCompiledBoneAssignments();
+    EXPECT_EQ(25, packed->sharedBlendIndexToBoneIndexMap.back());
+
+    // Corrupt blend index tables are rejected instead of being indexed out of range
+    MeshSerializer serializer;
+    MemoryDataStream* buffer = OGRE_NEW MemoryDataStream(1 << 20);
+    DataStreamPtr out(buffer);
+    serializer.exportMesh(mesh.get(), out);
+    std::vector<uchar> file(buffer->getPtr(), buffer->getPtr() + buffer->tell());
+
+    // chunk id and size, followed by the vertex count
+    size_t chunk = 0;
+    for (size_t i = 0; i + 10 <= file.size() && !chunk; ++i)
+    {
+        uint16 id;
+        uint32 count;
+        memcpy(&id, &file[i], sizeof(id));
+        memcpy(&count, &file[i + 6], sizeof(count));
+        if (id == M_MESH_PACKED_BONE_ASSIGNMENTS && count == vertexCount)
+            chunk = i;
+    }
+    ASSERT_NE(0u, chunk);
+    size_t numBlendIndicesPos = chunk + 6 + sizeof(uint32) + sizeof(uint16);
+    uint16 numBlendIndices;
+    memcpy(&numBlendIndices, &file[numBlendIndicesPos], sizeof(numBlendIndices));
+    size_t blendIndicesPos = numBlendIndicesPos + sizeof(uint16) * (1 + numBlendIndices);
+
+    std::vector<uchar> tooManyIndices = file;
+    uint16 badCount = 300;
+    memcpy(&tooManyIndices[numBlendIndicesPos], &badCount, sizeof(badCount));
+    std::vector<uchar> missingIndex = file;
+    missingIndex[blendIndicesPos + 5] = static_cast<uchar>(numBlendIndices);
+
+    std::vector<uchar>* corrupt[] = { &tooManyIndices, &missingIndex };
+    for (int i = 0; i < 2; ++i)
+    {
+        DataStreamPtr stream(OGRE_NEW MemoryDataStream(corrupt[i]->data(), corrupt[i]->size()));
+        MeshPtr result = MeshManager::getSingleton().createManual("packed_corrupt.mesh", "General");
+        EXPECT_THROW(serializer.importMesh(stream, result.get()), InvalidParametersException);
+        MeshManager::getSingleton().remove(result);
+    }
+
+    MeshManager::getSingleton().remove(mesh);
+    MeshManager::getSingleton().remove(packed);
+    MeshManager::getSingleton().remove(legacy);
+}
+//--------------------------------------------------------------------------
 TEST_F(MeshSerializerTests,Mesh_XML)
 {
 #ifdef OGRE_TEST_XMLSERIALIZER
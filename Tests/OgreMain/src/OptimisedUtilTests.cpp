@@ -0,0 +1,194 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreOptimisedUtil.h"
+#include "OgreMatrix4.h"
+#include "OgreThreadPool.h"
+#include "OgreTimer.h"
+#include "OgreLogManager.h"
+
+#include <thread>
+
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1600)
+#include <random>
+using std::minstd_rand;
+#else
+#include <tr1/random>
+using std::tr1::minstd_rand;
+#endif
+
+using namespace Ogre;
+
+namespace {
+/// Skinning input with 4 weights per vertex, in every buffer layout OptimisedUtil has a path for
+struct SkinningTestData
+{
+    size_t numVertices;
+    std::vector<Affine3> matrices;
+    std::vector<const Affine3*> blendMatrices;
+    std::vector<float> weights;
+    std::vector<unsigned char> indices;
+    // position and normal interleaved, 2 floats of padding up front so the
+    // first vertex isn't 16 bytes aligned
+    std::vector<float> src;
+
+    SkinningTestData(size_t vertexCount) : numVertices(vertexCount), matrices(60)
+    {
+        minstd_rand rng;
+        for (size_t i = 0; i < matrices.size(); ++i)
+        {
+            Vector3 axis(float(rng() % 100) + 1, float(rng() % 100), float(rng() % 100));
+            Quaternion rot(Degree(float(rng() % 360)), axis.normalisedCopy());
+            matrices[i] = Affine3(Vector3(float(rng() % 20), float(rng() % 20), float(rng() % 20)), rot);
+            blendMatrices.push_back(&matrices[i]);
+        }
+
+        for (size_t i = 0; i < numVertices; ++i)
+        {
+            float w[4], sum = 0;
+            for (int b = 0; b < 4; ++b)
+            {
+                // every fifth vertex has a single bone
+                w[b] = b > 0 && i % 5 == 0 ? 0 : float(rng() % 100 + 1);
+                sum += w[b];
+                indices.push_back((unsigned char)(rng() % matrices.size()));
+            }
+            for (int b = 0; b < 4; ++b)
+                weights.push_back(w[b] / sum);
+        }
+
+        src.resize(2 + numVertices * 6);
+        for (size_t i = 0; i < numVertices; ++i)
+        {
+            Vector3 norm = Vector3(float(rng() % 200), float(rng() % 200), float(rng() % 200)) - 100;
+            norm.normalise();
+            for (int c = 0; c < 3; ++c)
+            {
+                src[2 + i * 6 + c] = float(rng() % 2000) / 100 - 10;
+                src[2 + i * 6 + 3 + c] = norm[c];
+            }
+        }
+    }
+
+    /// Blends into dest (same layout as src), 0 = shared, 1 = separated, 2 = position only
+    void blend(OptimisedUtil* util, ThreadPool* pool, int layout, std::vector<float>& dest) const
+    {
+        // only the padding is never written, so reuse the buffer if it fits
+        if (dest.size() != src.size())
+            dest.assign(src.size(), 0);
+        if (layout == 0)
+        {
+            util->softwareVertexSkinningParallel(pool, &src[2], &dest[2], &src[5], &dest[5],
+                                                 &weights[0], &indices[0], &blendMatrices[0],
+                                                 24, 24, 24, 24, 16, 4, 4, numVertices);
+            return;
+        }
+
+        // separate packed buffers, offset by one float
+        std::vector<float> srcPos(1 + numVertices * 3), srcNorm(1 + numVertices * 3);
+        std::vector<float> destPos(srcPos.size()), destNorm(srcNorm.size());
+        for (size_t i = 0; i < numVertices * 3; ++i)
+        {
+            srcPos[1 + i] = src[2 + i / 3 * 6 + i % 3];
+            srcNorm[1 + i] = src[2 + i / 3 * 6 + 3 + i % 3];
+        }
+        util->softwareVertexSkinningParallel(pool, &srcPos[1], &destPos[1],
+                                             layout == 1 ? &srcNorm[1] : NULL, &destNorm[1],
+                                             &weights[0], &indices[0], &blendMatrices[0],
+                                             12, 12, 12, 12, 16, 4, 4, numVertices);
+        for (size_t i = 0; i < numVertices * 3; ++i)
+        {
+            dest[2 + i / 3 * 6 + i % 3] = destPos[1 + i];
+            dest[2 + i / 3 * 6 + 3 + i % 3] = destNorm[1 + i];
+        }
+    }
+};
+}
+
+TEST(OptimisedUtil,softwareVertexSkinning)
+{
+    // enough vertices to be split across the pool, not a multiple of 4
+    SkinningTestData data(5000 + 3);
+    OptimisedUtil::ImplementationList impls = OptimisedUtil::getAvailableImplementations();
+    ASSERT_EQ("General", impls[0].first);
+
+    ThreadPool pool(3);
+    for (int layout = 0; layout < 3; ++layout)
+    {
+        std::vector<float> expected, actual;
+        data.blend(impls[0].second, NULL, layout, expected);
+        for (size_t i = 0; i < impls.size() * 2; ++i)
+        {
+            data.blend(impls[i / 2].second, i % 2 ? &pool : NULL, layout, actual);
+            size_t numErrors = 0;
+            for (size_t f = 0; f < expected.size(); ++f)
+            {
+                // SSE normalises normals with an approximate reciprocal square root
+                if (std::abs(expected[f] - actual[f]) > 2e-3f && numErrors++ < 5)
+                    ADD_FAILURE() << impls[i / 2].first << (i % 2 ? " threaded" : "") << ", layout "
+                                  << layout << ", float " << f << ": " << expected[f] << " != " << actual[f];
+            }
+            EXPECT_EQ(0u, numErrors);
+        }
+    }
+}
+
+TEST(OptimisedUtil,softwareVertexSkinningBenchmark)
+{
+    const int numRuns = 100;
+    SkinningTestData data(16 * 1024);
+    OptimisedUtil::ImplementationList impls = OptimisedUtil::getAvailableImplementations();
+
+    ThreadPool pool(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+    std::vector<float> expected, actual;
+    data.blend(impls[0].second, NULL, 0, expected);
+    for (size_t i = 0; i < impls.size() * 2; ++i)
+    {
+        ThreadPool* threads = i % 2 ? &pool : NULL;
+        data.blend(impls[i / 2].second, threads, 0, actual);
+
+        // best of several runs, to filter out the noise of other processes
+        unsigned long micros = ~0ul;
+        for (int r = 0; r < numRuns; ++r)
+        {
+            Timer timer;
+            data.blend(impls[i / 2].second, threads, 0, actual);
+            micros = std::min(micros, timer.getMicroseconds());
+        }
+
+        float maxError = 0;
+        for (size_t f = 0; f < expected.size(); ++f)
+            maxError = std::max(maxError, std::abs(expected[f] - actual[f]));
+        EXPECT_LT(maxError, 2e-3f) << impls[i / 2].first;
+
+        LogManager::getSingleton().stream() << "skinning " << data.numVertices << " vertices, "
+            << impls[i / 2].first << (threads ? " threaded: " : ": ") << micros << " us per call, max error "
+            << maxError;
+    }
+}
@@ -0,0 +1,417 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreSceneNode.h"
+#include "OgreSceneManager.h"
+#include "OgreParticleSystem.h"
+#include "OgreParticleSystemManager.h"
+#include "OgreParticleEmitterFactory.h"
+#include "OgreParticleAffectorFactory.h"
+#include "OgreParticle.h"
+#include "OgreParticleSoA.h"
+#include "OgreControllerManager.h"
+#include "OgreMaterialManager.h"
+#include "OgreTimer.h"
+#include "OgreThreadPool.h"
+#include "OgreImage.h"
+#include "OgreConfigFile.h"
+#include "OgreFileSystemLayer.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreLogManager.h"
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace Ogre;
+
+namespace {
+/// Emits at a constant rate with attributes derived from a counter, so runs are repeatable
+class SoATestEmitter : public ParticleEmitter
+{
+    int mCount;
+public:
+    SoATestEmitter(ParticleSystem* psys) : ParticleEmitter(psys), mCount(0)
+    {
+        mType = "SoATest";
+        setEmissionRate(300);
+    }
+    unsigned short _getEmissionCount(Real timeElapsed) { return genConstantEmissionCount(timeElapsed); }
+    void _initParticle(Particle* p)
+    {
+        ++mCount;
+        p->resetDimensions();
+        p->mPosition = Vector3(mCount * 0.5f, 0, -mCount);
+        p->mDirection = Vector3(std::sin(Real(mCount)), 1 + Math::UnitRandom(), std::cos(Real(mCount))) * 10;
+        p->mColour = ColourValue(1, 0.5f, 0.25f, 1);
+        p->mTimeToLive = p->mTotalTimeToLive = 0.2f + (mCount % 7) * 0.1f;
+        p->mRotation = 0;
+        p->mRotationSpeed = Radian(0.5f * (mCount % 5));
+    }
+};
+/// Gravity and spin, with SoA support
+class SoATestForceAffector : public ParticleAffector
+{
+public:
+    SoATestForceAffector(ParticleSystem* psys) : ParticleAffector(psys) { mType = "SoATestForce"; }
+    void _affectParticles(ParticleSystem* pSystem, Real timeElapsed)
+    {
+        ParticleIterator pi = pSystem->_getIterator();
+        while (!pi.end())
+        {
+            Particle* p = pi.getNext();
+            p->mDirection.y -= 9.8f * timeElapsed;
+            p->setRotation(p->mRotation + timeElapsed * p->mRotationSpeed);
+        }
+    }
+    bool _affectParticlesSoA(ParticleSystem* pSystem, ParticleSoA& particles, Real timeElapsed)
+    {
+        for (size_t i = 0; i < particles.size(); ++i)
+        {
+            particles.mDirectionY[i] -= 9.8f * timeElapsed;
+            particles.mRotation[i] += timeElapsed * particles.mRotationSpeed[i];
+        }
+        pSystem->_notifyParticleRotated();
+        return true;
+    }
+};
+/// Fading and growth, only through the Particle objects
+class SoATestFadeAffector : public ParticleAffector
+{
+public:
+    SoATestFadeAffector(ParticleSystem* psys) : ParticleAffector(psys) { mType = "SoATestFade"; }
+    void _affectParticles(ParticleSystem* pSystem, Real timeElapsed)
+    {
+        ParticleIterator pi = pSystem->_getIterator();
+        while (!pi.end())
+        {
+            Particle* p = pi.getNext();
+            p->mColour.a -= 0.5f * timeElapsed;
+            Real w = p->hasOwnDimensions() ? p->getOwnWidth() : pSystem->getDefaultWidth();
+            p->setDimensions(w + timeElapsed, w + 2 * timeElapsed);
+        }
+    }
+};
+/// Set once a system has started updating its particles
+std::atomic<bool> gUpdatingParticles(false);
+/// Marks the start of the particle update, should come before the affectors it checks
+class UpdateMarkerAffector : public ParticleAffector
+{
+public:
+    UpdateMarkerAffector(ParticleSystem* psys) : ParticleAffector(psys) { mType = "UpdateMarker"; }
+    void _initParticle(Particle*) { gUpdatingParticles = true; }
+    void _affectParticles(ParticleSystem*, Real) { gUpdatingParticles = true; }
+};
+template<class T> struct SoATestAffectorFactory : public ParticleAffectorFactory
+{
+    String name;
+    SoATestAffectorFactory(const String& n) : name(n) {}
+    String getName() const { return name; }
+    ParticleAffector* createAffector(ParticleSystem* psys)
+    {
+        ParticleAffector* p = OGRE_NEW T(psys);
+        mAffectors.push_back(p);
+        return p;
+    }
+};
+struct SoATestEmitterFactory : public ParticleEmitterFactory
+{
+    String getName() const { return "SoATest"; }
+    ParticleEmitter* createEmitter(ParticleSystem* psys)
+    {
+        ParticleEmitter* e = OGRE_NEW SoATestEmitter(psys);
+        mEmitters.push_back(e);
+        return e;
+    }
+};
+
+std::vector<std::vector<Real> > getParticleState(ParticleSystem* ps)
+{
+    std::vector<std::vector<Real> > ret;
+    ParticleIterator pi = ps->_getIterator();
+    while (!pi.end())
+    {
+        Particle* p = pi.getNext();
+        // the size of recycled particles without own dimensions is left over from
+        // their previous life, which depends on the order they expired in
+        Real w = p->mOwnDimensions ? p->mWidth : 0, h = p->mOwnDimensions ? p->mHeight : 0;
+        Real v[] = {p->mTimeToLive, p->mPosition.x, p->mPosition.y, p->mPosition.z,
+                    p->mDirection.x, p->mDirection.y, p->mDirection.z, p->mColour.a,
+                    p->mRotation.valueRadians(), w, h, Real(p->mOwnDimensions)};
+        ret.push_back(std::vector<Real>(v, v + sizeof(v) / sizeof(v[0])));
+    }
+    // expiry reorders the SoA storage
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
+/// Records the threads resources are opened on, and whether any was opened during an update
+struct ThreadRecorder : public ResourceLoadingListener
+{
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    bool openedDuringUpdate;
+
+    ThreadRecorder() : openedDuringUpdate(false) {}
+
+    DataStreamPtr resourceLoading(const String&, const String&, Resource*) { return DataStreamPtr(); }
+    void resourceStreamOpened(const String&, const String&, Resource*, DataStreamPtr&)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.insert(std::this_thread::get_id());
+        openedDuringUpdate |= gUpdatingParticles;
+    }
+    bool resourceCollision(Resource*, ResourceManager*) { return false; }
+};
+}
+
+class ParticleSystemTest : public ::testing::Test
+{
+public:
+    // factories are not owned by the manager and must outlive the systems
+    SoATestEmitterFactory mEmitterFactory;
+    SoATestAffectorFactory<SoATestForceAffector> mForceFactory;
+    SoATestAffectorFactory<SoATestFadeAffector> mFadeFactory;
+    SoATestAffectorFactory<UpdateMarkerAffector> mMarkerFactory;
+    Root* mRoot;
+    // normally created by Root::initialise
+    ControllerManager* mControllerMgr;
+    SceneManager* mSceneMgr;
+
+    ParticleSystemTest() : mForceFactory("SoATestForce"), mFadeFactory("SoATestFade"), mMarkerFactory("UpdateMarker") {}
+
+    void SetUp()
+    {
+        mRoot = OGRE_NEW Root("");
+        mControllerMgr = OGRE_NEW ControllerManager();
+        MaterialManager::getSingleton().initialise();
+        ParticleSystemManager& psm = ParticleSystemManager::getSingleton();
+        psm._initialise();
+        psm.addEmitterFactory(&mEmitterFactory);
+        psm.addAffectorFactory(&mForceFactory);
+        psm.addAffectorFactory(&mFadeFactory);
+        psm.addAffectorFactory(&mMarkerFactory);
+        mSceneMgr = mRoot->createSceneManager();
+    }
+    void TearDown()
+    {
+        mRoot->destroySceneManager(mSceneMgr);
+        OGRE_DELETE mControllerMgr;
+        OGRE_DELETE mRoot;
+    }
+
+    ParticleSystem* createSystem(uint32 seed)
+    {
+        ParticleSystem* ps = mSceneMgr->createParticleSystem(500);
+        ps->addEmitter("SoATest");
+        ps->addAffector("SoATestForce");
+        ps->addAffector("SoATestFade");
+        ps->addAffector("SoATestForce");
+        // several iterations per update
+        ps->setIterationInterval(1 / 120.0f);
+        ps->setRandomSeed(seed);
+        mSceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(ps);
+        return ps;
+    }
+};
+
+TEST_F(ParticleSystemTest,soaStorage)
+{
+    ParticleSystem* systems[2] = {createSystem(42), createSystem(42)};
+    systems[1]->setParameter("soa_storage", "true");
+    EXPECT_TRUE(systems[1]->getSoAStorage());
+
+    for (int frame = 0; frame < 60; ++frame)
+    {
+        systems[0]->_update(1 / 30.0f);
+        systems[1]->_update(1 / 30.0f);
+    }
+
+    EXPECT_GT(systems[0]->getNumParticles(), 0u);
+    EXPECT_LT(systems[0]->getNumParticles(), 600u); // some expired
+    EXPECT_EQ(systems[0]->getNumParticles(), systems[1]->getNumParticles());
+    EXPECT_TRUE(getParticleState(systems[0]) == getParticleState(systems[1]));
+
+    // changes made through the Particle objects are picked up by the next update
+    for (int i = 0; i < 2; ++i)
+    {
+        ParticleIterator pi = systems[i]->_getIterator();
+        while (!pi.end())
+            pi.getNext()->mPosition.y += 100;
+        systems[i]->_update(1 / 30.0f);
+    }
+    EXPECT_TRUE(getParticleState(systems[0]) == getParticleState(systems[1]));
+}
+
+TEST_F(ParticleSystemTest,soaStorageBenchmark)
+{
+    const int numFrames = 120;
+    ParticleSystem* systems[2];
+    for (int i = 0; i < 2; ++i)
+    {
+        systems[i] = mSceneMgr->createParticleSystem(20000);
+        systems[i]->addEmitter("SoATest")->setEmissionRate(20000);
+        systems[i]->addAffector("SoATestForce");
+        systems[i]->setRandomSeed(7);
+        systems[i]->setSoAStorage(i == 1);
+        mSceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(systems[i]);
+    }
+
+    unsigned long times[2];
+    for (int i = 0; i < 2; ++i)
+    {
+        Timer timer;
+        for (int frame = 0; frame < numFrames; ++frame)
+            systems[i]->_update(1 / 60.0f);
+        times[i] = timer.getMicroseconds();
+    }
+
+    LogManager::getSingleton().stream() << numFrames << " updates of " << systems[0]->getNumParticles()
+        << " particles: list " << times[0] << " us, soa " << times[1] << " us";
+
+    EXPECT_GT(systems[0]->getNumParticles(), 1000u);
+    EXPECT_TRUE(getParticleState(systems[0]) == getParticleState(systems[1]));
+}
+
+TEST_F(ParticleSystemTest,parallelUpdate)
+{
+    const int numSystems = 16;
+    std::vector<ParticleSystem*> serial, parallel;
+    for (int i = 0; i < numSystems; ++i)
+    {
+        serial.push_back(createSystem(i));
+        parallel.push_back(createSystem(i));
+        parallel.back()->setSoAStorage(i % 2 == 0);
+    }
+
+    ParticleSystemManager& psm = ParticleSystemManager::getSingleton();
+    for (int frame = 0; frame < 30; ++frame)
+    {
+        for (int i = 0; i < numSystems; ++i)
+            serial[i]->_update(1 / 30.0f);
+
+        psm.setParallelUpdate(true);
+        // as done by the time controllers
+        for (int i = numSystems - 1; i >= 0; --i)
+            psm._queueUpdate(parallel[i], 1 / 30.0f);
+        psm._updateQueuedSystems();
+        psm.setParallelUpdate(false);
+    }
+
+    for (int i = 0; i < numSystems; ++i)
+    {
+        EXPECT_GT(parallel[i]->getNumParticles(), 0u);
+        EXPECT_TRUE(getParticleState(serial[i]) == getParticleState(parallel[i]));
+        EXPECT_EQ(serial[i]->getBoundingBox(), parallel[i]->getBoundingBox());
+    }
+    // the streams differ between the systems
+    EXPECT_FALSE(getParticleState(serial[0]) == getParticleState(serial[1]));
+}
+
+#ifndef OGRE_STATIC_LIB
+TEST_F(ParticleSystemTest,parallelColourImage)
+{
+    // the affector comes from ParticleFX
+    FileSystemLayer fsLayer(OGRE_VERSION_NAME);
+    ConfigFile cf;
+    cf.load(fsLayer.getConfigFilePath("plugins.cfg"));
+    StringVector plugins = cf.getMultiSetting("Plugin");
+    for (size_t i = 0; i < plugins.size(); ++i)
+    {
+        if (plugins[i].find("ParticleFX") != String::npos)
+            mRoot->loadPlugin(cf.getSetting("PluginFolder") + "/" + plugins[i]);
+    }
+    mRoot->getThreadPool()->setNumWorkerThreads(3);
+    ParticleSystemManager& psm = ParticleSystemManager::getSingleton();
+
+    // a colour ramp with varying alpha, in a format OgreMain decodes itself
+    const String dir = "./ParticleColourImageTest";
+    FileSystemLayer::createDirectory(dir);
+    uint32 ramp[16 * 16];
+    for (uint32 i = 0; i < 16 * 16; ++i)
+        ramp[i] = (0xFFu - i % 16 * 0x10u) << 24 | (i % 16 * 0x10u) << 16 | 0x80u;
+    Image image;
+    image.loadDynamicImage(reinterpret_cast<uchar*>(ramp), 16, 16, PF_A8R8G8B8);
+    image.save(dir + "/ramp.dds");
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+    rgm.addResourceLocation(dir, "FileSystem", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+    ThreadRecorder recorder;
+    rgm.setLoadingListener(&recorder);
+
+    // which thread runs an update depends on scheduling, so also check that
+    // nothing is loaded once the particle update has started
+    const int numSystems = 8;
+    std::vector<ParticleSystem*> serial, parallel;
+    for (int i = 0; i < 2 * numSystems; ++i)
+    {
+        ParticleSystem* ps = mSceneMgr->createParticleSystem(500);
+        ps->addEmitter("SoATest");
+        ps->addAffector("UpdateMarker");
+        ps->addAffector("ColourImage")->setParameter("image", "ramp.dds");
+        ps->setRandomSeed(i % numSystems);
+        mSceneMgr->getRootSceneNode()->createChildSceneNode()->attachObject(ps);
+        (i < numSystems ? serial : parallel).push_back(ps);
+    }
+
+    for (int frame = 0; frame < 30; ++frame)
+    {
+        for (int i = 0; i < numSystems; ++i)
+        {
+            serial[i]->_update(1 / 30.0f);
+            gUpdatingParticles = false;
+        }
+
+        psm.setParallelUpdate(true);
+        for (int i = 0; i < numSystems; ++i)
+            psm._queueUpdate(parallel[i], 1 / 30.0f);
+        psm._updateQueuedSystems();
+        psm.setParallelUpdate(false);
+        gUpdatingParticles = false;
+    }
+    rgm.setLoadingListener(0);
+
+    // each affector loaded its image before the update, on this thread only
+    EXPECT_FALSE(recorder.openedDuringUpdate);
+    ASSERT_EQ(1u, recorder.threads.size());
+    EXPECT_EQ(std::this_thread::get_id(), *recorder.threads.begin());
+    for (int i = 0; i < numSystems; ++i)
+    {
+        ASSERT_GT(parallel[i]->getNumParticles(), 0u);
+        EXPECT_LT(parallel[i]->getParticle(0)->mColour.a, 1);
+        EXPECT_TRUE(getParticleState(serial[i]) == getParticleState(parallel[i]));
+    }
+
+    rgm.removeResourceLocation(dir, ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    FileSystemLayer::removeFile(dir + "/ramp.dds");
+    FileSystemLayer::removeDirectory(dir);
+}
+#endif
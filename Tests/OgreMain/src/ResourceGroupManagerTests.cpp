@@ -0,0 +1,86 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreFileSystemLayer.h"
+
+#include <fstream>
+#include <thread>
+
+using namespace Ogre;
+
+TEST(ResourceGroupManager,resourceIndexCache)
+{
+    Root root("");
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+
+    const String dir = "./ResourceIndexCacheTest";
+    FileSystemLayer::createDirectory(dir);
+    FileSystemLayer::createDirectory(dir + "/sub");
+    std::ofstream((dir + "/sub/a.txt").c_str()) << "a";
+
+    rgm.setUseResourceIndexCache(true);
+    rgm.addResourceLocation(dir, "FileSystem", "IndexCache", true);
+    EXPECT_TRUE(rgm.resourceExists("IndexCache", "sub/a.txt"));
+    EXPECT_TRUE(rgm.isResourceIndexCacheDirty());
+
+    DataStreamPtr saved(OGRE_NEW MemoryDataStream(65536));
+    rgm.saveResourceIndexCache(saved);
+    saved->seek(0);
+    rgm.removeResourceLocation(dir, "IndexCache");
+    rgm.loadResourceIndexCache(saved);
+    EXPECT_FALSE(rgm.isResourceIndexCacheDirty());
+
+    // unchanged locations are indexed from the cache
+    rgm.addResourceLocation(dir, "FileSystem", "IndexCache", true);
+    EXPECT_TRUE(rgm.resourceExists("IndexCache", "sub/a.txt"));
+    EXPECT_FALSE(rgm.isResourceIndexCacheDirty());
+
+    // a file added to a subdirectory invalidates the entry
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    std::ofstream((dir + "/sub/b.txt").c_str()) << "b";
+    rgm.removeResourceLocation(dir, "IndexCache");
+    rgm.addResourceLocation(dir, "FileSystem", "IndexCache", true);
+    EXPECT_TRUE(rgm.resourceExists("IndexCache", "sub/b.txt"));
+    EXPECT_TRUE(rgm.isResourceIndexCacheDirty());
+
+    // invalid data is discarded
+    char garbage[64] = "not an index";
+    rgm.loadResourceIndexCache(DataStreamPtr(OGRE_NEW MemoryDataStream(garbage, sizeof(garbage))));
+    rgm.removeResourceLocation(dir, "IndexCache");
+    rgm.addResourceLocation(dir, "FileSystem", "IndexCache", true);
+    EXPECT_TRUE(rgm.resourceExists("IndexCache", "sub/a.txt"));
+    EXPECT_TRUE(rgm.isResourceIndexCacheDirty());
+
+    FileSystemLayer::removeFile(dir + "/sub/a.txt");
+    FileSystemLayer::removeFile(dir + "/sub/b.txt");
+    FileSystemLayer::removeDirectory(dir + "/sub");
+    FileSystemLayer::removeDirectory(dir);
+}
@@ -0,0 +1,375 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreSceneNode.h"
+#include "OgreSceneGraphTransformCache.h"
+#include "OgreCamera.h"
+#include "OgreThreadPool.h"
+#include "OgreMaterialManager.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreEntity.h"
+#include "OgreMeshManager.h"
+#include "OgreSceneQueryBroadPhase.h"
+
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1600)
+#include <random>
+using std::minstd_rand;
+#else
+#include <tr1/random>
+using std::tr1::minstd_rand;
+#endif
+
+using namespace Ogre;
+
+static void createRandomHierarchy(SceneManager* mgr, size_t nodeCount, std::vector<SceneNode*>& nodes)
+{
+    // we want cross platform consistent sequence
+    minstd_rand rng;
+
+    nodes.push_back(mgr->getRootSceneNode());
+    for (size_t n = 0; n < nodeCount; ++n)
+    {
+        SceneNode* parent = nodes[rng() % nodes.size()];
+        SceneNode* node = parent->createChildSceneNode(
+            Vector3(float(rng() % 200) - 100, float(rng() % 200) - 100, float(rng() % 200) - 100),
+            Quaternion(Degree(float(rng() % 360)), Vector3(1, float(rng() % 10), 2).normalisedCopy()));
+        node->setScale(Vector3(0.5f + float(rng() % 100) / 50));
+        node->setInheritOrientation(rng() % 8 != 0);
+        node->setInheritScale(rng() % 8 != 0);
+        nodes.push_back(node);
+    }
+}
+
+TEST(SceneManager,parallelSceneGraphUpdate)
+{
+    Root root;
+    SceneManager* serialMgr = root.createSceneManager();
+    SceneManager* parallelMgr = root.createSceneManager();
+    parallelMgr->setParallelSceneGraphUpdate(true);
+    ASSERT_TRUE(parallelMgr->getParallelSceneGraphUpdate());
+
+    std::vector<SceneNode*> serial, parallel;
+    createRandomHierarchy(serialMgr, 5000, serial);
+    createRandomHierarchy(parallelMgr, 5000, parallel);
+
+    minstd_rand rng;
+    for (int frame = 0; frame < 4; ++frame)
+    {
+        serialMgr->_updateSceneGraph(NULL);
+        parallelMgr->_updateSceneGraph(NULL);
+
+        for (size_t i = 0; i < serial.size(); ++i)
+        {
+            // compare the raw bits, the results must be identical
+            ASSERT_EQ(0, memcmp(&serial[i]->_getFullTransform(), &parallel[i]->_getFullTransform(),
+                                sizeof(Affine3)));
+            ASSERT_EQ(0, memcmp(serial[i]->_getDerivedOrientation().ptr(),
+                                parallel[i]->_getDerivedOrientation().ptr(), sizeof(Quaternion)));
+        }
+
+        // move a few nodes and reparent one subtree
+        for (int n = 0; n < 50; ++n)
+        {
+            size_t i = 1 + rng() % (serial.size() - 1);
+            serial[i]->translate(Vector3(1, 2, 3));
+            parallel[i]->translate(Vector3(1, 2, 3));
+        }
+        size_t i = 1 + rng() % (serial.size() - 1);
+        serial[i]->getParent()->removeChild(serial[i]);
+        serialMgr->getRootSceneNode()->addChild(serial[i]);
+        parallel[i]->getParent()->removeChild(parallel[i]);
+        parallelMgr->getRootSceneNode()->addChild(parallel[i]);
+    }
+
+    parallelMgr->_updateSceneGraph(NULL);
+    SceneGraphTransformCache* cache = parallelMgr->_getTransformCache();
+    ASSERT_EQ(parallel.size(), cache->getNumNodes());
+    for (size_t i = 0; i < cache->getNumNodes(); ++i)
+    {
+        EXPECT_EQ(cache->getNode(i)->_getDerivedPosition(), cache->getDerivedPosition(i));
+    }
+}
+
+namespace
+{
+/// records the order in which objects are queued
+struct CullRecorder : public MovableObject
+{
+    std::vector<int>* queued;
+    int index;
+    AxisAlignedBox box;
+
+    CullRecorder(std::vector<int>* q, int i) : queued(q), index(i), box(-5, -5, -5, 5, 5, 5) {}
+    const String& getMovableType(void) const { static String type = "CullRecorder"; return type; }
+    const AxisAlignedBox& getBoundingBox(void) const { return box; }
+    Real getBoundingRadius(void) const { return box.getHalfSize().length(); }
+    void _updateRenderQueue(RenderQueue*) { queued->push_back(index); }
+    void visitRenderables(Renderable::Visitor*, bool) {}
+};
+}
+
+TEST(SceneManager,parallelCulling)
+{
+    Root root;
+    // for the cameras, the scene managers are destroyed explicitly before these go away
+    DefaultHardwareBufferManager hbm;
+    MaterialManager::getSingleton().initialise();
+    root.getThreadPool()->setNumWorkerThreads(3);
+
+    SceneManager* mgrs[2] = {root.createSceneManager(), root.createSceneManager()};
+    mgrs[1]->setParallelCulling(true);
+    ASSERT_TRUE(mgrs[1]->getParallelCulling());
+
+    std::vector<int> queued[2];
+    std::vector<CullRecorder*> objects;
+    Camera* cams[2];
+    for (int m = 0; m < 2; ++m)
+    {
+        std::vector<SceneNode*> nodes;
+        createRandomHierarchy(mgrs[m], 3000, nodes);
+        for (size_t i = 1; i < nodes.size(); ++i)
+        {
+            objects.push_back(new CullRecorder(&queued[m], int(i)));
+            nodes[i]->attachObject(objects.back());
+        }
+        mgrs[m]->_updateSceneGraph(NULL);
+
+        cams[m] = mgrs[m]->createCamera("cam");
+        mgrs[m]->getRootSceneNode()->attachObject(cams[m]);
+        cams[m]->setNearClipDistance(1);
+        cams[m]->setFarClipDistance(300);
+        cams[m]->setAspectRatio(1);
+    }
+
+    const Vector3 dirs[] = {Vector3::UNIT_X, Vector3::NEGATIVE_UNIT_Z, Vector3(1, 1, 1)};
+    for (const Vector3& dir : dirs)
+    {
+        VisibleObjectsBoundsInfo bounds[2];
+        for (int m = 0; m < 2; ++m)
+        {
+            queued[m].clear();
+            bounds[m].reset();
+            cams[m]->setDirection(dir);
+            mgrs[m]->getRenderQueue()->clear();
+            mgrs[m]->_findVisibleObjects(cams[m], &bounds[m], false);
+        }
+
+        EXPECT_FALSE(queued[0].empty());
+        EXPECT_LT(queued[0].size(), objects.size() / 2);
+        EXPECT_EQ(queued[0], queued[1]);
+        EXPECT_EQ(bounds[0].aabb, bounds[1].aabb);
+        EXPECT_EQ(bounds[0].minDistance, bounds[1].minDistance);
+        EXPECT_EQ(bounds[0].maxDistance, bounds[1].maxDistance);
+    }
+
+    root.destroySceneManager(mgrs[0]);
+    root.destroySceneManager(mgrs[1]);
+    for (CullRecorder* o : objects)
+        delete o;
+}
+
+namespace
+{
+typedef std::vector<std::pair<String, String> > NamePairs;
+
+/// the results the default queries gave by testing every object
+struct BruteForceQueries
+{
+    std::vector<MovableObject*> objects;
+
+    BruteForceQueries(SceneManager* mgr)
+    {
+        SceneManager::MovableObjectIterator it = mgr->getMovableObjectIterator("Entity");
+        while (it.hasMoreElements())
+        {
+            MovableObject* a = it.getNext();
+            if (a->isInScene())
+                objects.push_back(a);
+        }
+    }
+
+    std::set<String> box(const AxisAlignedBox& box) const
+    {
+        std::set<String> ret;
+        for (MovableObject* a : objects)
+            if (box.intersects(a->getWorldBoundingBox()))
+                ret.insert(a->getName());
+        return ret;
+    }
+
+    std::set<String> volume(const PlaneBoundedVolume& volume) const
+    {
+        std::set<String> ret;
+        for (MovableObject* a : objects)
+            if (volume.intersects(a->getWorldBoundingBox()))
+                ret.insert(a->getName());
+        return ret;
+    }
+
+    std::set<String> sphere(const Sphere& sphere) const
+    {
+        std::set<String> ret;
+        for (MovableObject* a : objects)
+            if (sphere.intersects(Sphere(a->getParentNode()->_getDerivedPosition(), a->getBoundingRadius())))
+                ret.insert(a->getName());
+        return ret;
+    }
+
+    std::set<String> ray(const Ray& ray) const
+    {
+        std::set<String> ret;
+        for (MovableObject* a : objects)
+            if (ray.intersects(a->getWorldBoundingBox()).first)
+                ret.insert(a->getName());
+        return ret;
+    }
+
+    NamePairs intersections() const
+    {
+        NamePairs ret;
+        for (size_t i = 0; i < objects.size(); ++i)
+            for (size_t j = i + 1; j < objects.size(); ++j)
+                if (objects[i]->getWorldBoundingBox().intersects(objects[j]->getWorldBoundingBox()))
+                    ret.push_back(std::make_pair(objects[i]->getName(), objects[j]->getName()));
+        return ret;
+    }
+};
+
+std::set<String> resultNames(const SceneQueryResultMovableList& movables)
+{
+    std::set<String> ret;
+    for (MovableObject* a : movables)
+        EXPECT_TRUE(ret.insert(a->getName()).second);
+    return ret;
+}
+}
+
+TEST(SceneManager,sceneQueryBroadPhase)
+{
+    Root root;
+    DefaultHardwareBufferManager hbm;
+    MaterialManager::getSingleton().initialise();
+    MeshManager::getSingleton()._initialise();
+    SceneManager* mgr = root.createSceneManager();
+
+    minstd_rand rng;
+    std::vector<SceneNode*> nodes;
+    for (int i = 0; i < 400; ++i)
+    {
+        SceneNode* node = mgr->getRootSceneNode()->createChildSceneNode(
+            Vector3(float(rng() % 4000), float(rng() % 4000), float(rng() % 4000)) - 2000);
+        node->setScale(Vector3(0.2f + float(rng() % 100) / 50));
+        node->attachObject(mgr->createEntity("Prefab_Cube"));
+        nodes.push_back(node);
+    }
+    mgr->_updateSceneGraph(NULL);
+
+    AxisAlignedBoxSceneQuery* boxQuery = mgr->createAABBQuery(AxisAlignedBox());
+    SphereSceneQuery* sphereQuery = mgr->createSphereQuery(Sphere());
+    RaySceneQuery* rayQuery = mgr->createRayQuery(Ray());
+    PlaneBoundedVolumeListSceneQuery* volumeQuery = mgr->createPlaneBoundedVolumeQuery(PlaneBoundedVolumeList());
+    IntersectionSceneQuery* intersectionQuery = mgr->createIntersectionQuery();
+
+    for (int round = 0; round < 4; ++round)
+    {
+        BruteForceQueries expected(mgr);
+
+        for (int q = 0; q < 20; ++q)
+        {
+            Vector3 centre = Vector3(float(rng() % 4000), float(rng() % 4000), float(rng() % 4000)) - 2000;
+            Vector3 halfSize(float(rng() % 600 + 1), float(rng() % 600 + 1), float(rng() % 600 + 1));
+            AxisAlignedBox box(centre - halfSize, centre + halfSize);
+
+            boxQuery->setBox(box);
+            EXPECT_EQ(expected.box(box), resultNames(boxQuery->execute().movables));
+
+            PlaneBoundedVolume volume;
+            volume.planes.push_back(Plane(Vector3::UNIT_X, box.getMinimum()));
+            volume.planes.push_back(Plane(Vector3::NEGATIVE_UNIT_X, box.getMaximum()));
+            volume.planes.push_back(Plane(Vector3::UNIT_Y, box.getMinimum()));
+            volume.planes.push_back(Plane(Vector3::NEGATIVE_UNIT_Y, box.getMaximum()));
+            volume.planes.push_back(Plane(Vector3::UNIT_Z, box.getMinimum()));
+            volume.planes.push_back(Plane(Vector3::NEGATIVE_UNIT_Z, box.getMaximum()));
+            volumeQuery->setVolumes(PlaneBoundedVolumeList(1, volume));
+            EXPECT_EQ(expected.volume(volume), resultNames(volumeQuery->execute().movables));
+
+            Sphere sphere(centre, halfSize.x);
+            sphereQuery->setSphere(sphere);
+            EXPECT_EQ(expected.sphere(sphere), resultNames(sphereQuery->execute().movables));
+
+            Ray ray(centre, halfSize.normalisedCopy());
+            rayQuery->setRay(ray);
+            std::set<String> hit;
+            for (const RaySceneQueryResultEntry& entry : rayQuery->execute())
+                hit.insert(entry.movable->getName());
+            EXPECT_EQ(expected.ray(ray), hit);
+        }
+
+        NamePairs pairs;
+        for (const SceneQueryMovableObjectPair& pair : intersectionQuery->execute().movables2movables)
+            pairs.push_back(std::make_pair(pair.first->getName(), pair.second->getName()));
+        EXPECT_FALSE(pairs.empty());
+        EXPECT_EQ(expected.intersections(), pairs);
+
+        // move some nodes, detach, reattach and replace some objects
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            switch (rng() % 8)
+            {
+            case 0:
+                nodes[i]->translate(Vector3(float(rng() % 40), float(rng() % 40), float(rng() % 40)) - 20);
+                break;
+            case 1:
+                nodes[i]->setPosition(Vector3(float(rng() % 4000), float(rng() % 4000), float(rng() % 4000)) - 2000);
+                break;
+            case 2:
+                if (nodes[i]->numAttachedObjects())
+                    nodes[i]->detachAllObjects();
+                else
+                    nodes[i]->attachObject(mgr->createEntity("Prefab_Cube"));
+                break;
+            case 3:
+                if (nodes[i]->numAttachedObjects())
+                    mgr->destroyMovableObject(nodes[i]->getAttachedObject(0));
+                break;
+            }
+        }
+        mgr->_updateSceneGraph(NULL);
+    }
+
+    SceneQueryBroadPhase* broadPhase = mgr->_getSceneQueryBroadPhase(false);
+    ASSERT_TRUE(broadPhase);
+    EXPECT_GT(broadPhase->getNumBoundedObjects(), 0u);
+    EXPECT_EQ(0u, broadPhase->getNumUnboundedObjects());
+
+    root.destroySceneManager(mgr);
+    // the meshes use buffers of hbm
+    MeshManager::getSingleton().removeAll();
+}
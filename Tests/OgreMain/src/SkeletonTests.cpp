@@ -0,0 +1,193 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreSkeletonManager.h"
+#include "OgreSkeleton.h"
+#include "OgreBone.h"
+#include "OgreBonePoseBuffer.h"
+#include "OgreAnimation.h"
+#include "OgreAnimationTrack.h"
+#include "OgreAnimationState.h"
+#include "OgreKeyFrame.h"
+
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1600)
+#include <random>
+using std::minstd_rand;
+#else
+#include <tr1/random>
+using std::tr1::minstd_rand;
+#endif
+
+using namespace Ogre;
+
+TEST(Skeleton,poseBuffer)
+{
+    Root root;
+    SkeletonPtr skel = SkeletonManager::getSingleton().create("poseBuffer", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+    // random hierarchy, children are created before some of their parents
+    minstd_rand rng;
+    const int numBones = 60;
+    for (int i = 0; i < numBones; ++i)
+        skel->createBone(i);
+    for (int i = 0; i < numBones; ++i)
+    {
+        Bone* bone = skel->getBone(i);
+        if (i != 7 && i != 23)
+            skel->getBone(i < 7 ? 7 : rng() % i)->addChild(bone);
+        bone->setPosition(float(rng() % 100) - 50, float(rng() % 100) - 50, float(rng() % 100));
+        bone->setOrientation(Quaternion(Degree(float(rng() % 360)), Vector3(1, 2, float(i)).normalisedCopy()));
+        bone->setScale(1 + float(rng() % 10) / 10, 1, 1 + float(rng() % 5) / 10);
+        bone->setInheritOrientation(i % 11 != 5);
+        bone->setInheritScale(i % 13 != 6);
+    }
+    skel->setBindingPose();
+
+    Node::Listener listener;
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (int i = 0; i < numBones; ++i)
+        {
+            skel->getBone(i)->roll(Degree(float(rng() % 90)));
+            skel->getBone(i)->translate(Vector3(1, float(pass), 2));
+        }
+
+        std::vector<Affine3> matrices(numBones);
+        std::vector<Vector3> positions;
+        skel->_getBoneMatrices(&matrices[0]);
+        // the buffer is only used without listeners or tag points
+        EXPECT_EQ(pass == 0, skel->_getPoseBuffer()->isValid());
+        for (int i = 0; i < numBones; ++i)
+            positions.push_back(skel->getBone(i)->_getDerivedPosition());
+
+        // compare with the recursive update
+        for (Bone* bone : skel->getRootBones())
+            bone->_update(true, true);
+        for (int i = 0; i < numBones; ++i)
+        {
+            Affine3 expected;
+            skel->getBone(i)->_getOffsetTransform(expected);
+            EXPECT_EQ(0, memcmp(&expected, &matrices[i], sizeof(Affine3)));
+            EXPECT_EQ(positions[i], skel->getBone(i)->_getDerivedPosition());
+        }
+
+        // not supported by the buffer
+        skel->getBone(3)->setListener(&listener);
+    }
+    skel->getBone(3)->setListener(NULL);
+}
+
+TEST(Skeleton,batchedBlending)
+{
+    Root root;
+    SkeletonPtr skel = SkeletonManager::getSingleton().create("batchedBlending", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    // opt-in
+    EXPECT_FALSE(skel->getBatchedBlending());
+
+    minstd_rand rng;
+    const int numBones = 20;
+    for (int i = 0; i < numBones; ++i)
+    {
+        Bone* bone = skel->createBone(i);
+        if (i > 0)
+            skel->getBone(rng() % i)->addChild(bone);
+        bone->setPosition(float(rng() % 10), 1, 2);
+        bone->setOrientation(Quaternion(Degree(float(rng() % 360)), Vector3::UNIT_Y));
+    }
+    skel->setBindingPose();
+    Bone* manual = skel->getBone(5);
+    manual->setManuallyControlled(true);
+
+    // layered animations animating different subsets of the bones
+    for (int a = 0; a < 4; ++a)
+    {
+        Animation* anim = skel->createAnimation("anim" + StringConverter::toString(a), 2);
+        if (a == 3)
+            anim->setRotationInterpolationMode(Animation::RIM_SPHERICAL);
+        for (int i = a; i < numBones; i += a + 1)
+        {
+            NodeAnimationTrack* track = anim->createNodeTrack(i, skel->getBone(i));
+            for (int k = 0; k < 5; ++k)
+            {
+                TransformKeyFrame* kf = track->createNodeKeyFrame(k * 0.5f);
+                kf->setTranslate(Vector3(float(rng() % 10), float(k), 0));
+                kf->setRotation(Quaternion(Degree(float(rng() % 90)), Vector3(1, 1, float(k)).normalisedCopy()));
+                kf->setScale(Vector3(1, 1 + k * 0.1f, 1));
+            }
+        }
+    }
+
+    AnimationStateSet states;
+    skel->_initAnimationState(&states);
+    for (int a = 0; a < 4; ++a)
+    {
+        AnimationState* state = states.getAnimationState("anim" + StringConverter::toString(a));
+        state->setEnabled(true);
+        state->setWeight(0.2f + a * 0.3f);
+        state->setTimePosition(0.3f * (a + 1));
+    }
+    AnimationState* masked = states.getAnimationState("anim1");
+    masked->createBlendMask(numBones, 0.5f);
+    masked->setBlendMaskEntry(3, 0);
+    masked->setBlendMaskEntry(7, 1);
+
+    for (int mode = 0; mode < 2; ++mode)
+    {
+        skel->setBlendMode(mode == 0 ? ANIMBLEND_AVERAGE : ANIMBLEND_CUMULATIVE);
+
+        // manual bones are not reset, animations are applied on top
+        manual->setPosition(3, 4, 5);
+        manual->setOrientation(Quaternion::IDENTITY);
+        manual->setScale(Vector3::UNIT_SCALE);
+        skel->setBatchedBlending(false);
+        skel->setAnimationState(states);
+        std::vector<Vector3> positions, scales;
+        std::vector<Quaternion> orientations;
+        for (int i = 0; i < numBones; ++i)
+        {
+            positions.push_back(skel->getBone(i)->getPosition());
+            orientations.push_back(skel->getBone(i)->getOrientation());
+            scales.push_back(skel->getBone(i)->getScale());
+        }
+
+        manual->setPosition(3, 4, 5);
+        manual->setOrientation(Quaternion::IDENTITY);
+        manual->setScale(Vector3::UNIT_SCALE);
+        skel->setBatchedBlending(true);
+        skel->setAnimationState(states);
+        for (int i = 0; i < numBones; ++i)
+        {
+            Bone* bone = skel->getBone(i);
+            EXPECT_EQ(0, memcmp(&positions[i], &bone->getPosition(), sizeof(Vector3)));
+            EXPECT_EQ(0, memcmp(&orientations[i], &bone->getOrientation(), sizeof(Quaternion)));
+            EXPECT_EQ(0, memcmp(&scales[i], &bone->getScale(), sizeof(Vector3)));
+        }
+    }
+}
@@ -0,0 +1,291 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreTimer.h"
+#include "OgreLogManager.h"
+#include "Threading/OgreDefaultWorkQueue.h"
+
+// the TBB thread provider has its own task based DefaultWorkQueue and no WorkStealingWorkQueue
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+
+#include "Threading/OgreWorkStealingWorkQueue.h"
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
+using namespace Ogre;
+
+namespace
+{
+    /// Counts requests, fails the first attempt of odd requests and spawns children from channel 0
+    struct CountingHandler : public WorkQueue::RequestHandler, public WorkQueue::ResponseHandler
+    {
+        AtomicScalar<size_t> handled;
+        AtomicScalar<size_t> failed;
+        size_t responses;
+        size_t spin;
+
+        CountingHandler(size_t spinCount = 0) : handled(0), failed(0), responses(0), spin(spinCount) {}
+
+        WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+        {
+            // a little bit of work, so the benchmark is not purely measuring queue overhead
+            volatile size_t sink = 0;
+            for (size_t i = 0; i < spin; ++i)
+                sink = sink + i;
+
+            ++handled;
+            if (req->getType() == 1 && req->getRetryCount())
+            {
+                ++failed;
+                return OGRE_NEW WorkQueue::Response(req, false, Any());
+            }
+            if (req->getType() == 2)
+            {
+                // requests added from a worker thread
+                const_cast<WorkQueue*>(srcQ)->addRequest(req->getChannel(), 0, Any());
+            }
+            return OGRE_NEW WorkQueue::Response(req, true, Any());
+        }
+
+        void handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
+        {
+            EXPECT_TRUE(res->succeeded());
+            ++responses;
+        }
+    };
+
+    void pumpResponses(WorkQueue* queue, CountingHandler& handler, size_t expected)
+    {
+        Timer timer;
+        while (handler.responses < expected && timer.getMilliseconds() < 30000)
+        {
+            queue->processResponses();
+            OGRE_THREAD_YIELD;
+        }
+    }
+
+    /// Records the order in which request types reach the handler
+    struct OrderHandler : public WorkQueue::RequestHandler, public WorkQueue::ResponseHandler
+    {
+        std::vector<uint16> order;
+
+        WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+        {
+            order.push_back(req->getType());
+            return OGRE_NEW WorkQueue::Response(req, true, Any());
+        }
+
+        void handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ) {}
+    };
+
+    /// Queue requests without starting the workers and process them on this thread
+    void checkPriorityOrder(DefaultWorkQueueBase* queue)
+    {
+        OrderHandler handler;
+        uint16 channel = queue->getChannel("test");
+        queue->addRequestHandler(channel, &handler);
+        queue->addResponseHandler(channel, &handler);
+
+        queue->addRequest(channel, 1, Any());
+        queue->addRequest(channel, 2, Any(), 0, false, false, 5);
+        WorkQueue::RequestID promoted = queue->addRequest(channel, 3, Any(), 0, false, false, -1);
+        queue->addRequest(channel, 4, Any(), 0, false, false, 3);
+        queue->addRequest(channel, 5, Any(), 0, false, false, -2);
+        WorkQueue::RequestID demoted = queue->addRequest(channel, 6, Any());
+        // expires before anything is processed, so it is dropped without a response
+        queue->addRequest(channel, 7, Any(), 0, false, false, 100, 1);
+        WorkQueue::RequestID promotedDefault = queue->addRequest(channel, 8, Any());
+        queue->setRequestPriority(promoted, 10);
+        queue->setRequestPriority(promotedDefault, 20);
+        queue->setRequestPriority(demoted, -5);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        for (int i = 0; i < 8; ++i)
+            queue->_processNextRequest();
+        queue->processResponses();
+
+        uint16 expected[] = {8, 3, 2, 4, 1, 5, 6};
+        ASSERT_EQ(7u, handler.order.size());
+        for (size_t i = 0; i < handler.order.size(); ++i)
+            EXPECT_EQ(expected[i], handler.order[i]);
+
+        queue->removeRequestHandler(channel, &handler);
+        queue->removeResponseHandler(channel, &handler);
+    }
+
+    /// Records the ID of every request it handles
+    struct RecordingHandler : public CountingHandler
+    {
+        std::mutex mutex;
+        std::vector<WorkQueue::RequestID> ids;
+
+        RecordingHandler(size_t spinCount) : CountingHandler(spinCount) {}
+
+        WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ids.push_back(req->getID());
+            }
+            return CountingHandler::handleRequest(req, srcQ);
+        }
+    };
+
+    /** Has numProducers threads add requestsPerProducer each, checks every request is
+        handled and answered exactly once and returns the time taken in microseconds. */
+    unsigned long runContention(DefaultWorkQueueBase* queue, size_t numProducers, size_t requestsPerProducer)
+    {
+        RecordingHandler handler(200);
+        queue->setWorkerThreadCount(3);
+        queue->addRequestHandler(0, &handler);
+        queue->addResponseHandler(0, &handler);
+        queue->startup();
+
+        Timer timer;
+        std::vector<std::vector<WorkQueue::RequestID> > added(numProducers);
+        std::vector<std::thread> producers;
+        for (size_t p = 0; p < numProducers; ++p)
+        {
+            std::vector<WorkQueue::RequestID>* ids = &added[p];
+            producers.push_back(std::thread([queue, requestsPerProducer, ids]() {
+                for (size_t i = 0; i < requestsPerProducer; ++i)
+                    ids->push_back(queue->addRequest(0, 0, Any()));
+            }));
+        }
+        for (size_t p = 0; p < producers.size(); ++p)
+            producers[p].join();
+
+        size_t expected = numProducers * requestsPerProducer;
+        pumpResponses(queue, handler, expected);
+        unsigned long elapsed = timer.getMicroseconds();
+
+        EXPECT_EQ(expected, handler.responses);
+        EXPECT_EQ(expected, handler.handled.load());
+
+        // each producer gets increasing IDs, and every ID is handled exactly once
+        std::vector<WorkQueue::RequestID> allAdded;
+        for (size_t p = 0; p < numProducers; ++p)
+        {
+            EXPECT_TRUE(std::is_sorted(added[p].begin(), added[p].end()));
+            allAdded.insert(allAdded.end(), added[p].begin(), added[p].end());
+        }
+        std::sort(allAdded.begin(), allAdded.end());
+        std::sort(handler.ids.begin(), handler.ids.end());
+        EXPECT_TRUE(std::adjacent_find(allAdded.begin(), allAdded.end()) == allAdded.end());
+        EXPECT_TRUE(allAdded == handler.ids);
+
+        queue->shutdown();
+        queue->removeRequestHandler(0, &handler);
+        queue->removeResponseHandler(0, &handler);
+        return elapsed;
+    }
+}
+
+TEST(WorkQueue,workStealingRequests)
+{
+    Root root;
+    WorkStealingWorkQueue queue("test");
+    CountingHandler handler;
+    uint16 channel = queue.getChannel("test");
+    queue.addRequestHandler(channel, &handler);
+    queue.addResponseHandler(channel, &handler);
+    queue.setResponseProcessingTimeLimit(0);
+
+    // queued before startup, so nothing has been picked up yet
+    const size_t count = 1000;
+    WorkQueue::RequestID aborted = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        // type 1 fails once and is retried, type 2 adds another request from the worker
+        WorkQueue::RequestID rid = queue.addRequest(channel, uint16(i % 3), Any(), i % 3 == 1 ? 1 : 0);
+        if (i == 3)
+            aborted = rid;
+    }
+    EXPECT_TRUE(queue.abortPendingRequest(aborted));
+    EXPECT_FALSE(queue.abortPendingRequest(0xffffffff));
+    EXPECT_EQ(count, queue.getPendingRequestCount());
+
+    queue.setWorkerThreadCount(3);
+    queue.startup();
+
+    // the aborted request gets no response, each type 2 request produces one more
+    size_t numChildren = count / 3;
+    size_t expected = count - 1 + numChildren;
+    pumpResponses(&queue, handler, expected);
+    EXPECT_EQ(expected, handler.responses);
+    EXPECT_EQ(count / 3, handler.failed.load());
+
+    // forced synchronous requests are answered before addRequest returns
+    queue.addRequest(channel, 0, Any(), 0, true);
+    EXPECT_EQ(expected + 1, handler.responses);
+
+    // idle thread requests
+    for (size_t i = 0; i < 10; ++i)
+        queue.addRequest(channel, 0, Any(), 0, false, true);
+    pumpResponses(&queue, handler, expected + 11);
+    EXPECT_EQ(expected + 11, handler.responses);
+
+    queue.shutdown();
+    EXPECT_EQ(0u, queue.getPendingRequestCount());
+}
+
+TEST(WorkQueue,requestPriorities)
+{
+    Root root;
+
+    DefaultWorkQueue defaultQueue("default");
+    checkPriorityOrder(&defaultQueue);
+
+    WorkStealingWorkQueue stealingQueue("stealing");
+    checkPriorityOrder(&stealingQueue);
+}
+
+TEST(WorkQueue,contention)
+{
+    Root root;
+
+    const size_t numProducers = 4;
+    const size_t requestsPerProducer = 5000;
+
+    DefaultWorkQueue defaultQueue("default");
+    unsigned long defaultTime = runContention(&defaultQueue, numProducers, requestsPerProducer);
+
+    WorkStealingWorkQueue stealingQueue("stealing");
+    unsigned long stealingTime = runContention(&stealingQueue, numProducers, requestsPerProducer);
+    EXPECT_LE(stealingQueue.getStolenRequestCount(), numProducers * requestsPerProducer);
+
+    LogManager::getSingleton().stream() << numProducers << " producers x " << requestsPerProducer
+        << " requests, 3 workers: DefaultWorkQueue " << defaultTime / 1000.0
+        << " ms, WorkStealingWorkQueue " << stealingTime / 1000.0 << " ms ("
+        << stealingQueue.getStolenRequestCount() << " stolen)";
+}
+
+#endif
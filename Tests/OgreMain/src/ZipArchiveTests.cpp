@@ -30,6 +30,9 @@ THE SOFTWARE.
 #include "OgreCommon.h"
 #include "OgreConfigFile.h"
 #include "OgreFileSystemLayer.h"
+#include "OgreException.h"
+
+#include <fstream>
 
 using namespace Ogre;
 
@@ -250,3 +253,149 @@ TEST_F(ZipArchiveTests,ReadInterleave)
     EXPECT_TRUE(stream2->eof());
 }
 //--------------------------------------------------------------------------
+TEST_F(ZipArchiveTests,FileNotFound)
+{
+    EXPECT_THROW(arch->open("missing.txt"), FileNotFoundException);
+    EXPECT_FALSE(arch->exists("missing.txt"));
+    EXPECT_TRUE(arch->find("missing.txt")->empty());
+}
+//--------------------------------------------------------------------------
+TEST_F(ZipArchiveTests,EmptyStoredFile)
+{
+    DataStreamPtr stream = arch->open("level1/materials/scripts/file.material");
+    EXPECT_EQ((size_t)0, stream->size());
+    EXPECT_TRUE(stream->eof());
+}
+//--------------------------------------------------------------------------
+//--------------------------------------------------------------------------
+namespace {
+    /// Content of deflated/data.bin
+    std::vector<char> mixedArchiveData()
+    {
+        std::vector<char> data(100000);
+        uint32 x = 1;
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            x = (x * 1103515245 + 12345) & 0x7fffffff;
+            data[i] = char('a' + (x >> 16) % 16);
+        }
+        return data;
+    }
+
+    std::vector<uint8> readFile(const String& path)
+    {
+        std::ifstream file(path.c_str(), std::ios::binary);
+        return std::vector<uint8>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    bool xorDecrypt(size_t pos, void* buf, size_t len)
+    {
+        for (size_t i = 0; i < len; ++i)
+            static_cast<uint8*>(buf)[i] ^= 0x5A;
+        return true;
+    }
+}
+//--------------------------------------------------------------------------
+void ZipArchiveMixedTests::SetUp()
+{
+    Ogre::ConfigFile cf;
+    cf.load(Ogre::FileSystemLayer(OGRE_VERSION_NAME).getConfigFilePath("resources.cfg"));
+    archivePath = cf.getSettings("Tests").begin()->second+"/misc/ArchiveTestMixed.zip";
+}
+//--------------------------------------------------------------------------
+void ZipArchiveMixedTests::checkArchive(Archive* arch)
+{
+    arch->load();
+
+    StringVectorPtr files = arch->list(true);
+    ASSERT_EQ((size_t)2, files->size());
+    EXPECT_EQ(String("stored.txt"), files->at(0));
+    EXPECT_EQ(fileId("deflated/data.bin"), files->at(1));
+
+    StringVectorPtr dirs = arch->list(true, true);
+    ASSERT_EQ((size_t)1, dirs->size());
+    EXPECT_EQ(String("deflated"), dirs->at(0));
+
+    FileInfoListPtr infos = arch->findFileInfo("*.bin", true);
+    ASSERT_EQ((size_t)1, infos->size());
+    EXPECT_EQ(String("deflated/"), infos->at(0).path);
+    EXPECT_EQ((size_t)100000, infos->at(0).uncompressedSize);
+    EXPECT_LT(infos->at(0).compressedSize, infos->at(0).uncompressedSize);
+
+    // stored
+    DataStreamPtr stored = arch->open("stored.txt");
+    EXPECT_EQ((size_t)28, stored->size());
+    EXPECT_EQ(String("stored line 1"), stored->getLine());
+    EXPECT_EQ(String("stored line 2"), stored->getLine());
+    EXPECT_TRUE(stored->eof());
+    stored->seek(7);
+    EXPECT_EQ(String("line 1"), stored->getLine());
+
+    // deflated, larger than the inflate input buffer
+    std::vector<char> expected = mixedArchiveData();
+    std::vector<char> data(expected.size());
+    DataStreamPtr deflated = arch->open("deflated/data.bin");
+    EXPECT_EQ(expected.size(), deflated->size());
+    EXPECT_EQ(expected.size(), deflated->read(&data[0], data.size()));
+    EXPECT_TRUE(data == expected);
+    EXPECT_TRUE(deflated->eof());
+
+    // seeking back restarts inflating
+    char chunk[16];
+    size_t offsets[] = {50000, 10, 99990, 70000};
+    for (size_t i = 0; i < 4; ++i)
+    {
+        deflated->seek(offsets[i]);
+        size_t count = std::min(sizeof(chunk), expected.size() - offsets[i]);
+        ASSERT_EQ(count, deflated->read(chunk, sizeof(chunk)));
+        EXPECT_EQ(0, memcmp(chunk, &expected[offsets[i]], count));
+    }
+
+    EXPECT_THROW(arch->open("deflated/missing.bin"), FileNotFoundException);
+    EXPECT_FALSE(arch->exists("missing.bin"));
+    EXPECT_TRUE(arch->find("missing.bin")->empty());
+}
+//--------------------------------------------------------------------------
+TEST_F(ZipArchiveMixedTests,File)
+{
+    ZipArchiveFactory factory;
+    Archive* arch = factory.createInstance(archivePath, true);
+    checkArchive(arch);
+
+    // the file is mapped, so stored entries are read in place
+    EXPECT_TRUE(dynamic_cast<MemoryDataStream*>(arch->open("stored.txt").get()) != NULL);
+    factory.destroyInstance(arch);
+}
+//--------------------------------------------------------------------------
+TEST_F(ZipArchiveMixedTests,Embedded)
+{
+    std::vector<uint8> contents = readFile(archivePath);
+    ASSERT_FALSE(contents.empty());
+    EmbeddedZipArchiveFactory::addEmbbeddedFile("mixed.zip", &contents[0], contents.size(), NULL);
+
+    EmbeddedZipArchiveFactory factory;
+    Archive* arch = factory.createInstance("mixed.zip", true);
+    checkArchive(arch);
+    EXPECT_TRUE(dynamic_cast<MemoryDataStream*>(arch->open("stored.txt").get()) != NULL);
+    factory.destroyInstance(arch);
+
+    EmbeddedZipArchiveFactory::removeEmbbeddedFile("mixed.zip");
+    arch = factory.createInstance("mixed.zip", true);
+    EXPECT_THROW(arch->load(), InternalErrorException);
+    factory.destroyInstance(arch);
+}
+//--------------------------------------------------------------------------
+TEST_F(ZipArchiveMixedTests,EmbeddedEncrypted)
+{
+    std::vector<uint8> contents = readFile(archivePath);
+    ASSERT_FALSE(contents.empty());
+    xorDecrypt(0, &contents[0], contents.size());
+    EmbeddedZipArchiveFactory::addEmbbeddedFile("encrypted.zip", &contents[0], contents.size(), xorDecrypt);
+
+    EmbeddedZipArchiveFactory factory;
+    Archive* arch = factory.createInstance("encrypted.zip", true);
+    checkArchive(arch);
+    factory.destroyInstance(arch);
+    EmbeddedZipArchiveFactory::removeEmbbeddedFile("encrypted.zip");
+}
+//--------------------------------------------------------------------------
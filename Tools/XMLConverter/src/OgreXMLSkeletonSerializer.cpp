@@ -590,9 +590,22 @@ namespace Ogre {
         // Write all keyframes
         TiXmlElement* keysNode = 
             trackNode->InsertEndChild(TiXmlElement("keyframes"))->ToElement();
-        for (unsigned short i = 0; i < track->getNumKeyFrames(); ++i)
+        const CompressedTransformKeys* compressedKeys = track->getCompressedKeys();
+        if (compressedKeys)
         {
-            writeKeyFrame(keysNode, track->getNodeKeyFrame(i));
+            for (size_t i = 0; i < compressedKeys->getNumKeys(); ++i)
+            {
+                TransformKeyFrame key(track, compressedKeys->getKeyTime(i));
+                compressedKeys->getKey(i, &key);
+                writeKeyFrame(keysNode, &key);
+            }
+        }
+        else
+        {
+            for (unsigned short i = 0; i < track->getNumKeyFrames(); ++i)
+            {
+                writeKeyFrame(keysNode, track->getNodeKeyFrame(i));
+            }
         }
     }
     //---------------------------------------------------------------------